@@ -0,0 +1,173 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Slicer includes
+#include "vtkSlicerApplicationLogic.h"
+#include "vtkSlicerTask.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// Slicer MRML includes
+#include "vtkMRMLAbstractLogic.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+
+// ITKSYS includes
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+class vtkTaskTestLogic : public vtkMRMLAbstractLogic
+{
+public:
+  static vtkTaskTestLogic *New();
+  vtkTypeMacro(vtkTaskTestLogic, vtkMRMLAbstractLogic);
+
+  void Run(void* vtkNotUsed(clientData))
+  {
+    int running = ++this->NumberOfRunningTasks;
+    int maximum = this->MaximumNumberOfRunningTasks;
+    while (running > maximum
+      && !this->MaximumNumberOfRunningTasks.compare_exchange_weak(maximum, running))
+      {
+      }
+    // Barrier: tasks wait until two of them are running at the same time,
+    // which only happens if the pool executes tasks concurrently.
+    // The timeout prevents blocking forever if tasks are executed one by one.
+    for (int i = 0; i < 1000 && !this->ConcurrentTasksDetected; ++i)
+      {
+      if (this->NumberOfRunningTasks >= 2)
+        {
+        this->ConcurrentTasksDetected = true;
+        break;
+        }
+      itksys::SystemTools::Delay(10);
+      }
+    --this->NumberOfRunningTasks;
+    ++this->NumberOfExecutedTasks;
+  }
+
+  std::atomic<int> NumberOfRunningTasks{0};
+  std::atomic<int> MaximumNumberOfRunningTasks{0};
+  std::atomic<int> NumberOfExecutedTasks{0};
+  std::atomic<bool> ConcurrentTasksDetected{false};
+
+protected:
+  vtkTaskTestLogic() = default;
+  ~vtkTaskTestLogic() override = default;
+};
+vtkStandardNewMacro(vtkTaskTestLogic);
+
+//----------------------------------------------------------------------------
+bool WaitForTasks(vtkSlicerApplicationLogic* appLogic, int numberOfTasks)
+{
+  for (int i = 0; i < 500; ++i)
+    {
+    if (appLogic->GetNumberOfExecutedTasks() + appLogic->GetNumberOfCanceledTasks() >= numberOfTasks)
+      {
+      return true;
+      }
+    itksys::SystemTools::Delay(20);
+    }
+  return false;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkSlicerApplicationLogicTaskTest(int , char * [])
+{
+  const int numberOfTasks = 20;
+  const int numberOfThreads = 4;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkSlicerApplicationLogic> appLogic;
+  appLogic->SetMRMLScene(scene.GetPointer());
+  appLogic->SetNumberOfProcessingThreads(numberOfThreads);
+  CHECK_INT(appLogic->GetNumberOfProcessingThreads(), numberOfThreads);
+
+  vtkNew<vtkTaskTestLogic> logic;
+
+  // Tasks cannot be scheduled before the threads are created
+  vtkNew<vtkSlicerTask> rejectedTask;
+  rejectedTask->SetTypeToProcessing();
+  rejectedTask->SetTaskFunction(logic.GetPointer(),
+    (vtkSlicerTask::TaskFunctionPointer)&vtkTaskTestLogic::Run, nullptr);
+  CHECK_INT(appLogic->ScheduleTask(rejectedTask.GetPointer()), 0);
+
+  appLogic->CreateProcessingThread();
+
+  std::vector<vtkSmartPointer<vtkSlicerTask> > tasks;
+  for (int i = 0; i < numberOfTasks; ++i)
+    {
+    vtkSmartPointer<vtkSlicerTask> task = vtkSmartPointer<vtkSlicerTask>::New();
+    task->SetTypeToProcessing();
+    task->SetPriority(i % 2 ? vtkSlicerTask::HighPriority : vtkSlicerTask::LowPriority);
+    task->SetTaskFunction(logic.GetPointer(),
+      (vtkSlicerTask::TaskFunctionPointer)&vtkTaskTestLogic::Run, nullptr);
+    tasks.push_back(task);
+    }
+  // Canceled task is discarded
+  tasks.back()->Cancel();
+  for (int i = 0; i < numberOfTasks; ++i)
+    {
+    CHECK_INT(appLogic->ScheduleTask(tasks[i]), 1);
+    }
+
+  CHECK_BOOL(WaitForTasks(appLogic.GetPointer(), numberOfTasks), true);
+  CHECK_INT(logic->NumberOfExecutedTasks.load(), numberOfTasks - 1);
+  CHECK_INT(appLogic->GetNumberOfExecutedTasks(), numberOfTasks - 1);
+  CHECK_INT(appLogic->GetNumberOfCanceledTasks(), 1);
+  CHECK_INT(appLogic->GetProcessingTaskQueueSize(), 0);
+  CHECK_BOOL(logic->ConcurrentTasksDetected, true);
+  CHECK_BOOL(logic->MaximumNumberOfRunningTasks <= numberOfThreads, true);
+  CHECK_BOOL(appLogic->GetAverageTaskExecutionTime() > 0.0, true);
+  CHECK_BOOL(appLogic->GetMaximumTaskExecutionTime() >= appLogic->GetAverageTaskExecutionTime(), true);
+  CHECK_BOOL(appLogic->GetMaximumTaskWaitTime() >= appLogic->GetAverageTaskWaitTime(), true);
+  std::cout << "Average task wait time: " << appLogic->GetAverageTaskWaitTime() << "s, "
+            << "maximum: " << appLogic->GetMaximumTaskWaitTime() << "s" << std::endl;
+
+  appLogic->ResetTaskStatistics();
+  CHECK_INT(appLogic->GetNumberOfExecutedTasks(), 0);
+  CHECK_INT(appLogic->GetNumberOfCanceledTasks(), 0);
+
+  // Requests that are not processed yet can be canceled
+  vtkMTimeType uid1 = appLogic->RequestReadFile("vtkMRMLScalarVolumeNode1", "file1.nrrd");
+  vtkMTimeType uid2 = appLogic->RequestWriteData("vtkMRMLScalarVolumeNode1", "file2.nrrd");
+  CHECK_BOOL(uid1 != 0, true);
+  CHECK_BOOL(uid2 != 0, true);
+  CHECK_INT(appLogic->GetReadDataQueueSize(), 1);
+  CHECK_INT(appLogic->GetWriteDataQueueSize(), 1);
+  CHECK_BOOL(appLogic->CancelRequest(uid1), true);
+  CHECK_BOOL(appLogic->CancelRequest(uid1), false);
+  CHECK_BOOL(appLogic->CancelRequest(uid2), true);
+  CHECK_INT(appLogic->GetReadDataQueueSize(), 0);
+  CHECK_INT(appLogic->GetWriteDataQueueSize(), 0);
+
+  appLogic->TerminateProcessingThread();
+  CHECK_INT(appLogic->ScheduleTask(rejectedTask.GetPointer()), 0);
+
+  return EXIT_SUCCESS;
+}
@@ -41,15 +41,278 @@
 # include <sys/resource.h>
 #endif
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <queue>
+#include <thread>
 
 #include "vtkSlicerApplicationLogicRequests.h"
 
 //----------------------------------------------------------------------------
-class ProcessingTaskQueue : public std::queue<vtkSmartPointer<vtkSlicerTask> > {};
 class ModifiedQueue : public std::queue<vtkSmartPointer<vtkObject> > {};
-class ReadDataQueue : public std::queue<DataRequest*> {};
-class WriteDataQueue : public std::queue<DataRequest*> {};
+
+//----------------------------------------------------------------------------
+class DataRequestQueue : public std::queue<DataRequest*>
+{
+public:
+  /// Remove and delete the request of the given uid.
+  /// Return true if the request was found.
+  bool RemoveRequest(vtkMTimeType uid)
+  {
+    for (std::deque<DataRequest*>::iterator it = this->c.begin(); it != this->c.end(); ++it)
+      {
+      if ((*it)->GetUID() == uid)
+        {
+        delete *it;
+        this->c.erase(it);
+        return true;
+        }
+      }
+    return false;
+  }
+};
+class ReadDataQueue : public DataRequestQueue {};
+class WriteDataQueue : public DataRequestQueue {};
+
+//----------------------------------------------------------------------------
+/// Tasks queued for one thread of the processing task pool, bucketed by
+/// priority. Other threads of the same group take tasks from the queue
+/// when their own queue is empty.
+class ProcessingTaskQueue
+{
+public:
+  struct Item
+    {
+    vtkSmartPointer<vtkSlicerTask> Task;
+    int Priority;
+    std::chrono::steady_clock::time_point ScheduleTime;
+    };
+
+  void Push(const Item& item)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    this->Items[item.Priority].push_back(item);
+  }
+
+  /// Pop the oldest task of the given priority
+  bool Pop(int priority, Item& item)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    if (this->Items[priority].empty())
+      {
+      return false;
+      }
+    item = this->Items[priority].front();
+    this->Items[priority].pop_front();
+    return true;
+  }
+
+  /// Move all queued tasks into items
+  void TakeAll(std::vector<Item>& items)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    for (int priority = vtkSlicerTask::HighPriority; priority >= vtkSlicerTask::LowPriority; --priority)
+      {
+      items.insert(items.end(), this->Items[priority].begin(), this->Items[priority].end());
+      this->Items[priority].clear();
+      }
+  }
+
+  size_t GetSize()
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    size_t size = 0;
+    for (int priority = vtkSlicerTask::LowPriority; priority <= vtkSlicerTask::HighPriority; ++priority)
+      {
+      size += this->Items[priority].size();
+      }
+    return size;
+  }
+
+private:
+  std::mutex Lock;
+  std::deque<Item> Items[vtkSlicerTask::HighPriority + 1];
+};
+
+//----------------------------------------------------------------------------
+/// Task queues of the processing and networking threads and task statistics.
+class ProcessingTaskPool
+{
+public:
+  enum
+    {
+    ProcessingGroup = 0,
+    NetworkingGroup,
+    NumberOfGroups
+    };
+
+  /// Thread start information, passed as UserData to the threader callbacks
+  struct ThreadInfo
+    {
+    vtkSlicerApplicationLogic* ApplicationLogic;
+    int ThreadIndex;
+    };
+
+  ProcessingTaskPool()
+  {
+    this->Stopping = false;
+    this->NextQueueIndex = 0;
+    for (int group = 0; group < NumberOfGroups; ++group)
+      {
+      this->NumberOfQueuedTasks[group] = 0;
+      }
+    this->ResetStatistics();
+  }
+
+  /// Set the number of threads (and queues) of each group.
+  /// Must not be called while threads are running. Already queued tasks are kept.
+  void Initialize(vtkSlicerApplicationLogic* appLogic, int numberOfProcessingThreads)
+  {
+    const int numberOfThreads[NumberOfGroups] = { numberOfProcessingThreads, 1 };
+    for (int group = 0; group < NumberOfGroups; ++group)
+      {
+      std::vector<ProcessingTaskQueue::Item> items;
+      for (size_t queueIndex = 0; queueIndex < this->Queues[group].size(); ++queueIndex)
+        {
+        this->Queues[group][queueIndex]->TakeAll(items);
+        }
+      this->Queues[group].clear();
+      for (int threadIndex = 0; threadIndex < numberOfThreads[group]; ++threadIndex)
+        {
+        this->Queues[group].push_back(std::unique_ptr<ProcessingTaskQueue>(new ProcessingTaskQueue));
+        }
+      for (size_t itemIndex = 0; itemIndex < items.size(); ++itemIndex)
+        {
+        this->Queues[group][itemIndex % this->Queues[group].size()]->Push(items[itemIndex]);
+        }
+      }
+    this->ProcessingThreadInfos.clear();
+    for (int threadIndex = 0; threadIndex < numberOfProcessingThreads; ++threadIndex)
+      {
+      ThreadInfo info = { appLogic, threadIndex };
+      this->ProcessingThreadInfos.push_back(info);
+      }
+    this->Stopping = false;
+  }
+
+  void Push(vtkSlicerTask* task)
+  {
+    int group = (task->GetType() == vtkSlicerTask::Networking ? NetworkingGroup : ProcessingGroup);
+    ProcessingTaskQueue::Item item;
+    item.Task = task;
+    item.Priority = task->GetPriority();
+    item.ScheduleTime = std::chrono::steady_clock::now();
+    {
+    std::lock_guard<std::mutex> lock(this->TaskAvailableLock);
+    // distribute tasks among the threads of the group
+    size_t queueIndex = (this->NextQueueIndex++) % this->Queues[group].size();
+    this->Queues[group][queueIndex]->Push(item);
+    this->NumberOfQueuedTasks[group]++;
+    }
+    this->TaskAvailableCondition[group].notify_one();
+  }
+
+  /// Take the task of highest priority, first from the queue of the thread,
+  /// then from the queues of the other threads of the group.
+  bool Take(int group, int threadIndex, ProcessingTaskQueue::Item& item)
+  {
+    const size_t numberOfQueues = this->Queues[group].size();
+    for (int priority = vtkSlicerTask::HighPriority; priority >= vtkSlicerTask::LowPriority; --priority)
+      {
+      for (size_t offset = 0; offset < numberOfQueues; ++offset)
+        {
+        if (this->Queues[group][(threadIndex + offset) % numberOfQueues]->Pop(priority, item))
+          {
+          std::lock_guard<std::mutex> lock(this->TaskAvailableLock);
+          this->NumberOfQueuedTasks[group]--;
+          return true;
+          }
+        }
+      }
+    return false;
+  }
+
+  /// Block until a task is available in the group, Stop() is called or
+  /// the timeout expires.
+  void WaitForTask(int group, int timeoutMs)
+  {
+    std::unique_lock<std::mutex> lock(this->TaskAvailableLock);
+    this->TaskAvailableCondition[group].wait_for(lock, std::chrono::milliseconds(timeoutMs),
+      [this, group]{ return this->Stopping || this->NumberOfQueuedTasks[group] > 0; });
+  }
+
+  /// Wake up all the waiting threads
+  void Stop()
+  {
+    {
+    std::lock_guard<std::mutex> lock(this->TaskAvailableLock);
+    this->Stopping = true;
+    }
+    for (int group = 0; group < NumberOfGroups; ++group)
+      {
+      this->TaskAvailableCondition[group].notify_all();
+      }
+  }
+
+  /// Execute the task (unless it is canceled) and update the statistics
+  void Execute(ProcessingTaskQueue::Item& item)
+  {
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    double waitTime = std::chrono::duration<double>(startTime - item.ScheduleTime).count();
+    if (item.Task->IsCanceled())
+      {
+      std::lock_guard<std::mutex> lock(this->StatisticsLock);
+      this->NumberOfCanceledTasks++;
+      return;
+      }
+    item.Task->Execute();
+    double executionTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+    std::lock_guard<std::mutex> lock(this->StatisticsLock);
+    this->NumberOfExecutedTasks++;
+    this->TotalWaitTime += waitTime;
+    this->MaximumWaitTime = std::max(this->MaximumWaitTime, waitTime);
+    this->TotalExecutionTime += executionTime;
+    this->MaximumExecutionTime = std::max(this->MaximumExecutionTime, executionTime);
+  }
+
+  unsigned int GetSize()
+  {
+    std::lock_guard<std::mutex> lock(this->TaskAvailableLock);
+    return static_cast<unsigned int>(this->NumberOfQueuedTasks[ProcessingGroup] + this->NumberOfQueuedTasks[NetworkingGroup]);
+  }
+
+  void ResetStatistics()
+  {
+    std::lock_guard<std::mutex> lock(this->StatisticsLock);
+    this->NumberOfExecutedTasks = 0;
+    this->NumberOfCanceledTasks = 0;
+    this->TotalWaitTime = 0.0;
+    this->MaximumWaitTime = 0.0;
+    this->TotalExecutionTime = 0.0;
+    this->MaximumExecutionTime = 0.0;
+  }
+
+  std::vector<ThreadInfo> ProcessingThreadInfos;
+
+  std::mutex StatisticsLock;
+  vtkTypeInt64 NumberOfExecutedTasks;
+  vtkTypeInt64 NumberOfCanceledTasks;
+  double TotalWaitTime;
+  double MaximumWaitTime;
+  double TotalExecutionTime;
+  double MaximumExecutionTime;
+
+private:
+  std::vector<std::unique_ptr<ProcessingTaskQueue> > Queues[NumberOfGroups];
+  std::mutex TaskAvailableLock;
+  std::condition_variable TaskAvailableCondition[NumberOfGroups];
+  size_t NumberOfQueuedTasks[NumberOfGroups];
+  size_t NextQueueIndex;
+  bool Stopping;
+};
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSlicerApplicationLogic);
@@ -58,8 +321,11 @@ vtkStandardNewMacro(vtkSlicerApplicationLogic);
 vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
 {
   this->ProcessingThreader = itk::PlatformMultiThreader::New();
-  this->ProcessingThreadId = -1;
   this->ProcessingThreadActive = false;
+  // Tasks (CLI modules, etc.) are often multi-threaded themselves,
+  // only use a fraction of the cores.
+  unsigned int numberOfCores = std::thread::hardware_concurrency();
+  this->NumberOfProcessingThreads = std::max(1, std::min(4, static_cast<int>(numberOfCores / 2)));
 
   this->ModifiedQueueActive = false;
 
@@ -67,7 +333,8 @@ vtkSlicerApplicationLogic::vtkSlicerApplicationLogic()
 
   this->WriteDataQueueActive = false;
 
-  this->InternalTaskQueue = new ProcessingTaskQueue;
+  this->InternalTaskPool = new ProcessingTaskPool;
+  this->InternalTaskPool->Initialize(this, this->NumberOfProcessingThreads);
   this->InternalModifiedQueue = new ModifiedQueue;
 
   this->InternalReadDataQueue = new ReadDataQueue;
@@ -82,20 +349,9 @@ vtkSlicerApplicationLogic::~vtkSlicerApplicationLogic()
   // Note that TerminateThread does not kill a thread, it only waits
   // for the thread to finish.  We need to signal the thread that we
   // want to terminate
-  if (this->ProcessingThreadId != -1 && this->ProcessingThreader)
-    {
-    // Signal the processingThread that we are terminating.
-    this->ProcessingThreadActiveLock.lock();
-    this->ProcessingThreadActive = false;
-    this->ProcessingThreadActiveLock.unlock();
-
-    // Wait for the thread to finish and clean up the state of the threader
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-
-    this->ProcessingThreadId = -1;
-    }
+  this->TerminateProcessingThread();
 
-  delete this->InternalTaskQueue;
+  delete this->InternalTaskPool;
 
   this->ModifiedQueueLock.lock();
   while (!(*this->InternalModifiedQueue).empty())
@@ -118,6 +374,111 @@ unsigned int vtkSlicerApplicationLogic::GetReadDataQueueSize()
   return static_cast<unsigned int>( (*this->InternalReadDataQueue).size() );
 }
 
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetWriteDataQueueSize()
+{
+  return static_cast<unsigned int>( (*this->InternalWriteDataQueue).size() );
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerApplicationLogic::CancelRequest(vtkMTimeType uid)
+{
+  if (uid == 0)
+    {
+    return false;
+    }
+  bool removed = false;
+  this->ReadDataQueueLock.lock();
+  removed = this->InternalReadDataQueue->RemoveRequest(uid);
+  this->ReadDataQueueLock.unlock();
+  if (!removed)
+    {
+    this->WriteDataQueueLock.lock();
+    removed = this->InternalWriteDataQueue->RemoveRequest(uid);
+    this->WriteDataQueueLock.unlock();
+    }
+  return removed;
+}
+
+//----------------------------------------------------------------------------
+unsigned int vtkSlicerApplicationLogic::GetProcessingTaskQueueSize()
+{
+  return this->InternalTaskPool->GetSize();
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkSlicerApplicationLogic::GetNumberOfExecutedTasks()
+{
+  std::lock_guard<std::mutex> lock(this->InternalTaskPool->StatisticsLock);
+  return this->InternalTaskPool->NumberOfExecutedTasks;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkSlicerApplicationLogic::GetNumberOfCanceledTasks()
+{
+  std::lock_guard<std::mutex> lock(this->InternalTaskPool->StatisticsLock);
+  return this->InternalTaskPool->NumberOfCanceledTasks;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetAverageTaskWaitTime()
+{
+  std::lock_guard<std::mutex> lock(this->InternalTaskPool->StatisticsLock);
+  if (this->InternalTaskPool->NumberOfExecutedTasks == 0)
+    {
+    return 0.0;
+    }
+  return this->InternalTaskPool->TotalWaitTime / this->InternalTaskPool->NumberOfExecutedTasks;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetMaximumTaskWaitTime()
+{
+  std::lock_guard<std::mutex> lock(this->InternalTaskPool->StatisticsLock);
+  return this->InternalTaskPool->MaximumWaitTime;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetAverageTaskExecutionTime()
+{
+  std::lock_guard<std::mutex> lock(this->InternalTaskPool->StatisticsLock);
+  if (this->InternalTaskPool->NumberOfExecutedTasks == 0)
+    {
+    return 0.0;
+    }
+  return this->InternalTaskPool->TotalExecutionTime / this->InternalTaskPool->NumberOfExecutedTasks;
+}
+
+//----------------------------------------------------------------------------
+double vtkSlicerApplicationLogic::GetMaximumTaskExecutionTime()
+{
+  std::lock_guard<std::mutex> lock(this->InternalTaskPool->StatisticsLock);
+  return this->InternalTaskPool->MaximumExecutionTime;
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::ResetTaskStatistics()
+{
+  this->InternalTaskPool->ResetStatistics();
+}
+
+//----------------------------------------------------------------------------
+void vtkSlicerApplicationLogic::SetNumberOfProcessingThreads(int numberOfThreads)
+{
+  numberOfThreads = std::max(1, std::min(numberOfThreads, static_cast<int>(ITK_MAX_THREADS) - 1));
+  if (this->NumberOfProcessingThreads == numberOfThreads)
+    {
+    return;
+    }
+  if (!this->ProcessingThreadIDs.empty())
+    {
+    vtkWarningMacro("SetNumberOfProcessingThreads: processing threads are running, "
+      "new value is applied when processing threads are created again");
+    }
+  this->NumberOfProcessingThreads = numberOfThreads;
+  this->Modified();
+}
+
 //-----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::SetMRMLSceneDataIO(vtkMRMLScene* newMRMLScene,
                                                    vtkMRMLRemoteIOLogic *remoteIOLogic,
@@ -171,21 +532,35 @@ void vtkSlicerApplicationLogic::PrintSelf(ostream& os, vtkIndent indent)
   this->vtkObject::PrintSelf(os, indent);
 
   os << indent << "SlicerApplicationLogic:             " << this->GetClassName() << "\n";
+  os << indent << "NumberOfProcessingThreads: " << this->NumberOfProcessingThreads << "\n";
+  os << indent << "ProcessingTaskQueueSize: " << this->GetProcessingTaskQueueSize() << "\n";
+  os << indent << "ReadDataQueueSize: " << this->GetReadDataQueueSize() << "\n";
+  os << indent << "WriteDataQueueSize: " << this->GetWriteDataQueueSize() << "\n";
+  os << indent << "NumberOfExecutedTasks: " << this->GetNumberOfExecutedTasks() << "\n";
+  os << indent << "NumberOfCanceledTasks: " << this->GetNumberOfCanceledTasks() << "\n";
+  os << indent << "AverageTaskWaitTime: " << this->GetAverageTaskWaitTime() << "\n";
+  os << indent << "MaximumTaskWaitTime: " << this->GetMaximumTaskWaitTime() << "\n";
+  os << indent << "AverageTaskExecutionTime: " << this->GetAverageTaskExecutionTime() << "\n";
+  os << indent << "MaximumTaskExecutionTime: " << this->GetMaximumTaskExecutionTime() << "\n";
 }
 
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::CreateProcessingThread()
 {
-  if (this->ProcessingThreadId == -1)
+  if (this->ProcessingThreadIDs.empty())
     {
+    this->InternalTaskPool->Initialize(this, this->NumberOfProcessingThreads);
+
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = true;
     this->ProcessingThreadActiveLock.unlock();
 
-    this->ProcessingThreadId
-      = this->ProcessingThreader
-      ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
-                    this);
+    for (int threadIndex = 0; threadIndex < this->NumberOfProcessingThreads; ++threadIndex)
+      {
+      this->ProcessingThreadIDs.push_back( this->ProcessingThreader
+            ->SpawnThread(vtkSlicerApplicationLogic::ProcessingThreaderCallback,
+                      &this->InternalTaskPool->ProcessingThreadInfos[threadIndex]) );
+      }
 
     // Start four network threads (TODO: make the number of threads a setting)
     this->NetworkingThreadIDs.push_back ( this->ProcessingThreader
@@ -228,7 +603,7 @@ void vtkSlicerApplicationLogic::CreateProcessingThread()
 //----------------------------------------------------------------------------
 void vtkSlicerApplicationLogic::TerminateProcessingThread()
 {
-  if (this->ProcessingThreadId != -1)
+  if (!this->ProcessingThreadIDs.empty())
     {
     this->ModifiedQueueActiveLock.lock();
     this->ModifiedQueueActive = false;
@@ -245,11 +620,18 @@ void vtkSlicerApplicationLogic::TerminateProcessingThread()
     this->ProcessingThreadActiveLock.lock();
     this->ProcessingThreadActive = false;
     this->ProcessingThreadActiveLock.unlock();
-
-    this->ProcessingThreader->TerminateThread( this->ProcessingThreadId );
-    this->ProcessingThreadId = -1;
+    // wake up idle threads
+    this->InternalTaskPool->Stop();
 
     std::vector<int>::const_iterator idIterator;
+    idIterator = this->ProcessingThreadIDs.begin();
+    while (idIterator != this->ProcessingThreadIDs.end())
+      {
+      this->ProcessingThreader->TerminateThread( *idIterator );
+      ++idIterator;
+      }
+    this->ProcessingThreadIDs.clear();
+
     idIterator = this->NetworkingThreadIDs.begin();
     while (idIterator != this->NetworkingThreadIDs.end())
       {
@@ -285,23 +667,23 @@ vtkSlicerApplicationLogic
   (void)ret; // unused variable
 #endif
 
-  // pull out the reference to the appLogic
-  vtkSlicerApplicationLogic *appLogic
-    = (vtkSlicerApplicationLogic*)
+  // pull out the reference to the appLogic and the index of the thread
+  ProcessingTaskPool::ThreadInfo *threadInfo
+    = (ProcessingTaskPool::ThreadInfo*)
     (((itk::PlatformMultiThreader::WorkUnitInfo *)(arg))->UserData);
 
   // Tell the app to start processing any tasks slated for the
   // processing thread
-  appLogic->ProcessProcessingTasks();
+  threadInfo->ApplicationLogic->ProcessProcessingTasks(threadInfo->ThreadIndex);
 
   return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
 }
 
 //----------------------------------------------------------------------------
-void vtkSlicerApplicationLogic::ProcessProcessingTasks()
+void vtkSlicerApplicationLogic::ProcessProcessingTasks(int threadIndex)
 {
   int active = true;
-  vtkSmartPointer<vtkSlicerTask> task = nullptr;
+  ProcessingTaskQueue::Item item;
 
   while (active)
     {
@@ -312,35 +694,18 @@ void vtkSlicerApplicationLogic::ProcessProcessingTasks()
 
     if (active)
       {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      // pull a task off the queues, only processing tasks are handled in this thread
+      if (this->InternalTaskPool->Take(ProcessingTaskPool::ProcessingGroup, threadIndex, item))
         {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-
-        // only handle processing tasks in this thread
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Processing )
-          {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = nullptr;
-          }
+        this->InternalTaskPool->Execute(item);
+        item.Task = nullptr;
         }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
+      else
         {
-        task->Execute();
-        task = nullptr;
+        // wait until a task is scheduled
+        this->InternalTaskPool->WaitForTask(ProcessingTaskPool::ProcessingGroup, 100);
         }
       }
-
-    // busy wait
-    itksys::SystemTools::Delay(100);
     }
 }
 
@@ -383,7 +748,7 @@ vtkSlicerApplicationLogic
 void vtkSlicerApplicationLogic::ProcessNetworkingTasks()
 {
   int active = true;
-  vtkSmartPointer<vtkSlicerTask> task = nullptr;
+  ProcessingTaskQueue::Item item;
 
   while (active)
     {
@@ -394,33 +759,18 @@ void vtkSlicerApplicationLogic::ProcessNetworkingTasks()
 
     if (active)
       {
-      // pull a task off the queue
-      this->ProcessingTaskQueueLock.lock();
-      if ((*this->InternalTaskQueue).size() > 0)
+      // pull a task off the queue, only networking tasks are handled in this thread
+      if (this->InternalTaskPool->Take(ProcessingTaskPool::NetworkingGroup, 0, item))
         {
-        // std::cout << "Number of queued tasks: " << (*this->InternalTaskQueue).size() << std::endl;
-        task = (*this->InternalTaskQueue).front();
-        if ( task->GetType() == vtkSlicerTask::Networking )
-          {
-          (*this->InternalTaskQueue).pop();
-          }
-        else
-          {
-          task = nullptr;
-          }
+        this->InternalTaskPool->Execute(item);
+        item.Task = nullptr;
         }
-      this->ProcessingTaskQueueLock.unlock();
-
-      // process the task (should this be in a separate thread?)
-      if (task)
+      else
         {
-        task->Execute();
-        task = nullptr;
+        // wait until a task is scheduled
+        this->InternalTaskPool->WaitForTask(ProcessingTaskPool::NetworkingGroup, 100);
         }
       }
-
-    // busy wait
-    itksys::SystemTools::Delay(100);
     }
 }
 
@@ -436,9 +786,12 @@ int vtkSlicerApplicationLogic::ScheduleTask( vtkSlicerTask *task )
     return false;
     }
 
-  this->ProcessingTaskQueueLock.lock();
-  (*this->InternalTaskQueue).push( task );
-  this->ProcessingTaskQueueLock.unlock();
+  if (!task)
+    {
+    return false;
+    }
+
+  this->InternalTaskPool->Push( task );
   return true;
 }
 
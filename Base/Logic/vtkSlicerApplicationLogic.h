@@ -40,7 +40,7 @@ class vtkDataIOManagerLogic;
 class vtkPersonInformation;
 class vtkSlicerTask;
 class ModifiedQueue;
-class ProcessingTaskQueue;
+class ProcessingTaskPool;
 class ReadDataQueue;
 class ReadDataRequest;
 class WriteDataQueue;
@@ -72,11 +72,20 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
   /// (display it in the Fiducials GUI)
   void PropagateFiducialListSelection();
 
-  /// Create a thread for processing
+  /// Create the processing threads
+  /// \sa SetNumberOfProcessingThreads()
   void CreateProcessingThread();
 
-  /// Shutdown the processing thread
+  /// Shutdown the processing threads
   void TerminateProcessingThread();
+
+  /// Set the number of threads executing processing tasks.
+  /// Changing the value while the processing threads are running has no
+  /// effect until TerminateProcessingThread() and CreateProcessingThread()
+  /// are called.
+  /// Default is half of the number of cores, at least 1 and at most 4.
+  void SetNumberOfProcessingThreads(int numberOfThreads);
+  vtkGetMacro(NumberOfProcessingThreads, int);
   /// List of events potentially fired by the application logic
   enum RequestEvents
     {
@@ -90,11 +99,32 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
       RequestProcessedEvent
     };
 
-  /// Schedule a task to run in the processing thread. Returns true if
+  /// Schedule a task to run in a processing thread. Returns true if
   /// task was successfully scheduled. ScheduleTask() is called from the
-  /// main thread to run something in the processing thread.
+  /// main thread to run something in a processing thread.
+  /// Processing tasks are distributed among the processing threads, an idle
+  /// thread takes over tasks queued for the other threads. Tasks with a
+  /// higher priority are executed first. Networking tasks are executed
+  /// sequentially in the networking thread.
+  /// Call vtkSlicerTask::Cancel() to discard a task that is not started yet.
+  /// \sa vtkSlicerTask::SetPriority(), vtkSlicerTask::Cancel()
   int ScheduleTask( vtkSlicerTask* );
 
+  /// Return the number of scheduled tasks that are not started yet.
+  unsigned int GetProcessingTaskQueueSize();
+
+  /// Task statistics, updated when a task is executed or discarded.
+  /// Wait time is the time (in seconds) between ScheduleTask() and the start
+  /// of the execution, execution time is the duration of vtkSlicerTask::Execute().
+  /// \sa ResetTaskStatistics()
+  vtkTypeInt64 GetNumberOfExecutedTasks();
+  vtkTypeInt64 GetNumberOfCanceledTasks();
+  double GetAverageTaskWaitTime();
+  double GetMaximumTaskWaitTime();
+  double GetAverageTaskExecutionTime();
+  double GetMaximumTaskExecutionTime();
+  void ResetTaskStatistics();
+
   /// Request a Modified call on an object.  This method allows a
   /// processing thread to request a Modified call on an object to be
   /// performed in the main thread.  This allows the call to Modified
@@ -146,6 +176,14 @@ class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerApplicationLogic
   /// multiple items are being returned and have all been returned).
   unsigned int GetReadDataQueueSize();
 
+  /// Return the number of write requests that are not processed yet.
+  unsigned int GetWriteDataQueueSize();
+
+  /// Remove a read or write request that is not processed yet.
+  /// \a uid is the value returned by RequestReadFile(), RequestReadScene(),
+  /// RequestWriteData(), etc.
+  /// Return true if the request was found and removed.
+  bool CancelRequest(vtkMTimeType uid);
 
   /// Request that data be written from a file to a remote destination.
   /// Return the request UID (monotonically increasing) of the request or 0 if
@@ -233,7 +271,8 @@ protected:
   static itk::ITK_THREAD_RETURN_TYPE NetworkingThreaderCallback( void * );
 
   /// Task processing loop that is run in the processing thread
-  void ProcessProcessingTasks();
+  /// of index \a threadIndex
+  void ProcessProcessingTasks(int threadIndex);
 
   /// Networking Task processing loop that is run in a networking thread
   void ProcessNetworkingTasks();
@@ -251,7 +290,6 @@ private:
 
   itk::PlatformMultiThreader::Pointer ProcessingThreader;
   std::mutex ProcessingThreadActiveLock;
-  std::mutex ProcessingTaskQueueLock;
   std::mutex ModifiedQueueActiveLock;
   std::mutex ModifiedQueueLock;
   std::mutex ReadDataQueueActiveLock;
@@ -259,14 +297,15 @@ private:
   std::mutex WriteDataQueueActiveLock;
   std::mutex WriteDataQueueLock;
   vtkTimeStamp RequestTimeStamp;
-  int ProcessingThreadId;
+  int NumberOfProcessingThreads;
+  std::vector<int> ProcessingThreadIDs;
   std::vector<int> NetworkingThreadIDs;
   int ProcessingThreadActive;
   int ModifiedQueueActive;
   int ReadDataQueueActive;
   int WriteDataQueueActive;
 
-  ProcessingTaskQueue* InternalTaskQueue;
+  ProcessingTaskPool*  InternalTaskPool;
   ModifiedQueue*       InternalModifiedQueue;
   ReadDataQueue*       InternalReadDataQueue;
   WriteDataQueue*      InternalWriteDataQueue;
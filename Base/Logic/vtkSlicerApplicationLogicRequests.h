@@ -19,6 +19,9 @@
 #include <vtkMRMLSubjectHierarchyNode.h>
 #include <vtkMRMLTableNode.h>
 
+// vtkITK includes
+#include <vtkITKSharedMemoryImage.h>
+
 //----------------------------------------------------------------------------
 class DataRequest
 {
@@ -28,7 +31,7 @@ public:
     m_UID = 0;
   }
 
-  DataRequest(int uid)
+  DataRequest(vtkMTimeType uid)
   {
     m_UID = uid;
   }
@@ -37,7 +40,7 @@ public:
 
   virtual void Execute(vtkSlicerApplicationLogic*) {};
 
-  int GetUID()const{return m_UID;}
+  vtkMTimeType GetUID()const{return m_UID;}
 
 protected:
   vtkMTimeType m_UID;
@@ -48,7 +51,7 @@ class ReadDataRequestFile : public DataRequest
 {
 public:
   ReadDataRequestFile(const std::string& node, const std::string& filename,
-    int displayData, int deleteFile, int uid = 0)
+    int displayData, int deleteFile, vtkMTimeType uid = 0)
     : DataRequest(uid)
   {
     m_TargetNode = node;
@@ -107,9 +110,11 @@ public:
       if (storageNode.GetPointer() == nullptr)
         {
         // Read the data into the referenced node
-        if (itksys::SystemTools::FileExists(m_Filename.c_str()))
+        if (itksys::SystemTools::FileExists(m_Filename.c_str())
+          || vtkITKSharedMemoryImage::IsSharedMemoryFileName(m_Filename.c_str()))
           {
-          // file is there on disk
+          // file is there on disk (or image written by a command line module
+          // into shared memory, which the volume storage node can read)
           storableNode->AddDefaultStorageNode(m_Filename.c_str());
           storageNode = storableNode->GetStorageNode();
           createdNewStorageNode = (storageNode != nullptr);
@@ -174,6 +179,10 @@ public:
         {
         removed = 1;
         }
+      else if (vtkITKSharedMemoryImage::IsSharedMemoryFileName(m_Filename.c_str()))
+        {
+        removed = vtkITKSharedMemoryImage::RemoveImage(m_Filename.c_str());
+        }
       else
         {
         removed = itksys::SystemTools::RemoveFile(m_Filename.c_str());
@@ -248,7 +257,7 @@ public:
     const std::vector<std::string>& sourceNodes,
     const std::string& filename,
     int displayData, int deleteFile,
-    int uid = 0)
+    vtkMTimeType uid = 0)
     : DataRequest(uid)
   {
     m_TargetNodes = targetNodes;
@@ -512,7 +521,7 @@ class ReadDataRequestUpdateParentTransform : public DataRequest
 {
 public:
   ReadDataRequestUpdateParentTransform(const std::string& updatedNode,
-    const std::string& parentTransformNode, int uid = 0)
+    const std::string& parentTransformNode, vtkMTimeType uid = 0)
     : DataRequest(uid)
   {
     m_UpdatedNode = updatedNode;
@@ -540,7 +549,7 @@ class ReadDataRequestUpdateSubjectHierarchyLocation : public DataRequest
 {
 public:
   ReadDataRequestUpdateSubjectHierarchyLocation(const std::string& updatedNode,
-    const std::string& siblingNode, int uid = 0)
+    const std::string& siblingNode, vtkMTimeType uid = 0)
     : DataRequest(uid)
   {
     m_UpdatedNode = updatedNode;
@@ -575,7 +584,7 @@ class ReadDataRequestAddNodeReference : public DataRequest
 {
 public:
   ReadDataRequestAddNodeReference(const std::string& referencingNode,
-    const std::string& referencedNode, const std::string& role, int uid = 0)
+    const std::string& referencedNode, const std::string& role, vtkMTimeType uid = 0)
     : DataRequest(uid)
   {
     m_ReferencingNode = referencingNode;
@@ -608,7 +617,7 @@ public:
   WriteDataRequestFile(
       const std::string& vtkNotUsed(node),
       const std::string& vtkNotUsed(filename),
-      int uid = 0)
+      vtkMTimeType uid = 0)
     : DataRequest(uid)
   {
   }
@@ -624,7 +633,7 @@ public:
   WriteDataRequestScene(const std::vector<std::string>& targetNodes,
                    const std::vector<std::string>& sourceNodes,
                    const std::string& filename,
-                   int uid = 0)
+                   vtkMTimeType uid = 0)
     : DataRequest(uid)
   {
     m_TargetNodes = targetNodes;
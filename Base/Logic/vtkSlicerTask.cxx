@@ -13,6 +13,8 @@ vtkSlicerTask::vtkSlicerTask()
   this->TaskFunction = nullptr;
   this->TaskClientData = nullptr;
   this->Type = vtkSlicerTask::Undefined;
+  this->Priority = vtkSlicerTask::NormalPriority;
+  this->Canceled = false;
 }
 //----------------------------------------------------------------------------
 vtkSlicerTask::~vtkSlicerTask() = default;
@@ -36,8 +38,23 @@ void vtkSlicerTask::Execute()
     }
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerTask::Cancel()
+{
+  this->Canceled = true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkSlicerTask::IsCanceled()
+{
+  return this->Canceled;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerTask::PrintSelf(ostream& os, vtkIndent indent)
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "Type: " << this->GetTypeAsString() << "\n";
+  os << indent << "Priority: " << this->Priority << "\n";
+  os << indent << "Canceled: " << (this->Canceled ? "true" : "false") << "\n";
 }
@@ -6,6 +6,9 @@
 #include "vtkMRMLAbstractLogic.h"
 #include "vtkSlicerBaseLogic.h"
 
+// STD includes
+#include <atomic>
+
 class VTK_SLICER_BASE_LOGIC_EXPORT vtkSlicerTask : public vtkObject
 {
 public:
@@ -38,6 +41,32 @@ public:
   void SetTypeToProcessing() {this->SetType(vtkSlicerTask::Processing);};
   void SetTypeToNetworking() {this->SetType(vtkSlicerTask::Networking);};
 
+  ///
+  /// Priority of the task. Queued tasks with a higher priority are
+  /// executed first, tasks of the same priority in scheduling order.
+  enum
+    {
+    LowPriority = 0,
+    NormalPriority,
+    HighPriority
+    };
+
+  vtkSetClampMacro (Priority, int, vtkSlicerTask::LowPriority, vtkSlicerTask::HighPriority);
+  vtkGetMacro (Priority, int);
+  void SetPriorityToLow() {this->SetPriority(vtkSlicerTask::LowPriority);};
+  void SetPriorityToNormal() {this->SetPriority(vtkSlicerTask::NormalPriority);};
+  void SetPriorityToHigh() {this->SetPriority(vtkSlicerTask::HighPriority);};
+
+  ///
+  /// Request cancellation of the task. A canceled task that is still
+  /// queued is discarded without being executed. This method can be
+  /// called from any thread.
+  void Cancel();
+
+  ///
+  /// Return true if Cancel() has been called on the task.
+  bool IsCanceled();
+
   const char* GetTypeAsString( ) {
     switch (this->Type)
       {
@@ -60,6 +89,8 @@ private:
   void *TaskClientData;
 
   int Type;
+  int Priority;
+  std::atomic<bool> Canceled;
 
 };
 #endif
@@ -1396,15 +1396,18 @@ def arrayFromMarkupsControlPoints(markupsNode, world = False):
 
   To modify markup control points based on a numpy array, use :py:meth:`updateMarkupsControlPointsFromArray`.
   """
-  numberOfControlPoints = markupsNode.GetNumberOfControlPoints()
-  import numpy as np
-  narray = np.zeros([numberOfControlPoints, 3])
-  for controlPointIndex in range(numberOfControlPoints):
-    if world:
-      markupsNode.GetNthControlPointPositionWorld(controlPointIndex, narray[controlPointIndex,:])
-    else:
-      markupsNode.GetNthControlPointPosition(controlPointIndex, narray[controlPointIndex,:])
-  return narray
+  import vtk
+  import vtk.util.numpy_support
+  points = vtk.vtkPoints()
+  points.SetDataTypeToDouble()
+  if world:
+    markupsNode.GetControlPointPositionsWorld(points)
+  else:
+    markupsNode.GetControlPointPositions(points)
+  if points.GetNumberOfPoints() == 0:
+    import numpy as np
+    return np.zeros([0, 3])
+  return vtk.util.numpy_support.vtk_to_numpy(points.GetData()).copy()
 
 def updateMarkupsControlPointsFromArray(markupsNode, narray, world = False):
   """Sets control point positions in a markups node from a numpy array of size Nx3.
@@ -1419,26 +1422,16 @@ def updateMarkupsControlPointsFromArray(markupsNode, narray, world = False):
     return
   if len(narrayshape) != 2 or narrayshape[1] != 3:
     raise RuntimeError("Unsupported numpy array shape: "+str(narrayshape)+" expected (N,3)")
-  numberOfControlPoints = narrayshape[0]
-  oldNumberOfControlPoints = markupsNode.GetNumberOfControlPoints()
-  # Update existing control points
-  for controlPointIndex in range(min(numberOfControlPoints, oldNumberOfControlPoints)):
-    if world:
-      markupsNode.SetNthControlPointPositionWorldFromArray(controlPointIndex, narray[controlPointIndex,:])
-    else:
-      markupsNode.SetNthControlPointPositionFromArray(controlPointIndex, narray[controlPointIndex,:])
-  if numberOfControlPoints >= oldNumberOfControlPoints:
-    # Add new points to the markup node
-    from vtk import vtkVector3d
-    for controlPointIndex in range(oldNumberOfControlPoints, numberOfControlPoints):
-      if world:
-        markupsNode.AddControlPointWorld(vtkVector3d(narray[controlPointIndex,:]))
-      else:
-        markupsNode.AddControlPoint(vtkVector3d(narray[controlPointIndex,:]))
+  # Set all points in one call, so that measurements and displayed points are updated only once
+  import numpy as np
+  import vtk
+  import vtk.util.numpy_support
+  points = vtk.vtkPoints()
+  points.SetData(vtk.util.numpy_support.numpy_to_vtk(np.ascontiguousarray(narray, dtype=np.float64), deep=True))
+  if world:
+    markupsNode.SetControlPointPositionsWorld(points)
   else:
-    # Remove extra point from the markup node
-    for controlPointIndex in range(oldNumberOfControlPoints, numberOfControlPoints, -1):
-      markupsNode.RemoveNthControlPoint(controlPointIndex-1)
+    markupsNode.SetControlPointPositions(points)
 
 def arrayFromMarkupsCurvePoints(markupsNode, world = False):
   """Return interpolated curve point positions of a markups node as rows in a numpy array (of size Nx3).
@@ -21,6 +21,8 @@
 #include "qSlicerApplicationHelper.h"
 
 // Qt includes
+#include <QDir>
+#include <QFileInfo>
 #include <QFont>
 #include <QLabel>
 #include <QSettings>
@@ -180,6 +182,18 @@ void qSlicerApplicationHelper::setupModuleFactoryManager(qSlicerModuleFactoryMan
     cliExecutableFactory->setTempDirectory(tempDirectory);
     moduleFactoryManager->registerFactory(cliExecutableFactory, preferExecutableCLIs ? 1 : 0);
 
+    // Cache module descriptions next to the revision specific settings, so that
+    // CLI executables do not have to be run and libraries do not have to be loaded
+    // at each startup to get the descriptions.
+    if (!options->settingsDisabled())
+      {
+      QFileInfo revisionUserSettingsFileInfo(app->slicerRevisionUserSettingsFilePath());
+      QString cacheFilePathPrefix =
+        QDir(revisionUserSettingsFileInfo.path()).filePath(revisionUserSettingsFileInfo.completeBaseName());
+      cliLoadableFactory->setModuleDescriptionCacheFilePath(cacheFilePathPrefix + "-CLILoadableModuleDescriptions.cache");
+      cliExecutableFactory->setModuleDescriptionCacheFilePath(cacheFilePathPrefix + "-CLIExecutableModuleDescriptions.cache");
+      }
+
     if (!options->disableBuiltInModules() &&
         !options->disableBuiltInCLIModules() &&
         !options->runPythonAndExit())
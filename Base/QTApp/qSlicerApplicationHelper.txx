@@ -150,6 +150,22 @@ int qSlicerApplicationHelper::postInitializeApplication(
     }
   splashMessage(splashScreen, "Instantiating modules...");
   moduleFactoryManager->instantiateModules();
+#ifdef Slicer_BUILD_CLI_SUPPORT
+  // Store the CLI module descriptions retrieved while instantiating the modules,
+  // so that they are available at the next startup even if the application
+  // does not exit normally.
+  foreach(qSlicerModuleFactoryManager::qSlicerModuleFactory* factory, moduleFactoryManager->registeredFactories())
+    {
+    if (qSlicerCLILoadableModuleFactory* cliLoadableFactory = dynamic_cast<qSlicerCLILoadableModuleFactory*>(factory))
+      {
+      cliLoadableFactory->saveModuleDescriptionCache();
+      }
+    else if (qSlicerCLIExecutableModuleFactory* cliExecutableFactory = dynamic_cast<qSlicerCLIExecutableModuleFactory*>(factory))
+      {
+      cliExecutableFactory->saveModuleDescriptionCache();
+      }
+    }
+#endif
   if (app.commandOptions()->verboseModuleDiscovery())
     {
     qDebug() << "Number of instantiated modules:"
@@ -19,16 +19,110 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
 
 // Slicer includes
 #include <qSlicerCLIExecutableModuleFactory.h>
+#include <qSlicerCLIModuleDescriptionCache.h>
 
 // STD includes
 
 #include "vtkMRMLCoreTestingMacros.h"
 
-int qSlicerCLIExecutableModuleFactoryTest1(int, char * [] )
+namespace
 {
+
+const char* CACHED_XML_DESCRIPTION =
+  "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+  "<executable><category>Testing</category><title>Cached CLI Module</title></executable>";
+
+//-----------------------------------------------------------------------------
+bool writeExecutable(const QString& filePath, const QByteArray& content)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size())
+    {
+    return false;
+    }
+  file.close();
+  return file.setPermissions(file.permissions() | QFileDevice::ExeOwner);
+}
+
+//-----------------------------------------------------------------------------
+int testCachedModuleDescription()
+{
+  QTemporaryDir temporaryDir;
+  CHECK_BOOL(temporaryDir.isValid(), true);
+  QDir directory(temporaryDir.path());
+  QString cacheFilePath = directory.filePath("ModuleDescriptions.cache");
+
+  // The file cannot be run, so the module can only be instantiated
+  // if the executable is not run with "--xml"
+  QString executablePath = directory.filePath("CachedCLIModule");
+#ifdef Q_OS_WIN
+  executablePath += ".exe";
+#endif
+  CHECK_BOOL(writeExecutable(executablePath, "not an executable"), true);
+
+  {
+  qSlicerCLIExecutableModuleFactory factory;
+  factory.setModuleDescriptionCacheFilePath(cacheFilePath);
+  QString moduleName = factory.registerFileItem(QFileInfo(executablePath));
+  CHECK_STD_STRING(moduleName.toStdString(), "CachedCLIModule");
+  CHECK_NULL(factory.instantiate(moduleName));
+  }
+
+  {
+  qSlicerCLIModuleDescriptionCache cache;
+  cache.setFilePath(cacheFilePath);
+  cache.setXmlDescription(executablePath, CACHED_XML_DESCRIPTION);
+  CHECK_BOOL(cache.save(), true);
+  }
+
+  // Cached description is used instead of running the executable
+  {
+  qSlicerCLIExecutableModuleFactory factory;
+  factory.setModuleDescriptionCacheFilePath(cacheFilePath);
+  QString moduleName = factory.registerFileItem(QFileInfo(executablePath));
+  CHECK_STD_STRING(moduleName.toStdString(), "CachedCLIModule");
+  qSlicerAbstractCoreModule* module = factory.instantiate(moduleName);
+  CHECK_NOT_NULL(module);
+  CHECK_STD_STRING(module->title().toStdString(), "Cached CLI Module");
+  }
+
+#ifndef Q_OS_WIN
+  // Description retrieved by running the executable is available
+  // to other factories once the cache is saved
+  QString scriptPath = directory.filePath("ScriptCLIModule");
+  CHECK_BOOL(writeExecutable(scriptPath,
+    QByteArray("#!/bin/sh\necho '") + CACHED_XML_DESCRIPTION + "'\n"), true);
+  {
+  qSlicerCLIExecutableModuleFactory factory;
+  factory.setModuleDescriptionCacheFilePath(cacheFilePath);
+  QString moduleName = factory.registerFileItem(QFileInfo(scriptPath));
+  CHECK_NOT_NULL(factory.instantiate(moduleName));
+  CHECK_BOOL(factory.saveModuleDescriptionCache(), true);
+
+  qSlicerCLIModuleDescriptionCache cache;
+  cache.setFilePath(cacheFilePath);
+  CHECK_BOOL(cache.xmlDescription(scriptPath).trimmed() == CACHED_XML_DESCRIPTION, true);
+  CHECK_BOOL(cache.xmlDescription(executablePath) == CACHED_XML_DESCRIPTION, true);
+  }
+#endif
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qSlicerCLIExecutableModuleFactoryTest1(int argc, char * argv[] )
+{
+  QCoreApplication app(argc, argv);
+
   QStringList executableNames;
   executableNames << "Threshold.exe"
                   << "Threshold";
@@ -48,5 +142,7 @@ int qSlicerCLIExecutableModuleFactoryTest1(int, char * [] )
       }
     }
 
+  CHECK_EXIT_SUCCESS(testCachedModuleDescription());
+
   return EXIT_SUCCESS;
 }
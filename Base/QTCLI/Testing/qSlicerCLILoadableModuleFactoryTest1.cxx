@@ -19,16 +19,81 @@
 ==============================================================================*/
 
 // Qt includes
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
 
 // Slicer includes
 #include <qSlicerCLILoadableModuleFactory.h>
+#include <qSlicerCLIModuleDescriptionCache.h>
 
 // STD includes
 
 #include "vtkMRMLCoreTestingMacros.h"
 
-int qSlicerCLILoadableModuleFactoryTest1(int, char * [] )
+namespace
 {
+
+//-----------------------------------------------------------------------------
+int testCachedModuleDescription()
+{
+  QTemporaryDir temporaryDir;
+  CHECK_BOOL(temporaryDir.isValid(), true);
+  QDir directory(temporaryDir.path());
+  QString cacheFilePath = directory.filePath("ModuleDescriptions.cache");
+
+  // The file is not a valid library, so the module can only be registered
+  // if the library is not loaded
+#if defined(Q_OS_WIN)
+  QString libraryPath = directory.filePath("CachedCLIModuleLib.dll");
+#elif defined(Q_OS_MAC)
+  QString libraryPath = directory.filePath("libCachedCLIModuleLib.dylib");
+#else
+  QString libraryPath = directory.filePath("libCachedCLIModuleLib.so");
+#endif
+  {
+  QFile libraryFile(libraryPath);
+  CHECK_BOOL(libraryFile.open(QIODevice::WriteOnly), true);
+  CHECK_BOOL(libraryFile.write("not a library") > 0, true);
+  }
+
+  {
+  qSlicerCLILoadableModuleFactory factory;
+  factory.setModuleDescriptionCacheFilePath(cacheFilePath);
+  CHECK_BOOL(factory.registerFileItem(QFileInfo(libraryPath)).isEmpty(), true);
+  }
+
+  {
+  qSlicerCLIModuleDescriptionCache cache;
+  cache.setFilePath(cacheFilePath);
+  cache.setXmlDescription(libraryPath,
+    "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+    "<executable><category>Testing</category><title>Cached CLI Module</title></executable>");
+  CHECK_BOOL(cache.save(), true);
+  }
+
+  // Cached description is used instead of loading the library
+  {
+  qSlicerCLILoadableModuleFactory factory;
+  factory.setModuleDescriptionCacheFilePath(cacheFilePath);
+  QString moduleName = factory.registerFileItem(QFileInfo(libraryPath));
+  CHECK_STD_STRING(moduleName.toStdString(), "CachedCLIModule");
+  qSlicerAbstractCoreModule* module = factory.instantiate(moduleName);
+  CHECK_NOT_NULL(module);
+  CHECK_STD_STRING(module->title().toStdString(), "Cached CLI Module");
+  }
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qSlicerCLILoadableModuleFactoryTest1(int argc, char * argv[] )
+{
+  QCoreApplication app(argc, argv);
+
   QStringList libraryNames;
   libraryNames << "ThresholdLib.dll"
                << "Threshold.dll"
@@ -50,6 +115,8 @@ int qSlicerCLILoadableModuleFactoryTest1(int, char * [] )
       }
     }
 
+  CHECK_EXIT_SUCCESS(testCachedModuleDescription());
+
   return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,100 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+// Slicer includes
+#include <qSlicerCLIModuleDescriptionCache.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+bool writeFile(const QString& filePath, const QByteArray& content)
+{
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly))
+    {
+    return false;
+    }
+  return file.write(content) == content.size();
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int qSlicerCLIModuleDescriptionCacheTest1(int, char * [] )
+{
+  QTemporaryDir temporaryDir;
+  CHECK_BOOL(temporaryDir.isValid(), true);
+  QDir directory(temporaryDir.path());
+  QString modulePath = directory.filePath("CLIModule");
+  QString otherModulePath = directory.filePath("OtherCLIModule");
+  QString cacheFilePath = directory.filePath("Cache/ModuleDescriptions.cache");
+  CHECK_BOOL(writeFile(modulePath, "module"), true);
+  CHECK_BOOL(writeFile(otherModulePath, "other module"), true);
+  const QString xmlDescription = "<?xml version=\"1.0\" encoding=\"utf-8\"?><executable></executable>";
+
+  {
+  qSlicerCLIModuleDescriptionCache cache;
+  cache.setFilePath(cacheFilePath);
+  CHECK_BOOL(cache.xmlDescription(modulePath).isEmpty(), true);
+  cache.setXmlDescription(modulePath, xmlDescription);
+  cache.setXmlDescription(otherModulePath, xmlDescription);
+  CHECK_STD_STRING(cache.xmlDescription(modulePath).toStdString(), xmlDescription.toStdString());
+  CHECK_BOOL(cache.save(), true);
+  }
+
+  // Descriptions are read from the file
+  {
+  qSlicerCLIModuleDescriptionCache cache;
+  cache.setFilePath(cacheFilePath);
+  CHECK_STD_STRING(cache.xmlDescription(modulePath).toStdString(), xmlDescription.toStdString());
+  CHECK_STD_STRING(cache.xmlDescription(otherModulePath).toStdString(), xmlDescription.toStdString());
+
+  // Description of a changed module is not used
+  CHECK_BOOL(writeFile(modulePath, "updated module"), true);
+  CHECK_BOOL(cache.xmlDescription(modulePath).isEmpty(), true);
+
+  // Descriptions of removed modules are not saved
+  CHECK_BOOL(QFile::remove(otherModulePath), true);
+  cache.setXmlDescription(modulePath, xmlDescription);
+  }
+
+  {
+  qSlicerCLIModuleDescriptionCache cache;
+  cache.setFilePath(cacheFilePath);
+  CHECK_STD_STRING(cache.xmlDescription(modulePath).toStdString(), xmlDescription.toStdString());
+  CHECK_BOOL(writeFile(otherModulePath, "other module"), true);
+  CHECK_BOOL(cache.xmlDescription(otherModulePath).isEmpty(), true);
+  }
+
+  // Invalid cache files are ignored
+  CHECK_BOOL(writeFile(cacheFilePath, "invalid"), true);
+  {
+  qSlicerCLIModuleDescriptionCache cache;
+  cache.setFilePath(cacheFilePath);
+  CHECK_BOOL(cache.xmlDescription(modulePath).isEmpty(), true);
+  }
+
+  return EXIT_SUCCESS;
+}
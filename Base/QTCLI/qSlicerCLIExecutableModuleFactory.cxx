@@ -20,15 +20,39 @@
 
 // Qt includes
 #include <QProcess>
+#include <QRunnable>
 #include <QStandardPaths>
+#include <QThreadPool>
 
 // Slicer includes
 #include "qSlicerCLIExecutableModuleFactory.h"
 #include "qSlicerCLIModule.h"
+#include "qSlicerCLIModuleDescriptionCache.h"
 #include "qSlicerCLIModuleFactoryHelper.h"
 #include "qSlicerUtils.h"
 #include <vtkSlicerCLIModuleLogic.h>
 
+namespace
+{
+
+//-----------------------------------------------------------------------------
+class qSlicerCLIXmlArgumentRunnable : public QRunnable
+{
+public:
+  qSlicerCLIXmlArgumentRunnable(const QString& path)
+    : Path(path)
+  {
+  }
+  void run() override
+  {
+    this->Result.set_value(qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument(this->Path));
+  }
+  QString Path;
+  std::promise<qSlicerCLIExecutableModuleFactoryItem::XmlArgumentResult> Result;
+};
+
+} // end of anonymous namespace
+
 //-----------------------------------------------------------------------------
 QString findPython()
 {
@@ -49,15 +73,27 @@ QString findPython()
 
 //-----------------------------------------------------------------------------
 qSlicerCLIExecutableModuleFactoryItem::qSlicerCLIExecutableModuleFactoryItem(
-  const QString& newTempDirectory)
+  const QString& newTempDirectory, qSlicerCLIModuleDescriptionCache* descriptionCache)
   : TempDirectory(newTempDirectory)
   , CLIModule(nullptr)
+  , DescriptionCache(descriptionCache)
 {
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCLIExecutableModuleFactoryItem::load()
 {
+  if (QFile::exists(this->xmlModuleDescriptionFilePath())
+    || (this->DescriptionCache && !this->DescriptionCache->xmlDescription(this->path()).isEmpty()))
+    {
+    // description is available without running the executable
+    return true;
+    }
+  // The thread pool limits the number of concurrently running executables.
+  // The runnable is deleted by the thread pool when it is completed.
+  qSlicerCLIXmlArgumentRunnable* runnable = new qSlicerCLIXmlArgumentRunnable(this->path());
+  this->XmlArgumentResultFuture = runnable->Result.get_future();
+  QThreadPool::globalInstance()->start(runnable);
   return true;
 }
 
@@ -98,7 +134,7 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
 
   //
   // If the xml file exists, read it and associate it with the module
-  // description. If not, run the CLI executable with "--xml".
+  // description. If not, use the cached description or run the CLI executable with "--xml".
   //
   QString xmlDescription;
   if (QFile::exists(xmlFilePath))
@@ -116,7 +152,18 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
     }
   else
     {
-    xmlDescription = this->runCLIWithXmlArgument();
+    if (this->DescriptionCache)
+      {
+      xmlDescription = this->DescriptionCache->xmlDescription(this->path());
+      }
+    if (xmlDescription.isEmpty())
+      {
+      xmlDescription = this->runCLIWithXmlArgument();
+      if (this->DescriptionCache)
+        {
+        this->DescriptionCache->setXmlDescription(this->path(), xmlDescription);
+        }
+      }
     }
   if (xmlDescription.isEmpty())
     {
@@ -137,18 +184,45 @@ qSlicerAbstractCoreModule* qSlicerCLIExecutableModuleFactoryItem::instanciator()
 //-----------------------------------------------------------------------------
 QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
 {
-  ctkScopedCurrentDir scopedCurrentDir(QFileInfo(this->path()).path());
+  XmlArgumentResult result;
+  if (this->XmlArgumentResultFuture.valid())
+    {
+    result = this->XmlArgumentResultFuture.get();
+    }
+  else
+    {
+    result = qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument(this->path());
+    }
+  foreach(const QString& errorString, result.ErrorStrings)
+    {
+    this->appendInstantiateErrorString(errorString);
+    }
+  foreach(const QString& warningString, result.WarningStrings)
+    {
+    this->appendInstantiateWarningString(warningString);
+    }
+  return result.XmlDescription;
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIExecutableModuleFactoryItem::XmlArgumentResult
+qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument(const QString& path)
+{
+  XmlArgumentResult result;
 
   int cliProcessTimeoutInMs = 5000;
   QProcess cli;
   QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
   env.insert("ITK_AUTOLOAD_PATH", "");
   cli.setProcessEnvironment(env);
-  cli.start(this->path(), QStringList(QString("--xml")));
+  // The working directory is set for the process instead of changing the
+  // current directory of the application, as CLIs may run concurrently.
+  cli.setWorkingDirectory(QFileInfo(path).path());
+  cli.start(path, QStringList(QString("--xml")));
   bool res = cli.waitForFinished(cliProcessTimeoutInMs);
   if (!res)
     {
-    this->appendInstantiateErrorString(QString("CLI executable: %1").arg(this->path()));
+    result.ErrorStrings << QString("CLI executable: %1").arg(path);
     QString errorString;
     switch(cli.error())
       {
@@ -180,14 +254,14 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
               "Failed to execute process. An unknown error occurred.");
         break;
       }
-    this->appendInstantiateErrorString(errorString);
-    return nullptr;
+    result.ErrorStrings << errorString;
+    return result;
     }
   QString errors = cli.readAllStandardError();
   if (!errors.isEmpty())
     {
-    this->appendInstantiateErrorString(QString("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString(errors);
+    result.ErrorStrings << QString("CLI executable: %1").arg(path);
+    result.ErrorStrings << errors;
     // TODO: More investigation for the following behavior:
     // on my machine (Ubuntu 10.04 with ITKv4), having standard error trims the
     // standard output results. The following readAllStandardOutput() is then
@@ -198,19 +272,20 @@ QString qSlicerCLIExecutableModuleFactoryItem::runCLIWithXmlArgument()
   QString xmlDescription = cli.readAllStandardOutput();
   if (xmlDescription.isEmpty())
     {
-    this->appendInstantiateErrorString(QString("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateErrorString("Failed to retrieve Xml Description");
-    return QString();
+    result.ErrorStrings << QString("CLI executable: %1").arg(path);
+    result.ErrorStrings << "Failed to retrieve Xml Description";
+    return result;
     }
   if (!xmlDescription.startsWith("<?xml"))
     {
-    this->appendInstantiateWarningString(QString("CLI executable: %1").arg(this->path()));
-    this->appendInstantiateWarningString(QLatin1String("XML description doesn't start right away."));
-    this->appendInstantiateWarningString(QString("Output before '<?xml' is [%1]").arg(
-                                           xmlDescription.mid(0, xmlDescription.indexOf("<?xml"))));
+    result.WarningStrings << QString("CLI executable: %1").arg(path);
+    result.WarningStrings << QLatin1String("XML description doesn't start right away.");
+    result.WarningStrings << QString("Output before '<?xml' is [%1]").arg(
+                               xmlDescription.mid(0, xmlDescription.indexOf("<?xml")));
     xmlDescription.remove(0, xmlDescription.indexOf("<?xml"));
     }
-  return xmlDescription;
+  result.XmlDescription = xmlDescription;
+  return result;
 }
 
 //-----------------------------------------------------------------------------
@@ -235,6 +310,7 @@ public:
 
 private:
   QString TempDirectory;
+  qSlicerCLIModuleDescriptionCache DescriptionCache;
 };
 
 //-----------------------------------------------------------------------------
@@ -285,7 +361,7 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLIExecutableModuleFac
 ::createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLIExecutableModuleFactory);
-  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLIExecutableModuleFactoryItem(d->TempDirectory, &d->DescriptionCache);
 }
 
 //-----------------------------------------------------------------------------
@@ -300,3 +376,24 @@ void qSlicerCLIExecutableModuleFactory::setTempDirectory(const QString& newTempD
   Q_D(qSlicerCLIExecutableModuleFactory);
   d->TempDirectory = newTempDirectory;
 }
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIExecutableModuleFactory::setModuleDescriptionCacheFilePath(const QString& filePath)
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  d->DescriptionCache.setFilePath(filePath);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIExecutableModuleFactory::moduleDescriptionCacheFilePath()const
+{
+  Q_D(const qSlicerCLIExecutableModuleFactory);
+  return d->DescriptionCache.filePath();
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLIExecutableModuleFactory::saveModuleDescriptionCache()
+{
+  Q_D(qSlicerCLIExecutableModuleFactory);
+  return d->DescriptionCache.save();
+}
@@ -25,28 +25,51 @@
 #include "qSlicerAbstractCoreModule.h"
 #include "qSlicerBaseQTCLIExport.h"
 class qSlicerCLIModule;
+class qSlicerCLIModuleDescriptionCache;
 
 // CTK includes
 #include <ctkPimpl.h>
 #include <ctkAbstractPluginFactory.h>
 
+// STD includes
+#include <future>
+
 //-----------------------------------------------------------------------------
 class qSlicerCLIExecutableModuleFactoryItem
   : public ctkAbstractFactoryFileBasedItem<qSlicerAbstractCoreModule>
 {
 public:
-  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLIExecutableModuleFactoryItem(const QString& newTempDirectory,
+    qSlicerCLIModuleDescriptionCache* descriptionCache = nullptr);
+  /// Start retrieving the XML description in a background thread if it is
+  /// not available in a file or in the description cache. Descriptions of
+  /// all modules are retrieved in parallel, while the modules are registered.
   bool load() override;
   void uninstantiate() override;
+
+  /// Output of running the CLI with "--xml" argument
+  struct XmlArgumentResult
+    {
+    QString XmlDescription;
+    QStringList ErrorStrings;
+    QStringList WarningStrings;
+    };
+  /// Run CLI executable at \a path with "--xml" argument. Thread-safe.
+  static XmlArgumentResult runCLIWithXmlArgument(const QString& path);
+
 protected:
   /// Return path of the expected XML file.
   QString xmlModuleDescriptionFilePath();
 
   qSlicerAbstractCoreModule* instanciator() override;
+  /// Get result of the background process started in load() or run the CLI
+  /// if it was not started.
   QString runCLIWithXmlArgument();
 private:
   QString TempDirectory;
   qSlicerCLIModule* CLIModule;
+  qSlicerCLIModuleDescriptionCache* DescriptionCache;
+  std::future<XmlArgumentResult> XmlArgumentResultFuture;
 };
 
 class qSlicerCLIExecutableModuleFactoryPrivate;
@@ -71,6 +94,19 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Set file that stores XML descriptions of the modules, so that the executables
+  /// do not have to be run at the next startup. If empty (default) then descriptions are not cached.
+  /// \sa qSlicerCLIModuleDescriptionCache
+  void setModuleDescriptionCacheFilePath(const QString& filePath);
+  QString moduleDescriptionCacheFilePath()const;
+
+  /// Write the module descriptions retrieved since the cache file was read.
+  /// Called once the modules are instantiated, so that descriptions are not lost
+  /// if the application does not exit normally. The cache is also saved when the
+  /// factory is deleted.
+  /// \sa qSlicerCLIModuleDescriptionCache::save()
+  bool saveModuleDescriptionCache();
+
 protected:
   bool isValidFile(const QFileInfo& file)const override;
 
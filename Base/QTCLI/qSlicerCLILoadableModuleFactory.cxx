@@ -23,6 +23,7 @@
 // Slicer includes
 #include "qSlicerCLILoadableModuleFactory.h"
 #include "qSlicerCLIModule.h"
+#include "qSlicerCLIModuleDescriptionCache.h"
 #include "qSlicerCLIModuleFactoryHelper.h"
 #include "qSlicerUtils.h"
 
@@ -31,16 +32,22 @@
 
 //-----------------------------------------------------------------------------
 qSlicerCLILoadableModuleFactoryItem::qSlicerCLILoadableModuleFactoryItem(
-  const QString& newTempDirectory) : TempDirectory(newTempDirectory)
+  const QString& newTempDirectory, qSlicerCLIModuleDescriptionCache* descriptionCache)
+  : TempDirectory(newTempDirectory)
+  , DescriptionCache(descriptionCache)
 {
 }
 
 //-----------------------------------------------------------------------------
 bool qSlicerCLILoadableModuleFactoryItem::load()
 {
-  // If XML description file exists, skip loading. It will be
+  if (this->DescriptionCache && !QFile::exists(this->xmlModuleDescriptionFilePath()))
+    {
+    this->CachedXmlDescription = this->DescriptionCache->xmlDescription(this->path());
+    }
+  // If XML description file exists or the description is cached, skip loading. It will be
   // lazily done by calling ModuleDescription::GetTarget() method.
-  if (!QFile::exists(this->xmlModuleDescriptionFilePath()))
+  if (!QFile::exists(this->xmlModuleDescriptionFilePath()) && this->CachedXmlDescription.isEmpty())
     {
     return this->Superclass::load();
     }
@@ -91,9 +98,9 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
   QString xmlFilePath = this->xmlModuleDescriptionFilePath();
 
   //
-  // If the xml file exists, read it and associate it with the module
-  // description. The "ModuleEntryPoint" address will be lazily retrieved
-  // after calling ModuleDescription::GetTarget() method.
+  // If the xml file exists or the description is cached, read it and associate
+  // it with the module description. The "ModuleEntryPoint" address will be lazily
+  // retrieved after calling ModuleDescription::GetTarget() method.
   //
   // If not, directly resolve the symbols "XMLModuleDescription" and
   // "ModuleEntryPoint" from the loaded library.
@@ -116,6 +123,12 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
     module->moduleDescription().SetTargetCallback(
           this, qSlicerCLILoadableModuleFactoryItem::loadLibraryAndResolveSymbols);
     }
+  else if (!this->CachedXmlDescription.isEmpty())
+    {
+    xmlDescription = this->CachedXmlDescription;
+    module->moduleDescription().SetTargetCallback(
+          this, qSlicerCLILoadableModuleFactoryItem::loadLibraryAndResolveSymbols);
+    }
   else
     {
     // Library is expected to already be loaded
@@ -125,6 +138,10 @@ qSlicerAbstractCoreModule* qSlicerCLILoadableModuleFactoryItem::instanciator()
       {
       return nullptr;
       }
+    if (this->DescriptionCache)
+      {
+      this->DescriptionCache->setXmlDescription(this->path(), xmlDescription);
+      }
     }
   if (xmlDescription.isEmpty())
     {
@@ -270,6 +287,7 @@ public:
 
 private:
   QString TempDirectory;
+  qSlicerCLIModuleDescriptionCache DescriptionCache;
 };
 
 //-----------------------------------------------------------------------------
@@ -314,7 +332,7 @@ ctkAbstractFactoryItem<qSlicerAbstractCoreModule>* qSlicerCLILoadableModuleFacto
 createFactoryFileBasedItem()
 {
   Q_D(qSlicerCLILoadableModuleFactory);
-  return new qSlicerCLILoadableModuleFactoryItem(d->TempDirectory);
+  return new qSlicerCLILoadableModuleFactoryItem(d->TempDirectory, &d->DescriptionCache);
 }
 
 //-----------------------------------------------------------------------------
@@ -330,6 +348,20 @@ void qSlicerCLILoadableModuleFactory::setTempDirectory(const QString& newTempDir
   d->TempDirectory = newTempDirectory;
 }
 
+//-----------------------------------------------------------------------------
+void qSlicerCLILoadableModuleFactory::setModuleDescriptionCacheFilePath(const QString& filePath)
+{
+  Q_D(qSlicerCLILoadableModuleFactory);
+  d->DescriptionCache.setFilePath(filePath);
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLILoadableModuleFactory::moduleDescriptionCacheFilePath()const
+{
+  Q_D(const qSlicerCLILoadableModuleFactory);
+  return d->DescriptionCache.filePath();
+}
+
 //-----------------------------------------------------------------------------
 bool qSlicerCLILoadableModuleFactory::isValidFile(const QFileInfo& file)const
 {
@@ -339,3 +371,10 @@ bool qSlicerCLILoadableModuleFactory::isValidFile(const QFileInfo& file)const
     }
   return qSlicerUtils::isCLILoadableModule(file.absoluteFilePath());
 }
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLILoadableModuleFactory::saveModuleDescriptionCache()
+{
+  Q_D(qSlicerCLILoadableModuleFactory);
+  return d->DescriptionCache.save();
+}
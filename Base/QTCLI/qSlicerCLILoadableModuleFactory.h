@@ -33,6 +33,7 @@
 class ModuleDescription;
 class ModuleLogo;
 class qSlicerCLIModule;
+class qSlicerCLIModuleDescriptionCache;
 
 //-----------------------------------------------------------------------------
 class qSlicerCLILoadableModuleFactoryItem
@@ -40,7 +41,10 @@ class qSlicerCLILoadableModuleFactoryItem
 {
 public:
   typedef ctkFactoryLibraryItem<qSlicerAbstractCoreModule> Superclass;
-  qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory);
+  qSlicerCLILoadableModuleFactoryItem(const QString& newTempDirectory,
+    qSlicerCLIModuleDescriptionCache* descriptionCache = nullptr);
+  /// Library is not loaded if the XML description is available in a file
+  /// or in the description cache. It will be loaded when the module is run.
   bool load() override;
 
   static void loadLibraryAndResolveSymbols(
@@ -56,6 +60,9 @@ protected:
   static bool updateLogo(qSlicerCLILoadableModuleFactoryItem* item, ModuleLogo& logo);
 private:
   QString TempDirectory;
+  qSlicerCLIModuleDescriptionCache* DescriptionCache;
+  /// Description found in the cache when the item was loaded
+  QString CachedXmlDescription;
 };
 
 class qSlicerCLILoadableModuleFactoryPrivate;
@@ -82,6 +89,19 @@ public:
 
   void setTempDirectory(const QString& newTempDirectory);
 
+  /// Set file that stores XML descriptions of the modules, so that the libraries
+  /// do not have to be loaded at the next startup. If empty (default) then descriptions are not cached.
+  /// \sa qSlicerCLIModuleDescriptionCache
+  void setModuleDescriptionCacheFilePath(const QString& filePath);
+  QString moduleDescriptionCacheFilePath()const;
+
+  /// Write the module descriptions retrieved since the cache file was read.
+  /// Called once the modules are instantiated, so that descriptions are not lost
+  /// if the application does not exit normally. The cache is also saved when the
+  /// factory is deleted.
+  /// \sa qSlicerCLIModuleDescriptionCache::save()
+  bool saveModuleDescriptionCache();
+
 protected:
   ctkAbstractFactoryItem<qSlicerAbstractCoreModule>*
     createFactoryFileBasedItem() override;
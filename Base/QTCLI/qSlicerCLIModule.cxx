@@ -103,6 +103,17 @@ vtkMRMLAbstractLogic* qSlicerCLIModule::createLogic()
     logic->SetAllowInMemoryTransfer(0);
     }
 
+  // Built-in executables read and write images with ITK after registering the
+  // shared memory image IO. Other modules must opt in from their description,
+  // built-in modules that can't read "shm:/" images opt out.
+  std::string allowSharedMemoryTransfer = d->Desc.GetParameterValue("AllowSharedMemoryTransfer");
+  if (allowSharedMemoryTransfer == "true"
+      || (allowSharedMemoryTransfer != "false" && this->isBuiltIn()
+          && settings.value("Modules/CLISharedMemoryTransfer", true).toBool()))
+    {
+    logic->SetAllowSharedMemoryTransfer(1);
+    }
+
   return logic;
 }
 
@@ -0,0 +1,231 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Qt includes
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSaveFile>
+
+// QtCLI includes
+#include "qSlicerCLIModuleDescriptionCache.h"
+
+namespace
+{
+// Identifies the file format, must be changed if the format changes
+const quint32 CacheFileMagicNumber = 0x534c4344; // "SLCD"
+const quint32 CacheFileVersion = 1;
+}
+
+//-----------------------------------------------------------------------------
+class qSlicerCLIModuleDescriptionCachePrivate
+{
+public:
+  struct CacheEntry
+    {
+    qint64 Size;
+    qint64 LastModified;
+    QString XmlDescription;
+    };
+
+  qSlicerCLIModuleDescriptionCachePrivate();
+
+  /// Read all entries from the cache file
+  void read();
+
+  static QString key(const QString& modulePath);
+
+  QString FilePath;
+  QMap<QString, CacheEntry> Entries;
+  bool Modified;
+};
+
+//-----------------------------------------------------------------------------
+qSlicerCLIModuleDescriptionCachePrivate::qSlicerCLIModuleDescriptionCachePrivate()
+{
+  this->Modified = false;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIModuleDescriptionCachePrivate::key(const QString& modulePath)
+{
+  return QFileInfo(modulePath).absoluteFilePath();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIModuleDescriptionCachePrivate::read()
+{
+  this->Entries.clear();
+  this->Modified = false;
+  QFile file(this->FilePath);
+  if (this->FilePath.isEmpty() || !file.exists())
+    {
+    return;
+    }
+  if (!file.open(QIODevice::ReadOnly))
+    {
+    qWarning() << "Failed to read CLI module description cache:" << this->FilePath;
+    return;
+    }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  quint32 magicNumber = 0;
+  quint32 version = 0;
+  stream >> magicNumber >> version;
+  if (magicNumber != CacheFileMagicNumber || version != CacheFileVersion)
+    {
+    // Created by a different application version, it will be overwritten
+    return;
+    }
+  quint32 numberOfEntries = 0;
+  stream >> numberOfEntries;
+  QMap<QString, CacheEntry> entries;
+  for (quint32 entryIndex = 0; entryIndex < numberOfEntries && stream.status() == QDataStream::Ok; ++entryIndex)
+    {
+    QString modulePath;
+    CacheEntry entry;
+    stream >> modulePath >> entry.Size >> entry.LastModified >> entry.XmlDescription;
+    entries[modulePath] = entry;
+    }
+  if (stream.status() != QDataStream::Ok)
+    {
+    qWarning() << "Invalid CLI module description cache, it will be overwritten:" << this->FilePath;
+    return;
+    }
+  this->Entries = entries;
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIModuleDescriptionCache::qSlicerCLIModuleDescriptionCache()
+  : d_ptr(new qSlicerCLIModuleDescriptionCachePrivate)
+{
+}
+
+//-----------------------------------------------------------------------------
+qSlicerCLIModuleDescriptionCache::~qSlicerCLIModuleDescriptionCache()
+{
+  this->save();
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIModuleDescriptionCache::setFilePath(const QString& filePath)
+{
+  Q_D(qSlicerCLIModuleDescriptionCache);
+  if (d->FilePath == filePath)
+    {
+    return;
+    }
+  d->FilePath = filePath;
+  d->read();
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIModuleDescriptionCache::filePath()const
+{
+  Q_D(const qSlicerCLIModuleDescriptionCache);
+  return d->FilePath;
+}
+
+//-----------------------------------------------------------------------------
+QString qSlicerCLIModuleDescriptionCache::xmlDescription(const QString& modulePath)const
+{
+  Q_D(const qSlicerCLIModuleDescriptionCache);
+  QMap<QString, qSlicerCLIModuleDescriptionCachePrivate::CacheEntry>::const_iterator entryIt =
+    d->Entries.constFind(qSlicerCLIModuleDescriptionCachePrivate::key(modulePath));
+  if (entryIt == d->Entries.constEnd())
+    {
+    return QString();
+    }
+  QFileInfo moduleFileInfo(modulePath);
+  if (!moduleFileInfo.exists()
+    || moduleFileInfo.size() != entryIt->Size
+    || moduleFileInfo.lastModified().toMSecsSinceEpoch() != entryIt->LastModified)
+    {
+    // module has been updated since the description was stored
+    return QString();
+    }
+  return entryIt->XmlDescription;
+}
+
+//-----------------------------------------------------------------------------
+void qSlicerCLIModuleDescriptionCache::setXmlDescription(const QString& modulePath, const QString& xmlDescription)
+{
+  Q_D(qSlicerCLIModuleDescriptionCache);
+  QFileInfo moduleFileInfo(modulePath);
+  if (!moduleFileInfo.exists() || xmlDescription.isEmpty())
+    {
+    return;
+    }
+  qSlicerCLIModuleDescriptionCachePrivate::CacheEntry entry;
+  entry.Size = moduleFileInfo.size();
+  entry.LastModified = moduleFileInfo.lastModified().toMSecsSinceEpoch();
+  entry.XmlDescription = xmlDescription;
+  d->Entries[qSlicerCLIModuleDescriptionCachePrivate::key(modulePath)] = entry;
+  d->Modified = true;
+}
+
+//-----------------------------------------------------------------------------
+bool qSlicerCLIModuleDescriptionCache::save()
+{
+  Q_D(qSlicerCLIModuleDescriptionCache);
+  if (!d->Modified || d->FilePath.isEmpty())
+    {
+    return true;
+    }
+
+  // Remove entries of modules that have been uninstalled
+  QMap<QString, qSlicerCLIModuleDescriptionCachePrivate::CacheEntry>::iterator entryIt = d->Entries.begin();
+  while (entryIt != d->Entries.end())
+    {
+    if (QFile::exists(entryIt.key()))
+      {
+      ++entryIt;
+      }
+    else
+      {
+      entryIt = d->Entries.erase(entryIt);
+      }
+    }
+
+  QDir().mkpath(QFileInfo(d->FilePath).absolutePath());
+  // The file is replaced only when it is completely written, so that
+  // concurrently started applications do not read a partially written file.
+  QSaveFile file(d->FilePath);
+  if (!file.open(QIODevice::WriteOnly))
+    {
+    qWarning() << "Failed to write CLI module description cache:" << d->FilePath;
+    return false;
+    }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << CacheFileMagicNumber << CacheFileVersion << quint32(d->Entries.size());
+  for (entryIt = d->Entries.begin(); entryIt != d->Entries.end(); ++entryIt)
+    {
+    stream << entryIt.key() << entryIt->Size << entryIt->LastModified << entryIt->XmlDescription;
+    }
+  if (!file.commit())
+    {
+    qWarning() << "Failed to write CLI module description cache:" << d->FilePath;
+    return false;
+    }
+  d->Modified = false;
+  return true;
+}
@@ -0,0 +1,73 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __qSlicerCLIModuleDescriptionCache_h
+#define __qSlicerCLIModuleDescriptionCache_h
+
+// Qt includes
+#include <QScopedPointer>
+#include <QString>
+
+#include "qSlicerBaseQTCLIExport.h"
+
+class qSlicerCLIModuleDescriptionCachePrivate;
+
+/// \brief Persistent cache of XML descriptions of CLI modules.
+///
+/// Getting the description of a CLI module requires running the executable
+/// with "--xml" argument or loading the shared library, which takes a long time
+/// if there are many modules. The cache stores the descriptions in a file,
+/// so that they can be reused at the next application startup.
+///
+/// Entries are identified by the path of the module file and they are only
+/// used if the size and last modification time of the module file have not
+/// changed since the description was stored.
+///
+/// The cache is only accessed from the main thread.
+class Q_SLICER_BASE_QTCLI_EXPORT qSlicerCLIModuleDescriptionCache
+{
+public:
+  qSlicerCLIModuleDescriptionCache();
+  /// The cache is saved if entries are changed.
+  virtual ~qSlicerCLIModuleDescriptionCache();
+
+  /// Set the file that stores the descriptions and read the descriptions from it.
+  /// If empty (default) then descriptions are only kept in memory.
+  void setFilePath(const QString& filePath);
+  QString filePath()const;
+
+  /// Get XML description of the module at \a modulePath.
+  /// Returns an empty string if the description is not cached or the module file has changed.
+  QString xmlDescription(const QString& modulePath)const;
+
+  /// Store XML description of the module at \a modulePath.
+  void setXmlDescription(const QString& modulePath, const QString& xmlDescription);
+
+  /// Write descriptions to the cache file if entries have changed since
+  /// the file was read. Entries of module files that no longer exist are removed.
+  /// Returns false if the file could not be written.
+  bool save();
+
+protected:
+  QScopedPointer<qSlicerCLIModuleDescriptionCachePrivate> d_ptr;
+
+private:
+  Q_DECLARE_PRIVATE(qSlicerCLIModuleDescriptionCache);
+  Q_DISABLE_COPY(qSlicerCLIModuleDescriptionCache);
+};
+
+#endif
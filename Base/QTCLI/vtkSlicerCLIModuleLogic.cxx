@@ -30,10 +30,15 @@
 #include <vtkMRMLStorageNode.h>
 #include <vtkMRMLModelStorageNode.h>
 #include <vtkMRMLTransformNode.h>
+#include <vtkMRMLVolumeNode.h>
+
+// vtkITK includes
+#include <vtkITKSharedMemoryImage.h>
 
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkIntArray.h>
+#include <vtkMatrix4x4.h>
 #include <vtkMultiThreader.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
@@ -79,6 +84,14 @@ struct DigitsToCharacters
     }
 };
 
+//----------------------------------------------------------------------------
+// Serializes the execution of shared object modules of all the CLI logics
+static std::mutex& GetSharedObjectModuleMutex()
+{
+  static std::mutex sharedObjectModuleMutex;
+  return sharedObjectModuleMutex;
+}
+
 typedef std::pair<vtkSlicerCLIModuleLogic *, vtkMRMLCommandLineModuleNode *> LogicNodePair;
 class MRMLIDMap : public std::map<std::string, std::string> {};
 
@@ -199,6 +212,7 @@ public:
   ModuleDescription DefaultModuleDescription;
   int DeleteTemporaryFiles;
   int AllowInMemoryTransfer;
+  int AllowSharedMemoryTransfer;
 
   int RedirectModuleStreams;
 
@@ -300,6 +314,7 @@ vtkSlicerCLIModuleLogic::vtkSlicerCLIModuleLogic()
 
   this->Internal->DeleteTemporaryFiles = 1;
   this->Internal->AllowInMemoryTransfer = 1;
+  this->Internal->AllowSharedMemoryTransfer = 0;
   this->Internal->RedirectModuleStreams = 1;
   this->Internal->RescheduleCallback =
     vtkSmartPointer<vtkSlicerCLIRescheduleCallback>::New();
@@ -403,6 +418,22 @@ int vtkSlicerCLIModuleLogic::GetAllowInMemoryTransfer() const
   return this->Internal->AllowInMemoryTransfer;
 }
 
+//----------------------------------------------------------------------------
+void vtkSlicerCLIModuleLogic::SetAllowSharedMemoryTransfer(int value)
+{
+  vtkDebugMacro(<< this->GetClassName() << " (" << this << "): setting AllowSharedMemoryTransfer to " << value);
+  if (this->Internal->AllowSharedMemoryTransfer != value)
+    {
+    this->Internal->AllowSharedMemoryTransfer = value;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkSlicerCLIModuleLogic::GetAllowSharedMemoryTransfer() const
+{
+  return this->Internal->AllowSharedMemoryTransfer;
+}
+
 //----------------------------------------------------------------------------
 void vtkSlicerCLIModuleLogic::RedirectModuleStreamsOn()
 {
@@ -479,6 +510,25 @@ vtkSlicerCLIModuleLogic
   return fname;
 }
 
+//----------------------------------------------------------------------------
+bool vtkSlicerCLIModuleLogic
+::CanTransferImageThroughSharedMemory(vtkMRMLNode* node, const std::string& type)
+{
+  if (!node || this->GetAllowSharedMemoryTransfer() == 0
+      || !vtkITKSharedMemoryImage::IsSupported())
+    {
+    return false;
+    }
+  if (!type.empty() && type != "scalar" && type != "label")
+    {
+    return false;
+    }
+  // Diffusion and vector volumes derive from scalar volumes but require
+  // their storage node to write the additional metadata.
+  return strcmp(node->GetClassName(), "vtkMRMLScalarVolumeNode") == 0
+    || strcmp(node->GetClassName(), "vtkMRMLLabelMapVolumeNode") == 0;
+}
+
 //----------------------------------------------------------------------------
 std::string
 vtkSlicerCLIModuleLogic
@@ -916,6 +966,10 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
   // vector of files to delete
   std::set<std::string> filesToDelete;
 
+  // map from shared memory image names to the temporary files used
+  // if the image cannot be exchanged through shared memory
+  std::map<std::string, std::string> sharedMemoryFallbackFileNames;
+
   // iterators for parameter groups
   std::vector<ModuleParameterGroup>::iterator pgbeginit
     = node0->GetModuleDescription().GetParameterGroups().begin();
@@ -965,6 +1019,17 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
                                              (*pit).GetFileExtensions(),
                                              commandType);
 
+        // Scalar volumes are exchanged with executables through shared
+        // memory instead of temporary files when the platform allows it.
+        if ((*pit).GetTag() == "image" && commandType == CommandLineModule
+            && this->CanTransferImageThroughSharedMemory(
+                 this->GetMRMLScene()->GetNodeByID(id.c_str()), (*pit).GetType()))
+          {
+          std::string sharedMemoryName = vtkITKSharedMemoryImage::CreateUniqueFileName();
+          sharedMemoryFallbackFileNames[sharedMemoryName] = fname;
+          fname = sharedMemoryName;
+          }
+
         filesToDelete.insert(fname);
         if ((*pit).GetChannel() == "input")
           {
@@ -1114,6 +1179,31 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
         }
       }
 
+    // write the image into shared memory, fall back to the temporary
+    // file if it fails (e.g. not enough shared memory available)
+    if (out && vtkITKSharedMemoryImage::IsSharedMemoryFileName((*id2fn0).second.c_str()))
+      {
+      vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(nd);
+      vtkNew<vtkMatrix4x4> ijkToRAS;
+      volumeNode->GetIJKToRASMatrix(ijkToRAS.GetPointer());
+      if (vtkITKSharedMemoryImage::WriteImage(volumeNode->GetImageData(),
+            ijkToRAS.GetPointer(), (*id2fn0).second.c_str()))
+        {
+        out = nullptr;
+        }
+      else
+        {
+        vtkWarningMacro("Unable to write " << nd->GetID() << " into shared memory, "
+                        << "a temporary file is used instead");
+        std::string fname = sharedMemoryFallbackFileNames[(*id2fn0).second];
+        vtkITKSharedMemoryImage::RemoveImage((*id2fn0).second.c_str());
+        filesToDelete.erase((*id2fn0).second);
+        filesToDelete.insert(fname);
+        // the iterator stays valid, only the mapped value is changed
+        nodesToWrite[(*id2fn0).first] = fname;
+        }
+      }
+
     // if the file is to be written, then write it
     if (out)
       {
@@ -2156,6 +2246,11 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     //
     //
 
+    // The module output is captured by redirecting the process-wide std::cout
+    // and std::cerr streams, therefore only one shared object module can run
+    // at a time. Executable modules run concurrently.
+    std::lock_guard<std::mutex> sharedObjectModuleLock(GetSharedObjectModuleMutex());
+
     std::ostringstream coutstringstream;
     std::ostringstream cerrstringstream;
     std::streambuf* origcoutrdbuf = std::cout.rdbuf();
@@ -2582,7 +2677,12 @@ void vtkSlicerCLIModuleLogic::ApplyTask(void *clientdata)
     std::set<std::string>::iterator fit;
     for (fit = filesToDelete.begin(); fit != filesToDelete.end(); ++fit)
       {
-      if (itksys::SystemTools::FileExists((*fit).c_str()))
+      if (vtkITKSharedMemoryImage::IsSharedMemoryFileName((*fit).c_str()))
+        {
+        // Outputs of a failed or cancelled module may not exist
+        vtkITKSharedMemoryImage::RemoveImage((*fit).c_str());
+        }
+      else if (itksys::SystemTools::FileExists((*fit).c_str()))
         {
         removed = itksys::SystemTools::RemoveFile((*fit).c_str());
         if (!removed)
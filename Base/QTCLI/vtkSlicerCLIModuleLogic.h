@@ -91,6 +91,16 @@ public:
   void SetAllowInMemoryTransfer(int value);
   int GetAllowInMemoryTransfer() const;
 
+  /// Control use of shared memory instead of temporary files to exchange
+  /// scalar volumes with executable CLIs. Disabled by default, as only
+  /// executables that read and write images with ITK after calling
+  /// itkFactoryRegistration() can access "shm:/" image names.
+  /// qSlicerCLIModule::createLogic() enables it for built-in modules unless
+  /// the "Modules/CLISharedMemoryTransfer" setting is off. The default of an
+  /// "AllowSharedMemoryTransfer" parameter in the XML description overrides it.
+  void SetAllowSharedMemoryTransfer(int value);
+  int GetAllowSharedMemoryTransfer() const;
+
   /// For debugging, control redirection of cout and cerr
   virtual void RedirectModuleStreamsOn();
   virtual void RedirectModuleStreamsOff();
@@ -140,6 +150,9 @@ protected:
                                      const std::vector<std::string>& extensions,
                                      CommandLineModuleType commandType);
   std::string ConstructTemporarySceneFileName(vtkMRMLScene *scene);
+  /// Return true if \a node can be exchanged through shared memory
+  /// for an image parameter of the given type.
+  bool CanTransferImageThroughSharedMemory(vtkMRMLNode* node, const std::string& type);
   std::string FindHiddenNodeID(const ModuleDescription& d,
                                const ModuleParameter& p);
 
@@ -185,6 +185,14 @@ void qSlicerAbstractModuleFactoryManager::unregisterFactories()
     }
 }
 
+//-----------------------------------------------------------------------------
+QList<qSlicerAbstractModuleFactoryManager::qSlicerModuleFactory*>
+qSlicerAbstractModuleFactoryManager::registeredFactories()const
+{
+  Q_D(const qSlicerAbstractModuleFactoryManager);
+  return d->Factories.keys();
+}
+
 //-----------------------------------------------------------------------------
 void qSlicerAbstractModuleFactoryManager::setSearchPaths(const QStringList& paths)
 {
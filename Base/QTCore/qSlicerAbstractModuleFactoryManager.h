@@ -116,6 +116,8 @@ public:
   void registerFactory(qSlicerModuleFactory* factory, int priority = 0);
   void unregisterFactory(qSlicerModuleFactory* factory);
   void unregisterFactories();
+  /// Return the registered factories.
+  QList<qSlicerModuleFactory*> registeredFactories()const;
 
   void setSearchPaths(const QStringList& searchPaths);
   QStringList searchPaths()const;
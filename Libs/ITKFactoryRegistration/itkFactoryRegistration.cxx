@@ -1,5 +1,6 @@
 
 #include "itkFactoryRegistration.h"
+#include "itkSharedMemoryImageIOFactory.h"
 
 // ITK includes
 #include <itkImageFileReader.h>
@@ -10,5 +11,12 @@
 // optimized out by the compiler.
 void itk::itkFactoryRegistration()
 {
-  return;
+  // Allow executable command line modules to exchange images
+  // with Slicer through shared memory.
+  static bool sharedMemoryImageIORegistered = false;
+  if (!sharedMemoryImageIORegistered)
+    {
+    itk::SharedMemoryImageIOFactory::RegisterOneFactory();
+    sharedMemoryImageIORegistered = true;
+    }
 }
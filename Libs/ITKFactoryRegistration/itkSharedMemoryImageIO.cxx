@@ -0,0 +1,309 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "itkSharedMemoryImageIO.h"
+
+// STD includes
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+namespace
+{
+
+const char SharedMemoryFileNamePrefix[] = "shm:";
+const char SharedMemorySignature[8] = { 'S', 'L', 'I', 'C', 'E', 'R', 'S', 'M' };
+const unsigned int SharedMemoryMaximumDimension = 3;
+
+//----------------------------------------------------------------------------
+/// Layout of the beginning of the shared memory object, the pixel data
+/// starts at DataOffset. Both processes run on the same machine, no byte
+/// swapping is needed.
+struct SharedMemoryImageHeader
+{
+  char Signature[8];
+  uint32_t NumberOfDimensions;
+  uint32_t ComponentType;
+  uint32_t PixelType;
+  uint32_t NumberOfComponents;
+  uint64_t Dimensions[SharedMemoryMaximumDimension];
+  double Spacing[SharedMemoryMaximumDimension];
+  double Origin[SharedMemoryMaximumDimension];
+  double Direction[SharedMemoryMaximumDimension][SharedMemoryMaximumDimension];
+  uint64_t DataOffset;
+  uint64_t DataSize;
+};
+
+//----------------------------------------------------------------------------
+std::string GetSharedMemoryName(const std::string& fileName)
+{
+  return fileName.substr(sizeof(SharedMemoryFileNamePrefix) - 1);
+}
+
+#ifndef _WIN32
+//----------------------------------------------------------------------------
+/// Map the shared memory object read-only. Return nullptr on failure.
+void* MapSharedMemory(const std::string& fileName, size_t& size)
+{
+  int fd = shm_open(GetSharedMemoryName(fileName).c_str(), O_RDONLY, 0);
+  if (fd < 0)
+    {
+    return nullptr;
+    }
+  struct stat status;
+  if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(SharedMemoryImageHeader)))
+    {
+    close(fd);
+    return nullptr;
+    }
+  size = static_cast<size_t>(status.st_size);
+  void* memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED)
+    {
+    return nullptr;
+    }
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(memory);
+  if (memcmp(header->Signature, SharedMemorySignature, sizeof(SharedMemorySignature)) != 0
+    || header->DataOffset + header->DataSize > size)
+    {
+    munmap(memory, size);
+    return nullptr;
+    }
+  return memory;
+}
+#endif
+
+} // end of anonymous namespace
+
+namespace itk
+{
+
+//----------------------------------------------------------------------------
+SharedMemoryImageIO::SharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+SharedMemoryImageIO::~SharedMemoryImageIO() = default;
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::IsSupported()
+{
+#ifdef _WIN32
+  return false;
+#else
+  return true;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::IsSharedMemoryFileName(const std::string& fileName)
+{
+  return fileName.compare(0, sizeof(SharedMemoryFileNamePrefix) - 1, SharedMemoryFileNamePrefix) == 0
+    && fileName.size() > sizeof(SharedMemoryFileNamePrefix);
+}
+
+//----------------------------------------------------------------------------
+std::string SharedMemoryImageIO::CreateUniqueFileName()
+{
+  static std::atomic<unsigned int> counter(0);
+  std::ostringstream fileName;
+  // Names are limited to 31 characters on macOS
+  fileName << SharedMemoryFileNamePrefix << "/slicer_";
+#ifndef _WIN32
+  fileName << getpid() << "_";
+#endif
+  fileName << counter++;
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::RemoveSharedMemory(const std::string& fileName)
+{
+  if (!SharedMemoryImageIO::IsSharedMemoryFileName(fileName))
+    {
+    return false;
+    }
+#ifdef _WIN32
+  return false;
+#else
+  return shm_unlink(GetSharedMemoryName(fileName).c_str()) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::CanReadFile(const char* fileName)
+{
+  if (!fileName || !SharedMemoryImageIO::IsSupported()
+    || !SharedMemoryImageIO::IsSharedMemoryFileName(fileName))
+    {
+    return false;
+    }
+#ifndef _WIN32
+  size_t size = 0;
+  void* memory = MapSharedMemory(fileName, size);
+  if (!memory)
+    {
+    return false;
+    }
+  munmap(memory, size);
+#endif
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void SharedMemoryImageIO::ReadImageInformation()
+{
+#ifdef _WIN32
+  itkExceptionMacro("Shared memory is not supported on this platform");
+#else
+  size_t size = 0;
+  void* memory = MapSharedMemory(m_FileName, size);
+  if (!memory)
+    {
+    itkExceptionMacro("Failed to open shared memory image " << m_FileName);
+    }
+  SharedMemoryImageHeader header;
+  memcpy(&header, memory, sizeof(header));
+  munmap(memory, size);
+
+  if (header.NumberOfDimensions == 0 || header.NumberOfDimensions > SharedMemoryMaximumDimension)
+    {
+    itkExceptionMacro("Invalid number of dimensions in shared memory image " << m_FileName);
+    }
+  this->SetNumberOfDimensions(header.NumberOfDimensions);
+  for (unsigned int i = 0; i < header.NumberOfDimensions; ++i)
+    {
+    this->SetDimensions(i, header.Dimensions[i]);
+    this->SetSpacing(i, header.Spacing[i]);
+    this->SetOrigin(i, header.Origin[i]);
+    std::vector<double> direction(header.NumberOfDimensions);
+    for (unsigned int j = 0; j < header.NumberOfDimensions; ++j)
+      {
+      direction[j] = header.Direction[i][j];
+      }
+    this->SetDirection(i, direction);
+    }
+  this->SetComponentType(static_cast<IOComponentType>(header.ComponentType));
+  this->SetPixelType(static_cast<IOPixelType>(header.PixelType));
+  this->SetNumberOfComponents(header.NumberOfComponents);
+#endif
+}
+
+//----------------------------------------------------------------------------
+void SharedMemoryImageIO::Read(void* buffer)
+{
+#ifdef _WIN32
+  (void)buffer;
+  itkExceptionMacro("Shared memory is not supported on this platform");
+#else
+  size_t size = 0;
+  void* memory = MapSharedMemory(m_FileName, size);
+  if (!memory)
+    {
+    itkExceptionMacro("Failed to open shared memory image " << m_FileName);
+    }
+  const SharedMemoryImageHeader* header = static_cast<const SharedMemoryImageHeader*>(memory);
+  const SizeType imageSizeInBytes = this->GetImageSizeInBytes();
+  if (header->DataSize != imageSizeInBytes)
+    {
+    munmap(memory, size);
+    itkExceptionMacro("Unexpected data size in shared memory image " << m_FileName
+      << ": " << header->DataSize << " bytes instead of " << imageSizeInBytes);
+    }
+  memcpy(buffer, static_cast<const char*>(memory) + header->DataOffset, imageSizeInBytes);
+  munmap(memory, size);
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool SharedMemoryImageIO::CanWriteFile(const char* fileName)
+{
+  return fileName && SharedMemoryImageIO::IsSupported()
+    && SharedMemoryImageIO::IsSharedMemoryFileName(fileName);
+}
+
+//----------------------------------------------------------------------------
+void SharedMemoryImageIO::Write(const void* buffer)
+{
+#ifdef _WIN32
+  (void)buffer;
+  itkExceptionMacro("Shared memory is not supported on this platform");
+#else
+  const unsigned int numberOfDimensions = this->GetNumberOfDimensions();
+  if (numberOfDimensions == 0 || numberOfDimensions > SharedMemoryMaximumDimension)
+    {
+    itkExceptionMacro("Shared memory images support up to " << SharedMemoryMaximumDimension
+      << " dimensions, image has " << numberOfDimensions);
+    }
+
+  SharedMemoryImageHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.Signature, SharedMemorySignature, sizeof(SharedMemorySignature));
+  header.NumberOfDimensions = numberOfDimensions;
+  header.ComponentType = static_cast<uint32_t>(this->GetComponentType());
+  header.PixelType = static_cast<uint32_t>(this->GetPixelType());
+  header.NumberOfComponents = this->GetNumberOfComponents();
+  for (unsigned int i = 0; i < numberOfDimensions; ++i)
+    {
+    header.Dimensions[i] = this->GetDimensions(i);
+    header.Spacing[i] = this->GetSpacing(i);
+    header.Origin[i] = this->GetOrigin(i);
+    std::vector<double> direction = this->GetDirection(i);
+    for (unsigned int j = 0; j < numberOfDimensions && j < direction.size(); ++j)
+      {
+      header.Direction[i][j] = direction[j];
+      }
+    }
+  // keep the pixel data aligned
+  header.DataOffset = ((sizeof(header) + 63) / 64) * 64;
+  header.DataSize = this->GetImageSizeInBytes();
+  const size_t size = static_cast<size_t>(header.DataOffset + header.DataSize);
+
+  const std::string name = GetSharedMemoryName(m_FileName);
+  int fd = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+  if (fd < 0)
+    {
+    itkExceptionMacro("Failed to create shared memory image " << m_FileName);
+    }
+#ifdef __APPLE__
+  // shared memory objects are not file backed, the size is reserved when it is set
+  const int allocateError = ftruncate(fd, static_cast<off_t>(size));
+#else
+  // ftruncate does not reserve pages in /dev/shm: if it is too small then writing
+  // into the mapped memory would raise SIGBUS instead of reporting an error
+  const int allocateError = posix_fallocate(fd, 0, static_cast<off_t>(size));
+#endif
+  if (allocateError != 0)
+    {
+    close(fd);
+    shm_unlink(name.c_str());
+    itkExceptionMacro("Failed to allocate " << size << " bytes for shared memory image " << m_FileName);
+    }
+  void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (memory == MAP_FAILED)
+    {
+    shm_unlink(name.c_str());
+    itkExceptionMacro("Failed to map shared memory image " << m_FileName);
+    }
+  memcpy(memory, &header, sizeof(header));
+  memcpy(static_cast<char*>(memory) + header.DataOffset, buffer, header.DataSize);
+  munmap(memory, size);
+#endif
+}
+
+} // end namespace itk
@@ -0,0 +1,99 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef itkSharedMemoryImageIO_h
+#define itkSharedMemoryImageIO_h
+
+#include "itkFactoryRegistrationConfigure.h"
+
+// ITK includes
+#include <itkImageIOBase.h>
+
+// STD includes
+#include <string>
+
+namespace itk
+{
+/** \class SharedMemoryImageIO
+ * \brief ImageIO object for exchanging images through shared memory
+ *
+ * SharedMemoryImageIO allows an executable command line module and
+ * Slicer to exchange images without writing them into temporary
+ * files. The "filename" looks like <code>shm:/\<name\></code> where
+ * name identifies a POSIX shared memory object.
+ *
+ * The shared memory object contains a small header (dimensions,
+ * spacing, origin and direction in LPS, pixel type) followed by the
+ * uncompressed pixel data. Write() creates (or replaces) the shared memory
+ * object, Read() does not remove it: the process creating the name
+ * is responsible for calling RemoveSharedMemory().
+ *
+ * On platforms without POSIX shared memory (Windows), CanReadFile()
+ * and CanWriteFile() return false and temporary files must be used.
+ */
+class ITKFactoryRegistration_EXPORT SharedMemoryImageIO : public ImageIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef SharedMemoryImageIO Self;
+  typedef ImageIOBase         Superclass;
+  typedef SmartPointer<Self>  Pointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SharedMemoryImageIO, ImageIOBase);
+
+  /** Return true if shared memory is supported on this platform. */
+  static bool IsSupported();
+
+  /** Return true if the filename refers to a shared memory object. */
+  static bool IsSharedMemoryFileName(const std::string& fileName);
+
+  /** Return a filename that is unique in the process and among the
+   *  running processes. */
+  static std::string CreateUniqueFileName();
+
+  /** Remove the shared memory object. Return true on success. */
+  static bool RemoveSharedMemory(const std::string& fileName);
+
+  /** Determine the file type. Returns true if this ImageIO can read the
+   * file specified. */
+  bool CanReadFile(const char*) override;
+
+  /** Set the spacing and dimension information for the set filename. */
+  void ReadImageInformation() override;
+
+  /** Reads the data from shared memory into the memory buffer provided. */
+  void Read(void* buffer) override;
+
+  /** Determine the file type. Returns true if this ImageIO can write the
+   * file specified. */
+  bool CanWriteFile(const char*) override;
+
+  /** Image information is written with the pixel data in Write(). */
+  void WriteImageInformation() override {}
+
+  /** Writes the image information and the data into a new shared memory
+   * object. */
+  void Write(const void* buffer) override;
+
+protected:
+  SharedMemoryImageIO();
+  ~SharedMemoryImageIO() override;
+
+private:
+  SharedMemoryImageIO(const Self&) = delete;
+  void operator=(const Self&) = delete;
+};
+
+} // end namespace itk
+
+#endif
@@ -21,6 +21,9 @@
 
 
 // STD includes
+#include <fstream>
+#include <iterator>
+#include <sstream>
 
 #include "vtkMRMLCoreTestingMacros.h"
 
@@ -33,6 +36,72 @@ bool validFile(const char *fileName)
   return false;
 }
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+void writeFile(const std::string& fileName, const std::string& content)
+{
+  std::ofstream file(fileName.c_str(), std::ios::out | std::ios::binary);
+  file << content;
+}
+
+//----------------------------------------------------------------------------
+std::string readFile(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+//----------------------------------------------------------------------------
+int testCompressedZip()
+{
+  std::string workingDir = vtksys::SystemTools::GetCurrentWorkingDirectory();
+  std::string sourceDir = workingDir + "/compressionTest";
+  std::string extractDir = workingDir + "/extractedCompressionTest";
+  std::string zipFilePath = workingDir + "/compressionTest.zip";
+  vtksys::SystemTools::RemoveADirectory(sourceDir);
+  vtksys::SystemTools::RemoveADirectory(extractDir);
+  vtksys::SystemTools::RemoveFile(zipFilePath);
+  vtksys::SystemTools::MakeDirectory(sourceDir);
+  vtksys::SystemTools::MakeDirectory(extractDir);
+
+  // Text content is deflated, content of files that are already compressed is stored
+  std::ostringstream textContent;
+  for (int i = 0; i < 10000; ++i)
+    {
+    textContent << "<MRMLNode id=\"vtkMRMLNode" << i << "\" />\n";
+    }
+  std::string binaryContent;
+  unsigned int randomState = 12345;
+  for (int i = 0; i < 100000; ++i)
+    {
+    randomState = randomState * 1664525u + 1013904223u;
+    binaryContent.push_back(static_cast<char>(randomState >> 24));
+    }
+  writeFile(sourceDir + "/scene.mrml", textContent.str());
+  writeFile(sourceDir + "/volume.nii.gz", binaryContent);
+
+  // Failed write keeps the source files
+  std::string invalidZipFilePath = workingDir + "/nonexistentDirectory/compressionTest.zip";
+  CHECK_BOOL(vtkArchive::Zip(invalidZipFilePath.c_str(), sourceDir.c_str(), true, true), false);
+  CHECK_STD_STRING(readFile(sourceDir + "/scene.mrml"), textContent.str());
+  CHECK_STD_STRING(readFile(sourceDir + "/volume.nii.gz"), binaryContent);
+
+  CHECK_BOOL(vtkArchive::Zip(zipFilePath.c_str(), sourceDir.c_str(), true, true), true);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(sourceDir + "/scene.mrml"), false);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(sourceDir + "/volume.nii.gz"), false);
+  // the text file must have been compressed
+  CHECK_BOOL(vtksys::SystemTools::FileLength(zipFilePath) < textContent.str().size() / 2 + binaryContent.size(), true);
+
+  CHECK_BOOL(vtkArchive::UnZip(zipFilePath.c_str(), extractDir.c_str()), true);
+  CHECK_STD_STRING(readFile(extractDir + "/compressionTest/scene.mrml"), textContent.str());
+  CHECK_STD_STRING(readFile(extractDir + "/compressionTest/volume.nii.gz"), binaryContent);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
 int vtkArchiveTest1(int argc, char * argv[] )
 {
   if (argc < 2)
@@ -166,6 +235,29 @@ int vtkArchiveTest1(int argc, char * argv[] )
     std::cerr << "failed to extract archive : " << "extractedArchiveTest" << std::endl;
     return EXIT_FAILURE;
     }
+  vtksys::SystemTools::ChangeDirectory("..");
+
+  //
+  // Create a compressed zip file, removing files as they are zipped
+  //
+  std::string compressedZipFilePath = vtksys::SystemTools::GetCurrentWorkingDirectory() +
+                                                    std::string("/archiveTestCompressed.zip");
+  res = vtkArchive::Zip(compressedZipFilePath.c_str(), zipDirPath.c_str(), true, true);
+  if (!res)
+    {
+    std::cerr << "failed to create new compressed archive" << std::endl;
+    return EXIT_FAILURE;
+    }
+  CHECK_BOOL(vtksys::SystemTools::FileExists(zipDirPath + "/vol.mrml"), false);
+  CHECK_BOOL(vtkArchive::ListArchive(compressedZipFilePath.c_str(), files), true);
+  // directory entry and the two scene files
+  CHECK_INT(static_cast<int>(files.size()), 3);
+
+  CHECK_BOOL(vtkArchive::IsFileCompressed("volume.nii.gz"), true);
+  CHECK_BOOL(vtkArchive::IsFileCompressed("screenshot.png"), true);
+  CHECK_BOOL(vtkArchive::IsFileCompressed("scene.mrml"), false);
+
+  CHECK_EXIT_SUCCESS(testCompressedZip());
 
   return EXIT_SUCCESS;
 }
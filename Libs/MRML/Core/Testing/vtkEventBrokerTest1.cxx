@@ -0,0 +1,104 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkEventBroker.h"
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::vector<std::string> InvokedObservers;
+
+//----------------------------------------------------------------------------
+void RecordCallback(vtkObject* vtkNotUsed(caller), unsigned long vtkNotUsed(eid),
+                    void* clientData, void* vtkNotUsed(callData))
+{
+  InvokedObservers.push_back(reinterpret_cast<const char*>(clientData));
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkEventBrokerTest1(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  vtkEventBroker* broker = vtkEventBroker::GetInstance();
+  broker->ResetStatistics();
+  broker->SetEventModeToAsynchronous();
+
+  vtkNew<vtkObject> lowPrioritySubject;
+  vtkNew<vtkObject> highPrioritySubject;
+  vtkNew<vtkObject> lowPriorityObserver;
+  vtkNew<vtkObject> highPriorityObserver;
+
+  vtkNew<vtkCallbackCommand> lowPriorityCallback;
+  lowPriorityCallback->SetCallback(RecordCallback);
+  lowPriorityCallback->SetClientData(const_cast<char*>("low"));
+  vtkNew<vtkCallbackCommand> highPriorityCallback;
+  highPriorityCallback->SetCallback(RecordCallback);
+  highPriorityCallback->SetClientData(const_cast<char*>("high"));
+
+  broker->AddObservation(lowPrioritySubject.GetPointer(), vtkCommand::ModifiedEvent,
+    lowPriorityObserver.GetPointer(), lowPriorityCallback.GetPointer(), 0.0f);
+  broker->AddObservation(highPrioritySubject.GetPointer(), vtkCommand::ModifiedEvent,
+    highPriorityObserver.GetPointer(), highPriorityCallback.GetPointer(), 10.0f);
+
+  // Repeated events are coalesced while the observation is in the queue
+  for (int i = 0; i < 100; ++i)
+    {
+    lowPrioritySubject->Modified();
+    highPrioritySubject->Modified();
+    }
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 2);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfFiredEvents()), 200);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfCoalescedEvents()), 198);
+  CHECK_INT(static_cast<int>(broker->GetNumberOfDispatchedEvents()), 0);
+
+  // Highest priority is dispatched first even if it was queued last
+  broker->ProcessEventQueue();
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+  CHECK_INT(static_cast<int>(InvokedObservers.size()), 2);
+  CHECK_STD_STRING(InvokedObservers[0], "high");
+  CHECK_STD_STRING(InvokedObservers[1], "low");
+  CHECK_INT(static_cast<int>(broker->GetNumberOfDispatchedEvents()), 2);
+  CHECK_INT(static_cast<int>(broker->GetObserverNumberOfInvocations(highPriorityObserver.GetPointer())), 1);
+  CHECK_BOOL(broker->GetObserverTotalElapsedTime(highPriorityObserver.GetPointer()) >= 0.0, true);
+
+  // Removed observations are removed from the queue
+  lowPrioritySubject->Modified();
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 1);
+  broker->RemoveObservations(lowPriorityObserver.GetPointer());
+  CHECK_INT(broker->GetNumberOfQueuedObservations(), 0);
+
+  // Synchronous mode invokes the observations immediately
+  broker->SetEventModeToSynchronous();
+  InvokedObservers.clear();
+  highPrioritySubject->Modified();
+  CHECK_INT(static_cast<int>(InvokedObservers.size()), 1);
+  CHECK_INT(static_cast<int>(broker->GetObserverNumberOfInvocations(highPriorityObserver.GetPointer())), 2);
+
+  broker->ResetStatistics();
+  CHECK_INT(static_cast<int>(broker->GetNumberOfFiredEvents()), 0);
+  CHECK_INT(static_cast<int>(broker->GetObserverNumberOfInvocations(highPriorityObserver.GetPointer())), 0);
+
+  broker->RemoveObservations(highPriorityObserver.GetPointer());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLImageStatistics.h"
+#include "vtkMRMLScalarVolumeDisplayNode.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void FillImage(vtkImageData* image, int offset)
+{
+  image->SetDimensions(10, 10, 10);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (int i = 0; i < 1000; ++i)
+    {
+    voxels[i] = static_cast<short>(i + offset);
+    }
+}
+
+//----------------------------------------------------------------------------
+int TestComputeAndCache()
+{
+  vtkNew<vtkImageData> image;
+  FillImage(image.GetPointer(), 0);
+
+  CHECK_NULL(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()));
+  vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::GetImageStatistics(image.GetPointer());
+  CHECK_NOT_NULL(statistics);
+  CHECK_INT(statistics->GetNumberOfVoxels(), 1000);
+  CHECK_DOUBLE(statistics->GetScalarRange()[0], 0.0);
+  CHECK_DOUBLE(statistics->GetScalarRange()[1], 999.0);
+  CHECK_DOUBLE_TOLERANCE(statistics->GetMean(), 499.5, 0.001);
+  CHECK_DOUBLE_TOLERANCE(statistics->GetPercentile(50.0), 499.5, 1.0);
+  CHECK_DOUBLE_TOLERANCE(statistics->GetAutoRange()[0], 1.0, 2.0);
+  CHECK_DOUBLE_TOLERANCE(statistics->GetAutoRange()[1], 998.0, 2.0);
+  CHECK_NOT_NULL(statistics->GetHistogram());
+
+  // Statistics are computed only once
+  CHECK_POINTER(vtkMRMLImageStatistics::GetImageStatistics(image.GetPointer()), statistics);
+  CHECK_POINTER(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()), statistics);
+
+  // Modified voxels are detected
+  FillImage(image.GetPointer(), 100);
+  CHECK_NULL(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()));
+  statistics = vtkMRMLImageStatistics::GetImageStatistics(image.GetPointer());
+  CHECK_NOT_NULL(statistics);
+  CHECK_DOUBLE(statistics->GetScalarRange()[0], 100.0);
+  CHECK_DOUBLE(statistics->GetScalarRange()[1], 1099.0);
+
+  // Modified image is detected
+  image->Modified();
+  CHECK_NULL(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()));
+  statistics = vtkMRMLImageStatistics::GetImageStatistics(image.GetPointer());
+  CHECK_NOT_NULL(statistics);
+  CHECK_POINTER(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()), statistics);
+
+  vtkMRMLImageStatistics::RemoveImageStatistics(image.GetPointer());
+  CHECK_NULL(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()));
+
+  // Images without voxels have no statistics
+  vtkNew<vtkImageData> emptyImage;
+  CHECK_NULL(vtkMRMLImageStatistics::GetImageStatistics(emptyImage.GetPointer()));
+  CHECK_NULL(vtkMRMLImageStatistics::GetImageStatistics(nullptr));
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestHeaderValue()
+{
+  vtkNew<vtkImageData> image;
+  FillImage(image.GetPointer(), -500);
+  std::string headerValue = vtkMRMLImageStatistics::GetImageStatistics(image.GetPointer())->GetHeaderValue();
+
+  // Statistics read from header are used without computing them
+  vtkNew<vtkImageData> loadedImage;
+  FillImage(loadedImage.GetPointer(), -500);
+  CHECK_BOOL(vtkMRMLImageStatistics::SetImageStatisticsFromHeaderValue(loadedImage.GetPointer(), headerValue), true);
+  vtkMRMLImageStatistics* loadedStatistics = vtkMRMLImageStatistics::GetCachedImageStatistics(loadedImage.GetPointer());
+  CHECK_NOT_NULL(loadedStatistics);
+  CHECK_DOUBLE(loadedStatistics->GetScalarRange()[0], -500.0);
+  CHECK_DOUBLE(loadedStatistics->GetScalarRange()[1], 499.0);
+  CHECK_DOUBLE_TOLERANCE(loadedStatistics->GetMean(), -0.5, 0.001);
+
+  // Histogram is computed on request
+  CHECK_NOT_NULL(loadedStatistics->GetHistogram());
+  CHECK_DOUBLE_TOLERANCE(loadedStatistics->GetPercentile(50.0), -0.5, 1.0);
+
+  // Header values of a different image or invalid values are ignored
+  vtkNew<vtkImageData> otherImage;
+  otherImage->SetDimensions(5, 5, 5);
+  otherImage->AllocateScalars(VTK_SHORT, 1);
+  CHECK_BOOL(vtkMRMLImageStatistics::SetImageStatisticsFromHeaderValue(otherImage.GetPointer(), headerValue), false);
+  CHECK_BOOL(vtkMRMLImageStatistics::SetImageStatisticsFromHeaderValue(loadedImage.GetPointer(), "invalid"), false);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSharedByDisplayNodes()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkImageData> image;
+  FillImage(image.GetPointer(), 0);
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode.GetPointer());
+  volumeNode->SetAndObserveImageData(image.GetPointer());
+
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode1;
+  scene->AddNode(displayNode1.GetPointer());
+  volumeNode->AddAndObserveDisplayNodeID(displayNode1->GetID());
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode2;
+  scene->AddNode(displayNode2.GetPointer());
+  volumeNode->AddAndObserveDisplayNodeID(displayNode2->GetID());
+
+  displayNode1->AutoWindowLevelOn();
+  displayNode1->CalculateAutoLevels();
+  vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer());
+  CHECK_NOT_NULL(statistics);
+  CHECK_DOUBLE_TOLERANCE(displayNode1->GetWindowLevelMin(), statistics->GetAutoRange()[0], 1e-6);
+  CHECK_DOUBLE_TOLERANCE(displayNode1->GetWindowLevelMax(), statistics->GetAutoRange()[1], 1e-6);
+
+  displayNode2->AutoWindowLevelOn();
+  displayNode2->CalculateAutoLevels();
+  CHECK_POINTER(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()), statistics);
+
+  double range[2] = { 0.0, 0.0 };
+  displayNode2->GetDisplayScalarRange(range);
+  CHECK_DOUBLE(range[0], 0.0);
+  CHECK_DOUBLE(range[1], 999.0);
+  CHECK_POINTER(vtkMRMLImageStatistics::GetCachedImageStatistics(image.GetPointer()), statistics);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestMultiComponentDisplayScalarRange()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(2, 1, 1);
+  image->AllocateScalars(VTK_DOUBLE, 2);
+  double* voxels = static_cast<double*>(image->GetScalarPointer());
+  voxels[0] = 0.0;
+  voxels[1] = 3.0;
+  voxels[2] = 4.0;
+  voxels[3] = 0.0;
+
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode.GetPointer());
+  volumeNode->SetAndObserveImageData(image.GetPointer());
+  vtkNew<vtkMRMLScalarVolumeDisplayNode> displayNode;
+  scene->AddNode(displayNode.GetPointer());
+  volumeNode->AddAndObserveDisplayNodeID(displayNode->GetID());
+
+  // Range of multi-component images is the range of the vector magnitude, as in vtkImageData
+  double expectedRange[2] = { 0.0, 0.0 };
+  image->GetScalarRange(expectedRange);
+  double range[2] = { 0.0, 0.0 };
+  displayNode->GetDisplayScalarRange(range);
+  CHECK_DOUBLE(range[0], expectedRange[0]);
+  CHECK_DOUBLE(range[1], expectedRange[1]);
+  CHECK_DOUBLE(range[0], 3.0);
+  CHECK_DOUBLE(range[1], 4.0);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLImageStatisticsTest1(int, char*[])
+{
+  CHECK_EXIT_SUCCESS(TestComputeAndCache());
+  CHECK_EXIT_SUCCESS(TestHeaderValue());
+  CHECK_EXIT_SUCCESS(TestSharedByDisplayNodes());
+  CHECK_EXIT_SUCCESS(TestMultiComponentDisplayScalarRange());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+#include "vtkMRMLTextNode.h"
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Number of nodes of className in the scene, computed by traversing the
+/// whole Nodes collection (behavior before the introduction of the class cache).
+int GetNumberOfNodesByClassByTraversal(vtkMRMLScene* scene, const char* className)
+{
+  int num = 0;
+  vtkMRMLNode *node;
+  vtkCollectionSimpleIterator it;
+  for (scene->GetNodes()->InitTraversal(it);
+       (node = (vtkMRMLNode*)scene->GetNodes()->GetNextItemAsObject(it)) ;)
+    {
+    if (node->IsA(className))
+      {
+      num++;
+      }
+    }
+  return num;
+}
+
+//----------------------------------------------------------------------------
+void PrintMeasurement(const std::string& name, int numberOfNodes, double value)
+{
+  std::cout << "<DartMeasurement name=\"" << name << "-" << numberOfNodes << "\" "
+            << "type=\"numeric/double\">"
+            << value << "</DartMeasurement>" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+int TestNodesByClassPerformance(int numberOfNodes)
+{
+  const int numberOfQueries = 100;
+  // 1% of the nodes are scripted module nodes, the rest are text nodes
+  const int scriptedNodeStep = 100;
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkTimerLog> timer;
+
+  timer->StartTimer();
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (int i = 0; i < numberOfNodes; ++i)
+    {
+    vtkSmartPointer<vtkMRMLNode> node;
+    if (i % scriptedNodeStep == 0)
+      {
+      node = vtkSmartPointer<vtkMRMLScriptedModuleNode>::New();
+      }
+    else
+      {
+      node = vtkSmartPointer<vtkMRMLTextNode>::New();
+      }
+    scene->AddNode(node);
+    }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  timer->StopTimer();
+  PrintMeasurement("AddNodes", numberOfNodes, timer->GetElapsedTime());
+
+  const int expectedNumberOfScriptedNodes = (numberOfNodes + scriptedNodeStep - 1) / scriptedNodeStep;
+
+  // Full traversal of the scene
+  timer->StartTimer();
+  for (int i = 0; i < numberOfQueries; ++i)
+    {
+    CHECK_INT(GetNumberOfNodesByClassByTraversal(scene.GetPointer(), "vtkMRMLScriptedModuleNode"), expectedNumberOfScriptedNodes);
+    }
+  timer->StopTimer();
+  double traversalTime = timer->GetElapsedTime();
+  PrintMeasurement("GetNumberOfNodesByClassTraversal", numberOfNodes, traversalTime);
+
+  // Class cache: the first query populates the cache
+  timer->StartTimer();
+  for (int i = 0; i < numberOfQueries; ++i)
+    {
+    CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScriptedModuleNode"), expectedNumberOfScriptedNodes);
+    }
+  timer->StopTimer();
+  double cacheTime = timer->GetElapsedTime();
+  PrintMeasurement("GetNumberOfNodesByClassCache", numberOfNodes, cacheTime);
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfQueries; ++i)
+    {
+    std::vector<vtkMRMLNode*> nodes;
+    CHECK_INT(scene->GetNodesByClass("vtkMRMLScriptedModuleNode", nodes), expectedNumberOfScriptedNodes);
+    CHECK_NOT_NULL(scene->GetNthNodeByClass(expectedNumberOfScriptedNodes - 1, "vtkMRMLScriptedModuleNode"));
+    }
+  timer->StopTimer();
+  PrintMeasurement("GetNodesByClassCache", numberOfNodes, timer->GetElapsedTime());
+
+  std::cout << numberOfNodes << " nodes: traversal " << traversalTime
+            << "s, cache " << cacheTime << "s" << std::endl;
+
+  // Cache must stay in sync with scene order when nodes are added and removed
+  vtkMRMLNode* firstScriptedNode = scene->GetFirstNodeByClass("vtkMRMLScriptedModuleNode");
+  CHECK_NOT_NULL(firstScriptedNode);
+  scene->RemoveNode(firstScriptedNode);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScriptedModuleNode"), expectedNumberOfScriptedNodes - 1);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScriptedModuleNode"),
+    GetNumberOfNodesByClassByTraversal(scene.GetPointer(), "vtkMRMLScriptedModuleNode"));
+
+  vtkNew<vtkMRMLScriptedModuleNode> lastScriptedNode;
+  scene->AddNode(lastScriptedNode.GetPointer());
+  CHECK_POINTER(scene->GetNthNodeByClass(expectedNumberOfScriptedNodes - 1, "vtkMRMLScriptedModuleNode"),
+    lastScriptedNode.GetPointer());
+  // Superclass queries include subclasses
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNode"), scene->GetNumberOfNodes());
+
+  // Removing all nodes must not update the class lists node by node
+  timer->StartTimer();
+  scene->Clear(1);
+  timer->StopTimer();
+  PrintMeasurement("Clear", numberOfNodes, timer->GetElapsedTime());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLScriptedModuleNode"), 0);
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLNode"), scene->GetNumberOfNodes());
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSceneNodesByClassPerformanceTest(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestNodesByClassPerformance(1000));
+  CHECK_EXIT_SUCCESS(TestNodesByClassPerformance(10000));
+  CHECK_EXIT_SUCCESS(TestNodesByClassPerformance(100000));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,128 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLScriptedModuleNode.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkSphereSource.h>
+
+//---------------------------------------------------------------------------
+int vtkMRMLSceneUndoTest(int vtkNotUsed(argc), char * vtkNotUsed(argv) [] )
+{
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetUndoOn();
+
+  vtkNew<vtkMRMLScriptedModuleNode> parameterNode;
+  parameterNode->SetUndoEnabled(true);
+  parameterNode->SetParameter("Text", "first");
+  scene->AddNode(parameterNode.GetPointer());
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(100);
+  sphere->SetPhiResolution(100);
+  sphere->Update();
+  vtkNew<vtkMRMLModelNode> modelNode;
+  modelNode->SetUndoEnabled(true);
+  modelNode->SetAndObservePolyData(sphere->GetOutput());
+  scene->AddNode(modelNode.GetPointer());
+
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 0);
+  CHECK_INT(scene->GetUndoMemorySize(), 0);
+
+  // First state: both nodes are copied
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 1);
+  vtkTypeInt64 firstStateSize = scene->GetUndoStateMemorySize(0);
+  CHECK_BOOL(firstStateSize > 0, true);
+  CHECK_INT(scene->GetUndoMemorySize(), firstStateSize);
+
+  // Second state: only the parameter node changed, the model copy is shared
+  parameterNode->SetParameter("Text", "second");
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 2);
+  vtkTypeInt64 secondStateSize = scene->GetUndoStateMemorySize(1);
+  CHECK_BOOL(secondStateSize > 0, true);
+  CHECK_BOOL(secondStateSize < firstStateSize, true);
+  CHECK_INT(scene->GetUndoMemorySize(), firstStateSize + secondStateSize);
+
+  // Third state copies the parameter node, fourth state shares all the copies
+  parameterNode->SetParameter("Text", "third");
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 4);
+  CHECK_INT(scene->GetUndoStateMemorySize(3), 0);
+
+  // Undo restores the shared states
+  scene->Undo();
+  CHECK_STD_STRING(parameterNode->GetParameter("Text"), "third");
+  scene->Undo();
+  CHECK_STD_STRING(parameterNode->GetParameter("Text"), "third");
+  scene->Undo();
+  CHECK_STD_STRING(parameterNode->GetParameter("Text"), "second");
+  CHECK_INT(modelNode->GetPolyData()->GetNumberOfPoints(), sphere->GetOutput()->GetNumberOfPoints());
+  scene->Redo();
+  CHECK_STD_STRING(parameterNode->GetParameter("Text"), "third");
+  scene->Undo();
+  scene->Undo();
+  CHECK_STD_STRING(parameterNode->GetParameter("Text"), "first");
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 0);
+
+  // Memory limit removes the oldest states but always keeps the last one
+  for (int i = 0; i < 5; ++i)
+    {
+    modelNode->GetPolyData()->Modified();
+    scene->SaveStateForUndo();
+    }
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 5);
+  // The two most recent states fit: the oldest one also contains the parameter node copy
+  scene->SetMaximumUndoMemorySize(scene->GetUndoStateMemorySize(4) * 3);
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 2);
+  scene->SetMaximumUndoMemorySize(1);
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 1);
+
+  scene->ClearUndoStack();
+  CHECK_INT(scene->GetUndoMemorySize(), 0);
+  scene->SetMaximumUndoMemorySize(0);
+
+  // Restored nodes are not the copies shared by the undo states
+  parameterNode->SetParameter("Text", "saved");
+  scene->SaveStateForUndo();
+  scene->SaveStateForUndo();
+  std::string parameterNodeID = parameterNode->GetID();
+  scene->RemoveNode(parameterNode.GetPointer());
+  scene->Undo();
+  vtkMRMLScriptedModuleNode* restoredNode = vtkMRMLScriptedModuleNode::SafeDownCast(
+    scene->GetNodeByID(parameterNodeID));
+  CHECK_NOT_NULL(restoredNode);
+  CHECK_STD_STRING(restoredNode->GetParameter("Text"), "saved");
+  restoredNode->SetParameter("Text", "edited");
+  scene->Undo();
+  CHECK_STD_STRING(restoredNode->GetParameter("Text"), "saved");
+
+  // Memory size is updated as the states are removed
+  for (int i = 0; i < 5; ++i)
+    {
+    modelNode->GetPolyData()->Modified();
+    scene->SaveStateForUndo();
+    }
+  scene->SetMaximumUndoMemorySize(scene->GetUndoStateMemorySize(4) * 2 + 1);
+  CHECK_INT(scene->GetNumberOfUndoLevels(), 2);
+  CHECK_BOOL(scene->GetUndoMemorySize() <= scene->GetMaximumUndoMemorySize(), true);
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,212 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLSubjectHierarchyConstants.h"
+#include "vtkMRMLSubjectHierarchyNode.h"
+#include "vtkMRMLTextNode.h"
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void PrintMeasurement(const std::string& name, int numberOfItems, double value)
+{
+  std::cout << "<DartMeasurement name=\"" << name << "-" << numberOfItems << "\" "
+            << "type=\"numeric/double\">"
+            << value << "</DartMeasurement>" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+std::string GetItemName(int index)
+{
+  std::ostringstream name;
+  name << "Text_" << index;
+  return name.str();
+}
+
+//----------------------------------------------------------------------------
+std::string GetItemUID(int index)
+{
+  std::ostringstream uid;
+  uid << "1.2.840.1234." << index;
+  return uid.str();
+}
+
+//----------------------------------------------------------------------------
+struct UIDAddedEventData
+{
+  std::string UIDName;
+  std::string UIDValue;
+  vtkIdType FoundItemID{vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID};
+};
+
+//----------------------------------------------------------------------------
+void UIDAddedCallback(vtkObject* caller, unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  vtkMRMLSubjectHierarchyNode* shNode = vtkMRMLSubjectHierarchyNode::SafeDownCast(caller);
+  UIDAddedEventData* eventData = reinterpret_cast<UIDAddedEventData*>(clientData);
+  eventData->FoundItemID = shNode->GetItemByUID(eventData->UIDName.c_str(), eventData->UIDValue.c_str());
+}
+
+//----------------------------------------------------------------------------
+int TestSubjectHierarchyLookupPerformance(int numberOfItems)
+{
+  const int numberOfQueries = 1000;
+  // Data items are organized into studies, as after DICOM import
+  const int numberOfItemsPerStudy = 100;
+  const std::string uidName = vtkMRMLSubjectHierarchyConstants::GetDICOMUIDName();
+
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkTimerLog> timer;
+
+  std::vector<vtkSmartPointer<vtkMRMLTextNode> > dataNodes;
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    vtkSmartPointer<vtkMRMLTextNode> dataNode = vtkSmartPointer<vtkMRMLTextNode>::New();
+    dataNode->SetName(GetItemName(i).c_str());
+    scene->AddNode(dataNode);
+    dataNodes.push_back(dataNode);
+    }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+
+  vtkMRMLSubjectHierarchyNode* shNode = vtkMRMLSubjectHierarchyNode::GetSubjectHierarchyNode(scene.GetPointer());
+  CHECK_NOT_NULL(shNode);
+
+  timer->StartTimer();
+  vtkIdType patientItemID = shNode->CreateSubjectItem(shNode->GetSceneItemID(), "Patient");
+  vtkIdType studyItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID;
+  std::vector<vtkIdType> itemIDs;
+  for (int i = 0; i < numberOfItems; ++i)
+    {
+    if (i % numberOfItemsPerStudy == 0)
+      {
+      studyItemID = shNode->CreateStudyItem(patientItemID, "Study");
+      }
+    vtkIdType itemID = shNode->CreateItem(studyItemID, dataNodes[i]);
+    shNode->SetItemUID(itemID, uidName, GetItemUID(i));
+    itemIDs.push_back(itemID);
+    }
+  timer->StopTimer();
+  PrintMeasurement("CreateItems", numberOfItems, timer->GetElapsedTime());
+
+  // Query items all over the tree
+  const int queryStep = std::max(1, numberOfItems / numberOfQueries);
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; i += queryStep)
+    {
+    CHECK_INT(shNode->GetItemByDataNode(dataNodes[i]), itemIDs[i]);
+    }
+  timer->StopTimer();
+  double dataNodeTime = timer->GetElapsedTime();
+  PrintMeasurement("GetItemByDataNode", numberOfItems, dataNodeTime);
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; i += queryStep)
+    {
+    CHECK_INT(shNode->GetItemByUID(uidName.c_str(), GetItemUID(i).c_str()), itemIDs[i]);
+    }
+  timer->StopTimer();
+  PrintMeasurement("GetItemByUID", numberOfItems, timer->GetElapsedTime());
+
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; i += queryStep)
+    {
+    CHECK_INT(shNode->GetItemByName(GetItemName(i)), itemIDs[i]);
+    }
+  timer->StopTimer();
+  double nameTime = timer->GetElapsedTime();
+  PrintMeasurement("GetItemByName", numberOfItems, nameTime);
+
+  // Recursive child search traverses the tree
+  timer->StartTimer();
+  for (int i = 0; i < numberOfItems; i += queryStep)
+    {
+    CHECK_INT(shNode->GetItemChildWithName(shNode->GetSceneItemID(), GetItemName(i), true), itemIDs[i]);
+    }
+  timer->StopTimer();
+  double traversalTime = timer->GetElapsedTime();
+  PrintMeasurement("GetItemChildWithNameTraversal", numberOfItems, traversalTime);
+
+  std::cout << numberOfItems << " items: traversal " << traversalTime
+            << "s, lookup by name " << nameTime << "s, lookup by data node " << dataNodeTime << "s" << std::endl;
+
+  // Lookups must follow changes of the items
+  dataNodes[0]->SetName("RenamedText");
+  CHECK_INT(shNode->GetItemByName("RenamedText"), itemIDs[0]);
+  CHECK_INT(shNode->GetItemByName(GetItemName(0)), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+
+  shNode->SetItemName(itemIDs[1], GetItemName(2));
+  vtkNew<vtkIdList> foundItemIDs;
+  shNode->GetItemsByName(GetItemName(2), foundItemIDs.GetPointer());
+  CHECK_INT(foundItemIDs->GetNumberOfIds(), 2);
+  CHECK_INT(foundItemIDs->GetId(0), itemIDs[1]);
+  CHECK_INT(shNode->GetItemByName(GetItemName(2)), itemIDs[1]);
+
+  shNode->SetItemUID(itemIDs[3], "OtherUID", "1.2.840.9999 1.2.840.9998");
+  CHECK_INT(shNode->GetItemByUID("OtherUID", "1.2.840.9999 1.2.840.9998"), itemIDs[3]);
+  CHECK_INT(shNode->GetItemByUID("OtherUID", "1.2.840.9999"), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  CHECK_INT(shNode->GetItemByUIDList("OtherUID", "1.2.840.9998"), itemIDs[3]);
+
+  // New UID can be found by observers of the UID added event
+  UIDAddedEventData eventData;
+  eventData.UIDName = "OtherUID";
+  eventData.UIDValue = "1.2.840.9997";
+  vtkNew<vtkCallbackCommand> uidAddedCallback;
+  uidAddedCallback->SetCallback(UIDAddedCallback);
+  uidAddedCallback->SetClientData(&eventData);
+  shNode->AddObserver(vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemUIDAddedEvent, uidAddedCallback.GetPointer());
+  shNode->SetItemUID(itemIDs[6], eventData.UIDName, eventData.UIDValue);
+  shNode->RemoveObserver(uidAddedCallback.GetPointer());
+  CHECK_INT(eventData.FoundItemID, itemIDs[6]);
+
+  vtkIdType folderItemID = shNode->CreateFolderItem(shNode->GetSceneItemID(), "Folder");
+  shNode->SetItemParent(itemIDs[4], folderItemID);
+  CHECK_INT(shNode->GetItemByDataNode(dataNodes[4]), itemIDs[4]);
+
+  shNode->RemoveItem(itemIDs[5], false);
+  CHECK_INT(shNode->GetItemByDataNode(dataNodes[5]), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  CHECK_INT(shNode->GetItemByUID(uidName.c_str(), GetItemUID(5).c_str()), vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID);
+  vtkIdType recreatedItemID = shNode->CreateItem(folderItemID, dataNodes[5]);
+  CHECK_BOOL(recreatedItemID != itemIDs[5], true);
+  CHECK_INT(shNode->GetItemByDataNode(dataNodes[5]), recreatedItemID);
+  CHECK_INT(shNode->GetItemByName(GetItemName(5)), recreatedItemID);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSubjectHierarchyNodePerformanceTest(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestSubjectHierarchyLookupPerformance(1000));
+  CHECK_EXIT_SUCCESS(TestSubjectHierarchyLookupPerformance(10000));
+  CHECK_EXIT_SUCCESS(TestSubjectHierarchyLookupPerformance(100000));
+  return EXIT_SUCCESS;
+}
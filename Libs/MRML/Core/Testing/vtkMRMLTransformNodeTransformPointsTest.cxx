@@ -0,0 +1,323 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLTransformNode.h"
+
+// VTK includes
+#include <vtkBSplineTransform.h>
+#include <vtkGeneralTransform.h>
+#include <vtkGridTransform.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+#include <vtkTransform.h>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreatePoints(vtkPoints* points, int numberOfPoints)
+{
+  points->SetNumberOfPoints(numberOfPoints);
+  for (int i = 0; i < numberOfPoints; ++i)
+    {
+    points->SetPoint(i, (i % 17) * 5.0 - 40.0, (i % 13) * 6.0 - 35.0, (i % 11) * 7.0 - 30.0);
+    }
+}
+
+//----------------------------------------------------------------------------
+void FillDisplacementGrid(vtkImageData* grid, double scale)
+{
+  grid->SetDimensions(6, 6, 6);
+  grid->SetOrigin(-60.0, -60.0, -60.0);
+  grid->SetSpacing(25.0, 25.0, 25.0);
+  grid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacement = static_cast<double*>(grid->GetScalarPointer());
+  for (int i = 0; i < 6 * 6 * 6; ++i)
+    {
+    *(displacement++) = scale * sin(i * 0.1);
+    *(displacement++) = scale * cos(i * 0.2);
+    *(displacement++) = scale * sin(i * 0.3);
+    }
+}
+
+//----------------------------------------------------------------------------
+int CheckTransformPoints(vtkAbstractTransform* transform)
+{
+  vtkNew<vtkPoints> points;
+  CreatePoints(points.GetPointer(), 1000);
+  vtkNew<vtkPoints> transformedPoints;
+  vtkMRMLTransformNode::TransformPoints(transform, points.GetPointer(), transformedPoints.GetPointer());
+  CHECK_INT(transformedPoints->GetNumberOfPoints(), points->GetNumberOfPoints());
+
+  for (vtkIdType pointIndex = 0; pointIndex < points->GetNumberOfPoints(); ++pointIndex)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointIndex, point);
+    double expectedPoint[3] = { point[0], point[1], point[2] };
+    if (transform)
+      {
+      transform->TransformPoint(point, expectedPoint);
+      }
+    double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+    transformedPoints->GetPoint(pointIndex, transformedPoint);
+    CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(expectedPoint, transformedPoint)), 0.0, 1e-3);
+    }
+
+  // In-place transform, modified points must be detected by the pipeline
+  vtkMTimeType pointsMTime = points->GetMTime();
+  vtkMRMLTransformNode::TransformPoints(transform, points.GetPointer(), points.GetPointer());
+  CHECK_BOOL(points->GetMTime() > pointsMTime, true);
+  for (vtkIdType pointIndex = 0; pointIndex < points->GetNumberOfPoints(); ++pointIndex)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointIndex, point);
+    double transformedPoint[3] = { 0.0, 0.0, 0.0 };
+    transformedPoints->GetPoint(pointIndex, transformedPoint);
+    CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(point, transformedPoint)), 0.0, 1e-3);
+    }
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestLinearTransforms()
+{
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(nullptr));
+
+  vtkNew<vtkTransform> linearTransform1;
+  linearTransform1->Translate(10.0, -20.0, 30.0);
+  linearTransform1->RotateX(30.0);
+  vtkNew<vtkTransform> linearTransform2;
+  linearTransform2->RotateZ(-45.0);
+  linearTransform2->Scale(1.5, 2.0, 0.5);
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(linearTransform1.GetPointer()));
+
+  vtkNew<vtkGeneralTransform> compositeTransform;
+  compositeTransform->PostMultiply();
+  compositeTransform->Concatenate(linearTransform1.GetPointer());
+  compositeTransform->Concatenate(linearTransform2.GetPointer());
+  compositeTransform->Concatenate(linearTransform1->GetInverse());
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(compositeTransform.GetPointer()));
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestNonlinearTransforms()
+{
+  vtkNew<vtkImageData> displacementGrid;
+  FillDisplacementGrid(displacementGrid.GetPointer(), 5.0);
+  vtkNew<vtkGridTransform> gridTransform;
+  gridTransform->SetDisplacementGridData(displacementGrid.GetPointer());
+  gridTransform->SetInterpolationModeToCubic();
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(gridTransform.GetPointer()));
+
+  vtkNew<vtkImageData> coefficients;
+  FillDisplacementGrid(coefficients.GetPointer(), 3.0);
+  vtkNew<vtkBSplineTransform> bsplineTransform;
+  bsplineTransform->SetCoefficientData(coefficients.GetPointer());
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(bsplineTransform.GetPointer()));
+
+  // Linear and nonlinear transforms mixed, including inverse of nonlinear transforms
+  vtkNew<vtkTransform> linearTransform1;
+  linearTransform1->Translate(5.0, -2.0, 3.0);
+  linearTransform1->RotateY(10.0);
+  vtkNew<vtkTransform> linearTransform2;
+  linearTransform2->RotateZ(-5.0);
+  vtkNew<vtkGeneralTransform> compositeTransform;
+  compositeTransform->PostMultiply();
+  compositeTransform->Concatenate(linearTransform1.GetPointer());
+  compositeTransform->Concatenate(gridTransform.GetPointer());
+  compositeTransform->Concatenate(linearTransform2.GetPointer());
+  compositeTransform->Concatenate(linearTransform1->GetInverse());
+  compositeTransform->Concatenate(bsplineTransform->GetInverse());
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(compositeTransform.GetPointer()));
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestTransformNodeHierarchy()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkTransform> parentTransform;
+  parentTransform->Translate(10.0, 20.0, 30.0);
+  vtkNew<vtkMRMLTransformNode> parentTransformNode;
+  scene->AddNode(parentTransformNode.GetPointer());
+  parentTransformNode->SetAndObserveTransformToParent(parentTransform.GetPointer());
+
+  vtkNew<vtkImageData> displacementGrid;
+  FillDisplacementGrid(displacementGrid.GetPointer(), 5.0);
+  vtkNew<vtkGridTransform> gridTransform;
+  gridTransform->SetDisplacementGridData(displacementGrid.GetPointer());
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  scene->AddNode(transformNode.GetPointer());
+  transformNode->SetAndObserveTransformToParent(gridTransform.GetPointer());
+  transformNode->SetAndObserveTransformNodeID(parentTransformNode->GetID());
+
+  vtkNew<vtkGeneralTransform> transformToWorld;
+  transformNode->GetTransformToWorld(transformToWorld.GetPointer());
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(transformToWorld.GetPointer()));
+
+  vtkNew<vtkGeneralTransform> transformFromWorld;
+  transformNode->GetTransformFromWorld(transformFromWorld.GetPointer());
+  CHECK_EXIT_SUCCESS(CheckTransformPoints(transformFromWorld.GetPointer()));
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestResampledTransformCache()
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkTransform> parentTransform;
+  parentTransform->Translate(10.0, 20.0, 30.0);
+  vtkNew<vtkMRMLTransformNode> parentTransformNode;
+  scene->AddNode(parentTransformNode.GetPointer());
+  parentTransformNode->SetAndObserveTransformToParent(parentTransform.GetPointer());
+
+  vtkNew<vtkImageData> displacementGrid;
+  FillDisplacementGrid(displacementGrid.GetPointer(), 5.0);
+  vtkNew<vtkGridTransform> gridTransform;
+  gridTransform->SetDisplacementGridData(displacementGrid.GetPointer());
+  gridTransform->SetInterpolationModeToCubic();
+  vtkNew<vtkMRMLTransformNode> transformNode;
+  scene->AddNode(transformNode.GetPointer());
+  transformNode->SetAndObserveTransformToParent(gridTransform.GetPointer());
+  transformNode->SetAndObserveTransformNodeID(parentTransformNode->GetID());
+
+  // Disabled by default
+  double bounds[6] = { -30.0, 30.0, -25.0, 25.0, -20.0, 20.0 };
+  CHECK_NULL(transformNode->GetResampledTransformToWorld(bounds));
+  CHECK_DOUBLE(transformNode->GetResampledTransformToWorldError(), -1.0);
+
+  // Users of the transform are notified when they need to switch between exact and resampled transform
+  vtkNew<vtkMRMLCoreTestingUtilities::vtkMRMLNodeCallback> callback;
+  transformNode->AddObserver(vtkMRMLTransformableNode::TransformModifiedEvent, callback.GetPointer());
+  transformNode->ResampledTransformCacheEnabledOn();
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTransformableNode::TransformModifiedEvent), 1);
+  callback->ResetNumberOfEvents();
+  transformNode->SetResampledTransformCacheSpacing(2.0);
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTransformableNode::TransformModifiedEvent), 1);
+  callback->ResetNumberOfEvents();
+  transformNode->ResampledTransformCacheEnabledOn();
+  CHECK_INT(callback->GetNumberOfEvents(vtkMRMLTransformableNode::TransformModifiedEvent), 0);
+  transformNode->RemoveObserver(callback.GetPointer());
+
+  vtkAbstractTransform* resampledTransform = transformNode->GetResampledTransformToWorld(bounds);
+  CHECK_NOT_NULL(resampledTransform);
+  double error = transformNode->GetResampledTransformToWorldError();
+  CHECK_BOOL(error >= 0.0 && error < 1.0, true);
+
+  // Resampled transform approximates the exact transform within the bounds
+  vtkNew<vtkGeneralTransform> transformToWorld;
+  transformNode->GetTransformToWorld(transformToWorld.GetPointer());
+  vtkNew<vtkPoints> points;
+  CreatePoints(points.GetPointer(), 1000);
+  for (vtkIdType pointIndex = 0; pointIndex < points->GetNumberOfPoints(); ++pointIndex)
+    {
+    double point[3] = { 0.0, 0.0, 0.0 };
+    points->GetPoint(pointIndex, point);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      point[axis] = std::max(bounds[axis * 2], std::min(bounds[axis * 2 + 1], point[axis]));
+      }
+    double exactPoint[3] = { 0.0, 0.0, 0.0 };
+    transformToWorld->TransformPoint(point, exactPoint);
+    double resampledPoint[3] = { 0.0, 0.0, 0.0 };
+    resampledTransform->TransformPoint(point, resampledPoint);
+    if (sqrt(vtkMath::Distance2BetweenPoints(exactPoint, resampledPoint)) > 2.0 * error + 1e-3)
+      {
+      std::cerr << "Line " << __LINE__ << ": resampled transform error is larger than expected at point "
+        << point[0] << ", " << point[1] << ", " << point[2] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  // Exact transform is used outside the grid, where displacements would be extrapolated
+  double outsidePoint[3] = { 55.0, 45.0, 40.0 };
+  double exactOutsidePoint[3] = { 0.0, 0.0, 0.0 };
+  transformToWorld->TransformPoint(outsidePoint, exactOutsidePoint);
+  double resampledOutsidePoint[3] = { 0.0, 0.0, 0.0 };
+  resampledTransform->TransformPoint(outsidePoint, resampledOutsidePoint);
+  CHECK_DOUBLE_TOLERANCE(sqrt(vtkMath::Distance2BetweenPoints(exactOutsidePoint, resampledOutsidePoint)), 0.0, 1e-6);
+
+  // Grid is reused for bounds within the grid
+  double smallerBounds[6] = { -10.0, 10.0, -10.0, 10.0, -10.0, 10.0 };
+  CHECK_POINTER(transformNode->GetResampledTransformToWorld(smallerBounds), resampledTransform);
+
+  // Grid is recomputed if any transform in the chain changes
+  parentTransform->Translate(1.0, 0.0, 0.0);
+  vtkAbstractTransform* updatedResampledTransform = transformNode->GetResampledTransformToWorld(bounds);
+  CHECK_NOT_NULL(updatedResampledTransform);
+  CHECK_BOOL(updatedResampledTransform != resampledTransform, true);
+  resampledTransform = updatedResampledTransform;
+  double transformedOrigin[3] = { 0.0, 0.0, 0.0 };
+  double origin[3] = { 0.0, 0.0, 0.0 };
+  transformToWorld->TransformPoint(origin, transformedOrigin);
+  double resampledTransformedOrigin[3] = { 0.0, 0.0, 0.0 };
+  resampledTransform->TransformPoint(origin, resampledTransformedOrigin);
+  CHECK_DOUBLE_TOLERANCE(resampledTransformedOrigin[0], transformedOrigin[0], 2.0 * error + 1e-3);
+
+  // Grid is recomputed if it does not cover the requested region
+  double largerBounds[6] = { -50.0, 50.0, -25.0, 25.0, -20.0, 20.0 };
+  updatedResampledTransform = transformNode->GetResampledTransformToWorld(largerBounds);
+  CHECK_BOOL(updatedResampledTransform != resampledTransform, true);
+  CHECK_POINTER(transformNode->GetResampledTransformToWorld(bounds), updatedResampledTransform);
+
+  // Grid is recomputed if the parent transform node changes
+  resampledTransform = updatedResampledTransform;
+  transformNode->SetAndObserveTransformNodeID(nullptr);
+  CHECK_BOOL(transformNode->GetResampledTransformToWorld(bounds) != resampledTransform, true);
+
+  double bounds_World[6] = { 0.0, 20.0, 0.0, 20.0, 0.0, 20.0 };
+  CHECK_NOT_NULL(transformNode->GetResampledTransformFromWorld(bounds_World));
+  CHECK_BOOL(transformNode->GetResampledTransformFromWorldError() >= 0.0, true);
+
+  // Linear transforms are not resampled
+  parentTransformNode->ResampledTransformCacheEnabledOn();
+  CHECK_NULL(parentTransformNode->GetResampledTransformToWorld(bounds));
+
+  // Invalid bounds
+  double invalidBounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+  CHECK_NULL(transformNode->GetResampledTransformToWorld(invalidBounds));
+
+  transformNode->ResampledTransformCacheEnabledOff();
+  CHECK_NULL(transformNode->GetResampledTransformToWorld(bounds));
+  CHECK_DOUBLE(transformNode->GetResampledTransformToWorldError(), -1.0);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLTransformNodeTransformPointsTest(int , char * [] )
+{
+  CHECK_EXIT_SUCCESS(TestLinearTransforms());
+  CHECK_EXIT_SUCCESS(TestNonlinearTransforms());
+  CHECK_EXIT_SUCCESS(TestTransformNodeHierarchy());
+  CHECK_EXIT_SUCCESS(TestResampledTransformCache());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,150 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH)
+  All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
+#include "vtkMRMLScene.h"
+#include "vtkMRMLVolumeArchetypeStorageNode.h"
+
+// vtkITK includes
+#include <vtkITKSharedMemoryImage.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void CreateImage(vtkImageData* image, vtkMatrix4x4* ijkToRAS)
+{
+  image->SetDimensions(4, 5, 6);
+  image->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (int i = 0; i < 4 * 5 * 6; ++i)
+    {
+    voxels[i] = static_cast<short>(i - 50);
+    }
+  ijkToRAS->Identity();
+  ijkToRAS->SetElement(0, 0, -0.5);
+  ijkToRAS->SetElement(1, 1, 1.5);
+  ijkToRAS->SetElement(2, 2, 2.0);
+  ijkToRAS->SetElement(0, 3, 10.0);
+  ijkToRAS->SetElement(1, 3, -20.0);
+  ijkToRAS->SetElement(2, 3, 30.0);
+}
+
+//----------------------------------------------------------------------------
+int TestSharedMemoryRoundTrip()
+{
+  vtkNew<vtkImageData> image;
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  CreateImage(image.GetPointer(), ijkToRAS.GetPointer());
+
+  // Image written by a command line module
+  std::string sharedMemoryFileName = vtkITKSharedMemoryImage::CreateUniqueFileName();
+  CHECK_BOOL(vtkITKSharedMemoryImage::IsSharedMemoryFileName(sharedMemoryFileName.c_str()), true);
+  CHECK_BOOL(vtkITKSharedMemoryImage::WriteImage(image.GetPointer(), ijkToRAS.GetPointer(),
+    sharedMemoryFileName.c_str()), true);
+
+  // Output volume is read through its storage node
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  scene->AddNode(volumeNode.GetPointer());
+  vtkNew<vtkMRMLVolumeArchetypeStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(sharedMemoryFileName.c_str());
+  CHECK_INT(storageNode->ReadData(volumeNode.GetPointer(), true), 1);
+  CHECK_POINTER(volumeNode->GetStorageNode(), storageNode.GetPointer());
+
+  vtkImageData* readImage = volumeNode->GetImageData();
+  CHECK_NOT_NULL(readImage);
+  CHECK_INT(readImage->GetScalarType(), VTK_SHORT);
+  int* dimensions = readImage->GetDimensions();
+  CHECK_INT(dimensions[0], 4);
+  CHECK_INT(dimensions[1], 5);
+  CHECK_INT(dimensions[2], 6);
+  short* voxels = static_cast<short*>(readImage->GetScalarPointer());
+  for (int i = 0; i < 4 * 5 * 6; ++i)
+    {
+    CHECK_INT(voxels[i], i - 50);
+    }
+  vtkNew<vtkMatrix4x4> readIJKToRAS;
+  volumeNode->GetIJKToRASMatrix(readIJKToRAS.GetPointer());
+  for (int row = 0; row < 4; ++row)
+    {
+    for (int column = 0; column < 4; ++column)
+      {
+      CHECK_BOOL(std::abs(readIJKToRAS->GetElement(row, column) - ijkToRAS->GetElement(row, column)) < 1e-6, true);
+      }
+    }
+
+  CHECK_BOOL(vtkITKSharedMemoryImage::RemoveImage(sharedMemoryFileName.c_str()), true);
+
+  // Released image cannot be read anymore
+  vtkNew<vtkMRMLScalarVolumeNode> otherVolumeNode;
+  scene->AddNode(otherVolumeNode.GetPointer());
+  TESTING_OUTPUT_IGNORE_WARNINGS_ERRORS_BEGIN();
+  CHECK_INT(storageNode->ReadData(otherVolumeNode.GetPointer(), true), 0);
+  TESTING_OUTPUT_IGNORE_WARNINGS_ERRORS_END();
+  CHECK_NULL(otherVolumeNode->GetImageData());
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSharedMemoryWriteFailure()
+{
+  // Command line module logic falls back to a temporary file
+  // if the image cannot be written into shared memory
+  vtkNew<vtkImageData> emptyImage;
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  std::string sharedMemoryFileName = vtkITKSharedMemoryImage::CreateUniqueFileName();
+  TESTING_OUTPUT_ASSERT_WARNINGS_BEGIN();
+  CHECK_BOOL(vtkITKSharedMemoryImage::WriteImage(emptyImage.GetPointer(), ijkToRAS.GetPointer(),
+    sharedMemoryFileName.c_str()), false);
+  TESTING_OUTPUT_ASSERT_WARNINGS_END();
+
+  vtkNew<vtkImageData> image;
+  CreateImage(image.GetPointer(), ijkToRAS.GetPointer());
+  TESTING_OUTPUT_ASSERT_WARNINGS_BEGIN();
+  CHECK_BOOL(vtkITKSharedMemoryImage::WriteImage(image.GetPointer(), ijkToRAS.GetPointer(), nullptr), false);
+  TESTING_OUTPUT_ASSERT_WARNINGS_END();
+
+  // Regular file names are not handled as shared memory images
+  CHECK_BOOL(vtkITKSharedMemoryImage::IsSharedMemoryFileName("/tmp/volume.nrrd"), false);
+  CHECK_BOOL(vtkITKSharedMemoryImage::IsSharedMemoryFileName(nullptr), false);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeArchetypeStorageNodeSharedMemoryTest(int vtkNotUsed(argc), char * vtkNotUsed(argv)[])
+{
+  if (!vtkITKSharedMemoryImage::IsSupported())
+    {
+    std::cout << "Shared memory images are not supported on this platform, test skipped" << std::endl;
+    return EXIT_SUCCESS;
+    }
+  CHECK_EXIT_SUCCESS(TestSharedMemoryRoundTrip());
+  CHECK_EXIT_SUCCESS(TestSharedMemoryWriteFailure());
+  return EXIT_SUCCESS;
+}
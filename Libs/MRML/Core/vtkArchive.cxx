@@ -18,7 +18,10 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include <archive_entry.h>
 
 // STD includes
+#include <algorithm>
+#include <cctype>
 #include <cstring>
+#include <fstream>
 #include <iostream>
 
 // VTK include
@@ -359,10 +362,66 @@ bool vtkArchive::ExtractTar(const char* tarFileName, bool verbose, bool extract,
   return true;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkArchive::IsFileCompressed(const char* fileName)
+{
+  if (!fileName)
+    {
+    return false;
+    }
+  std::string lowerFileName = vtksys::SystemTools::LowerCase(fileName);
+  const char* compressedExtensions[] =
+    {
+    ".gz", ".bz2", ".xz", ".zip", ".mrb", ".png", ".jpg", ".jpeg", ".mp4", ".zraw", ".mgz"
+    };
+  for (const char* extension : compressedExtensions)
+    {
+    if (vtksys::SystemTools::StringEndsWith(lowerFileName, extension))
+      {
+      return true;
+      }
+    }
+  if (!vtksys::SystemTools::StringEndsWith(lowerFileName, ".nrrd"))
+    {
+    return false;
+    }
+  // NRRD with attached data: read the header until the empty line that
+  // separates it from the data
+  std::ifstream nrrdFile(fileName, std::ios::in | std::ios::binary);
+  std::string line;
+  const size_t maxNumberOfHeaderLines = 1000;
+  for (size_t lineIndex = 0; lineIndex < maxNumberOfHeaderLines && std::getline(nrrdFile, line); ++lineIndex)
+    {
+    if (line.empty() || line == "\r")
+      {
+      break;
+      }
+    if (!vtksys::SystemTools::StringStartsWith(line, "encoding:"))
+      {
+      continue;
+      }
+    std::string encoding = vtksys::SystemTools::LowerCase(line.substr(strlen("encoding:")));
+    encoding.erase(std::remove_if(encoding.begin(), encoding.end(),
+      [](unsigned char c) { return std::isspace(c) != 0; }), encoding.end());
+    return (encoding == "gz" || encoding == "gzip" || encoding == "bz2" || encoding == "bzip2");
+    }
+  return false;
+}
+
 //-----------------------------------------------------------------------------
 // creates a zip file with the full contents of the directory (recurses)
 // zip entries will include relative path of including tail of directoryToZip
 bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
+{
+#ifdef HAVE_ZLIB_H
+  return vtkArchive::Zip(zipFileName, directoryToZip, true, false);
+#else
+  return vtkArchive::Zip(zipFileName, directoryToZip, false, false);
+#endif
+}
+
+//-----------------------------------------------------------------------------
+bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip, bool compress, bool removeZippedFiles)
 {
 
   //
@@ -404,7 +463,8 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
   // now zip it up using LibArchive
   struct archive *zipArchive;
   struct archive_entry *entry, *dirEntry;
-  char buff[BUFSIZ];
+  // large buffer to limit the number of reads of large data files
+  std::vector<char> buff(1024 * 1024);
   size_t len;
   // have to read the contents of the files to add them to the archive
   FILE *fd;
@@ -412,17 +472,18 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
   zipArchive = archive_write_new();
 
   // create a zip archive
-#ifdef HAVE_ZLIB_H
-  std::string compression_type = "deflate";
-#else
-  std::string compression_type = "store";
-#endif
+  std::string compression_type = (compress ? "deflate" : "store");
 
   archive_write_set_format_zip(zipArchive);
 
   archive_write_set_format_option(zipArchive, "zip", "compression", compression_type.c_str());
 
-  archive_write_open_filename(zipArchive, zipFileName);
+  if (archive_write_open_filename(zipArchive, zipFileName) != ARCHIVE_OK)
+    {
+    vtkArchiveTools::Error("Zip: cannot open:", zipFileName);
+    archive_write_free(zipArchive);
+    return false;
+    }
 
   // add the data directory
   dirEntry = archive_entry_new();
@@ -430,13 +491,13 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
   archive_entry_copy_pathname(dirEntry, directoryName.c_str());
   archive_entry_set_mode(dirEntry, S_IFDIR | 0755);
   archive_entry_set_size(dirEntry, 512);
-  archive_write_header(zipArchive, dirEntry);
+  bool success = (archive_write_header(zipArchive, dirEntry) == ARCHIVE_OK);
   archive_entry_free(dirEntry);
 
   // add the files
   std::vector<std::string>::const_iterator sit;
   sit = files.begin();
-  while (sit != files.end())
+  while (success && sit != files.end())
     {
     vtkArchiveTools::Message("Zip: adding:", (*sit).c_str());
     const char *fileName = (*sit).c_str();
@@ -459,7 +520,27 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
     archive_entry_set_size(entry, fileLength);
     archive_entry_set_filetype(entry, AE_IFREG);
     archive_entry_set_perm(entry, 0644);
-    archive_write_header(zipArchive, entry);
+#if ARCHIVE_VERSION_NUMBER >= 3001000
+    if (compress)
+      {
+      // do not spend time compressing data that is already compressed
+      if (vtkArchive::IsFileCompressed(fileName))
+        {
+        archive_write_zip_set_compression_store(zipArchive);
+        }
+      else
+        {
+        archive_write_zip_set_compression_deflate(zipArchive);
+        }
+      }
+#endif
+    if (archive_write_header(zipArchive, entry) != ARCHIVE_OK)
+      {
+      vtkArchiveTools::Error("Zip: cannot add entry:", archive_error_string(zipArchive));
+      archive_entry_free(entry);
+      success = false;
+      break;
+      }
 
     //
     // add the data for this entry
@@ -467,29 +548,62 @@ bool vtkArchive::Zip(const char* zipFileName, const char* directoryToZip)
     fd = fopen(fileName, "rb");
     if (!fd)
       {
-      vtkArchiveTools::Error("Zip: cannot open:", (*sit).c_str());
+      vtkArchiveTools::Error("Zip: cannot open:", fileName);
+      success = false;
       }
     else
       {
-      len = fread(buff, sizeof(char), sizeof(buff), fd);
+      // the source file is only removed if all its content is in the archive
+      bool entryWritten = true;
+      unsigned long writtenLength = 0;
+      len = fread(buff.data(), sizeof(char), buff.size(), fd);
       while ( len > 0 )
         {
-        archive_write_data(zipArchive, buff, len);
-        len = fread(buff, sizeof(char), sizeof(buff), fd);
+        vtkTypeInt64 written = static_cast<vtkTypeInt64>(archive_write_data(zipArchive, buff.data(), len));
+        if (written != static_cast<vtkTypeInt64>(len))
+          {
+          vtkArchiveTools::Error("Zip: cannot write data:", archive_error_string(zipArchive));
+          entryWritten = false;
+          break;
+          }
+        writtenLength += static_cast<unsigned long>(written);
+        len = fread(buff.data(), sizeof(char), buff.size(), fd);
+        }
+      if (ferror(fd) || writtenLength != fileLength)
+        {
+        vtkArchiveTools::Error("Zip: cannot read:", fileName);
+        entryWritten = false;
         }
       fclose(fd);
+      if (entryWritten && archive_write_finish_entry(zipArchive) != ARCHIVE_OK)
+        {
+        vtkArchiveTools::Error("Zip: cannot write entry:", archive_error_string(zipArchive));
+        entryWritten = false;
+        }
+      if (!entryWritten)
+        {
+        success = false;
+        }
+      else if (removeZippedFiles && !vtksys::SystemTools::RemoveFile(fileName))
+        {
+        vtkArchiveTools::Error("Zip: cannot remove:", fileName);
+        }
       }
     archive_entry_free(entry);
     }
 
-  archive_write_close(zipArchive);
+  if (archive_write_close(zipArchive) != ARCHIVE_OK)
+    {
+    vtkArchiveTools::Error("Zip:", "error on close!");
+    success = false;
+    }
   int retval = archive_write_free(zipArchive);
   if (retval != ARCHIVE_OK)
     {
     vtkArchiveTools::Error("Zip:", "error on close!");
     return false;
     }
-  return true;
+  return success;
 }
 
 //-----------------------------------------------------------------------------
@@ -39,6 +39,19 @@ public:
   // zip entries will include relative path of including tail of directoryToZip
   static bool Zip(const char* zipFileName, const char* directoryToZip);
 
+  // creates a zip file with the full contents of the directory (recurses)
+  // If compress is true then entries are deflated, except files that are
+  // already compressed (see IsFileCompressed()), which are stored as is.
+  // If removeZippedFiles is true then each file is deleted as soon as it has been
+  // added to the archive, so that the disk space needed is about the size of the
+  // directory instead of twice its size.
+  static bool Zip(const char* zipFileName, const char* directoryToZip, bool compress, bool removeZippedFiles);
+
+  // returns true if the content of the file is already compressed (compressed
+  // image formats, gzip files, NRRD files with compressed encoding, etc.),
+  // in which case compressing it again would only cost time.
+  static bool IsFileCompressed(const char* fileName);
+
   // unzips zip file into specified directory
   // (internally this supports many formats of archive, not just zip)
   static bool UnZip(const char* zipFileName, const char *destinationDirectory);
@@ -22,6 +22,18 @@
 #include <vtkObjectFactory.h>
 #include <vtkTimerLog.h>
 
+// STD includes
+#include <algorithm>
+
+namespace
+{
+//----------------------------------------------------------------------------
+bool HasHigherPriority(vtkObservation* observation1, vtkObservation* observation2)
+{
+  return observation1->GetPriority() > observation2->GetPriority();
+}
+}
+
 vtkCxxSetObjectMacro(vtkEventBroker, TimerLog, vtkTimerLog);
 
 //----------------------------------------------------------------------------
@@ -98,6 +110,9 @@ vtkEventBroker::vtkEventBroker()
   this->LogFileName = nullptr;
   this->ScriptHandler = nullptr;
   this->ScriptHandlerClientData = nullptr;
+  this->NumberOfFiredEvents = 0;
+  this->NumberOfCoalescedEvents = 0;
+  this->NumberOfDispatchedEvents = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -681,6 +696,7 @@ void vtkEventBroker::ProcessEvent ( vtkObservation *observation, vtkObject *call
   //
   if ( eid == observation->GetEvent() || observation->GetEvent() == vtkCommand::AnyEvent )
     {
+    this->NumberOfFiredEvents++;
     if ( this->EventMode == vtkEventBroker::Synchronous || eid == vtkCommand::DeleteEvent )
       {
       this->InvokeObservation( observation, eid, callData );
@@ -754,6 +770,10 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
   if ( this->GetCompressCallData() &&
        observation->GetEvent() != vtkCommand::AnyEvent)
     {
+    if ( !observation->GetCallDataList()->empty() )
+      {
+      this->NumberOfCoalescedEvents++;
+      }
     observation->GetCallDataList()->clear();
     observation->GetCallDataList()->push_back( call );
     }
@@ -772,11 +792,22 @@ void vtkEventBroker::QueueObservation ( vtkObservation *observation,
       {
       observation->GetCallDataList()->push_back( call );
       }
+    else
+      {
+      this->NumberOfCoalescedEvents++;
+      }
     }
 
+  //
+  // The queue is sorted by decreasing priority, insert the observation
+  // after the ones with the same priority to keep the order of events.
+  //
   if ( !observation->GetInEventQueue() )
     {
-    this->EventQueue.push_back( observation );
+    std::deque< vtkObservation * >::iterator queueIter =
+      std::upper_bound( this->EventQueue.begin(), this->EventQueue.end(),
+                        observation, HasHigherPriority );
+    this->EventQueue.insert( queueIter, observation );
     observation->SetInEventQueue(1);
     }
 }
@@ -841,6 +872,8 @@ void vtkEventBroker::InvokeObservation ( vtkObservation *observation,
   double elapsedTime = this->TimerLog->GetUniversalTime() - startTime;
   observation->SetTotalElapsedTime (observation->GetTotalElapsedTime() + elapsedTime);
   observation->SetLastElapsedTime (elapsedTime);
+  observation->SetNumberOfInvocations (observation->GetNumberOfInvocations() + 1);
+  this->NumberOfDispatchedEvents++;
   this->LogEvent (observation);
 
   // clear reference to observation (may cause delete)
@@ -852,32 +885,30 @@ void vtkEventBroker::InvokeObservation ( vtkObservation *observation,
 void vtkEventBroker::ProcessEventQueue ()
 {
   //
-  // for each observation on the event queue,
+  // for each observation on the event queue (highest priority first),
   // invoke it with each of the stored callData pointers
   // - register your pointer to the observation in case it
   //   gets deleted during handling of the event
-  // - if the observation is no longer in the queue, stop processing events
-  // - unregister before after dequeing in case the observation should go away
+  // - dequeue the observation and take its call data before invoking it:
+  //   events fired by the callbacks queue the observation again
+  // - if the observation is removed by a callback (it is then detached
+  //   and has no event tag), stop processing its events
   //
   while ( this->GetNumberOfQueuedObservations() > 0 )
     {
-    vtkObservation *observation = this->EventQueue.front();
+    vtkObservation *observation = this->DequeueObservation();
     observation->Register( this );
-    int finished = 0;
-    while ( !finished )
-      {
-      vtkObservation::CallType call = observation->GetCallDataList()->front();
-      observation->GetCallDataList()->pop_front();
-      finished = (observation->GetCallDataList()->size() == 0);
-      this->InvokeObservation( observation, call.EventID, call.CallData );
-      if ( !observation->GetInEventQueue() )
+    std::deque< vtkObservation::CallType > calls;
+    calls.swap( *observation->GetCallDataList() );
+    std::deque< vtkObservation::CallType >::const_iterator callIter;
+    for ( callIter = calls.begin(); callIter != calls.end(); ++callIter )
+      {
+      if ( observation->GetEventTag() == 0 )
         {
-        observation->GetCallDataList()->clear();
-        finished = 1;
         break;
         }
+      this->InvokeObservation( observation, callIter->EventID, callIter->CallData );
       }
-    this->DequeueObservation();
     observation->Delete();
     }
 }
@@ -894,6 +925,62 @@ void vtkEventBroker::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "EventNestingLevel: " << this->EventNestingLevel << "\n";
   os << indent << "LogFileName: " <<
     (this->LogFileName ? this->LogFileName : "(none)") << "\n";
+  os << indent << "NumberOfFiredEvents: " << this->NumberOfFiredEvents << "\n";
+  os << indent << "NumberOfCoalescedEvents: " << this->NumberOfCoalescedEvents << "\n";
+  os << indent << "NumberOfDispatchedEvents: " << this->NumberOfDispatchedEvents << "\n";
+}
+
+//----------------------------------------------------------------------------
+double vtkEventBroker::GetObserverTotalElapsedTime ( vtkObject *observer )
+{
+  double totalElapsedTime = 0.0;
+  ObjectToObservationVectorMap::iterator mapIter = this->ObserverMap.find( observer );
+  if ( mapIter == this->ObserverMap.end() )
+    {
+    return totalElapsedTime;
+    }
+  ObservationVector::iterator obsIter;
+  for ( obsIter = mapIter->second.begin(); obsIter != mapIter->second.end(); ++obsIter )
+    {
+    totalElapsedTime += (*obsIter)->GetTotalElapsedTime();
+    }
+  return totalElapsedTime;
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkEventBroker::GetObserverNumberOfInvocations ( vtkObject *observer )
+{
+  unsigned long numberOfInvocations = 0;
+  ObjectToObservationVectorMap::iterator mapIter = this->ObserverMap.find( observer );
+  if ( mapIter == this->ObserverMap.end() )
+    {
+    return numberOfInvocations;
+    }
+  ObservationVector::iterator obsIter;
+  for ( obsIter = mapIter->second.begin(); obsIter != mapIter->second.end(); ++obsIter )
+    {
+    numberOfInvocations += (*obsIter)->GetNumberOfInvocations();
+    }
+  return numberOfInvocations;
+}
+
+//----------------------------------------------------------------------------
+void vtkEventBroker::ResetStatistics ()
+{
+  this->NumberOfFiredEvents = 0;
+  this->NumberOfCoalescedEvents = 0;
+  this->NumberOfDispatchedEvents = 0;
+  ObjectToObservationVectorMap::iterator mapIter;
+  for ( mapIter = this->SubjectMap.begin(); mapIter != this->SubjectMap.end(); ++mapIter )
+    {
+    ObservationVector::iterator obsIter;
+    for ( obsIter = mapIter->second.begin(); obsIter != mapIter->second.end(); ++obsIter )
+      {
+      (*obsIter)->SetLastElapsedTime( 0.0 );
+      (*obsIter)->SetTotalElapsedTime( 0.0 );
+      (*obsIter)->SetNumberOfInvocations( 0 );
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
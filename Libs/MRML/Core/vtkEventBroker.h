@@ -179,6 +179,11 @@ public:
   /// In synchronous mode, observations are invoked immediately when the
   /// event takes place.  In asynchronous mode, observations are added
   /// to the event queue for later invocation.
+  /// Queued observations are invoked by decreasing priority (see
+  /// AddObservation), observations of equal priority in the order they
+  /// were queued. An observation that is already waiting in the queue is
+  /// not queued again: the new event is coalesced with the pending ones
+  /// (see CompressCallData).
   enum EventMode {
     Synchronous,
     Asynchronous
@@ -233,6 +238,25 @@ public:
   vtkGetMacro (CompressCallData, int);
   vtkSetMacro (CompressCallData, int);
 
+  /// Event statistics
+  ///
+  /// Number of events received for the observations (fired), merged into
+  /// an observation already waiting in the event queue (coalesced) and
+  /// delivered to the observers (dispatched).
+  vtkGetMacro (NumberOfFiredEvents, vtkTypeUInt64);
+  vtkGetMacro (NumberOfCoalescedEvents, vtkTypeUInt64);
+  vtkGetMacro (NumberOfDispatchedEvents, vtkTypeUInt64);
+
+  ///
+  /// Time spent in the callbacks of all the observations of an observer
+  /// and number of times they were invoked.
+  double GetObserverTotalElapsedTime (vtkObject *observer);
+  unsigned long GetObserverNumberOfInvocations (vtkObject *observer);
+
+  ///
+  /// Reset the event counters and the elapsed times of the observations
+  void ResetStatistics ();
+
   ///
   /// Sets the method pointer to be used for processing script observations
   void SetScriptHandler ( void (*scriptHandler) (const char* script, void *clientData), void *clientData )
@@ -286,6 +310,10 @@ protected:
   int EventMode;
   int CompressCallData;
 
+  vtkTypeUInt64 NumberOfFiredEvents;
+  vtkTypeUInt64 NumberOfCoalescedEvents;
+  vtkTypeUInt64 NumberOfDispatchedEvents;
+
   std::ofstream LogFile;
 private:
   /// DetachObservations is a fast (but dangerous) method to delete all the
@@ -0,0 +1,267 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "vtkMRMLImageStatistics.h"
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkImageData.h>
+#include <vtkImageHistogramStatistics.h>
+#include <vtkInformation.h>
+#include <vtkInformationObjectBaseKey.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+#include <limits>
+#include <sstream>
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLImageStatistics);
+vtkInformationKeyMacro(vtkMRMLImageStatistics, IMAGE_STATISTICS, ObjectBase);
+
+//----------------------------------------------------------------------------
+vtkMRMLImageStatistics::vtkMRMLImageStatistics()
+{
+  this->ScalarRange[0] = 0.0;
+  this->ScalarRange[1] = 0.0;
+  this->AutoRange[0] = 0.0;
+  this->AutoRange[1] = 0.0;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLImageStatistics::~vtkMRMLImageStatistics() = default;
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageStatistics::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "ScalarRange: " << this->ScalarRange[0] << " " << this->ScalarRange[1] << "\n";
+  os << indent << "Mean: " << this->Mean << "\n";
+  os << indent << "Median: " << this->Median << "\n";
+  os << indent << "StandardDeviation: " << this->StandardDeviation << "\n";
+  os << indent << "AutoRange: " << this->AutoRange[0] << " " << this->AutoRange[1] << "\n";
+  os << indent << "NumberOfVoxels: " << this->NumberOfVoxels << "\n";
+  os << indent << "Histogram: " << (this->Histogram ? "available" : "not computed") << "\n";
+  os << indent << "BinOrigin: " << this->BinOrigin << "\n";
+  os << indent << "BinSpacing: " << this->BinSpacing << "\n";
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLImageStatistics* vtkMRMLImageStatistics::GetCachedImageStatistics(vtkImageData* image)
+{
+  if (!image)
+    {
+    return nullptr;
+    }
+  vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::SafeDownCast(
+    image->GetInformation()->Get(vtkMRMLImageStatistics::IMAGE_STATISTICS()));
+  if (!statistics || !statistics->IsUpToDate(image))
+    {
+    return nullptr;
+    }
+  return statistics;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLImageStatistics* vtkMRMLImageStatistics::GetImageStatistics(vtkImageData* image)
+{
+  vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::GetCachedImageStatistics(image);
+  if (statistics)
+    {
+    return statistics;
+    }
+  vtkNew<vtkMRMLImageStatistics> newStatistics;
+  if (!newStatistics->Compute(image))
+    {
+    return nullptr;
+    }
+  newStatistics->StoreInImage(image);
+  return newStatistics.GetPointer();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageStatistics::RemoveImageStatistics(vtkImageData* image)
+{
+  if (!image)
+    {
+    return;
+    }
+  image->GetInformation()->Remove(vtkMRMLImageStatistics::IMAGE_STATISTICS());
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageStatistics::SetSource(vtkImageData* image)
+{
+  vtkDataArray* scalars = image->GetPointData()->GetScalars();
+  this->Image = image;
+  this->ImageMTime = image->GetMTime();
+  this->Scalars = scalars;
+  this->ScalarsMTime = scalars->GetMTime();
+  this->NumberOfVoxels = scalars->GetNumberOfTuples();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLImageStatistics::IsUpToDate(vtkImageData* image)
+{
+  vtkDataArray* scalars = (image && image->GetPointData()) ? image->GetPointData()->GetScalars() : nullptr;
+  return scalars != nullptr
+    && this->Image.GetPointer() == image
+    && this->ImageMTime == image->GetMTime()
+    && this->Scalars.GetPointer() == scalars
+    && this->ScalarsMTime == scalars->GetMTime()
+    && this->NumberOfVoxels == scalars->GetNumberOfTuples();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLImageStatistics::StoreInImage(vtkImageData* image)
+{
+  image->GetInformation()->Set(vtkMRMLImageStatistics::IMAGE_STATISTICS(), this);
+  // storing the statistics must not make them out of date
+  this->ImageMTime = image->GetMTime();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLImageStatistics::Compute(vtkImageData* image)
+{
+  // vtkImageHistogramStatistics crashes if there are no scalars
+  if (!image || !image->GetPointData() || !image->GetPointData()->GetScalars()
+    || image->GetPointData()->GetScalars()->GetNumberOfTuples() == 0)
+    {
+    return false;
+    }
+
+  vtkNew<vtkImageHistogramStatistics> histogramStatistics;
+  // Automatic range includes the entire intensity range except the top/bottom 0.1%,
+  // to not let a very thin tail of the intensity distribution to decrease the image
+  // contrast too much.
+  // While in CT and sometimes in MRI, there may be a large empty area
+  // outside the reconstructed image, which could be suppressed
+  // by a larger lower percentile value, it would make the method
+  // too specific to particular imaging modalities and could lead to
+  // suboptimal results for other types of images.
+  histogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
+  // Percentiles are very low (0.1%), so there is no need for range expansion.
+  histogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+  histogramStatistics->SetActiveComponent(0);
+  histogramStatistics->GenerateHistogramImageOff();
+  histogramStatistics->SetInputData(image);
+  histogramStatistics->Update();
+
+  this->ScalarRange[0] = histogramStatistics->GetMinimum();
+  this->ScalarRange[1] = histogramStatistics->GetMaximum();
+  this->Mean = histogramStatistics->GetMean();
+  this->Median = histogramStatistics->GetMedian();
+  this->StandardDeviation = histogramStatistics->GetStandardDeviation();
+  histogramStatistics->GetAutoRange(this->AutoRange);
+
+  this->Histogram = vtkSmartPointer<vtkIdTypeArray>::New();
+  this->Histogram->DeepCopy(histogramStatistics->GetHistogram());
+  this->BinOrigin = histogramStatistics->GetBinOrigin();
+  this->BinSpacing = histogramStatistics->GetBinSpacing();
+
+  this->SetSource(image);
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray* vtkMRMLImageStatistics::GetHistogram()
+{
+  if (!this->Histogram && this->Image)
+    {
+    // Statistics were read from file header, which does not contain the histogram
+    this->Compute(this->Image);
+    }
+  return this->Histogram;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLImageStatistics::GetBinOrigin()
+{
+  this->GetHistogram();
+  return this->BinOrigin;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLImageStatistics::GetBinSpacing()
+{
+  this->GetHistogram();
+  return this->BinSpacing;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLImageStatistics::GetPercentile(double percent)
+{
+  vtkIdTypeArray* histogram = this->GetHistogram();
+  if (!histogram || histogram->GetNumberOfTuples() == 0)
+    {
+    vtkErrorMacro("GetPercentile failed: histogram is not available");
+    return 0.0;
+    }
+  const vtkIdType numberOfBins = histogram->GetNumberOfTuples();
+  const vtkIdType* binCounts = histogram->GetPointer(0);
+  vtkIdType totalCount = 0;
+  for (vtkIdType binIndex = 0; binIndex < numberOfBins; ++binIndex)
+    {
+    totalCount += binCounts[binIndex];
+    }
+  double targetCount = totalCount * std::min(100.0, std::max(0.0, percent)) / 100.0;
+  vtkIdType count = 0;
+  for (vtkIdType binIndex = 0; binIndex < numberOfBins; ++binIndex)
+    {
+    count += binCounts[binIndex];
+    if (count > 0 && count >= targetCount)
+      {
+      return this->BinOrigin + binIndex * this->BinSpacing;
+      }
+    }
+  return this->BinOrigin + (numberOfBins - 1) * this->BinSpacing;
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLImageStatistics::GetHeaderValue()
+{
+  // Values are written with full precision so that the range is exactly restored
+  std::ostringstream headerValue;
+  headerValue.precision(std::numeric_limits<double>::max_digits10);
+  headerValue << this->NumberOfVoxels
+    << " " << this->ScalarRange[0] << " " << this->ScalarRange[1]
+    << " " << this->Mean << " " << this->Median << " " << this->StandardDeviation
+    << " " << this->AutoRange[0] << " " << this->AutoRange[1];
+  return headerValue.str();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLImageStatistics::SetImageStatisticsFromHeaderValue(vtkImageData* image, const std::string& headerValue)
+{
+  if (!image || !image->GetPointData() || !image->GetPointData()->GetScalars())
+    {
+    return false;
+    }
+  vtkNew<vtkMRMLImageStatistics> statistics;
+  std::istringstream headerStream(headerValue);
+  vtkIdType numberOfVoxels = 0;
+  headerStream >> numberOfVoxels
+    >> statistics->ScalarRange[0] >> statistics->ScalarRange[1]
+    >> statistics->Mean >> statistics->Median >> statistics->StandardDeviation
+    >> statistics->AutoRange[0] >> statistics->AutoRange[1];
+  if (headerStream.fail()
+    || numberOfVoxels != image->GetPointData()->GetScalars()->GetNumberOfTuples())
+    {
+    // values are invalid or stored for a different image
+    return false;
+    }
+  statistics->SetSource(image);
+  statistics->StoreInImage(image);
+  return true;
+}
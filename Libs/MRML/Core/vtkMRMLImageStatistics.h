@@ -0,0 +1,138 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLImageStatistics_h
+#define __vtkMRMLImageStatistics_h
+
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <string>
+
+class vtkDataArray;
+class vtkIdTypeArray;
+class vtkImageData;
+class vtkInformationObjectBaseKey;
+
+/// \brief Intensity statistics of an image, computed once and shared by all users of the image.
+///
+/// GetImageStatistics() stores the statistics in the information of the image data object,
+/// therefore display nodes, volume rendering and other modules that need the statistics
+/// of the same image share a single computation. Statistics are recomputed when the
+/// image or its scalars are replaced or modified.
+///
+/// Statistics are computed from the first scalar component, in one pass of the
+/// multi-threaded vtkImageHistogramStatistics filter.
+///
+/// The summary values (all values except the histogram) can be stored in a file header
+/// (see GetHeaderValue() and SetImageStatisticsFromHeaderValue()), so that they are not
+/// computed again when the image is loaded.
+class VTK_MRML_EXPORT vtkMRMLImageStatistics : public vtkObject
+{
+public:
+  static vtkMRMLImageStatistics *New();
+  vtkTypeMacro(vtkMRMLImageStatistics,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Get statistics of the image.
+  /// Cached statistics are returned if the scalars have not changed since they were computed,
+  /// otherwise the statistics are computed and cached in the image.
+  /// Returns nullptr if the image has no scalars.
+  /// Must be called from the main thread.
+  static vtkMRMLImageStatistics* GetImageStatistics(vtkImageData* image);
+
+  /// Get statistics of the image if they are cached and up to date, without computing them.
+  static vtkMRMLImageStatistics* GetCachedImageStatistics(vtkImageData* image);
+
+  /// Remove cached statistics from the image.
+  static void RemoveImageStatistics(vtkImageData* image);
+
+  /// Image information key that stores the statistics.
+  static vtkInformationObjectBaseKey* IMAGE_STATISTICS();
+
+  /// Name of the file header field that stores the statistics.
+  static const char* GetHeaderKey() { return "Slicer.ImageStatistics"; }
+
+  /// Summary values, serialized for storing in a file header.
+  std::string GetHeaderValue();
+
+  /// Cache statistics that were read from a file header in the image.
+  /// The values are ignored if they do not belong to this image (number of voxels is different).
+  /// The histogram is computed when it is first requested.
+  /// Returns true if the statistics are set.
+  static bool SetImageStatisticsFromHeaderValue(vtkImageData* image, const std::string& headerValue);
+
+  /// Minimum and maximum voxel value
+  vtkGetVector2Macro(ScalarRange, double);
+
+  vtkGetMacro(Mean, double);
+  vtkGetMacro(Median, double);
+  vtkGetMacro(StandardDeviation, double);
+
+  /// Intensity range between the 0.1 and 99.9 percentiles.
+  /// It is used as automatic window/level and threshold range.
+  vtkGetVector2Macro(AutoRange, double);
+
+  /// Number of voxels that the statistics are computed from
+  vtkGetMacro(NumberOfVoxels, vtkIdType);
+
+  /// Number of voxels in each histogram bin.
+  /// Bin i covers the values around BinOrigin + i * BinSpacing.
+  vtkIdTypeArray* GetHistogram();
+  double GetBinOrigin();
+  double GetBinSpacing();
+
+  /// Voxel value below which the specified percent (0-100) of voxel values fall.
+  /// Computed from the histogram, therefore accuracy is limited to the bin spacing.
+  double GetPercentile(double percent);
+
+protected:
+  vtkMRMLImageStatistics();
+  ~vtkMRMLImageStatistics() override;
+
+  /// Compute all statistics and the histogram from the image scalars
+  bool Compute(vtkImageData* image);
+
+  /// Remember the scalars that the statistics belong to
+  void SetSource(vtkImageData* image);
+
+  /// Return true if the statistics belong to the current scalars of the image
+  bool IsUpToDate(vtkImageData* image);
+
+  /// Cache the statistics in the image information
+  void StoreInImage(vtkImageData* image);
+
+  double ScalarRange[2];
+  double Mean{0.0};
+  double Median{0.0};
+  double StandardDeviation{0.0};
+  double AutoRange[2];
+  vtkIdType NumberOfVoxels{0};
+
+  /// Histogram is not available if the statistics are read from a file header
+  vtkSmartPointer<vtkIdTypeArray> Histogram;
+  double BinOrigin{0.0};
+  double BinSpacing{1.0};
+
+  vtkWeakPointer<vtkImageData> Image;
+  vtkMTimeType ImageMTime{0};
+  vtkWeakPointer<vtkDataArray> Scalars;
+  vtkMTimeType ScalarsMTime{0};
+
+private:
+  vtkMRMLImageStatistics(const vtkMRMLImageStatistics&) = delete;
+  void operator=(const vtkMRMLImageStatistics&) = delete;
+};
+
+#endif
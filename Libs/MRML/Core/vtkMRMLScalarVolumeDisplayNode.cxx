@@ -14,6 +14,7 @@ Version:   $Revision: 1.2 $
 
 // MRML includes
 #include "vtkEventBroker.h"
+#include "vtkMRMLImageStatistics.h"
 #include "vtkMRMLScalarVolumeDisplayNode.h"
 #include "vtkMRMLScene.h"
 #include "vtkMRMLProceduralColorNode.h"
@@ -27,7 +28,6 @@ Version:   $Revision: 1.2 $
 #include <vtkImageCast.h>
 #include <vtkImageData.h>
 #include <vtkImageExtractComponents.h>
-#include <vtkImageHistogramStatistics.h>
 #include <vtkImageLogic.h>
 #include <vtkImageMapToWindowLevelColors.h>
 #include <vtkImageStencil.h>
@@ -104,7 +104,6 @@ vtkMRMLScalarVolumeDisplayNode::vtkMRMLScalarVolumeDisplayNode()
   this->AppendComponents->AddInputConnection(0, this->ExtractRGB->GetOutputPort() );
   this->AppendComponents->AddInputConnection(0, this->AlphaLogic->GetOutputPort() );
 
-  this->HistogramStatistics = nullptr;
   this->IsInCalculateAutoLevels = false;
 
   vtkEventBroker::GetInstance()->AddObservation(
@@ -124,12 +123,6 @@ vtkMRMLScalarVolumeDisplayNode::~vtkMRMLScalarVolumeDisplayNode()
   this->ExtractRGB->Delete();
   this->ExtractAlpha->Delete();
   this->MultiplyAlpha->Delete();
-
-  if (this->HistogramStatistics)
-    {
-    this->HistogramStatistics->Delete();
-    this->HistogramStatistics = nullptr;
-    }
 }
 
 //----------------------------------------------------------------------------
@@ -689,7 +682,20 @@ void vtkMRMLScalarVolumeDisplayNode::GetDisplayScalarRange(double range[2])
     return;
     }
   this->GetScalarImageDataConnection()->GetProducer()->Update();
-  imageData->GetScalarRange(range);
+  if (imageData->GetNumberOfScalarComponents() == 1)
+    {
+    vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::GetImageStatistics(imageData);
+    if (statistics)
+      {
+      statistics->GetScalarRange(range);
+      }
+    }
+  else
+    {
+    // statistics are computed from the first component only, while the range
+    // of multi-component images is the range of the vector magnitude
+    imageData->GetScalarRange(range);
+    }
   if (imageData->GetNumberOfScalarComponents() >=3 &&
       fabs(range[0]) < 0.000001 && fabs(range[1]) < 0.000001)
     {
@@ -730,32 +736,17 @@ void vtkMRMLScalarVolumeDisplayNode::CalculateAutoLevels()
     return;
     }
 
-  if (this->HistogramStatistics == nullptr)
+  // Statistics are computed once and shared by all display nodes and modules that use this image
+  vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::GetImageStatistics(imageDataScalar);
+  if (!statistics)
     {
-    this->HistogramStatistics = vtkImageHistogramStatistics::New();
-
-    // Set automatic window/level to include the entire intensity range
-    // (except top/bottom 0.1%, to not let a very thin tail of the intensity
-    // distribution to decrease the image contrast too much).
-    // While in CT and sometimes in MRI, there may be a large empty area
-    // outside the reconstructed image, which could be suppressed
-    // by a larger lower percentile value, it would make the method
-    // too specific to particular imaging modalities and could lead to
-    // suboptimal results for other types of images.
-    // Therefore, we choose small, symmetric percentile values here
-    // and maybe add modality-specific methods later (e.g., for CT
-    // images we could set lower value to -1000HU).
-    this->HistogramStatistics->SetAutoRangePercentiles(0.1, 99.9);
-
-    // Percentiles are very low (0.1%), so there is no need for
-    // range expansion.
-    this->HistogramStatistics->SetAutoRangeExpansionFactors(0.0, 0.0);
+    vtkDebugMacro("CalculateScalarAutoLevels: image statistics are not available");
+    return;
     }
 
   this->IsInCalculateAutoLevels = true;
-  this->HistogramStatistics->SetInputData(imageDataScalar);
-  this->HistogramStatistics->Update();
-  double* intensityRange = this->HistogramStatistics->GetAutoRange();
+  double intensityRange[2] = { 0.0, 0.0 };
+  statistics->GetAutoRange(intensityRange);
   vtkDebugMacro("CalculateScalarAutoLevels:"
                 << " lower: " << intensityRange[0] << " upper: " << intensityRange[1]);
 
@@ -21,7 +21,6 @@
 // VTK includes
 class vtkImageAlgorithm;
 class vtkImageAppendComponents;
-class vtkImageHistogramStatistics;
 class vtkImageCast;
 class vtkImageLogic;
 class vtkImageMapToColors;
@@ -241,7 +240,6 @@ protected:
 
   ///
   /// Used internally in CalculateScalarAutoLevels and CalculateStatisticsAutoLevels
-  vtkImageHistogramStatistics *HistogramStatistics;
   bool IsInCalculateAutoLevels;
 };
 
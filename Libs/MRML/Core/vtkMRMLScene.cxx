@@ -92,9 +92,12 @@ Version:   $Revision: 1.18 $
 #include <vtkCollection.h>
 #include <vtkDebugLeaks.h>
 #include <vtkErrorCode.h>
+#include <vtkImageData.h>
 #include <vtkObjectFactory.h>
 #include <vtkPNGWriter.h>
+#include <vtkPointSet.h>
 #include <vtkSmartPointer.h>
+#include <vtkTable.h>
 
 // VTKSYS includes
 #include <vtksys/RegularExpression.hxx>
@@ -111,6 +114,73 @@ Version:   $Revision: 1.18 $
 # include <vtkTimerLog.h>
 #endif
 
+//------------------------------------------------------------------------------
+namespace
+{
+/// Approximate memory used by a node, excluding its bulk data.
+const vtkTypeInt64 NODE_BASE_MEMORY_SIZE = 1024;
+
+//------------------------------------------------------------------------------
+/// Return the bulk data object of a node (image, mesh or table), if any.
+vtkDataObject* GetNodeDataObject(vtkMRMLNode* node)
+{
+  if (vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(node))
+    {
+    return volumeNode->GetImageData();
+    }
+  if (vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(node))
+    {
+    return modelNode->GetMesh();
+    }
+  if (vtkMRMLTableNode* tableNode = vtkMRMLTableNode::SafeDownCast(node))
+    {
+    return tableNode->GetTable();
+    }
+  return nullptr;
+}
+
+//------------------------------------------------------------------------------
+/// Return the time the content of a node has been last modified.
+/// Bulk data of storable nodes may be modified without the node being
+/// modified, therefore 0 is returned for storable nodes with unknown bulk data
+/// to indicate that the modification time can't be determined.
+vtkMTimeType GetNodeContentMTime(vtkMRMLNode* node)
+{
+  vtkMTimeType mtime = node->GetMTime();
+  if (!vtkMRMLStorableNode::SafeDownCast(node))
+    {
+    return mtime;
+    }
+  if (!vtkMRMLVolumeNode::SafeDownCast(node)
+    && !vtkMRMLModelNode::SafeDownCast(node)
+    && !vtkMRMLTableNode::SafeDownCast(node))
+    {
+    return 0;
+    }
+  vtkDataObject* dataObject = GetNodeDataObject(node);
+  if (dataObject)
+    {
+    mtime = std::max(mtime, dataObject->GetMTime());
+    }
+  return mtime;
+}
+
+//------------------------------------------------------------------------------
+/// Return the estimated memory size of a node, in bytes.
+vtkTypeInt64 GetNodeMemorySize(vtkMRMLNode* node)
+{
+  vtkTypeInt64 size = NODE_BASE_MEMORY_SIZE;
+  vtkDataObject* dataObject = GetNodeDataObject(node);
+  if (dataObject)
+    {
+    // GetActualMemorySize() returns kibibytes
+    size += static_cast<vtkTypeInt64>(dataObject->GetActualMemorySize()) * 1024;
+    }
+  return size;
+}
+}
+
+//------------------------------------------------------------------------------
 vtkCxxSetObjectMacro(vtkMRMLScene, CacheManager, vtkCacheManager)
 vtkCxxSetObjectMacro(vtkMRMLScene, DataIOManager, vtkDataIOManager)
 vtkCxxSetObjectMacro(vtkMRMLScene, UserTagTable, vtkTagTable)
@@ -120,6 +190,7 @@ vtkCxxSetObjectMacro(vtkMRMLScene, URIHandlerCollection, vtkCollection)
 vtkMRMLScene::vtkMRMLScene()
 {
   this->NodeIDsMTime = 0;
+  this->NodesByClassMTime = 0;
 
   this->RegisteredNodeClasses.clear();
   this->UniqueIDs.clear();
@@ -127,6 +198,7 @@ vtkMRMLScene::vtkMRMLScene()
 
   this->Nodes =  vtkCollection::New();
   this->MaximumNumberOfSavedUndoStates = 20;
+  this->MaximumUndoMemorySize = 0;
   this->UndoFlag = false;
 
   this->NodeReferences.clear();
@@ -369,6 +441,9 @@ void vtkMRMLScene::RemoveAllNodes(bool removeSingletons)
       removeNodeIds.emplace_back(node->GetID());
       }
     }
+  // Removing the nodes one by one from the class lists would take quadratic
+  // time, the lists are recomputed on demand instead.
+  this->ClearNodesByClass();
   for(std::deque< std::string >::iterator nodeIt=removeNodeIds.begin(); nodeIt!=removeNodeIds.end(); ++nodeIt)
     {
     vtkMRMLNode* node=this->GetNodeByID(*nodeIt);
@@ -1200,10 +1275,12 @@ vtkMRMLNode* vtkMRMLScene::AddNodeNoNotify(vtkMRMLNode *n)
     n->SetName(this->GenerateUniqueName(n).c_str());
     }
   n->SetScene( this );
+  this->UpdateNodesByClass();
   this->Nodes->vtkCollection::AddItem((vtkObject *)n);
 
   // cache the node so the whole scene cache stays up-to date
   this->AddNodeID(n);
+  this->AddNodeToNodesByClass(n);
 
   // Keep the SH up-to-date
   if (vtkMRMLSubjectHierarchyNode::SafeDownCast(n) != nullptr &&
@@ -1417,10 +1494,12 @@ void vtkMRMLScene::RemoveNode(vtkMRMLNode *n)
     {
     n->SetScene(nullptr);
     }
+  this->UpdateNodesByClass();
   this->Nodes->vtkCollection::RemoveItem((vtkObject *)n);
 
   std::string nid = (n->GetID() ? n->GetID() : "");
   this->RemoveNodeID(n->GetID());
+  this->RemoveNodeFromNodesByClass(n);
 
   this->InvokeEvent(vtkMRMLScene::NodeRemovedEvent, n);
 
@@ -1598,18 +1677,7 @@ int vtkMRMLScene::GetNumberOfNodesByClass(const char *className)
     vtkErrorMacro("GetNumberOfNodesByClass: class name is null.");
     return 0;
     }
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      num++;
-      }
-    }
-  return num;
+  return static_cast<int>(this->GetNodesByClassCache(className).size());
 }
 
 //------------------------------------------------------------------------------
@@ -1621,16 +1689,7 @@ int vtkMRMLScene::GetNodesByClass(const char *className, std::vector<vtkMRMLNode
     vtkErrorMacro("GetNodesByClass: class name is null.");
     return 0;
     }
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
-    {
-    if (node->IsA(className))
-      {
-      nodes.push_back(node);
-      }
-    }
+  nodes = this->GetNodesByClassCache(className);
   return static_cast<int>(nodes.size());
 }
 
@@ -1643,15 +1702,11 @@ vtkCollection* vtkMRMLScene::GetNodesByClass(const char *className)
     return nullptr;
     }
   vtkCollection* nodes = vtkCollection::New();
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>& classNodes = this->GetNodesByClassCache(className);
+  for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = classNodes.begin();
+       nodeIt != classNodes.end(); ++nodeIt)
     {
-    if (node->IsA(className))
-      {
-      nodes->AddItem(node);
-      }
+    nodes->AddItem(*nodeIt);
     }
   return nodes;
 }
@@ -1712,13 +1767,12 @@ vtkMRMLNode* vtkMRMLScene::GetSingletonNode(const char* singletonTag, const char
     return nullptr;
     }
 
-  vtkCollectionSimpleIterator it;
-  vtkMRMLNode* node = nullptr;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>& classNodes = this->GetNodesByClassCache(className);
+  for (std::vector<vtkMRMLNode*>::const_iterator nodeIt = classNodes.begin();
+       nodeIt != classNodes.end(); ++nodeIt)
     {
-    if (node->IsA(className) &&
-        node->GetSingletonTag() != nullptr &&
+    vtkMRMLNode* node = *nodeIt;
+    if (node->GetSingletonTag() != nullptr &&
         strcmp(node->GetSingletonTag(), singletonTag) == 0)
       {
       return node;
@@ -1788,22 +1842,12 @@ vtkMRMLNode* vtkMRMLScene::GetNthNodeByClass(int n, const char *className)
     return nullptr;
     }
 
-  int num=0;
-  vtkMRMLNode *node;
-  vtkCollectionSimpleIterator it;
-  for (this->Nodes->InitTraversal(it);
-       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+  const std::vector<vtkMRMLNode*>& classNodes = this->GetNodesByClassCache(className);
+  if (n >= static_cast<int>(classNodes.size()))
     {
-    if (node->IsA(className))
-      {
-      if (num == n)
-        {
-        return node;
-        }
-      num++;
-      }
+    return nullptr;
     }
-  return nullptr;
+  return classNodes[n];
 }
 
 //------------------------------------------------------------------------------
@@ -2049,6 +2093,8 @@ vtkMRMLNode* vtkMRMLScene::InsertAfterNode(vtkMRMLNode *item, vtkMRMLNode *n)
     }
   // cache the node so the whole scene cache stays up-to-date
   this->AddNodeID(n);
+  // the node is not necessarily appended, the class lists are recomputed on demand
+  this->ClearNodesByClass();
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2147,6 +2193,8 @@ vtkMRMLNode* vtkMRMLScene::InsertBeforeNode(vtkMRMLNode *item, vtkMRMLNode *n)
     }
   // cache the node so the whole scene cache stays up-todate
   this->AddNodeID(n);
+  // the node is not necessarily appended, the class lists are recomputed on demand
+  this->ClearNodesByClass();
 
   n->SetDisableModifiedEvent(modifyStatus);
 
@@ -2507,11 +2555,12 @@ void vtkMRMLScene::SaveStateForUndo (vtkMRMLNode *node)
 
   this->ClearRedoStack();
   //this->SetUndoOn();
-  this->PushIntoUndoStack();
+  std::set<vtkMRMLNode*> nodesToCopy;
   if (node)
     {
-    this->CopyNodeInUndoStack(node);
+    nodesToCopy.insert(node);
     }
+  this->PushIntoUndoStack(nodesToCopy);
 }
 
 //------------------------------------------------------------------------------
@@ -2533,16 +2582,17 @@ void vtkMRMLScene::SaveStateForUndo (std::vector<vtkMRMLNode *> nodes)
 
   this->ClearRedoStack();
   //this->SetUndoOn();
-  this->PushIntoUndoStack();
+  std::set<vtkMRMLNode*> nodesToCopy;
   unsigned int n;
   for (n=0; n<nodes.size(); n++)
     {
     vtkMRMLNode *node = nodes[n];
     if (node && node->GetUndoEnabled())
       {
-      this->CopyNodeInUndoStack(node);
+      nodesToCopy.insert(node);
       }
     }
+  this->PushIntoUndoStack(nodesToCopy);
 }
 
 //------------------------------------------------------------------------------
@@ -2570,18 +2620,17 @@ void vtkMRMLScene::SaveStateForUndo (vtkCollection* nodes)
 
   this->ClearRedoStack();
   //this->SetUndoOn();
-  this->PushIntoUndoStack();
-
+  std::set<vtkMRMLNode*> nodesToCopy;
   int nnodes = nodes->GetNumberOfItems();
-
   for (int n=0; n<nnodes; n++)
     {
     vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(nodes->GetItemAsObject(n));
     if (node && node->GetUndoEnabled())
       {
-      this->CopyNodeInUndoStack(node);
+      nodesToCopy.insert(node);
       }
     }
+  this->PushIntoUndoStack(nodesToCopy);
 }
 
 //------------------------------------------------------------------------------
@@ -2605,6 +2654,14 @@ void vtkMRMLScene::SaveStateForUndo ()
 //------------------------------------------------------------------------------
 // Make a new collection that has pointers to all the nodes in the current scene
 void vtkMRMLScene::PushIntoUndoStack()
+{
+  this->PushIntoUndoStack(std::set<vtkMRMLNode*>());
+}
+
+//------------------------------------------------------------------------------
+// Make a new collection that has pointers to all the nodes in the current scene
+// and copies of the nodes that must be restorable.
+void vtkMRMLScene::PushIntoUndoStack(const std::set<vtkMRMLNode*>& nodesToCopy)
 {
   if (this->Nodes == nullptr)
     {
@@ -2620,9 +2677,19 @@ void vtkMRMLScene::PushIntoUndoStack()
   for (int n=0; n<nnodes; n++)
     {
     vtkMRMLNode *node  = vtkMRMLNode::SafeDownCast(currentScene->GetItemAsObject(n));
-    if (node && node->GetUndoEnabled())
+    if (!node || !node->GetUndoEnabled())
+      {
+      continue;
+      }
+    if (nodesToCopy.find(node) == nodesToCopy.end())
       {
       newScene->AddItem(node);
+      continue;
+      }
+    vtkSmartPointer<vtkMRMLNode> nodeCopy = this->GetNodeCopyForUndo(node);
+    if (nodeCopy)
+      {
+      newScene->AddItem(nodeCopy);
       }
     }
 
@@ -2668,10 +2735,10 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode *copyNode)
     return;
     }
 
-  vtkMRMLNode *snode = copyNode->CreateNodeInstance();
-  if (snode != nullptr)
+  vtkSmartPointer<vtkMRMLNode> snode = this->GetNodeCopyForUndo(copyNode);
+  if (!snode || this->UndoStack.empty())
     {
-    snode->CopyWithScene(copyNode);
+    return;
     }
 
   vtkCollection* undoScene = this->UndoStack.back();
@@ -2685,7 +2752,123 @@ void vtkMRMLScene::CopyNodeInUndoStack(vtkMRMLNode *copyNode)
       break;
       }
     }
-  snode->Delete();
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMRMLNode> vtkMRMLScene::GetNodeCopyForUndo(vtkMRMLNode* node)
+{
+  if (!node)
+    {
+    return nullptr;
+    }
+  std::string nodeID = (node->GetID() ? node->GetID() : "");
+  vtkMTimeType nodeMTime = GetNodeContentMTime(node);
+  if (!nodeID.empty() && nodeMTime > 0)
+    {
+    std::map< std::string, UndoNodeCopyInfo >::iterator copyIt = this->UndoNodeCopies.find(nodeID);
+    if (copyIt != this->UndoNodeCopies.end()
+      && copyIt->second.Node.GetPointer() == node
+      && copyIt->second.NodeMTime == nodeMTime)
+      {
+      // The node has not been modified since it was last saved,
+      // share the copy between the undo states.
+      return copyIt->second.NodeCopy;
+      }
+    }
+
+  vtkSmartPointer<vtkMRMLNode> nodeCopy = vtkSmartPointer<vtkMRMLNode>::Take(node->CreateNodeInstance());
+  if (!nodeCopy)
+    {
+    vtkErrorMacro("GetNodeCopyForUndo: failed to create copy of node " << nodeID);
+    return nullptr;
+    }
+  nodeCopy->CopyWithScene(node);
+
+  if (!nodeID.empty())
+    {
+    UndoNodeCopyInfo& copyInfo = this->UndoNodeCopies[nodeID];
+    copyInfo.Node = node;
+    copyInfo.NodeCopy = nodeCopy;
+    copyInfo.NodeMTime = nodeMTime;
+    }
+  return nodeCopy;
+}
+
+//------------------------------------------------------------------------------
+vtkSmartPointer<vtkMRMLNode> vtkMRMLScene::CreateNodeFromUndoCopy(vtkMRMLNode* nodeCopy)
+{
+  if (!nodeCopy)
+    {
+    return nullptr;
+    }
+  // The copy may be shared by several undo/redo states, it must never become
+  // a node of the scene, otherwise editing the node would change those states.
+  vtkSmartPointer<vtkMRMLNode> node = vtkSmartPointer<vtkMRMLNode>::Take(nodeCopy->CreateNodeInstance());
+  if (!node)
+    {
+    vtkErrorMacro("CreateNodeFromUndoCopy: failed to create node "
+      << (nodeCopy->GetID() ? nodeCopy->GetID() : "(undefined)"));
+    return nullptr;
+    }
+  node->CopyWithScene(nodeCopy);
+  return node;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLScene::GetUndoNodeCopiesMemorySize(vtkCollection* undoScene, std::set<vtkMRMLNode*>& countedNodes)
+{
+  vtkTypeInt64 size = 0;
+  int nnodes = undoScene->GetNumberOfItems();
+  for (int n = 0; n < nnodes; n++)
+    {
+    vtkMRMLNode *node = vtkMRMLNode::SafeDownCast(undoScene->GetItemAsObject(n));
+    if (!node || countedNodes.find(node) != countedNodes.end())
+      {
+      continue;
+      }
+    // Nodes of the scene are referenced (not copied) by the undo stack
+    if (node->GetID() && this->GetNodeByID(node->GetID()) == node)
+      {
+      continue;
+      }
+    countedNodes.insert(node);
+    size += GetNodeMemorySize(node);
+    }
+  return size;
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLScene::GetUndoStateMemorySize(int undoLevel)
+{
+  if (undoLevel < 0 || undoLevel >= static_cast<int>(this->UndoStack.size()))
+    {
+    vtkErrorMacro("GetUndoStateMemorySize: invalid undo level " << undoLevel);
+    return 0;
+    }
+  std::list< vtkCollection* >::iterator undoStateIt = this->UndoStack.begin();
+  std::advance(undoStateIt, undoLevel);
+  // Copies that are shared with the previous (older) state are not counted
+  std::set<vtkMRMLNode*> countedNodes;
+  if (undoStateIt != this->UndoStack.begin())
+    {
+    std::list< vtkCollection* >::iterator previousUndoStateIt = undoStateIt;
+    --previousUndoStateIt;
+    this->GetUndoNodeCopiesMemorySize(*previousUndoStateIt, countedNodes);
+    }
+  return this->GetUndoNodeCopiesMemorySize(*undoStateIt, countedNodes);
+}
+
+//------------------------------------------------------------------------------
+vtkTypeInt64 vtkMRMLScene::GetUndoMemorySize()
+{
+  vtkTypeInt64 size = 0;
+  std::set<vtkMRMLNode*> countedNodes;
+  for (std::list< vtkCollection* >::iterator undoStateIt = this->UndoStack.begin();
+    undoStateIt != this->UndoStack.end(); ++undoStateIt)
+    {
+    size += this->GetUndoNodeCopiesMemorySize(*undoStateIt, countedNodes);
+    }
+  return size;
 }
 
 //------------------------------------------------------------------------------
@@ -2816,8 +2999,13 @@ void vtkMRMLScene::Undo()
 
   for (nn=0; nn<addNodes.size(); nn++)
     {
-    this->AddNode(addNodes[nn]);
-    addNodes[nn]->SetSceneReferences();
+    vtkSmartPointer<vtkMRMLNode> restoredNode = this->CreateNodeFromUndoCopy(addNodes[nn]);
+    if (!restoredNode)
+      {
+      continue;
+      }
+    this->AddNode(restoredNode);
+    restoredNode->SetSceneReferences();
     }
   for (nn=0; nn<removeNodes.size(); nn++)
     {
@@ -2840,6 +3028,7 @@ void vtkMRMLScene::Undo()
    {
    this->UndoStack.pop_back();
    }
+  this->RemoveUnusedUndoNodeCopies();
   this->Modified();
 
   this->EndState(vtkMRMLScene::UndoState);
@@ -2953,7 +3142,11 @@ void vtkMRMLScene::Redo()
 
   for (nn=0; nn<addNodes.size(); nn++)
     {
-    this->AddNode(addNodes[nn]);
+    vtkSmartPointer<vtkMRMLNode> restoredNode = this->CreateNodeFromUndoCopy(addNodes[nn]);
+    if (restoredNode)
+      {
+      this->AddNode(restoredNode);
+      }
     }
   for (nn=0; nn<removeNodes.size(); nn++)
     {
@@ -2981,6 +3174,7 @@ void vtkMRMLScene::ClearUndoStack()
     (*iter)->Delete();
     }
   this->UndoStack.clear();
+  this->UndoNodeCopies.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -3320,6 +3514,95 @@ void vtkMRMLScene::ClearNodeIDs()
   }
 }
 
+//------------------------------------------------------------------------------
+const std::vector<vtkMRMLNode*>& vtkMRMLScene::GetNodesByClassCache(const char* className)
+{
+  this->UpdateNodesByClass();
+  std::map< std::string, std::vector<vtkMRMLNode*> >::iterator classIt =
+    this->NodesByClass.find(className);
+  if (classIt != this->NodesByClass.end())
+    {
+    return classIt->second;
+    }
+  // First time the class is queried, populate its list.
+  std::vector<vtkMRMLNode*>& classNodes = this->NodesByClass[className];
+  vtkMRMLNode *node;
+  vtkCollectionSimpleIterator it;
+  for (this->Nodes->InitTraversal(it);
+       (node = (vtkMRMLNode*)this->Nodes->GetNextItemAsObject(it)) ;)
+    {
+    if (node->IsA(className))
+      {
+      classNodes.push_back(node);
+      }
+    }
+  return classNodes;
+}
+
+//------------------------------------------------------------------------------
+void vtkMRMLScene::UpdateNodesByClass()
+{
+  if (this->Nodes->GetMTime() > this->NodesByClassMTime)
+    {
+#ifdef MRMLSCENE_VERBOSE
+    std::cerr << "Reset node class cache..." << std::endl;
+#endif
+    this->ClearNodesByClass();
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::AddNodeToNodesByClass(vtkMRMLNode *node)
+{
+  if (!this->Nodes || !node)
+    {
+    return;
+    }
+  for (std::map< std::string, std::vector<vtkMRMLNode*> >::iterator classIt = this->NodesByClass.begin();
+       classIt != this->NodesByClass.end(); ++classIt)
+    {
+    if (node->IsA(classIt->first.c_str()))
+      {
+      classIt->second.push_back(node);
+      }
+    }
+  this->NodesByClassMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::RemoveNodeFromNodesByClass(vtkMRMLNode *node)
+{
+  if (!this->Nodes || !node)
+    {
+    return;
+    }
+  for (std::map< std::string, std::vector<vtkMRMLNode*> >::iterator classIt = this->NodesByClass.begin();
+       classIt != this->NodesByClass.end(); ++classIt)
+    {
+    if (node->IsA(classIt->first.c_str()))
+      {
+      // a node is only listed once per class
+      std::vector<vtkMRMLNode*>& classNodes = classIt->second;
+      std::vector<vtkMRMLNode*>::iterator nodeIt = std::find(classNodes.begin(), classNodes.end(), node);
+      if (nodeIt != classNodes.end())
+        {
+        classNodes.erase(nodeIt);
+        }
+      }
+    }
+  this->NodesByClassMTime = this->Nodes->GetMTime();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::ClearNodesByClass()
+{
+  if (this->Nodes)
+    {
+    this->NodesByClass.clear();
+    this->NodesByClassMTime = this->Nodes->GetMTime();
+    }
+}
+
 //------------------------------------------------------------------------------
 void vtkMRMLScene::AddURIHandler(vtkURIHandler *handler)
 {
@@ -3687,15 +3970,93 @@ void vtkMRMLScene::SetMaximumNumberOfSavedUndoStates(int stackSize)
   this->Modified();
 }
 
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::SetMaximumUndoMemorySize(vtkTypeInt64 maximumSize)
+{
+  if (maximumSize == this->MaximumUndoMemorySize)
+    {
+    return;
+    }
+
+  if (maximumSize < 0)
+    {
+    vtkErrorMacro("Cannot set maximum undo memory size to be a value less than 0");
+    return;
+    }
+
+  this->MaximumUndoMemorySize = maximumSize;
+  this->TrimUndoStack();
+  this->Modified();
+}
+
 //-----------------------------------------------------------------------------
 void vtkMRMLScene::TrimUndoStack()
 {
   std::list<vtkSmartPointer<vtkCollection> > removedStacks;
   while(static_cast<int>(this->UndoStack.size()) > this->MaximumNumberOfSavedUndoStates)
     {
-    removedStacks.emplace_back(this->UndoStack.front());
+    removedStacks.push_back(vtkSmartPointer<vtkCollection>::Take(this->UndoStack.front()));
     this->UndoStack.pop_front();
     }
+  if (this->MaximumUndoMemorySize > 0 && this->UndoStack.size() > 1)
+    {
+    // Compute the memory size once. A node copy may be shared by several
+    // states, its memory is only released when the last state using it is removed.
+    vtkTypeInt64 undoMemorySize = 0;
+    std::map<vtkMRMLNode*, int> numberOfStatesByNodeCopy;
+    for (std::list< vtkCollection* >::iterator undoStateIt = this->UndoStack.begin();
+      undoStateIt != this->UndoStack.end(); ++undoStateIt)
+      {
+      std::set<vtkMRMLNode*> stateNodeCopies;
+      this->GetUndoNodeCopiesMemorySize(*undoStateIt, stateNodeCopies);
+      for (std::set<vtkMRMLNode*>::iterator nodeIt = stateNodeCopies.begin(); nodeIt != stateNodeCopies.end(); ++nodeIt)
+        {
+        if (numberOfStatesByNodeCopy[*nodeIt]++ == 0)
+          {
+          undoMemorySize += GetNodeMemorySize(*nodeIt);
+          }
+        }
+      }
+    // Always keep the most recent state
+    while (this->UndoStack.size() > 1 && undoMemorySize > this->MaximumUndoMemorySize)
+      {
+      std::set<vtkMRMLNode*> stateNodeCopies;
+      this->GetUndoNodeCopiesMemorySize(this->UndoStack.front(), stateNodeCopies);
+      for (std::set<vtkMRMLNode*>::iterator nodeIt = stateNodeCopies.begin(); nodeIt != stateNodeCopies.end(); ++nodeIt)
+        {
+        if (--numberOfStatesByNodeCopy[*nodeIt] == 0)
+          {
+          undoMemorySize -= GetNodeMemorySize(*nodeIt);
+          }
+        }
+      removedStacks.push_back(vtkSmartPointer<vtkCollection>::Take(this->UndoStack.front()));
+      this->UndoStack.pop_front();
+      }
+    }
+  if (removedStacks.empty())
+    {
+    return;
+    }
+  removedStacks.clear();
+  this->RemoveUnusedUndoNodeCopies();
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLScene::RemoveUnusedUndoNodeCopies()
+{
+  // Copies that are only referenced by UndoNodeCopies are not in the undo stack anymore
+  std::map< std::string, UndoNodeCopyInfo >::iterator copyIt = this->UndoNodeCopies.begin();
+  while (copyIt != this->UndoNodeCopies.end())
+    {
+    if (copyIt->second.NodeCopy->GetReferenceCount() <= 1)
+      {
+      this->UndoNodeCopies.erase(copyIt++);
+      }
+    else
+      {
+      ++copyIt;
+      }
+    }
 }
 
 //----------------------------------------------------------------------------
@@ -3747,7 +4108,10 @@ bool vtkMRMLScene::WriteToMRB(const char* filename, vtkImageData* thumbnail/*=nu
     }
 
   vtkDebugMacro("Zipping to " << mrbFilePath);
-  if (!vtkArchive::Zip(mrbFilePath.c_str(), bundleDir.c_str()))
+  // Bundle files are removed as soon as they are in the archive to avoid
+  // needing twice the size of the bundle on disk. Files that storage nodes
+  // already compressed (e.g., volumes) are stored, other files are deflated.
+  if (!vtkArchive::Zip(mrbFilePath.c_str(), bundleDir.c_str(), true, true))
     {
     vtkErrorMacro("Failed to save " << filename << ": Could not compress bundle");
     return false;
@@ -747,6 +747,28 @@ public:
   void SetMaximumNumberOfSavedUndoStates(int stackSize);
   vtkGetMacro(MaximumNumberOfSavedUndoStates, int);
 
+  /// \brief Sets the maximum memory size (in bytes) of the node copies saved in
+  /// the undo stack and removes the oldest saved states until the memory size is
+  /// below the new maximum. The most recent state is always kept.
+  /// 0 (default) means that the undo memory size is not limited.
+  /// \sa GetUndoMemorySize(), SetMaximumNumberOfSavedUndoStates()
+  void SetMaximumUndoMemorySize(vtkTypeInt64 maximumSize);
+  vtkGetMacro(MaximumUndoMemorySize, vtkTypeInt64);
+
+  /// \brief Returns the estimated memory size (in bytes) of the node copies
+  /// saved in the undo state \a undoLevel (0 is the oldest state).
+  ///
+  /// Node copies are shared between consecutive undo states when the node
+  /// has not been modified, shared copies are only counted in the oldest
+  /// state that contains them.
+  /// \sa GetUndoMemorySize(), GetNumberOfUndoLevels()
+  vtkTypeInt64 GetUndoStateMemorySize(int undoLevel);
+
+  /// Returns the estimated memory size (in bytes) of all the node copies saved
+  /// in the undo stack.
+  /// \sa GetUndoStateMemorySize(), SetMaximumUndoMemorySize()
+  vtkTypeInt64 GetUndoMemorySize();
+
   /// \brief Write the scene to a MRML scene bundle (.mrb) file.
   /// If thumbnail image is provided then it is saved in the scene's root folder.
   /// Returns false if the save failed
@@ -794,8 +816,26 @@ protected:
   ~vtkMRMLScene() override;
 
   void PushIntoUndoStack();
+  /// Push the current scene into the undo stack and store a copy of the
+  /// \a nodesToCopy nodes instead of the nodes themselves.
+  void PushIntoUndoStack(const std::set<vtkMRMLNode*>& nodesToCopy);
   void PushIntoRedoStack();
 
+  /// \brief Return a copy of \a node that can be stored in the undo stack.
+  ///
+  /// If the node has not been modified since the last time it was copied into
+  /// the undo stack, then the previous copy is returned, so that unchanged
+  /// node states are shared between undo states instead of being copied again.
+  vtkSmartPointer<vtkMRMLNode> GetNodeCopyForUndo(vtkMRMLNode* node);
+
+  /// Estimated memory size (in bytes) of the node copies of \a undoScene that
+  /// are not in \a countedNodes. Counted copies are added to \a countedNodes.
+  vtkTypeInt64 GetUndoNodeCopiesMemorySize(vtkCollection* undoScene, std::set<vtkMRMLNode*>& countedNodes);
+
+  /// Create a new node from a node copy of the undo or redo stack.
+  /// Used for restoring removed nodes, as copies may be shared between states.
+  vtkSmartPointer<vtkMRMLNode> CreateNodeFromUndoCopy(vtkMRMLNode* nodeCopy);
+
   void CopyNodeInUndoStack(vtkMRMLNode *node);
   void CopyNodeInRedoStack(vtkMRMLNode *node);
 
@@ -843,12 +883,42 @@ protected:
   /// Clear NodeIDs map used to speedup GetByID() method.
   void ClearNodeIDs();
 
+  /// \brief Return the list of nodes that are of class \a className (or
+  /// any subclass) in the same order as in the \a Nodes collection.
+  ///
+  /// The list is computed the first time a class is queried and is then kept
+  /// up-to-date by AddNodeNoNotify() and RemoveNode(), therefore
+  /// GetNodesByClass(), GetNumberOfNodesByClass() and GetNthNodeByClass()
+  /// cost the size of the result instead of the size of the scene.
+  /// \sa NodesByClass
+  const std::vector<vtkMRMLNode*>& GetNodesByClassCache(const char* className);
+
+  /// \brief Synchronize NodesByClass map with the \a Nodes collection.
+  ///
+  /// The map is cleared if the collection has been modified without the map
+  /// being updated (e.g. when nodes are directly added to the collection).
+  void UpdateNodesByClass();
+
+  /// Add node to the \a NodesByClass lists that the node is a class of.
+  /// The node is expected to be the last item of the \a Nodes collection.
+  void AddNodeToNodesByClass(vtkMRMLNode *node);
+
+  /// Remove node from all the \a NodesByClass lists.
+  void RemoveNodeFromNodesByClass(vtkMRMLNode *node);
+
+  /// Clear NodesByClass map used to speedup GetNodesByClass() methods.
+  void ClearNodesByClass();
+
   /// Get a NodeReferences iterator for a node reference.
   NodeReferencesType::iterator FindNodeReference(const char* referencedId, vtkMRMLNode* referencingNode);
 
   /// Clean up elements of the undo/redo stack beyond the maximum size
+  /// and beyond the maximum memory size
   void TrimUndoStack();
 
+  /// Remove node copies from \a UndoNodeCopies that are not in the undo stack anymore
+  void RemoveUnusedUndoNodeCopies();
+
   /// Reserve all node reference ids for a node
   void ReserveNodeReferenceIDs(vtkMRMLNode* node);
 
@@ -882,6 +952,18 @@ protected:
   std::list< vtkCollection* >  UndoStack;
   std::list< vtkCollection* >  RedoStack;
 
+  /// Latest copy of a node that has been saved in the undo stack
+  struct UndoNodeCopyInfo
+    {
+    vtkWeakPointer<vtkMRMLNode> Node;
+    vtkSmartPointer<vtkMRMLNode> NodeCopy;
+    vtkMTimeType NodeMTime;
+    };
+  /// Latest copies saved in the undo stack (by node ID), used to share
+  /// unchanged node states between undo states.
+  std::map< std::string, UndoNodeCopyInfo > UndoNodeCopies;
+  vtkTypeInt64 MaximumUndoMemorySize;
+
   std::string                 URL;
   std::string                 RootDirectory;
 
@@ -895,6 +977,8 @@ protected:
   NodeReferencesType NodeReferences; // ReferencedIDs (string), ReferencingNodes (node pointer)
   std::map< std::string, std::string > ReferencedIDChanges;
   std::map< std::string, vtkSmartPointer<vtkMRMLNode> > NodeIDs;
+  /// Nodes of a queried class name (including subclasses), in scene order.
+  std::map< std::string, std::vector<vtkMRMLNode*> > NodesByClass;
 
   // Stores default nodes. If a class is created or reset (using CreateNodeByClass or Clear) and
   // a default node is defined for it then the content of the default node will be used to initialize
@@ -912,6 +996,7 @@ protected:
   int ReadDataOnLoad;
 
   vtkMTimeType  NodeIDsMTime;
+  vtkMTimeType  NodesByClassMTime;
 
   void RemoveAllNodes(bool removeSingletons);
 
@@ -98,6 +98,16 @@ vtkMRMLSegmentationStorageNode::vtkMRMLSegmentationStorageNode() = default;
 //----------------------------------------------------------------------------
 vtkMRMLSegmentationStorageNode::~vtkMRMLSegmentationStorageNode() = default;
 
+//----------------------------------------------------------------------------
+namespace
+{
+bool IsMasterRepresentationBrickedLabelmap(vtkSegmentation* segmentation)
+{
+  return segmentation && segmentation->GetMasterRepresentationName()
+    == vtkSegmentationConverter::GetSegmentationBrickedLabelmapRepresentationName();
+}
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSegmentationStorageNode::PrintSelf(ostream& os, vtkIndent indent)
 {
@@ -160,7 +170,8 @@ void vtkMRMLSegmentationStorageNode::InitializeSupportedWriteFileTypes()
   if (segmentationNode)
     {
     // restrict write file types to those that are suitable for current master representation
-    masterIsImage = segmentationNode->GetSegmentation()->IsMasterRepresentationImageData();
+    masterIsImage = segmentationNode->GetSegmentation()->IsMasterRepresentationImageData()
+      || IsMasterRepresentationBrickedLabelmap(segmentationNode->GetSegmentation());
     masterIsPolyData = segmentationNode->GetSegmentation()->IsMasterRepresentationPolyData();
     if (!masterIsImage && !masterIsPolyData)
       {
@@ -215,7 +226,8 @@ const char* vtkMRMLSegmentationStorageNode::GetDefaultWriteFileExtension()
     {
     return nullptr;
     }
-  if (segmentationNode->GetSegmentation()->IsMasterRepresentationImageData())
+  if (segmentationNode->GetSegmentation()->IsMasterRepresentationImageData()
+    || IsMasterRepresentationBrickedLabelmap(segmentationNode->GetSegmentation()))
     {
     return "seg.nrrd";
     }
@@ -529,6 +541,7 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
   int numberOfSegments = 0;
   std::map<int, std::vector<int> > segmentIndexInLayer;
   std::string containedRepresentationNames;
+  std::string masterRepresentationName;
   vtkMatrix4x4* rasToFileIjk = nullptr;
   int imageExtentInFile[6] = { 0, -1, 0, -1, 0, -1 };
   int commonGeometryExtent[6] = { 0, -1, 0, -1, 0, -1 };
@@ -595,6 +608,9 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
     // Read contained representation names
     this->GetSegmentationMetaDataFromDicitionary(containedRepresentationNames, dictionary, KEY_SEGMENTATION_CONTAINED_REPRESENTATION_NAMES);
 
+    // Read master representation name, bricked labelmaps are stored as binary labelmaps
+    this->GetSegmentationMetaDataFromDicitionary(masterRepresentationName, dictionary, KEY_SEGMENTATION_MASTER_REPRESENTATION);
+
     // Read contained segment layer numbers
     while (dictionary.HasKey(GetSegmentMetaDataKey(numberOfSegments, KEY_SEGMENT_ID)))
       {
@@ -861,6 +877,13 @@ int vtkMRMLSegmentationStorageNode::ReadBinaryLabelmapRepresentation(vtkMRMLSegm
     segmentation->AddSegment(currentSegment, currentSegmentID);
     }
 
+  // Restore bricked labelmap master representation from the binary labelmaps
+  if (masterRepresentationName == vtkSegmentationConverter::GetSegmentationBrickedLabelmapRepresentationName()
+    && segmentation->CreateRepresentation(masterRepresentationName))
+    {
+    segmentation->SetMasterRepresentationName(masterRepresentationName);
+    }
+
   // Create contained representations now that all the data is loaded
   this->CreateRepresentationsBySerializedNames(segmentation, containedRepresentationNames);
 
@@ -1065,7 +1088,8 @@ int vtkMRMLSegmentationStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     }
 
   // Write only master representation
-  if (segmentationNode->GetSegmentation()->IsMasterRepresentationImageData())
+  if (segmentationNode->GetSegmentation()->IsMasterRepresentationImageData()
+    || IsMasterRepresentationBrickedLabelmap(segmentationNode->GetSegmentation()))
     {
     return this->WriteBinaryLabelmapRepresentation(segmentationNode, fullName);
     }
@@ -1088,10 +1112,24 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
     return 0;
     }
   vtkSegmentation* segmentation = segmentationNode->GetSegmentation();
-  segmentation->CollapseBinaryLabelmaps(false);
 
   // Get and check master representation
-  if (!segmentationNode->GetSegmentation()->IsMasterRepresentationImageData())
+  std::string labelmapRepresentationName = segmentation->GetMasterRepresentationName();
+  if (IsMasterRepresentationBrickedLabelmap(segmentation))
+    {
+    // Bricked labelmaps are written as dense image data, using the binary labelmap derived from them
+    labelmapRepresentationName = vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName();
+    if (!segmentation->CreateRepresentation(labelmapRepresentationName))
+      {
+      vtkErrorMacro("WriteBinaryLabelmapRepresentation: Failed to convert bricked labelmap master representation to binary labelmap");
+      return 0;
+      }
+    }
+  else if (segmentation->IsMasterRepresentationImageData())
+    {
+    segmentation->CollapseBinaryLabelmaps(false);
+    }
+  else
     {
     vtkErrorMacro("WriteBinaryLabelmapRepresentation: Invalid master representation to write as image data");
     return 0;
@@ -1106,7 +1144,7 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
     std::string currentSegmentID = *segmentIdIt;
     vtkSegment* currentSegment = segmentation->GetSegment(*segmentIdIt);
     vtkSmartPointer<vtkOrientedImageData> currentBinaryLabelmap = vtkOrientedImageData::SafeDownCast(
-      currentSegment->GetRepresentation(segmentationNode->GetSegmentation()->GetMasterRepresentationName()));
+      currentSegment->GetRepresentation(labelmapRepresentationName));
     if (currentBinaryLabelmap->GetScalarSize() > scalarSize)
       {
       scalarSize = currentBinaryLabelmap->GetScalarSize();
@@ -1193,7 +1231,7 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
 
     // Get master representation from segment
     vtkSmartPointer<vtkOrientedImageData> currentBinaryLabelmap = vtkOrientedImageData::SafeDownCast(
-      currentSegment->GetRepresentation(segmentationNode->GetSegmentation()->GetMasterRepresentationName()));
+      currentSegment->GetRepresentation(labelmapRepresentationName));
     if (!currentBinaryLabelmap)
       {
       vtkErrorMacro("WriteBinaryLabelmapRepresentation: Failed to retrieve master representation from segment " << currentSegmentID);
@@ -1266,7 +1304,7 @@ int vtkMRMLSegmentationStorageNode::WriteBinaryLabelmapRepresentation(vtkMRMLSeg
     labelValueSS << currentSegment->GetLabelValue();
     writer->SetAttribute(GetSegmentMetaDataKey(segmentIndex, KEY_SEGMENT_LABEL_VALUE).c_str(), labelValueSS.str());
 
-    vtkDataObject* originalRepresentation = currentSegment->GetRepresentation(segmentationNode->GetSegmentation()->GetMasterRepresentationName());
+    vtkDataObject* originalRepresentation = currentSegment->GetRepresentation(labelmapRepresentationName);
     if (labelmapLayers.find(originalRepresentation) == labelmapLayers.end())
       {
       labelmapLayers[originalRepresentation] = layerIndex;
@@ -20,20 +20,24 @@
 #include "vtkMRMLSequenceNode.h"
 #include "vtkMRMLSequenceStorageNode.h"
 #include "vtkMRMLStorableNode.h"
+#include "vtkMRMLVolumeSequenceFrameReader.h"
 #include "vtkMRMLVolumeSequenceStorageNode.h"
 
 // MRML includes
 #include <vtkMRMLScene.h>
+#include <vtkMRMLVolumeNode.h>
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkCollection.h>
+#include <vtkImageData.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 #include <vtkTimerLog.h>
 
 // STD includes
+#include <algorithm>
 #include <sstream>
 
 #define SAFE_CHAR_POINTER(unsafeString) ( unsafeString==nullptr?"":unsafeString )
@@ -81,6 +85,9 @@ vtkMRMLSequenceNode::~vtkMRMLSequenceNode()
 void vtkMRMLSequenceNode::RemoveAllDataNodes()
 {
   this->IndexEntries.clear();
+  this->PagedDataNodeFrameIndices.clear();
+  this->LoadedPagedDataNodes.clear();
+  this->FrameReader = nullptr;
   if (!this->SequenceScene)
     {
     return;
@@ -204,7 +211,7 @@ void vtkMRMLSequenceNode::ReadIndexValues(const std::string& indexText)
       std::string indexValue = nodeId_indexValue.substr(indexValueSeparatorPos+1, nodeId_indexValue.size()-indexValueSeparatorPos-1);
 
       IndexEntryType indexEntry;
-      indexEntry.IndexValue=indexValue;
+      indexEntry.SetIndexValue(indexValue);
       // The nodes are not read yet, so we can only store the node ID and get the pointer to the node later (in UpdateScene())
       indexEntry.DataNodeID=nodeId;
       indexEntry.DataNode=nullptr;
@@ -264,7 +271,7 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
   for(std::deque< IndexEntryType >::iterator sourceIndexIt=snode->IndexEntries.begin(); sourceIndexIt!=snode->IndexEntries.end(); ++sourceIndexIt)
     {
     IndexEntryType seqItem;
-    seqItem.IndexValue=sourceIndexIt->IndexValue;
+    seqItem.SetIndexValue(sourceIndexIt->IndexValue);
     seqItem.DataNode = nullptr;
     if (sourceIndexIt->DataNode!=nullptr)
       {
@@ -282,6 +289,30 @@ void vtkMRMLSequenceNode::Copy(vtkMRMLNode *anode)
       }
     this->IndexEntries.push_back(seqItem);
     }
+
+  // Paged data nodes of the copy read their voxels from the same frame reader
+  this->PagedDataNodeFrameIndices.clear();
+  this->LoadedPagedDataNodes.clear();
+  this->FrameReader = snode->FrameReader;
+  this->PagedDataNodeCacheSize = snode->PagedDataNodeCacheSize;
+  for (std::map< vtkMRMLNode*, int >::iterator pagedIt = snode->PagedDataNodeFrameIndices.begin();
+    pagedIt != snode->PagedDataNodeFrameIndices.end(); ++pagedIt)
+    {
+    vtkMRMLNode* copiedDataNode = this->SequenceScene->GetNodeByID(pagedIt->first->GetID());
+    if (copiedDataNode)
+      {
+      this->PagedDataNodeFrameIndices[copiedDataNode] = pagedIt->second;
+      }
+    }
+  for (vtkMRMLNode* loadedDataNode : snode->LoadedPagedDataNodes)
+    {
+    vtkMRMLNode* copiedDataNode = this->SequenceScene->GetNodeByID(loadedDataNode->GetID());
+    if (copiedDataNode)
+      {
+      this->LoadedPagedDataNodes.push_back(copiedDataNode);
+      }
+    }
+
   this->Modified();
   this->StorableModifiedTime.Modified();
 
@@ -303,7 +334,7 @@ void vtkMRMLSequenceNode::CopySequenceIndex(vtkMRMLNode *anode)
     for (std::deque< IndexEntryType >::iterator sourceIndexIt = snode->IndexEntries.begin(); sourceIndexIt != snode->IndexEntries.end(); ++sourceIndexIt)
       {
       IndexEntryType seqItem;
-      seqItem.IndexValue = sourceIndexIt->IndexValue;
+      seqItem.SetIndexValue(sourceIndexIt->IndexValue);
       if (sourceIndexIt->DataNode != nullptr)
         {
         seqItem.DataNodeID = sourceIndexIt->DataNode->GetID();
@@ -331,6 +362,9 @@ void vtkMRMLSequenceNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "indexType: " << indexTypeString << "\n";
 
   os << indent << "numericIndexValueTolerance: " << this->NumericIndexValueTolerance << "\n";
+  os << indent << "pagedDataNodes: " << this->PagedDataNodeFrameIndices.size()
+    << " (" << this->LoadedPagedDataNodes.size() << " loaded)\n";
+  os << indent << "pagedDataNodeCacheSize: " << this->PagedDataNodeCacheSize << "\n";
 
   os << indent << "indexValues: ";
   if (this->IndexEntries.empty())
@@ -363,6 +397,8 @@ bool vtkMRMLSequenceNode::UpdateDataNodeAtValue(vtkMRMLNode* node, const std::st
     vtkDebugMacro("vtkMRMLSequenceNode::UpdateDataNodeAtValue failed, indexValue not found");
     return false;
     }
+  // Voxels of the updated node must not be released or read from the file anymore
+  this->RemovePagedDataNode(nodeToBeUpdated);
   nodeToBeUpdated->CopyContent(node, !shallowCopy);
   this->Modified();
   this->StorableModifiedTime.Modified();
@@ -377,7 +413,7 @@ int vtkMRMLSequenceNode::GetInsertPosition(const std::string& indexValue)
     {
     int itemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
     double numericIndexValue = atof(indexValue.c_str());
-    double foundNumericIndexValue = atof(this->IndexEntries[itemNumber].IndexValue.c_str());
+    double foundNumericIndexValue = this->IndexEntries[itemNumber].NumericIndexValue;
     if (numericIndexValue < foundNumericIndexValue) // Deals with case of index value being smaller than any in the sequence and numeric tolerances
       {
       insertPosition = itemNumber;
@@ -398,24 +434,88 @@ vtkMRMLNode* vtkMRMLSequenceNode::SetDataNodeAtValue(vtkMRMLNode* node, const st
     vtkErrorMacro("vtkMRMLSequenceNode::SetDataNodeAtValue failed, invalid node");
     return nullptr;
     }
+  vtkMRMLNode* newNode = this->AddDataNodeCopy(node, indexValue);
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+  return newNode;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::SetDataNodesAtValues(vtkCollection* nodes, const std::vector<std::string>& indexValues)
+{
+  if (nodes == nullptr || nodes->GetNumberOfItems() != static_cast<int>(indexValues.size()))
+    {
+    vtkErrorMacro("vtkMRMLSequenceNode::SetDataNodesAtValues failed, number of nodes and index values must be the same");
+    return false;
+    }
+  for (int nodeIndex = 0; nodeIndex < nodes->GetNumberOfItems(); ++nodeIndex)
+    {
+    if (vtkMRMLNode::SafeDownCast(nodes->GetItemAsObject(nodeIndex)) == nullptr)
+      {
+      vtkErrorMacro("vtkMRMLSequenceNode::SetDataNodesAtValues failed, invalid node at position " << nodeIndex);
+      return false;
+      }
+    }
+  if (indexValues.empty())
+    {
+    return true;
+    }
+  for (int nodeIndex = 0; nodeIndex < nodes->GetNumberOfItems(); ++nodeIndex)
+    {
+    this->AddDataNodeCopy(vtkMRMLNode::SafeDownCast(nodes->GetItemAsObject(nodeIndex)), indexValues[nodeIndex]);
+    }
+  this->Modified();
+  this->StorableModifiedTime.Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::AddDataNodeCopy(vtkMRMLNode* node, const std::string& indexValue)
+{
   // Make sure the sequence scene is created
   this->GetSequenceScene();
   // Add a copy of the node to the sequence's scene
   vtkMRMLNode* newNode = this->DeepCopyNodeToScene(node, this->SequenceScene);
-  int seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
+  int seqItemIndex = -1;
+  int insertPosition = static_cast<int>(this->IndexEntries.size());
+  if (this->IndexType == vtkMRMLSequenceNode::NumericIndex && !this->IndexEntries.empty())
+    {
+    // A single binary search gives both the matching item and the insert position.
+    // Values larger than the last index value (typical when recording) are found without search.
+    double numericIndexValue = atof(indexValue.c_str());
+    int closestItemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
+    double closestNumericIndexValue = this->IndexEntries[closestItemNumber].NumericIndexValue;
+    if (fabs(numericIndexValue - closestNumericIndexValue) <= this->NumericIndexValueTolerance)
+      {
+      seqItemIndex = closestItemNumber;
+      }
+    else if (numericIndexValue < closestNumericIndexValue)
+      {
+      insertPosition = closestItemNumber;
+      }
+    else
+      {
+      insertPosition = closestItemNumber + 1;
+      }
+    }
+  else
+    {
+    seqItemIndex = this->GetItemNumberFromIndexValue(indexValue);
+    }
   if (seqItemIndex<0)
     {
-    // The sequence item doesn't exist yet
-    seqItemIndex = GetInsertPosition(indexValue);
-    // Create new item
+    // The sequence item doesn't exist yet, create new item
+    seqItemIndex = insertPosition;
     IndexEntryType seqItem;
-    seqItem.IndexValue = indexValue;
+    seqItem.SetIndexValue(indexValue);
     this->IndexEntries.insert(this->IndexEntries.begin() + seqItemIndex, seqItem);
     }
+  else
+    {
+    this->RemovePagedDataNode(this->IndexEntries[seqItemIndex].DataNode);
+    }
   this->IndexEntries[seqItemIndex].DataNode = newNode;
   this->IndexEntries[seqItemIndex].DataNodeID.clear();
-  this->Modified();
-  this->StorableModifiedTime.Modified();
   return newNode;
 }
 
@@ -434,6 +534,7 @@ void vtkMRMLSequenceNode::RemoveDataNodeAtValue(const std::string& indexValue)
     return;
     }
   // TODO: remove associated nodes as well (such as storage node)?
+  this->RemovePagedDataNode(this->IndexEntries[seqItemIndex].DataNode);
   this->SequenceScene->RemoveNode(this->IndexEntries[seqItemIndex].DataNode);
   this->IndexEntries.erase(this->IndexEntries.begin()+seqItemIndex);
   this->Modified();
@@ -457,8 +558,8 @@ int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
 
     // Deal with index values not within the range of index values in the Sequence
     double numericIndexValue = atof(indexValue.c_str());
-    double lowerNumericIndexValue = atof(this->IndexEntries[lowerBound].IndexValue.c_str());
-    double upperNumericIndexValue = atof(this->IndexEntries[upperBound].IndexValue.c_str());
+    double lowerNumericIndexValue = this->IndexEntries[lowerBound].NumericIndexValue;
+    double upperNumericIndexValue = this->IndexEntries[upperBound].NumericIndexValue;
     if (numericIndexValue <= lowerNumericIndexValue + this->NumericIndexValueTolerance)
       {
       if (numericIndexValue < lowerNumericIndexValue - this->NumericIndexValueTolerance && exactMatchRequired)
@@ -486,7 +587,7 @@ int vtkMRMLSequenceNode::GetItemNumberFromIndexValue(const std::string& indexVal
       {
       // Note that if middle is equal to either lowerBound or upperBound then upperBound - lowerBound <= 1
       int middle = int((lowerBound + upperBound)/2);
-      double middleNumericIndexValue = atof(this->IndexEntries[middle].IndexValue.c_str());
+      double middleNumericIndexValue = this->IndexEntries[middle].NumericIndexValue;
       if (fabs(numericIndexValue - middleNumericIndexValue) <= this->NumericIndexValueTolerance)
         {
         return middle;
@@ -532,6 +633,7 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetDataNodeAtValue(const std::string& indexVal
     // not found
     return nullptr;
     }
+  this->LoadPagedDataNode(this->IndexEntries[seqItemIndex].DataNode);
   return this->IndexEntries[seqItemIndex].DataNode;
 }
 
@@ -572,7 +674,7 @@ bool vtkMRMLSequenceNode::UpdateIndexValue(const std::string& oldIndexValue, con
     return false;
     }
   // Update the index value
-  this->IndexEntries[oldSeqItemIndex].IndexValue = newIndexValue;
+  this->IndexEntries[oldSeqItemIndex].SetIndexValue(newIndexValue);
   if (this->IndexType == vtkMRMLSequenceNode::NumericIndex)
     {
     IndexEntryType movingEntry = this->IndexEntries[oldSeqItemIndex];
@@ -636,9 +738,187 @@ vtkMRMLNode* vtkMRMLSequenceNode::GetNthDataNode(int itemNumber)
     vtkErrorMacro("vtkMRMLSequenceNode::GetNthDataNode failed: itemNumber "<<itemNumber<<" is out of range");
     return nullptr;
     }
+  this->LoadPagedDataNode(this->IndexEntries[itemNumber].DataNode);
   return this->IndexEntries[itemNumber].DataNode;
 }
 
+//-----------------------------------------------------------------------------
+vtkMRMLNode* vtkMRMLSequenceNode::SetPagedDataNodeAtValue(vtkMRMLVolumeNode* node, const std::string& indexValue, int frameIndex)
+{
+  if (node == nullptr)
+    {
+    vtkErrorMacro("vtkMRMLSequenceNode::SetPagedDataNodeAtValue failed, invalid node");
+    return nullptr;
+    }
+  vtkMRMLVolumeNode* newNode = vtkMRMLVolumeNode::SafeDownCast(this->SetDataNodeAtValue(node, indexValue));
+  if (!newNode)
+    {
+    return nullptr;
+    }
+  // Voxels are read when the data node is requested
+  newNode->SetAndObserveImageData(nullptr);
+  this->PagedDataNodeFrameIndices[newNode] = frameIndex;
+  return newNode;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::SetFrameReader(vtkMRMLVolumeSequenceFrameReader* frameReader)
+{
+  if (this->FrameReader == frameReader)
+    {
+    return;
+    }
+  this->FrameReader = frameReader;
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+vtkMRMLVolumeSequenceFrameReader* vtkMRMLSequenceNode::GetFrameReader()
+{
+  return this->FrameReader;
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::SetSequenceFileFrameReader(vtkMRMLVolumeSequenceFrameReader* frameReader)
+{
+  if (!frameReader)
+    {
+    // Keep the voxels of all data nodes in memory
+    for (std::map< vtkMRMLNode*, int >::iterator pagedIt = this->PagedDataNodeFrameIndices.begin();
+      pagedIt != this->PagedDataNodeFrameIndices.end(); ++pagedIt)
+      {
+      vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(pagedIt->first);
+      if (!volumeNode || std::find(this->LoadedPagedDataNodes.begin(), this->LoadedPagedDataNodes.end(),
+        pagedIt->first) != this->LoadedPagedDataNodes.end())
+        {
+        continue;
+        }
+      vtkNew<vtkImageData> frameVoxels;
+      if (!this->FrameReader || !this->FrameReader->ReadFrame(pagedIt->second, frameVoxels.GetPointer()))
+        {
+        vtkErrorMacro("vtkMRMLSequenceNode::SetSequenceFileFrameReader failed: cannot read frame " << pagedIt->second);
+        continue;
+        }
+      volumeNode->SetAndObserveImageData(frameVoxels.GetPointer());
+      }
+    this->PagedDataNodeFrameIndices.clear();
+    this->LoadedPagedDataNodes.clear();
+    this->SetFrameReader(nullptr);
+    return;
+    }
+  for (int itemNumber = 0; itemNumber < static_cast<int>(this->IndexEntries.size()); ++itemNumber)
+    {
+    std::map< vtkMRMLNode*, int >::iterator pagedIt = this->PagedDataNodeFrameIndices.find(this->IndexEntries[itemNumber].DataNode);
+    if (pagedIt != this->PagedDataNodeFrameIndices.end())
+      {
+      pagedIt->second = itemNumber;
+      }
+    }
+  this->SetFrameReader(frameReader);
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::IsNthDataNodePaged(int itemNumber)
+{
+  if (itemNumber < 0 || itemNumber >= static_cast<int>(this->IndexEntries.size()))
+    {
+    return false;
+    }
+  return this->PagedDataNodeFrameIndices.find(this->IndexEntries[itemNumber].DataNode) != this->PagedDataNodeFrameIndices.end();
+}
+
+//-----------------------------------------------------------------------------
+bool vtkMRMLSequenceNode::IsNthDataNodeLoaded(int itemNumber)
+{
+  if (!this->IsNthDataNodePaged(itemNumber))
+    {
+    return true;
+    }
+  return std::find(this->LoadedPagedDataNodes.begin(), this->LoadedPagedDataNodes.end(),
+    this->IndexEntries[itemNumber].DataNode) != this->LoadedPagedDataNodes.end();
+}
+
+//-----------------------------------------------------------------------------
+int vtkMRMLSequenceNode::GetNumberOfLoadedPagedDataNodes()
+{
+  return static_cast<int>(this->LoadedPagedDataNodes.size());
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::PrefetchDataNodesAtValues(const std::vector<std::string>& indexValues)
+{
+  if (!this->FrameReader || this->PagedDataNodeFrameIndices.empty())
+    {
+    return;
+    }
+  std::vector<int> frameIndices;
+  for (const std::string& indexValue : indexValues)
+    {
+    int itemNumber = this->GetItemNumberFromIndexValue(indexValue, false);
+    if (itemNumber < 0 || this->IsNthDataNodeLoaded(itemNumber))
+      {
+      continue;
+      }
+    frameIndices.push_back(this->PagedDataNodeFrameIndices[this->IndexEntries[itemNumber].DataNode]);
+    }
+  this->FrameReader->Prefetch(frameIndices);
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::LoadPagedDataNode(vtkMRMLNode* dataNode)
+{
+  std::map< vtkMRMLNode*, int >::iterator pagedIt = this->PagedDataNodeFrameIndices.find(dataNode);
+  if (pagedIt == this->PagedDataNodeFrameIndices.end())
+    {
+    // voxels are always loaded
+    return;
+    }
+  std::list< vtkMRMLNode* >::iterator loadedIt = std::find(this->LoadedPagedDataNodes.begin(), this->LoadedPagedDataNodes.end(), dataNode);
+  if (loadedIt != this->LoadedPagedDataNodes.end())
+    {
+    // already loaded, mark as most recently used
+    this->LoadedPagedDataNodes.splice(this->LoadedPagedDataNodes.begin(), this->LoadedPagedDataNodes, loadedIt);
+    return;
+    }
+  vtkMRMLVolumeNode* volumeNode = vtkMRMLVolumeNode::SafeDownCast(dataNode);
+  if (!volumeNode || !this->FrameReader)
+    {
+    vtkErrorMacro("vtkMRMLSequenceNode::LoadPagedDataNode failed: frame reader is not set");
+    return;
+    }
+  vtkNew<vtkImageData> frameVoxels;
+  if (!this->FrameReader->ReadFrame(pagedIt->second, frameVoxels.GetPointer()))
+    {
+    vtkErrorMacro("vtkMRMLSequenceNode::LoadPagedDataNode failed: cannot read frame " << pagedIt->second);
+    return;
+    }
+  volumeNode->SetAndObserveImageData(frameVoxels.GetPointer());
+  this->LoadedPagedDataNodes.push_front(dataNode);
+
+  // Release voxels of the least recently used data nodes
+  int cacheSize = std::max(1, this->PagedDataNodeCacheSize);
+  while (static_cast<int>(this->LoadedPagedDataNodes.size()) > cacheSize)
+    {
+    vtkMRMLVolumeNode* releasedVolumeNode = vtkMRMLVolumeNode::SafeDownCast(this->LoadedPagedDataNodes.back());
+    this->LoadedPagedDataNodes.pop_back();
+    if (releasedVolumeNode)
+      {
+      releasedVolumeNode->SetAndObserveImageData(nullptr);
+      }
+    }
+}
+
+//-----------------------------------------------------------------------------
+void vtkMRMLSequenceNode::RemovePagedDataNode(vtkMRMLNode* dataNode)
+{
+  if (!dataNode)
+    {
+    return;
+    }
+  this->PagedDataNodeFrameIndices.erase(dataNode);
+  this->LoadedPagedDataNodes.remove(dataNode);
+}
+
 //-----------------------------------------------------------------------------
 vtkMRMLScene* vtkMRMLSequenceNode::GetSequenceScene(bool autoCreate/*=true*/)
 {
@@ -22,10 +22,20 @@
 #include <vtkMRML.h>
 #include <vtkMRMLStorableNode.h>
 
+// VTK includes
+#include <vtkSmartPointer.h>
+
 // std includes
+#include <cstdlib>
 #include <deque>
+#include <list>
+#include <map>
 #include <set>
 
+class vtkCollection;
+class vtkMRMLVolumeNode;
+class vtkMRMLVolumeSequenceFrameReader;
+
 
 /// \brief MRML node for representing a sequence of MRML nodes
 ///
@@ -103,6 +113,55 @@ public:
   /// Returns the data node copy that has just been created.
   vtkMRMLNode* SetDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue);
 
+  /// Add copies of the provided nodes to this sequence as data nodes, at the corresponding index values.
+  /// Same as calling SetDataNodeAtValue for each node but the node is modified only once.
+  /// Adding nodes in increasing order of numeric index values (for example, when recording) is
+  /// the fastest, as no search is needed to find the position of the new items.
+  /// Returns false if the number of nodes and index values does not match or a node is invalid.
+  bool SetDataNodesAtValues(vtkCollection* nodes, const std::vector<std::string>& indexValues);
+
+  /// Add a copy of the provided volume node to this sequence as a data node, without image data.
+  /// \a node is expected to have no image data, its voxels are not kept in the sequence.
+  /// Voxels are read from frame \a frameIndex of the frame reader when the data node is requested
+  /// by GetNthDataNode() or GetDataNodeAtValue() and they are released when more than
+  /// PagedDataNodeCacheSize paged data nodes are loaded.
+  /// The data node is not paged anymore when it is updated by UpdateDataNodeAtValue().
+  /// Returns the data node copy that has just been created.
+  /// \sa SetFrameReader()
+  vtkMRMLNode* SetPagedDataNodeAtValue(vtkMRMLVolumeNode* node, const std::string& indexValue, int frameIndex);
+
+  /// Reader of the voxels of paged data nodes
+  void SetFrameReader(vtkMRMLVolumeSequenceFrameReader* frameReader);
+  vtkMRMLVolumeSequenceFrameReader* GetFrameReader();
+
+  /// Read the voxels of paged data nodes from a volume sequence file that stores the
+  /// data nodes in the order of the items, for example after the sequence is written to file.
+  /// The frame index of each paged data node is set to its item number.
+  /// If \a frameReader is nullptr then the voxels of all paged data nodes are loaded
+  /// from the current frame reader and the data nodes are not paged anymore.
+  void SetSequenceFileFrameReader(vtkMRMLVolumeSequenceFrameReader* frameReader);
+
+  /// Maximum number of paged data nodes that have their voxels loaded.
+  /// The voxels of the least recently requested data nodes are released first.
+  /// Default is 16.
+  vtkSetMacro(PagedDataNodeCacheSize, int);
+  vtkGetMacro(PagedDataNodeCacheSize, int);
+
+  /// Return true if the voxels of the n-th data node are read on demand
+  bool IsNthDataNodePaged(int itemNumber);
+
+  /// Return true if the n-th data node is not paged or if its voxels are loaded
+  bool IsNthDataNodeLoaded(int itemNumber);
+
+  /// Return the number of paged data nodes that have their voxels loaded
+  int GetNumberOfLoadedPagedDataNodes();
+
+  /// Start reading the voxels of paged data nodes in background threads, so that they are
+  /// available without delay when they are requested. Closest match is used for each index value.
+  /// Index values of data nodes that are not paged or already loaded are ignored.
+  /// Previous prefetch requests that are not started yet are discarded.
+  void PrefetchDataNodesAtValues(const std::vector<std::string>& indexValues);
+
   /// Update an existing data node.
   /// Return true if a data node was found by that index.
   bool UpdateDataNodeAtValue(vtkMRMLNode* node, const std::string& indexValue, bool shallowCopy = false);
@@ -175,14 +234,32 @@ protected:
   /// If numeric index then insert it by respecting sorting order, otherwise insert to the end.
   int GetInsertPosition(const std::string& indexValue);
 
+  /// Add the node to the internal scene and to the index, without invoking any event.
+  vtkMRMLNode* AddDataNodeCopy(vtkMRMLNode* node, const std::string& indexValue);
+
   void ReadIndexValues(const std::string& indexText);
 
   vtkMRMLNode* DeepCopyNodeToScene(vtkMRMLNode* source, vtkMRMLScene* scene);
 
+  /// Read the voxels of a paged data node if they are not loaded yet
+  /// and release the voxels of the least recently used data nodes.
+  void LoadPagedDataNode(vtkMRMLNode* dataNode);
+
+  /// Voxels of the data node are not read on demand anymore
+  void RemovePagedDataNode(vtkMRMLNode* dataNode);
+
   struct IndexEntryType
     {
+    /// Set the index value and its numeric value
+    void SetIndexValue(const std::string& indexValue)
+      {
+      this->IndexValue = indexValue;
+      this->NumericIndexValue = atof(indexValue.c_str());
+      }
     std::string IndexValue;
-    vtkMRMLNode* DataNode;
+    /// Numeric value of IndexValue, stored to avoid parsing the string at each comparison
+    double NumericIndexValue{0.0};
+    vtkMRMLNode* DataNode{nullptr};
     std::string DataNodeID; // only used temporarily, during scene load
     };
 
@@ -200,6 +277,13 @@ protected:
 
   /// List of data items (the scene may contain some more nodes, such as storage nodes)
   std::deque< IndexEntryType > IndexEntries;
+
+  /// Frame index of data nodes that have their voxels read on demand
+  std::map< vtkMRMLNode*, int > PagedDataNodeFrameIndices;
+  /// Paged data nodes that have their voxels loaded, most recently used first
+  std::list< vtkMRMLNode* > LoadedPagedDataNodes;
+  vtkSmartPointer<vtkMRMLVolumeSequenceFrameReader> FrameReader;
+  int PagedDataNodeCacheSize{16};
 };
 
 #endif
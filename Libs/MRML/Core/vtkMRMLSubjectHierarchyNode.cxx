@@ -1431,6 +1431,28 @@ public:
   /// Add item and data node observers (if observers has not been added yet)
   void AddItemObservers(vtkSubjectHierarchyItem* item);
 
+  /// Determine whether the item is in the tree under the scene item (the scene item itself is not included)
+  bool IsItemInTree(vtkSubjectHierarchyItem* item);
+
+  /// Add items that were created since the last update to the lookup tables
+  void UpdateItemIndex();
+  /// Add current data node, name, and UIDs of the item to the lookup tables
+  void IndexItem(vtkSubjectHierarchyItem* item);
+  /// Add the item and all items in its branch to the lookup tables
+  void IndexBranch(vtkSubjectHierarchyItem* item);
+  /// Add the items associated to the data node to the lookup tables (e.g., after the data node is renamed)
+  void IndexDataNodeItems(vtkMRMLNode* dataNode);
+
+  /// Find items in a lookup table.
+  /// Outdated entries (for which itemMatches returns false) are removed from the table.
+  /// \param foundItems Items that are in the tree and match the key, in no particular order
+  template<class IndexType, class KeyType, class MatchFunction>
+  void FindIndexedItems(IndexType& index, const KeyType& key, MatchFunction itemMatches,
+    std::vector<vtkSubjectHierarchyItem*>& foundItems);
+  /// Add entry to a lookup table
+  template<class IndexType, class KeyType>
+  void AddIndexEntry(IndexType& index, const KeyType& key, vtkIdType itemID);
+
 public:
   /// Scene subject hierarchy item. This is the ancestor of all subject hierarchy items in the tree
   vtkSubjectHierarchyItem* SceneItem;
@@ -1449,6 +1471,22 @@ public:
   /// Flag indicating whether resolving unresolved items is underway (after scene import or restore)
   bool IsResolving;
 
+  /// Lookup tables to find items in the tree without traversing it.
+  /// Items are added to the tables when they are created, or their data node, name, UID, or parent changes.
+  /// Entries are not removed when an item is removed or changed, therefore all found items are verified
+  /// and outdated entries are removed when found.
+  typedef std::map<vtkMRMLNode*, std::set<vtkIdType> > DataNodeIndexType;
+  typedef std::map<std::pair<std::string, std::string>, std::set<vtkIdType> > UIDIndexType;
+  typedef std::map<std::string, std::set<vtkIdType> > NameIndexType;
+  DataNodeIndexType ItemsByDataNode;
+  /// Key is (UID name, UID value)
+  UIDIndexType ItemsByUID;
+  NameIndexType ItemsByName;
+  /// Items with smaller ID than this have been added to the lookup tables
+  vtkIdType NextIndexedItemID;
+  /// Number of entries in the lookup tables, used for deciding when to rebuild them
+  vtkIdType NumberOfIndexEntries;
+
 private:
   vtkMRMLSubjectHierarchyNode* External;
 };
@@ -1460,6 +1498,8 @@ private:
 vtkMRMLSubjectHierarchyNode::vtkInternal::vtkInternal(vtkMRMLSubjectHierarchyNode* external)
 : EventsDisabled(false)
 , IsResolving(false)
+, NextIndexedItemID(vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID + 1)
+, NumberOfIndexEntries(0)
 , External(external)
 {
   // Create scene item
@@ -1712,6 +1752,146 @@ void vtkMRMLSubjectHierarchyNode::vtkInternal::AddItemObservers(vtkSubjectHierar
     }
 }
 
+//----------------------------------------------------------------------------
+bool vtkMRMLSubjectHierarchyNode::vtkInternal::IsItemInTree(vtkSubjectHierarchyItem* item)
+{
+  if (!item || item == this->SceneItem)
+    {
+    return false;
+    }
+  vtkSubjectHierarchyItem* rootItem = item;
+  while (rootItem->Parent)
+    {
+    rootItem = rootItem->Parent;
+    }
+  return (rootItem == this->SceneItem);
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::vtkInternal::UpdateItemIndex()
+{
+  std::map<vtkIdType, vtkSubjectHierarchyItem*>& itemCache = vtkSubjectHierarchyItem::ItemCache;
+
+  // Outdated entries are only removed when they are found, so rebuild the tables
+  // if they contain many more entries than the number of existing items
+  if (this->NumberOfIndexEntries > 4 * static_cast<vtkIdType>(itemCache.size()) + 1000)
+    {
+    this->ItemsByDataNode.clear();
+    this->ItemsByUID.clear();
+    this->ItemsByName.clear();
+    this->NumberOfIndexEntries = 0;
+    this->NextIndexedItemID = vtkMRMLSubjectHierarchyNode::INVALID_ITEM_ID + 1;
+    }
+
+  // Item IDs are incremental and the item cache is ordered by ID, so new items are at the end of the cache
+  std::map<vtkIdType, vtkSubjectHierarchyItem*>::iterator itemIt = itemCache.lower_bound(this->NextIndexedItemID);
+  for ( ; itemIt != itemCache.end(); ++itemIt)
+    {
+    // The item cache contains items of all subject hierarchy nodes
+    if (this->IsItemInTree(itemIt->second))
+      {
+      this->IndexItem(itemIt->second);
+      }
+    this->NextIndexedItemID = itemIt->first + 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::vtkInternal::IndexItem(vtkSubjectHierarchyItem* item)
+{
+  if (!item)
+    {
+    return;
+    }
+  if (item->DataNode)
+    {
+    this->AddIndexEntry(this->ItemsByDataNode, item->DataNode.GetPointer(), item->ID);
+    }
+  std::string name = item->GetName();
+  if (!name.empty())
+    {
+    this->AddIndexEntry(this->ItemsByName, name, item->ID);
+    }
+  for (std::map<std::string, std::string>::iterator uidIt = item->UIDs.begin(); uidIt != item->UIDs.end(); ++uidIt)
+    {
+    if (uidIt->first.empty() || uidIt->second.empty())
+      {
+      continue;
+      }
+    this->AddIndexEntry(this->ItemsByUID, std::make_pair(uidIt->first, uidIt->second), item->ID);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::vtkInternal::IndexBranch(vtkSubjectHierarchyItem* item)
+{
+  if (!item)
+    {
+    return;
+    }
+  this->IndexItem(item);
+  for (vtkSubjectHierarchyItem::ChildVector::iterator childIt = item->Children.begin(); childIt != item->Children.end(); ++childIt)
+    {
+    this->IndexBranch(childIt->GetPointer());
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLSubjectHierarchyNode::vtkInternal::IndexDataNodeItems(vtkMRMLNode* dataNode)
+{
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->FindIndexedItems(this->ItemsByDataNode, dataNode,
+    [dataNode](vtkSubjectHierarchyItem* item) { return item->DataNode.GetPointer() == dataNode; },
+    foundItems);
+  for (std::vector<vtkSubjectHierarchyItem*>::iterator itemIt = foundItems.begin(); itemIt != foundItems.end(); ++itemIt)
+    {
+    this->IndexItem(*itemIt);
+    }
+}
+
+//----------------------------------------------------------------------------
+template<class IndexType, class KeyType, class MatchFunction>
+void vtkMRMLSubjectHierarchyNode::vtkInternal::FindIndexedItems(IndexType& index, const KeyType& key,
+  MatchFunction itemMatches, std::vector<vtkSubjectHierarchyItem*>& foundItems)
+{
+  this->UpdateItemIndex();
+
+  typename IndexType::iterator entryIt = index.find(key);
+  if (entryIt == index.end())
+    {
+    return;
+    }
+  std::set<vtkIdType>& itemIDs = entryIt->second;
+  for (std::set<vtkIdType>::iterator itemIDIt = itemIDs.begin(); itemIDIt != itemIDs.end(); )
+    {
+    std::map<vtkIdType, vtkSubjectHierarchyItem*>::iterator itemIt = vtkSubjectHierarchyItem::ItemCache.find(*itemIDIt);
+    vtkSubjectHierarchyItem* item = (itemIt != vtkSubjectHierarchyItem::ItemCache.end() ? itemIt->second : nullptr);
+    if (!this->IsItemInTree(item) || !itemMatches(item))
+      {
+      // Item has been removed or changed since it was added to the table
+      itemIDs.erase(itemIDIt++);
+      this->NumberOfIndexEntries--;
+      continue;
+      }
+    foundItems.push_back(item);
+    ++itemIDIt;
+    }
+  if (itemIDs.empty())
+    {
+    index.erase(entryIt);
+    }
+}
+
+//----------------------------------------------------------------------------
+template<class IndexType, class KeyType>
+void vtkMRMLSubjectHierarchyNode::vtkInternal::AddIndexEntry(IndexType& index, const KeyType& key, vtkIdType itemID)
+{
+  if (index[key].insert(itemID).second)
+    {
+    this->NumberOfIndexEntries++;
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLSubjectHierarchyNode::vtkInternal::CopyAsUnresolved(vtkMRMLSubjectHierarchyNode* otherShNode)
 {
@@ -2041,6 +2221,7 @@ void vtkMRMLSubjectHierarchyNode::SetItemDataNode(vtkIdType itemID, vtkMRMLNode*
     }
 
   item->DataNode = dataNode;
+  this->Internal->IndexItem(item);
 
   // Add observers for data node
   this->Internal->AddItemObservers(item);
@@ -2093,6 +2274,7 @@ void vtkMRMLSubjectHierarchyNode::SetItemName(vtkIdType itemID, std::string name
 
   if (nameChanged)
     {
+    this->Internal->IndexItem(item);
     this->InvokeCustomModifiedEvent(SubjectHierarchyItemModifiedEvent, (void*)&itemID);
     }
 }
@@ -2233,6 +2415,7 @@ void vtkMRMLSubjectHierarchyNode::SetItemUID(vtkIdType itemID, std::string uidNa
     return;
     }
 
+  // The UID is added to the lookup table in ItemEventCallback before the UID added event is propagated
   item->SetUID(uidName, uidValue); // Events are invoked within this call
 }
 
@@ -2378,6 +2561,7 @@ vtkIdType vtkMRMLSubjectHierarchyNode::CreateItem(vtkIdType parentItemID, vtkMRM
 
     // The name of the data node is used, so empty name is set
     item->Name = "";
+    this->Internal->IndexItem(item);
     if (ownerPluginName)
       {
       item->OwnerPluginName = ownerPluginName;
@@ -2633,6 +2817,7 @@ void vtkMRMLSubjectHierarchyNode::SetItemParent(vtkIdType itemID, vtkIdType pare
 
   // Perform reparenting
   item->Reparent(parentItem);
+  this->Internal->IndexBranch(item);
 }
 
 //----------------------------------------------------------------------------
@@ -2725,7 +2910,12 @@ bool vtkMRMLSubjectHierarchyNode::ReparentItemByDataNode(vtkIdType itemID, vtkMR
     }
 
   // Perform reparenting
-  return item->Reparent(newParentItem);
+  if (!item->Reparent(newParentItem))
+    {
+    return false;
+    }
+  this->Internal->IndexBranch(item);
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -2753,6 +2943,28 @@ vtkIdType vtkMRMLSubjectHierarchyNode::GetItemByUID(const char* uidName, const c
     vtkErrorMacro("GetSubjectHierarchyNodeByUID: Invalid UID name or value");
     return INVALID_ITEM_ID;
     }
+  if (!uidName[0] || !uidValue[0])
+    {
+    return INVALID_ITEM_ID;
+    }
+
+  std::string uidNameStr(uidName);
+  std::string uidValueStr(uidValue);
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->Internal->FindIndexedItems(this->Internal->ItemsByUID, std::make_pair(uidNameStr, uidValueStr),
+    [&uidNameStr, &uidValueStr](vtkSubjectHierarchyItem* item) { return item->GetUID(uidNameStr) == uidValueStr; },
+    foundItems);
+  if (foundItems.size() == 1)
+    {
+    return foundItems[0]->ID;
+    }
+
+  if (foundItems.empty())
+    {
+    return INVALID_ITEM_ID;
+    }
+
+  // Search the tree if there are multiple matches, to return the first item in the tree
   vtkSubjectHierarchyItem* item = this->Internal->SceneItem->FindChildByUID(uidName, uidValue);
   return (item ? item->ID : INVALID_ITEM_ID);
 }
@@ -2778,6 +2990,21 @@ vtkIdType vtkMRMLSubjectHierarchyNode::GetItemByDataNode(vtkMRMLNode* dataNode)
     return INVALID_ITEM_ID;
     }
 
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->Internal->FindIndexedItems(this->Internal->ItemsByDataNode, dataNode,
+    [dataNode](vtkSubjectHierarchyItem* item) { return item->DataNode.GetPointer() == dataNode; },
+    foundItems);
+  if (foundItems.size() == 1)
+    {
+    return foundItems[0]->ID;
+    }
+
+  if (foundItems.empty())
+    {
+    return INVALID_ITEM_ID;
+    }
+
+  // Search the tree if there are multiple matches (should not happen), to return the first item in the tree
   vtkSubjectHierarchyItem* item = this->Internal->SceneItem->FindChildByDataNode(dataNode);
   return (item ? item->ID : INVALID_ITEM_ID);
 }
@@ -2791,6 +3018,17 @@ vtkIdType vtkMRMLSubjectHierarchyNode::GetItemByName(std::string name)
     return INVALID_ITEM_ID;
     }
 
+  std::vector<vtkSubjectHierarchyItem*> foundItems;
+  this->Internal->FindIndexedItems(this->Internal->ItemsByName, name,
+    [&name](vtkSubjectHierarchyItem* item) { return item->GetName() == name; },
+    foundItems);
+  if (foundItems.size() == 1)
+    {
+    return foundItems[0]->ID;
+    }
+
+  // Search the tree if there are multiple matches (to return the first item in the tree)
+  // or no match (data node may have been renamed while its modified events were disabled)
   std::vector<vtkIdType> foundItemIDs;
   this->Internal->SceneItem->FindChildrenByName(name, foundItemIDs);
   if (foundItemIDs.size() == 0)
@@ -2820,6 +3058,20 @@ void vtkMRMLSubjectHierarchyNode::GetItemsByName(std::string name, vtkIdList* fo
     return;
     }
 
+  if (!contains)
+    {
+    std::vector<vtkSubjectHierarchyItem*> foundItems;
+    this->Internal->FindIndexedItems(this->Internal->ItemsByName, name,
+      [&name](vtkSubjectHierarchyItem* item) { return item->GetName() == name; },
+      foundItems);
+    if (foundItems.size() == 1)
+      {
+      foundItemIds->InsertNextId(foundItems[0]->ID);
+      return;
+      }
+    // Multiple matches are returned in the order of the tree
+    }
+
   std::vector<vtkIdType> foundItemsVector;
   this->Internal->SceneItem->FindChildrenByName(name, foundItemsVector, contains);
 
@@ -3345,7 +3597,28 @@ int vtkMRMLSubjectHierarchyNode::GetNumberOfItemChildren(vtkIdType itemID, bool
 void vtkMRMLSubjectHierarchyNode::ItemEventCallback(vtkObject* caller, unsigned long eid, void* clientData, void* callData)
 {
   vtkMRMLSubjectHierarchyNode* self = reinterpret_cast<vtkMRMLSubjectHierarchyNode*>(clientData);
-  if (!self || self->Internal->EventsDisabled)
+  if (!self)
+    {
+    return;
+    }
+
+  // Keep the lookup tables up to date even if events are disabled (data node may have been renamed).
+  // Added items and UIDs are indexed before the events are propagated, so that observers can find them.
+  if (eid == vtkCommand::ModifiedEvent && vtkMRMLNode::SafeDownCast(caller))
+    {
+    self->Internal->IndexDataNodeItems(vtkMRMLNode::SafeDownCast(caller));
+    }
+  else if (eid == vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemAddedEvent
+    || eid == vtkMRMLSubjectHierarchyNode::SubjectHierarchyItemUIDAddedEvent)
+    {
+    vtkSubjectHierarchyItem* item = reinterpret_cast<vtkSubjectHierarchyItem*>(callData);
+    if (self->Internal->IsItemInTree(item))
+      {
+      self->Internal->IndexItem(item);
+      }
+    }
+
+  if (self->Internal->EventsDisabled)
     {
     return;
     }
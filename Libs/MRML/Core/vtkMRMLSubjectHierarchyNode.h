@@ -269,6 +269,7 @@ public:
   /// Get subject hierarchy item associated to a data MRML node
   /// \param dataNode The node for which we want the associated hierarchy node
   /// \return The first subject hierarchy item ID to which the given node is associated to.
+  /// Items are looked up in a table, so the cost does not depend on the number of items in the hierarchy.
   vtkIdType GetItemByDataNode(vtkMRMLNode* dataNode);
 
   /// Get item in whole subject hierarchy by a given name
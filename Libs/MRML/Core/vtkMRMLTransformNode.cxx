@@ -31,19 +31,168 @@ Version:   $Revision: 1.14 $
 #include <vtkCollection.h>
 #include <vtkCollectionIterator.h>
 #include <vtkGeneralTransform.h>
+#include <vtkGridTransform.h>
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkHomogeneousTransform.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
+#include <vtkPointData.h>
 #include <vtkPoints.h>
+#include <vtkSMPTools.h>
 #include <vtkThinPlateSplineTransform.h>
 #include <vtkTransform.h>
+#include <vtkWarpTransform.h>
 #include <vtksys/SystemTools.hxx>
 
 // STD includes
+#include <algorithm>
+#include <cmath>
 #include <sstream>
 #include <stack>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Displacement grid transform that uses the exact transform for points outside the grid,
+/// instead of extrapolating the displacements at the grid boundary.
+class vtkResampledGridTransform : public vtkWarpTransform
+{
+public:
+  static vtkResampledGridTransform* New();
+  vtkTypeMacro(vtkResampledGridTransform, vtkWarpTransform);
+
+  void SetTransforms(vtkGridTransform* gridTransform, vtkAbstractTransform* exactTransform)
+    {
+    this->GridTransform = gridTransform;
+    this->ExactTransform = exactTransform;
+    this->Modified();
+    }
+
+  vtkAbstractTransform* MakeTransform() override
+    {
+    return vtkResampledGridTransform::New();
+    }
+
+  vtkMTimeType GetMTime() override
+    {
+    vtkMTimeType mtime = this->Superclass::GetMTime();
+    if (this->GridTransform)
+      {
+      mtime = std::max(mtime, this->GridTransform->GetMTime());
+      }
+    if (this->ExactTransform)
+      {
+      mtime = std::max(mtime, this->ExactTransform->GetMTime());
+      }
+    return mtime;
+    }
+
+protected:
+  vtkResampledGridTransform() = default;
+  ~vtkResampledGridTransform() override = default;
+
+  void InternalUpdate() override
+    {
+    this->GridBounds[0] = this->GridBounds[2] = this->GridBounds[4] = 0.0;
+    this->GridBounds[1] = this->GridBounds[3] = this->GridBounds[5] = -1.0;
+    if (!this->GridTransform || !this->ExactTransform)
+      {
+      return;
+      }
+    this->GridTransform->Update();
+    this->ExactTransform->Update();
+    vtkImageData* grid = this->GridTransform->GetDisplacementGrid();
+    if (grid)
+      {
+      grid->GetBounds(this->GridBounds);
+      }
+    }
+
+  void InternalDeepCopy(vtkAbstractTransform* transform) override
+    {
+    vtkResampledGridTransform* resampledGridTransform = static_cast<vtkResampledGridTransform*>(transform);
+    this->SetTransforms(resampledGridTransform->GridTransform, resampledGridTransform->ExactTransform);
+    this->Superclass::InternalDeepCopy(transform);
+    }
+
+  bool IsInsideGrid(const double point[3])
+    {
+    return point[0] >= this->GridBounds[0] && point[0] <= this->GridBounds[1]
+      && point[1] >= this->GridBounds[2] && point[1] <= this->GridBounds[3]
+      && point[2] >= this->GridBounds[4] && point[2] <= this->GridBounds[5];
+    }
+
+  vtkAbstractTransform* GetTransformForPoint(const double point[3])
+    {
+    return this->IsInsideGrid(point) ? this->GridTransform.GetPointer() : this->ExactTransform.GetPointer();
+    }
+
+  void ForwardTransformPoint(const double in[3], double out[3]) override
+    {
+    if (!this->GridTransform || !this->ExactTransform)
+      {
+      out[0] = in[0];
+      out[1] = in[1];
+      out[2] = in[2];
+      return;
+      }
+    this->GetTransformForPoint(in)->InternalTransformPoint(in, out);
+    }
+
+  void ForwardTransformPoint(const float in[3], float out[3]) override
+    {
+    double point[3] = { in[0], in[1], in[2] };
+    this->ForwardTransformPoint(point, point);
+    out[0] = static_cast<float>(point[0]);
+    out[1] = static_cast<float>(point[1]);
+    out[2] = static_cast<float>(point[2]);
+    }
+
+  void ForwardTransformDerivative(const double in[3], double out[3], double derivative[3][3]) override
+    {
+    if (!this->GridTransform || !this->ExactTransform)
+      {
+      out[0] = in[0];
+      out[1] = in[1];
+      out[2] = in[2];
+      vtkMath::Identity3x3(derivative);
+      return;
+      }
+    this->GetTransformForPoint(in)->InternalTransformDerivative(in, out, derivative);
+    }
+
+  void ForwardTransformDerivative(const float in[3], float out[3], float derivative[3][3]) override
+    {
+    double point[3] = { in[0], in[1], in[2] };
+    double doubleDerivative[3][3];
+    this->ForwardTransformDerivative(point, point, doubleDerivative);
+    for (int i = 0; i < 3; ++i)
+      {
+      out[i] = static_cast<float>(point[i]);
+      for (int j = 0; j < 3; ++j)
+        {
+        derivative[i][j] = static_cast<float>(doubleDerivative[i][j]);
+        }
+      }
+    }
+
+  vtkSmartPointer<vtkGridTransform> GridTransform;
+  vtkSmartPointer<vtkAbstractTransform> ExactTransform;
+  double GridBounds[6]{0.0, -1.0, 0.0, -1.0, 0.0, -1.0};
+
+private:
+  vtkResampledGridTransform(const vtkResampledGridTransform&) = delete;
+  void operator=(const vtkResampledGridTransform&) = delete;
+};
+
+vtkStandardNewMacro(vtkResampledGridTransform);
+
+} // end of anonymous namespace
 
 //----------------------------------------------------------------------------
 vtkMRMLNodeNewMacro(vtkMRMLTransformNode);
@@ -77,6 +226,11 @@ vtkMRMLTransformNode::~vtkMRMLTransformNode()
 void vtkMRMLTransformNode::WriteXML(ostream& of, int nIndent)
 {
   Superclass::WriteXML(of, nIndent);
+
+  vtkMRMLWriteXMLBeginMacro(of);
+  vtkMRMLWriteXMLBooleanMacro(resampledTransformCacheEnabled, ResampledTransformCacheEnabled);
+  vtkMRMLWriteXMLFloatMacro(resampledTransformCacheSpacing, ResampledTransformCacheSpacing);
+  vtkMRMLWriteXMLEndMacro();
 }
 
 //----------------------------------------------------------------------------
@@ -86,6 +240,11 @@ void vtkMRMLTransformNode::ReadXMLAttributes(const char** atts)
 
   Superclass::ReadXMLAttributes(atts);
 
+  vtkMRMLReadXMLBeginMacro(atts);
+  vtkMRMLReadXMLBooleanMacro(resampledTransformCacheEnabled, ResampledTransformCacheEnabled);
+  vtkMRMLReadXMLFloatMacro(resampledTransformCacheSpacing, ResampledTransformCacheSpacing);
+  vtkMRMLReadXMLEndMacro();
+
   const char* attName;
   const char* attValue;
   while (*atts != nullptr)
@@ -186,6 +345,92 @@ bool vtkMRMLTransformNode::AreTransformsEqual(vtkAbstractTransform* transform1,
   return true;
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::TransformPoints(vtkAbstractTransform* transform, vtkPoints* inputPoints, vtkPoints* outputPoints)
+{
+  if (inputPoints == nullptr || outputPoints == nullptr)
+    {
+    vtkGenericWarningMacro("vtkMRMLTransformNode::TransformPoints failed: input or output points are invalid");
+    return;
+    }
+  vtkIdType numberOfPoints = inputPoints->GetNumberOfPoints();
+  if (outputPoints != inputPoints)
+    {
+    outputPoints->SetNumberOfPoints(numberOfPoints);
+    }
+
+  // Split the transform into steps that are applied to each point in order.
+  // A step either applies a matrix (product of consecutive homogeneous transforms)
+  // or evaluates a nonlinear transform.
+  struct TransformStep
+    {
+    vtkAbstractTransform* NonlinearTransform;
+    double Matrix[16];
+    };
+  std::vector<TransformStep> steps;
+  vtkNew<vtkCollection> transformList;
+  vtkMRMLTransformNode::FlattenGeneralTransform(transformList.GetPointer(), transform);
+  vtkCollectionSimpleIterator it;
+  vtkAbstractTransform* concatenatedTransform = nullptr;
+  for (transformList->InitTraversal(it); (concatenatedTransform = vtkAbstractTransform::SafeDownCast(transformList->GetNextItemAsObject(it))) ;)
+    {
+    // Update now, as worker threads cannot update the transform
+    concatenatedTransform->Update();
+    vtkHomogeneousTransform* homogeneousTransform = vtkHomogeneousTransform::SafeDownCast(concatenatedTransform);
+    if (homogeneousTransform)
+      {
+      if (steps.empty() || steps.back().NonlinearTransform)
+        {
+        steps.emplace_back();
+        steps.back().NonlinearTransform = nullptr;
+        vtkMatrix4x4::Identity(steps.back().Matrix);
+        }
+      double matrix[16];
+      vtkMatrix4x4::DeepCopy(matrix, homogeneousTransform->GetMatrix());
+      vtkMatrix4x4::Multiply4x4(matrix, steps.back().Matrix, steps.back().Matrix);
+      }
+    else
+      {
+      steps.emplace_back();
+      steps.back().NonlinearTransform = concatenatedTransform;
+      }
+    }
+
+  vtkSMPTools::For(0, numberOfPoints, [&](vtkIdType beginPointIndex, vtkIdType endPointIndex)
+    {
+    double point[4] = { 0.0, 0.0, 0.0, 1.0 };
+    double transformedPoint[4] = { 0.0, 0.0, 0.0, 1.0 };
+    for (vtkIdType pointIndex = beginPointIndex; pointIndex < endPointIndex; ++pointIndex)
+      {
+      inputPoints->GetPoint(pointIndex, point);
+      for (const TransformStep& step : steps)
+        {
+        if (step.NonlinearTransform)
+          {
+          step.NonlinearTransform->InternalTransformPoint(point, point);
+          continue;
+          }
+        point[3] = 1.0;
+        vtkMatrix4x4::MultiplyPoint(step.Matrix, point, transformedPoint);
+        double w = transformedPoint[3];
+        if (w != 1.0 && w != 0.0)
+          {
+          // perspective transform
+          transformedPoint[0] /= w;
+          transformedPoint[1] /= w;
+          transformedPoint[2] /= w;
+          }
+        point[0] = transformedPoint[0];
+        point[1] = transformedPoint[1];
+        point[2] = transformedPoint[2];
+        }
+      outputPoints->SetPoint(pointIndex, point);
+      }
+    });
+  // SetPoint does not update the modification time of the points
+  outputPoints->Modified();
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLTransformNode::DeepCopyTransform(vtkAbstractTransform* dst, vtkAbstractTransform* src)
 {
@@ -300,6 +545,11 @@ void vtkMRMLTransformNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*
     {
     return;
     }
+  vtkMRMLCopyBeginMacro(anode);
+  vtkMRMLCopyBooleanMacro(ResampledTransformCacheEnabled);
+  vtkMRMLCopyFloatMacro(ResampledTransformCacheSpacing);
+  vtkMRMLCopyEndMacro();
+
   if (deepCopy)
   {
   this->SetReadAsTransformToParent(node->GetReadAsTransformToParent());
@@ -346,6 +596,13 @@ void vtkMRMLTransformNode::PrintSelf(ostream& os, vtkIndent indent)
   Superclass::PrintSelf(os,indent);
   os << indent << "ReadAsTransformToParent: " << this->ReadAsTransformToParent << "\n";
 
+  vtkMRMLPrintBeginMacro(os, indent);
+  vtkMRMLPrintBooleanMacro(ResampledTransformCacheEnabled);
+  vtkMRMLPrintFloatMacro(ResampledTransformCacheSpacing);
+  vtkMRMLPrintEndMacro();
+  os << indent << "ResampledTransformToWorldError: " << this->GetResampledTransformToWorldError() << "\n";
+  os << indent << "ResampledTransformFromWorldError: " << this->GetResampledTransformFromWorldError() << "\n";
+
   // Flatten the transform list to make the copying simpler
   if (this->TransformToParent)
     {
@@ -447,6 +704,229 @@ void vtkMRMLTransformNode::GetTransformFromWorld(vtkGeneralTransform* transformF
   vtkMRMLTransformNode::GetTransformBetweenNodes(nullptr, this, transformFromWorld);
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetResampledTransformCacheEnabled(bool enabled)
+{
+  if (this->ResampledTransformCacheEnabled == enabled)
+    {
+    return;
+    }
+  this->ResampledTransformCacheEnabled = enabled;
+  this->Modified();
+  this->TransformModified();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLTransformNode::SetResampledTransformCacheSpacing(double spacing)
+{
+  if (this->ResampledTransformCacheSpacing == spacing)
+    {
+    return;
+    }
+  this->ResampledTransformCacheSpacing = spacing;
+  this->Modified();
+  if (this->ResampledTransformCacheEnabled)
+    {
+    this->TransformModified();
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetResampledTransformToWorld(const double bounds[6])
+{
+  return this->GetResampledTransform(this->ResampledTransformToWorldCache, true, bounds);
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetResampledTransformFromWorld(const double bounds_World[6])
+{
+  return this->GetResampledTransform(this->ResampledTransformFromWorldCache, false, bounds_World);
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLTransformNode::GetResampledTransformToWorldError()
+{
+  return this->ResampledTransformToWorldCache.Transform ? this->ResampledTransformToWorldCache.Error : -1.0;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLTransformNode::GetResampledTransformFromWorldError()
+{
+  return this->ResampledTransformFromWorldCache.Transform ? this->ResampledTransformFromWorldCache.Error : -1.0;
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractTransform* vtkMRMLTransformNode::GetResampledTransform(ResampledTransformCache& cache,
+  bool transformToWorld, const double bounds[6])
+{
+  if (!this->ResampledTransformCacheEnabled || this->ResampledTransformCacheSpacing <= 0.0)
+    {
+    // release the grid, it will not be used
+    cache.Transform = nullptr;
+    return nullptr;
+    }
+  if (bounds == nullptr || bounds[0] > bounds[1] || bounds[2] > bounds[3] || bounds[4] > bounds[5])
+    {
+    return nullptr;
+    }
+  if (this->IsTransformToWorldLinear())
+    {
+    // linear transforms are computed exactly and faster than grid interpolation
+    cache.Transform = nullptr;
+    return nullptr;
+    }
+
+  std::vector<vtkWeakPointer<vtkMRMLTransformNode> > transformNodes;
+  for (vtkMRMLTransformNode* transformNode = this; transformNode; transformNode = transformNode->GetParentTransformNode())
+    {
+    transformNodes.push_back(transformNode);
+    }
+  vtkMTimeType transformToWorldMTime = this->GetTransformToWorldMTime();
+
+  bool transformUnchanged = (cache.Transform != nullptr
+    && cache.TransformToWorldMTime == transformToWorldMTime
+    && cache.RequestedSpacing == this->ResampledTransformCacheSpacing
+    && cache.TransformNodes.size() == transformNodes.size());
+  for (size_t nodeIndex = 0; transformUnchanged && nodeIndex < transformNodes.size(); ++nodeIndex)
+    {
+    transformUnchanged = (cache.TransformNodes[nodeIndex].GetPointer() == transformNodes[nodeIndex].GetPointer());
+    }
+
+  double gridBounds[6] = { bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5] };
+  if (transformUnchanged)
+    {
+    bool insideGrid = true;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      insideGrid = insideGrid && bounds[axis * 2] >= cache.Bounds[axis * 2] && bounds[axis * 2 + 1] <= cache.Bounds[axis * 2 + 1];
+      }
+    if (insideGrid)
+      {
+      return cache.Transform;
+      }
+    // Cover the previously requested region as well, to not recompute the grid
+    // when users of the transform request different regions alternately.
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      gridBounds[axis * 2] = std::min(gridBounds[axis * 2], cache.Bounds[axis * 2]);
+      gridBounds[axis * 2 + 1] = std::max(gridBounds[axis * 2 + 1], cache.Bounds[axis * 2 + 1]);
+      }
+    }
+
+  // Grid extends by one spacing beyond the bounds so that all points within the bounds are interpolated.
+  // Spacing is increased if needed to limit memory usage and computation time.
+  const double maximumNumberOfGridPoints = 100.0 * 100.0 * 100.0;
+  double spacing = this->ResampledTransformCacheSpacing;
+  int dimensions[3] = { 0, 0, 0 };
+  for (;;)
+    {
+    double numberOfGridPoints = 1.0;
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      dimensions[axis] = static_cast<int>(std::ceil((gridBounds[axis * 2 + 1] - gridBounds[axis * 2]) / spacing)) + 3;
+      numberOfGridPoints *= dimensions[axis];
+      }
+    if (numberOfGridPoints <= maximumNumberOfGridPoints)
+      {
+      break;
+      }
+    spacing *= std::max(1.01, std::cbrt(numberOfGridPoints / maximumNumberOfGridPoints));
+    }
+  double origin[3] = { gridBounds[0] - spacing, gridBounds[2] - spacing, gridBounds[4] - spacing };
+
+  vtkNew<vtkGeneralTransform> exactTransform;
+  if (transformToWorld)
+    {
+    this->GetTransformToWorld(exactTransform.GetPointer());
+    }
+  else
+    {
+    this->GetTransformFromWorld(exactTransform.GetPointer());
+    }
+
+  // Compute displacements at grid points
+  vtkNew<vtkPoints> gridPoints;
+  gridPoints->SetDataTypeToDouble();
+  gridPoints->SetNumberOfPoints(static_cast<vtkIdType>(dimensions[0]) * dimensions[1] * dimensions[2]);
+  vtkIdType pointIndex = 0;
+  for (int k = 0; k < dimensions[2]; ++k)
+    {
+    for (int j = 0; j < dimensions[1]; ++j)
+      {
+      for (int i = 0; i < dimensions[0]; ++i)
+        {
+        gridPoints->SetPoint(pointIndex++, origin[0] + i * spacing, origin[1] + j * spacing, origin[2] + k * spacing);
+        }
+      }
+    }
+  vtkNew<vtkPoints> transformedGridPoints;
+  transformedGridPoints->SetDataTypeToDouble();
+  vtkMRMLTransformNode::TransformPoints(exactTransform.GetPointer(), gridPoints.GetPointer(), transformedGridPoints.GetPointer());
+
+  vtkNew<vtkImageData> displacementGrid;
+  displacementGrid->SetOrigin(origin);
+  displacementGrid->SetSpacing(spacing, spacing, spacing);
+  displacementGrid->SetDimensions(dimensions);
+  displacementGrid->AllocateScalars(VTK_DOUBLE, 3);
+  double* displacements = static_cast<double*>(displacementGrid->GetScalarPointer());
+  for (pointIndex = 0; pointIndex < gridPoints->GetNumberOfPoints(); ++pointIndex)
+    {
+    double* point = gridPoints->GetPoint(pointIndex);
+    double* transformedPoint = transformedGridPoints->GetPoint(pointIndex);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      displacements[pointIndex * 3 + axis] = transformedPoint[axis] - point[axis];
+      }
+    }
+
+  vtkNew<vtkGridTransform> gridTransform;
+  gridTransform->SetInterpolationModeToLinear();
+  gridTransform->SetDisplacementGridData(displacementGrid.GetPointer());
+  // Displacements are not extrapolated, the exact transform is used outside the grid
+  vtkSmartPointer<vtkResampledGridTransform> resampledTransform = vtkSmartPointer<vtkResampledGridTransform>::New();
+  resampledTransform->SetTransforms(gridTransform.GetPointer(), exactTransform.GetPointer());
+
+  // Interpolation error is the largest between grid points, therefore it is estimated at cell centers
+  vtkNew<vtkPoints> cellCenterPoints;
+  cellCenterPoints->SetDataTypeToDouble();
+  cellCenterPoints->SetNumberOfPoints(static_cast<vtkIdType>(dimensions[0] - 1) * (dimensions[1] - 1) * (dimensions[2] - 1));
+  pointIndex = 0;
+  for (int k = 0; k < dimensions[2] - 1; ++k)
+    {
+    for (int j = 0; j < dimensions[1] - 1; ++j)
+      {
+      for (int i = 0; i < dimensions[0] - 1; ++i)
+        {
+        cellCenterPoints->SetPoint(pointIndex++,
+          origin[0] + (i + 0.5) * spacing, origin[1] + (j + 0.5) * spacing, origin[2] + (k + 0.5) * spacing);
+        }
+      }
+    }
+  vtkNew<vtkPoints> exactCellCenterPoints;
+  exactCellCenterPoints->SetDataTypeToDouble();
+  vtkMRMLTransformNode::TransformPoints(exactTransform.GetPointer(), cellCenterPoints.GetPointer(), exactCellCenterPoints.GetPointer());
+  vtkNew<vtkPoints> resampledCellCenterPoints;
+  resampledCellCenterPoints->SetDataTypeToDouble();
+  vtkMRMLTransformNode::TransformPoints(resampledTransform, cellCenterPoints.GetPointer(), resampledCellCenterPoints.GetPointer());
+  double maximumSquaredError = 0.0;
+  for (pointIndex = 0; pointIndex < cellCenterPoints->GetNumberOfPoints(); ++pointIndex)
+    {
+    double* exactPoint = exactCellCenterPoints->GetPoint(pointIndex);
+    double* resampledPoint = resampledCellCenterPoints->GetPoint(pointIndex);
+    maximumSquaredError = std::max(maximumSquaredError, vtkMath::Distance2BetweenPoints(exactPoint, resampledPoint));
+    }
+
+  cache.Transform = resampledTransform;
+  cache.TransformToWorldMTime = transformToWorldMTime;
+  cache.TransformNodes = transformNodes;
+  cache.RequestedSpacing = this->ResampledTransformCacheSpacing;
+  std::copy(gridBounds, gridBounds + 6, cache.Bounds);
+  cache.Error = std::sqrt(maximumSquaredError);
+  vtkDebugMacro("Resampled transform " << (transformToWorld ? "to" : "from") << " world: grid spacing " << spacing
+    << "mm, " << dimensions[0] << "x" << dimensions[1] << "x" << dimensions[2] << " points, maximum error " << cache.Error << "mm");
+  return cache.Transform;
+}
+
 //----------------------------------------------------------------------------
 int  vtkMRMLTransformNode::IsTransformToNodeLinear(vtkMRMLTransformNode* targetNode)
 {
@@ -17,10 +17,18 @@
 
 #include "vtkMRMLDisplayableNode.h"
 
+// VTK includes
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+// STD includes
+#include <vector>
+
 class vtkCollection;
 class vtkAbstractTransform;
 class vtkGeneralTransform;
 class vtkMatrix4x4;
+class vtkPoints;
 class vtkTransform;
 
 /// \brief MRML node for representing a transformation
@@ -128,6 +136,46 @@ public:
   /// \sa GetTransformBetweenNodes
   void GetTransformFromWorld(vtkGeneralTransform* transformToWorld);
 
+  ///
+  /// Enable approximation of nonlinear transforms to/from world by a single resampled displacement grid.
+  /// Evaluating one grid is much faster than evaluating a chain of nonlinear (especially inverse) transforms,
+  /// at the cost of an approximation error, which is reported by GetResampledTransformToWorldError().
+  /// Disabled by default.
+  /// TransformModifiedEvent is invoked when the setting changes, as users of the transform
+  /// switch between the exact and the resampled transform.
+  /// \sa GetResampledTransformToWorld, GetResampledTransformFromWorld
+  vtkGetMacro(ResampledTransformCacheEnabled, bool);
+  void SetResampledTransformCacheEnabled(bool enabled);
+  vtkBooleanMacro(ResampledTransformCacheEnabled, bool);
+
+  ///
+  /// Spacing of the resampled displacement grid, in mm. Default is 5mm.
+  /// The spacing is increased if the grid would contain more than 100^3 points.
+  vtkGetMacro(ResampledTransformCacheSpacing, double);
+  void SetResampledTransformCacheSpacing(double spacing);
+
+  ///
+  /// Get a displacement grid transform that approximates the transform to world within
+  /// the specified bounds (in the coordinate system of this node).
+  /// The grid is computed when first requested and it is reused until any transform to world
+  /// or the parent transform nodes change, or bounds outside the grid are requested.
+  /// Points outside the grid are transformed by the exact transform.
+  /// Returns nullptr if resampled transform cache is disabled or the transform to world is linear,
+  /// in which case GetTransformToWorld should be used.
+  vtkAbstractTransform* GetResampledTransformToWorld(const double bounds[6]);
+
+  ///
+  /// Get a displacement grid transform that approximates the transform from world within
+  /// the specified bounds (in world coordinate system).
+  /// \sa GetResampledTransformToWorld
+  vtkAbstractTransform* GetResampledTransformFromWorld(const double bounds_World[6]);
+
+  ///
+  /// Maximum distance (in mm) between the resampled and the exact transform, measured at the
+  /// centers of the cells of the last computed resampled grid. Returns -1 if no grid is computed.
+  double GetResampledTransformToWorldError();
+  double GetResampledTransformFromWorldError();
+
   ///
   /// Get concatenated transforms to the specified node.
   /// \sa GetTransformBetweenNodes
@@ -344,6 +392,16 @@ public:
   /// Returns nonzero on success.
   static int DeepCopyTransform(vtkAbstractTransform* dst, vtkAbstractTransform* src);
 
+  ///
+  /// Transform all points of inputPoints and store the result in outputPoints.
+  /// Much faster than calling TransformPoint for each point: points are processed in parallel
+  /// (using vtkSMPTools), consecutive linear transforms of a composite transform are applied as
+  /// a single matrix, and nonlinear (grid, B-spline, thin plate spline) transforms are evaluated
+  /// directly, without the update check that every TransformPoint call performs.
+  /// The transform must not be modified while points are transformed.
+  /// inputPoints and outputPoints may be the same object.
+  static void TransformPoints(vtkAbstractTransform* transform, vtkPoints* inputPoints, vtkPoints* outputPoints);
+
   ///
   /// Invert the transform.
   /// Internally it does not perform any actual computation just switches ToParent and FromParent.
@@ -384,6 +442,21 @@ protected:
   /// Sets and observes a transform and deletes the inverse (so that the inverse will be computed automatically)
   virtual void SetAndObserveTransform(vtkAbstractTransform** originalTransformPtr, vtkAbstractTransform** inverseTransformPtr, vtkAbstractTransform *transform);
 
+  /// Resampled displacement grid and the state of the transforms it was computed from
+  struct ResampledTransformCache
+    {
+    vtkSmartPointer<vtkAbstractTransform> Transform;
+    vtkMTimeType TransformToWorldMTime{0};
+    std::vector<vtkWeakPointer<vtkMRMLTransformNode> > TransformNodes;
+    double Bounds[6]{0.0, -1.0, 0.0, -1.0, 0.0, -1.0};
+    double RequestedSpacing{0.0};
+    double Error{-1.0};
+    };
+
+  ///
+  /// Return the cached resampled transform to/from world, recompute it if it is not valid for the bounds.
+  vtkAbstractTransform* GetResampledTransform(ResampledTransformCache& cache, bool transformToWorld, const double bounds[6]);
+
   ///
   /// These transforms store the transforms that were set externally.
   /// We use the capability of generic transforms for concatenating and inverting the same
@@ -396,6 +469,11 @@ protected:
 
   int ReadAsTransformToParent;
 
+  bool ResampledTransformCacheEnabled{false};
+  double ResampledTransformCacheSpacing{5.0};
+  ResampledTransformCache ResampledTransformToWorldCache;
+  ResampledTransformCache ResampledTransformFromWorldCache;
+
   // Temporary buffers used for returning transform info as char*
   std::string TransformInfo;
 
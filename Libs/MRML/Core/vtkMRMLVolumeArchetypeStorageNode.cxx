@@ -15,6 +15,7 @@ Version:   $Revision: 1.6 $
 // MRML includes
 #include "vtkDataFileFormatHelper.h"
 #include "vtkDataIOManager.h"
+#include "vtkMRMLImageStatistics.h"
 #include "vtkMRMLScene.h"
 #ifdef MRML_USE_vtkTeem
 #include "vtkMRMLVectorVolumeNode.h"
@@ -28,6 +29,7 @@ Version:   $Revision: 1.6 $
 #include "vtkITKArchetypeImageSeriesVectorReaderFile.h"
 #include "vtkITKArchetypeImageSeriesVectorReaderSeries.h"
 #include "vtkITKImageWriter.h"
+#include "vtkITKSharedMemoryImage.h"
 
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
@@ -37,11 +39,14 @@ Version:   $Revision: 1.6 $
 #include <vtkDataArray.h>
 #include <vtkErrorCode.h>
 #include <vtkImageChangeInformation.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkSmartPointer.h>
 #include <vtkStringArray.h>
 #include <vtksys/Directory.hxx>
+// ITK includes
+#include <itkMetaDataObject.h>
 
 // STD includes
 #include <algorithm>
@@ -56,6 +61,7 @@ vtkMRMLVolumeArchetypeStorageNode::vtkMRMLVolumeArchetypeStorageNode()
   this->CenterImage = 0;
   this->SingleFile  = 0;
   this->UseOrientationFromFile = 1;
+  this->WriteImageStatistics = false;
   this->DefaultWriteFileExtension = "nrrd";
 }
 
@@ -76,6 +82,7 @@ void vtkMRMLVolumeArchetypeStorageNode::WriteXML(ostream& of, int nIndent)
   ss << this->UseOrientationFromFile;
   of << " UseOrientationFromFile=\"" << ss.str() << "\"";
   }
+  of << " writeImageStatistics=\"" << (this->WriteImageStatistics ? "true" : "false") << "\"";
   // SingleFile attribute is not written to file. GetNumberOfFileNames()
   // is used to determine if reader should read from single/multiple files.
 }
@@ -105,6 +112,10 @@ void vtkMRMLVolumeArchetypeStorageNode::ReadXMLAttributes(const char** atts)
       ss << attValue;
       ss >> this->UseOrientationFromFile;
       }
+    if (!strcmp(attName, "writeImageStatistics"))
+      {
+      this->WriteImageStatistics = (strcmp(attValue, "true") == 0);
+      }
     }
 
   // SingleFile attribute used to be read from the scene, but often
@@ -129,6 +140,7 @@ void vtkMRMLVolumeArchetypeStorageNode::Copy(vtkMRMLNode *anode)
   this->SetCenterImage(node->CenterImage);
   this->SetSingleFile(node->SingleFile);
   this->SetUseOrientationFromFile(node->UseOrientationFromFile);
+  this->SetWriteImageStatistics(node->WriteImageStatistics);
 
   this->EndModify(disabledModify);
 }
@@ -140,6 +152,7 @@ void vtkMRMLVolumeArchetypeStorageNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "CenterImage:   " << this->CenterImage << "\n";
   os << indent << "SingleFile:   " << this->SingleFile << "\n";
   os << indent << "UseOrientationFromFile:   " << this->UseOrientationFromFile << "\n";
+  os << indent << "WriteImageStatistics:   " << (this->WriteImageStatistics ? "true" : "false") << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -264,6 +277,11 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
     return 1;
     }
 
+  if (vtkITKSharedMemoryImage::IsSharedMemoryFileName(this->GetFileName()))
+    {
+    return this->ReadSharedMemoryImage(refNode);
+    }
+
   std::string fullName = this->GetFullNameFromFileName();
   vtkDebugMacro("ReadData: got full archetype name " << fullName);
 
@@ -461,6 +479,15 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
 
   vtkNew<vtkImageData> iciOutputCopy;
   iciOutputCopy->ShallowCopy(ici->GetOutput());
+
+  // Statistics that are stored in the file header do not have to be computed again
+  std::string imageStatistics;
+  if (itk::ExposeMetaData<std::string>(reader->GetMetaDataDictionary(),
+    vtkMRMLImageStatistics::GetHeaderKey(), imageStatistics))
+    {
+    vtkMRMLImageStatistics::SetImageStatisticsFromHeaderValue(iciOutputCopy.GetPointer(), imageStatistics);
+    }
+
   volNode->SetAndObserveImageData(iciOutputCopy.GetPointer());
 
   // Log volume size to the application log. It helps to identify potential out-of-memory issues.
@@ -485,6 +512,36 @@ int vtkMRMLVolumeArchetypeStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeArchetypeStorageNode::ReadSharedMemoryImage(vtkMRMLNode *refNode)
+{
+  // Only scalar volumes are exchanged with command line modules through shared memory
+  vtkMRMLScalarVolumeNode* volNode = vtkMRMLScalarVolumeNode::SafeDownCast(refNode);
+  if (volNode == nullptr
+    || volNode->IsA("vtkMRMLVectorVolumeNode")
+    || volNode->IsA("vtkMRMLDiffusionTensorVolumeNode"))
+    {
+    vtkErrorMacro("ReadSharedMemoryImage: Reference node is expected to be a scalar volume node");
+    return 0;
+    }
+
+  vtkNew<vtkImageData> imageData;
+  vtkNew<vtkMatrix4x4> ijkToRAS;
+  if (!vtkITKSharedMemoryImage::ReadImage(this->GetFileName(), imageData.GetPointer(), ijkToRAS.GetPointer()))
+    {
+    vtkErrorMacro("ReadSharedMemoryImage: Cannot read shared memory image: " << this->GetFileName());
+    return 0;
+    }
+  if (imageData->GetNumberOfScalarComponents() != 1)
+    {
+    vtkErrorMacro("ReadSharedMemoryImage: Not a scalar volume: " << this->GetFileName());
+    return 0;
+    }
+  volNode->SetAndObserveImageData(imageData.GetPointer());
+  volNode->SetIJKToRASMatrix(ijkToRAS.GetPointer());
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 {
@@ -596,6 +653,7 @@ int vtkMRMLVolumeArchetypeStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
     vtkNew<vtkMatrix4x4> mat;
     volNode->GetRASToIJKMatrix(mat.GetPointer());
     writer->SetRasToIJKMatrix(mat.GetPointer());
+    this->SetImageStatisticsToWriter(volNode, writer.GetPointer());
 
     try
       {
@@ -726,6 +784,7 @@ std::string vtkMRMLVolumeArchetypeStorageNode::UpdateFileList(vtkMRMLNode *refNo
   vtkNew<vtkMatrix4x4> mat;
   volNode->GetRASToIJKMatrix(mat.GetPointer());
   writer->SetRasToIJKMatrix(mat.GetPointer());
+  this->SetImageStatisticsToWriter(volNode, writer.GetPointer());
 
   try
     {
@@ -901,6 +960,21 @@ void vtkMRMLVolumeArchetypeStorageNode::ConfigureForDataExchange()
   this->UseCompressionOff();
 }
 
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeArchetypeStorageNode::SetImageStatisticsToWriter(vtkMRMLVolumeNode* volNode, vtkITKImageWriter* writer)
+{
+  if (!this->WriteImageStatistics || !volNode->GetImageData()
+    || volNode->GetImageData()->GetNumberOfScalarComponents() != 1)
+    {
+    return;
+    }
+  vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::GetImageStatistics(volNode->GetImageData());
+  if (statistics)
+    {
+    writer->SetAttribute(vtkMRMLImageStatistics::GetHeaderKey(), statistics->GetHeaderValue());
+    }
+}
+
 //----------------------------------------------------------------------------
 void vtkMRMLVolumeArchetypeStorageNode::SetMetaDataDictionaryFromReader(vtkMRMLVolumeNode *volNode, vtkITKArchetypeImageSeriesReader *reader)
 {
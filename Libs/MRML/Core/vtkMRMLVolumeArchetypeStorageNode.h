@@ -19,6 +19,7 @@
 
 class vtkImageData;
 class vtkITKArchetypeImageSeriesReader;
+class vtkITKImageWriter;
 class vtkMRMLVolumeNode;
 
 /// \brief MRML node for representing a volume storage.
@@ -73,6 +74,16 @@ public:
   vtkSetMacro(UseOrientationFromFile, int);
   vtkGetMacro(UseOrientationFromFile, int);
 
+  ///
+  /// Store intensity statistics of scalar volumes in the file header on write,
+  /// so that they are not computed again when the volume is loaded.
+  /// Statistics are only stored in file formats that support custom header fields (such as NRRD).
+  /// Disabled by default.
+  /// \sa vtkMRMLImageStatistics
+  vtkSetMacro(WriteImageStatistics, bool);
+  vtkGetMacro(WriteImageStatistics, bool);
+  vtkBooleanMacro(WriteImageStatistics, bool);
+
   /// Return true if the reference node is supported by the storage node
   bool CanReadInReferenceNode(vtkMRMLNode* refNode) override;
   bool CanWriteFromReferenceNode(vtkMRMLNode* refNode) override;
@@ -104,12 +115,20 @@ protected:
   /// Read data and set it in the referenced node
   int ReadDataInternal(vtkMRMLNode *refNode) override;
 
+  /// Read a scalar volume that a command line module wrote into shared memory
+  /// (file name starting with "shm:/", see vtkITKSharedMemoryImage).
+  int ReadSharedMemoryImage(vtkMRMLNode *refNode);
+
   /// Write data from a referenced node
   int WriteDataInternal(vtkMRMLNode *refNode) override;
 
+  /// Add image statistics to the writer if WriteImageStatistics is enabled
+  void SetImageStatisticsToWriter(vtkMRMLVolumeNode* volNode, vtkITKImageWriter* writer);
+
   int CenterImage;
   int SingleFile;
   int UseOrientationFromFile;
+  bool WriteImageStatistics;
 
 };
 
@@ -23,6 +23,7 @@ Version:   $Revision: 1.14 $
 #include <vtkAppendPolyData.h>
 #include <vtkBoundingBox.h>
 #include <vtkCallbackCommand.h>
+#include <vtkDataArray.h>
 #include <vtkEventForwarderCommand.h>
 #include <vtkGeneralTransform.h>
 #include <vtkHomogeneousTransform.h>
@@ -32,11 +33,12 @@ Version:   $Revision: 1.14 $
 #include <vtkMathUtilities.h>
 #include <vtkMatrix4x4.h>
 #include <vtkNew.h>
+#include <vtkPointData.h>
 #include <vtkSmartPointer.h>
 #include <vtkTransform.h>
 #include <vtkTrivialProducer.h>
 
-#include <algorithm> // For std::min
+#include <algorithm> // For std::min, std::max, std::copy
 #include <cassert>
 #include <vector>
 
@@ -754,6 +756,7 @@ void vtkMRMLVolumeNode
     this->ImageDataConnection->GetProducer() : nullptr;
 
   this->ImageDataConnection = newImageDataConnection;
+  this->ImageDataModifiedExtents.clear();
 
   vtkAlgorithm* imageDataAlgorithm = this->ImageDataConnection ?
     this->ImageDataConnection->GetProducer() : nullptr;
@@ -1080,6 +1083,81 @@ void vtkMRMLVolumeNode::ApplyNonLinearTransform(vtkAbstractTransform* transform)
   this->EndModify(wasModified);
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLVolumeNode::ImageDataExtentModified(const int extent[6])
+{
+  // Number of modifications kept, older ones require a full update
+  const size_t maximumNumberOfModifiedExtents = 32;
+
+  vtkImageData* imageData = this->GetImageData();
+  if (!imageData)
+    {
+    return;
+    }
+  ImageDataModifiedExtentType modifiedExtent;
+  modifiedExtent.PreviousMTime = imageData->GetMTime();
+  std::copy(extent, extent + 6, modifiedExtent.Extent);
+  // Modifications done without ImageDataExtentModified() break the history
+  if (!this->ImageDataModifiedExtents.empty() &&
+      this->ImageDataModifiedExtents.back().MTime != modifiedExtent.PreviousMTime)
+    {
+    this->ImageDataModifiedExtents.clear();
+    }
+  // Scalars are modified too, for the scalar range to be recomputed
+  if (imageData->GetPointData()->GetScalars())
+    {
+    imageData->GetPointData()->GetScalars()->Modified();
+    }
+  imageData->Modified();
+  modifiedExtent.MTime = imageData->GetMTime();
+  this->ImageDataModifiedExtents.push_back(modifiedExtent);
+  if (this->ImageDataModifiedExtents.size() > maximumNumberOfModifiedExtents)
+    {
+    this->ImageDataModifiedExtents.pop_front();
+    }
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLVolumeNode::GetImageDataModifiedExtentSince(vtkMTimeType time, int extent[6])
+{
+  extent[0] = extent[2] = extent[4] = 0;
+  extent[1] = extent[3] = extent[5] = -1;
+  vtkImageData* imageData = this->GetImageData();
+  if (!imageData || this->ImageDataModifiedExtents.empty() ||
+      this->ImageDataModifiedExtents.back().MTime != imageData->GetMTime())
+    {
+    return false;
+    }
+  std::deque<ImageDataModifiedExtentType>::const_reverse_iterator it;
+  for (it = this->ImageDataModifiedExtents.rbegin(); it != this->ImageDataModifiedExtents.rend(); ++it)
+    {
+    if (it->MTime <= time)
+      {
+      return true;
+      }
+    bool emptyModifiedExtent = (it->Extent[0] > it->Extent[1] ||
+      it->Extent[2] > it->Extent[3] || it->Extent[4] > it->Extent[5]);
+    for (int i = 0; i < 3 && !emptyModifiedExtent; ++i)
+      {
+      if (extent[2*i] > extent[2*i+1])
+        {
+        extent[2*i] = it->Extent[2*i];
+        extent[2*i+1] = it->Extent[2*i+1];
+        }
+      else
+        {
+        extent[2*i] = std::min(extent[2*i], it->Extent[2*i]);
+        extent[2*i+1] = std::max(extent[2*i+1], it->Extent[2*i+1]);
+        }
+      }
+    if (it->PreviousMTime <= time)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLVolumeNode::ShiftImageDataExtentToZeroStart()
 {
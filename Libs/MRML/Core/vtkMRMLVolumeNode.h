@@ -28,6 +28,9 @@ class vtkMatrix4x4;
 // ITK includes
 #include "itkMetaDataDictionary.h"
 
+// STD includes
+#include <deque>
+
 /// \brief MRML node for representing a volume (image stack).
 ///
 /// Volume nodes describe data sets that can be thought of as stacks of 2D
@@ -185,6 +188,21 @@ public:
   /// (0,dim[0],0,dim[1],0,dim[2]), which is not the case many times for segmentation merged labelmaps.
   void ShiftImageDataExtentToZeroStart();
 
+  /// Notify that the voxels of the image data within \a extent have been
+  /// modified in place. It calls Modified() on the image data and its scalars
+  /// and records the extent so that consumers (e.g. slice views) can update only the modified
+  /// region. Use it instead of GetImageData()->Modified() after editing a few
+  /// voxels (e.g. painting in a labelmap).
+  /// \sa GetImageDataModifiedExtentSince()
+  void ImageDataExtentModified(const int extent[6]);
+
+  /// Get the extent of the voxels modified since the image data had the
+  /// modification time \a time. Returns false if the modified region is
+  /// unknown (the image data was modified without ImageDataExtentModified()
+  /// or the modification is older than the recorded history).
+  /// The extent is empty (extent[0] > extent[1]) if nothing changed.
+  bool GetImageDataModifiedExtentSince(vtkMTimeType time, int extent[6]);
+
   ///
   /// alternative method to propagate events generated in Display nodes
   void ProcessMRMLEvents ( vtkObject * /*caller*/,
@@ -258,6 +276,17 @@ protected:
   vtkAlgorithmOutput* ImageDataConnection;
   vtkEventForwarderCommand* DataEventForwarder;
 
+  /// Modification of the image data recorded by ImageDataExtentModified():
+  /// voxels in Extent changed when the image MTime went from PreviousMTime
+  /// to MTime.
+  struct ImageDataModifiedExtentType
+    {
+    vtkMTimeType PreviousMTime;
+    vtkMTimeType MTime;
+    int Extent[6];
+    };
+  std::deque<ImageDataModifiedExtentType> ImageDataModifiedExtents;
+
   itk::MetaDataDictionary Dictionary;
 };
 
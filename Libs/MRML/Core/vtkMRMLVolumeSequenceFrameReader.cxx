@@ -0,0 +1,446 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "vtkMRMLVolumeSequenceFrameReader.h"
+
+// vtkTeem includes
+#include "vtkTeemNRRDReader.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageExtractComponents.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+/// Location and layout of the frames in a volume sequence file
+struct FrameLayout
+{
+  std::string FileName;
+  /// File that contains the raw voxels, empty if the voxels are compressed
+  std::string RawDataFileName;
+  vtkTypeInt64 RawDataOffset{-1};
+  int Dimensions[3]{0, 0, 0};
+  int ScalarType{VTK_VOID};
+  /// Frames are stored as scalar components
+  int NumberOfFrames{0};
+  /// Voxels of a frame are stored contiguously, instead of interleaved with the other frames
+  bool FramesContiguous{false};
+};
+
+//----------------------------------------------------------------------------
+bool ReadFrameLayout(const std::string& fileName, FrameLayout& layout)
+{
+  std::lock_guard<std::mutex> teemLock(vtkMRMLVolumeSequenceFrameReader::GetTeemMutex());
+  vtkNew<vtkTeemNRRDReader> reader;
+  if (!reader->CanReadFile(fileName.c_str()))
+    {
+    return false;
+    }
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+  if (reader->GetReadStatus() != 0 || reader->GetNumberOfComponents() < 1)
+    {
+    return false;
+    }
+  layout.FileName = fileName;
+  layout.RawDataFileName = reader->GetRawDataFileName();
+  layout.RawDataOffset = reader->GetRawDataOffset();
+  int* extent = reader->GetDataExtent();
+  for (int i = 0; i < 3; ++i)
+    {
+    layout.Dimensions[i] = extent[i * 2 + 1] - extent[i * 2] + 1;
+    }
+  layout.ScalarType = reader->GetDataScalarType();
+  layout.NumberOfFrames = reader->GetNumberOfComponents();
+  layout.FramesContiguous = (layout.NumberOfFrames == 1 || reader->GetRawDataComponentsOutermost());
+  return true;
+}
+
+//----------------------------------------------------------------------------
+/// Read the voxels of a single frame from a raw data file that stores the frames one after the other
+bool ReadRawFrame(const FrameLayout& layout, int frameIndex, vtkImageData* frameVoxels)
+{
+  std::ifstream dataFile(layout.RawDataFileName.c_str(), std::ios::in | std::ios::binary);
+  if (!dataFile)
+    {
+    return false;
+    }
+  vtkNew<vtkImageData> voxels;
+  voxels->SetDimensions(layout.Dimensions);
+  voxels->AllocateScalars(layout.ScalarType, 1);
+  vtkTypeInt64 frameSize = voxels->GetScalarSize() * voxels->GetNumberOfPoints();
+  dataFile.seekg(layout.RawDataOffset + frameIndex * frameSize, std::ios::beg);
+  dataFile.read(static_cast<char*>(voxels->GetScalarPointer()), frameSize);
+  if (dataFile.gcount() != frameSize)
+    {
+    return false;
+    }
+  frameVoxels->ShallowCopy(voxels.GetPointer());
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+class vtkMRMLVolumeSequenceFrameReader::vtkInternal
+{
+public:
+  std::mutex Mutex;
+  /// Notified when prefetch requests are added or the threads have to stop
+  std::condition_variable PrefetchRequested;
+  /// Notified when a frame is decoded by a prefetch thread
+  std::condition_variable FrameDecoded;
+
+  std::string FileName;
+  std::deque<int> PendingFrameIndices;
+  std::set<int> FramesInProgress;
+  std::map<int, vtkSmartPointer<vtkImageData> > PrefetchedFrames;
+  /// Prefetched frame indices, in the order of decoding
+  std::deque<int> PrefetchedFrameOrder;
+
+  std::vector<std::thread> PrefetchThreads;
+  bool StopPrefetchThreads{false};
+
+  std::atomic<int> NumberOfDecodedFrames{0};
+
+  /// Layout of the most recently used file
+  FrameLayout Layout;
+
+  /// Get the layout of the frames in the file, read its header if needed
+  bool GetFrameLayout(const std::string& fileName, FrameLayout& layout)
+    {
+    {
+      std::lock_guard<std::mutex> lock(this->Mutex);
+      if (!fileName.empty() && this->Layout.FileName == fileName)
+        {
+        layout = this->Layout;
+        return true;
+        }
+    }
+    if (fileName.empty() || !ReadFrameLayout(fileName, layout))
+      {
+      return false;
+      }
+    std::lock_guard<std::mutex> lock(this->Mutex);
+    this->Layout = layout;
+    return true;
+    }
+
+  void RemovePrefetchedFrame(int frameIndex)
+    {
+    this->PrefetchedFrames.erase(frameIndex);
+    std::deque<int>::iterator orderIt = std::find(this->PrefetchedFrameOrder.begin(), this->PrefetchedFrameOrder.end(), frameIndex);
+    if (orderIt != this->PrefetchedFrameOrder.end())
+      {
+      this->PrefetchedFrameOrder.erase(orderIt);
+      }
+    }
+};
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLVolumeSequenceFrameReader);
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSequenceFrameReader::vtkMRMLVolumeSequenceFrameReader()
+{
+  this->Internal = new vtkInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSequenceFrameReader::~vtkMRMLVolumeSequenceFrameReader()
+{
+  this->StopPrefetchThreads();
+  delete this->Internal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceFrameReader::StopPrefetchThreads()
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    this->Internal->StopPrefetchThreads = true;
+    this->Internal->PendingFrameIndices.clear();
+  }
+  this->Internal->PrefetchRequested.notify_all();
+  for (std::thread& prefetchThread : this->Internal->PrefetchThreads)
+    {
+    if (prefetchThread.joinable())
+      {
+      prefetchThread.join();
+      }
+    }
+  this->Internal->PrefetchThreads.clear();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceFrameReader::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "FileName: " << this->GetFileName() << "\n";
+  os << indent << "MaximumNumberOfPrefetchedFrames: " << this->MaximumNumberOfPrefetchedFrames << "\n";
+  os << indent << "NumberOfPrefetchThreads: " << this->NumberOfPrefetchThreads << "\n";
+  os << indent << "NumberOfPrefetchedFrames: " << this->GetNumberOfPrefetchedFrames() << "\n";
+  os << indent << "NumberOfDecodedFrames: " << this->GetNumberOfDecodedFrames() << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceFrameReader::SetFileName(const std::string& fileName)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    if (this->Internal->FileName == fileName)
+      {
+      return;
+      }
+    this->Internal->FileName = fileName;
+  }
+  this->ClearPrefetchedFrames();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLVolumeSequenceFrameReader::GetFileName()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->FileName;
+}
+
+//----------------------------------------------------------------------------
+std::mutex& vtkMRMLVolumeSequenceFrameReader::GetTeemMutex()
+{
+  static std::mutex teemMutex;
+  return teemMutex;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceFrameReader::CanReadFramesIndividually()
+{
+  FrameLayout layout;
+  if (!this->Internal->GetFrameLayout(this->GetFileName(), layout))
+    {
+    return false;
+    }
+  return !layout.RawDataFileName.empty() && layout.RawDataOffset >= 0 && layout.FramesContiguous;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceFrameReader::GetNumberOfFrames()
+{
+  FrameLayout layout;
+  if (!this->Internal->GetFrameLayout(this->GetFileName(), layout))
+    {
+    return 0;
+    }
+  return layout.NumberOfFrames;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceFrameReader::ReadFrame(int frameIndex, vtkImageData* frameVoxels)
+{
+  if (!frameVoxels)
+    {
+    vtkErrorMacro("ReadFrame failed: invalid output image");
+    return false;
+    }
+  std::string fileName;
+  {
+    std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+    // Do not decode the frame twice if a prefetch thread is already working on it
+    this->Internal->FrameDecoded.wait(lock, [this, frameIndex]
+      { return this->Internal->FramesInProgress.find(frameIndex) == this->Internal->FramesInProgress.end(); });
+    std::map<int, vtkSmartPointer<vtkImageData> >::iterator prefetchedFrameIt = this->Internal->PrefetchedFrames.find(frameIndex);
+    if (prefetchedFrameIt != this->Internal->PrefetchedFrames.end())
+      {
+      frameVoxels->ShallowCopy(prefetchedFrameIt->second);
+      this->Internal->RemovePrefetchedFrame(frameIndex);
+      return true;
+      }
+    std::deque<int>::iterator pendingIt = std::find(this->Internal->PendingFrameIndices.begin(),
+      this->Internal->PendingFrameIndices.end(), frameIndex);
+    if (pendingIt != this->Internal->PendingFrameIndices.end())
+      {
+      this->Internal->PendingFrameIndices.erase(pendingIt);
+      }
+    fileName = this->Internal->FileName;
+  }
+  if (!this->DecodeFrame(fileName, frameIndex, frameVoxels))
+    {
+    vtkErrorMacro("ReadFrame failed: cannot read frame " << frameIndex << " from file " << fileName);
+    return false;
+    }
+  this->Internal->NumberOfDecodedFrames++;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceFrameReader::Prefetch(const std::vector<int>& frameIndices)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+    this->Internal->PendingFrameIndices.clear();
+    if (this->Internal->StopPrefetchThreads)
+      {
+      // the reader is being destroyed
+      return;
+      }
+    for (int frameIndex : frameIndices)
+      {
+      if (this->Internal->PrefetchedFrames.find(frameIndex) != this->Internal->PrefetchedFrames.end()
+        || this->Internal->FramesInProgress.find(frameIndex) != this->Internal->FramesInProgress.end()
+        || std::find(this->Internal->PendingFrameIndices.begin(), this->Internal->PendingFrameIndices.end(), frameIndex)
+          != this->Internal->PendingFrameIndices.end())
+        {
+        continue;
+        }
+      this->Internal->PendingFrameIndices.push_back(frameIndex);
+      }
+    if (this->Internal->PendingFrameIndices.empty())
+      {
+      return;
+      }
+    if (this->Internal->PrefetchThreads.empty())
+      {
+      int numberOfThreads = std::max(1, this->NumberOfPrefetchThreads);
+      for (int threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+        {
+        this->Internal->PrefetchThreads.emplace_back(&vtkMRMLVolumeSequenceFrameReader::ProcessPrefetchRequests, this);
+        }
+      }
+  }
+  this->Internal->PrefetchRequested.notify_all();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceFrameReader::ClearPrefetchedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  this->Internal->PendingFrameIndices.clear();
+  this->Internal->PrefetchedFrames.clear();
+  this->Internal->PrefetchedFrameOrder.clear();
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceFrameReader::IsFramePrefetched(int frameIndex)
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return this->Internal->PrefetchedFrames.find(frameIndex) != this->Internal->PrefetchedFrames.end();
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceFrameReader::GetNumberOfPrefetchedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+  return static_cast<int>(this->Internal->PrefetchedFrames.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceFrameReader::GetNumberOfDecodedFrames()
+{
+  return this->Internal->NumberOfDecodedFrames;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceFrameReader::ProcessPrefetchRequests()
+{
+  for (;;)
+    {
+    int frameIndex = -1;
+    std::string fileName;
+    {
+      std::unique_lock<std::mutex> lock(this->Internal->Mutex);
+      this->Internal->PrefetchRequested.wait(lock, [this]
+        { return this->Internal->StopPrefetchThreads || !this->Internal->PendingFrameIndices.empty(); });
+      if (this->Internal->StopPrefetchThreads)
+        {
+        return;
+        }
+      frameIndex = this->Internal->PendingFrameIndices.front();
+      this->Internal->PendingFrameIndices.pop_front();
+      this->Internal->FramesInProgress.insert(frameIndex);
+      fileName = this->Internal->FileName;
+    }
+
+    vtkSmartPointer<vtkImageData> frameVoxels = vtkSmartPointer<vtkImageData>::New();
+    bool success = this->DecodeFrame(fileName, frameIndex, frameVoxels);
+    if (success)
+      {
+      this->Internal->NumberOfDecodedFrames++;
+      }
+
+    {
+      std::lock_guard<std::mutex> lock(this->Internal->Mutex);
+      this->Internal->FramesInProgress.erase(frameIndex);
+      // Frames of a previous file are not kept
+      if (success && fileName == this->Internal->FileName)
+        {
+        this->Internal->RemovePrefetchedFrame(frameIndex);
+        this->Internal->PrefetchedFrames[frameIndex] = frameVoxels;
+        this->Internal->PrefetchedFrameOrder.push_back(frameIndex);
+        int maximumNumberOfPrefetchedFrames = std::max(1, this->MaximumNumberOfPrefetchedFrames);
+        while (static_cast<int>(this->Internal->PrefetchedFrameOrder.size()) > maximumNumberOfPrefetchedFrames)
+          {
+          this->Internal->RemovePrefetchedFrame(this->Internal->PrefetchedFrameOrder.front());
+          }
+        }
+    }
+    this->Internal->FrameDecoded.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceFrameReader::DecodeFrame(const std::string& fileName, int frameIndex, vtkImageData* frameVoxels)
+{
+  FrameLayout layout;
+  if (!this->Internal->GetFrameLayout(fileName, layout)
+    || frameIndex < 0 || frameIndex >= layout.NumberOfFrames)
+    {
+    return false;
+    }
+  if (!layout.RawDataFileName.empty() && layout.RawDataOffset >= 0 && layout.FramesContiguous)
+    {
+    // Raw voxels are read without teem, frames can be read in multiple threads at once
+    return ReadRawFrame(layout, frameIndex, frameVoxels);
+    }
+
+  // Compressed or interleaved voxels have to be decoded by teem, the whole file is decoded
+  std::lock_guard<std::mutex> teemLock(this->GetTeemMutex());
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  vtkNew<vtkImageExtractComponents> extractComponents;
+  extractComponents->SetInputConnection(reader->GetOutputPort());
+  extractComponents->SetComponents(frameIndex);
+  extractComponents->Update();
+  vtkImageData* decodedVoxels = extractComponents->GetOutput();
+  if (!decodedVoxels || !decodedVoxels->GetPointData() || !decodedVoxels->GetPointData()->GetScalars())
+    {
+    return false;
+    }
+  frameVoxels->ShallowCopy(decodedVoxels);
+  // Slicer expects normalized image position and spacing
+  frameVoxels->SetOrigin(0, 0, 0);
+  frameVoxels->SetSpacing(1, 1, 1);
+  return true;
+}
@@ -0,0 +1,129 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLVolumeSequenceFrameReader_h
+#define __vtkMRMLVolumeSequenceFrameReader_h
+
+#include "vtkMRML.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <mutex>
+#include <string>
+#include <vector>
+
+class vtkImageData;
+
+/// \brief Reads the voxels of individual frames of a volume sequence file.
+///
+/// Frames are decoded on demand by ReadFrame(), which allows a sequence node to
+/// keep only the recently used frames in memory.
+/// Prefetch() starts decoding frames in background threads. Decoded frames are kept
+/// until ReadFrame() retrieves them, at most MaximumNumberOfPrefetchedFrames of them.
+///
+/// By default frames are read from a NRRD file. If the file stores raw (uncompressed)
+/// voxels with the frame axis outermost then the voxels of the requested frame are
+/// read directly from their position in the file.
+/// Compressed files and files that interleave the frames have to be decoded as a whole
+/// for each frame.
+/// Subclasses may override DecodeFrame() to read other formats.
+/// \sa vtkMRMLSequenceNode::SetPagedDataNodeAtValue
+class VTK_MRML_EXPORT vtkMRMLVolumeSequenceFrameReader : public vtkObject
+{
+public:
+  static vtkMRMLVolumeSequenceFrameReader *New();
+  vtkTypeMacro(vtkMRMLVolumeSequenceFrameReader,vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Name of the volume sequence file.
+  /// Changing the file name removes the prefetched frames.
+  void SetFileName(const std::string& fileName);
+  std::string GetFileName();
+
+  /// Return true if a frame can be read without decoding the whole file,
+  /// which is the case for raw voxels stored in the machine byte order,
+  /// with the voxels of each frame stored contiguously.
+  /// Reads the file header if it is not read yet.
+  bool CanReadFramesIndividually();
+
+  /// Number of frames in the file. Reads the file header if it is not read yet.
+  /// Returns 0 if the header cannot be read.
+  int GetNumberOfFrames();
+
+  /// Get the voxels of a frame. Image origin is (0,0,0) and spacing is (1,1,1),
+  /// the geometry is stored in the volume node.
+  /// Prefetched frames are returned without decoding them again.
+  /// If the frame is being prefetched then the method waits for it.
+  /// Returns false if the frame could not be read.
+  bool ReadFrame(int frameIndex, vtkImageData* frameVoxels);
+
+  /// Decode frames in background threads, in the specified order.
+  /// Frames that are already prefetched or being decoded are skipped.
+  /// Prefetch requests from a previous call that are not started yet are discarded.
+  void Prefetch(const std::vector<int>& frameIndices);
+
+  /// Discard prefetch requests and remove prefetched frames.
+  /// Frames that are being decoded are removed when they are completed.
+  void ClearPrefetchedFrames();
+
+  /// Return true if the frame is decoded and waiting to be retrieved by ReadFrame()
+  bool IsFramePrefetched(int frameIndex);
+
+  /// Number of decoded frames that are waiting to be retrieved by ReadFrame()
+  int GetNumberOfPrefetchedFrames();
+
+  /// Maximum number of prefetched frames. When the limit is exceeded then the
+  /// least recently prefetched frames are removed.
+  /// Default is 8.
+  vtkSetMacro(MaximumNumberOfPrefetchedFrames, int);
+  vtkGetMacro(MaximumNumberOfPrefetchedFrames, int);
+
+  /// Number of threads decoding prefetched frames.
+  /// Threads are started at the first Prefetch() call, later changes have no effect.
+  /// Default is 2.
+  vtkSetMacro(NumberOfPrefetchThreads, int);
+  vtkGetMacro(NumberOfPrefetchThreads, int);
+
+  /// Total number of frames that have been decoded (in the calling thread or in background threads)
+  int GetNumberOfDecodedFrames();
+
+  /// Teem reports errors through a global (biff) state, which is not thread-safe.
+  /// NRRD readers and writers that may run in background threads must lock this mutex.
+  static std::mutex& GetTeemMutex();
+
+protected:
+  vtkMRMLVolumeSequenceFrameReader();
+  ~vtkMRMLVolumeSequenceFrameReader() override;
+
+  /// Read a frame from the file. It is called from multiple threads at once.
+  /// Must not modify the reader or invoke events.
+  virtual bool DecodeFrame(const std::string& fileName, int frameIndex, vtkImageData* frameVoxels);
+
+  /// Decode frames of the prefetch queue, until the reader is destroyed
+  void ProcessPrefetchRequests();
+
+  /// Discard pending prefetch requests and wait for the prefetch threads to exit.
+  /// Subclasses that override DecodeFrame must call it in their destructor,
+  /// before the state used by DecodeFrame is deleted.
+  void StopPrefetchThreads();
+
+  int MaximumNumberOfPrefetchedFrames{8};
+  int NumberOfPrefetchThreads{2};
+
+private:
+  vtkMRMLVolumeSequenceFrameReader(const vtkMRMLVolumeSequenceFrameReader&) = delete;
+  void operator=(const vtkMRMLVolumeSequenceFrameReader&) = delete;
+
+  class vtkInternal;
+  vtkInternal* Internal;
+};
+
+#endif
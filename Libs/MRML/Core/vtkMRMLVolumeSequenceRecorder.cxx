@@ -0,0 +1,286 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#include "vtkMRMLVolumeSequenceRecorder.h"
+
+// vtkTeem includes
+#include "vtkTeemNRRDWriter.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+//----------------------------------------------------------------------------
+class vtkMRMLVolumeSequenceRecorder::vtkRecorderInternal
+{
+public:
+  struct PendingFrame
+    {
+    vtkSmartPointer<vtkImageData> Voxels;
+    double AddedTimeSec{0.0};
+    };
+
+  std::mutex Mutex;
+  /// Notified when a frame is added or the thread has to stop
+  std::condition_variable FrameAdded;
+  /// Notified when a frame is written
+  std::condition_variable FrameWritten;
+
+  /// Frames that are not written yet, by frame index
+  std::map<int, PendingFrame> PendingFrames;
+  /// Frame indices in the order of writing
+  std::deque<int> PendingFrameIndices;
+  int NextFrameIndex{0};
+
+  std::thread WriterThread;
+  bool StopWriterThread{false};
+
+  int NumberOfWrittenFrames{0};
+  int NumberOfDroppedFrames{0};
+  int NumberOfFailedFrames{0};
+  double TotalLatencySec{0.0};
+  double MaximumLatencySec{0.0};
+};
+
+//----------------------------------------------------------------------------
+vtkStandardNewMacro(vtkMRMLVolumeSequenceRecorder);
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSequenceRecorder::vtkMRMLVolumeSequenceRecorder()
+{
+  this->RecorderInternal = new vtkRecorderInternal;
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeSequenceRecorder::~vtkMRMLVolumeSequenceRecorder()
+{
+  // Prefetch threads call DecodeFrame, which uses the recorder state
+  this->StopPrefetchThreads();
+
+  // Queued frames are written before the recorder is destroyed
+  {
+    std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+    this->RecorderInternal->StopWriterThread = true;
+  }
+  this->RecorderInternal->FrameAdded.notify_all();
+  if (this->RecorderInternal->WriterThread.joinable())
+    {
+    this->RecorderInternal->WriterThread.join();
+    }
+  delete this->RecorderInternal;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceRecorder::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+  os << indent << "MaximumNumberOfPendingFrames: " << this->MaximumNumberOfPendingFrames << "\n";
+  os << indent << "UseCompression: " << (this->UseCompression ? "true" : "false") << "\n";
+  os << indent << "NumberOfPendingFrames: " << this->GetNumberOfPendingFrames() << "\n";
+  os << indent << "NumberOfWrittenFrames: " << this->GetNumberOfWrittenFrames() << "\n";
+  os << indent << "NumberOfDroppedFrames: " << this->GetNumberOfDroppedFrames() << "\n";
+  os << indent << "NumberOfFailedFrames: " << this->GetNumberOfFailedFrames() << "\n";
+  os << indent << "AverageLatencySec: " << this->GetAverageLatencySec() << "\n";
+  os << indent << "MaximumLatencySec: " << this->GetMaximumLatencySec() << "\n";
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceRecorder::AddFrame(vtkImageData* frameVoxels)
+{
+  if (!frameVoxels)
+    {
+    vtkErrorMacro("AddFrame failed: invalid image");
+    return -1;
+    }
+  int frameIndex = -1;
+  {
+    std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+    if (static_cast<int>(this->RecorderInternal->PendingFrameIndices.size()) >= std::max(1, this->MaximumNumberOfPendingFrames))
+      {
+      this->RecorderInternal->NumberOfDroppedFrames++;
+      return -1;
+      }
+    frameIndex = this->RecorderInternal->NextFrameIndex++;
+    vtkRecorderInternal::PendingFrame& pendingFrame = this->RecorderInternal->PendingFrames[frameIndex];
+    // The caller may modify its image after the frame is added
+    pendingFrame.Voxels = vtkSmartPointer<vtkImageData>::New();
+    pendingFrame.Voxels->DeepCopy(frameVoxels);
+    pendingFrame.AddedTimeSec = vtkTimerLog::GetUniversalTime();
+    this->RecorderInternal->PendingFrameIndices.push_back(frameIndex);
+    if (!this->RecorderInternal->WriterThread.joinable())
+      {
+      this->RecorderInternal->WriterThread = std::thread(&vtkMRMLVolumeSequenceRecorder::ProcessPendingFrames, this);
+      }
+  }
+  this->RecorderInternal->FrameAdded.notify_all();
+  return frameIndex;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceRecorder::WaitForPendingFrames()
+{
+  std::unique_lock<std::mutex> lock(this->RecorderInternal->Mutex);
+  this->RecorderInternal->FrameWritten.wait(lock, [this] { return this->RecorderInternal->PendingFrames.empty(); });
+}
+
+//----------------------------------------------------------------------------
+std::string vtkMRMLVolumeSequenceRecorder::GetFrameFileName(int frameIndex)
+{
+  std::ostringstream frameFileName;
+  frameFileName << this->GetFileName() << "_" << std::setfill('0') << std::setw(6) << frameIndex << ".nrrd";
+  return frameFileName.str();
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceRecorder::RemoveFrameFiles()
+{
+  this->WaitForPendingFrames();
+  int numberOfFrames = 0;
+  {
+    std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+    numberOfFrames = this->RecorderInternal->NextFrameIndex;
+  }
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    std::string frameFileName = this->GetFrameFileName(frameIndex);
+    if (vtksys::SystemTools::FileExists(frameFileName.c_str(), true))
+      {
+      vtksys::SystemTools::RemoveFile(frameFileName.c_str());
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceRecorder::GetNumberOfPendingFrames()
+{
+  std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+  return static_cast<int>(this->RecorderInternal->PendingFrames.size());
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceRecorder::GetNumberOfWrittenFrames()
+{
+  std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+  return this->RecorderInternal->NumberOfWrittenFrames;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceRecorder::GetNumberOfDroppedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+  return this->RecorderInternal->NumberOfDroppedFrames;
+}
+
+//----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceRecorder::GetNumberOfFailedFrames()
+{
+  std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+  return this->RecorderInternal->NumberOfFailedFrames;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLVolumeSequenceRecorder::GetAverageLatencySec()
+{
+  std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+  int numberOfCompletedFrames = this->RecorderInternal->NumberOfWrittenFrames + this->RecorderInternal->NumberOfFailedFrames;
+  if (numberOfCompletedFrames == 0)
+    {
+    return 0.0;
+    }
+  return this->RecorderInternal->TotalLatencySec / numberOfCompletedFrames;
+}
+
+//----------------------------------------------------------------------------
+double vtkMRMLVolumeSequenceRecorder::GetMaximumLatencySec()
+{
+  std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+  return this->RecorderInternal->MaximumLatencySec;
+}
+
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceRecorder::ProcessPendingFrames()
+{
+  for (;;)
+    {
+    int frameIndex = -1;
+    vtkRecorderInternal::PendingFrame pendingFrame;
+    {
+      std::unique_lock<std::mutex> lock(this->RecorderInternal->Mutex);
+      this->RecorderInternal->FrameAdded.wait(lock, [this]
+        { return this->RecorderInternal->StopWriterThread || !this->RecorderInternal->PendingFrameIndices.empty(); });
+      if (this->RecorderInternal->PendingFrameIndices.empty())
+        {
+        // stop was requested and all frames are written
+        return;
+        }
+      frameIndex = this->RecorderInternal->PendingFrameIndices.front();
+      this->RecorderInternal->PendingFrameIndices.pop_front();
+      pendingFrame = this->RecorderInternal->PendingFrames[frameIndex];
+    }
+
+    // The frame stays in the pending frames until the file is complete, so that it can be read meanwhile
+    bool success = false;
+    {
+      std::lock_guard<std::mutex> teemLock(this->GetTeemMutex());
+      vtkNew<vtkTeemNRRDWriter> writer;
+      writer->SetFileName(this->GetFrameFileName(frameIndex).c_str());
+      writer->SetInputData(pendingFrame.Voxels);
+      writer->SetUseCompression(this->UseCompression ? 1 : 0);
+      writer->Write();
+      success = (writer->GetWriteError() == 0);
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+      this->RecorderInternal->PendingFrames.erase(frameIndex);
+      if (success)
+        {
+        this->RecorderInternal->NumberOfWrittenFrames++;
+        }
+      else
+        {
+        this->RecorderInternal->NumberOfFailedFrames++;
+        }
+      double latencySec = vtkTimerLog::GetUniversalTime() - pendingFrame.AddedTimeSec;
+      this->RecorderInternal->TotalLatencySec += latencySec;
+      this->RecorderInternal->MaximumLatencySec = std::max(this->RecorderInternal->MaximumLatencySec, latencySec);
+    }
+    this->RecorderInternal->FrameWritten.notify_all();
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLVolumeSequenceRecorder::DecodeFrame(const std::string& vtkNotUsed(fileName), int frameIndex, vtkImageData* frameVoxels)
+{
+  {
+    std::lock_guard<std::mutex> lock(this->RecorderInternal->Mutex);
+    std::map<int, vtkRecorderInternal::PendingFrame>::iterator pendingFrameIt = this->RecorderInternal->PendingFrames.find(frameIndex);
+    if (pendingFrameIt != this->RecorderInternal->PendingFrames.end())
+      {
+      frameVoxels->ShallowCopy(pendingFrameIt->second.Voxels);
+      return true;
+      }
+  }
+  // Written frames are read by the NRRD frame reader, each frame file contains a single frame
+  return this->Superclass::DecodeFrame(this->GetFrameFileName(frameIndex), 0, frameVoxels);
+}
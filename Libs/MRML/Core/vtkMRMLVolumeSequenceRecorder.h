@@ -0,0 +1,99 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+#ifndef __vtkMRMLVolumeSequenceRecorder_h
+#define __vtkMRMLVolumeSequenceRecorder_h
+
+#include "vtkMRMLVolumeSequenceFrameReader.h"
+
+/// \brief Writes recorded volume sequence frames to files in a background thread.
+///
+/// AddFrame() only queues the voxels of the frame, compression and writing to file
+/// is done by a background thread. Each frame is written to a separate file,
+/// named <FileName>_<frameIndex>.nrrd.
+///
+/// The voxels are copied when the frame is added, so the caller may keep updating
+/// its image in place.
+///
+/// If the writer cannot keep up with the recording then frames are dropped, so that
+/// recording never blocks and at most MaximumNumberOfPendingFrames frames are kept in memory.
+///
+/// The recorder is also the frame reader of the recorded sequence: frames that are not
+/// written yet are returned from the queue, other frames are read from their files.
+/// \sa vtkMRMLSequenceBrowserNode::SetRecordingDirectory
+class VTK_MRML_EXPORT vtkMRMLVolumeSequenceRecorder : public vtkMRMLVolumeSequenceFrameReader
+{
+public:
+  static vtkMRMLVolumeSequenceRecorder *New();
+  vtkTypeMacro(vtkMRMLVolumeSequenceRecorder,vtkMRMLVolumeSequenceFrameReader);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Add a frame to the write queue.
+  /// Returns the index of the new frame, or -1 if the frame is dropped because the queue is full.
+  int AddFrame(vtkImageData* frameVoxels);
+
+  /// Wait until all queued frames are written to file.
+  void WaitForPendingFrames();
+
+  /// Name of the file that stores the frame.
+  std::string GetFrameFileName(int frameIndex);
+
+  /// Wait until all queued frames are written and delete the frame files.
+  /// Frames cannot be read from the recorder anymore, therefore it must only be called
+  /// when the frames are stored elsewhere (for example, merged into a volume sequence file).
+  void RemoveFrameFiles();
+
+  /// Maximum number of frames that are waiting to be written.
+  /// Default is 30.
+  vtkSetMacro(MaximumNumberOfPendingFrames, int);
+  vtkGetMacro(MaximumNumberOfPendingFrames, int);
+
+  /// Compress frame files. Enabled by default.
+  vtkSetMacro(UseCompression, bool);
+  vtkGetMacro(UseCompression, bool);
+  vtkBooleanMacro(UseCompression, bool);
+
+  /// Number of frames that are waiting to be written
+  int GetNumberOfPendingFrames();
+
+  /// Number of frames that have been written to file
+  int GetNumberOfWrittenFrames();
+
+  /// Number of frames that were not recorded because the queue was full
+  int GetNumberOfDroppedFrames();
+
+  /// Number of frames that could not be written to file
+  int GetNumberOfFailedFrames();
+
+  /// Average and maximum time between adding a frame and completing its file (in seconds)
+  double GetAverageLatencySec();
+  double GetMaximumLatencySec();
+
+protected:
+  vtkMRMLVolumeSequenceRecorder();
+  ~vtkMRMLVolumeSequenceRecorder() override;
+
+  /// Return queued frames or read the frame from its own file
+  bool DecodeFrame(const std::string& fileName, int frameIndex, vtkImageData* frameVoxels) override;
+
+  /// Write queued frames to file, until the recorder is destroyed
+  void ProcessPendingFrames();
+
+  int MaximumNumberOfPendingFrames{30};
+  bool UseCompression{true};
+
+private:
+  vtkMRMLVolumeSequenceRecorder(const vtkMRMLVolumeSequenceRecorder&) = delete;
+  void operator=(const vtkMRMLVolumeSequenceRecorder&) = delete;
+
+  class vtkRecorderInternal;
+  vtkRecorderInternal* RecorderInternal;
+};
+
+#endif
@@ -14,6 +14,8 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLSequenceNode.h"
 #include "vtkMRMLVectorVolumeNode.h"
+#include "vtkMRMLVolumeSequenceFrameReader.h"
+#include "vtkMRMLVolumeSequenceRecorder.h"
 
 #include "vtkSlicerVersionConfigure.h"
 #include "vtkTeemNRRDReader.h"
@@ -25,6 +27,7 @@ or http://www.slicer.org/copyright/copyright.txt for details.
 #endif
 #include "vtkImageExtractComponents.h"
 #include "vtkNew.h"
+#include "vtkSmartPointer.h"
 #include "vtkStringArray.h"
 #include "vtksys/SystemTools.hxx"
 
@@ -37,6 +40,13 @@ vtkMRMLVolumeSequenceStorageNode::vtkMRMLVolumeSequenceStorageNode() = default;
 //----------------------------------------------------------------------------
 vtkMRMLVolumeSequenceStorageNode::~vtkMRMLVolumeSequenceStorageNode() = default;
 
+//----------------------------------------------------------------------------
+void vtkMRMLVolumeSequenceStorageNode::PrintSelf(ostream& os, vtkIndent indent)
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "ReadFramesOnDemand: " << this->ReadFramesOnDemand << "\n";
+}
+
 //----------------------------------------------------------------------------
 bool vtkMRMLVolumeSequenceStorageNode::CanReadInReferenceNode(vtkMRMLNode *refNode)
 {
@@ -103,7 +113,7 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
   int frameAxis = 0;
   for ( KeyVector::iterator kit = keys.begin(); kit != keys.end(); ++kit)
     {
-#ifdef NRRD_CHUNK_IO_AVAILABLE
+    // Frames are stored along the first axis (interleaved) or the last axis (one after the other)
     if (*kit == "axis 0 index type")
       {
       volSequenceNode->SetIndexTypeFromString(reader->GetHeaderValue((*kit).c_str()));
@@ -123,21 +133,6 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
         // Encode string to make sure there are no spaces in the serialized index value (space is used as separator)
         indexValues.push_back(vtkMRMLNode::URLDecodeString(indexValue.c_str()));
         }
-#else
-    if (*kit == "axis 0 index type")
-      {
-      volSequenceNode->SetIndexTypeFromString(reader->GetHeaderValue((*kit).c_str()));
-      }
-    else if (*kit == "axis 0 index values")
-      {
-      std::string indexValue;
-      for (std::istringstream indexValueList(reader->GetHeaderValue((*kit).c_str()));
-        indexValueList >> indexValue;)
-        {
-        // Encode string to make sure there are no spaces in the serialized index value (space is used as separator)
-        indexValues.push_back(vtkMRMLNode::URLDecodeString(indexValue.c_str()));
-        }
-#endif
       }
     else
       {
@@ -150,12 +145,26 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
   const char* sequenceAxisUnit = reader->GetAxisUnit(frameAxis);
   volSequenceNode->SetIndexUnit(sequenceAxisUnit ? sequenceAxisUnit : "");
 
+  // Voxels of the frames are read when they are requested if a frame can be read
+  // without decoding the whole file (raw voxels), otherwise all the frames are decoded now.
+  bool readFramesOnDemand = false;
+  vtkNew<vtkMRMLVolumeSequenceFrameReader> frameReader;
+  if (this->ReadFramesOnDemand)
+    {
+    frameReader->SetFileName(fullName);
+    readFramesOnDemand = frameReader->CanReadFramesIndividually();
+    }
+
   // Read and copy the data to sequence of volume nodes
 #ifdef NRRD_CHUNK_IO_AVAILABLE
   int numberOfFrames = reader->GetNumberOfImages();
   vtkImageData* imageData = nullptr;
   vtkNew<vtkImageExtractComponents> extractComponents;
-  if (!readAsMultipleImagesOn)
+  if (readFramesOnDemand)
+    {
+    numberOfFrames = frameReader->GetNumberOfFrames();
+    }
+  else if (!readAsMultipleImagesOn)
     {
     reader->Update();
     // Copy image data to sequence of volume nodes
@@ -169,54 +178,70 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     extractComponents->SetInputConnection(reader->GetOutputPort());
     }
 #else
-  reader->Update();
-  // Copy image data to sequence of volume nodes
-  vtkImageData* imageData = reader->GetOutput();
-  if (imageData == nullptr || imageData->GetPointData()==nullptr || imageData->GetPointData()->GetScalars() == nullptr)
+  int numberOfFrames = 0;
+  vtkNew<vtkImageExtractComponents> extractComponents;
+  if (readFramesOnDemand)
     {
-    vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: invalid image data");
-    return 0;
+    numberOfFrames = frameReader->GetNumberOfFrames();
+    }
+  else
+    {
+    reader->Update();
+    // Copy image data to sequence of volume nodes
+    vtkImageData* imageData = reader->GetOutput();
+    if (imageData == nullptr || imageData->GetPointData()==nullptr || imageData->GetPointData()->GetScalars() == nullptr)
+      {
+      vtkErrorMacro("vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: invalid image data");
+      return 0;
+      }
+    numberOfFrames = imageData->GetNumberOfScalarComponents();
+    extractComponents->SetInputConnection(reader->GetOutputPort());
     }
-  int numberOfFrames = imageData->GetNumberOfScalarComponents();
-  vtkNew<vtkImageExtractComponents> extractComponents;
-  extractComponents->SetInputConnection(reader->GetOutputPort());
 #endif
 
+  if (readFramesOnDemand)
+    {
+    volSequenceNode->SetFrameReader(frameReader.GetPointer());
+    }
+
   vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: Starting reading sequence. ");
   for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
     {
-    vtkDebugMacro(<< " reading frame : "<<frameIndex);
-#ifdef NRRD_CHUNK_IO_AVAILABLE
-    vtkImageData *frameVoxels = nullptr;
-    if (readAsMultipleImagesOn)
-      {
-      reader->SetCurrentImageIndex(frameIndex);
-      reader->Update();
-      // It is not necessary to deepcopy imageData here,
-      // because it will be already deepcopied in volSequenceNode->SetDataNodeAtValue.
-      frameVoxels = reader->GetOutput();
-      }
-    else
+    vtkNew<vtkMRMLScalarVolumeNode> frameVolume;
+    if (!readFramesOnDemand)
       {
+      vtkDebugMacro(<< " reading frame : "<<frameIndex);
+#ifdef NRRD_CHUNK_IO_AVAILABLE
+      vtkImageData *frameVoxels = nullptr;
+      if (readAsMultipleImagesOn)
+        {
+        reader->SetCurrentImageIndex(frameIndex);
+        reader->Update();
+        // It is not necessary to deepcopy imageData here,
+        // because it will be already deepcopied in volSequenceNode->SetDataNodeAtValue.
+        frameVoxels = reader->GetOutput();
+        }
+      else
+        {
+        extractComponents->SetComponents(frameIndex);
+        extractComponents->Update();
+        frameVoxels = extractComponents->GetOutput();
+        }
+#else
       extractComponents->SetComponents(frameIndex);
       extractComponents->Update();
-      frameVoxels = extractComponents->GetOutput();
-      }
-#else
-    extractComponents->SetComponents(frameIndex);
-    extractComponents->Update();
-    vtkNew<vtkImageData> frameVoxels;
-    frameVoxels->DeepCopy(extractComponents->GetOutput());
+      vtkNew<vtkImageData> frameVoxels;
+      frameVoxels->DeepCopy(extractComponents->GetOutput());
 #endif
-    // Slicer expects normalized image position and spacing
-    frameVoxels->SetOrigin(0, 0, 0);
-    frameVoxels->SetSpacing(1, 1, 1);
-    vtkNew<vtkMRMLScalarVolumeNode> frameVolume;
+      // Slicer expects normalized image position and spacing
+      frameVoxels->SetOrigin(0, 0, 0);
+      frameVoxels->SetSpacing(1, 1, 1);
 #ifdef NRRD_CHUNK_IO_AVAILABLE
-    frameVolume->SetAndObserveImageData(frameVoxels);
+      frameVolume->SetAndObserveImageData(frameVoxels);
 #else
-    frameVolume->SetAndObserveImageData(frameVoxels.GetPointer());
+      frameVolume->SetAndObserveImageData(frameVoxels.GetPointer());
 #endif
+      }
     frameVolume->SetRASToIJKMatrix(reader->GetRasToIjkMatrix());
 
     std::ostringstream indexStr;
@@ -232,7 +257,14 @@ int vtkMRMLVolumeSequenceStorageNode::ReadDataInternal(vtkMRMLNode* refNode)
     std::ostringstream nameStr;
     nameStr << refNode->GetName() << "_" << std::setw(4) << std::setfill('0') << frameIndex << std::ends;
     frameVolume->SetName( nameStr.str().c_str() );
-    volSequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str() );
+    if (readFramesOnDemand)
+      {
+      volSequenceNode->SetPagedDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str(), frameIndex);
+      }
+    else
+      {
+      volSequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str().c_str() );
+      }
     }
 
   vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::ReadDataInternal: sequence successfully read. ");
@@ -275,6 +307,12 @@ bool vtkMRMLVolumeSequenceStorageNode::CanWriteFromReferenceNode(vtkMRMLNode *re
   int numberOfFrameVolumes = volSequenceNode->GetNumberOfDataNodes();
   for (int frameIndex = 1; frameIndex<numberOfFrameVolumes; frameIndex++)
     {
+    if (!volSequenceNode->IsNthDataNodeLoaded(frameIndex))
+      {
+      // Frames that are read on demand come from a single volume sequence file,
+      // they do not need to be read to check their compatibility.
+      continue;
+      }
     vtkMRMLVolumeNode* currentFrameVolume = vtkMRMLVolumeNode::SafeDownCast(volSequenceNode->GetNthDataNode(frameIndex));
     if (currentFrameVolume == nullptr)
       {
@@ -398,6 +436,8 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
 #if Slicer_VERSION_MAJOR > 4 || (Slicer_VERSION_MAJOR == 4 && Slicer_VERSION_MINOR >= 9)
   vtkNew<vtkTeemNRRDWriter> writer;
   writer->SetVectorAxisKind(nrrdKindList);
+  // Frames are stored one after the other, so that a frame can be read without reading the whole file
+  writer->VectorAxisOutermostOn();
 #else
   vtkNew<vtkNRRDWriter> writer;
 #endif
@@ -414,18 +454,10 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   writer->SetIJKToRASMatrix(ijkToRas.GetPointer());
   //writer->SetMeasurementFrameMatrix(mf.GetPointer());
 
-  // Write index information
-  int axisIndex;
-  std::string axisType, axisValues;
-#ifdef NRRD_CHUNK_IO_AVAILABLE
-  axisIndex = 3;
-  axisType = "axis 3 index type";
-  axisValues = "axis 3 index values";
-#else
-  axisIndex = 0;
-  axisType = "axis 0 index type";
-  axisValues = "axis 0 index values";
-#endif
+  // Write index information (frame axis is the last axis)
+  int axisIndex = 3;
+  std::string axisType = "axis 3 index type";
+  std::string axisValues = "axis 3 index values";
 
   if (!volSequenceNode->GetIndexName().empty())
     {
@@ -540,6 +572,17 @@ int vtkMRMLVolumeSequenceStorageNode::WriteDataInternal(vtkMRMLNode *refNode)
   this->StageWriteData(refNode);
 #endif
 
+  // Frames that were recorded to temporary files are now merged into the sequence file
+  vtkSmartPointer<vtkMRMLVolumeSequenceRecorder> recorder = vtkMRMLVolumeSequenceRecorder::SafeDownCast(volSequenceNode->GetFrameReader());
+  if (writeFlag && recorder)
+    {
+    vtkNew<vtkMRMLVolumeSequenceFrameReader> frameReader;
+    frameReader->SetFileName(fullName);
+    // Compressed frames would have to be decoded from the whole file each time, therefore they are kept in memory
+    volSequenceNode->SetSequenceFileFrameReader(frameReader->CanReadFramesIndividually() ? frameReader.GetPointer() : nullptr);
+    recorder->RemoveFrameFiles();
+    }
+
   vtkDebugMacro(<< " vtkMRMLVolumeSequenceStorageNode::WriteDataInternal: sequence successfully written. ");
   return writeFlag;
 }
@@ -27,6 +27,7 @@ class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStora
   vtkTypeMacro(vtkMRMLVolumeSequenceStorageNode,vtkMRMLNRRDStorageNode);
 
   vtkMRMLNode* CreateNodeInstance() override;
+  void PrintSelf(ostream& os, vtkIndent indent) override;
 
   ///
   /// Get node XML tag name (like Storage, Model)
@@ -55,6 +56,17 @@ class VTK_MRML_EXPORT vtkMRMLVolumeSequenceStorageNode : public vtkMRMLNRRDStora
   /// Return a default file extension for writting
   const char* GetDefaultWriteFileExtension() override;
 
+  /// Only read the header when the sequence is loaded and read the voxels of
+  /// each frame when it is requested. Frames that are not used recently are released.
+  /// Only possible if the voxels are stored uncompressed (UseCompression is off when the
+  /// file is written) and the frames are not interleaved, otherwise all the frames are read
+  /// at once. Files written by this storage node store the frames one after the other.
+  /// Enabled by default.
+  /// \sa vtkMRMLSequenceNode::SetPagedDataNodeAtValue
+  vtkSetMacro(ReadFramesOnDemand, bool);
+  vtkGetMacro(ReadFramesOnDemand, bool);
+  vtkBooleanMacro(ReadFramesOnDemand, bool);
+
 protected:
   vtkMRMLVolumeSequenceStorageNode();
   ~vtkMRMLVolumeSequenceStorageNode() override;
@@ -80,6 +92,8 @@ protected:
 
   /// Initialize all the supported write file types
   void InitializeSupportedWriteFileTypes() override;
+
+  bool ReadFramesOnDemand{true};
 };
 
 #endif
@@ -46,6 +46,7 @@ vtkObservation::vtkObservation()
 
   this->LastElapsedTime = 0.0;
   this->TotalElapsedTime = 0.0;
+  this->NumberOfInvocations = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -100,4 +101,5 @@ void vtkObservation::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "LastElapsedTime: " << this->LastElapsedTime << "\n";
   os << indent << "TotalElapsedTime: " << this->TotalElapsedTime << "\n";
+  os << indent << "NumberOfInvocations: " << this->NumberOfInvocations << "\n";
 }
@@ -90,6 +90,11 @@ class VTK_MRML_EXPORT vtkObservation : public vtkObject
   vtkGetMacro (TotalElapsedTime, double);
   vtkSetMacro (TotalElapsedTime, double);
 
+  /// Description
+  /// Number of times the callback (or script) has been invoked
+  vtkGetMacro (NumberOfInvocations, unsigned long);
+  vtkSetMacro (NumberOfInvocations, unsigned long);
+
   struct CallType
   {
     inline CallType(unsigned long eventID, void* callData);
@@ -159,6 +164,7 @@ protected:
 
   double LastElapsedTime;
   double TotalElapsedTime;
+  unsigned long NumberOfInvocations;
 
 };
 
@@ -1043,7 +1043,23 @@ void vtkMRMLModelDisplayableManager::UpdateModelMesh(vtkMRMLDisplayableNode *dis
   if (tnode != nullptr && !tnode->IsTransformToWorldLinear())
     {
     hasNonLinearTransform = true;
-    tnode->GetTransformToWorld(worldTransform);
+    // Use the resampled transform if enabled, as transforming the mesh points
+    // with a single grid is much faster than with nonlinear transform chains.
+    vtkAbstractTransform* resampledTransform = nullptr;
+    if (modelNode && tnode->GetResampledTransformCacheEnabled())
+      {
+      double bounds[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+      modelNode->GetBounds(bounds);
+      resampledTransform = tnode->GetResampledTransformToWorld(bounds);
+      }
+    if (resampledTransform)
+      {
+      worldTransform->Concatenate(resampledTransform);
+      }
+    else
+      {
+      tnode->GetTransformToWorld(worldTransform);
+      }
     }
 
   for (i=0; i<ndnodes; i++)
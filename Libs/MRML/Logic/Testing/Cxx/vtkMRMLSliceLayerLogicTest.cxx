@@ -19,10 +19,12 @@
 ==============================================================================*/
 
 // MRMLLogic includes
+#include "vtkImageIncrementalReslice.h"
 #include "vtkMRMLSliceLayerLogic.h"
 
 // MRML includes
 #include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLScalarVolumeNode.h"
 #include "vtkMRMLScene.h"
 
 // VTK includes
@@ -34,11 +36,13 @@
 #include <vtkImageReslice.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
+#include <vtkTransform.h>
 #include <vtkTrivialProducer.h>
 
 namespace
 {
 bool testDTIPipeline();
+int testIncrementalReslice();
 }
 
 //----------------------------------------------------------------------------
@@ -71,6 +75,8 @@ int vtkMRMLSliceLayerLogicTest(int , char * [] )
     TEST_SET_GET_VALUE(logic, VolumeNode, VolumeNode.GetPointer());
   }
 
+  CHECK_EXIT_SUCCESS(testIncrementalReslice());
+
   bool res = true;
   res = res && testDTIPipeline();
   return res ? EXIT_SUCCESS : EXIT_FAILURE;
@@ -136,4 +142,136 @@ bool testDTIPipeline()
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool compareImages(vtkImageData* image1, vtkImageData* image2)
+{
+  vtkDataArray* scalars1 = image1->GetPointData()->GetScalars();
+  vtkDataArray* scalars2 = image2->GetPointData()->GetScalars();
+  if (scalars1->GetNumberOfTuples() != scalars2->GetNumberOfTuples())
+    {
+    std::cerr << "Number of voxels differ: " << scalars1->GetNumberOfTuples()
+              << " != " << scalars2->GetNumberOfTuples() << std::endl;
+    return false;
+    }
+  for (vtkIdType i = 0; i < scalars1->GetNumberOfTuples(); ++i)
+    {
+    if (scalars1->GetTuple1(i) != scalars2->GetTuple1(i))
+      {
+      std::cerr << "Voxel " << i << " differs: " << scalars1->GetTuple1(i)
+                << " != " << scalars2->GetTuple1(i) << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Write voxels directly in the scalar buffer, as vtkImageSlicePaint does,
+// without modifying the image data
+void paintVoxels(vtkImageData* imageData, const int extent[6], unsigned char label)
+{
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      unsigned char* voxelPtr = static_cast<unsigned char*>(imageData->GetScalarPointer(extent[0], j, k));
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        *(voxelPtr++) = label;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+int testIncrementalReslice()
+{
+  vtkNew<vtkImageData> imageData;
+  imageData->SetDimensions(40, 40, 10);
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  imageData->GetPointData()->GetScalars()->Fill(0);
+  vtkNew<vtkMRMLScalarVolumeNode> volumeNode;
+  volumeNode->SetAndObserveImageData(imageData.GetPointer());
+
+  // Oblique slice through the volume
+  vtkNew<vtkTransform> xyToIJK;
+  xyToIJK->Translate(20., -5., 5.);
+  xyToIJK->RotateZ(30.);
+
+  vtkNew<vtkImageIncrementalReslice> reslice;
+  reslice->SetVolumeNode(volumeNode.GetPointer());
+  reslice->SetInputData(imageData.GetPointer());
+  reslice->SetResliceTransform(xyToIJK.GetPointer());
+  reslice->SetInterpolationModeToLinear();
+  reslice->SetOutputOrigin(0, 0, 0);
+  reslice->SetOutputSpacing(1, 1, 1);
+  reslice->SetOutputExtent(0, 49, 0, 49, 0, 0);
+  reslice->GenerateStencilOutputOn();
+  reslice->Update();
+  const int numberOfOutputVoxels = 50 * 50;
+  CHECK_INT(static_cast<int>(reslice->GetNumberOfUpdatedVoxels()), numberOfOutputVoxels);
+
+  vtkNew<vtkImageReslice> referenceReslice;
+  referenceReslice->SetInputData(imageData.GetPointer());
+  referenceReslice->SetResliceTransform(xyToIJK.GetPointer());
+  referenceReslice->SetInterpolationModeToLinear();
+  referenceReslice->SetOutputOrigin(0, 0, 0);
+  referenceReslice->SetOutputSpacing(1, 1, 1);
+  referenceReslice->SetOutputExtent(0, 49, 0, 49, 0, 0);
+
+  // Paint a few voxels: only the corresponding region is resliced
+  int paintExtent[6] = { 18, 21, 10, 12, 4, 6 };
+  paintVoxels(imageData.GetPointer(), paintExtent, 255);
+  volumeNode->ImageDataExtentModified(paintExtent);
+  reslice->Update();
+  CHECK_BOOL(reslice->GetNumberOfUpdatedVoxels() > 0, true);
+  CHECK_BOOL(reslice->GetNumberOfUpdatedVoxels() < numberOfOutputVoxels / 10, true);
+  referenceReslice->Update();
+  CHECK_BOOL(compareImages(reslice->GetOutput(), referenceReslice->GetOutput()), true);
+
+  // Voxels out of the slice do not trigger any reslicing
+  int outOfSliceExtent[6] = { 0, 1, 0, 1, 0, 1 };
+  paintVoxels(imageData.GetPointer(), outOfSliceExtent, 255);
+  volumeNode->ImageDataExtentModified(outOfSliceExtent);
+  reslice->Update();
+  CHECK_INT(static_cast<int>(reslice->GetNumberOfUpdatedVoxels()), 0);
+
+  // Successive strokes are incremental too
+  int secondPaintExtent[6] = { 22, 24, 11, 13, 5, 5 };
+  paintVoxels(imageData.GetPointer(), secondPaintExtent, 128);
+  volumeNode->ImageDataExtentModified(secondPaintExtent);
+  reslice->Update();
+  CHECK_BOOL(reslice->GetNumberOfUpdatedVoxels() > 0, true);
+  CHECK_BOOL(reslice->GetNumberOfUpdatedVoxels() < numberOfOutputVoxels / 10, true);
+  referenceReslice->Update();
+  CHECK_BOOL(compareImages(reslice->GetOutput(), referenceReslice->GetOutput()), true);
+
+  // Modified() called before the extent is recorded (what vtkImageSlicePaint
+  // does unless NotifyWorkingImageModified is off) is an unknown modification
+  paintVoxels(imageData.GetPointer(), paintExtent, 64);
+  imageData->Modified();
+  volumeNode->ImageDataExtentModified(paintExtent);
+  reslice->Update();
+  CHECK_INT(static_cast<int>(reslice->GetNumberOfUpdatedVoxels()), numberOfOutputVoxels);
+  referenceReslice->Update();
+  CHECK_BOOL(compareImages(reslice->GetOutput(), referenceReslice->GetOutput()), true);
+
+  // Modifications of unknown extent require a full update
+  int unknownExtent[6] = { 30, 30, 30, 30, 5, 5 };
+  paintVoxels(imageData.GetPointer(), unknownExtent, 255);
+  imageData->Modified();
+  reslice->Update();
+  CHECK_INT(static_cast<int>(reslice->GetNumberOfUpdatedVoxels()), numberOfOutputVoxels);
+  referenceReslice->Update();
+  CHECK_BOOL(compareImages(reslice->GetOutput(), referenceReslice->GetOutput()), true);
+
+  // Parameter changes require a full update
+  volumeNode->ImageDataExtentModified(paintExtent);
+  reslice->SetInterpolationModeToNearestNeighbor();
+  reslice->Update();
+  CHECK_INT(static_cast<int>(reslice->GetNumberOfUpdatedVoxels()), numberOfOutputVoxels);
+
+  return EXIT_SUCCESS;
+}
+
 }
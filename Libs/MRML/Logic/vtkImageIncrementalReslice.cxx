@@ -0,0 +1,247 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#include "vtkImageIncrementalReslice.h"
+
+// MRML includes
+#include <vtkMRMLVolumeNode.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkImageStencilData.h>
+#include <vtkInformation.h>
+#include <vtkInformationVector.h>
+#include <vtkLinearTransform.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkStreamingDemandDrivenPipeline.h>
+
+// STD includes
+#include <algorithm>
+
+//------------------------------------------------------------------------------
+vtkStandardNewMacro(vtkImageIncrementalReslice);
+
+//----------------------------------------------------------------------------
+vtkImageIncrementalReslice::vtkImageIncrementalReslice()
+{
+  this->IncrementalUpdate = true;
+  this->NumberOfUpdatedVoxels = 0;
+  this->LastInputMTime = 0;
+  this->LastMTime = 0;
+  for (int i = 0; i < 6; ++i)
+    {
+    this->LastInputExtent[i] = 0;
+    this->LastUpdateExtent[i] = 0;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkImageIncrementalReslice::~vtkImageIncrementalReslice() = default;
+
+//----------------------------------------------------------------------------
+void vtkImageIncrementalReslice::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "VolumeNode: " << this->VolumeNode.GetPointer() << "\n";
+  os << indent << "IncrementalUpdate: " << this->IncrementalUpdate << "\n";
+  os << indent << "NumberOfUpdatedVoxels: " << this->NumberOfUpdatedVoxels << "\n";
+}
+
+//----------------------------------------------------------------------------
+void vtkImageIncrementalReslice::SetVolumeNode(vtkMRMLVolumeNode* volumeNode)
+{
+  if (this->VolumeNode == volumeNode)
+    {
+    return;
+    }
+  this->VolumeNode = volumeNode;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+vtkMRMLVolumeNode* vtkImageIncrementalReslice::GetVolumeNode()
+{
+  return this->VolumeNode;
+}
+
+//----------------------------------------------------------------------------
+bool vtkImageIncrementalReslice::GetModifiedOutputExtent(
+  vtkImageData* input, vtkInformation* outInfo, const int updateExtent[6], int modifiedExtent[6])
+{
+  // The previous output can only be reused if nothing but the input voxels changed
+  if (!this->VolumeNode || this->VolumeNode->GetImageData() != input
+      || !this->LastOutput || this->LastInput != input
+      || this->LastMTime != this->GetMTime())
+    {
+    return false;
+    }
+  int inputExtent[6];
+  input->GetExtent(inputExtent);
+  for (int i = 0; i < 6; ++i)
+    {
+    if (inputExtent[i] != this->LastInputExtent[i] ||
+        updateExtent[i] != this->LastUpdateExtent[i])
+      {
+      return false;
+      }
+    }
+  // Only linear transforms map the modified box onto a box
+  vtkAbstractTransform* resliceTransform = this->GetResliceTransform();
+  vtkLinearTransform* linearTransform = vtkLinearTransform::SafeDownCast(resliceTransform);
+  if (this->GetResliceAxes() != nullptr || this->GetSlabNumberOfSlices() > 1 ||
+      (resliceTransform != nullptr && linearTransform == nullptr))
+    {
+    return false;
+    }
+
+  int ijkExtent[6];
+  if (!this->VolumeNode->GetImageDataModifiedExtentSince(this->LastInputMTime, ijkExtent))
+    {
+    return false;
+    }
+  modifiedExtent[0] = modifiedExtent[2] = modifiedExtent[4] = 0;
+  modifiedExtent[1] = modifiedExtent[3] = modifiedExtent[5] = -1;
+  if (ijkExtent[0] > ijkExtent[1] || ijkExtent[2] > ijkExtent[3] || ijkExtent[4] > ijkExtent[5])
+    {
+    // nothing changed
+    return true;
+    }
+
+  // Input to output transform, the reslice transform maps output to input.
+  vtkNew<vtkMatrix4x4> inputToOutput;
+  if (linearTransform)
+    {
+    linearTransform->Update();
+    vtkMatrix4x4::Invert(linearTransform->GetMatrix(), inputToOutput.GetPointer());
+    }
+
+  // Output voxels within the interpolation kernel of a modified voxel change
+  int margin = (this->GetInterpolationMode() == VTK_RESLICE_CUBIC ? 2 : 1);
+  double inputOrigin[3];
+  double inputSpacing[3];
+  input->GetOrigin(inputOrigin);
+  input->GetSpacing(inputSpacing);
+  double outputOrigin[3];
+  double outputSpacing[3];
+  outInfo->Get(vtkDataObject::ORIGIN(), outputOrigin);
+  outInfo->Get(vtkDataObject::SPACING(), outputSpacing);
+
+  double bounds[6] = { VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+                       VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX,
+                       VTK_DOUBLE_MAX, -VTK_DOUBLE_MAX };
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double point[4] = { 0.0, 0.0, 0.0, 1.0 };
+    for (int i = 0; i < 3; ++i)
+      {
+      int index = ((corner >> i) & 1) ? ijkExtent[2*i+1] + margin : ijkExtent[2*i] - margin;
+      point[i] = inputOrigin[i] + inputSpacing[i] * index;
+      }
+    inputToOutput->MultiplyPoint(point, point);
+    for (int i = 0; i < 3; ++i)
+      {
+      double outputIndex = (point[i] / point[3] - outputOrigin[i]) / outputSpacing[i];
+      bounds[2*i] = std::min(bounds[2*i], outputIndex);
+      bounds[2*i+1] = std::max(bounds[2*i+1], outputIndex);
+      }
+    }
+  for (int i = 0; i < 3; ++i)
+    {
+    double minIndex = std::min(bounds[2*i], bounds[2*i+1]);
+    double maxIndex = std::max(bounds[2*i], bounds[2*i+1]);
+    modifiedExtent[2*i] = std::max(updateExtent[2*i], vtkMath::Floor(minIndex));
+    modifiedExtent[2*i+1] = std::min(updateExtent[2*i+1], vtkMath::Ceil(maxIndex));
+    if (modifiedExtent[2*i] > modifiedExtent[2*i+1])
+      {
+      // modified voxels are out of the output
+      modifiedExtent[0] = modifiedExtent[2] = modifiedExtent[4] = 0;
+      modifiedExtent[1] = modifiedExtent[3] = modifiedExtent[5] = -1;
+      return true;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkImageIncrementalReslice::RequestData(vtkInformation *request,
+                                            vtkInformationVector **inputVector,
+                                            vtkInformationVector *outputVector)
+{
+  vtkInformation* outInfo = outputVector->GetInformationObject(0);
+  vtkImageData* input = vtkImageData::GetData(inputVector[0]);
+  vtkImageData* output = vtkImageData::GetData(outputVector, 0);
+  vtkImageStencilData* stencilOutput = nullptr;
+  if (this->GetGenerateStencilOutput() && outputVector->GetNumberOfInformationObjects() > 1)
+    {
+    stencilOutput = vtkImageStencilData::GetData(outputVector, 1);
+    }
+  int updateExtent[6];
+  outInfo->Get(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent);
+
+  int modifiedExtent[6];
+  bool incremental = this->IncrementalUpdate && input && output &&
+    this->GetModifiedOutputExtent(input, outInfo, updateExtent, modifiedExtent);
+
+  int result = 1;
+  if (!incremental)
+    {
+    result = this->Superclass::RequestData(request, inputVector, outputVector);
+    this->NumberOfUpdatedVoxels = output ? output->GetNumberOfPoints() : 0;
+    if (output)
+      {
+      // Shallow copy: the previous output shares the arrays of the output
+      this->LastOutput = vtkSmartPointer<vtkImageData>::New();
+      this->LastOutput->ShallowCopy(output);
+      }
+    if (stencilOutput)
+      {
+      this->LastStencilOutput = vtkSmartPointer<vtkImageStencilData>::New();
+      this->LastStencilOutput->ShallowCopy(stencilOutput);
+      }
+    }
+  else
+    {
+    this->NumberOfUpdatedVoxels = 0;
+    if (modifiedExtent[0] <= modifiedExtent[1])
+      {
+      // Reslice the modified region only, then copy it into the previous output
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), modifiedExtent, 6);
+      result = this->Superclass::RequestData(request, inputVector, outputVector);
+      outInfo->Set(vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(), updateExtent, 6);
+      if (result)
+        {
+        this->LastOutput->CopyAndCastFrom(output, modifiedExtent);
+        }
+      this->NumberOfUpdatedVoxels = static_cast<vtkIdType>(modifiedExtent[1] - modifiedExtent[0] + 1)
+        * (modifiedExtent[3] - modifiedExtent[2] + 1) * (modifiedExtent[5] - modifiedExtent[4] + 1);
+      }
+    output->ShallowCopy(this->LastOutput);
+    // The stencil only depends on the geometry, which did not change
+    if (stencilOutput && this->LastStencilOutput)
+      {
+      stencilOutput->ShallowCopy(this->LastStencilOutput);
+      }
+    }
+
+  this->LastInput = input;
+  this->LastInputMTime = input ? input->GetMTime() : 0;
+  this->LastMTime = this->GetMTime();
+  if (input)
+    {
+    input->GetExtent(this->LastInputExtent);
+    }
+  std::copy(updateExtent, updateExtent + 6, this->LastUpdateExtent);
+  return result;
+}
@@ -0,0 +1,90 @@
+/*=auto=========================================================================
+
+  Portions (c) Copyright 2005 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   3D Slicer
+
+=========================================================================auto=*/
+
+#ifndef __vtkImageIncrementalReslice_h
+#define __vtkImageIncrementalReslice_h
+
+// VTK includes
+#include <vtkImageReslice.h>
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+#include "vtkMRMLLogicExport.h"
+
+class vtkImageStencilData;
+class vtkMRMLVolumeNode;
+
+/// \brief Reslice filter that only recomputes the output region affected by
+/// modified input voxels.
+///
+/// When the voxels of the input volume are modified in place and reported
+/// with vtkMRMLVolumeNode::ImageDataExtentModified(), the modified IJK extent
+/// is mapped into the output and only that region is resliced, the rest of
+/// the previous output is reused.
+/// A full update is done whenever anything else changed (reslice parameters,
+/// transform, output geometry, input geometry) or if the reslice transform is
+/// not linear.
+class VTK_MRML_LOGIC_EXPORT vtkImageIncrementalReslice : public vtkImageReslice
+{
+public:
+  static vtkImageIncrementalReslice *New();
+  vtkTypeMacro(vtkImageIncrementalReslice,vtkImageReslice);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  ///
+  /// Volume node whose image data is the input of the filter. It provides
+  /// the extents of the modified voxels. Full updates are done if not set.
+  void SetVolumeNode(vtkMRMLVolumeNode* volumeNode);
+  vtkMRMLVolumeNode* GetVolumeNode();
+
+  ///
+  /// Only reslice the modified region of the output if possible.
+  /// On by default.
+  vtkSetMacro(IncrementalUpdate, bool);
+  vtkGetMacro(IncrementalUpdate, bool);
+  vtkBooleanMacro(IncrementalUpdate, bool);
+
+  ///
+  /// Number of output voxels resliced by the last execution
+  vtkGetMacro(NumberOfUpdatedVoxels, vtkIdType);
+
+protected:
+  vtkImageIncrementalReslice();
+  ~vtkImageIncrementalReslice() override;
+
+  int RequestData(vtkInformation *request,
+                  vtkInformationVector **inputVector,
+                  vtkInformationVector *outputVector) override;
+
+  /// Compute the output extent affected by the input voxels modified since
+  /// the last execution. Returns false if a full update is needed.
+  bool GetModifiedOutputExtent(vtkImageData* input, vtkInformation* outInfo,
+                               const int updateExtent[6], int modifiedExtent[6]);
+
+  vtkWeakPointer<vtkMRMLVolumeNode> VolumeNode;
+  bool IncrementalUpdate;
+  vtkIdType NumberOfUpdatedVoxels;
+
+  /// State of the last execution
+  vtkSmartPointer<vtkImageData> LastOutput;
+  vtkSmartPointer<vtkImageStencilData> LastStencilOutput;
+  vtkWeakPointer<vtkImageData> LastInput;
+  vtkMTimeType LastInputMTime;
+  vtkMTimeType LastMTime;
+  int LastInputExtent[6];
+  int LastUpdateExtent[6];
+
+private:
+  vtkImageIncrementalReslice(const vtkImageIncrementalReslice&) = delete;
+  void operator=(const vtkImageIncrementalReslice&) = delete;
+};
+
+#endif
@@ -45,6 +45,7 @@
 #include <vtkAddonMathUtilities.h>
 
 //
+#include "vtkImageIncrementalReslice.h"
 #include "vtkImageLabelOutline.h"
 
 // STD includes
@@ -121,8 +122,8 @@ vtkMRMLSliceLayerLogic::vtkMRMLSliceLayerLogic()
   this->AssignAttributeScalarsToTensorsUVW->Assign(vtkDataSetAttributes::SCALARS, vtkDataSetAttributes::TENSORS, vtkAssignAttribute::POINT_DATA);
 
   // Create the parts for the scalar layer pipeline
-  this->Reslice = vtkImageReslice::New();
-  this->ResliceUVW = vtkImageReslice::New();
+  this->Reslice = vtkImageIncrementalReslice::New();
+  this->ResliceUVW = vtkImageIncrementalReslice::New();
   this->LabelOutline = vtkImageLabelOutline::New();
   this->LabelOutlineUVW = vtkImageLabelOutline::New();
 
@@ -516,13 +517,31 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
     vtkMRMLTransformNode *transformNode = this->VolumeNode->GetParentTransformNode();
     if ( transformNode != nullptr )
       {
-      vtkNew<vtkGeneralTransform> worldTransform;
-      worldTransform->Identity();
-      transformNode->GetTransformFromWorld(worldTransform.GetPointer());
-      //worldTransform->Inverse();
+      // Use the resampled transform if enabled, as evaluating a single grid is much faster
+      // than evaluating (inverse) nonlinear transform chains for every pixel.
+      // The grid only needs to cover the region where the volume is displayed.
+      vtkAbstractTransform* resampledTransform = nullptr;
+      if (transformNode->GetResampledTransformCacheEnabled())
+        {
+        double bounds_World[6] = { 0.0, -1.0, 0.0, -1.0, 0.0, -1.0 };
+        this->VolumeNode->GetRASBounds(bounds_World);
+        resampledTransform = transformNode->GetResampledTransformFromWorld(bounds_World);
+        }
+      if (resampledTransform)
+        {
+        this->XYToIJKTransform->Concatenate(resampledTransform);
+        this->UVWToIJKTransform->Concatenate(resampledTransform);
+        }
+      else
+        {
+        vtkNew<vtkGeneralTransform> worldTransform;
+        worldTransform->Identity();
+        transformNode->GetTransformFromWorld(worldTransform.GetPointer());
+        //worldTransform->Inverse();
 
-      this->XYToIJKTransform->Concatenate(worldTransform.GetPointer());
-      this->UVWToIJKTransform->Concatenate(worldTransform.GetPointer());
+        this->XYToIJKTransform->Concatenate(worldTransform.GetPointer());
+        this->UVWToIJKTransform->Concatenate(worldTransform.GetPointer());
+        }
       }
 
     vtkNew<vtkMatrix4x4> rasToIJK;
@@ -534,11 +553,18 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
     // vtkImageReslice works faster if the input is a linear transform, so try to convert it
     // to a linear transform.
     // Also attempt to make it a permute transform, as it makes reslicing even faster.
+    // Keep the current transform if unchanged to not invalidate the reslice
+    // output (it would prevent incremental reslicing of modified voxels).
     vtkSmartPointer<vtkTransform> linearXYToIJKTransform = vtkSmartPointer<vtkTransform>::New();
     if (vtkMRMLTransformNode::IsGeneralTransformLinear(this->XYToIJKTransform, linearXYToIJKTransform))
       {
       SnapToPermuteMatrix(linearXYToIJKTransform);
-      this->Reslice->SetResliceTransform(linearXYToIJKTransform);
+      vtkTransform* currentTransform = vtkTransform::SafeDownCast(this->Reslice->GetResliceTransform());
+      if (!currentTransform ||
+          !AreMatricesEqual(currentTransform->GetMatrix(), linearXYToIJKTransform->GetMatrix()))
+        {
+        this->Reslice->SetResliceTransform(linearXYToIJKTransform);
+        }
       }
     else
       {
@@ -548,7 +574,12 @@ void vtkMRMLSliceLayerLogic::UpdateTransforms()
     if (vtkMRMLTransformNode::IsGeneralTransformLinear(this->UVWToIJKTransform, linearUVWToIJKTransform))
       {
       SnapToPermuteMatrix(linearUVWToIJKTransform);
-      this->ResliceUVW->SetResliceTransform( linearUVWToIJKTransform );
+      vtkTransform* currentTransform = vtkTransform::SafeDownCast(this->ResliceUVW->GetResliceTransform());
+      if (!currentTransform ||
+          !AreMatricesEqual(currentTransform->GetMatrix(), linearUVWToIJKTransform->GetMatrix()))
+        {
+        this->ResliceUVW->SetResliceTransform( linearUVWToIJKTransform );
+        }
       }
     else
       {
@@ -708,6 +739,8 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
         }
       this->Reslice->SetInputConnection( this->AssignAttributeTensorsToScalars->GetOutputPort() );
       this->ResliceUVW->SetInputConnection( this->AssignAttributeTensorsToScalars->GetOutputPort() );
+      this->Reslice->SetVolumeNode( nullptr );
+      this->ResliceUVW->SetVolumeNode( nullptr );
 
       this->AssignAttributeScalarsToTensors->SetInputConnection(this->Reslice->GetOutputPort() );
       // don't activate 3D UVW reslice pipeline if we use single 2D reslice pipeline
@@ -747,8 +780,17 @@ void vtkMRMLSliceLayerLogic::UpdateImageDisplay()
 //      {
 //      volumeNode->GetImageData()->Print(std::cout);
 //      }
-    this->Reslice->SetInputData(volumeNode->GetImageData());
-    this->ResliceUVW->SetInputData(volumeNode->GetImageData());
+    if (this->Reslice->GetInputDataObject(0, 0) != volumeNode->GetImageData())
+      {
+      this->Reslice->SetInputData(volumeNode->GetImageData());
+      }
+    if (this->ResliceUVW->GetInputDataObject(0, 0) != volumeNode->GetImageData())
+      {
+      this->ResliceUVW->SetInputData(volumeNode->GetImageData());
+      }
+    // only reslice the voxels reported by ImageDataExtentModified()
+    this->Reslice->SetVolumeNode(volumeNode);
+    this->ResliceUVW->SetVolumeNode(volumeNode);
     // use the label outline if we have a label map volume, this is the label
     // layer (turned on in slice logic when the label layer is instantiated)
     // and the slice node is set to use it.
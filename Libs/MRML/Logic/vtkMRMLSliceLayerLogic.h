@@ -48,7 +48,7 @@
 #include <vtkVersion.h>
 
 class vtkAssignAttribute;
-class vtkImageReslice;
+class vtkImageIncrementalReslice;
 class vtkGeneralTransform;
 
 // STL includes
@@ -85,9 +85,11 @@ public:
   void SetSliceNode (vtkMRMLSliceNode *SliceNode);
 
   ///
-  /// The image reslice or slice being used
-  vtkGetObjectMacro (Reslice, vtkImageReslice);
-  vtkGetObjectMacro (ResliceUVW, vtkImageReslice);
+  /// The image reslice or slice being used.
+  /// Scalar volumes modified with vtkMRMLVolumeNode::ImageDataExtentModified()
+  /// are only resliced in the affected region.
+  vtkGetObjectMacro (Reslice, vtkImageIncrementalReslice);
+  vtkGetObjectMacro (ResliceUVW, vtkImageIncrementalReslice);
 
   ///
   /// Select if this is a label layer or not (it currently determines if we use
@@ -166,8 +168,8 @@ protected:
 
   ///
   /// the VTK class instances that implement this Logic's operations
-  vtkImageReslice *Reslice;
-  vtkImageReslice *ResliceUVW;
+  vtkImageIncrementalReslice *Reslice;
+  vtkImageIncrementalReslice *ResliceUVW;
   vtkImageLabelOutline *LabelOutline;
   vtkImageLabelOutline *LabelOutlineUVW;
 
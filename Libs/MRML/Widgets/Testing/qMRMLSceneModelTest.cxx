@@ -20,6 +20,7 @@
 
 // Qt includes
 #include <QApplication>
+#include <QSignalSpy>
 #include <QTimer>
 
 // CTK includes
@@ -47,6 +48,8 @@ private slots:
   void testSetColumns_data();
   void testSetColumnsWithScene();
   void testSetColumnsWithScene_data();
+  void testIndexFromNode();
+  void testLazyUpdateBatchProcess();
 };
 
 // ----------------------------------------------------------------------------
@@ -192,6 +195,95 @@ void qMRMLSceneModelTester::testSetColumnsWithScene_data()
   this->testSetColumns_data();
 }
 
+// ----------------------------------------------------------------------------
+void qMRMLSceneModelTester::testIndexFromNode()
+{
+  qMRMLSceneModel sceneModel;
+  sceneModel.setListenNodeModifiedEvent(qMRMLSceneModel::AllNodes);
+  vtkNew<vtkMRMLScene> scene;
+  sceneModel.setMRMLScene(scene.GetPointer());
+
+  QList<vtkMRMLViewNode*> nodes;
+  for (int i = 0; i < 10; ++i)
+    {
+    vtkNew<vtkMRMLViewNode> node;
+    scene->AddNode(node.GetPointer());
+    nodes << node.GetPointer();
+    }
+  for (int i = 0; i < nodes.count(); ++i)
+    {
+    QModelIndex nodeIndex = sceneModel.indexFromNode(nodes[i]);
+    QVERIFY(nodeIndex.isValid());
+    QCOMPARE(nodeIndex.row(), i);
+    QCOMPARE(sceneModel.mrmlNodeFromIndex(nodeIndex), nodes[i]);
+    }
+
+  // Indexes are found after other rows are removed
+  scene->RemoveNode(nodes[0]);
+  QVERIFY(sceneModel.indexFromNode(nodes[1]).isValid());
+  QCOMPARE(sceneModel.indexFromNode(nodes[1]).row(), 0);
+  QCOMPARE(sceneModel.mrmlNodeFromIndex(sceneModel.indexFromNode(nodes[9])), nodes[9]);
+
+  // Item is updated when the node is modified
+  nodes[5]->SetName("ModifiedName");
+  QCOMPARE(sceneModel.itemFromNode(nodes[5])->text(), QString("ModifiedName"));
+
+  // Nodes that are not in the scene are not in the model
+  vtkNew<vtkMRMLViewNode> otherNode;
+  QVERIFY(!sceneModel.indexFromNode(otherNode.GetPointer()).isValid());
+}
+
+// ----------------------------------------------------------------------------
+void qMRMLSceneModelTester::testLazyUpdateBatchProcess()
+{
+  qMRMLSceneModel sceneModel;
+  sceneModel.setListenNodeModifiedEvent(qMRMLSceneModel::AllNodes);
+  sceneModel.setLazyUpdate(true);
+  vtkNew<vtkMRMLScene> scene;
+  sceneModel.setMRMLScene(scene.GetPointer());
+
+  QList<vtkMRMLViewNode*> nodes;
+  for (int i = 0; i < 1000; ++i)
+    {
+    vtkNew<vtkMRMLViewNode> node;
+    scene->AddNode(node.GetPointer());
+    nodes << node.GetPointer();
+    }
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 1000);
+  QStandardItem* unchangedItem = sceneModel.itemFromNode(nodes[10]);
+
+  QSignalSpy sceneUpdatedSpy(&sceneModel, SIGNAL(sceneUpdated()));
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  vtkNew<vtkMRMLViewNode> addedNode;
+  scene->AddNode(addedNode.GetPointer());
+  scene->RemoveNode(nodes[0]);
+  nodes[20]->SetName("ModifiedName");
+  // The model is not updated during batch processing
+  QVERIFY(sceneModel.itemFromNode(addedNode.GetPointer()) == nullptr);
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 1000);
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  QCOMPARE(sceneUpdatedSpy.count(), 1);
+
+  // Only the changed items are updated
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 1000);
+  QVERIFY(sceneModel.itemFromNode(addedNode.GetPointer()) != nullptr);
+  QCOMPARE(sceneModel.indexFromNode(addedNode.GetPointer()).row(), 999);
+  QCOMPARE(sceneModel.itemFromNode(nodes[20])->text(), QString("ModifiedName"));
+  QCOMPARE(sceneModel.itemFromNode(nodes[10]), unchangedItem);
+
+  // Many changes rebuild the model
+  scene->StartState(vtkMRMLScene::BatchProcessState);
+  for (int i = 0; i < 500; ++i)
+    {
+    vtkNew<vtkMRMLViewNode> node;
+    scene->AddNode(node.GetPointer());
+    }
+  scene->EndState(vtkMRMLScene::BatchProcessState);
+  QCOMPARE(sceneUpdatedSpy.count(), 2);
+  QCOMPARE(sceneModel.rowCount(sceneModel.mrmlSceneIndex()), 1500);
+  QCOMPARE(sceneModel.itemFromNode(nodes[20])->text(), QString("ModifiedName"));
+}
+
 // ----------------------------------------------------------------------------
 CTK_TEST_MAIN(qMRMLSceneModelTest)
 #include "moc_qMRMLSceneModelTest.cxx"
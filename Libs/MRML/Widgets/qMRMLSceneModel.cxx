@@ -47,6 +47,7 @@ qMRMLSceneModelPrivate::qMRMLSceneModelPrivate(qMRMLSceneModel& object)
   this->LazyUpdate = false;
   this->ListenNodeModifiedEvent = qMRMLSceneModel::NoNodes;
   this->PendingItemModified = -1; // -1 means not updating
+  this->PendingFullUpdate = false;
 
   this->NameColumn = -1;
   this->IDColumn = -1;
@@ -90,26 +91,25 @@ void qMRMLSceneModelPrivate::init()
 
 //------------------------------------------------------------------------------
 QModelIndexList qMRMLSceneModelPrivate::indexes(const QString& nodeID)const
+{
+  vtkMRMLNode* node = this->MRMLScene ? this->MRMLScene->GetNodeByID(nodeID.toUtf8()) : nullptr;
+  return this->indexes(node, nodeID);
+}
+
+//------------------------------------------------------------------------------
+QModelIndexList qMRMLSceneModelPrivate::indexes(vtkMRMLNode* node, const QString& nodeUID)const
 {
   Q_Q(const qMRMLSceneModel);
-  QModelIndex scene = q->mrmlSceneIndex();
-  if (scene == QModelIndex())
-    {
-    return QModelIndexList();
-    }
-  // QAbstractItemModel::match doesn't browse through columns
-  // we need to do it manually
-  QModelIndexList nodeIndexes = q->match(
-    scene, qMRMLSceneModel::UIDRole, nodeID,
-    1, Qt::MatchExactly | Qt::MatchRecursive);
-  Q_ASSERT(nodeIndexes.size() <= 1); // we know for sure it won't be more than 1
-  if (nodeIndexes.size() == 0)
+  QModelIndexList nodeIndexes;
+  QModelIndex nodeIndex = this->indexFromNode(node, nodeUID);
+  if (!nodeIndex.isValid())
     {
     return nodeIndexes;
     }
+  nodeIndexes << nodeIndex;
   // Add the QModelIndexes from the other columns
-  const int row = nodeIndexes[0].row();
-  QModelIndex nodeParentIndex = nodeIndexes[0].parent();
+  const int row = nodeIndex.row();
+  QModelIndex nodeParentIndex = nodeIndex.parent();
   const int sceneColumnCount = q->columnCount(nodeParentIndex);
   for (int j = 1; j < sceneColumnCount; ++j)
     {
@@ -118,6 +118,52 @@ QModelIndexList qMRMLSceneModelPrivate::indexes(const QString& nodeID)const
   return nodeIndexes;
 }
 
+//------------------------------------------------------------------------------
+QModelIndex qMRMLSceneModelPrivate::indexFromNode(vtkMRMLNode* node, const QString& nodeUID)const
+{
+  Q_Q(const qMRMLSceneModel);
+  QModelIndex sceneIndex = q->mrmlSceneIndex();
+  if (!sceneIndex.isValid() || nodeUID.isEmpty())
+    {
+    return QModelIndex();
+    }
+
+  // Try to find the nodeIndex in the cache first
+  QHash<vtkMRMLNode*,QPersistentModelIndex>::iterator rowCacheIt = this->RowCache.end();
+  if (node)
+    {
+    rowCacheIt = this->RowCache.find(node);
+    if (rowCacheIt == this->RowCache.end())
+      {
+      // not found in cache, therefore it cannot be in the model
+      return QModelIndex();
+      }
+    if (rowCacheIt.value().isValid()
+      && rowCacheIt.value().data(qMRMLSceneModel::UIDRole).toString() == nodeUID)
+      {
+      // The item at the cached index matches the requested node ID
+      return rowCacheIt.value();
+      }
+    }
+
+  // The cache was not up-to-date. Do a slow linear search.
+  // QAbstractItemModel::match only search through the first column
+  // (because scene is in the first column)
+  QModelIndexList nodeIndexes = q->match(
+    sceneIndex, qMRMLSceneModel::UIDRole, nodeUID,
+    1, Qt::MatchExactly | Qt::MatchRecursive);
+  Q_ASSERT(nodeIndexes.size() <= 1); // we know for sure it won't be more than 1
+  if (nodeIndexes.size() == 0)
+    {
+    return QModelIndex();
+    }
+  if (rowCacheIt != this->RowCache.end())
+    {
+    rowCacheIt.value() = nodeIndexes[0];
+    }
+  return nodeIndexes[0];
+}
+
 //------------------------------------------------------------------------------
 void qMRMLSceneModelPrivate::listenNodeModifiedEvent()
 {
@@ -253,6 +299,129 @@ void qMRMLSceneModelPrivate::reparentItems(
   newParentItem->insertRow(pos, children);
 }
 
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::removeNodeItem(const QModelIndex& nodeIndex)
+{
+  Q_Q(qMRMLSceneModel);
+  QStandardItem* item = q->itemFromIndex(nodeIndex.sibling(nodeIndex.row(),0));
+  if (!item)
+    {
+    return;
+    }
+  // The children may be lost if not reparented, we ensure they got reparented.
+  while (item->rowCount())
+    {
+    // we need to remove the children from the node to remove because they
+    // would be automatically deleted in QStandardItemModel::removeRow()
+    this->Orphans.push_back(item->takeRow(0));
+    }
+  // Remove the item from any orphan list if it exist as we don't want to
+  // add it back later in reparentOrphans()
+  foreach(QList<QStandardItem*> orphans, this->Orphans)
+    {
+    if (orphans.contains(item))
+      {
+      this->Orphans.removeAll(orphans);
+      }
+    }
+  q->removeRow(nodeIndex.row(), nodeIndex.parent());
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::reparentOrphans()
+{
+  Q_Q(qMRMLSceneModel);
+  foreach(QList<QStandardItem*> orphans, this->Orphans)
+    {
+    QStandardItem* orphan = orphans[0];
+    // Make sure that the orphans have not already been reparented.
+    if (orphan->parent())
+      {
+      // Not sure how it is possible, but if it is, then we might want to
+      // review the logic behind.
+      Q_ASSERT(orphan->parent() == nullptr);
+      continue;
+      }
+    vtkMRMLNode* node = q->mrmlNodeFromItem(orphan);
+    int newIndex = q->nodeIndex(node);
+    QStandardItem* newParentItem = q->itemFromNode(q->parentNode(node));
+    if (newParentItem == nullptr)
+      {
+      newParentItem = q->mrmlSceneItem();
+      }
+    Q_ASSERT(newParentItem);
+    this->reparentItems(orphans, newIndex, newParentItem);
+    }
+  this->Orphans.clear();
+}
+
+//------------------------------------------------------------------------------
+bool qMRMLSceneModelPrivate::applyPendingBatchChanges()
+{
+  Q_Q(qMRMLSceneModel);
+  if (this->PendingFullUpdate || !this->MRMLScene || !q->mrmlSceneItem())
+    {
+    return false;
+    }
+  // Inserting a node requires a traversal of the scene, therefore
+  // rebuilding the model is faster if many nodes have changed.
+  const int numberOfChanges = this->PendingAddedNodes.count()
+    + this->PendingRemovedIndexes.count() + this->PendingModifiedNodes.count();
+  if (numberOfChanges > qMax(100, this->MRMLScene->GetNumberOfNodes() / 10))
+    {
+    return false;
+    }
+
+  foreach(const QPersistentModelIndex& removedIndex, this->PendingRemovedIndexes)
+    {
+    if (removedIndex.isValid())
+      {
+      this->removeNodeItem(removedIndex);
+      }
+    }
+  if (!this->Orphans.isEmpty())
+    {
+    // Children of removed nodes may have been removed or reparented as well,
+    // it is simpler to rebuild the hierarchy.
+    foreach(QList<QStandardItem*> orphans, this->Orphans)
+      {
+      qDeleteAll(orphans);
+      }
+    this->Orphans.clear();
+    return false;
+    }
+
+  foreach(vtkMRMLNode* addedNode, this->PendingAddedNodes)
+    {
+    if (addedNode && addedNode->GetScene() == this->MRMLScene && !q->itemFromNode(addedNode))
+      {
+      q->insertNode(addedNode);
+      }
+    }
+
+  foreach(vtkMRMLNode* modifiedNode, this->PendingModifiedNodes)
+    {
+    if (modifiedNode && modifiedNode->GetScene() == this->MRMLScene && modifiedNode->GetID()
+      && this->RowCache.contains(modifiedNode))
+      {
+      q->updateNodeItems(modifiedNode, QString(modifiedNode->GetID()));
+      }
+    }
+
+  this->clearPendingBatchChanges();
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void qMRMLSceneModelPrivate::clearPendingBatchChanges()
+{
+  this->PendingAddedNodes.clear();
+  this->PendingRemovedIndexes.clear();
+  this->PendingModifiedNodes.clear();
+  this->PendingModifiedNodesSet.clear();
+  this->PendingFullUpdate = false;
+}
+
 //------------------------------------------------------------------------------
 // qMRMLSceneModel
 //------------------------------------------------------------------------------
@@ -438,54 +607,15 @@ QModelIndex qMRMLSceneModel::indexFromNode(vtkMRMLNode* node, int column)const
     return QModelIndex();
     }
 
-  QModelIndex nodeIndex;
-
-  // Try to find the nodeIndex in the cache first
-  QMap<vtkMRMLNode*,QPersistentModelIndex>::iterator rowCacheIt=d->RowCache.find(node);
-  if (rowCacheIt==d->RowCache.end())
-    {
-    // not found in cache, therefore it cannot be in the model
-    return nodeIndex;
-    }
-  if (rowCacheIt.value().isValid())
-    {
-    // An entry found in the cache. If the item at the cached index matches the requested node ID
-    // then we use it.
-    QStandardItem* nodeItem = this->itemFromIndex(rowCacheIt.value());
-    if (nodeItem!=nullptr)
-      {
-      if (nodeItem->data(qMRMLSceneModel::UIDRole).toString().compare(QString::fromUtf8(node->GetID()))==0)
-        {
-        // id matched
-        nodeIndex=rowCacheIt.value();
-        }
-      }
-    }
-
-  // The cache was not up-to-date. Do a slow linear search.
+  QModelIndex nodeIndex = d->indexFromNode(node, QString::fromUtf8(node->GetID()));
   if (!nodeIndex.isValid())
     {
-    // QAbstractItemModel::match doesn't browse through columns
-    // we need to do it manually
-    QModelIndexList nodeIndexes = this->match(
-      this->mrmlSceneIndex(), qMRMLSceneModel::UIDRole, QString(node->GetID()),
-      1, Qt::MatchExactly | Qt::MatchRecursive);
-    Q_ASSERT(nodeIndexes.size() <= 1); // we know for sure it won't be more than 1
-    if (nodeIndexes.size() == 0)
-      {
-      // maybe the node hasn't been added to the scene yet...
-      // (if it's called from populateScene/inserteNode)
-      d->RowCache.remove(node);
-      return QModelIndex();
-      }
-    nodeIndex=nodeIndexes[0];
-    d->RowCache[node]=nodeIndex;
+    // maybe the node hasn't been added to the scene yet...
+    // (if it's called from populateScene/inserteNode)
+    return QModelIndex();
     }
   if (column == 0)
     {
-    // QAbstractItemModel::match only search through the first column
-    // (because scene is in the first column)
-    Q_ASSERT(nodeIndex.isValid());
     return nodeIndex;
     }
   // Add the QModelIndexes from the other columns
@@ -499,7 +629,7 @@ QModelIndex qMRMLSceneModel::indexFromNode(vtkMRMLNode* node, int column)const
 QModelIndexList qMRMLSceneModel::indexes(vtkMRMLNode* node)const
 {
   Q_D(const qMRMLSceneModel);
-  return d->indexes(QString(node->GetID()));
+  return d->indexes(node, QString(node->GetID()));
 }
 
 //------------------------------------------------------------------------------
@@ -697,6 +827,8 @@ void qMRMLSceneModel::updateScene()
                  this, SLOT(onMRMLNodeIDChanged(vtkObject*,void*)));
 
   d->RowCache.clear();
+  // The model is rebuilt from the scene, recorded changes are not needed anymore
+  d->clearPendingBatchChanges();
 
   // Enabled so it can be interacted with
   this->invisibleRootItem()->setFlags(Qt::ItemIsEnabled);
@@ -1189,12 +1321,18 @@ void qMRMLSceneModel::onMRMLSceneNodeAdded(vtkMRMLScene* scene, vtkMRMLNode* nod
   Q_ASSERT(scene == d->MRMLScene);
   Q_ASSERT(vtkMRMLNode::SafeDownCast(node));
 
-  if (d->MRMLScene->IsImporting() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsImporting())
     {
     // Node IDs and references are not valid until the import is completed, therefore do not attempt
     // to add a node during importing (see https://issues.slicer.org/view.php?id=4080).
     return;
     }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    // The node is inserted at the end of batch processing
+    d->PendingAddedNodes << node;
+    return;
+    }
   this->insertNode(node);
 }
 
@@ -1206,10 +1344,23 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
   Q_UNUSED(scene);
   Q_ASSERT(scene == d->MRMLScene);
 
-  if (d->MRMLScene->IsClosing() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsClosing())
     {
     return;
     }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    // The item is removed at the end of batch processing
+    qvtkDisconnect(node, vtkCommand::NoEvent, this, nullptr);
+    QModelIndex nodeIndex = d->indexFromNode(node, QString(node->GetID()));
+    if (nodeIndex.isValid())
+      {
+      d->PendingRemovedIndexes << QPersistentModelIndex(nodeIndex);
+      }
+    d->RowCache.remove(node);
+    d->PendingModifiedNodesSet.remove(node);
+    return;
+    }
 
   int connectionsRemoved =
     qvtkDisconnect(node, vtkCommand::ModifiedEvent,
@@ -1226,31 +1377,12 @@ void qMRMLSceneModel::onMRMLSceneNodeAboutToBeRemoved(vtkMRMLScene* scene, vtkMR
   // Remove all the observations on the node
   qvtkDisconnect(node, vtkCommand::NoEvent, this, nullptr);
 
-  // TODO: can be fasten by browsing the tree only once
-  QModelIndexList indexes = this->match(this->mrmlSceneIndex(), qMRMLSceneModel::UIDRole,
-                                        QString(node->GetID()), 1,
-                                        Qt::MatchExactly | Qt::MatchRecursive);
-  if (indexes.count())
+  QModelIndex nodeIndex = d->indexFromNode(node, QString(node->GetID()));
+  if (nodeIndex.isValid())
     {
-    QStandardItem* item = this->itemFromIndex(indexes[0].sibling(indexes[0].row(),0));
-    // The children may be lost if not reparented, we ensure they got reparented.
-    while (item->rowCount())
-      {
-      // we need to remove the children from the node to remove because they
-      // would be automatically deleted in QStandardItemModel::removeRow()
-      d->Orphans.push_back(item->takeRow(0));
-      }
-    // Remove the item from any orphan list if it exist as we don't want to
-    // add it back later in onMRMLSceneNodeRemoved
-    foreach(QList<QStandardItem*> orphans, d->Orphans)
-      {
-      if (orphans.contains(item))
-        {
-        d->Orphans.removeAll(orphans);
-        }
-      }
-    this->removeRow(indexes[0].row(), indexes[0].parent());
+    d->removeNodeItem(nodeIndex);
     }
+  d->RowCache.remove(node);
 }
 
 //------------------------------------------------------------------------------
@@ -1266,28 +1398,7 @@ void qMRMLSceneModel::onMRMLSceneNodeRemoved(vtkMRMLScene* scene, vtkMRMLNode* n
   // The removed node may had children, if they haven't been updated, they
   // are likely to be lost (not reachable when browsing the model), we need
   // to reparent them.
-  foreach(QList<QStandardItem*> orphans, d->Orphans)
-    {
-    QStandardItem* orphan = orphans[0];
-    // Make sure that the orphans have not already been reparented.
-    if (orphan->parent())
-      {
-      // Not sure how it is possible, but if it is, then we might want to
-      // review the logic behind.
-      Q_ASSERT(orphan->parent() == nullptr);
-      continue;
-      }
-    vtkMRMLNode* node = this->mrmlNodeFromItem(orphan);
-    int newIndex = this->nodeIndex(node);
-    QStandardItem* newParentItem = this->itemFromNode(this->parentNode(node));
-    if (newParentItem == nullptr)
-      {
-      newParentItem = this->mrmlSceneItem();
-      }
-    Q_ASSERT(newParentItem);
-    d->reparentItems(orphans, newIndex, newParentItem);
-    }
-  d->Orphans.clear();
+  d->reparentOrphans();
 }
 
 //------------------------------------------------------------------------------
@@ -1358,10 +1469,25 @@ void qMRMLSceneModel::updateNodeItems(vtkMRMLNode* node, const QString& nodeUID)
 {
   Q_D(qMRMLSceneModel);
 
-  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsImporting() || (d->LazyUpdate && d->MRMLScene->IsBatchProcessing()))
+  if (d->MRMLScene->IsClosing() || d->MRMLScene->IsImporting())
     {
     return;
     }
+  if (d->LazyUpdate && d->MRMLScene->IsBatchProcessing())
+    {
+    // The items are updated at the end of batch processing
+    if (node && node->GetID() && nodeUID != QString(node->GetID()))
+      {
+      // node ID changed, the item cannot be found by the new ID
+      d->PendingFullUpdate = true;
+      }
+    else if (node && !d->PendingModifiedNodesSet.contains(node))
+      {
+      d->PendingModifiedNodesSet.insert(node);
+      d->PendingModifiedNodes << node;
+      }
+    return;
+    }
 
   // If there is no node here or if the node has no scene. that means the node
   // has been removed from the scene but the scene model hasn't been notified
@@ -1375,7 +1501,7 @@ void qMRMLSceneModel::updateNodeItems(vtkMRMLNode* node, const QString& nodeUID)
     return;
     }
   //Q_ASSERT(node->GetScene()->IsNodePresent(node));
-  QModelIndexList nodeIndexes = d->indexes(nodeUID);
+  QModelIndexList nodeIndexes = d->indexes(node, nodeUID);
   //qDebug() << "onMRMLNodeModified" << node->GetID() << nodeIndexes;
   Q_ASSERT(nodeIndexes.count());
   for (int i = 0; i < nodeIndexes.size(); ++i)
@@ -1518,7 +1644,11 @@ void qMRMLSceneModel::onMRMLSceneEndBatchProcess(vtkMRMLScene* scene)
   Q_UNUSED(scene);
   if (d->LazyUpdate)
     {
-    this->updateScene();
+    // Apply only the changes made during batch processing, if possible
+    if (!d->applyPendingBatchChanges())
+      {
+      this->updateScene();
+      }
     emit sceneUpdated();
     }
 }
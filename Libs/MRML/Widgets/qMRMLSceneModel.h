@@ -72,6 +72,9 @@ class QMRML_WIDGETS_EXPORT qMRMLSceneModel : public QStandardItemModel
   /// If LazyUpdate is true, the model ignores added node events when the
   /// scene is importing/restoring, but synchronize with the scene once its
   /// imported/restored.
+  /// Nodes added, removed, or modified during batch processing are recorded
+  /// and the model is updated only for these nodes at the end of the batch
+  /// processing (the model is rebuilt if many nodes have changed).
   Q_PROPERTY (bool lazyUpdate READ lazyUpdate WRITE setLazyUpdate)
 
   /// Control in which column vtkMRMLNode names are displayed (Qt::DisplayRole).
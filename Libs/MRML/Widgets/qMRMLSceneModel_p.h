@@ -35,7 +35,8 @@
 // Qt includes
 class QStandardItemModel;
 #include <QFlags>
-#include <QMap>
+#include <QHash>
+#include <QSet>
 
 // qMRML includes
 #include "qMRMLSceneModel.h"
@@ -46,6 +47,7 @@ class vtkMRMLScene;
 // VTK includes
 #include <vtkCallbackCommand.h>
 #include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
 
 //------------------------------------------------------------------------------
 // qMRMLSceneModelPrivate
@@ -61,6 +63,13 @@ public:
   void init();
 
   QModelIndexList indexes(const QString& nodeID)const;
+  /// Return all the indexes (all the columns) of the item of the node.
+  /// \param nodeUID ID that the item of the node is stored with. It is different from
+  ///   the current node ID when the node ID has just changed.
+  QModelIndexList indexes(vtkMRMLNode* node, const QString& nodeUID)const;
+  /// Return the index (first column) of the item of the node.
+  /// The row cache is used if it is up-to-date, otherwise the model is searched.
+  QModelIndex indexFromNode(vtkMRMLNode* node, const QString& nodeUID)const;
 
   QStringList extraItems(QStandardItem* parent, const QString& extraType)const;
   void insertExtraItem(int row, QStandardItem* parent,
@@ -71,6 +80,17 @@ public:
   void listenNodeModifiedEvent();
   void reparentItems(QList<QStandardItem*>& children, int newIndex, QStandardItem* newParent);
 
+  /// Remove the item of a node. Children of the item are kept in Orphans.
+  void removeNodeItem(const QModelIndex& nodeIndex);
+  /// Insert the orphan items at the position of their node.
+  void reparentOrphans();
+
+  /// Apply changes recorded during batch processing (with LazyUpdate enabled)
+  /// to the model. Returns false if the model needs to be rebuilt instead
+  /// (the recorded changes are not applicable or there are too many of them).
+  bool applyPendingBatchChanges();
+  void clearPendingBatchChanges();
+
   /// This method is called by qMRMLSceneModel::populateScene() to speed up
   /// the loading of large scene. By explicitly specifying the \a index, it
   /// skips repetitive scene traversal calls caused by
@@ -102,11 +122,22 @@ public:
   QList<QList<QStandardItem*> > Orphans;
 
   // Map from MRML node to row.
-  // It just stores the result of the latest lookup by indexFromNode,
-  // not guaranteed to contain up-to-date information, should be just used
-  // as a search hint. If the node cannot be found at the given index then
-  // we need to browse through all model items.
-  mutable QMap<vtkMRMLNode*,QPersistentModelIndex> RowCache;
+  // All nodes in the model have an entry, which is added when the item of
+  // the node is inserted and removed when the node is removed. The stored
+  // index is updated by Qt when rows are inserted or removed, but it becomes
+  // invalid if the item is moved (taken and inserted again), therefore
+  // it is just a search hint: if the node cannot be found at the given index
+  // then we need to browse through all model items.
+  mutable QHash<vtkMRMLNode*,QPersistentModelIndex> RowCache;
+
+  // Changes recorded during batch processing when LazyUpdate is enabled.
+  // They are applied to the model at the end of batch processing.
+  QList<vtkWeakPointer<vtkMRMLNode> > PendingAddedNodes;
+  QList<QPersistentModelIndex> PendingRemovedIndexes;
+  QList<vtkWeakPointer<vtkMRMLNode> > PendingModifiedNodes;
+  QSet<vtkMRMLNode*> PendingModifiedNodesSet;
+  // Set if a change cannot be applied incrementally (e.g., node ID changed)
+  bool PendingFullUpdate;
 };
 
 #endif
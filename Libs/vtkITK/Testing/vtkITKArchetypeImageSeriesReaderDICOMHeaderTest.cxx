@@ -0,0 +1,307 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+=========================================================================*/
+
+// vtkITK includes
+#include <vtkITKArchetypeImageSeriesScalarReader.h>
+#include <vtkITKConfigure.h>
+
+// VTK includes
+#include <vtkNew.h>
+
+// ITK includes
+#include <itkFactoryRegistration.h>
+#include <itkGDCMImageIO.h>
+#include <itkImage.h>
+#include <itkImageFileWriter.h>
+#include <itkMetaDataObject.h>
+#include <itksys/SystemTools.hxx>
+
+// STD includes
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_SLICES = 6;
+const char* SERIES_A_UID = "1.2.826.0.1.3680043.2.1125.1.1";
+const char* SERIES_B_UID = "1.2.826.0.1.3680043.2.1125.1.2";
+
+/// Result of reading the headers that must not depend on the number of threads
+struct DICOMHeaderGrouping
+{
+  std::vector<std::string> SeriesInstanceUIDs;
+  unsigned int NumberOfSliceLocations{0};
+  unsigned int NumberOfImagePositions{0};
+  std::vector<std::string> FileNames;
+};
+
+//----------------------------------------------------------------------------
+std::string GetSliceFileName(const std::string& tempDir, int sliceIndex)
+{
+  std::ostringstream fileName;
+  fileName << tempDir << "/vtkITKArchetypeImageSeriesReaderDICOMHeaderTest_" << sliceIndex << ".dcm";
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
+bool WriteDICOMSlice(const std::string& fileName, const std::string& seriesInstanceUID, int sliceIndex)
+{
+  typedef itk::Image<short, 3> ImageType;
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType size;
+  size[0] = 4;
+  size[1] = 4;
+  size[2] = 1;
+  ImageType::RegionType region;
+  region.SetSize(size);
+  image->SetRegions(region);
+  image->Allocate();
+  image->FillBuffer(static_cast<short>(sliceIndex));
+  ImageType::PointType origin;
+  origin[0] = 0.0;
+  origin[1] = 0.0;
+  origin[2] = 2.0 * sliceIndex;
+  image->SetOrigin(origin);
+
+  std::ostringstream instanceNumber;
+  instanceNumber << sliceIndex + 1;
+  std::ostringstream sopInstanceUID;
+  sopInstanceUID << seriesInstanceUID << "." << sliceIndex + 1;
+  std::ostringstream imagePosition;
+  imagePosition << "0\\0\\" << origin[2];
+  std::ostringstream sliceLocation;
+  sliceLocation << origin[2];
+
+  itk::MetaDataDictionary& dictionary = image->GetMetaDataDictionary();
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0016", "1.2.840.10008.5.1.4.1.1.2");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0018", sopInstanceUID.str());
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", "CT");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000d", "1.2.826.0.1.3680043.2.1125.1");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", seriesInstanceUID);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", instanceNumber.str());
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0032", imagePosition.str());
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0037", "1\\0\\0\\0\\1\\0");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|1041", sliceLocation.str());
+
+  itk::GDCMImageIO::Pointer gdcmIO = itk::GDCMImageIO::New();
+  gdcmIO->KeepOriginalUIDOn();
+  itk::ImageFileWriter<ImageType>::Pointer writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(gdcmIO);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  try
+    {
+    writer->Update();
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    std::cerr << "Failed to write " << fileName << ": " << err << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool WriteDICOMSeries(const std::string& tempDir)
+{
+  for (int sliceIndex = 0; sliceIndex < NUMBER_OF_SLICES; ++sliceIndex)
+    {
+    const char* seriesInstanceUID = (sliceIndex < NUMBER_OF_SLICES / 2 ? SERIES_A_UID : SERIES_B_UID);
+    if (!WriteDICOMSlice(GetSliceFileName(tempDir, sliceIndex), seriesInstanceUID, sliceIndex))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool ReadDICOMHeaders(const std::string& tempDir, int numberOfThreads, DICOMHeaderGrouping& grouping)
+{
+  vtkNew<vtkITKArchetypeImageSeriesScalarReader> reader;
+  reader->SetArchetype(GetSliceFileName(tempDir, 0).c_str());
+  for (int sliceIndex = 0; sliceIndex < NUMBER_OF_SLICES; ++sliceIndex)
+    {
+    reader->AddFileName(GetSliceFileName(tempDir, sliceIndex).c_str());
+    }
+  reader->SetNumberOfThreads(numberOfThreads);
+  reader->SetOutputScalarTypeToNative();
+  reader->SetDesiredCoordinateOrientationToNative();
+  reader->UpdateInformation();
+  if (reader->GetErrorCode() != 0)
+    {
+    std::cerr << "Failed to read DICOM headers with " << numberOfThreads << " threads" << std::endl;
+    return false;
+    }
+
+  grouping = DICOMHeaderGrouping();
+  for (unsigned int k = 0; k < reader->GetNumberOfSeriesInstanceUIDs(); ++k)
+    {
+    grouping.SeriesInstanceUIDs.push_back(reader->GetNthSeriesInstanceUID(k));
+    }
+  grouping.NumberOfSliceLocations = reader->GetNumberOfSliceLocation();
+  grouping.NumberOfImagePositions = reader->GetNumberOfImagePositionPatient();
+  for (unsigned int k = 0; k < reader->GetNumberOfFileNames(); ++k)
+    {
+    grouping.FileNames.push_back(reader->GetFileName(k));
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool HasSeriesInstanceUID(const DICOMHeaderGrouping& grouping, const std::string& seriesInstanceUID)
+{
+  for (const std::string& uid : grouping.SeriesInstanceUIDs)
+    {
+    if (uid == seriesInstanceUID)
+      {
+      return true;
+      }
+    }
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool TestParallelEqualsSerial(const std::string& tempDir)
+{
+  // Headers are parsed again for both readers
+  DICOMHeaderGrouping serialGrouping;
+  vtkITKArchetypeImageSeriesReader::ClearDICOMHeaderCache();
+  if (!ReadDICOMHeaders(tempDir, 1, serialGrouping))
+    {
+    return false;
+    }
+  DICOMHeaderGrouping parallelGrouping;
+  vtkITKArchetypeImageSeriesReader::ClearDICOMHeaderCache();
+  if (!ReadDICOMHeaders(tempDir, 4, parallelGrouping))
+    {
+    return false;
+    }
+
+  if (serialGrouping.SeriesInstanceUIDs.size() != 2
+    || serialGrouping.SeriesInstanceUIDs[0] != SERIES_A_UID
+    || serialGrouping.SeriesInstanceUIDs[1] != SERIES_B_UID)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected series instance UIDs" << std::endl;
+    return false;
+    }
+  if (serialGrouping.FileNames.size() != static_cast<size_t>(NUMBER_OF_SLICES / 2))
+    {
+    std::cerr << "Line " << __LINE__ << ": expected " << NUMBER_OF_SLICES / 2
+      << " files in the archetype series, found " << serialGrouping.FileNames.size() << std::endl;
+    return false;
+    }
+  if (parallelGrouping.SeriesInstanceUIDs != serialGrouping.SeriesInstanceUIDs
+    || parallelGrouping.NumberOfSliceLocations != serialGrouping.NumberOfSliceLocations
+    || parallelGrouping.NumberOfImagePositions != serialGrouping.NumberOfImagePositions
+    || parallelGrouping.FileNames != serialGrouping.FileNames)
+    {
+    std::cerr << "Line " << __LINE__ << ": headers read in parallel are grouped differently" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestCacheInvalidation(const std::string& tempDir)
+{
+  vtkITKArchetypeImageSeriesReader::ClearDICOMHeaderCache();
+  if (vtkITKArchetypeImageSeriesReader::GetNumberOfCachedDICOMHeaders() != 0)
+    {
+    std::cerr << "Line " << __LINE__ << ": cache is not empty after clearing it" << std::endl;
+    return false;
+    }
+  DICOMHeaderGrouping grouping;
+  if (!ReadDICOMHeaders(tempDir, 0, grouping))
+    {
+    return false;
+    }
+  if (vtkITKArchetypeImageSeriesReader::GetNumberOfCachedDICOMHeaders() != NUMBER_OF_SLICES)
+    {
+    std::cerr << "Line " << __LINE__ << ": expected " << NUMBER_OF_SLICES << " cached headers, found "
+      << vtkITKArchetypeImageSeriesReader::GetNumberOfCachedDICOMHeaders() << std::endl;
+    return false;
+    }
+
+  // File size changes: a longer UID is written
+  const std::string longerUID = std::string(SERIES_B_UID) + "3";
+  if (!WriteDICOMSlice(GetSliceFileName(tempDir, NUMBER_OF_SLICES - 1), longerUID, NUMBER_OF_SLICES - 1)
+    || !ReadDICOMHeaders(tempDir, 0, grouping))
+    {
+    return false;
+    }
+  if (!HasSeriesInstanceUID(grouping, longerUID))
+    {
+    std::cerr << "Line " << __LINE__ << ": header of the resized file is taken from the cache" << std::endl;
+    return false;
+    }
+
+  // Modification time changes: a UID of the same length is written
+  // (wait so that the modification time differs even with one second resolution)
+  itksys::SystemTools::Delay(2000);
+  const std::string sameLengthUID = "1.2.826.0.1.3680043.2.1125.1.4";
+  if (!WriteDICOMSlice(GetSliceFileName(tempDir, NUMBER_OF_SLICES - 2), sameLengthUID, NUMBER_OF_SLICES - 2)
+    || !ReadDICOMHeaders(tempDir, 0, grouping))
+    {
+    return false;
+    }
+  if (!HasSeriesInstanceUID(grouping, sameLengthUID))
+    {
+    std::cerr << "Line " << __LINE__ << ": header of the modified file is taken from the cache" << std::endl;
+    return false;
+    }
+
+  // Modified files replace their cache entries
+  if (vtkITKArchetypeImageSeriesReader::GetNumberOfCachedDICOMHeaders() != NUMBER_OF_SLICES)
+    {
+    std::cerr << "Line " << __LINE__ << ": expected " << NUMBER_OF_SLICES << " cached headers, found "
+      << vtkITKArchetypeImageSeriesReader::GetNumberOfCachedDICOMHeaders() << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkITKArchetypeImageSeriesReaderDICOMHeaderTest(int argc, char* argv[])
+{
+#ifndef VTKITK_BUILD_DICOM_SUPPORT
+  std::cout << "DICOM support is not enabled, test skipped" << std::endl;
+  return EXIT_SUCCESS;
+#endif
+
+  itk::itkFactoryRegistration();
+
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  if (!WriteDICOMSeries(tempDir))
+    {
+    return EXIT_FAILURE;
+    }
+  if (!TestParallelEqualsSerial(tempDir))
+    {
+    return EXIT_FAILURE;
+    }
+  if (!TestCacheInvalidation(tempDir))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
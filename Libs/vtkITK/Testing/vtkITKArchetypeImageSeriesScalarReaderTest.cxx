@@ -0,0 +1,289 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+=========================================================================*/
+
+// vtkITK includes
+#include <vtkITKArchetypeImageSeriesScalarReader.h>
+#include <vtkITKConfigure.h>
+
+// VTK includes
+#include <vtkCallbackCommand.h>
+#include <vtkCommand.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+
+// ITK includes
+#include <itkFactoryRegistration.h>
+#include <itkGDCMImageIO.h>
+#include <itkImage.h>
+#include <itkImageFileWriter.h>
+#include <itkMetaDataObject.h>
+
+// STD includes
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_SLICES = 7;
+const int SLICE_SIZE = 8;
+const char* SERIES_UID = "1.2.826.0.1.3680043.2.1125.2.1";
+
+//----------------------------------------------------------------------------
+short VoxelValue(int sliceIndex, int pixelIndex)
+{
+  return static_cast<short>(sliceIndex * 100 + pixelIndex);
+}
+
+//----------------------------------------------------------------------------
+std::string GetSliceFileName(const std::string& tempDir, int sliceIndex)
+{
+  std::ostringstream fileName;
+  fileName << tempDir << "/vtkITKArchetypeImageSeriesScalarReaderTest_" << sliceIndex << ".dcm";
+  return fileName.str();
+}
+
+//----------------------------------------------------------------------------
+bool WriteDICOMSlice(const std::string& fileName, int sliceIndex)
+{
+  typedef itk::Image<short, 3> ImageType;
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType size;
+  size[0] = SLICE_SIZE;
+  size[1] = SLICE_SIZE;
+  size[2] = 1;
+  ImageType::RegionType region;
+  region.SetSize(size);
+  image->SetRegions(region);
+  image->Allocate();
+  short* pixels = image->GetBufferPointer();
+  for (int pixelIndex = 0; pixelIndex < SLICE_SIZE * SLICE_SIZE; ++pixelIndex)
+    {
+    pixels[pixelIndex] = VoxelValue(sliceIndex, pixelIndex);
+    }
+  ImageType::PointType origin;
+  origin[0] = 0.0;
+  origin[1] = 0.0;
+  origin[2] = 1.5 * sliceIndex;
+  image->SetOrigin(origin);
+
+  std::ostringstream instanceNumber;
+  instanceNumber << sliceIndex + 1;
+  std::ostringstream sopInstanceUID;
+  sopInstanceUID << SERIES_UID << "." << sliceIndex + 1;
+  std::ostringstream imagePosition;
+  imagePosition << "0\\0\\" << origin[2];
+
+  itk::MetaDataDictionary& dictionary = image->GetMetaDataDictionary();
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0016", "1.2.840.10008.5.1.4.1.1.2");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0018", sopInstanceUID.str());
+  itk::EncapsulateMetaData<std::string>(dictionary, "0008|0060", "CT");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000d", "1.2.826.0.1.3680043.2.1125.2");
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|000e", SERIES_UID);
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0013", instanceNumber.str());
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0032", imagePosition.str());
+  itk::EncapsulateMetaData<std::string>(dictionary, "0020|0037", "1\\0\\0\\0\\1\\0");
+
+  itk::GDCMImageIO::Pointer gdcmIO = itk::GDCMImageIO::New();
+  gdcmIO->KeepOriginalUIDOn();
+  itk::ImageFileWriter<ImageType>::Pointer writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(gdcmIO);
+  writer->SetFileName(fileName);
+  writer->SetInput(image);
+  try
+    {
+    writer->Update();
+    }
+  catch (itk::ExceptionObject& err)
+    {
+    std::cerr << "Failed to write " << fileName << ": " << err << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void ProgressCallback(vtkObject* caller, unsigned long vtkNotUsed(eid), void* clientData, void* vtkNotUsed(callData))
+{
+  vtkAlgorithm* algorithm = vtkAlgorithm::SafeDownCast(caller);
+  double* lastProgress = reinterpret_cast<double*>(clientData);
+  *lastProgress = algorithm->GetProgress();
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> ReadSeries(const std::string& tempDir, int numberOfThreads, bool nativeOrientation)
+{
+  vtkNew<vtkITKArchetypeImageSeriesScalarReader> reader;
+  reader->SetArchetype(GetSliceFileName(tempDir, 0).c_str());
+  for (int sliceIndex = 0; sliceIndex < NUMBER_OF_SLICES; ++sliceIndex)
+    {
+    reader->AddFileName(GetSliceFileName(tempDir, sliceIndex).c_str());
+    }
+  reader->SetNumberOfThreads(numberOfThreads);
+  reader->SetOutputScalarTypeToNative();
+  if (nativeOrientation)
+    {
+    reader->SetDesiredCoordinateOrientationToNative();
+    }
+  else
+    {
+    reader->SetDesiredCoordinateOrientationToAxial();
+    }
+  double lastProgress = 0.0;
+  vtkNew<vtkCallbackCommand> progressCallback;
+  progressCallback->SetCallback(ProgressCallback);
+  progressCallback->SetClientData(&lastProgress);
+  reader->AddObserver(vtkCommand::ProgressEvent, progressCallback.GetPointer());
+  reader->Update();
+  if (reader->GetErrorCode() != 0)
+    {
+    std::cerr << "Failed to read series with " << numberOfThreads << " threads" << std::endl;
+    return nullptr;
+    }
+  // Slices read in parallel report progress from the calling thread
+  if (numberOfThreads > 1 && lastProgress != 1.0)
+    {
+    std::cerr << "Reading series with " << numberOfThreads << " threads finished with progress "
+      << lastProgress << std::endl;
+    return nullptr;
+    }
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->DeepCopy(reader->GetOutput());
+  return image;
+}
+
+//----------------------------------------------------------------------------
+bool CheckVoxels(vtkImageData* image)
+{
+  int* dimensions = image->GetDimensions();
+  if (dimensions[0] != SLICE_SIZE || dimensions[1] != SLICE_SIZE || dimensions[2] != NUMBER_OF_SLICES
+    || image->GetScalarType() != VTK_SHORT)
+    {
+    std::cerr << "Line " << __LINE__ << ": unexpected dimensions " << dimensions[0] << ", "
+      << dimensions[1] << ", " << dimensions[2] << " or scalar type " << image->GetScalarTypeAsString() << std::endl;
+    return false;
+    }
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  for (int sliceIndex = 0; sliceIndex < NUMBER_OF_SLICES; ++sliceIndex)
+    {
+    for (int pixelIndex = 0; pixelIndex < SLICE_SIZE * SLICE_SIZE; ++pixelIndex)
+      {
+      short voxel = voxels[sliceIndex * SLICE_SIZE * SLICE_SIZE + pixelIndex];
+      if (voxel != VoxelValue(sliceIndex, pixelIndex))
+        {
+        std::cerr << "Line " << __LINE__ << ": slice " << sliceIndex << " pixel " << pixelIndex
+          << ": expected " << VoxelValue(sliceIndex, pixelIndex) << ", actual " << voxel << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool CheckSameImage(vtkImageData* image, vtkImageData* expectedImage)
+{
+  int* dimensions = image->GetDimensions();
+  int* expectedDimensions = expectedImage->GetDimensions();
+  double* spacing = image->GetSpacing();
+  double* expectedSpacing = expectedImage->GetSpacing();
+  double* origin = image->GetOrigin();
+  double* expectedOrigin = expectedImage->GetOrigin();
+  for (int i = 0; i < 3; ++i)
+    {
+    if (dimensions[i] != expectedDimensions[i] || spacing[i] != expectedSpacing[i] || origin[i] != expectedOrigin[i])
+      {
+      std::cerr << "Line " << __LINE__ << ": geometry of the image read in parallel differs" << std::endl;
+      return false;
+      }
+    }
+  if (image->GetScalarType() != expectedImage->GetScalarType())
+    {
+    std::cerr << "Line " << __LINE__ << ": scalar type of the image read in parallel differs" << std::endl;
+    return false;
+    }
+  short* voxels = static_cast<short*>(image->GetScalarPointer());
+  short* expectedVoxels = static_cast<short*>(expectedImage->GetScalarPointer());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+    {
+    if (voxels[i] != expectedVoxels[i])
+      {
+      std::cerr << "Line " << __LINE__ << ": voxel " << i << ": expected " << expectedVoxels[i]
+        << ", actual " << voxels[i] << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestReadSlicesInParallel(const std::string& tempDir, bool nativeOrientation)
+{
+  // One thread reads the slices with the series reader
+  vtkSmartPointer<vtkImageData> serialImage = ReadSeries(tempDir, 1, nativeOrientation);
+  if (!serialImage || (nativeOrientation && !CheckVoxels(serialImage)))
+    {
+    return false;
+    }
+  // More slices than threads, so that threads read multiple slices
+  vtkSmartPointer<vtkImageData> parallelImage = ReadSeries(tempDir, 3, nativeOrientation);
+  if (!parallelImage || !CheckSameImage(parallelImage, serialImage))
+    {
+    return false;
+    }
+  // More threads than slices
+  parallelImage = ReadSeries(tempDir, 2 * NUMBER_OF_SLICES, nativeOrientation);
+  if (!parallelImage || !CheckSameImage(parallelImage, serialImage))
+    {
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkITKArchetypeImageSeriesScalarReaderTest(int argc, char* argv[])
+{
+#ifndef VTKITK_BUILD_DICOM_SUPPORT
+  std::cout << "DICOM support is not enabled, test skipped" << std::endl;
+  return EXIT_SUCCESS;
+#endif
+
+  itk::itkFactoryRegistration();
+
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+
+  for (int sliceIndex = 0; sliceIndex < NUMBER_OF_SLICES; ++sliceIndex)
+    {
+    if (!WriteDICOMSlice(GetSliceFileName(tempDir, sliceIndex), sliceIndex))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  if (!TestReadSlicesInParallel(tempDir, true))
+    {
+    return EXIT_FAILURE;
+    }
+  if (!TestReadSlicesInParallel(tempDir, false))
+    {
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
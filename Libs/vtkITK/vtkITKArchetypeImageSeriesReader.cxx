@@ -39,6 +39,11 @@
 
 // STD includes
 #include <algorithm>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 #include "itkArchetypeSeriesFileNames.h"
@@ -50,6 +55,61 @@
 #include "itkGDCMImageIO.h"
 #endif
 
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+namespace
+{
+
+/// DICOM tags that are used for grouping files, without spaces
+struct DICOMHeaderTags
+{
+  std::string SeriesInstanceUID;
+  std::string ContentTime;
+  std::string TriggerTime;
+  std::string EchoNumbers;
+  std::string DiffusionGradientOrientation;
+  std::string SliceLocation;
+  std::string ImageOrientationPatient;
+  std::string ImagePositionPatient;
+};
+
+/// Tags of a file, valid as long as the file modification time and size do not change
+struct CachedDICOMHeader
+{
+  long ModifiedTime{0};
+  unsigned long FileLength{0};
+  DICOMHeaderTags Tags;
+};
+
+/// Headers parsed by any reader, so that loading the same files again does not parse them again.
+/// The cache is emptied when it grows above the maximum size.
+std::mutex DICOMHeaderCacheMutex;
+std::map<std::string, CachedDICOMHeader> DICOMHeaderCache;
+const size_t MaximumNumberOfCachedDICOMHeaders = 100000;
+
+//----------------------------------------------------------------------------
+/// Append value to values if it is not present yet and return its index.
+/// Returns -1 for empty value.
+int InsertUniqueValue(const std::string& value, std::vector<std::string>& values,
+  std::map<std::string, int>& valueIndices)
+{
+  if (value.empty())
+    {
+    return -1;
+    }
+  std::map<std::string, int>::iterator valueIt = valueIndices.find(value);
+  if (valueIt != valueIndices.end())
+    {
+    return valueIt->second;
+    }
+  int index = static_cast<int>(values.size());
+  values.push_back(value);
+  valueIndices[value] = index;
+  return index;
+}
+
+} // end of anonymous namespace
+#endif
+
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesReader);
 
 //----------------------------------------------------------------------------
@@ -91,6 +151,7 @@ vtkITKArchetypeImageSeriesReader::vtkITKArchetypeImageSeriesReader()
   this->ImageOrientationPatient.resize( 0 );
 
   this->AnalyzeHeader = true;
+  this->NumberOfThreads = 0;
 
   this->GroupingByTags = false;
   this->IsOnlyFile = false;
@@ -176,6 +237,7 @@ void vtkITKArchetypeImageSeriesReader::PrintSelf(ostream& os, vtkIndent indent)
     os << ", " << this->DefaultDataOrigin[idx];
     }
   os << ")\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
 #ifdef VTKITK_BUILD_DICOM_SUPPORT
   os << indent << "DICOMImageIOApproach: " << this->GetDICOMImageIOApproach();
 #else
@@ -1208,6 +1270,26 @@ std::string vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(const itk
   return tagValue;
 }
 
+//----------------------------------------------------------------------------
+void vtkITKArchetypeImageSeriesReader::ClearDICOMHeaderCache()
+{
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+  std::lock_guard<std::mutex> lock(DICOMHeaderCacheMutex);
+  DICOMHeaderCache.clear();
+#endif
+}
+
+//----------------------------------------------------------------------------
+int vtkITKArchetypeImageSeriesReader::GetNumberOfCachedDICOMHeaders()
+{
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+  std::lock_guard<std::mutex> lock(DICOMHeaderCacheMutex);
+  return static_cast<int>(DICOMHeaderCache.size());
+#else
+  return 0;
+#endif
+}
+
 //----------------------------------------------------------------------------
 void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
 {
@@ -1315,72 +1397,145 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
     }
 
   // if Archetype is a Dicom File
-  gdcmIO->SetFileName( this->Archetype );
+  // Read the headers of all files in parallel. Headers that were parsed before are
+  // taken from the cache if the file has not changed since.
+  std::vector<DICOMHeaderTags> headers(nFiles);
+  std::vector<int> filesToParse;
+  std::vector<long> modifiedTimes(nFiles);
+  std::vector<unsigned long> fileLengths(nFiles);
   for (int f = 0; f < nFiles; f++)
     {
-    gdcmIO->SetFileName( this->AllFileNames[f] );
-    gdcmIO->ReadImageInformation();
-    itk::MetaDataDictionary &dict = gdcmIO->GetMetaDataDictionary();
-    std::string tagValue;
-
-    // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
-    // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
-    // multi-value separator backslashes.
-
-    // series instance UID
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|000e");
-    if (!tagValue.empty())
-      {
-      int idx = InsertSeriesInstanceUIDs( tagValue.c_str() );
-      this->IndexSeriesInstanceUIDs[f] = idx;
-      }
-    else
+    modifiedTimes[f] = itksys::SystemTools::ModifiedTime(this->AllFileNames[f]);
+    fileLengths[f] = itksys::SystemTools::FileLength(this->AllFileNames[f]);
+    }
+    {
+    std::lock_guard<std::mutex> lock(DICOMHeaderCacheMutex);
+    for (int f = 0; f < nFiles; f++)
       {
-      this->IndexSeriesInstanceUIDs[f] = -1;
+      const std::string& fileName = this->AllFileNames[f];
+      std::map<std::string, CachedDICOMHeader>::iterator cachedHeaderIt = DICOMHeaderCache.find(fileName);
+      if (cachedHeaderIt != DICOMHeaderCache.end()
+        && cachedHeaderIt->second.ModifiedTime == modifiedTimes[f]
+        && cachedHeaderIt->second.FileLength == fileLengths[f])
+        {
+        headers[f] = cachedHeaderIt->second.Tags;
+        }
+      else
+        {
+        filesToParse.push_back(f);
+        }
       }
+    }
 
-    // content time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0008|0033");
-    if (!tagValue.empty())
+  if (!filesToParse.empty())
+    {
+    // Worker threads take the next file until all files are parsed.
+    // Each thread uses its own image IO, as it stores the dictionary of the last read file.
+    std::atomic<size_t> nextFileToParse(0);
+    std::mutex exceptionMutex;
+    std::exception_ptr parseException;
+    auto parseHeaders = [&]()
       {
-      int idx = InsertContentTime( tagValue.c_str() );
-      this->IndexContentTime[f] = idx;
-      }
-    else
+      itk::GDCMImageIO::Pointer threadGdcmIO = itk::GDCMImageIO::New();
+      for (size_t i = nextFileToParse++; i < filesToParse.size(); i = nextFileToParse++)
+        {
+        int f = filesToParse[i];
+        try
+          {
+          threadGdcmIO->SetFileName( this->AllFileNames[f] );
+          threadGdcmIO->ReadImageInformation();
+          }
+        catch (...)
+          {
+          // exception is thrown again in the calling thread, after all workers are finished
+          std::lock_guard<std::mutex> lock(exceptionMutex);
+          if (!parseException)
+            {
+            parseException = std::current_exception();
+            }
+          nextFileToParse = filesToParse.size();
+          break;
+          }
+        const itk::MetaDataDictionary &dict = threadGdcmIO->GetMetaDataDictionary();
+        // Use vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces to remove extra spaces
+        // from the DICOM tag, because extra spaces were found in some DICOM file before/after the
+        // multi-value separator backslashes.
+        DICOMHeaderTags& header = headers[f];
+        header.SeriesInstanceUID = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|000e");
+        header.ContentTime = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0008|0033");
+        header.TriggerTime = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|1060");
+        header.EchoNumbers = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|0086");
+        header.DiffusionGradientOrientation = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0010|9089");
+        header.SliceLocation = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|1041");
+        header.ImageOrientationPatient = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0037");
+        header.ImagePositionPatient = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0032");
+        }
+      };
+    size_t numberOfThreads = this->NumberOfThreads > 0 ?
+      static_cast<size_t>(this->NumberOfThreads) : std::max(1u, std::thread::hardware_concurrency());
+    numberOfThreads = std::min(numberOfThreads, filesToParse.size());
+    std::vector<std::thread> workerThreads;
+    for (size_t threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
       {
-      this->IndexContentTime[f] = -1;
+      workerThreads.emplace_back(parseHeaders);
       }
-
-    // trigger time
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|1060");
-    if (!tagValue.empty())
+    parseHeaders();
+    for (std::thread& workerThread : workerThreads)
       {
-      int idx = InsertTriggerTime( tagValue.c_str() );
-      this->IndexTriggerTime[f] = idx;
+      workerThread.join();
       }
-    else
+    if (parseException)
       {
-      this->IndexTriggerTime[f] = -1;
+      std::rethrow_exception(parseException);
       }
 
-    // echo numbers
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0018|0086");
-    if (!tagValue.empty())
+    std::lock_guard<std::mutex> lock(DICOMHeaderCacheMutex);
+    if (DICOMHeaderCache.size() + filesToParse.size() > MaximumNumberOfCachedDICOMHeaders)
       {
-      int idx = InsertEchoNumbers( tagValue.c_str() );
-      this->IndexEchoNumbers[f] = idx;
+      DICOMHeaderCache.clear();
       }
-    else
+    for (int f : filesToParse)
       {
-      this->IndexEchoNumbers[f] = -1;
+      CachedDICOMHeader& cachedHeader = DICOMHeaderCache[this->AllFileNames[f]];
+      cachedHeader.ModifiedTime = modifiedTimes[f];
+      cachedHeader.FileLength = fileLengths[f];
+      cachedHeader.Tags = headers[f];
       }
+    }
+
+  // Group the files in file order, so that the indices do not depend on the order
+  // the headers were parsed in. Identifiers and slice locations are matched exactly,
+  // therefore they are looked up in a map instead of searching all known values.
+  std::map<std::string, int> seriesInstanceUIDIndices;
+  std::map<std::string, int> contentTimeIndices;
+  std::map<std::string, int> triggerTimeIndices;
+  std::map<std::string, int> echoNumbersIndices;
+  std::map<float, int> sliceLocationIndices;
+  for (int f = 0; f < nFiles; f++)
+    {
+    const DICOMHeaderTags& header = headers[f];
+
+    // series instance UID
+    this->IndexSeriesInstanceUIDs[f] = InsertUniqueValue(
+      header.SeriesInstanceUID, this->SeriesInstanceUIDs, seriesInstanceUIDIndices);
+
+    // content time
+    this->IndexContentTime[f] = InsertUniqueValue(
+      header.ContentTime, this->ContentTime, contentTimeIndices);
+
+    // trigger time
+    this->IndexTriggerTime[f] = InsertUniqueValue(
+      header.TriggerTime, this->TriggerTime, triggerTimeIndices);
+
+    // echo numbers
+    this->IndexEchoNumbers[f] = InsertUniqueValue(
+      header.EchoNumbers, this->EchoNumbers, echoNumbersIndices);
 
     // diffision gradient orientation
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0010|9089");
-    if (!tagValue.empty())
+    if (!header.DiffusionGradientOrientation.empty())
       {
       float a[3] = { -1 };
-      sscanf( tagValue.c_str(), "%f\\%f\\%f", a, a+1, a+2 );
+      sscanf( header.DiffusionGradientOrientation.c_str(), "%f\\%f\\%f", a, a+1, a+2 );
       int idx = InsertDiffusionGradientOrientation( a );
       this->IndexDiffusionGradientOrientation[f] = idx;
       }
@@ -1390,13 +1545,18 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // slice location
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|1041");
-    if (!tagValue.empty())
+    if (!header.SliceLocation.empty())
       {
       float a = -1;
-      sscanf( tagValue.c_str(), "%f", &a );
-      int idx = InsertSliceLocation( a );
-      this->IndexSliceLocation[f] = idx;
+      sscanf( header.SliceLocation.c_str(), "%f", &a );
+      std::map<float, int>::iterator sliceLocationIt = sliceLocationIndices.find(a);
+      if (sliceLocationIt == sliceLocationIndices.end())
+        {
+        sliceLocationIt = sliceLocationIndices.insert(
+          std::make_pair(a, static_cast<int>(this->SliceLocation.size()))).first;
+        this->SliceLocation.push_back(a);
+        }
+      this->IndexSliceLocation[f] = sliceLocationIt->second;
       }
     else
       {
@@ -1404,11 +1564,10 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       }
 
     // image orientation patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0037");
-    if (!tagValue.empty())
+    if (!header.ImageOrientationPatient.empty())
       {
       float a[6] = { -1 };
-      sscanf( tagValue.c_str(), "%f\\%f\\%f\\%f\\%f\\%f", a, a+1, a+2, a+3, a+4, a+5 );
+      sscanf( header.ImageOrientationPatient.c_str(), "%f\\%f\\%f\\%f\\%f\\%f", a, a+1, a+2, a+3, a+4, a+5 );
       int idx = InsertImageOrientationPatient( a );
       this->IndexImageOrientationPatient[f] = idx;
       }
@@ -1417,11 +1576,10 @@ void vtkITKArchetypeImageSeriesReader::AnalyzeDicomHeaders()
       this->IndexImageOrientationPatient[f] = -1;
       }
     // image position patient
-    tagValue = vtkITKArchetypeImageSeriesReader::GetMetaDataWithoutSpaces(dict, "0020|0032");
-    if (!tagValue.empty())
+    if (!header.ImagePositionPatient.empty())
       {
       float a[3] = { -1 };
-      sscanf( tagValue.c_str(), "%f\\%f\\%f", a, a+1, a+2 );
+      sscanf( header.ImagePositionPatient.c_str(), "%f\\%f\\%f", a, a+1, a+2 );
       int idx = InsertImagePositionPatient( a );
       this->IndexImagePositionPatient[f] = idx;
       }
@@ -246,6 +246,20 @@ public:
   vtkSetMacro(AnalyzeHeader, bool);
   vtkGetMacro(AnalyzeHeader, bool);
 
+  ///
+  /// Maximum number of threads that read the DICOM headers and the slices of a series.
+  /// 0 (default) means the number of hardware threads.
+  vtkSetMacro(NumberOfThreads, int);
+  vtkGetMacro(NumberOfThreads, int);
+
+  ///
+  /// Remove all headers from the DICOM header cache that all readers share
+  static void ClearDICOMHeaderCache();
+
+  ///
+  /// Number of headers in the DICOM header cache that all readers share
+  static int GetNumberOfCachedDICOMHeaders();
+
   ///
   /// Whether to use orientation from file
   vtkSetMacro(UseOrientationFromFile, int);
@@ -776,6 +790,9 @@ public:
       return (this->ImagePositionPatient.size()-1);
     }
 
+  /// Read the headers of all files and group the files by their DICOM tags.
+  /// DICOM headers are read in parallel. Headers of files that have not changed
+  /// since they were last read are taken from a cache that all readers share.
   void AnalyzeDicomHeaders( );
 
   void AssembleNthVolume( int n );
@@ -875,6 +892,7 @@ protected:
 
   std::vector<std::string> AllFileNames;
   bool AnalyzeHeader;
+  int NumberOfThreads;
   bool IsOnlyFile;
   bool ArchetypeIsDICOM;
 
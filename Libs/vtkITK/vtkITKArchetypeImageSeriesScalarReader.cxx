@@ -35,6 +35,14 @@
 #include <itkGDCMImageIO.h>
 #endif
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 vtkStandardNewMacro(vtkITKArchetypeImageSeriesScalarReader);
 
 namespace {
@@ -45,6 +53,151 @@ vtkAOSDataArrayTemplate<T>* DownCast(vtkAbstractArray* a)
   return vtkAOSDataArrayTemplate<T>::FastDownCast(a);
 }
 
+//----------------------------------------------------------------------------
+/// Create an image IO of the same type and with the same reading options as prototypeImageIO.
+/// CreateAnother() alone would create an image IO with default options.
+itk::ImageIOBase::Pointer CloneImageIO(itk::ImageIOBase* prototypeImageIO)
+{
+  itk::LightObject::Pointer anotherObject = prototypeImageIO->CreateAnother();
+  itk::ImageIOBase::Pointer imageIO = dynamic_cast<itk::ImageIOBase*>(anotherObject.GetPointer());
+  if (imageIO.IsNull())
+    {
+    return nullptr;
+    }
+  imageIO->SetUseStreamedReading(prototypeImageIO->GetUseStreamedReading());
+#ifdef VTKITK_BUILD_DICOM_SUPPORT
+  itk::GDCMImageIO* prototypeGDCMImageIO = dynamic_cast<itk::GDCMImageIO*>(prototypeImageIO);
+  itk::GDCMImageIO* gdcmImageIO = dynamic_cast<itk::GDCMImageIO*>(imageIO.GetPointer());
+  if (prototypeGDCMImageIO && gdcmImageIO)
+    {
+    gdcmImageIO->SetLoadPrivateTags(prototypeGDCMImageIO->GetLoadPrivateTags());
+    gdcmImageIO->SetKeepOriginalUID(prototypeGDCMImageIO->GetKeepOriginalUID());
+    }
+#endif
+  return imageIO;
+}
+
+//----------------------------------------------------------------------------
+/// Read the slices of the series reader's files concurrently into a single volume.
+/// Each worker thread decodes complete files with its own image IO and copies the
+/// pixels to the slice position of the file in the volume.
+/// Progress is reported from the calling thread to progressAlgorithm.
+/// At most maximumNumberOfThreads threads are used (number of hardware threads if 0).
+/// Returns nullptr if the files are not single slices of the same size (e.g., multi-frame
+/// files) or only one thread can be used, in which case the series must be read by the series reader.
+template <class TImage>
+typename TImage::Pointer ReadSeriesSlicesInParallel(itk::ImageSeriesReader<TImage>* seriesReader,
+  itk::ImageIOBase* prototypeImageIO, vtkAlgorithm* progressAlgorithm, int maximumNumberOfThreads)
+{
+  const std::vector<std::string>& fileNames = seriesReader->GetFileNames();
+  size_t numberOfThreads = maximumNumberOfThreads > 0 ?
+    static_cast<size_t>(maximumNumberOfThreads) : static_cast<size_t>(std::thread::hardware_concurrency());
+  numberOfThreads = std::min(numberOfThreads, fileNames.size());
+  if (numberOfThreads < 2)
+    {
+    return nullptr;
+    }
+
+  seriesReader->UpdateOutputInformation();
+  typename TImage::RegionType region = seriesReader->GetOutput()->GetLargestPossibleRegion();
+  typename TImage::SizeType size = region.GetSize();
+  if (size[2] != fileNames.size())
+    {
+    return nullptr;
+    }
+  typename TImage::Pointer volume = TImage::New();
+  volume->CopyInformation(seriesReader->GetOutput());
+  volume->SetRegions(region);
+  volume->Allocate();
+  typename TImage::PixelType* volumeBuffer = volume->GetBufferPointer();
+  const size_t numberOfSlicePixels = size[0] * size[1];
+
+  // Image IO objects are created in the calling thread, as the object factory is not thread-safe
+  itk::ImageIOBase::Pointer prototype = prototypeImageIO;
+  if (prototype.IsNull())
+    {
+    typename itk::ImageFileReader<TImage>::Pointer firstSliceReader = itk::ImageFileReader<TImage>::New();
+    firstSliceReader->SetFileName(fileNames[0]);
+    firstSliceReader->UpdateOutputInformation();
+    prototype = firstSliceReader->GetImageIO();
+    }
+  std::vector<itk::ImageIOBase::Pointer> imageIOs;
+  for (size_t threadIndex = 0; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    imageIOs.push_back(CloneImageIO(prototype));
+    if (imageIOs.back().IsNull())
+      {
+      return nullptr;
+      }
+    }
+
+  std::atomic<size_t> nextSliceIndex(0);
+  std::atomic<size_t> numberOfReadSlices(0);
+  std::atomic<bool> sliceSizeMismatch(false);
+  std::mutex exceptionMutex;
+  std::exception_ptr readException;
+  auto readSlices = [&](size_t threadIndex)
+    {
+    typename itk::ImageFileReader<TImage>::Pointer sliceReader = itk::ImageFileReader<TImage>::New();
+    sliceReader->SetImageIO(imageIOs[threadIndex]);
+    for (size_t sliceIndex = nextSliceIndex++; sliceIndex < fileNames.size(); sliceIndex = nextSliceIndex++)
+      {
+      try
+        {
+        sliceReader->SetFileName(fileNames[sliceIndex]);
+        sliceReader->UpdateLargestPossibleRegion();
+        }
+      catch (...)
+        {
+        // exception is thrown again in the calling thread, after all workers are finished
+        std::lock_guard<std::mutex> lock(exceptionMutex);
+        if (!readException)
+          {
+          readException = std::current_exception();
+          }
+        nextSliceIndex = fileNames.size();
+        break;
+        }
+      TImage* slice = sliceReader->GetOutput();
+      typename TImage::SizeType sliceSize = slice->GetLargestPossibleRegion().GetSize();
+      if (sliceSize[0] != size[0] || sliceSize[1] != size[1] || sliceSize[2] != 1)
+        {
+        sliceSizeMismatch = true;
+        nextSliceIndex = fileNames.size();
+        break;
+        }
+      std::copy(slice->GetBufferPointer(), slice->GetBufferPointer() + numberOfSlicePixels,
+        volumeBuffer + sliceIndex * numberOfSlicePixels);
+      size_t readSliceCount = ++numberOfReadSlices;
+      if (threadIndex == 0)
+        {
+        // VTK events must be invoked from the calling thread
+        progressAlgorithm->UpdateProgress(static_cast<double>(readSliceCount) / fileNames.size());
+        }
+      }
+    };
+  std::vector<std::thread> workerThreads;
+  for (size_t threadIndex = 1; threadIndex < numberOfThreads; ++threadIndex)
+    {
+    workerThreads.emplace_back(readSlices, threadIndex);
+    }
+  readSlices(0);
+  for (std::thread& workerThread : workerThreads)
+    {
+    workerThread.join();
+    }
+  if (readException)
+    {
+    std::rethrow_exception(readException);
+    }
+  if (sliceSizeMismatch)
+    {
+    return nullptr;
+    }
+  progressAlgorithm->UpdateProgress(1.0);
+  return volume;
+}
+
 };
 
 //----------------------------------------------------------------------------
@@ -132,23 +285,39 @@ int vtkITKArchetypeImageSeriesScalarReader::RequestData(
       reader##typeN->AddObserver(itk::ProgressEvent(),pcl); \
       reader##typeN->SetFileNames(this->FileNames); \
       reader##typeN->ReleaseDataFlagOn(); \
+      image##typeN::Pointer volume##typeN = ReadSeriesSlicesInParallel<image##typeN>( \
+        reader##typeN, this->ArchetypeIsDICOM ? imageIO.GetPointer() : nullptr, this, this->NumberOfThreads); \
       if (this->UseNativeCoordinateOrientation) \
         { \
-        filter = reader##typeN; \
+        if (volume##typeN.IsNull()) \
+          { \
+          filter = reader##typeN; \
+          } \
         } \
       else \
         { \
         itk::OrientImageFilter<image##typeN,image##typeN>::Pointer orient##typeN = \
             itk::OrientImageFilter<image##typeN,image##typeN>::New(); \
         if (this->Debug) {orient##typeN->DebugOn();} \
-        orient##typeN->SetInput(reader##typeN->GetOutput()); \
+        if (volume##typeN.IsNotNull()) \
+          { \
+          orient##typeN->SetInput(volume##typeN); \
+          } \
+        else \
+          { \
+          orient##typeN->SetInput(reader##typeN->GetOutput()); \
+          } \
         orient##typeN->UseImageDirectionOn(); \
         orient##typeN->SetDesiredCoordinateOrientation(this->DesiredCoordinateOrientation); \
         filter = orient##typeN; \
         }\
-      filter->UpdateLargestPossibleRegion(); \
+      if (filter) \
+        { \
+        filter->UpdateLargestPossibleRegion(); \
+        volume##typeN = filter->GetOutput(); \
+        } \
       itk::ImportImageContainer<itk::SizeValueType, type>::Pointer PixelContainer##typeN;\
-      PixelContainer##typeN = filter->GetOutput()->GetPixelContainer();\
+      PixelContainer##typeN = volume##typeN->GetPixelContainer();\
       void *ptr = static_cast<void *> (PixelContainer##typeN->GetBufferPointer());\
       DownCast<type>(data->GetPointData()->GetScalars())                \
         ->SetVoidArray(ptr, PixelContainer##typeN->Size(), 0,\
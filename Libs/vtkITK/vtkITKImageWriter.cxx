@@ -211,6 +211,13 @@ void ITKWriteVTKImage(vtkITKImageWriter *self, vtkImageData *inputImage, char *f
     itkImporter->GetOutput()->Update();
     itkImporter->GetOutput()->SetOrigin(origin);
     itkImporter->GetOutput()->SetSpacing(mag);
+    // Custom header fields are written from the metadata dictionary of the image
+    itk::MetaDataDictionary& dictionary = itkImporter->GetOutput()->GetMetaDataDictionary();
+    for (std::map<std::string, std::string>::const_iterator attributeIt = self->GetAttributes().begin();
+      attributeIt != self->GetAttributes().end(); ++attributeIt)
+      {
+      itk::EncapsulateMetaData<std::string>(dictionary, attributeIt->first, attributeIt->second);
+      }
     itkImageWriter->SetFileName( fileName );
     itkImageWriter->Update();
     }
@@ -301,6 +308,12 @@ void vtkITKImageWriter::SetFileName(const char *name)
   this->Modified();
 }
 
+//----------------------------------------------------------------------------
+void vtkITKImageWriter::SetAttribute(const std::string& name, const std::string& value)
+{
+  this->Attributes[name] = value;
+}
+
 //----------------------------------------------------------------------------
 // Writes all the data from the input.
 void vtkITKImageWriter::Write()
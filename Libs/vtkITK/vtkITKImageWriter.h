@@ -23,6 +23,10 @@
 #include "vtkITK.h"
 #include "itkImageIOBase.h"
 
+// STD includes
+#include <map>
+#include <string>
+
 class vtkStringArray;
 
 class VTK_ITK_EXPORT vtkITKImageWriter : public vtkImageAlgorithm
@@ -67,6 +71,13 @@ public:
     MeasurementFrameMatrix = mat;
   }
 
+  /// Set a custom key/value field that is stored in the file header on write.
+  /// It is only stored in file formats that support custom fields (such as NRRD).
+  void SetAttribute(const std::string& name, const std::string& value);
+
+  /// Get the custom header fields
+  const std::map<std::string, std::string>& GetAttributes() { return this->Attributes; }
+
 protected:
   vtkITKImageWriter();
   ~vtkITKImageWriter() override;
@@ -76,6 +87,7 @@ protected:
   vtkMatrix4x4* MeasurementFrameMatrix;
   int UseCompression;
   char* ImageIOClassName;
+  std::map<std::string, std::string> Attributes;
 
 private:
   vtkITKImageWriter(const vtkITKImageWriter&) = delete;
@@ -0,0 +1,222 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+==========================================================================*/
+
+// vtkITK includes
+#include "vtkITKSharedMemoryImage.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkMatrix4x4.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// ITK includes
+#include <itkSharedMemoryImageIO.h>
+
+// STD includes
+#include <cmath>
+
+vtkStandardNewMacro(vtkITKSharedMemoryImage);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+itk::ImageIOBase::IOComponentType GetITKComponentType(int vtkScalarType)
+{
+  switch (vtkScalarType)
+    {
+    case VTK_FLOAT: return itk::ImageIOBase::FLOAT;
+    case VTK_DOUBLE: return itk::ImageIOBase::DOUBLE;
+    case VTK_INT: return itk::ImageIOBase::INT;
+    case VTK_UNSIGNED_INT: return itk::ImageIOBase::UINT;
+    case VTK_SHORT: return itk::ImageIOBase::SHORT;
+    case VTK_UNSIGNED_SHORT: return itk::ImageIOBase::USHORT;
+    case VTK_LONG: return itk::ImageIOBase::LONG;
+    case VTK_UNSIGNED_LONG: return itk::ImageIOBase::ULONG;
+    case VTK_CHAR: return itk::ImageIOBase::CHAR;
+    case VTK_SIGNED_CHAR: return itk::ImageIOBase::CHAR;
+    case VTK_UNSIGNED_CHAR: return itk::ImageIOBase::UCHAR;
+    default: return itk::ImageIOBase::UNKNOWNCOMPONENTTYPE;
+    }
+}
+
+//----------------------------------------------------------------------------
+int GetVTKScalarType(itk::ImageIOBase::IOComponentType componentType)
+{
+  switch (componentType)
+    {
+    case itk::ImageIOBase::FLOAT: return VTK_FLOAT;
+    case itk::ImageIOBase::DOUBLE: return VTK_DOUBLE;
+    case itk::ImageIOBase::INT: return VTK_INT;
+    case itk::ImageIOBase::UINT: return VTK_UNSIGNED_INT;
+    case itk::ImageIOBase::SHORT: return VTK_SHORT;
+    case itk::ImageIOBase::USHORT: return VTK_UNSIGNED_SHORT;
+    case itk::ImageIOBase::LONG: return VTK_LONG;
+    case itk::ImageIOBase::ULONG: return VTK_UNSIGNED_LONG;
+    case itk::ImageIOBase::CHAR: return VTK_CHAR;
+    case itk::ImageIOBase::UCHAR: return VTK_UNSIGNED_CHAR;
+    default: return VTK_VOID;
+    }
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+vtkITKSharedMemoryImage::vtkITKSharedMemoryImage() = default;
+
+//----------------------------------------------------------------------------
+vtkITKSharedMemoryImage::~vtkITKSharedMemoryImage() = default;
+
+//----------------------------------------------------------------------------
+void vtkITKSharedMemoryImage::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os, indent);
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKSharedMemoryImage::IsSupported()
+{
+  return itk::SharedMemoryImageIO::IsSupported();
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKSharedMemoryImage::IsSharedMemoryFileName(const char* fileName)
+{
+  return fileName && itk::SharedMemoryImageIO::IsSharedMemoryFileName(fileName);
+}
+
+//----------------------------------------------------------------------------
+std::string vtkITKSharedMemoryImage::CreateUniqueFileName()
+{
+  return itk::SharedMemoryImageIO::CreateUniqueFileName();
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKSharedMemoryImage::WriteImage(vtkImageData* image, vtkMatrix4x4* ijkToRAS, const char* fileName)
+{
+  if (!image || !image->GetPointData()->GetScalars() || !ijkToRAS || !fileName)
+    {
+    vtkGenericWarningMacro("vtkITKSharedMemoryImage::WriteImage failed: invalid input");
+    return false;
+    }
+  itk::ImageIOBase::IOComponentType componentType = GetITKComponentType(image->GetScalarType());
+  if (componentType == itk::ImageIOBase::UNKNOWNCOMPONENTTYPE)
+    {
+    vtkGenericWarningMacro("vtkITKSharedMemoryImage::WriteImage failed: unsupported scalar type "
+      << image->GetScalarTypeAsString());
+    return false;
+    }
+
+  itk::SharedMemoryImageIO::Pointer imageIO = itk::SharedMemoryImageIO::New();
+  imageIO->SetFileName(fileName);
+  imageIO->SetNumberOfDimensions(3);
+  imageIO->SetComponentType(componentType);
+  imageIO->SetNumberOfComponents(image->GetNumberOfScalarComponents());
+  imageIO->SetPixelType(image->GetNumberOfScalarComponents() == 1 ?
+    itk::ImageIOBase::SCALAR : itk::ImageIOBase::VECTOR);
+
+  // RAS to LPS: flip the first two axes
+  const double rasToLPS[3] = { -1.0, -1.0, 1.0 };
+  int* dimensions = image->GetDimensions();
+  for (int i = 0; i < 3; ++i)
+    {
+    imageIO->SetDimensions(i, dimensions[i]);
+    double spacing = 0.0;
+    for (int j = 0; j < 3; ++j)
+      {
+      spacing += ijkToRAS->GetElement(j, i) * ijkToRAS->GetElement(j, i);
+      }
+    spacing = sqrt(spacing);
+    if (spacing == 0.0)
+      {
+      spacing = 1.0;
+      }
+    std::vector<double> direction(3);
+    for (int j = 0; j < 3; ++j)
+      {
+      direction[j] = rasToLPS[j] * ijkToRAS->GetElement(j, i) / spacing;
+      }
+    imageIO->SetSpacing(i, spacing);
+    imageIO->SetDirection(i, direction);
+    imageIO->SetOrigin(i, rasToLPS[i] * ijkToRAS->GetElement(i, 3));
+    }
+
+  try
+    {
+    imageIO->Write(image->GetScalarPointer());
+    }
+  catch (itk::ExceptionObject& exception)
+    {
+    vtkGenericWarningMacro("vtkITKSharedMemoryImage::WriteImage failed: " << exception.GetDescription());
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKSharedMemoryImage::ReadImage(const char* fileName, vtkImageData* image, vtkMatrix4x4* ijkToRAS)
+{
+  if (!fileName || !image || !ijkToRAS)
+    {
+    vtkGenericWarningMacro("vtkITKSharedMemoryImage::ReadImage failed: invalid input");
+    return false;
+    }
+  itk::SharedMemoryImageIO::Pointer imageIO = itk::SharedMemoryImageIO::New();
+  if (!imageIO->CanReadFile(fileName))
+    {
+    vtkGenericWarningMacro("vtkITKSharedMemoryImage::ReadImage failed: cannot read " << fileName);
+    return false;
+    }
+  imageIO->SetFileName(fileName);
+  try
+    {
+    imageIO->ReadImageInformation();
+    int scalarType = GetVTKScalarType(imageIO->GetComponentType());
+    if (scalarType == VTK_VOID)
+      {
+      vtkGenericWarningMacro("vtkITKSharedMemoryImage::ReadImage failed: unsupported component type in " << fileName);
+      return false;
+      }
+
+    const double lpsToRAS[3] = { -1.0, -1.0, 1.0 };
+    int dimensions[3] = { 1, 1, 1 };
+    ijkToRAS->Identity();
+    for (unsigned int i = 0; i < imageIO->GetNumberOfDimensions() && i < 3; ++i)
+      {
+      dimensions[i] = static_cast<int>(imageIO->GetDimensions(i));
+      std::vector<double> direction = imageIO->GetDirection(i);
+      for (unsigned int j = 0; j < direction.size() && j < 3; ++j)
+        {
+        ijkToRAS->SetElement(j, i, lpsToRAS[j] * direction[j] * imageIO->GetSpacing(i));
+        }
+      ijkToRAS->SetElement(i, 3, lpsToRAS[i] * imageIO->GetOrigin(i));
+      }
+
+    image->SetDimensions(dimensions);
+    image->SetOrigin(0.0, 0.0, 0.0);
+    image->SetSpacing(1.0, 1.0, 1.0);
+    image->AllocateScalars(scalarType, imageIO->GetNumberOfComponents());
+    imageIO->Read(image->GetScalarPointer());
+    }
+  catch (itk::ExceptionObject& exception)
+    {
+    vtkGenericWarningMacro("vtkITKSharedMemoryImage::ReadImage failed: " << exception.GetDescription());
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkITKSharedMemoryImage::RemoveImage(const char* fileName)
+{
+  return fileName && itk::SharedMemoryImageIO::RemoveSharedMemory(fileName);
+}
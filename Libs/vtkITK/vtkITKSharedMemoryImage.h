@@ -0,0 +1,69 @@
+/*=========================================================================
+
+  Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Program:   vtkITK
+
+==========================================================================*/
+
+#ifndef __vtkITKSharedMemoryImage_h
+#define __vtkITKSharedMemoryImage_h
+
+#include "vtkITK.h"
+
+// VTK includes
+#include <vtkObject.h>
+
+// STD includes
+#include <string>
+
+class vtkImageData;
+class vtkMatrix4x4;
+
+/// \brief Exchange images with executable command line modules through shared memory.
+///
+/// The images are accessed by the command line module using
+/// itk::SharedMemoryImageIO (registered by itk::itkFactoryRegistration()),
+/// with a "shm:/<name>" filename.
+/// Geometry is stored in LPS in the shared memory, the methods of this class
+/// convert from/to the RAS IJKToRAS matrix of volume nodes.
+class VTK_ITK_EXPORT vtkITKSharedMemoryImage : public vtkObject
+{
+public:
+  static vtkITKSharedMemoryImage *New();
+  vtkTypeMacro(vtkITKSharedMemoryImage, vtkObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  /// Return true if images can be exchanged through shared memory on this platform.
+  static bool IsSupported();
+
+  /// Return true if the fileName refers to a shared memory image.
+  static bool IsSharedMemoryFileName(const char* fileName);
+
+  /// Return a new shared memory image filename, unique in the process.
+  static std::string CreateUniqueFileName();
+
+  /// Copy the image and its geometry into a new shared memory image.
+  /// Origin and spacing of the image are ignored, \a ijkToRAS defines the geometry.
+  static bool WriteImage(vtkImageData* image, vtkMatrix4x4* ijkToRAS, const char* fileName);
+
+  /// Copy the shared memory image into \a image (origin is set to 0, spacing to 1)
+  /// and its geometry into \a ijkToRAS.
+  static bool ReadImage(const char* fileName, vtkImageData* image, vtkMatrix4x4* ijkToRAS);
+
+  /// Release the shared memory image.
+  static bool RemoveImage(const char* fileName);
+
+protected:
+  vtkITKSharedMemoryImage();
+  ~vtkITKSharedMemoryImage() override;
+
+private:
+  vtkITKSharedMemoryImage(const vtkITKSharedMemoryImage&) = delete;
+  void operator=(const vtkITKSharedMemoryImage&) = delete;
+};
+
+#endif
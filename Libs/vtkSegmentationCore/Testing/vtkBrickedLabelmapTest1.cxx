@@ -0,0 +1,372 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToBrickedLabelmapConversionRule.h"
+#include "vtkBrickedLabelmap.h"
+#include "vtkBrickedLabelmapToBinaryLabelmapConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+#include "vtkSegment.h"
+#include "vtkSegmentation.h"
+#include "vtkSegmentationConverterFactory.h"
+#include "vtkSegmentationModifier.h"
+
+// STD includes
+#include <cstring>
+
+//----------------------------------------------------------------------------
+void CreateLabelmap(vtkOrientedImageData* imageData, const int extent[6], const int filledExtent[6], double fillValue)
+{
+  imageData->SetExtent(const_cast<int*>(extent));
+  imageData->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  vtkOrientedImageDataResample::FillImage(imageData, 0.0);
+  vtkOrientedImageDataResample::FillImage(imageData, fillValue, filledExtent);
+}
+
+//----------------------------------------------------------------------------
+bool CompareLabelmaps(vtkBrickedLabelmap* brickedLabelmap, vtkOrientedImageData* expectedImage)
+{
+  vtkNew<vtkOrientedImageData> image;
+  brickedLabelmap->GetImage(image.GetPointer(), expectedImage->GetExtent());
+  if (image->GetScalarType() != expectedImage->GetScalarType()
+    || image->GetNumberOfPoints() != expectedImage->GetNumberOfPoints())
+    {
+    std::cerr << "Bricked labelmap scalar type or size does not match the expected image" << std::endl;
+    return false;
+    }
+  if (memcmp(image->GetScalarPointer(), expectedImage->GetScalarPointer(),
+    image->GetNumberOfPoints() * image->GetScalarSize()) != 0)
+    {
+    std::cerr << "Bricked labelmap voxels do not match the expected image" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedLabelmapTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  int extent[6] = { 0, 63, 0, 63, 0, 63 };
+  int cubeExtent[6] = { 10, 40, 10, 40, 10, 40 };
+  vtkNew<vtkOrientedImageData> denseLabelmap;
+  CreateLabelmap(denseLabelmap.GetPointer(), extent, cubeExtent, 1.0);
+
+  /////////////////////////////////////////////////
+  // Test storage
+  // Only bricks on the boundary of the cube store voxels
+  /////////////////////////////////////////////////
+  vtkNew<vtkBrickedLabelmap> brickedLabelmap;
+  brickedLabelmap->SetImage(denseLabelmap.GetPointer());
+  if (!CompareLabelmaps(brickedLabelmap.GetPointer(), denseLabelmap.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+  int numberOfUniformBricks = brickedLabelmap->GetNumberOfBricks(vtkBrickedLabelmap::BRICK_UNIFORM);
+  int numberOfDenseBricks = brickedLabelmap->GetNumberOfBricks(vtkBrickedLabelmap::BRICK_DENSE);
+  if (numberOfUniformBricks != 1 || numberOfDenseBricks != 26)
+    {
+    std::cerr << "Expected 1 uniform and 26 dense bricks, found " << numberOfUniformBricks << " uniform and "
+      << numberOfDenseBricks << " dense bricks" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int brickIndex[3] = { 3, 3, 3 };
+  if (brickedLabelmap->GetBrickState(brickIndex) != vtkBrickedLabelmap::BRICK_EMPTY)
+    {
+    std::cerr << "Brick outside of the cube should be empty" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (brickedLabelmap->GetActualMemorySize() >= denseLabelmap->GetActualMemorySize())
+    {
+    std::cerr << "Bricked labelmap memory size (" << brickedLabelmap->GetActualMemorySize()
+      << " kB) should be smaller than the dense labelmap memory size (" << denseLabelmap->GetActualMemorySize() << " kB)" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  /////////////////////////////////////////////////
+  // Test modification
+  // Result must be the same as modifying the dense labelmap
+  /////////////////////////////////////////////////
+  int paintExtent[6] = { 30, 50, 35, 45, 0, 20 };
+  vtkNew<vtkOrientedImageData> paintModifier;
+  CreateLabelmap(paintModifier.GetPointer(), paintExtent, paintExtent, 1.0);
+  vtkOrientedImageDataResample::ModifyImage(denseLabelmap.GetPointer(), paintModifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+  vtkOrientedImageDataResample::ModifyImage(brickedLabelmap.GetPointer(), paintModifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+  if (!CompareLabelmaps(brickedLabelmap.GetPointer(), denseLabelmap.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  int eraseExtent[6] = { 0, 63, 0, 63, 0, 31 };
+  vtkNew<vtkOrientedImageData> eraseModifier;
+  CreateLabelmap(eraseModifier.GetPointer(), eraseExtent, eraseExtent, 1.0);
+  vtkOrientedImageDataResample::ModifyImage(denseLabelmap.GetPointer(), eraseModifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 0.0);
+  vtkOrientedImageDataResample::ModifyImage(brickedLabelmap.GetPointer(), eraseModifier.GetPointer(), vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 0.0);
+  if (!CompareLabelmaps(brickedLabelmap.GetPointer(), denseLabelmap.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+  if (brickedLabelmap->GetNumberOfBricks(vtkBrickedLabelmap::BRICK_DENSE) != 9)
+    {
+    std::cerr << "Erased bricks should not be stored, found " << brickedLabelmap->GetNumberOfBricks(vtkBrickedLabelmap::BRICK_DENSE)
+      << " dense bricks instead of 9" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  /////////////////////////////////////////////////
+  // Test effective extent
+  /////////////////////////////////////////////////
+  int expectedEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkOrientedImageDataResample::CalculateEffectiveExtent(denseLabelmap.GetPointer(), expectedEffectiveExtent);
+  int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  vtkOrientedImageDataResample::CalculateEffectiveExtent(brickedLabelmap.GetPointer(), effectiveExtent);
+  for (int i = 0; i < 6; ++i)
+    {
+    if (effectiveExtent[i] != expectedEffectiveExtent[i])
+      {
+      std::cerr << "Effective extent mismatch at index " << i << ": " << effectiveExtent[i] << " != " << expectedEffectiveExtent[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  /////////////////////////////////////////////////
+  // Test extent change
+  // Voxels outside of the new extent are cleared
+  /////////////////////////////////////////////////
+  int croppedExtent[6] = { 0, 35, 0, 63, 0, 63 };
+  brickedLabelmap->SetExtent(croppedExtent);
+  brickedLabelmap->SetExtent(extent);
+  int removedExtent[6] = { 36, 63, 0, 63, 0, 63 };
+  vtkOrientedImageDataResample::FillImage(denseLabelmap.GetPointer(), 0.0, removedExtent);
+  if (!CompareLabelmaps(brickedLabelmap.GetPointer(), denseLabelmap.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  /////////////////////////////////////////////////
+  // Test conversion
+  // Only the voxels of the segment are kept from a shared binary labelmap
+  /////////////////////////////////////////////////
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToBrickedLabelmapConversionRule>::New());
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBrickedLabelmapToBinaryLabelmapConversionRule>::New());
+
+  vtkNew<vtkOrientedImageData> sharedLabelmap;
+  CreateLabelmap(sharedLabelmap.GetPointer(), extent, cubeExtent, 1.0);
+  int otherSegmentExtent[6] = { 50, 60, 50, 60, 50, 60 };
+  vtkOrientedImageDataResample::FillImage(sharedLabelmap.GetPointer(), 2.0, otherSegmentExtent);
+  vtkNew<vtkSegment> segment;
+  segment->SetLabelValue(1);
+  segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), sharedLabelmap.GetPointer());
+
+  vtkNew<vtkBinaryLabelmapToBrickedLabelmapConversionRule> binaryToBrickedRule;
+  if (!binaryToBrickedRule->Convert(segment.GetPointer()))
+    {
+    std::cerr << "Binary labelmap to bricked labelmap conversion failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkBrickedLabelmap* convertedLabelmap = vtkBrickedLabelmap::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetBrickedLabelmapRepresentationName()));
+  vtkNew<vtkOrientedImageData> segmentLabelmap;
+  CreateLabelmap(segmentLabelmap.GetPointer(), extent, cubeExtent, 1.0);
+  if (!convertedLabelmap || !CompareLabelmaps(convertedLabelmap, segmentLabelmap.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  segment->RemoveRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName());
+  vtkNew<vtkBrickedLabelmapToBinaryLabelmapConversionRule> brickedToBinaryRule;
+  if (!brickedToBinaryRule->Convert(segment.GetPointer()))
+    {
+    std::cerr << "Bricked labelmap to binary labelmap conversion failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(
+    segment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  if (!binaryLabelmap || !CompareLabelmaps(convertedLabelmap, binaryLabelmap))
+    {
+    return EXIT_FAILURE;
+    }
+
+  /////////////////////////////////////////////////
+  // Test shallow copy
+  // Modifying a shallow copy does not change the original labelmap
+  /////////////////////////////////////////////////
+  vtkNew<vtkBrickedLabelmap> shallowCopiedLabelmap;
+  shallowCopiedLabelmap->ShallowCopy(convertedLabelmap);
+  vtkOrientedImageDataResample::ModifyImage(shallowCopiedLabelmap.GetPointer(), eraseModifier.GetPointer(),
+    vtkOrientedImageDataResample::OPERATION_MASKING, nullptr, 0.0, 0.0);
+  if (!CompareLabelmaps(convertedLabelmap, segmentLabelmap.GetPointer()))
+    {
+    std::cerr << "Modification of a shallow copy changed the original bricked labelmap" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkOrientedImageData> erasedSegmentLabelmap;
+  CreateLabelmap(erasedSegmentLabelmap.GetPointer(), extent, cubeExtent, 1.0);
+  vtkOrientedImageDataResample::FillImage(erasedSegmentLabelmap.GetPointer(), 0.0, eraseExtent);
+  if (!CompareLabelmaps(shallowCopiedLabelmap.GetPointer(), erasedSegmentLabelmap.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  /////////////////////////////////////////////////
+  // Test merge
+  // Extent of the bricked labelmap grows to contain the merged image
+  /////////////////////////////////////////////////
+  vtkNew<vtkBrickedLabelmap> mergedLabelmap;
+  bool mergedLabelmapModified = false;
+  if (!vtkOrientedImageDataResample::MergeImage(mergedLabelmap.GetPointer(), paintModifier.GetPointer(),
+    vtkOrientedImageDataResample::OPERATION_MAXIMUM, nullptr, 0.0, 1.0, &mergedLabelmapModified) || !mergedLabelmapModified)
+    {
+    std::cerr << "Merging into an empty bricked labelmap failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int otherPaintExtent[6] = { 70, 75, 35, 45, 0, 20 };
+  vtkNew<vtkOrientedImageData> otherPaintModifier;
+  CreateLabelmap(otherPaintModifier.GetPointer(), otherPaintExtent, otherPaintExtent, 1.0);
+  if (!vtkOrientedImageDataResample::MergeImage(mergedLabelmap.GetPointer(), otherPaintModifier.GetPointer(),
+    vtkOrientedImageDataResample::OPERATION_MAXIMUM, nullptr, 0.0, 1.0, &mergedLabelmapModified) || !mergedLabelmapModified)
+    {
+    std::cerr << "Merging into a bricked labelmap failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int mergedExtent[6] = { 30, 75, 35, 45, 0, 20 };
+  vtkNew<vtkOrientedImageData> expectedMergedLabelmap;
+  CreateLabelmap(expectedMergedLabelmap.GetPointer(), mergedExtent, paintExtent, 1.0);
+  vtkOrientedImageDataResample::FillImage(expectedMergedLabelmap.GetPointer(), 1.0, otherPaintExtent);
+  const int* actualMergedExtent = mergedLabelmap->GetExtent();
+  for (int i = 0; i < 6; ++i)
+    {
+    if (actualMergedExtent[i] != mergedExtent[i])
+      {
+      std::cerr << "Merged extent mismatch at index " << i << ": " << actualMergedExtent[i] << " != " << mergedExtent[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  if (!CompareLabelmaps(mergedLabelmap.GetPointer(), expectedMergedLabelmap.GetPointer()))
+    {
+    return EXIT_FAILURE;
+    }
+
+  /////////////////////////////////////////////////
+  // Test segmentation modifier
+  // Edits are stored in the bricked labelmap master and the derived binary labelmap is updated
+  /////////////////////////////////////////////////
+  vtkNew<vtkSegmentation> segmentation;
+  segmentation->SetMasterRepresentationName(vtkSegmentationConverter::GetBrickedLabelmapRepresentationName());
+  vtkNew<vtkBrickedLabelmap> masterLabelmap;
+  masterLabelmap->SetImage(segmentLabelmap.GetPointer());
+  vtkNew<vtkSegment> brickedSegment;
+  brickedSegment->AddRepresentation(vtkSegmentationConverter::GetBrickedLabelmapRepresentationName(), masterLabelmap.GetPointer());
+  segmentation->AddSegment(brickedSegment.GetPointer(), "Segment_1");
+  if (!segmentation->CreateRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()))
+    {
+    std::cerr << "Failed to create binary labelmap from bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if (!vtkSegmentationModifier::ModifyBinaryLabelmap(paintModifier.GetPointer(), segmentation.GetPointer(), "Segment_1",
+    vtkSegmentationModifier::MODE_MERGE_MAX))
+    {
+    std::cerr << "Failed to paint into bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkNew<vtkOrientedImageData> expectedSegmentLabelmap;
+  CreateLabelmap(expectedSegmentLabelmap.GetPointer(), extent, cubeExtent, 1.0);
+  vtkOrientedImageDataResample::ModifyImage(expectedSegmentLabelmap.GetPointer(), paintModifier.GetPointer(),
+    vtkOrientedImageDataResample::OPERATION_MAXIMUM);
+  vtkBrickedLabelmap* segmentMasterLabelmap = vtkBrickedLabelmap::SafeDownCast(
+    brickedSegment->GetRepresentation(vtkSegmentationConverter::GetBrickedLabelmapRepresentationName()));
+  if (!segmentMasterLabelmap || !CompareLabelmaps(segmentMasterLabelmap, expectedSegmentLabelmap.GetPointer()))
+    {
+    std::cerr << "Painting did not modify the bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkOrientedImageData* derivedLabelmap = vtkOrientedImageData::SafeDownCast(
+    brickedSegment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  if (!derivedLabelmap || !CompareLabelmaps(segmentMasterLabelmap, derivedLabelmap))
+    {
+    std::cerr << "Binary labelmap was not updated from the bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  int keptExtent[6] = { 0, 63, 0, 63, 0, 31 };
+  vtkNew<vtkOrientedImageData> keepModifier;
+  CreateLabelmap(keepModifier.GetPointer(), extent, keptExtent, 1.0);
+  if (!vtkSegmentationModifier::ModifyBinaryLabelmap(keepModifier.GetPointer(), segmentation.GetPointer(), "Segment_1",
+    vtkSegmentationModifier::MODE_MERGE_MIN))
+    {
+    std::cerr << "Failed to erase from bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+  int erasedExtent[6] = { 0, 63, 0, 63, 32, 63 };
+  vtkOrientedImageDataResample::FillImage(expectedSegmentLabelmap.GetPointer(), 0.0, erasedExtent);
+  if (!CompareLabelmaps(segmentMasterLabelmap, expectedSegmentLabelmap.GetPointer()))
+    {
+    std::cerr << "Erasing did not modify the bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+  derivedLabelmap = vtkOrientedImageData::SafeDownCast(
+    brickedSegment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  if (!derivedLabelmap || !CompareLabelmaps(segmentMasterLabelmap, derivedLabelmap))
+    {
+    std::cerr << "Binary labelmap was not updated from the bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Painting inside the effective extent only updates the modified region of the binary labelmap
+  int derivedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  derivedLabelmap->GetExtent(derivedExtent);
+  int innerPaintExtent[6] = { 12, 20, 12, 20, 0, 5 };
+  vtkNew<vtkOrientedImageData> innerPaintModifier;
+  CreateLabelmap(innerPaintModifier.GetPointer(), innerPaintExtent, innerPaintExtent, 1.0);
+  if (!vtkSegmentationModifier::ModifyBinaryLabelmap(innerPaintModifier.GetPointer(), segmentation.GetPointer(), "Segment_1",
+    vtkSegmentationModifier::MODE_MERGE_MAX))
+    {
+    std::cerr << "Failed to paint into bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+  vtkOrientedImageDataResample::FillImage(expectedSegmentLabelmap.GetPointer(), 1.0, innerPaintExtent);
+  if (!CompareLabelmaps(segmentMasterLabelmap, expectedSegmentLabelmap.GetPointer()))
+    {
+    std::cerr << "Painting did not modify the bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+  derivedLabelmap = vtkOrientedImageData::SafeDownCast(
+    brickedSegment->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()));
+  if (!derivedLabelmap || !CompareLabelmaps(segmentMasterLabelmap, derivedLabelmap))
+    {
+    std::cerr << "Modified region of the binary labelmap was not updated from the bricked labelmap master" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (int i = 0; i < 6; ++i)
+    {
+    if (derivedLabelmap->GetExtent()[i] != derivedExtent[i])
+      {
+      std::cerr << "Binary labelmap extent changed at index " << i << ": " << derivedLabelmap->GetExtent()[i]
+        << " != " << derivedExtent[i] << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::cout << "Bricked labelmap test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
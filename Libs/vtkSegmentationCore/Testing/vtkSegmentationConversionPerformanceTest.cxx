@@ -0,0 +1,191 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// VTK includes
+#include <vtkDataArray.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+#include "vtkSegmentationConverter.h"
+
+// STD includes
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void PrintMeasurement(const std::string& name, int numberOfSegments, double value)
+{
+  std::cout << "<DartMeasurement name=\"" << name << "-" << numberOfSegments << "\" "
+            << "type=\"numeric/double\">"
+            << value << "</DartMeasurement>" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+// Fill a box of the labelmap with a label value, the box is different for each segment
+void FillBox(vtkOrientedImageData* labelmap, int segmentIndex, unsigned char labelValue)
+{
+  int* extent = labelmap->GetExtent();
+  int size = 8 + (segmentIndex % 5) * 2;
+  int offset[3] = { 2 + (segmentIndex * 7) % 30, 2 + (segmentIndex * 11) % 30, 2 + (segmentIndex * 13) % 30 };
+  for (int k = offset[2]; k < offset[2] + size && k <= extent[5]; ++k)
+    {
+    for (int j = offset[1]; j < offset[1] + size && j <= extent[3]; ++j)
+      {
+      for (int i = offset[0]; i < offset[0] + size && i <= extent[1]; ++i)
+        {
+        unsigned char* voxel = static_cast<unsigned char*>(labelmap->GetScalarPointer(i, j, k));
+        *voxel = labelValue;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkOrientedImageData> CreateLabelmap()
+{
+  vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+  labelmap->SetExtent(0, 49, 0, 49, 0, 49);
+  labelmap->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+  labelmap->GetPointData()->GetScalars()->Fill(0);
+  return labelmap;
+}
+
+//----------------------------------------------------------------------------
+// Create segments with separate labelmaps, or one labelmap shared by all segments
+void CreateSegments(int numberOfSegments, bool sharedLabelmap, std::vector<vtkSmartPointer<vtkSegment> >& segments)
+{
+  segments.clear();
+  vtkSmartPointer<vtkOrientedImageData> labelmap;
+  for (int segmentIndex = 0; segmentIndex < numberOfSegments; ++segmentIndex)
+    {
+    if (!sharedLabelmap || !labelmap)
+      {
+      labelmap = CreateLabelmap();
+      }
+    unsigned char labelValue = (sharedLabelmap ? segmentIndex + 1 : 1);
+    FillBox(labelmap, segmentIndex, labelValue);
+
+    vtkSmartPointer<vtkSegment> segment = vtkSmartPointer<vtkSegment>::New();
+    std::stringstream name;
+    name << "Segment_" << segmentIndex;
+    segment->SetName(name.str().c_str());
+    segment->SetLabelValue(labelValue);
+    segment->AddRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName(), labelmap);
+    segments.push_back(segment);
+    }
+}
+
+//----------------------------------------------------------------------------
+double ConvertSegments(std::vector<vtkSmartPointer<vtkSegment> >& segments, int numberOfThreads, bool jointSmoothing)
+{
+  vtkNew<vtkBinaryLabelmapToClosedSurfaceConversionRule> rule;
+  rule->SetNumberOfThreads(numberOfThreads);
+  rule->SetConversionParameter(vtkBinaryLabelmapToClosedSurfaceConversionRule::GetJointSmoothingParameterName(),
+    jointSmoothing ? "1" : "0");
+  std::vector<vtkSegment*> segmentsToConvert;
+  for (vtkSegment* segment : segments)
+    {
+    segment->RemoveRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName());
+    segmentsToConvert.push_back(segment);
+    }
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  bool success = rule->ConvertSegments(segmentsToConvert);
+  timer->StopTimer();
+  rule->PostConvert(nullptr);
+  return success ? timer->GetElapsedTime() : -1.0;
+}
+
+//----------------------------------------------------------------------------
+int TestConversionPerformance(int numberOfSegments, bool jointSmoothing)
+{
+  std::string mode = (jointSmoothing ? "JointSmoothing" : "SeparateLabelmaps");
+  std::vector<vtkSmartPointer<vtkSegment> > segments;
+  CreateSegments(numberOfSegments, jointSmoothing, segments);
+
+  double serialTime = ConvertSegments(segments, 1, jointSmoothing);
+  if (serialTime < 0)
+    {
+    std::cerr << __LINE__ << ": Serial conversion failed (" << mode << ")" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::vector<vtkIdType> serialNumberOfPoints;
+  std::vector<vtkIdType> serialNumberOfPolys;
+  for (vtkSegment* segment : segments)
+    {
+    vtkPolyData* surface = vtkPolyData::SafeDownCast(
+      segment->GetRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+    serialNumberOfPoints.push_back(surface ? surface->GetNumberOfPoints() : -1);
+    serialNumberOfPolys.push_back(surface ? surface->GetNumberOfPolys() : -1);
+    }
+
+  // Use all available cores
+  double parallelTime = ConvertSegments(segments, 0, jointSmoothing);
+  if (parallelTime < 0)
+    {
+    std::cerr << __LINE__ << ": Parallel conversion failed (" << mode << ")" << std::endl;
+    return EXIT_FAILURE;
+    }
+  for (size_t segmentIndex = 0; segmentIndex < segments.size(); ++segmentIndex)
+    {
+    vtkPolyData* surface = vtkPolyData::SafeDownCast(
+      segments[segmentIndex]->GetRepresentation(vtkSegmentationConverter::GetClosedSurfaceRepresentationName()));
+    if (!surface
+      || surface->GetNumberOfPoints() != serialNumberOfPoints[segmentIndex]
+      || surface->GetNumberOfPolys() != serialNumberOfPolys[segmentIndex])
+      {
+      std::cerr << __LINE__ << ": Parallel conversion result of segment " << segmentIndex
+        << " differs from serial conversion (" << mode << ")" << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  PrintMeasurement("SerialConversionTime" + mode, numberOfSegments, serialTime);
+  PrintMeasurement("ParallelConversionTime" + mode, numberOfSegments, parallelTime);
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkSegmentationConversionPerformanceTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  int numberOfSegmentsList[] = { 4, 16, 64 };
+  for (int numberOfSegments : numberOfSegmentsList)
+    {
+    if (TestConversionPerformance(numberOfSegments, false) != EXIT_SUCCESS)
+      {
+      return EXIT_FAILURE;
+      }
+    if (TestConversionPerformance(numberOfSegments, true) != EXIT_SUCCESS)
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
@@ -158,6 +158,12 @@ int vtkSegmentationHistoryTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
     }
 
+  if (segment2->GetRepresentation(vtkSegmentationConverter::GetBinaryLabelmapRepresentationName()) != undoLabelmap)
+    {
+    std::cerr << "Segments sharing a labelmap should still share it after undo!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
   /////////////////////////////////////////////////
   // Test redo
   // Voxel count should be the same as the modified
@@ -178,6 +184,39 @@ int vtkSegmentationHistoryTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
     return EXIT_FAILURE;
     }
 
+  /////////////////////////////////////////////////
+  // Test memory usage
+  // Saved labelmaps are compressed, memory limit removes old states
+  /////////////////////////////////////////////////
+  if (!StateCountCheck(history, 3))
+    {
+    return EXIT_FAILURE;
+    }
+  vtkTypeInt64 labelmapMemorySize = static_cast<vtkTypeInt64>(redoLabelmap->GetActualMemorySize()) * 1024;
+  if (history->GetStateMemorySize(0) <= 0 || history->GetStateMemorySize(0) >= labelmapMemorySize)
+    {
+    std::cerr << "Compressed state memory size (" << history->GetStateMemorySize(0) << ") should be smaller than the labelmap memory size ("
+      << labelmapMemorySize << ")" << std::endl;
+    return EXIT_FAILURE;
+    }
+  if (history->GetMemorySize() > history->GetStateMemorySize(0) + history->GetStateMemorySize(1) + history->GetStateMemorySize(2))
+    {
+    std::cerr << "Total memory size (" << history->GetMemorySize() << ") should not exceed the sum of state memory sizes" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  history->SetMaximumMemorySize(1);
+  if (!StateCountCheck(history, 1))
+    {
+    return EXIT_FAILURE;
+    }
+  if (history->IsRestorePreviousStateAvailable())
+    {
+    std::cerr << "Undo should not be available after all previous states are removed" << std::endl;
+    return EXIT_FAILURE;
+    }
+  history->SetMaximumMemorySize(0);
+
   std::cout << "Segmentation history test 1 passed." << std::endl;
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,129 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkBinaryLabelmapToBrickedLabelmapConversionRule.h"
+#include "vtkBrickedLabelmap.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+
+// VTK includes
+#include <vtkImageThreshold.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+//----------------------------------------------------------------------------
+vtkSegmentationConverterRuleNewMacro(vtkBinaryLabelmapToBrickedLabelmapConversionRule);
+
+//----------------------------------------------------------------------------
+vtkBinaryLabelmapToBrickedLabelmapConversionRule::vtkBinaryLabelmapToBrickedLabelmapConversionRule() = default;
+
+//----------------------------------------------------------------------------
+vtkBinaryLabelmapToBrickedLabelmapConversionRule::~vtkBinaryLabelmapToBrickedLabelmapConversionRule() = default;
+
+//----------------------------------------------------------------------------
+unsigned int vtkBinaryLabelmapToBrickedLabelmapConversionRule::GetConversionCost(
+    vtkDataObject* vtkNotUsed(sourceRepresentation)/*=nullptr*/,
+    vtkDataObject* vtkNotUsed(targetRepresentation)/*=nullptr*/)
+{
+  // Rough input-independent guess (ms)
+  return 50;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBinaryLabelmapToBrickedLabelmapConversionRule::ConstructRepresentationObjectByRepresentation(std::string representationName)
+{
+  if ( !representationName.compare(this->GetSourceRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else if ( !representationName.compare(this->GetTargetRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkBrickedLabelmap::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBinaryLabelmapToBrickedLabelmapConversionRule::ConstructRepresentationObjectByClass(std::string className)
+{
+  if (!className.compare("vtkOrientedImageData"))
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else if (!className.compare("vtkBrickedLabelmap"))
+    {
+    return (vtkDataObject*)vtkBrickedLabelmap::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToBrickedLabelmapConversionRule::Convert(vtkSegment* segment)
+{
+  this->CreateTargetRepresentation(segment);
+
+  vtkDataObject* sourceRepresentation = segment->GetRepresentation(this->GetSourceRepresentationName());
+  vtkDataObject* targetRepresentation = segment->GetRepresentation(this->GetTargetRepresentationName());
+
+  // Check validity of source and target representation objects
+  vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(sourceRepresentation);
+  if (!binaryLabelmap)
+    {
+    vtkErrorMacro("Convert: Source representation is not an oriented image data!");
+    return false;
+    }
+  vtkBrickedLabelmap* brickedLabelmap = vtkBrickedLabelmap::SafeDownCast(targetRepresentation);
+  if (!brickedLabelmap)
+    {
+    vtkErrorMacro("Convert: Target representation is not a bricked labelmap!");
+    return false;
+    }
+
+  if (!binaryLabelmap->GetPointData()->GetScalars() || binaryLabelmap->IsEmpty())
+    {
+    vtkNew<vtkOrientedImageData> emptyLabelmap;
+    emptyLabelmap->CopyDirections(binaryLabelmap);
+    emptyLabelmap->SetOrigin(binaryLabelmap->GetOrigin());
+    emptyLabelmap->SetSpacing(binaryLabelmap->GetSpacing());
+    emptyLabelmap->SetExtent(binaryLabelmap->GetExtent());
+    brickedLabelmap->SetImage(emptyLabelmap.GetPointer());
+    return true;
+    }
+
+  // Binary labelmaps may contain other segments, only keep the voxels of this segment
+  vtkNew<vtkImageThreshold> threshold;
+  threshold->SetInputData(binaryLabelmap);
+  threshold->ThresholdBetween(segment->GetLabelValue(), segment->GetLabelValue());
+  threshold->SetInValue(segment->GetLabelValue());
+  threshold->SetOutValue(0);
+  threshold->Update();
+
+  vtkNew<vtkOrientedImageData> segmentLabelmap;
+  segmentLabelmap->ShallowCopy(threshold->GetOutput());
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  binaryLabelmap->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  segmentLabelmap->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  return brickedLabelmap->SetImage(segmentLabelmap.GetPointer());
+}
@@ -0,0 +1,72 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkBinaryLabelmapToBrickedLabelmapConversionRule_h
+#define __vtkBinaryLabelmapToBrickedLabelmapConversionRule_h
+
+// SegmentationCore includes
+#include "vtkSegmentationConverterRule.h"
+#include "vtkSegmentationConverter.h"
+
+#include "vtkSegmentationCoreConfigure.h"
+
+/// \ingroup SegmentationCore
+/// \brief Convert binary labelmap representation (vtkOrientedImageData type) to
+///   bricked labelmap representation (vtkBrickedLabelmap type). Only the voxels of the
+///   segment label value are kept, as binary labelmaps may be shared between segments.
+class vtkSegmentationCore_EXPORT vtkBinaryLabelmapToBrickedLabelmapConversionRule
+  : public vtkSegmentationConverterRule
+{
+public:
+  static vtkBinaryLabelmapToBrickedLabelmapConversionRule* New();
+  vtkTypeMacro(vtkBinaryLabelmapToBrickedLabelmapConversionRule, vtkSegmentationConverterRule);
+  vtkSegmentationConverterRule* CreateRuleInstance() override;
+
+  /// Constructs representation object from representation name for the supported representation classes
+  /// (typically source and target representation VTK classes, subclasses of vtkDataObject)
+  /// Note: Need to take ownership of the created object! For example using vtkSmartPointer<vtkDataObject>::Take
+  vtkDataObject* ConstructRepresentationObjectByRepresentation(std::string representationName) override;
+
+  /// Constructs representation object from class name for the supported representation classes
+  /// (typically source and target representation VTK classes, subclasses of vtkDataObject)
+  /// Note: Need to take ownership of the created object! For example using vtkSmartPointer<vtkDataObject>::Take
+  vtkDataObject* ConstructRepresentationObjectByClass(std::string className) override;
+
+  /// Update the target representation based on the source representation
+  bool Convert(vtkSegment* segment) override;
+
+  /// Get the cost of the conversion.
+  unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
+
+  /// Human-readable name of the converter rule
+  const char* GetName() override { return "Binary labelmap to bricked labelmap"; };
+
+  /// Human-readable name of the source representation
+  const char* GetSourceRepresentationName() override { return vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName(); };
+
+  /// Human-readable name of the target representation
+  const char* GetTargetRepresentationName() override { return vtkSegmentationConverter::GetSegmentationBrickedLabelmapRepresentationName(); };
+
+protected:
+  vtkBinaryLabelmapToBrickedLabelmapConversionRule();
+  ~vtkBinaryLabelmapToBrickedLabelmapConversionRule() override;
+
+private:
+  vtkBinaryLabelmapToBrickedLabelmapConversionRule(const vtkBinaryLabelmapToBrickedLabelmapConversionRule&) = delete;
+  void operator=(const vtkBinaryLabelmapToBrickedLabelmapConversionRule&) = delete;
+};
+
+#endif // __vtkBinaryLabelmapToBrickedLabelmapConversionRule_h
@@ -68,6 +68,11 @@
 #include <vtkExtractSelection.h>
 #include <vtkSelectionSource.h>
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
 //----------------------------------------------------------------------------
 vtkSegmentationConverterRuleNewMacro(vtkBinaryLabelmapToClosedSurfaceConversionRule);
 
@@ -162,70 +167,248 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment
     {
     if (this->JointSmoothCache.find(orientedBinaryLabelmap) == this->JointSmoothCache.end())
       {
-      double* scalarRange = orientedBinaryLabelmap->GetScalarRange();
-      int lowLabel = (int)(floor(scalarRange[0]));
-      int highLabel = (int)(ceil(scalarRange[1]));
-
-      vtkNew<vtkImageAccumulate> imageAccumulate;
-      imageAccumulate->SetInputData(orientedBinaryLabelmap);
-      imageAccumulate->IgnoreZeroOn();
-      imageAccumulate->SetComponentOrigin(0, 0, 0);
-      imageAccumulate->SetComponentSpacing(1, 1, 1);
-      imageAccumulate->SetComponentExtent(lowLabel, highLabel, 0, 0, 0, 0);
-      imageAccumulate->Update();
-
       std::vector<int> labelValues;
-      for (int labelValue = lowLabel; labelValue <= highLabel; ++labelValue)
-        {
-        // Add a new threshold for every level in the labelmap
-        double numberOfVoxels = imageAccumulate->GetOutput()->GetPointData()->GetScalars()->GetTuple1((int)labelValue - lowLabel);
-        if (numberOfVoxels > 0.0)
-          {
-          labelValues.push_back(labelValue);
-          }
-        }
+      this->GetLabelValuesInLabelmap(orientedBinaryLabelmap, labelValues);
 
       vtkSmartPointer<vtkPolyData> jointSmoothedSurface = vtkSmartPointer<vtkPolyData>::New();
-      this->CreateClosedSurface(orientedBinaryLabelmap, jointSmoothedSurface, labelValues);
+      if (!this->CreateClosedSurface(orientedBinaryLabelmap, jointSmoothedSurface, labelValues))
+        {
+        vtkErrorMacro("Convert: Failed to create joint smoothed surface");
+        return false;
+        }
       this->JointSmoothCache[orientedBinaryLabelmap] = jointSmoothedSurface;
       }
 
-    vtkDataObject* sharedSurface = this->JointSmoothCache[orientedBinaryLabelmap];
+    vtkPolyData* sharedSurface = this->JointSmoothCache[orientedBinaryLabelmap];
     if (!sharedSurface)
       {
       vtkErrorMacro("Convert: Could not find cached surface");
       return false;
       }
+    this->ExtractLabelSurface(sharedSurface, segment->GetLabelValue(), closedSurfacePolyData);
+    }
+  else
+    {
+    std::vector<int> labelValue = { segment->GetLabelValue() };
+    if (!this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValue))
+      {
+      return false;
+      }
+    }
 
-    vtkNew<vtkSelectionSource> selection;
-    selection->SetContentType(vtkSelectionNode::THRESHOLDS);
-    selection->SetFieldType(vtkSelectionNode::POINT);
-    selection->GetContainingCells();
-    selection->AddThreshold(segment->GetLabelValue(), segment->GetLabelValue());
+  return true;
+}
 
-    vtkNew<vtkExtractSelection> threshold;
-    threshold->SetInputData(sharedSurface);
-    threshold->SetSelectionConnection(selection->GetOutputPort());
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::ConvertSegments(const std::vector<vtkSegment*>& segments)
+{
+  unsigned int numberOfThreads = (this->NumberOfThreads > 0 ? this->NumberOfThreads : std::thread::hardware_concurrency());
+  if (numberOfThreads < 2 || segments.size() < 2)
+    {
+    return this->Superclass::ConvertSegments(segments);
+    }
 
-    vtkNew<vtkGeometryFilter> geometry;
-    geometry->SetInputConnection(threshold->GetOutputPort());
-    geometry->Update();
+  // Get conversion parameters once, worker threads must not access the parameter map
+  double decimationFactor = vtkVariant(this->ConversionParameters[GetDecimationFactorParameterName()].first).ToDouble();
+  double smoothingFactor = vtkVariant(this->ConversionParameters[GetSmoothingFactorParameterName()].first).ToDouble();
+  int computeSurfaceNormals = vtkVariant(this->ConversionParameters[GetComputeSurfaceNormalsParameterName()].first).ToInt();
+  int jointSmoothing = vtkVariant(this->ConversionParameters[GetJointSmoothingParameterName()].first).ToInt();
+  bool jointSmoothingEnabled = (jointSmoothing > 0 && smoothingFactor > 0);
 
-    vtkPolyData* thresholdedSurface = geometry->GetOutput();
-    closedSurfacePolyData->ShallowCopy(thresholdedSurface);
+  // A task converts one segment, or all segments of a shared labelmap if joint smoothing is enabled.
+  // Each task gets its own shallow copy of the labelmap, as pipeline information of a data object
+  // cannot be modified by multiple threads.
+  struct ConversionTask
+    {
+    vtkSmartPointer<vtkOrientedImageData> Labelmap;
+    std::vector<size_t> SegmentIndices;
+    std::vector<int> LabelValues;
+    std::vector<vtkSmartPointer<vtkPolyData> > Surfaces;
+    bool Success{true};
+    };
+  std::vector<ConversionTask> tasks;
+  std::map<vtkOrientedImageData*, size_t> sharedLabelmapTaskIndices;
+  bool success = true;
+  for (size_t segmentIndex = 0; segmentIndex < segments.size(); ++segmentIndex)
+    {
+    vtkSegment* segment = segments[segmentIndex];
+    vtkOrientedImageData* orientedBinaryLabelmap = vtkOrientedImageData::SafeDownCast(
+      segment->GetRepresentation(this->GetSourceRepresentationName()));
+    if (!orientedBinaryLabelmap)
+      {
+      vtkErrorMacro("ConvertSegments: Source representation is not oriented image data");
+      success = false;
+      continue;
+      }
+    size_t taskIndex = tasks.size();
+    if (jointSmoothingEnabled)
+      {
+      std::map<vtkOrientedImageData*, size_t>::iterator taskIt = sharedLabelmapTaskIndices.find(orientedBinaryLabelmap);
+      if (taskIt != sharedLabelmapTaskIndices.end())
+        {
+        taskIndex = taskIt->second;
+        }
+      else
+        {
+        sharedLabelmapTaskIndices[orientedBinaryLabelmap] = taskIndex;
+        }
+      }
+    if (taskIndex == tasks.size())
+      {
+      tasks.emplace_back();
+      tasks.back().Labelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+      tasks.back().Labelmap->ShallowCopy(orientedBinaryLabelmap);
+      }
+    tasks[taskIndex].SegmentIndices.push_back(segmentIndex);
+    tasks[taskIndex].LabelValues.push_back(segment->GetLabelValue());
     }
-  else
+
+  // Worker threads take the next task until all tasks are done. Only one conversion pipeline
+  // per thread exists at a time, which bounds the memory used by intermediate results.
+  std::atomic<size_t> nextTaskIndex(0);
+  auto convertTasks = [&]()
     {
-    std::vector<int> labelValue = { segment->GetLabelValue() };
-    this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValue);
+    for (size_t taskIndex = nextTaskIndex++; taskIndex < tasks.size(); taskIndex = nextTaskIndex++)
+      {
+      ConversionTask& task = tasks[taskIndex];
+      if (jointSmoothingEnabled)
+        {
+        std::vector<int> labelValuesInLabelmap;
+        GetLabelValuesInLabelmap(task.Labelmap, labelValuesInLabelmap);
+        vtkNew<vtkPolyData> jointSmoothedSurface;
+        task.Success = this->CreateClosedSurface(task.Labelmap, jointSmoothedSurface, labelValuesInLabelmap,
+          decimationFactor, smoothingFactor, computeSurfaceNormals > 0);
+        if (!task.Success)
+          {
+          continue;
+          }
+        for (int labelValue : task.LabelValues)
+          {
+          vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+          ExtractLabelSurface(jointSmoothedSurface, labelValue, surface);
+          task.Surfaces.push_back(surface);
+          }
+        }
+      else
+        {
+        vtkSmartPointer<vtkPolyData> surface = vtkSmartPointer<vtkPolyData>::New();
+        task.Success = this->CreateClosedSurface(task.Labelmap, surface, task.LabelValues,
+          decimationFactor, smoothingFactor, computeSurfaceNormals > 0);
+        task.Surfaces.push_back(surface);
+        }
+      }
+    };
+  size_t numberOfWorkerThreads = std::min(static_cast<size_t>(numberOfThreads), tasks.size());
+  std::vector<std::thread> workerThreads;
+  for (size_t threadIndex = 1; threadIndex < numberOfWorkerThreads; ++threadIndex)
+    {
+    workerThreads.emplace_back(convertTasks);
+    }
+  convertTasks();
+  for (std::thread& workerThread : workerThreads)
+    {
+    workerThread.join();
     }
 
-  return true;
+  // Update target representations in the calling thread, in the order of the segments,
+  // as segments invoke modified events.
+  std::vector<vtkPolyData*> surfaces(segments.size(), nullptr);
+  for (const ConversionTask& task : tasks)
+    {
+    if (!task.Success)
+      {
+      // Errors are reported from the calling thread, segments of failed tasks are not updated
+      vtkErrorMacro("ConvertSegments: Failed to create closed surface of " << task.SegmentIndices.size() << " segment(s)");
+      success = false;
+      continue;
+      }
+    for (size_t i = 0; i < task.SegmentIndices.size(); ++i)
+      {
+      surfaces[task.SegmentIndices[i]] = task.Surfaces[i];
+      }
+    }
+  for (size_t segmentIndex = 0; segmentIndex < segments.size(); ++segmentIndex)
+    {
+    if (!surfaces[segmentIndex])
+      {
+      continue;
+      }
+    this->CreateTargetRepresentation(segments[segmentIndex]);
+    vtkPolyData* closedSurfacePolyData = vtkPolyData::SafeDownCast(
+      segments[segmentIndex]->GetRepresentation(this->GetTargetRepresentationName()));
+    if (!closedSurfacePolyData)
+      {
+      vtkErrorMacro("ConvertSegments: Target representation is not poly data");
+      success = false;
+      continue;
+      }
+    closedSurfacePolyData->ShallowCopy(surfaces[segmentIndex]);
+    }
+  return success;
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::GetLabelValuesInLabelmap(vtkOrientedImageData* binaryLabelmap, std::vector<int>& labelValues)
+{
+  labelValues.clear();
+  double* scalarRange = binaryLabelmap->GetScalarRange();
+  int lowLabel = (int)(floor(scalarRange[0]));
+  int highLabel = (int)(ceil(scalarRange[1]));
+
+  vtkNew<vtkImageAccumulate> imageAccumulate;
+  imageAccumulate->SetInputData(binaryLabelmap);
+  imageAccumulate->IgnoreZeroOn();
+  imageAccumulate->SetComponentOrigin(0, 0, 0);
+  imageAccumulate->SetComponentSpacing(1, 1, 1);
+  imageAccumulate->SetComponentExtent(lowLabel, highLabel, 0, 0, 0, 0);
+  imageAccumulate->Update();
+
+  for (int labelValue = lowLabel; labelValue <= highLabel; ++labelValue)
+    {
+    // Add a new threshold for every level in the labelmap
+    double numberOfVoxels = imageAccumulate->GetOutput()->GetPointData()->GetScalars()->GetTuple1((int)labelValue - lowLabel);
+    if (numberOfVoxels > 0.0)
+      {
+      labelValues.push_back(labelValue);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBinaryLabelmapToClosedSurfaceConversionRule::ExtractLabelSurface(vtkPolyData* jointSurface, int labelValue, vtkPolyData* labelSurface)
+{
+  vtkNew<vtkSelectionSource> selection;
+  selection->SetContentType(vtkSelectionNode::THRESHOLDS);
+  selection->SetFieldType(vtkSelectionNode::POINT);
+  selection->GetContainingCells();
+  selection->AddThreshold(labelValue, labelValue);
+
+  vtkNew<vtkExtractSelection> threshold;
+  threshold->SetInputData(jointSurface);
+  threshold->SetSelectionConnection(selection->GetOutputPort());
+
+  vtkNew<vtkGeometryFilter> geometry;
+  geometry->SetInputConnection(threshold->GetOutputPort());
+  geometry->Update();
+
+  labelSurface->ShallowCopy(geometry->GetOutput());
 }
 
 //----------------------------------------------------------------------------
 bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrientedImageData* orientedBinaryLabelmap,
   vtkPolyData* closedSurfacePolyData, std::vector<int> labelValues)
+{
+  double decimationFactor = vtkVariant(this->ConversionParameters[GetDecimationFactorParameterName()].first).ToDouble();
+  double smoothingFactor = vtkVariant(this->ConversionParameters[GetSmoothingFactorParameterName()].first).ToDouble();
+  int computeSurfaceNormals = vtkVariant(this->ConversionParameters[GetComputeSurfaceNormalsParameterName()].first).ToInt();
+  return this->CreateClosedSurface(orientedBinaryLabelmap, closedSurfacePolyData, labelValues,
+    decimationFactor, smoothingFactor, computeSurfaceNormals > 0);
+}
+
+//----------------------------------------------------------------------------
+bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrientedImageData* orientedBinaryLabelmap,
+  vtkPolyData* closedSurfacePolyData, std::vector<int> labelValues,
+  double decimationFactor, double smoothingFactor, bool computeSurfaceNormals)
 {
   if (!closedSurfacePolyData)
     {
@@ -281,11 +464,6 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   binaryLabelmapWithIdentityGeometry->SetOrigin(0, 0, 0);
   binaryLabelmapWithIdentityGeometry->SetSpacing(1.0, 1.0, 1.0);
 
-  // Get conversion parameters
-  double decimationFactor = vtkVariant(this->ConversionParameters[GetDecimationFactorParameterName()].first).ToDouble();
-  double smoothingFactor = vtkVariant(this->ConversionParameters[GetSmoothingFactorParameterName()].first).ToDouble();
-  int computeSurfaceNormals = vtkVariant(this->ConversionParameters[GetComputeSurfaceNormalsParameterName()].first).ToInt();
-
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
   vtkNew<vtkDiscreteFlyingEdges3D> marchingCubes;
 #else
@@ -364,7 +542,7 @@ bool vtkBinaryLabelmapToClosedSurfaceConversionRule::CreateClosedSurface(vtkOrie
   transformPolyDataFilter->SetInputData(processingResult);
   transformPolyDataFilter->SetTransform(labelmapGeometryTransform);
 
-  if (computeSurfaceNormals > 0)
+  if (computeSurfaceNormals)
     {
     vtkSmartPointer<vtkPolyDataNormals> polyDataNormals = vtkSmartPointer<vtkPolyDataNormals>::New();
     polyDataNormals->SetInputConnection(transformPolyDataFilter->GetOutputPort());
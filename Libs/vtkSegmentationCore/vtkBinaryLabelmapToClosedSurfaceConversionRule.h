@@ -71,6 +71,11 @@ public:
   /// Update the target representation based on the source representation
   bool Convert(vtkSegment* segment) override;
 
+  /// Update the target representation of multiple segments.
+  /// Segments are converted concurrently using up to NumberOfThreads threads. If joint smoothing is enabled
+  /// then each shared labelmap is converted by one thread. The output is the same as converting the segments one by one.
+  bool ConvertSegments(const std::vector<vtkSegment*>& segments) override;
+
   /// Perform postprocesing steps on the output
   /// Clears the joint smoothing cache
   bool PostConvert(vtkSegmentation* segmentation) override;
@@ -92,6 +97,17 @@ protected:
   /// This function checks whether this is the case.
   bool IsLabelmapPaddingNecessary(vtkImageData* binaryLabelMap);
 
+  /// Perform the binary labelmap to closed surface conversion using the specified parameters.
+  /// Conversion parameters of the rule are not accessed, so it can be called from multiple threads at once.
+  bool CreateClosedSurface(vtkOrientedImageData* inputImage, vtkPolyData* outputPolydata, std::vector<int> values,
+    double decimationFactor, double smoothingFactor, bool computeSurfaceNormals);
+
+  /// Get the non-zero label values that are present in the labelmap
+  static void GetLabelValuesInLabelmap(vtkOrientedImageData* binaryLabelmap, std::vector<int>& labelValues);
+
+  /// Extract the surface of one label from a surface created from multiple labels
+  static void ExtractLabelSurface(vtkPolyData* jointSurface, int labelValue, vtkPolyData* labelSurface);
+
 protected:
   vtkBinaryLabelmapToClosedSurfaceConversionRule();
   ~vtkBinaryLabelmapToClosedSurfaceConversionRule() override;
@@ -0,0 +1,576 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#include "vtkBrickedLabelmap.h"
+
+// SegmentationCore includes
+#include "vtkOrientedImageData.h"
+#include "vtkOrientedImageDataResample.h"
+
+// VTK includes
+#include <vtkBoundingBox.h>
+#include <vtkDataArray.h>
+#include <vtkImageData.h>
+#include <vtkMath.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <algorithm>
+
+vtkStandardNewMacro(vtkBrickedLabelmap);
+
+namespace
+{
+//----------------------------------------------------------------------------
+int FloorDivide(int dividend, int divisor)
+{
+  return (dividend >= 0 ? dividend / divisor : -((-dividend + divisor - 1) / divisor));
+}
+
+//----------------------------------------------------------------------------
+bool IsExtentEmpty(const int extent[6])
+{
+  return (extent[0] > extent[1] || extent[2] > extent[3] || extent[4] > extent[5]);
+}
+
+//----------------------------------------------------------------------------
+template <class T>
+bool IsUniformGeneric(T* voxels, vtkIdType numberOfVoxels, double& uniformValue)
+{
+  T firstValue = voxels[0];
+  for (vtkIdType voxelIndex = 1; voxelIndex < numberOfVoxels; ++voxelIndex)
+    {
+    if (voxels[voxelIndex] != firstValue)
+      {
+      return false;
+      }
+    }
+  uniformValue = static_cast<double>(firstValue);
+  return true;
+}
+}
+
+//----------------------------------------------------------------------------
+vtkBrickedLabelmap::vtkBrickedLabelmap()
+{
+  this->Extent[0] = this->Extent[2] = this->Extent[4] = 0;
+  this->Extent[1] = this->Extent[3] = this->Extent[5] = -1;
+  this->ScalarType = VTK_UNSIGNED_CHAR;
+  this->BrickSize = 16;
+  for (int row = 0; row < 4; ++row)
+    {
+    for (int column = 0; column < 4; ++column)
+      {
+      this->ImageToWorldMatrix[row][column] = (row == column ? 1.0 : 0.0);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkBrickedLabelmap::~vtkBrickedLabelmap() = default;
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::PrintSelf(ostream& os, vtkIndent indent)
+{
+  this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Extent: (" << this->Extent[0] << ", " << this->Extent[1] << ", " << this->Extent[2]
+    << ", " << this->Extent[3] << ", " << this->Extent[4] << ", " << this->Extent[5] << ")\n";
+  os << indent << "ScalarType: " << this->ScalarType << "\n";
+  os << indent << "BrickSize: " << this->BrickSize << "\n";
+  os << indent << "Number of uniform bricks: " << this->GetNumberOfBricks(BRICK_UNIFORM) << "\n";
+  os << indent << "Number of dense bricks: " << this->GetNumberOfBricks(BRICK_DENSE) << "\n";
+  os << indent << "ImageToWorldMatrix:\n";
+  for (int row = 0; row < 4; ++row)
+    {
+    os << indent.GetNextIndent();
+    for (int column = 0; column < 4; ++column)
+      {
+      os << this->ImageToWorldMatrix[row][column] << " ";
+      }
+    os << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::Initialize()
+{
+  this->Superclass::Initialize();
+  this->Extent[0] = this->Extent[2] = this->Extent[4] = 0;
+  this->Extent[1] = this->Extent[3] = this->Extent[5] = -1;
+  this->Bricks.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::ShallowCopy(vtkDataObject *dataObject)
+{
+  vtkBrickedLabelmap* labelmap = vtkBrickedLabelmap::SafeDownCast(dataObject);
+  this->Superclass::ShallowCopy(dataObject);
+  if (!labelmap)
+    {
+    return;
+    }
+  std::copy(labelmap->Extent, labelmap->Extent + 6, this->Extent);
+  this->ScalarType = labelmap->ScalarType;
+  this->BrickSize = labelmap->BrickSize;
+  std::copy(&labelmap->ImageToWorldMatrix[0][0], &labelmap->ImageToWorldMatrix[0][0] + 16, &this->ImageToWorldMatrix[0][0]);
+  // Voxels are copied on write, by whichever labelmap modifies them first
+  for (std::map<BrickIndexType, Brick>::iterator brickIt = labelmap->Bricks.begin(); brickIt != labelmap->Bricks.end(); ++brickIt)
+    {
+    brickIt->second.Shared = (brickIt->second.Scalars != nullptr);
+    }
+  this->Bricks = labelmap->Bricks;
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::DeepCopy(vtkDataObject *dataObject)
+{
+  vtkBrickedLabelmap* labelmap = vtkBrickedLabelmap::SafeDownCast(dataObject);
+  this->Superclass::DeepCopy(dataObject);
+  if (!labelmap)
+    {
+    return;
+    }
+  std::copy(labelmap->Extent, labelmap->Extent + 6, this->Extent);
+  this->ScalarType = labelmap->ScalarType;
+  this->BrickSize = labelmap->BrickSize;
+  std::copy(&labelmap->ImageToWorldMatrix[0][0], &labelmap->ImageToWorldMatrix[0][0] + 16, &this->ImageToWorldMatrix[0][0]);
+  this->Bricks.clear();
+  for (std::map<BrickIndexType, Brick>::iterator brickIt = labelmap->Bricks.begin(); brickIt != labelmap->Bricks.end(); ++brickIt)
+    {
+    Brick& brick = this->Bricks[brickIt->first];
+    brick.UniformValue = brickIt->second.UniformValue;
+    brick.Shared = false;
+    if (brickIt->second.Scalars)
+      {
+      brick.Scalars = vtkSmartPointer<vtkDataArray>::Take(brickIt->second.Scalars->NewInstance());
+      brick.Scalars->DeepCopy(brickIt->second.Scalars);
+      }
+    }
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+unsigned long vtkBrickedLabelmap::GetActualMemorySize()
+{
+  vtkTypeInt64 size = static_cast<vtkTypeInt64>(this->Bricks.size()) * (sizeof(BrickIndexType) + sizeof(Brick));
+  for (std::map<BrickIndexType, Brick>::iterator brickIt = this->Bricks.begin(); brickIt != this->Bricks.end(); ++brickIt)
+    {
+    if (brickIt->second.Scalars)
+      {
+      size += static_cast<vtkTypeInt64>(brickIt->second.Scalars->GetNumberOfValues()) * brickIt->second.Scalars->GetDataTypeSize();
+      }
+    }
+  return this->Superclass::GetActualMemorySize() + static_cast<unsigned long>((size + 1023) / 1024);
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::GetImageToWorldMatrix(vtkMatrix4x4* mat)
+{
+  if (!mat)
+    {
+    return;
+    }
+  mat->DeepCopy(&this->ImageToWorldMatrix[0][0]);
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::SetImageToWorldMatrix(vtkMatrix4x4* mat)
+{
+  if (!mat)
+    {
+    return;
+    }
+  bool modified = false;
+  for (int row = 0; row < 4; ++row)
+    {
+    for (int column = 0; column < 4; ++column)
+      {
+      if (this->ImageToWorldMatrix[row][column] != mat->GetElement(row, column))
+        {
+        this->ImageToWorldMatrix[row][column] = mat->GetElement(row, column);
+        modified = true;
+        }
+      }
+    }
+  if (modified)
+    {
+    this->Modified();
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::SetExtent(const int extent[6])
+{
+  if (std::equal(extent, extent + 6, this->Extent))
+    {
+    return;
+    }
+  std::copy(extent, extent + 6, this->Extent);
+  this->ClearVoxelsOutsideExtent();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::GetExtent(int extent[6])
+{
+  std::copy(this->Extent, this->Extent + 6, extent);
+}
+
+//----------------------------------------------------------------------------
+bool vtkBrickedLabelmap::IsEmpty()
+{
+  return IsExtentEmpty(this->Extent);
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::GetBounds(double bounds[6])
+{
+  if (this->IsEmpty())
+    {
+    vtkMath::UninitializeBounds(bounds);
+    return;
+    }
+  vtkBoundingBox boundingBox;
+  for (int corner = 0; corner < 8; ++corner)
+    {
+    double ijk[4] = { 0.0, 0.0, 0.0, 1.0 };
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      ijk[axis] = this->Extent[axis * 2 + ((corner >> axis) & 1)];
+      }
+    double world[3] = { 0.0, 0.0, 0.0 };
+    for (int row = 0; row < 3; ++row)
+      {
+      for (int column = 0; column < 4; ++column)
+        {
+        world[row] += this->ImageToWorldMatrix[row][column] * ijk[column];
+        }
+      }
+    boundingBox.AddPoint(world);
+    }
+  boundingBox.GetBounds(bounds);
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::SetScalarType(int scalarType)
+{
+  if (scalarType == this->ScalarType)
+    {
+    return;
+    }
+  this->ScalarType = scalarType;
+  this->Bricks.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::SetBrickSize(int brickSize)
+{
+  if (brickSize < 1)
+    {
+    vtkErrorMacro("SetBrickSize: invalid brick size " << brickSize);
+    return;
+    }
+  if (brickSize == this->BrickSize)
+    {
+    return;
+    }
+  this->BrickSize = brickSize;
+  this->Bricks.clear();
+  this->Modified();
+}
+
+//----------------------------------------------------------------------------
+bool vtkBrickedLabelmap::SetImage(vtkOrientedImageData* image)
+{
+  if (!image)
+    {
+    vtkErrorMacro("SetImage: invalid input image");
+    return false;
+    }
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  image->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  this->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  image->GetExtent(this->Extent);
+  this->Bricks.clear();
+  if (image->GetPointData()->GetScalars() == nullptr || this->IsEmpty())
+    {
+    this->Modified();
+    return true;
+    }
+  this->ScalarType = image->GetScalarType();
+
+  vtkSmartPointer<vtkImageData> inputImage = image;
+  if (image->GetNumberOfScalarComponents() > 1)
+    {
+    inputImage = vtkSmartPointer<vtkImageData>::New();
+    inputImage->SetExtent(image->GetExtent());
+    inputImage->AllocateScalars(this->ScalarType, 1);
+    inputImage->GetPointData()->GetScalars()->CopyComponent(0, image->GetPointData()->GetScalars(), 0);
+    }
+
+  int brickIndexRange[6] = { 0, -1, 0, -1, 0, -1 };
+  this->GetBrickIndexRange(this->Extent, brickIndexRange);
+  vtkNew<vtkImageData> brickImage;
+  for (int k = brickIndexRange[4]; k <= brickIndexRange[5]; ++k)
+    {
+    for (int j = brickIndexRange[2]; j <= brickIndexRange[3]; ++j)
+      {
+      for (int i = brickIndexRange[0]; i <= brickIndexRange[1]; ++i)
+        {
+        int brickIndex[3] = { i, j, k };
+        int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        this->GetBrickExtent(brickIndex, brickExtent);
+        // Each brick gets new scalars, as they are kept by SetBrickImage for dense bricks
+        this->GetBrickImage(brickIndex, brickImage.GetPointer());
+        int copiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        for (int axis = 0; axis < 3; ++axis)
+          {
+          copiedExtent[axis * 2] = std::max(brickExtent[axis * 2], this->Extent[axis * 2]);
+          copiedExtent[axis * 2 + 1] = std::min(brickExtent[axis * 2 + 1], this->Extent[axis * 2 + 1]);
+          }
+        brickImage->CopyAndCastFrom(inputImage, copiedExtent);
+        this->SetBrickImage(brickIndex, brickImage.GetPointer());
+        }
+      }
+    }
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkBrickedLabelmap::GetImage(vtkOrientedImageData* image, const int extent[6]/*=nullptr*/)
+{
+  if (!image)
+    {
+    vtkErrorMacro("GetImage: invalid output image");
+    return false;
+    }
+  int outputExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  std::copy(extent ? extent : this->Extent, (extent ? extent : this->Extent) + 6, outputExtent);
+
+  vtkNew<vtkMatrix4x4> imageToWorldMatrix;
+  this->GetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  image->SetImageToWorldMatrix(imageToWorldMatrix.GetPointer());
+  image->SetExtent(outputExtent);
+  image->AllocateScalars(this->ScalarType, 1);
+  if (IsExtentEmpty(outputExtent))
+    {
+    return true;
+    }
+  vtkOrientedImageDataResample::FillImage(image, 0.0);
+
+  vtkNew<vtkImageData> brickImage;
+  for (std::map<BrickIndexType, Brick>::iterator brickIt = this->Bricks.begin(); brickIt != this->Bricks.end(); ++brickIt)
+    {
+    int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    this->GetBrickExtent(brickIt->first.data(), brickExtent);
+    int copiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      copiedExtent[axis * 2] = std::max(brickExtent[axis * 2], outputExtent[axis * 2]);
+      copiedExtent[axis * 2 + 1] = std::min(brickExtent[axis * 2 + 1], outputExtent[axis * 2 + 1]);
+      }
+    if (IsExtentEmpty(copiedExtent))
+      {
+      continue;
+      }
+    if (!brickIt->second.Scalars)
+      {
+      vtkOrientedImageDataResample::FillImage(image, brickIt->second.UniformValue, copiedExtent);
+      continue;
+      }
+    this->GetBrickImage(brickIt->first.data(), brickImage.GetPointer(), true);
+    image->CopyAndCastFrom(brickImage.GetPointer(), copiedExtent);
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::GetBrickIndexRange(const int extent[6], int brickIndexRange[6])
+{
+  if (IsExtentEmpty(extent))
+    {
+    brickIndexRange[0] = brickIndexRange[2] = brickIndexRange[4] = 0;
+    brickIndexRange[1] = brickIndexRange[3] = brickIndexRange[5] = -1;
+    return;
+    }
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    brickIndexRange[axis * 2] = FloorDivide(extent[axis * 2], this->BrickSize);
+    brickIndexRange[axis * 2 + 1] = FloorDivide(extent[axis * 2 + 1], this->BrickSize);
+    }
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::GetBrickExtent(const int brickIndex[3], int brickExtent[6])
+{
+  for (int axis = 0; axis < 3; ++axis)
+    {
+    brickExtent[axis * 2] = brickIndex[axis] * this->BrickSize;
+    brickExtent[axis * 2 + 1] = brickExtent[axis * 2] + this->BrickSize - 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedLabelmap::GetBrickState(const int brickIndex[3], double* uniformValue/*=nullptr*/)
+{
+  BrickIndexType index = { { brickIndex[0], brickIndex[1], brickIndex[2] } };
+  std::map<BrickIndexType, Brick>::iterator brickIt = this->Bricks.find(index);
+  if (brickIt == this->Bricks.end())
+    {
+    if (uniformValue)
+      {
+      *uniformValue = 0.0;
+      }
+    return BRICK_EMPTY;
+    }
+  if (brickIt->second.Scalars)
+    {
+    return BRICK_DENSE;
+    }
+  if (uniformValue)
+    {
+    *uniformValue = brickIt->second.UniformValue;
+    }
+  return BRICK_UNIFORM;
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::GetBrickImage(const int brickIndex[3], vtkImageData* brickImage, bool readOnly/*=false*/)
+{
+  if (!brickImage)
+    {
+    return;
+    }
+  int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  this->GetBrickExtent(brickIndex, brickExtent);
+  brickImage->SetExtent(brickExtent);
+
+  BrickIndexType index = { { brickIndex[0], brickIndex[1], brickIndex[2] } };
+  std::map<BrickIndexType, Brick>::iterator brickIt = this->Bricks.find(index);
+  if (brickIt != this->Bricks.end() && brickIt->second.Scalars)
+    {
+    if (brickIt->second.Shared && !readOnly)
+      {
+      vtkSmartPointer<vtkDataArray> scalars = vtkSmartPointer<vtkDataArray>::Take(brickIt->second.Scalars->NewInstance());
+      scalars->DeepCopy(brickIt->second.Scalars);
+      brickIt->second.Scalars = scalars;
+      brickIt->second.Shared = false;
+      }
+    brickImage->GetPointData()->SetScalars(brickIt->second.Scalars);
+    return;
+    }
+  vtkSmartPointer<vtkDataArray> scalars = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(this->ScalarType));
+  scalars->SetNumberOfComponents(1);
+  scalars->SetNumberOfTuples(static_cast<vtkIdType>(this->BrickSize) * this->BrickSize * this->BrickSize);
+  scalars->Fill(brickIt != this->Bricks.end() ? brickIt->second.UniformValue : 0.0);
+  brickImage->GetPointData()->SetScalars(scalars);
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::SetBrickImage(const int brickIndex[3], vtkImageData* brickImage)
+{
+  BrickIndexType index = { { brickIndex[0], brickIndex[1], brickIndex[2] } };
+  vtkDataArray* scalars = (brickImage ? brickImage->GetPointData()->GetScalars() : nullptr);
+  if (!scalars || scalars->GetNumberOfTuples() < 1)
+    {
+    this->Bricks.erase(index);
+    return;
+    }
+
+  double uniformValue = 0.0;
+  bool uniform = false;
+  switch (scalars->GetDataType())
+    {
+    vtkTemplateMacro(uniform = IsUniformGeneric<VTK_TT>(static_cast<VTK_TT*>(scalars->GetVoidPointer(0)),
+      scalars->GetNumberOfTuples(), uniformValue));
+    default:
+      vtkErrorMacro("SetBrickImage: unknown scalar type");
+      return;
+    }
+  if (uniform && uniformValue == 0.0)
+    {
+    this->Bricks.erase(index);
+    return;
+    }
+  Brick& brick = this->Bricks[index];
+  brick.UniformValue = (uniform ? uniformValue : 0.0);
+  brick.Scalars = (uniform ? nullptr : scalars);
+  brick.Shared = false;
+}
+
+//----------------------------------------------------------------------------
+int vtkBrickedLabelmap::GetNumberOfBricks(int brickState)
+{
+  int numberOfBricks = 0;
+  for (std::map<BrickIndexType, Brick>::iterator brickIt = this->Bricks.begin(); brickIt != this->Bricks.end(); ++brickIt)
+    {
+    int currentBrickState = (brickIt->second.Scalars ? BRICK_DENSE : BRICK_UNIFORM);
+    if (currentBrickState == brickState)
+      {
+      ++numberOfBricks;
+      }
+    }
+  return numberOfBricks;
+}
+
+//----------------------------------------------------------------------------
+void vtkBrickedLabelmap::ClearVoxelsOutsideExtent()
+{
+  vtkNew<vtkImageData> brickImage;
+  vtkNew<vtkImageData> clippedBrickImage;
+  std::map<BrickIndexType, Brick>::iterator brickIt = this->Bricks.begin();
+  while (brickIt != this->Bricks.end())
+    {
+    int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    this->GetBrickExtent(brickIt->first.data(), brickExtent);
+    int clippedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      clippedExtent[axis * 2] = std::max(brickExtent[axis * 2], this->Extent[axis * 2]);
+      clippedExtent[axis * 2 + 1] = std::min(brickExtent[axis * 2 + 1], this->Extent[axis * 2 + 1]);
+      }
+    if (IsExtentEmpty(clippedExtent))
+      {
+      brickIt = this->Bricks.erase(brickIt);
+      continue;
+      }
+    if (std::equal(clippedExtent, clippedExtent + 6, brickExtent))
+      {
+      // brick is fully inside the extent
+      ++brickIt;
+      continue;
+      }
+    BrickIndexType brickIndex = brickIt->first;
+    ++brickIt;
+    // Brick is partially outside, copy the voxels that are inside into an empty brick
+    this->GetBrickImage(brickIndex.data(), brickImage.GetPointer(), true);
+    clippedBrickImage->SetExtent(brickExtent);
+    clippedBrickImage->AllocateScalars(this->ScalarType, 1);
+    vtkOrientedImageDataResample::FillImage(clippedBrickImage.GetPointer(), 0.0);
+    clippedBrickImage->CopyAndCastFrom(brickImage.GetPointer(), clippedExtent);
+    this->SetBrickImage(brickIndex.data(), clippedBrickImage.GetPointer());
+    // SetBrickImage keeps the scalars of dense bricks, so they must not be reused
+    clippedBrickImage->GetPointData()->SetScalars(nullptr);
+    }
+}
@@ -0,0 +1,158 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+#ifndef __vtkBrickedLabelmap_h
+#define __vtkBrickedLabelmap_h
+
+// Segmentation includes
+#include "vtkSegmentationCoreConfigure.h"
+
+// VTK includes
+#include <vtkDataObject.h>
+#include <vtkSmartPointer.h>
+
+// STD includes
+#include <array>
+#include <map>
+
+class vtkDataArray;
+class vtkImageData;
+class vtkMatrix4x4;
+class vtkOrientedImageData;
+
+/// \ingroup SegmentationCore
+/// \brief Sparse labelmap made of cubic bricks of voxels
+///
+/// The IJK grid is divided into bricks of BrickSize^3 voxels. Bricks that contain only
+/// zero voxels are not stored, bricks that contain a single value only store that value,
+/// and only the other bricks store their voxels. Memory usage and the cost of modifications
+/// therefore depend on the surface of the segment instead of its bounding box.
+///
+/// Bricks are aligned to the IJK grid (brick index = floor(voxel index / BrickSize)), so
+/// the extent can be changed without moving voxels. Voxels outside of the extent are zero.
+/// Geometry is defined the same way as in vtkOrientedImageData.
+/// \sa vtkOrientedImageDataResample::ModifyImage, vtkOrientedImageDataResample::CalculateEffectiveExtent
+class vtkSegmentationCore_EXPORT vtkBrickedLabelmap : public vtkDataObject
+{
+public:
+  static vtkBrickedLabelmap *New();
+  vtkTypeMacro(vtkBrickedLabelmap,vtkDataObject);
+  void PrintSelf(ostream& os, vtkIndent indent) override;
+
+  enum
+    {
+    BRICK_EMPTY = 0, ///< all voxels of the brick are zero, nothing is stored
+    BRICK_UNIFORM,   ///< all voxels of the brick have the same non-zero value
+    BRICK_DENSE      ///< voxels of the brick are stored
+    };
+
+  /// Remove all bricks and reset the extent to empty
+  void Initialize() override;
+  /// Shallow copy, voxels of the bricks are shared until one of the labelmaps modifies them
+  void ShallowCopy(vtkDataObject *src) override;
+  /// Deep copy
+  void DeepCopy(vtkDataObject *src) override;
+  /// Memory used by the stored bricks, in kibibytes
+  unsigned long GetActualMemorySize() override;
+
+  /// Get the geometry matrix that includes the spacing, directions, and origin information
+  void GetImageToWorldMatrix(vtkMatrix4x4* mat);
+  /// Set the geometry matrix that includes the spacing, directions, and origin information
+  void SetImageToWorldMatrix(vtkMatrix4x4* mat);
+
+  /// Extent of the labelmap. Voxels that are removed from the extent are set to zero.
+  void SetExtent(const int extent[6]);
+  const int* GetExtent() { return this->Extent; };
+  void GetExtent(int extent[6]);
+
+  /// Determines whether the labelmap is empty (if the extent has 0 voxels then it is)
+  bool IsEmpty();
+
+  /// Compute bounds of the extent in world coordinates (xmin,xmax, ymin,ymax, zmin,zmax).
+  void GetBounds(double bounds[6]);
+
+  /// Scalar type of the voxels. Changing the scalar type removes all bricks.
+  void SetScalarType(int scalarType);
+  vtkGetMacro(ScalarType, int);
+
+  /// Number of voxels along each side of the bricks. Changing the brick size removes all bricks.
+  /// Default is 16.
+  void SetBrickSize(int brickSize);
+  vtkGetMacro(BrickSize, int);
+
+  /// Replace the content of the labelmap by the voxels and geometry of an image.
+  /// Only voxels of the first scalar component are used.
+  bool SetImage(vtkOrientedImageData* image);
+
+  /// Write voxels of the extent into an image. The image geometry is set to the labelmap geometry.
+  /// \param extent Extent of the output image. The labelmap extent is used if nullptr.
+  bool GetImage(vtkOrientedImageData* image, const int extent[6]=nullptr);
+
+  /// Get index range (minI, maxI, minJ, maxJ, minK, maxK) of the bricks intersecting an extent
+  void GetBrickIndexRange(const int extent[6], int brickIndexRange[6]);
+
+  /// Get the voxel extent of a brick
+  void GetBrickExtent(const int brickIndex[3], int brickExtent[6]);
+
+  /// Get the state of a brick (BRICK_EMPTY, BRICK_UNIFORM, or BRICK_DENSE).
+  /// \param uniformValue Value of the voxels for BRICK_UNIFORM bricks, 0 for BRICK_EMPTY bricks.
+  int GetBrickState(const int brickIndex[3], double* uniformValue=nullptr);
+
+  /// Set up an image containing the voxels of the brick. The image extent is the brick extent.
+  /// Voxels of dense bricks are shared with the image, so that in-place modifications of the
+  /// image can be stored by calling SetBrickImage. Voxels shared with a shallow copy of the
+  /// labelmap are deep copied first, unless readOnly is true.
+  /// \param readOnly If true then the image must not be modified.
+  void GetBrickImage(const int brickIndex[3], vtkImageData* brickImage, bool readOnly=false);
+
+  /// Store the voxels of an image obtained by GetBrickImage.
+  /// The brick is stored as empty, uniform, or dense depending on its voxels.
+  /// Modified() is not called, so that multiple bricks can be set before notifying observers.
+  void SetBrickImage(const int brickIndex[3], vtkImageData* brickImage);
+
+  /// Get the number of stored bricks of the given state (BRICK_UNIFORM or BRICK_DENSE)
+  int GetNumberOfBricks(int brickState);
+
+protected:
+  vtkBrickedLabelmap();
+  ~vtkBrickedLabelmap() override;
+
+  /// Set voxels of the bricks that are outside of the extent to zero
+  void ClearVoxelsOutsideExtent();
+
+  typedef std::array<int, 3> BrickIndexType;
+  struct Brick
+    {
+    /// Value of all the voxels if the brick is uniform
+    double UniformValue{0.0};
+    /// Voxels of dense bricks, nullptr for uniform bricks
+    vtkSmartPointer<vtkDataArray> Scalars;
+    /// Scalars are shared with a shallow copy and must be copied before modification
+    bool Shared{false};
+    };
+
+  int Extent[6];
+  int ScalarType;
+  int BrickSize;
+  double ImageToWorldMatrix[4][4];
+  std::map<BrickIndexType, Brick> Bricks;
+
+private:
+  vtkBrickedLabelmap(const vtkBrickedLabelmap&) = delete;
+  void operator=(const vtkBrickedLabelmap&) = delete;
+};
+
+#endif
@@ -0,0 +1,102 @@
+/*==============================================================================
+
+  Copyright (c) Laboratory for Percutaneous Surgery (PerkLab)
+  Queen's University, Kingston, ON, Canada. All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// SegmentationCore includes
+#include "vtkBrickedLabelmapToBinaryLabelmapConversionRule.h"
+#include "vtkBrickedLabelmap.h"
+#include "vtkOrientedImageData.h"
+#include "vtkSegment.h"
+
+// VTK includes
+#include <vtkObjectFactory.h>
+
+//----------------------------------------------------------------------------
+vtkSegmentationConverterRuleNewMacro(vtkBrickedLabelmapToBinaryLabelmapConversionRule);
+
+//----------------------------------------------------------------------------
+vtkBrickedLabelmapToBinaryLabelmapConversionRule::vtkBrickedLabelmapToBinaryLabelmapConversionRule() = default;
+
+//----------------------------------------------------------------------------
+vtkBrickedLabelmapToBinaryLabelmapConversionRule::~vtkBrickedLabelmapToBinaryLabelmapConversionRule() = default;
+
+//----------------------------------------------------------------------------
+unsigned int vtkBrickedLabelmapToBinaryLabelmapConversionRule::GetConversionCost(
+    vtkDataObject* vtkNotUsed(sourceRepresentation)/*=nullptr*/,
+    vtkDataObject* vtkNotUsed(targetRepresentation)/*=nullptr*/)
+{
+  // Rough input-independent guess (ms)
+  return 50;
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBrickedLabelmapToBinaryLabelmapConversionRule::ConstructRepresentationObjectByRepresentation(std::string representationName)
+{
+  if ( !representationName.compare(this->GetSourceRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkBrickedLabelmap::New();
+    }
+  else if ( !representationName.compare(this->GetTargetRepresentationName()) )
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+vtkDataObject* vtkBrickedLabelmapToBinaryLabelmapConversionRule::ConstructRepresentationObjectByClass(std::string className)
+{
+  if (!className.compare("vtkBrickedLabelmap"))
+    {
+    return (vtkDataObject*)vtkBrickedLabelmap::New();
+    }
+  else if (!className.compare("vtkOrientedImageData"))
+    {
+    return (vtkDataObject*)vtkOrientedImageData::New();
+    }
+  else
+    {
+    return nullptr;
+    }
+}
+
+//----------------------------------------------------------------------------
+bool vtkBrickedLabelmapToBinaryLabelmapConversionRule::Convert(vtkSegment* segment)
+{
+  this->CreateTargetRepresentation(segment);
+
+  vtkDataObject* sourceRepresentation = segment->GetRepresentation(this->GetSourceRepresentationName());
+  vtkDataObject* targetRepresentation = segment->GetRepresentation(this->GetTargetRepresentationName());
+
+  // Check validity of source and target representation objects
+  vtkBrickedLabelmap* brickedLabelmap = vtkBrickedLabelmap::SafeDownCast(sourceRepresentation);
+  if (!brickedLabelmap)
+    {
+    vtkErrorMacro("Convert: Source representation is not a bricked labelmap!");
+    return false;
+    }
+  vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(targetRepresentation);
+  if (!binaryLabelmap)
+    {
+    vtkErrorMacro("Convert: Target representation is not an oriented image data!");
+    return false;
+    }
+
+  // Voxels of empty and uniform bricks are filled without reading any stored voxels
+  return brickedLabelmap->GetImage(binaryLabelmap);
+}
@@ -101,6 +101,13 @@ vtkDataObject* vtkFractionalLabelmapToClosedSurfaceConversionRule::ConstructRepr
     }
 }
 
+//----------------------------------------------------------------------------
+bool vtkFractionalLabelmapToClosedSurfaceConversionRule::ConvertSegments(const std::vector<vtkSegment*>& segments)
+{
+  // Skip the concurrent binary labelmap conversion of the superclass
+  return this->vtkSegmentationConverterRule::ConvertSegments(segments);
+}
+
 //----------------------------------------------------------------------------
 bool vtkFractionalLabelmapToClosedSurfaceConversionRule::Convert(vtkSegment* segment)
 {
@@ -57,6 +57,10 @@ public:
   /// Update the target representation based on the source representation
   bool Convert(vtkSegment* segment) override;
 
+  /// Update the target representation of multiple segments.
+  /// Fractional labelmaps are converted one segment at a time.
+  bool ConvertSegments(const std::vector<vtkSegment*>& segments) override;
+
   /// Get the cost of the conversion.
   unsigned int GetConversionCost(vtkDataObject* sourceRepresentation=nullptr, vtkDataObject* targetRepresentation=nullptr) override;
 
@@ -20,6 +20,7 @@
 
 // SegmentationCore includes
 #include "vtkOrientedImageDataResample.h"
+#include "vtkBrickedLabelmap.h"
 #include "vtkSegmentationConverter.h"
 #include "vtkOrientedImageData.h"
 
@@ -677,6 +678,99 @@ bool vtkOrientedImageDataResample::CalculateEffectiveExtent(vtkOrientedImageData
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkOrientedImageDataResample::CalculateEffectiveExtent(vtkBrickedLabelmap* labelmap, int effectiveExtent[6], double threshold /*=0.0*/)
+{
+  effectiveExtent[0] = effectiveExtent[2] = effectiveExtent[4] = 0;
+  effectiveExtent[1] = effectiveExtent[3] = effectiveExtent[5] = -1;
+  if (!labelmap || labelmap->IsEmpty())
+    {
+    return false;
+    }
+
+  const int* labelmapExtent = labelmap->GetExtent();
+  int brickIndexRange[6] = { 0, -1, 0, -1, 0, -1 };
+  labelmap->GetBrickIndexRange(labelmapExtent, brickIndexRange);
+  vtkNew<vtkOrientedImageData> brickImage;
+  for (int k = brickIndexRange[4]; k <= brickIndexRange[5]; ++k)
+    {
+    for (int j = brickIndexRange[2]; j <= brickIndexRange[3]; ++j)
+      {
+      for (int i = brickIndexRange[0]; i <= brickIndexRange[1]; ++i)
+        {
+        int brickIndex[3] = { i, j, k };
+        double uniformValue = 0.0;
+        int brickState = labelmap->GetBrickState(brickIndex, &uniformValue);
+        if (brickState != vtkBrickedLabelmap::BRICK_DENSE && uniformValue <= threshold)
+          {
+          continue;
+          }
+        int brickExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        labelmap->GetBrickExtent(brickIndex, brickExtent);
+        int brickEffectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+        if (brickState == vtkBrickedLabelmap::BRICK_DENSE)
+          {
+          bool insideEffectiveExtent = true;
+          for (int axis = 0; axis < 3; ++axis)
+            {
+            if (brickExtent[axis * 2] < effectiveExtent[axis * 2] || brickExtent[axis * 2 + 1] > effectiveExtent[axis * 2 + 1])
+              {
+              insideEffectiveExtent = false;
+              }
+            }
+          if (insideEffectiveExtent)
+            {
+            // voxels of this brick cannot grow the effective extent
+            continue;
+            }
+          labelmap->GetBrickImage(brickIndex, brickImage.GetPointer(), true);
+          switch (brickImage->GetScalarType())
+            {
+            vtkTemplateMacro(CalculateEffectiveExtentGeneric<VTK_TT>(brickImage.GetPointer(), brickEffectiveExtent, threshold));
+          default:
+            vtkGenericWarningMacro("vtkOrientedImageDataResample::CalculateEffectiveExtent: Unknown ScalarType");
+            return false;
+            }
+          }
+        else
+          {
+          std::copy(brickExtent, brickExtent + 6, brickEffectiveExtent);
+          }
+        for (int axis = 0; axis < 3; ++axis)
+          {
+          brickEffectiveExtent[axis * 2] = std::max(brickEffectiveExtent[axis * 2], labelmapExtent[axis * 2]);
+          brickEffectiveExtent[axis * 2 + 1] = std::min(brickEffectiveExtent[axis * 2 + 1], labelmapExtent[axis * 2 + 1]);
+          }
+        if (brickEffectiveExtent[0] > brickEffectiveExtent[1] || brickEffectiveExtent[2] > brickEffectiveExtent[3]
+          || brickEffectiveExtent[4] > brickEffectiveExtent[5])
+          {
+          continue;
+          }
+        bool effectiveExtentEmpty = (effectiveExtent[0] > effectiveExtent[1]);
+        for (int axis = 0; axis < 3; ++axis)
+          {
+          if (effectiveExtentEmpty || brickEffectiveExtent[axis * 2] < effectiveExtent[axis * 2])
+            {
+            effectiveExtent[axis * 2] = brickEffectiveExtent[axis * 2];
+            }
+          if (effectiveExtentEmpty || brickEffectiveExtent[axis * 2 + 1] > effectiveExtent[axis * 2 + 1])
+            {
+            effectiveExtent[axis * 2 + 1] = brickEffectiveExtent[axis * 2 + 1];
+            }
+          }
+        }
+      }
+    }
+  brickImage->GetPointData()->SetScalars(nullptr);
+
+  // Return with failure if effective extent is empty
+  if (effectiveExtent[0] > effectiveExtent[1] || effectiveExtent[2] > effectiveExtent[3] || effectiveExtent[4] > effectiveExtent[5])
+    {
+    return false;
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkOrientedImageDataResample::DoGeometriesMatch(vtkOrientedImageData* image1, vtkOrientedImageData* image2)
 {
@@ -1187,6 +1281,181 @@ bool vtkOrientedImageDataResample::ModifyImage(
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool vtkOrientedImageDataResample::ModifyImage(
+    vtkBrickedLabelmap* inputLabelmap,
+    vtkOrientedImageData* modifierImage,
+    int operation,
+    const int extent[6]/*=0*/,
+    double maskThreshold /*=0*/,
+    double fillValue /*=1*/)
+{
+  if (!inputLabelmap || !modifierImage)
+    {
+    return false;
+    }
+  vtkNew<vtkMatrix4x4> labelmapImageToWorldMatrix;
+  inputLabelmap->GetImageToWorldMatrix(labelmapImageToWorldMatrix.GetPointer());
+  vtkNew<vtkMatrix4x4> modifierImageToWorldMatrix;
+  modifierImage->GetImageToWorldMatrix(modifierImageToWorldMatrix.GetPointer());
+  if (!vtkOrientedImageDataResample::IsEqual(labelmapImageToWorldMatrix.GetPointer(), modifierImageToWorldMatrix.GetPointer()))
+    {
+    vtkGenericWarningMacro("vtkOrientedImageDataResample::ModifyImage failed: geometry mismatch between inputLabelmap and modifierImage");
+    return false;
+    }
+
+  // Region that may be modified: intersection of labelmap, modifier image, and requested extents
+  int updateExt[6] = { 0, -1, 0, -1, 0, -1 };
+  inputLabelmap->GetExtent(updateExt);
+  int* modifierExt = modifierImage->GetExtent();
+  for (int idx = 0; idx < 3; ++idx)
+    {
+    updateExt[idx * 2] = std::max(updateExt[idx * 2], modifierExt[idx * 2]);
+    updateExt[idx * 2 + 1] = std::min(updateExt[idx * 2 + 1], modifierExt[idx * 2 + 1]);
+    if (extent)
+      {
+      updateExt[idx * 2] = std::max(updateExt[idx * 2], extent[idx * 2]);
+      updateExt[idx * 2 + 1] = std::min(updateExt[idx * 2 + 1], extent[idx * 2 + 1]);
+      }
+    }
+  if (updateExt[0] > updateExt[1] || updateExt[2] > updateExt[3] || updateExt[4] > updateExt[5])
+    {
+    // labelmap and modifier image don't intersect, nothing need to be done
+    return true;
+    }
+
+  // Empty bricks stay empty if they can only be set to zero
+  bool skipEmptyBricks = (operation == OPERATION_MASKING && fillValue == 0.0)
+    || (operation == OPERATION_MINIMUM && modifierImage->GetScalarTypeMin() >= 0.0);
+
+  int brickIndexRange[6] = { 0, -1, 0, -1, 0, -1 };
+  inputLabelmap->GetBrickIndexRange(updateExt, brickIndexRange);
+  vtkNew<vtkImageData> brickImage;
+  bool labelmapModified = false;
+  for (int k = brickIndexRange[4]; k <= brickIndexRange[5]; ++k)
+    {
+    for (int j = brickIndexRange[2]; j <= brickIndexRange[3]; ++j)
+      {
+      for (int i = brickIndexRange[0]; i <= brickIndexRange[1]; ++i)
+        {
+        int brickIndex[3] = { i, j, k };
+        if (skipEmptyBricks && inputLabelmap->GetBrickState(brickIndex) == vtkBrickedLabelmap::BRICK_EMPTY)
+          {
+          continue;
+          }
+        inputLabelmap->GetBrickImage(brickIndex, brickImage.GetPointer());
+        vtkMTimeType brickImageMTimeBefore = brickImage->GetMTime();
+        switch (brickImage->GetScalarType())
+          {
+          vtkTemplateMacro(MergeImageGeneric<VTK_TT>(
+                             brickImage.GetPointer(),
+                             modifierImage,
+                             operation,
+                             updateExt,
+                             maskThreshold,
+                             fillValue));
+        default:
+          vtkGenericWarningMacro("vtkOrientedImageDataResample::ModifyImage failed: unknown ScalarType");
+          return false;
+          }
+        if (brickImage->GetMTime() > brickImageMTimeBefore)
+          {
+          inputLabelmap->SetBrickImage(brickIndex, brickImage.GetPointer());
+          labelmapModified = true;
+          }
+        // Dense bricks keep the scalars of the brick image, so they must not be reused
+        brickImage->GetPointData()->SetScalars(nullptr);
+        }
+      }
+    }
+  if (labelmapModified)
+    {
+    inputLabelmap->Modified();
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkOrientedImageDataResample::MergeImage(
+    vtkBrickedLabelmap* inputLabelmap,
+    vtkOrientedImageData* imageToAppend,
+    int operation,
+    const int extent[6]/*=nullptr*/,
+    double maskThreshold /*=0*/,
+    double fillValue /*=1*/,
+    bool *outputModified /*=nullptr*/)
+{
+  if (outputModified != nullptr)
+    {
+    (*outputModified) = false;
+    }
+  if (!inputLabelmap || !imageToAppend)
+    {
+    return false;
+    }
+
+  vtkNew<vtkMatrix4x4> imageToAppendImageToWorldMatrix;
+  imageToAppend->GetImageToWorldMatrix(imageToAppendImageToWorldMatrix.GetPointer());
+  if (inputLabelmap->IsEmpty())
+    {
+    inputLabelmap->SetImageToWorldMatrix(imageToAppendImageToWorldMatrix.GetPointer());
+    }
+  else
+    {
+    vtkNew<vtkMatrix4x4> labelmapImageToWorldMatrix;
+    inputLabelmap->GetImageToWorldMatrix(labelmapImageToWorldMatrix.GetPointer());
+    if (!vtkOrientedImageDataResample::IsEqual(labelmapImageToWorldMatrix.GetPointer(), imageToAppendImageToWorldMatrix.GetPointer()))
+      {
+      vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImage failed: geometry mismatch between inputLabelmap and imageToAppend");
+      return false;
+      }
+    }
+
+  // Grow the labelmap extent to contain the appended region. Bricks are aligned to the IJK grid,
+  // so no voxels are moved.
+  int appendedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  imageToAppend->GetExtent(appendedExtent);
+  if (extent)
+    {
+    for (int idx = 0; idx < 3; ++idx)
+      {
+      appendedExtent[idx * 2] = std::max(appendedExtent[idx * 2], extent[idx * 2]);
+      appendedExtent[idx * 2 + 1] = std::min(appendedExtent[idx * 2 + 1], extent[idx * 2 + 1]);
+      }
+    }
+  if (appendedExtent[0] > appendedExtent[1] || appendedExtent[2] > appendedExtent[3] || appendedExtent[4] > appendedExtent[5])
+    {
+    // nothing to append
+    return true;
+    }
+  int unionExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  if (inputLabelmap->IsEmpty())
+    {
+    std::copy(appendedExtent, appendedExtent + 6, unionExtent);
+    }
+  else
+    {
+    inputLabelmap->GetExtent(unionExtent);
+    for (int idx = 0; idx < 3; ++idx)
+      {
+      unionExtent[idx * 2] = std::min(unionExtent[idx * 2], appendedExtent[idx * 2]);
+      unionExtent[idx * 2 + 1] = std::max(unionExtent[idx * 2 + 1], appendedExtent[idx * 2 + 1]);
+      }
+    }
+
+  vtkMTimeType labelmapMTimeBefore = inputLabelmap->GetMTime();
+  inputLabelmap->SetExtent(unionExtent);
+  if (!vtkOrientedImageDataResample::ModifyImage(inputLabelmap, imageToAppend, operation, appendedExtent, maskThreshold, fillValue))
+    {
+    return false;
+    }
+  if (outputModified != nullptr)
+    {
+    (*outputModified) = (labelmapMTimeBefore < inputLabelmap->GetMTime());
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool vtkOrientedImageDataResample::CopyImage(vtkOrientedImageData* imageToCopy, vtkOrientedImageData* outputImage, const int extent[6]/*=0*/)
 {
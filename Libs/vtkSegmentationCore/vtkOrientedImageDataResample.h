@@ -30,6 +30,7 @@
 // std includes
 #include <vector>
 
+class vtkBrickedLabelmap;
 class vtkImageData;
 class vtkMatrix4x4;
 class vtkOrientedImageData;
@@ -87,6 +88,13 @@ public:
   static bool MergeImage(vtkOrientedImageData* inputImage, vtkOrientedImageData* imageToAppend, vtkOrientedImageData* outputImage, int operation,
     const int extent[6]=nullptr, double maskThreshold = 0, double fillValue = 1, bool *outputModified=nullptr);
 
+  /// Combines a bricked labelmap in-place with imageToAppend by max/min operation. The extent of the labelmap
+  /// is grown to contain imageToAppend (restricted to extent if specified), only the bricks of the modified region are processed.
+  /// inputLabelmap and imageToAppend must have the same geometry, unless inputLabelmap is empty, in which case it takes
+  /// the geometry of imageToAppend.
+  static bool MergeImage(vtkBrickedLabelmap* inputLabelmap, vtkOrientedImageData* imageToAppend, int operation,
+    const int extent[6]=nullptr, double maskThreshold = 0, double fillValue = 1, bool *outputModified=nullptr);
+
   /// Modifies inputImage in-place by combining with modifierImage using max/min operation.
   /// The extent will remain unchanged.
   /// Extent can be specified to restrict modifierImage's extent to a smaller region.
@@ -94,6 +102,13 @@ public:
   static bool ModifyImage(vtkOrientedImageData* inputImage, vtkOrientedImageData* modifierImage, int operation,
     const int extent[6] = nullptr, double maskThreshold = 0, double fillValue = 1);
 
+  /// Modifies a bricked labelmap in-place by combining with modifierImage using max/min operation.
+  /// Only the bricks intersecting the modified region are processed, and bricks that cannot change
+  /// (for example empty bricks when erasing) are skipped. The extent will remain unchanged.
+  /// inputLabelmap and modifierImage must have the same geometry (origin, spacing, directions).
+  static bool ModifyImage(vtkBrickedLabelmap* inputLabelmap, vtkOrientedImageData* modifierImage, int operation,
+    const int extent[6] = nullptr, double maskThreshold = 0, double fillValue = 1);
+
   /// Copy image with clipping to the specified extent
   static bool CopyImage(vtkOrientedImageData* imageToCopy, vtkOrientedImageData* outputImage, const int extent[6]=nullptr);
 
@@ -107,6 +122,8 @@ public:
 public:
   /// Calculate effective extent of an image: the IJK extent where non-zero voxels are located
   static bool CalculateEffectiveExtent(vtkOrientedImageData* image, int effectiveExtent[6], double threshold = 0.0);
+  /// Calculate effective extent of a bricked labelmap. Only the voxels of dense bricks are scanned.
+  static bool CalculateEffectiveExtent(vtkBrickedLabelmap* labelmap, int effectiveExtent[6], double threshold = 0.0);
 
   /// Determine if geometries of two oriented image data objects match.
   /// Origin, spacing and direction are considered, extent is not.
@@ -20,6 +20,7 @@
 
 // SegmentationCore includes
 #include "vtkSegment.h"
+#include "vtkBrickedLabelmap.h"
 
 #include "vtkSegmentationConverter.h"
 #include "vtkSegmentationConverterFactory.h"
@@ -257,6 +258,13 @@ void vtkSegment::GetBounds(double bounds[6])
       representationDataSet->GetBounds(representationBounds);
       boundingBox.AddBounds(representationBounds);
       }
+    vtkBrickedLabelmap* brickedLabelmap = vtkBrickedLabelmap::SafeDownCast(reprIt->second);
+    if (brickedLabelmap && !brickedLabelmap->IsEmpty())
+      {
+      double representationBounds[6] = { 1, -1, 1, -1, 1, -1 };
+      brickedLabelmap->GetBounds(representationBounds);
+      boundingBox.AddBounds(representationBounds);
+      }
     }
   boundingBox.GetBounds(bounds);
 }
@@ -1039,6 +1039,7 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
 
     // Perform conversion step
     currentConversionRule->PreConvert(this);
+    std::vector<vtkSegment*> segmentsToConvert;
     for (auto segmentID : segmentIDs)
       {
       vtkSegment* segment = this->GetSegment(segmentID);
@@ -1061,8 +1062,10 @@ bool vtkSegmentation::ConvertSegmentsUsingPath(std::vector<std::string> segmentI
         {
         continue;
         }
-      currentConversionRule->Convert(segment);
+      segmentsToConvert.push_back(segment);
       }
+    // Converting all segments in one call allows rules to process them concurrently
+    currentConversionRule->ConvertSegments(segmentsToConvert);
     currentConversionRule->PostConvert(this);
 
   }
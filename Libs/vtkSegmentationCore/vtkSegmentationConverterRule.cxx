@@ -42,9 +42,24 @@ vtkSegmentationConverterRule* vtkSegmentationConverterRule::Clone()
 {
   vtkSegmentationConverterRule* clone = this->CreateRuleInstance();
   clone->ConversionParameters = this->ConversionParameters;
+  clone->NumberOfThreads = this->NumberOfThreads;
   return clone;
 }
 
+//----------------------------------------------------------------------------
+bool vtkSegmentationConverterRule::ConvertSegments(const std::vector<vtkSegment*>& segments)
+{
+  bool success = true;
+  for (vtkSegment* segment : segments)
+    {
+    if (!this->Convert(segment))
+      {
+      success = false;
+      }
+    }
+  return success;
+}
+
 //----------------------------------------------------------------------------
 bool vtkSegmentationConverterRule::CreateTargetRepresentation(vtkSegment* segment)
 {
@@ -92,6 +92,12 @@ public:
   /// \sa ConvertInternal
   virtual bool Convert(vtkSegment* segment) = 0;
 
+  /// Update the target representation of multiple segments.
+  /// The default implementation calls Convert for each segment. Rules may override it to
+  /// convert the segments concurrently, but target representations must be identical to
+  /// the ones that Convert would create.
+  virtual bool ConvertSegments(const std::vector<vtkSegment*>& segments);
+
   /// Perform post-conversion steps across the specified segments in the segmentation
   /// This step should be unneccessary if only converting a single segment
   virtual bool PostConvert(vtkSegmentation* vtkNotUsed(segmentation)) { return true; };
@@ -132,6 +138,12 @@ public:
   /// Determine if the rule has a parameter with a certain name
   bool HasConversionParameter(const std::string& name);
 
+  /// Maximum number of threads used by rules that convert segments concurrently in ConvertSegments.
+  /// 0 (default) means the number of processor cores, 1 means that segments are converted one at a time.
+  /// The value is copied to the rules of new segmentations when the rule is registered in the factory.
+  vtkSetMacro(NumberOfThreads, int);
+  vtkGetMacro(NumberOfThreads, int);
+
 protected:
   /// Update the target representation based on the source representation
   virtual bool CreateTargetRepresentation(vtkSegment* segment);
@@ -154,6 +166,9 @@ protected:
   /// False by default.
   bool ReplaceTargetRepresentation{false};
 
+  /// Maximum number of threads used by ConvertSegments, 0 means the number of processor cores
+  int NumberOfThreads{0};
+
   friend class vtkSegmentationConverter;
 };
 
@@ -22,14 +22,26 @@
 #include "vtkSegmentationHistory.h"
 #include "vtkSegmentationConverterFactory.h"
 #include "vtkSegmentation.h"
+#include "vtkOrientedImageData.h"
 
 // VTK includes
 #include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkCallbackCommand.h>
+#include <vtkFieldData.h>
+#include <vtkPointData.h>
+#include <vtkTypeUInt32Array.h>
 
 // std includes
 #include <algorithm>
+#include <cstring>
+
+namespace
+{
+// Field data arrays that store the run-length encoded scalars of compressed labelmaps
+const char* RUN_VALUES_ARRAY_NAME = "SegmentationHistoryRunValues";
+const char* RUN_LENGTHS_ARRAY_NAME = "SegmentationHistoryRunLengths";
+}
 
 //----------------------------------------------------------------------------
 vtkStandardNewMacro(vtkSegmentationHistory);
@@ -40,6 +52,8 @@ vtkSegmentationHistory::vtkSegmentationHistory()
   this->Segmentation = nullptr;
 
   this->MaximumNumberOfStates = 5;
+  this->MaximumMemorySize = 0;
+  this->UseCompression = true;
 
   this->LastRestoredState = 0;
   this->RestoreStateInProgress = false;
@@ -98,6 +112,9 @@ void vtkSegmentationHistory::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Modified Time: " << this->GetMTime() << "\n";
 
   os << indent << "Number of saved states:  " << this->SegmentationStates.size() << "\n";
+  os << indent << "MaximumNumberOfStates:  " << this->MaximumNumberOfStates << "\n";
+  os << indent << "MaximumMemorySize:  " << this->MaximumMemorySize << "\n";
+  os << indent << "UseCompression:  " << (this->UseCompression ? "true" : "false") << "\n";
 }
 
 //---------------------------------------------------------------------------
@@ -147,6 +164,16 @@ bool vtkSegmentationHistory::SaveState()
     vtkSegmentation::CopySegment(segmentClone, segment, baselineSegment, savedObjects);
     newSegmentationState.Segments[*segmentIDIt] = segmentClone;
     }
+  if (this->UseCompression)
+    {
+    // Each saved representation is compressed once, even if it is shared by multiple segments
+    // or with the previous state (already compressed then).
+    for (std::map<vtkDataObject*, vtkDataObject*>::iterator savedObjectIt = savedObjects.begin();
+      savedObjectIt != savedObjects.end(); ++savedObjectIt)
+      {
+      vtkSegmentationHistory::CompressLabelmap(vtkOrientedImageData::SafeDownCast(savedObjectIt->second));
+      }
+    }
   this->SegmentationStates.push_back(newSegmentationState);
 
   // Set the current state as last restored state
@@ -184,6 +211,12 @@ bool vtkSegmentationHistory::RestorePreviousState()
     // this->SegmentationStates.size() - 1 is the state that we've just saved
     // this->SegmentationStates.size() - 2 is the state that was the last saved state before
     stateToRestore = (int)this->SegmentationStates.size() - 2;
+    if (stateToRestore < 0)
+      {
+      // previous states have been removed to store the current state
+      vtkWarningMacro("vtkSegmentation::RestorePreviousState failed: There are no previous state available for restore");
+      return false;
+      }
     }
   return this->RestoreState(stateToRestore);
 }
@@ -213,6 +246,32 @@ bool vtkSegmentationHistory::RestoreState(unsigned int stateIndex)
 
   std::set<std::string> segmentIDsToKeep;
   std::map<vtkDataObject*, vtkDataObject*> restoredRepresentations;
+
+  // Compressed labelmaps are decompressed once, segments sharing them will share the decompressed labelmap.
+  // CopySegment uses the decompressed labelmaps as already copied representations.
+  std::vector<vtkSmartPointer<vtkDataObject> > decompressedRepresentations;
+  for (SegmentsMap::iterator restoredSegmentsIt = restoredState.Segments.begin();
+    restoredSegmentsIt != restoredState.Segments.end(); ++restoredSegmentsIt)
+    {
+    std::vector<std::string> representationNames;
+    restoredSegmentsIt->second->GetContainedRepresentationNames(representationNames);
+    for (std::string representationName : representationNames)
+      {
+      vtkDataObject* representation = restoredSegmentsIt->second->GetRepresentation(representationName);
+      if (restoredRepresentations.find(representation) != restoredRepresentations.end())
+        {
+        continue;
+        }
+      vtkSmartPointer<vtkOrientedImageData> decompressedLabelmap =
+        vtkSegmentationHistory::DecompressLabelmap(vtkOrientedImageData::SafeDownCast(representation));
+      if (decompressedLabelmap)
+        {
+        decompressedRepresentations.push_back(decompressedLabelmap);
+        restoredRepresentations[representation] = decompressedLabelmap;
+        }
+      }
+    }
+
   for (SegmentsMap::iterator restoredSegmentsIt = restoredState.Segments.begin();
     restoredSegmentsIt != restoredState.Segments.end(); ++restoredSegmentsIt)
     {
@@ -307,6 +366,14 @@ void vtkSegmentationHistory::RemoveAllObsoleteStates()
     this->LastRestoredState--;
     modified = true;
    }
+  // Only states older than the last restored state are removed to fit in the memory limit
+  while (this->MaximumMemorySize > 0 && this->SegmentationStates.size() > 1 && this->LastRestoredState > 0
+    && this->GetMemorySize() > this->MaximumMemorySize)
+    {
+    this->SegmentationStates.pop_front();
+    this->LastRestoredState--;
+    modified = true;
+    }
   if (modified)
     {
     this->Modified();
@@ -325,6 +392,180 @@ void vtkSegmentationHistory::SetMaximumNumberOfStates(unsigned int maximumNumber
   this->Modified();
 }
 
+//---------------------------------------------------------------------------
+void vtkSegmentationHistory::SetMaximumMemorySize(vtkTypeInt64 maximumMemorySize)
+{
+  if (maximumMemorySize == this->MaximumMemorySize)
+    {
+    return;
+    }
+  this->MaximumMemorySize = maximumMemorySize;
+  this->RemoveAllObsoleteStates();
+  this->Modified();
+}
+
+//---------------------------------------------------------------------------
+vtkTypeInt64 vtkSegmentationHistory::GetMemorySize()
+{
+  vtkTypeInt64 memorySize = 0;
+  std::set<vtkDataObject*> countedRepresentations;
+  for (int stateIndex = 0; stateIndex < static_cast<int>(this->SegmentationStates.size()); ++stateIndex)
+    {
+    memorySize += this->GetStateMemorySize(stateIndex, countedRepresentations);
+    }
+  return memorySize;
+}
+
+//---------------------------------------------------------------------------
+vtkTypeInt64 vtkSegmentationHistory::GetStateMemorySize(int stateIndex)
+{
+  if (stateIndex < 0 || stateIndex >= static_cast<int>(this->SegmentationStates.size()))
+    {
+    vtkErrorMacro("GetStateMemorySize: invalid state index " << stateIndex);
+    return 0;
+    }
+  std::set<vtkDataObject*> countedRepresentations;
+  if (stateIndex > 0)
+    {
+    this->GetStateMemorySize(stateIndex - 1, countedRepresentations);
+    }
+  return this->GetStateMemorySize(stateIndex, countedRepresentations);
+}
+
+//---------------------------------------------------------------------------
+vtkTypeInt64 vtkSegmentationHistory::GetStateMemorySize(int stateIndex, std::set<vtkDataObject*>& countedRepresentations)
+{
+  vtkTypeInt64 memorySize = 0;
+  SegmentationState& state = this->SegmentationStates[stateIndex];
+  for (SegmentsMap::iterator segmentIt = state.Segments.begin(); segmentIt != state.Segments.end(); ++segmentIt)
+    {
+    std::vector<std::string> representationNames;
+    segmentIt->second->GetContainedRepresentationNames(representationNames);
+    for (std::string representationName : representationNames)
+      {
+      vtkDataObject* representation = segmentIt->second->GetRepresentation(representationName);
+      if (!representation || !countedRepresentations.insert(representation).second)
+        {
+        continue;
+        }
+      // GetActualMemorySize() returns kibibytes
+      memorySize += static_cast<vtkTypeInt64>(representation->GetActualMemorySize()) * 1024;
+      }
+    }
+  return memorySize;
+}
+
+//---------------------------------------------------------------------------
+bool vtkSegmentationHistory::CompressLabelmap(vtkOrientedImageData* labelmap)
+{
+  if (!labelmap || labelmap->GetFieldData()->GetAbstractArray(RUN_LENGTHS_ARRAY_NAME))
+    {
+    // not a labelmap or already compressed
+    return false;
+    }
+  vtkDataArray* scalars = labelmap->GetPointData()->GetScalars();
+  if (!scalars || labelmap->GetPointData()->GetNumberOfArrays() != 1
+    || !scalars->HasStandardMemoryLayout() || scalars->GetNumberOfTuples() < 1)
+    {
+    return false;
+    }
+
+  vtkSmartPointer<vtkDataArray> runValues = vtkSmartPointer<vtkDataArray>::Take(scalars->NewInstance());
+  runValues->SetName(RUN_VALUES_ARRAY_NAME);
+  runValues->SetNumberOfComponents(scalars->GetNumberOfComponents());
+  vtkNew<vtkTypeUInt32Array> runLengths;
+  runLengths->SetName(RUN_LENGTHS_ARRAY_NAME);
+
+  const vtkIdType numberOfTuples = scalars->GetNumberOfTuples();
+  const int tupleSize = scalars->GetDataTypeSize() * scalars->GetNumberOfComponents();
+  const unsigned char* tuples = static_cast<const unsigned char*>(scalars->GetVoidPointer(0));
+  const vtkIdType maximumRunLength = VTK_TYPE_UINT32_MAX;
+  vtkIdType runStart = 0;
+  for (vtkIdType tupleIndex = 1; tupleIndex <= numberOfTuples; ++tupleIndex)
+    {
+    if (tupleIndex < numberOfTuples && tupleIndex - runStart < maximumRunLength
+      && memcmp(tuples + tupleIndex * tupleSize, tuples + runStart * tupleSize, tupleSize) == 0)
+      {
+      continue;
+      }
+    runValues->InsertNextTuple(runStart, scalars);
+    runLengths->InsertNextValue(static_cast<vtkTypeUInt32>(tupleIndex - runStart));
+    runStart = tupleIndex;
+    }
+
+  vtkIdType compressedSize = runValues->GetNumberOfTuples() * (tupleSize + sizeof(vtkTypeUInt32));
+  if (compressedSize >= numberOfTuples * tupleSize)
+    {
+    // compression would not save memory
+    return false;
+    }
+  runValues->Squeeze();
+  runLengths->Squeeze();
+  labelmap->GetFieldData()->AddArray(runValues);
+  labelmap->GetFieldData()->AddArray(runLengths);
+  labelmap->GetPointData()->SetScalars(nullptr);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+vtkSmartPointer<vtkOrientedImageData> vtkSegmentationHistory::DecompressLabelmap(vtkOrientedImageData* compressedLabelmap)
+{
+  if (!compressedLabelmap)
+    {
+    return nullptr;
+    }
+  vtkDataArray* runValues = compressedLabelmap->GetFieldData()->GetArray(RUN_VALUES_ARRAY_NAME);
+  vtkTypeUInt32Array* runLengths = vtkTypeUInt32Array::SafeDownCast(
+    compressedLabelmap->GetFieldData()->GetArray(RUN_LENGTHS_ARRAY_NAME));
+  if (!runValues || !runLengths)
+    {
+    return nullptr;
+    }
+
+  vtkSmartPointer<vtkOrientedImageData> labelmap = vtkSmartPointer<vtkOrientedImageData>::Take(
+    compressedLabelmap->NewInstance());
+  labelmap->SetExtent(compressedLabelmap->GetExtent());
+  labelmap->SetOrigin(compressedLabelmap->GetOrigin());
+  labelmap->SetSpacing(compressedLabelmap->GetSpacing());
+  labelmap->CopyDirections(compressedLabelmap);
+  labelmap->AllocateScalars(runValues->GetDataType(), runValues->GetNumberOfComponents());
+
+  vtkDataArray* scalars = labelmap->GetPointData()->GetScalars();
+  const int tupleSize = scalars->GetDataTypeSize() * scalars->GetNumberOfComponents();
+  const unsigned char* values = static_cast<const unsigned char*>(runValues->GetVoidPointer(0));
+  unsigned char* tuples = static_cast<unsigned char*>(scalars->GetVoidPointer(0));
+  unsigned char* tuplesEnd = tuples + scalars->GetNumberOfTuples() * tupleSize;
+  for (vtkIdType runIndex = 0; runIndex < runLengths->GetNumberOfTuples(); ++runIndex)
+    {
+    const unsigned char* value = values + runIndex * tupleSize;
+    unsigned char* runEnd = std::min(tuples + static_cast<vtkIdType>(runLengths->GetValue(runIndex)) * tupleSize, tuplesEnd);
+    if (tupleSize == 1)
+      {
+      memset(tuples, *value, runEnd - tuples);
+      tuples = runEnd;
+      continue;
+      }
+    for (; tuples < runEnd; tuples += tupleSize)
+      {
+      memcpy(tuples, value, tupleSize);
+      }
+    }
+
+  // Copy other field data arrays
+  for (int arrayIndex = 0; arrayIndex < compressedLabelmap->GetFieldData()->GetNumberOfArrays(); ++arrayIndex)
+    {
+    vtkAbstractArray* array = compressedLabelmap->GetFieldData()->GetAbstractArray(arrayIndex);
+    if (array == runValues || array == runLengths)
+      {
+      continue;
+      }
+    vtkSmartPointer<vtkAbstractArray> arrayCopy = vtkSmartPointer<vtkAbstractArray>::Take(array->NewInstance());
+    arrayCopy->DeepCopy(array);
+    labelmap->GetFieldData()->AddArray(arrayCopy);
+    }
+  return labelmap;
+}
+
 //---------------------------------------------------------------------------
 void vtkSegmentationHistory::OnSegmentationModified(vtkObject* vtkNotUsed(caller),
   unsigned long vtkNotUsed(eid),
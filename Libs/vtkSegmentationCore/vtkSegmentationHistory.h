@@ -28,12 +28,14 @@
 // STD includes
 #include <deque>
 #include <map>
+#include <set>
 #include <vector>
 
 #include "vtkSegmentationCoreConfigure.h"
 
 class vtkCallbackCommand;
 class vtkDataObject;
+class vtkOrientedImageData;
 class vtkSegment;
 class vtkSegmentation;
 
@@ -86,6 +88,27 @@ public:
   /// Get the current number of states.
   int GetNumberOfStates();
 
+  /// Limits how much memory the stored states may use, in bytes.
+  /// If the stored states use more memory than the limit then the oldest states are removed.
+  /// The most recent state is always kept. 0 means there is no limit (default).
+  /// \sa GetMemorySize()
+  void SetMaximumMemorySize(vtkTypeInt64 maximumMemorySize);
+  vtkGetMacro(MaximumMemorySize, vtkTypeInt64);
+
+  /// Memory used by the representations stored in all the states, in bytes.
+  /// Representations shared between states are only counted once.
+  vtkTypeInt64 GetMemorySize();
+
+  /// Memory used by the representations stored in the state, in bytes.
+  /// Representations shared with the previous state are not counted.
+  vtkTypeInt64 GetStateMemorySize(int stateIndex);
+
+  /// Compress the binary labelmaps of the saved states using run-length encoding.
+  /// States are decompressed when they are restored. Enabled by default.
+  vtkSetMacro(UseCompression, bool);
+  vtkGetMacro(UseCompression, bool);
+  vtkBooleanMacro(UseCompression, bool);
+
 protected:
   /// Callback function called when the segmentation has been modified.
   /// It clears all states that are more recent than the last restored state.
@@ -95,11 +118,24 @@ protected:
   void RemoveAllNextStates();
 
   /// Delete all old states so that we keep only up to MaximumNumberOfStates states
+  /// and the states fit in MaximumMemorySize
   void RemoveAllObsoleteStates();
 
   /// Restores a state defined by stateIndex.
   bool RestoreState(unsigned int stateIndex);
 
+  /// Memory used by the representations of the state that are not in countedRepresentations.
+  /// Representations are added to countedRepresentations.
+  vtkTypeInt64 GetStateMemorySize(int stateIndex, std::set<vtkDataObject*>& countedRepresentations);
+
+  /// Replace the scalars of a labelmap by their run-length encoding.
+  /// Labelmaps that are already compressed or would not be smaller are left as is.
+  static bool CompressLabelmap(vtkOrientedImageData* labelmap);
+
+  /// Create a copy of a labelmap compressed by CompressLabelmap() with decoded scalars.
+  /// Returns nullptr if the labelmap is not compressed.
+  static vtkSmartPointer<vtkOrientedImageData> DecompressLabelmap(vtkOrientedImageData* compressedLabelmap);
+
 protected:
   vtkSegmentationHistory();
   ~vtkSegmentationHistory() override;
@@ -116,6 +152,8 @@ protected:
   vtkCallbackCommand* SegmentationModifiedCallbackCommand;
   std::deque<SegmentationState> SegmentationStates;
   unsigned int MaximumNumberOfStates;
+  vtkTypeInt64 MaximumMemorySize;
+  bool UseCompression;
 
   // Index of the state in SegmentationStates that was restored last.
   // If index == size of states then it means that the segmentation has changed
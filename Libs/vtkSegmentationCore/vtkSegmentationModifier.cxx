@@ -19,6 +19,7 @@
 ==============================================================================*/
 
 // SegmentationCore includes
+#include "vtkBrickedLabelmap.h"
 #include "vtkOrientedImageData.h"
 #include "vtkOrientedImageDataResample.h"
 #include "vtkSegmentation.h"
@@ -26,8 +27,11 @@
 #include "vtkSegmentationModifier.h"
 
 // VTK includes
+#include <vtkDataArray.h>
 #include <vtkImageConstantPad.h>
 #include <vtkImageThreshold.h>
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
 #include <vtkObjectFactory.h>
 #include <vtkPointData.h>
 
@@ -59,6 +63,13 @@ bool vtkSegmentationModifier::ModifyBinaryLabelmap(
     return false;
     }
 
+  // Binary labelmap is derived from a bricked labelmap master, modifications must be stored in the master
+  if (segmentation->GetMasterRepresentationName() == vtkSegmentationConverter::GetSegmentationBrickedLabelmapRepresentationName())
+    {
+    return vtkSegmentationModifier::ModifyBrickedLabelmap(labelmap, segmentation, segmentID, mergeMode, extent,
+      masterRepresentationModifiedEnabled, modifiedSegmentIDs);
+    }
+
   // If there are segments on the same layer that we should not overwrite, determine if there are any under the modifier labelmap
   if (vtkSegmentationModifier::SharedLabelmapShouldOverlap(segmentation, segmentID, segmentIDsToOverwrite))
     {
@@ -112,6 +123,170 @@ bool vtkSegmentationModifier::ModifyBinaryLabelmap(
   return true;
 }
 
+//-----------------------------------------------------------------------------
+bool vtkSegmentationModifier::ModifyBrickedLabelmap(vtkOrientedImageData* labelmap, vtkSegmentation* segmentation, std::string segmentID,
+  int mergeMode, const int extent[6], bool masterRepresentationModifiedEnabled, std::vector<std::string>* modifiedSegmentIDs)
+{
+  if (modifiedSegmentIDs)
+    {
+    modifiedSegmentIDs->clear();
+    }
+
+  vtkSegment* selectedSegment = segmentation->GetSegment(segmentID);
+  if (!selectedSegment)
+    {
+    vtkGenericWarningMacro("vtkSegmentationModifier::ModifyBrickedLabelmap: Invalid selected segment");
+    return false;
+    }
+  vtkBrickedLabelmap* segmentLabelmap = vtkBrickedLabelmap::SafeDownCast(
+    selectedSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBrickedLabelmapRepresentationName()));
+  if (!segmentLabelmap)
+    {
+    vtkErrorWithObjectMacro(segmentation, "vtkSegmentationModifier::ModifyBrickedLabelmap: Failed to get bricked labelmap representation in "
+      << "segmentation");
+    return false;
+    }
+
+  if (mergeMode == MODE_MERGE_MIN && segmentLabelmap->IsEmpty())
+    {
+    // empty labelmap remains empty when combined with minimum operation
+    return true;
+    }
+
+  // Voxels under the modifier are set to the label value of the segment. When erasing, voxels outside
+  // of the modifier are set to the minimum of the labelmap and the maximum value of the scalar type.
+  int operation = vtkOrientedImageDataResample::OPERATION_MASKING;
+  double backgroundValue = 0.0;
+  vtkSmartPointer<vtkOrientedImageData> modifierLabelmap = labelmap;
+  if (mergeMode == MODE_MERGE_MIN)
+    {
+    operation = vtkOrientedImageDataResample::OPERATION_MINIMUM;
+    backgroundValue = vtkDataArray::GetDataTypeMax(segmentLabelmap->GetScalarType());
+    vtkNew<vtkImageThreshold> threshold;
+    threshold->SetInputData(labelmap);
+    threshold->ThresholdByLower(0);
+    threshold->SetInValue(0);
+    threshold->SetOutValue(backgroundValue);
+    threshold->SetOutputScalarType(segmentLabelmap->GetScalarType());
+    threshold->Update();
+    modifierLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    modifierLabelmap->ShallowCopy(threshold->GetOutput());
+    modifierLabelmap->CopyDirections(labelmap);
+    }
+
+  // Replaced segments take the geometry of the modifier, otherwise the modifier is resampled to the segment geometry
+  const int* modifierExtent = extent;
+  vtkNew<vtkMatrix4x4> segmentImageToWorldMatrix;
+  segmentLabelmap->GetImageToWorldMatrix(segmentImageToWorldMatrix.GetPointer());
+  vtkNew<vtkMatrix4x4> modifierImageToWorldMatrix;
+  modifierLabelmap->GetImageToWorldMatrix(modifierImageToWorldMatrix.GetPointer());
+  if (mergeMode != MODE_REPLACE && !segmentLabelmap->IsEmpty()
+    && !vtkOrientedImageDataResample::IsEqual(segmentImageToWorldMatrix.GetPointer(), modifierImageToWorldMatrix.GetPointer()))
+    {
+    vtkNew<vtkOrientedImageData> croppedModifierLabelmap;
+    vtkOrientedImageDataResample::CopyImage(modifierLabelmap, croppedModifierLabelmap.GetPointer(), extent);
+    vtkNew<vtkOrientedImageData> referenceGeometry;
+    referenceGeometry->SetImageToWorldMatrix(segmentImageToWorldMatrix.GetPointer());
+    modifierLabelmap = vtkSmartPointer<vtkOrientedImageData>::New();
+    if (!vtkOrientedImageDataResample::ResampleOrientedImageToReferenceOrientedImage(croppedModifierLabelmap.GetPointer(),
+      referenceGeometry.GetPointer(), modifierLabelmap, false /*interpolate*/, true /*pad*/, nullptr, backgroundValue))
+      {
+      vtkErrorWithObjectMacro(segmentation, "vtkSegmentationModifier::ModifyBrickedLabelmap: Failed to resample labelmap");
+      return false;
+      }
+    modifierExtent = nullptr;
+    }
+
+  bool wasMasterRepresentationModifiedEnabled = segmentation->SetMasterRepresentationModifiedEnabled(masterRepresentationModifiedEnabled);
+
+  bool segmentLabelmapModified = false;
+  if (mergeMode == MODE_REPLACE)
+    {
+    segmentLabelmap->Initialize();
+    segmentLabelmapModified = true;
+    }
+  // Only bricks of the appended region are modified
+  int modifiedExtent[6] = { 0, -1, 0, -1, 0, -1 };
+  modifierLabelmap->GetExtent(modifiedExtent);
+  if (modifierExtent)
+    {
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      modifiedExtent[axis * 2] = std::max(modifiedExtent[axis * 2], modifierExtent[axis * 2]);
+      modifiedExtent[axis * 2 + 1] = std::min(modifiedExtent[axis * 2 + 1], modifierExtent[axis * 2 + 1]);
+      }
+    }
+
+  bool segmentLabelmapMerged = false;
+  if (!vtkOrientedImageDataResample::MergeImage(segmentLabelmap, modifierLabelmap, operation, modifierExtent,
+    0, selectedSegment->GetLabelValue(), &segmentLabelmapMerged))
+    {
+    segmentation->SetMasterRepresentationModifiedEnabled(wasMasterRepresentationModifiedEnabled);
+    vtkErrorWithObjectMacro(segmentation, "vtkSegmentationModifier::ModifyBrickedLabelmap: Failed to merge labelmap");
+    return false;
+    }
+  segmentLabelmapModified = segmentLabelmapModified || segmentLabelmapMerged;
+
+  if (segmentLabelmapModified)
+    {
+    // Shrink the extent to only contain the effective data (extent of non-zero voxels)
+    int effectiveExtent[6] = { 0, -1, 0, -1, 0, -1 };
+    vtkOrientedImageDataResample::CalculateEffectiveExtent(segmentLabelmap, effectiveExtent);
+    segmentLabelmap->SetExtent(effectiveExtent);
+
+    // Binary labelmap used for display and by the editor effects is derived from the master
+    vtkOrientedImageData* binaryLabelmap = vtkOrientedImageData::SafeDownCast(
+      selectedSegment->GetRepresentation(vtkSegmentationConverter::GetSegmentationBinaryLabelmapRepresentationName()));
+    if (binaryLabelmap)
+      {
+      // If the extent is unchanged then voxels outside of the modified bricks are unchanged,
+      // therefore only the modified region is copied
+      vtkNew<vtkMatrix4x4> binaryImageToWorldMatrix;
+      binaryLabelmap->GetImageToWorldMatrix(binaryImageToWorldMatrix.GetPointer());
+      segmentLabelmap->GetImageToWorldMatrix(segmentImageToWorldMatrix.GetPointer());
+      int* binaryExtent = binaryLabelmap->GetExtent();
+      bool extentUnchanged = (mergeMode != MODE_REPLACE
+        && binaryLabelmap->GetPointData()->GetScalars() && binaryLabelmap->GetScalarType() == segmentLabelmap->GetScalarType()
+        && vtkOrientedImageDataResample::IsEqual(binaryImageToWorldMatrix.GetPointer(), segmentImageToWorldMatrix.GetPointer()));
+      for (int i = 0; i < 6; ++i)
+        {
+        extentUnchanged = extentUnchanged && (binaryExtent[i] == effectiveExtent[i]);
+        }
+      for (int axis = 0; axis < 3; ++axis)
+        {
+        modifiedExtent[axis * 2] = std::max(modifiedExtent[axis * 2], effectiveExtent[axis * 2]);
+        modifiedExtent[axis * 2 + 1] = std::min(modifiedExtent[axis * 2 + 1], effectiveExtent[axis * 2 + 1]);
+        }
+      if (!extentUnchanged)
+        {
+        segmentLabelmap->GetImage(binaryLabelmap);
+        }
+      else if (modifiedExtent[0] <= modifiedExtent[1] && modifiedExtent[2] <= modifiedExtent[3] && modifiedExtent[4] <= modifiedExtent[5])
+        {
+        vtkNew<vtkOrientedImageData> modifiedRegion;
+        segmentLabelmap->GetImage(modifiedRegion.GetPointer(), modifiedExtent);
+        binaryLabelmap->CopyAndCastFrom(modifiedRegion.GetPointer(), modifiedExtent);
+        binaryLabelmap->GetPointData()->GetScalars()->Modified();
+        binaryLabelmap->Modified();
+        }
+      }
+    }
+
+  // Re-enable master representation modified event
+  segmentation->SetMasterRepresentationModifiedEnabled(wasMasterRepresentationModifiedEnabled);
+  if (segmentLabelmapModified)
+    {
+    if (modifiedSegmentIDs)
+      {
+      modifiedSegmentIDs->push_back(segmentID);
+      }
+    const char* segmentIdChar = segmentID.c_str();
+    segmentation->InvokeEvent(vtkSegmentation::MasterRepresentationModified, (void*)segmentIdChar);
+    segmentation->InvokeEvent(vtkSegmentation::RepresentationModified, (void*)segmentIdChar);
+    }
+  return true;
+}
+
 //-----------------------------------------------------------------------------
 bool vtkSegmentationModifier::GetSharedSegmentIDsInMask(
   vtkSegmentation* segmentation, std::string sharedSegmentID, vtkOrientedImageData* maskLabelmap, const int extent[6],
@@ -43,7 +43,8 @@ public:
 
 public:
   /// Set a labelmap image as binary labelmap representation into the segment defined by the segmentation node and segment ID.
-  /// Master representation must be binary labelmap! Master representation changed event is disabled to prevent deletion of all
+  /// Master representation must be binary labelmap or bricked labelmap! For a bricked labelmap master, the bricked labelmap
+  /// is modified and the binary labelmap of the segment is updated from it. Master representation changed event is disabled to prevent deletion of all
   /// other representation in all segments. The other representations in the given segment are re-converted. The extent of the
   /// segment binary labelmap is shrunk to the effective extent. Display update is triggered.
   /// \param mergeMode Determines if the labelmap should replace the segment, combined with a maximum or minimum operation, or set under the mask.
@@ -69,6 +70,10 @@ public:
     std::vector<std::string>& segmentIDs, int maskThreshold = 0.0, bool includeInputSharedSegmentID = false);
 
 protected:
+  /// Modify the bricked labelmap master representation of a segment. Only the bricks of the modified region are processed.
+  static bool ModifyBrickedLabelmap(vtkOrientedImageData* labelmap, vtkSegmentation* segmentation, std::string segmentID,
+    int mergeMode, const int extent[6], bool masterRepresentationModifiedEnabled, std::vector<std::string>* modifiedSegmentIDs);
+
   static bool AppendLabelmapToSegment(vtkOrientedImageData* labelmap, vtkSegmentation* segmentation, std::string segmentID, int mergeMode, const int extent[6],
     bool minimumOfAllSegments, std::vector<std::string>* modifiedSegmentIDs, bool& segmentLabelmapModified);
 
@@ -0,0 +1,195 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// vtkTeem includes
+#include <vtkTeemNRRDReader.h>
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+
+// STD includes
+#include <iostream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+short GetExpectedValue(int i, int j, int k, int c)
+{
+  return static_cast<short>(i + 10 * j + 100 * k + 1000 * c);
+}
+
+//----------------------------------------------------------------------------
+void WriteTestImage(const std::string& fileName, bool compressed)
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(7, 5, 6);
+  image->AllocateScalars(VTK_SHORT, 2);
+  for (int k = 0; k < 6; ++k)
+    {
+    for (int j = 0; j < 5; ++j)
+      {
+      for (int i = 0; i < 7; ++i)
+        {
+        for (int c = 0; c < 2; ++c)
+          {
+          image->SetScalarComponentFromDouble(i, j, k, c, GetExpectedValue(i, j, k, c));
+          }
+        }
+      }
+    }
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(image.GetPointer());
+  writer->SetUseCompression(compressed ? 1 : 0);
+  writer->Write();
+}
+
+//----------------------------------------------------------------------------
+bool CheckImage(vtkImageData* image, const int expectedExtent[6], const std::string& testName)
+{
+  int* extent = image->GetExtent();
+  for (int i = 0; i < 6; ++i)
+    {
+    if (extent[i] != expectedExtent[i])
+      {
+      std::cerr << testName << ": extent mismatch" << std::endl;
+      return false;
+      }
+    }
+  if (!image->GetPointData()->GetScalars() || image->GetNumberOfScalarComponents() != 2)
+    {
+    std::cerr << testName << ": invalid scalars" << std::endl;
+    return false;
+    }
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      for (int i = extent[0]; i <= extent[1]; ++i)
+        {
+        for (int c = 0; c < 2; ++c)
+          {
+          if (static_cast<short>(image->GetScalarComponentAsDouble(i, j, k, c)) != GetExpectedValue(i, j, k, c))
+            {
+            std::cerr << testName << ": voxel value mismatch at (" << i << ", " << j << ", " << k << ")" << std::endl;
+            return false;
+            }
+          }
+        }
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestRead(const std::string& fileName, bool compressed, bool useMemoryMapping)
+{
+  std::string testName = fileName + (useMemoryMapping ? " (memory mapped)" : "");
+  WriteTestImage(fileName, compressed);
+  const int wholeExtent[6] = { 0, 6, 0, 4, 0, 5 };
+
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetUseMemoryMapping(useMemoryMapping);
+  reader->Update();
+  if (!CheckImage(reader->GetOutput(), wholeExtent, testName + " whole extent"))
+    {
+    return false;
+    }
+
+  // Raw voxels are read only for the requested extent, compressed voxels for the whole extent
+  bool readsWholeExtent = compressed && nrrdEncodingGzip->available();
+  int subExtents[3][6] =
+    {
+    { 0, 6, 0, 4, 2, 3 }, // full slices
+    { 0, 6, 1, 2, 1, 4 }, // full rows
+    { 2, 5, 1, 3, 0, 2 }  // partial rows
+    };
+  for (int subExtentIndex = 0; subExtentIndex < 3; ++subExtentIndex)
+    {
+    vtkNew<vtkTeemNRRDReader> subExtentReader;
+    subExtentReader->SetFileName(fileName.c_str());
+    subExtentReader->UpdateExtent(subExtents[subExtentIndex]);
+    if (!CheckImage(subExtentReader->GetOutput(), readsWholeExtent ? wholeExtent : subExtents[subExtentIndex],
+      testName + " sub-extent"))
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool TestFileChangedAfterHeaderRead(const std::string& fileName)
+{
+  WriteTestImage(fileName, true);
+  vtkNew<vtkTeemNRRDReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->UpdateInformation();
+
+  // File is replaced by a larger image after the header is read
+  vtkNew<vtkImageData> largerImage;
+  largerImage->SetDimensions(20, 20, 20);
+  largerImage->AllocateScalars(VTK_SHORT, 2);
+  largerImage->GetPointData()->GetScalars()->Fill(0);
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputData(largerImage.GetPointer());
+  writer->SetUseCompression(1);
+  writer->Write();
+
+  // Voxels that do not match the header are not written into the output
+  std::cout << "Expected error: voxel size mismatch" << std::endl;
+  reader->Update();
+  vtkImageData* image = reader->GetOutput();
+  if (!image->GetPointData()->GetScalars()
+    || image->GetPointData()->GetScalars()->GetNumberOfTuples() != 7 * 5 * 6)
+    {
+    std::cerr << fileName << ": output array size mismatch" << std::endl;
+    return false;
+    }
+  return true;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkTeemNRRDReaderTest1(int argc, char* argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+  if (!TestRead(tempDir + "/vtkTeemNRRDReaderTest1_raw.nrrd", false, false)
+    || !TestRead(tempDir + "/vtkTeemNRRDReaderTest1_raw.nhdr", false, false)
+    || !TestRead(tempDir + "/vtkTeemNRRDReaderTest1_gzip.nrrd", true, false)
+    || !TestFileChangedAfterHeaderRead(tempDir + "/vtkTeemNRRDReaderTest1_changed.nrrd"))
+    {
+    return EXIT_FAILURE;
+    }
+#ifndef _WIN32
+  if (!TestRead(tempDir + "/vtkTeemNRRDReaderTest1_mapped.nrrd", false, true))
+    {
+    return EXIT_FAILURE;
+    }
+#endif
+  return EXIT_SUCCESS;
+}
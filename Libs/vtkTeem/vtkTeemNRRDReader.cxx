@@ -31,6 +31,7 @@
 // VTK includes
 #include "vtkBitArray.h"
 #include "vtkCharArray.h"
+#include "vtkDataArray.h"
 #include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkImageData.h"
@@ -52,6 +53,80 @@
 // Teem includes
 #include "teem/ten.h"
 
+// STD includes
+#include <fstream>
+#include <mutex>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+namespace
+{
+
+#ifndef _WIN32
+//----------------------------------------------------------------------------
+/// Memory mappings of voxel arrays, by the first voxel address.
+/// VTK only provides the voxel pointer when the array is released.
+struct MappedRegion
+{
+  void* Address;
+  size_t Length;
+};
+std::mutex MappedRegionsMutex;
+std::map<void*, MappedRegion> MappedRegions;
+
+//----------------------------------------------------------------------------
+void UnmapVoxels(void* voxels)
+{
+  MappedRegion region = { nullptr, 0 };
+  {
+    std::lock_guard<std::mutex> lock(MappedRegionsMutex);
+    std::map<void*, MappedRegion>::iterator regionIt = MappedRegions.find(voxels);
+    if (regionIt == MappedRegions.end())
+      {
+      return;
+      }
+    region = regionIt->second;
+    MappedRegions.erase(regionIt);
+  }
+  munmap(region.Address, region.Length);
+}
+#endif
+
+//----------------------------------------------------------------------------
+/// Return the position after the blank line that terminates the header of a NRRD file, or -1 if not found.
+vtkTypeInt64 GetAttachedDataOffset(const std::string& fileName)
+{
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    {
+    return -1;
+    }
+  std::string header;
+  char buffer[4096];
+  while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+    {
+    size_t searchStart = header.size() > 3 ? header.size() - 3 : 0;
+    header.append(buffer, static_cast<size_t>(file.gcount()));
+    size_t lfPosition = header.find("\n\n", searchStart);
+    size_t crlfPosition = header.find("\r\n\r\n", searchStart);
+    if (crlfPosition != std::string::npos && (lfPosition == std::string::npos || crlfPosition < lfPosition))
+      {
+      return static_cast<vtkTypeInt64>(crlfPosition + 4);
+      }
+    if (lfPosition != std::string::npos)
+      {
+      return static_cast<vtkTypeInt64>(lfPosition + 2);
+      }
+    }
+  return -1;
+}
+
+} // end of anonymous namespace
+
 vtkStandardNewMacro(vtkTeemNRRDReader);
 
 //----------------------------------------------------------------------------
@@ -66,6 +141,9 @@ vtkTeemNRRDReader::vtkTeemNRRDReader()
   this->PointDataType = -1;
   this->DataType = -1;
   this->NumberOfComponents = -1;
+  this->RawDataOffset = -1;
+  this->RawDataComponentsOutermost = false;
+  this->UseMemoryMapping = false;
 }
 
 //----------------------------------------------------------------------------
@@ -349,6 +427,9 @@ void vtkTeemNRRDReader::ExecuteInformation()
     return;
     }
   this->CurrentFileName = this->GetFileName();
+  this->RawDataFileName.clear();
+  this->RawDataOffset = -1;
+  this->RawDataComponentsOutermost = false;
 
   nrrdNuke(this->nrrd); // nuke and reallocate to reset the state
   this->nrrd = nrrdNew();
@@ -664,10 +745,91 @@ void vtkTeemNRRDReader::ExecuteInformation()
       }
     }
 
+  this->UpdateRawDataLocation(nio);
+
   this->vtkImageReader2::ExecuteInformation();
   nio = nrrdIoStateNix(nio);
 }
 
+//----------------------------------------------------------------------------
+void vtkTeemNRRDReader::UpdateRawDataLocation(NrrdIoState* nio)
+{
+  this->RawDataFileName.clear();
+  this->RawDataOffset = -1;
+  this->RawDataComponentsOutermost = false;
+
+  // Only raw voxels that are stored in the same layout and byte order as in memory can be read directly
+  if (nio->format != nrrdFormatNRRD || nio->encoding != nrrdEncodingRaw || nio->lineSkip != 0)
+    {
+    return;
+    }
+  if (nrrdElementSize(this->nrrd) > 1 && nio->endian != airMyEndian())
+    {
+    return;
+    }
+  unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
+  unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
+  if (rangeAxisNum > 1)
+    {
+    return;
+    }
+  // Components stored one after the other can still be located in the file,
+  // but they have to be interleaved (axes permuted) to be read into VTK order
+  bool componentsOutermost = (rangeAxisNum == 1 && rangeAxisIdx[0] != 0);
+  if (componentsOutermost && rangeAxisIdx[0] != this->nrrd->dim - 1)
+    {
+    return;
+    }
+  if (nrrdKind3DMaskedSymMatrix == this->nrrd->axis[0].kind
+    || nrrdKind3DSymMatrix == this->nrrd->axis[0].kind)
+    {
+    // tensors have to be converted
+    return;
+    }
+
+  std::string dataFileName;
+  vtkTypeInt64 dataOffset = 0;
+  if (nio->dataFNFormat == nullptr && nio->dataFNArr->len == 0)
+    {
+    // voxels are stored after the header
+    dataFileName = this->GetFileName();
+    dataOffset = GetAttachedDataOffset(dataFileName);
+    }
+  else if (nio->dataFNFormat == nullptr && nio->dataFNArr->len == 1)
+    {
+    // voxels are stored in a single detached data file
+    dataFileName = vtksys::SystemTools::CollapseFullPath(nio->dataFN[0],
+      vtksys::SystemTools::GetFilenamePath(this->GetFileName()));
+    }
+  else
+    {
+    return;
+    }
+  if (dataOffset < 0)
+    {
+    return;
+    }
+
+  vtkTypeInt64 dataSize = static_cast<vtkTypeInt64>(nrrdElementNumber(this->nrrd) * nrrdElementSize(this->nrrd));
+  vtkTypeInt64 fileSize = static_cast<vtkTypeInt64>(vtksys::SystemTools::FileLength(dataFileName));
+  if (nio->byteSkip == -1)
+    {
+    // voxels are at the end of the file
+    dataOffset = fileSize - dataSize;
+    }
+  else if (nio->byteSkip > 0)
+    {
+    dataOffset += nio->byteSkip;
+    }
+  if (dataOffset < 0 || dataOffset + dataSize > fileSize)
+    {
+    return;
+    }
+  this->RawDataFileName = dataFileName;
+  this->RawDataOffset = dataOffset;
+  this->RawDataComponentsOutermost = componentsOutermost;
+}
+
 //----------------------------------------------------------------------------
 vtkImageData *vtkTeemNRRDReader::AllocateOutputData(vtkDataObject *out, vtkInformation* outInfo)
 {
@@ -897,7 +1059,9 @@ int vtkTeemNRRDReader::tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, doub
 // are assumed to be the same as the file extent/order.
 void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInformation* outInfo)
 {
-  if (this->GetOutputInformation(0))
+  // Raw voxels can be read for any extent, other encodings are decoded for the whole extent
+  bool readRawData = !this->RawDataFileName.empty() && !this->RawDataComponentsOutermost;
+  if (this->GetOutputInformation(0) && !readRawData)
     {
     this->GetOutputInformation(0)->Set(
       vtkStreamingDemandDrivenPipeline::UPDATE_EXTENT(),
@@ -913,6 +1077,54 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
     return;
     }
 
+  vtkDataArray* voxels = nullptr;
+  switch(this->PointDataType)
+    {
+    case vtkDataSetAttributes::SCALARS:
+      voxels = imageData->GetPointData()->GetScalars();
+      break;
+    case vtkDataSetAttributes::VECTORS:
+      voxels = imageData->GetPointData()->GetVectors();
+      break;
+    case vtkDataSetAttributes::NORMALS:
+      voxels = imageData->GetPointData()->GetNormals();
+      break;
+    case vtkDataSetAttributes::TENSORS:
+      voxels = imageData->GetPointData()->GetTensors();
+      break;
+    }
+  if (voxels)
+    {
+    voxels->SetName("NRRDImage");
+    }
+  this->ComputeDataIncrements();
+
+  if (voxels && readRawData)
+    {
+    // Raw voxels are read without parsing the header again and without an intermediate buffer
+    int* extent = imageData->GetExtent();
+    bool wholeExtent = (extent[0] == this->DataExtent[0] && extent[1] == this->DataExtent[1]
+      && extent[2] == this->DataExtent[2] && extent[3] == this->DataExtent[3]
+      && extent[4] == this->DataExtent[4] && extent[5] == this->DataExtent[5]);
+    if (wholeExtent && this->UseMemoryMapping && this->MapRawData(voxels))
+      {
+      return;
+      }
+    if (this->ReadRawData(voxels, extent))
+      {
+      return;
+      }
+    vtkErrorMacro("Read: Error reading voxels from " << this->RawDataFileName);
+    return;
+    }
+
+  void *ptr = (voxels ? voxels->GetVoidPointer(0) : nullptr);
+  size_t outputDataSize = (voxels ? static_cast<size_t>(voxels->GetDataSize()) * voxels->GetDataTypeSize() : 0);
+
+  // Teem frees the existing data buffer of the nrrd if its size does not match the file,
+  // therefore the buffer of the output array is never passed to teem.
+  nrrdEmpty(this->nrrd);
+
   // Read in the this->nrrd.  Yes, this means that the header is being read
   // twice: once by ExecuteInformation, and once here
   if ( nrrdLoad(this->nrrd, this->GetFileName(), nullptr) != 0 )
@@ -928,30 +1140,6 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
     return;
     }
 
-  void *ptr = nullptr;
-  switch(this->PointDataType)
-    {
-    case vtkDataSetAttributes::SCALARS:
-      imageData->GetPointData()->GetScalars()->SetName("NRRDImage");
-      //get pointer
-      ptr = imageData->GetPointData()->GetScalars()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::VECTORS:
-      imageData->GetPointData()->GetVectors()->SetName("NRRDImage");
-      //get pointer
-      ptr = imageData->GetPointData()->GetVectors()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::NORMALS:
-      imageData->GetPointData()->GetNormals()->SetName("NRRDImage");
-      ptr = imageData->GetPointData()->GetNormals()->GetVoidPointer(0);
-      break;
-    case vtkDataSetAttributes::TENSORS:
-      imageData->GetPointData()->GetTensors()->SetName("NRRDImage");
-      ptr = imageData->GetPointData()->GetTensors()->GetVoidPointer(0);
-      break;
-    }
-  this->ComputeDataIncrements();
-
   unsigned int rangeAxisIdx[NRRD_DIM_MAX] = { 0 };
   unsigned int rangeAxisNum = nrrdRangeAxesGet(this->nrrd, rangeAxisIdx);
   if (rangeAxisNum > 1)
@@ -1089,9 +1277,21 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
     // be called here if it existed.
     }
 
+  size_t decodedDataSize = nrrdElementSize(this->nrrd) * nrrdElementNumber(this->nrrd);
+  if (ptr && decodedDataSize != outputDataSize)
+    {
+    // the file has changed since its header was read
+    vtkErrorMacro("Read: Size of the voxels in " << this->GetFileName() << " (" << decodedDataSize
+      << " bytes) does not match the image information (" << outputDataSize << " bytes)");
+    nrrdEmpty(this->nrrd);
+    return;
+    }
   if (ptr)
     {
-    memcpy(ptr, this->nrrd->data, nrrdElementSize(this->nrrd)*nrrdElementNumber(this->nrrd));
+    // The decoded voxels are used by the output array without copying them.
+    // Teem allocates the buffer by malloc, it is released by free.
+    voxels->SetVoidArray(this->nrrd->data, voxels->GetDataSize(), 0, vtkAbstractArray::VTK_DATA_ARRAY_FREE);
+    this->nrrd->data = nullptr;
     }
 
   // release the memory while keeping the struct
@@ -1102,4 +1302,107 @@ void vtkTeemNRRDReader::ExecuteDataWithInformation(vtkDataObject *output, vtkInf
 void vtkTeemNRRDReader::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+  os << indent << "UseMemoryMapping: " << (this->UseMemoryMapping ? "true" : "false") << "\n";
+  os << indent << "RawDataFileName: " << this->RawDataFileName << "\n";
+  os << indent << "RawDataOffset: " << this->RawDataOffset << "\n";
+  os << indent << "RawDataComponentsOutermost: " << (this->RawDataComponentsOutermost ? "true" : "false") << "\n";
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::ReadRawData(vtkDataArray* voxels, int extent[6])
+{
+  std::ifstream dataFile(this->RawDataFileName.c_str(), std::ios::in | std::ios::binary);
+  if (!dataFile)
+    {
+    return false;
+    }
+  vtkTypeInt64 voxelSize = static_cast<vtkTypeInt64>(voxels->GetDataTypeSize()) * voxels->GetNumberOfComponents();
+  vtkTypeInt64 wholeDimensions[3] =
+    {
+    this->DataExtent[1] - this->DataExtent[0] + 1,
+    this->DataExtent[3] - this->DataExtent[2] + 1,
+    this->DataExtent[5] - this->DataExtent[4] + 1
+    };
+  vtkTypeInt64 rowSize = (extent[1] - extent[0] + 1) * voxelSize;
+  vtkTypeInt64 numberOfRows = extent[3] - extent[2] + 1;
+  bool fullRows = (extent[0] == this->DataExtent[0] && extent[1] == this->DataExtent[1]);
+  bool fullSlices = fullRows && (extent[2] == this->DataExtent[2] && extent[3] == this->DataExtent[3]);
+
+  char* outputPtr = static_cast<char*>(voxels->GetVoidPointer(0));
+  for (int k = extent[4]; k <= extent[5]; ++k)
+    {
+    // Contiguous voxels are read at once: all requested slices, all rows of a slice, or one row
+    vtkTypeInt64 sliceOffset = (k - this->DataExtent[4]) * wholeDimensions[1];
+    for (int j = extent[2]; j <= extent[3]; ++j)
+      {
+      vtkTypeInt64 voxelOffset = ((sliceOffset + j - this->DataExtent[2]) * wholeDimensions[0]) + extent[0] - this->DataExtent[0];
+      vtkTypeInt64 readSize = rowSize;
+      if (fullSlices)
+        {
+        readSize = rowSize * numberOfRows * (extent[5] - extent[4] + 1);
+        }
+      else if (fullRows)
+        {
+        readSize = rowSize * numberOfRows;
+        }
+      dataFile.seekg(this->RawDataOffset + voxelOffset * voxelSize, std::ios::beg);
+      dataFile.read(outputPtr, readSize);
+      if (dataFile.gcount() != readSize)
+        {
+        return false;
+        }
+      outputPtr += readSize;
+      if (fullRows)
+        {
+        break;
+        }
+      }
+    if (fullSlices)
+      {
+      break;
+      }
+    }
+  voxels->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool vtkTeemNRRDReader::MapRawData(vtkDataArray* voxels)
+{
+#ifdef _WIN32
+  vtkWarningMacro("MapRawData: memory mapping is not supported on this platform");
+  (void)voxels;
+  return false;
+#else
+  vtkTypeInt64 dataSize = static_cast<vtkTypeInt64>(voxels->GetDataSize()) * voxels->GetDataTypeSize();
+  if (dataSize <= 0)
+    {
+    return false;
+    }
+  int fd = open(this->RawDataFileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    {
+    return false;
+    }
+  // Mapping has to start at a page boundary
+  vtkTypeInt64 pageSize = static_cast<vtkTypeInt64>(sysconf(_SC_PAGESIZE));
+  vtkTypeInt64 mappingOffset = (this->RawDataOffset / pageSize) * pageSize;
+  size_t mappingLength = static_cast<size_t>(this->RawDataOffset - mappingOffset + dataSize);
+  // Private mapping: modifications of the voxels are not written to the file
+  void* mapping = mmap(nullptr, mappingLength, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, static_cast<off_t>(mappingOffset));
+  close(fd);
+  if (mapping == MAP_FAILED)
+    {
+    return false;
+    }
+  void* mappedVoxels = static_cast<char*>(mapping) + (this->RawDataOffset - mappingOffset);
+  {
+    std::lock_guard<std::mutex> lock(MappedRegionsMutex);
+    MappedRegion region = { mapping, mappingLength };
+    MappedRegions[mappedVoxels] = region;
+  }
+  voxels->SetVoidArray(mappedVoxels, voxels->GetDataSize(), 0, vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  voxels->SetArrayFreeFunction(UnmapVoxels);
+  return true;
+#endif
 }
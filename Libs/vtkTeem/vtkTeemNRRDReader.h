@@ -133,6 +133,33 @@ public:
   vtkGetMacro(NumberOfComponents,int);
 
 
+  ///
+  /// Memory-map raw (uncompressed) voxel data instead of reading it into a new buffer.
+  /// Mapping is only used when the whole image is requested and the voxels can be used
+  /// as they are stored in the file (machine byte order, no axis permutation or tensor
+  /// conversion). Voxels are loaded from the file when they are first accessed, therefore
+  /// the file must not be overwritten while the image is in use. Not available on Windows.
+  /// Disabled by default.
+  vtkSetMacro(UseMemoryMapping, bool);
+  vtkGetMacro(UseMemoryMapping, bool);
+  vtkBooleanMacro(UseMemoryMapping, bool);
+
+  ///
+  /// Name of the file that stores the voxels in raw encoding, in the order that VTK uses
+  /// or with the components stored one after the other (see GetRawDataComponentsOutermost()).
+  /// Empty if the voxels have to be decoded by teem. Available after UpdateInformation().
+  std::string GetRawDataFileName() { return this->RawDataFileName; }
+
+  ///
+  /// Position of the first voxel in the raw data file, -1 if not available.
+  vtkGetMacro(RawDataOffset, vtkTypeInt64);
+
+  ///
+  /// True if the non-spatial axis is the slowest axis in the raw data file, therefore
+  /// all voxels of a component are stored contiguously. The reader still decodes
+  /// these files with teem, as the components have to be interleaved.
+  vtkGetMacro(RawDataComponentsOutermost, bool);
+
   ///
   /// Use image origin from the file
   void SetUseNativeOriginOn()
@@ -268,6 +295,25 @@ protected:
 
   int tenSpaceDirectionReduce(Nrrd *nout, const Nrrd *nin, double SD[9]);
 
+  /// Determine if the voxels can be read from the file without decoding by teem.
+  /// Sets RawDataFileName, RawDataOffset and RawDataComponentsOutermost.
+  void UpdateRawDataLocation(NrrdIoState* nio);
+
+  /// Read the voxels of the extent directly from RawDataFileName into the output array
+  bool ReadRawData(vtkDataArray* voxels, int extent[6]);
+
+  /// Use the memory-mapped voxels of RawDataFileName as output array
+  bool MapRawData(vtkDataArray* voxels);
+
+  /// Name of the file that stores the voxels in raw encoding.
+  /// Empty if the voxels have to be decoded by teem.
+  std::string RawDataFileName;
+  /// Position of the first voxel in RawDataFileName
+  vtkTypeInt64 RawDataOffset;
+  /// Components are stored one after the other in RawDataFileName instead of interleaved
+  bool RawDataComponentsOutermost;
+  bool UseMemoryMapping;
+
 private:
   vtkTeemNRRDReader(const vtkTeemNRRDReader&) = delete;
   void operator=(const vtkTeemNRRDReader&) = delete;
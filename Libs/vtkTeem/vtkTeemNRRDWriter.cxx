@@ -38,6 +38,7 @@ vtkTeemNRRDWriter::vtkTeemNRRDWriter()
   this->AxisLabels = new AxisInfoMapType;
   this->AxisUnits = new AxisInfoMapType;
   this->VectorAxisKind = nrrdKindUnknown;
+  this->VectorAxisOutermost = false;
   this->Space = nrrdSpaceRightAnteriorSuperior;
 }
 
@@ -285,6 +286,26 @@ void* vtkTeemNRRDWriter::MakeNRRD()
   nrrdAxisInfoSet_nva(nrrd, nrrdAxisInfoSpaceDirection, spaceDir);
   nrrd->space = this->Space;
 
+  if (this->VectorAxisOutermost && baseDim == 1)
+    {
+    // Move the range axis from the fastest to the slowest axis.
+    // The voxels are copied, the input voxels are only wrapped.
+    Nrrd *nperm = nrrdNew();
+    unsigned int axmap[NRRD_DIM_MAX] = { 1, 2, 3, 0 };
+    if (nrrdAxesPermute(nperm, nrrd, axmap))
+      {
+      char *err = biffGetDone(NRRD); // would be nice to free(err)
+      vtkErrorMacro("Write: Error permuting range axis for "
+                        << this->GetFileName() << ":\n" << err);
+      nrrdNuke(nperm);
+      nrrd = nrrdNix(nrrd);
+      this->WriteErrorOn();
+      return nullptr;
+      }
+    nrrd = nrrdNix(nrrd);
+    nrrd = nperm;
+    }
+
   if (!this->AxisLabels->empty())
     {
     const char* labels[NRRD_DIM_MAX] = { nullptr };
@@ -445,8 +466,16 @@ void vtkTeemNRRDWriter::WriteData()
                       << this->GetFileName() << ":\n" << err);
     this->WriteErrorOn();
     }
-  // Free the nrrd struct but don't touch nrrd->data
-  nrrd = nrrdNix(nrrd);
+  if (this->VectorAxisOutermost && nrrd->dim == 4)
+    {
+    // the voxels were copied when the axes were permuted
+    nrrd = nrrdNuke(nrrd);
+    }
+  else
+    {
+    // Free the nrrd struct but don't touch nrrd->data
+    nrrd = nrrdNix(nrrd);
+    }
   nio = nrrdIoStateNix(nio);
   return;
 }
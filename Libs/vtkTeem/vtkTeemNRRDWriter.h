@@ -82,6 +82,14 @@ public:
   /// from the number of components and scalar type.
   void SetVectorAxisKind(int kind);
 
+  /// Write the non-spatial axis as the last (slowest) axis instead of the first one,
+  /// so that the components are stored one after the other instead of interleaved.
+  /// Axis indices of SetAxisLabel() and SetAxisUnit() refer to the axes in the file.
+  /// Disabled by default.
+  vtkSetMacro(VectorAxisOutermost, bool);
+  vtkGetMacro(VectorAxisOutermost, bool);
+  vtkBooleanMacro(VectorAxisOutermost, bool);
+
   /// Method to set the coordinate system written to the NRRD file.
   /// Currently the only valid coordinate systems are: RAS, RAST, LPS, and LPST.
   vtkSetMacro(Space, int);
@@ -96,6 +104,8 @@ public:
   void vtkSetSpaceToLPST() { this->SetSpace(nrrdSpaceLeftPosteriorSuperiorTime); };
 
   /// Utility function to return image as a Nrrd*
+  /// The nrrd wraps the input voxels, unless VectorAxisOutermost is enabled
+  /// for an image with multiple components: then it owns a copy of the voxels.
   void* MakeNRRD();
 
 protected:
@@ -128,6 +138,7 @@ protected:
   AxisInfoMapType *AxisLabels;
   AxisInfoMapType *AxisUnits;
   int VectorAxisKind;
+  bool VectorAxisOutermost;
   int Space;
 
 private:
@@ -31,6 +31,9 @@ Version:   $Revision$
 
 // VTK includes
 #include <vtkVersion.h> // must precede reference to VTK_MAJOR_VERSION
+#include <vtkAlgorithm.h>
+#include <vtkAlgorithmOutput.h>
+#include <vtkCommand.h>
 #include <vtkDebugLeaks.h>
 #include <vtkDecimatePro.h>
 #if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
@@ -49,6 +52,7 @@ Version:   $Revision$
 #include <vtkImageToStructuredPoints.h>
 #include <vtkInformation.h>
 #include <vtkLookupTable.h>
+#include <vtkMatrix4x4.h>
 #include <vtkNew.h>
 #include <vtkPointData.h>
 #include <vtkPolyDataNormals.h>
@@ -67,6 +71,437 @@ Version:   $Revision$
 // VTKsys includes
 #include <vtksys/SystemTools.hxx>
 
+// STD includes
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Add a model node that reads the model from fileName, with a storage and display node,
+// under the model hierarchy (or under the matching node of the color hierarchy)
+void AddModelToScene(vtkMRMLScene* modelScene, const std::string& labelName, const std::string& fileName, int label,
+                     vtkMRMLColorTableNode* colorNode, vtkMRMLModelHierarchyNode* topColorHierarchyNode,
+                     vtkMRMLNode* rnd, bool debug)
+{
+  if (debug)
+    {
+    std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
+              << endl;
+    }
+  // each model needs a mrml node, a storage node and a display node
+  vtkNew<vtkMRMLModelNode> mnode;
+  mnode->SetScene(modelScene);
+  mnode->SetName(labelName.c_str());
+
+  vtkNew<vtkMRMLModelStorageNode> snode;
+  snode->SetFileName(fileName.c_str());
+  if (modelScene->AddNode(snode.GetPointer()) == nullptr)
+    {
+    std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
+    }
+  vtkNew<vtkMRMLModelDisplayNode> dnode;
+  dnode->SetColor(0.5, 0.5, 0.5);
+  double *rgba;
+  if (colorNode != nullptr)
+    {
+    rgba = colorNode->GetLookupTable()->GetTableValue(label);
+    if (rgba != nullptr)
+      {
+      if (debug)
+        {
+        std::cout << "Got colour: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
+        }
+      dnode->SetColor(rgba[0], rgba[1], rgba[2]);
+      }
+    else
+      {
+      std::cerr << "Couldn't get look up table value for " << label << ", display node colour is not set (grey)"
+                << endl;
+      }
+    }
+
+  dnode->SetVisibility(1);
+  modelScene->AddNode(dnode.GetPointer());
+  if (debug)
+    {
+    std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
+    std::cout << "Setting model's storage node: id = "
+              << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
+    }
+  mnode->SetAndObserveStorageNodeID(snode->GetID());
+  mnode->SetAndObserveDisplayNodeID(dnode->GetID());
+  modelScene->AddNode(mnode.GetPointer());
+
+  // put it in the hierarchy, either the flat one by default or
+  // try to find the matching color hierarchy node to make this an
+  // associated node
+  std::string colorName;
+  if (colorNode != nullptr)
+    {
+    colorName = std::string(colorNode->GetColorNameAsFileName(label));
+    }
+  else
+    {
+    // might be in a testing case where the hierarchy nodes are
+    // numbered (made from the generic colors)
+    std::stringstream ss;
+    ss << label;
+    colorName = ss.str();
+    if (debug)
+      {
+      std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
+      }
+    }
+  vtkMRMLNode *mrmlNode = nullptr;
+  if (colorName.compare("") != 0)
+    {
+    mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
+    }
+  // if there's no color hierarchy, or no color name or the mrml node
+  // named for the color isn't a model hierarchy node, use a flat hierarchy
+  if (topColorHierarchyNode == nullptr ||
+      colorName.compare("") == 0 ||
+      mrmlNode == nullptr ||
+      strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
+    {
+    vtkNew<vtkMRMLModelHierarchyNode> mhnd;
+    mhnd->SetHideFromEditors(1);
+    modelScene->AddNode(mhnd.GetPointer());
+    mhnd->SetParentNodeID(rnd->GetID());
+    mhnd->SetModelNodeID(mnode->GetID());
+    }
+  else
+    {
+    // use the template color hierarchy
+    vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
+    if (colorHierarchyNode)
+      {
+      colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
+      // and hide it so that it doesn't clutter up the tree
+      colorHierarchyNode->SetHideFromEditors(1);
+      if (debug)
+        {
+        std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
+        }
+      }
+    }
+  if (debug)
+    {
+    std::cout << "...done adding model to output scene" << endl;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Model of one label, generated in single pass mode
+struct LabelModel
+{
+  int Label{0};
+  std::string Name;
+  // Voxel extent of the label, extended by one voxel on each side
+  int Extent[6]{INT_MAX, INT_MIN, INT_MAX, INT_MIN, INT_MAX, INT_MIN};
+  std::string FileName;
+  bool HasPolygons{false};
+  bool Failed{false};
+};
+
+//----------------------------------------------------------------------------
+// Parameters of the per-label model generation pipeline
+struct LabelModelParameters
+{
+  int Smooth{10};
+  std::string FilterType;
+  float Decimate{0.25};
+  bool SplitNormals{true};
+  bool PointNormals{true};
+  bool SaveIntermediateModels{false};
+  bool Debug{false};
+  std::string RootDir;
+  std::string FileHeader;
+  vtkNew<vtkMatrix4x4> IJKToLPSMatrix;
+};
+
+//----------------------------------------------------------------------------
+// Find the extent of all labels in one pass over the image
+template <class T>
+void ComputeLabelExtents(vtkImageData* image, T* voxels, std::vector<LabelModel>& labelModels)
+{
+  std::unordered_map<int, LabelModel*> labelModelsByLabel;
+  for (LabelModel& labelModel : labelModels)
+    {
+    labelModelsByLabel[labelModel.Label] = &labelModel;
+    }
+  int extent[6] = { 0, -1, 0, -1, 0, -1 };
+  image->GetExtent(extent);
+  const int numberOfComponents = image->GetNumberOfScalarComponents();
+  T* voxel = voxels;
+  // neighbor voxels usually have the same value, so the label is only looked up when the value changes
+  LabelModel* labelModel = nullptr;
+  T lastValue = T();
+  bool lastValueValid = false;
+  for (int k = extent[4]; k <= extent[5]; k++)
+    {
+    for (int j = extent[2]; j <= extent[3]; j++)
+      {
+      for (int i = extent[0]; i <= extent[1]; i++, voxel += numberOfComponents)
+        {
+        if (!lastValueValid || *voxel != lastValue)
+          {
+          lastValue = *voxel;
+          lastValueValid = true;
+          labelModel = nullptr;
+          double value = static_cast<double>(lastValue);
+          if (value == std::floor(value) && value >= INT_MIN && value <= INT_MAX)
+            {
+            std::unordered_map<int, LabelModel*>::iterator labelModelIt = labelModelsByLabel.find(static_cast<int>(value));
+            if (labelModelIt != labelModelsByLabel.end())
+              {
+              labelModel = labelModelIt->second;
+              }
+            }
+          }
+        if (labelModel)
+          {
+          int* labelExtent = labelModel->Extent;
+          labelExtent[0] = std::min(labelExtent[0], i);
+          labelExtent[1] = std::max(labelExtent[1], i);
+          labelExtent[2] = std::min(labelExtent[2], j);
+          labelExtent[3] = std::max(labelExtent[3], j);
+          labelExtent[4] = std::min(labelExtent[4], k);
+          labelExtent[5] = std::max(labelExtent[5], k);
+          }
+        }
+      }
+    }
+  // Include the neighbor voxels, so that the surface is the same as the surface extracted from the whole image
+  for (LabelModel& model : labelModels)
+    {
+    for (int axis = 0; axis < 3; axis++)
+      {
+      model.Extent[axis * 2] = std::max(model.Extent[axis * 2] - 1, extent[axis * 2]);
+      model.Extent[axis * 2 + 1] = std::min(model.Extent[axis * 2 + 1] + 1, extent[axis * 2 + 1]);
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+bool WriteModel(vtkAlgorithmOutput* modelConnection, const std::string& fileName, const std::string& fileHeader)
+{
+  vtkNew<vtkPolyDataWriter> writer;
+  writer->SetInputConnection(modelConnection);
+  writer->SetHeader(fileHeader.c_str());
+  writer->SetFileType(2);
+  writer->SetFileName(fileName.c_str());
+  if (!writer->Write())
+    {
+    std::cerr << "ERROR: Failed to write model file " << fileName.c_str() << std::endl;
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Generate the model of a label from the region of the label map that contains the label
+// and write it to file. Uses the same filters and settings as the model generation from
+// the whole image, so that the generated models are the same. Thread-safe, the image is
+// only read.
+void GenerateLabelModel(vtkImageData* image, LabelModel& labelModel, const LabelModelParameters& parameters)
+{
+  const int label = labelModel.Label;
+  const std::string& labelName = labelModel.Name;
+  if (labelModel.Extent[0] > labelModel.Extent[1])
+    {
+    // label is not found in the image
+    return;
+    }
+
+  vtkNew<vtkImageData> labelImage;
+  labelImage->SetOrigin(image->GetOrigin());
+  labelImage->SetSpacing(image->GetSpacing());
+  labelImage->SetExtent(labelModel.Extent);
+  labelImage->AllocateScalars(image->GetScalarType(), image->GetNumberOfScalarComponents());
+  labelImage->CopyAndCastFrom(image, labelModel.Extent);
+
+  vtkNew<vtkImageThreshold> imageThreshold;
+  imageThreshold->SetInputData(labelImage.GetPointer());
+  imageThreshold->SetReplaceIn(1);
+  imageThreshold->SetReplaceOut(1);
+  imageThreshold->SetInValue(200);
+  imageThreshold->SetOutValue(0);
+  imageThreshold->ThresholdBetween(label, label);
+
+#if VTK_MAJOR_VERSION >= 9 || (VTK_MAJOR_VERSION >= 8 && VTK_MINOR_VERSION >= 2)
+  vtkNew<vtkFlyingEdges3D> mcubes;
+#else
+  vtkNew<vtkMarchingCubes> mcubes;
+#endif
+  mcubes->SetInputConnection(imageThreshold->GetOutputPort());
+  mcubes->SetValue(0, 100.5);
+  mcubes->ComputeScalarsOff();
+  mcubes->ComputeGradientsOff();
+  mcubes->ComputeNormalsOff();
+  mcubes->Update();
+  if (mcubes->GetOutput()->GetNumberOfPolys() == 0)
+    {
+    return;
+    }
+  labelModel.HasPolygons = true;
+  if (parameters.SaveIntermediateModels)
+    {
+    WriteModel(mcubes->GetOutputPort(), parameters.RootDir + labelName + "-MarchingCubes.vtk", parameters.FileHeader);
+    }
+
+  vtkNew<vtkDecimatePro> decimator;
+  decimator->SetInputConnection(mcubes->GetOutputPort());
+  decimator->SetFeatureAngle(60);
+  decimator->SplittingOff();
+  decimator->PreserveTopologyOn();
+  decimator->SetMaximumError(1);
+  decimator->SetTargetReduction(parameters.Decimate);
+  decimator->Update();
+  if (parameters.SaveIntermediateModels)
+    {
+    WriteModel(decimator->GetOutputPort(), parameters.RootDir + labelName + "-Decimated.vtk", parameters.FileHeader);
+    }
+  vtkSmartPointer<vtkAlgorithm> lastFilter = decimator.GetPointer();
+
+  if (parameters.IJKToLPSMatrix->Determinant() < 0)
+    {
+    vtkNew<vtkReverseSense> reverser;
+    reverser->SetInputConnection(lastFilter->GetOutputPort());
+    reverser->ReverseNormalsOn();
+    lastFilter = reverser.GetPointer();
+    }
+
+  if (parameters.FilterType == "Sinc")
+    {
+    vtkNew<vtkWindowedSincPolyDataFilter> smootherSinc;
+    smootherSinc->SetPassBand(0.1);
+    smootherSinc->SetInputConnection(lastFilter->GetOutputPort());
+    smootherSinc->SetNumberOfIterations(parameters.Smooth);
+    smootherSinc->FeatureEdgeSmoothingOff();
+    smootherSinc->BoundarySmoothingOff();
+    lastFilter = smootherSinc.GetPointer();
+    }
+  else
+    {
+    vtkNew<vtkSmoothPolyDataFilter> smootherPoly;
+    smootherPoly->SetRelaxationFactor(0.33);
+    smootherPoly->SetFeatureAngle(60);
+    smootherPoly->SetConvergence(0);
+    smootherPoly->SetInputConnection(lastFilter->GetOutputPort());
+    smootherPoly->SetNumberOfIterations(parameters.Smooth);
+    smootherPoly->FeatureEdgeSmoothingOff();
+    smootherPoly->BoundarySmoothingOff();
+    lastFilter = smootherPoly.GetPointer();
+    }
+  if (parameters.SaveIntermediateModels)
+    {
+    lastFilter->Update();
+    WriteModel(lastFilter->GetOutputPort(), parameters.RootDir + labelName + "-Smoothed.vtk", parameters.FileHeader);
+    }
+
+  // each thread uses its own transform, shared transforms are not updated concurrently
+  vtkNew<vtkTransform> transformIJKtoLPS;
+  transformIJKtoLPS->SetMatrix(parameters.IJKToLPSMatrix.GetPointer());
+  vtkNew<vtkTransformPolyDataFilter> transformer;
+  transformer->SetInputConnection(lastFilter->GetOutputPort());
+  transformer->SetTransform(transformIJKtoLPS.GetPointer());
+
+  vtkNew<vtkPolyDataNormals> normals;
+  if (parameters.PointNormals)
+    {
+    normals->ComputePointNormalsOn();
+    }
+  else
+    {
+    normals->ComputePointNormalsOff();
+    }
+  normals->SetInputConnection(transformer->GetOutputPort());
+  normals->SetFeatureAngle(60);
+  normals->SetSplitting(parameters.SplitNormals);
+
+  vtkNew<vtkStripper> stripper;
+  stripper->SetInputConnection(normals->GetOutputPort());
+  stripper->Update();
+
+  labelModel.FileName = parameters.RootDir + labelName + std::string(".vtk");
+  if (parameters.Debug)
+    {
+    std::cout << "Writing model " << " " << labelName << " to file " << labelModel.FileName << std::endl;
+    }
+  WriteModel(stripper->GetOutputPort(), labelModel.FileName, parameters.FileHeader);
+}
+
+//----------------------------------------------------------------------------
+// Generate models of all labels concurrently. The calling thread reports progress.
+void GenerateLabelModels(vtkImageData* image, std::vector<LabelModel>& labelModels,
+                         const LabelModelParameters& parameters, vtkAlgorithm* progressReporter)
+{
+  progressReporter->InvokeEvent(vtkCommand::StartEvent);
+  const size_t numberOfModels = labelModels.size();
+  size_t numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+  numberOfThreads = std::min(numberOfThreads, numberOfModels);
+
+  std::atomic<size_t> nextModelIndex(0);
+  size_t numberOfCompletedModels = 0;
+  std::mutex completedMutex;
+  std::condition_variable completedCondition;
+  auto generateModels = [&]()
+    {
+    for (size_t modelIndex = nextModelIndex++; modelIndex < numberOfModels; modelIndex = nextModelIndex++)
+      {
+      try
+        {
+        GenerateLabelModel(image, labelModels[modelIndex], parameters);
+        }
+      catch(...)
+        {
+        labelModels[modelIndex].Failed = true;
+        }
+        {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        numberOfCompletedModels++;
+        }
+      completedCondition.notify_one();
+      }
+    };
+  std::vector<std::thread> threads;
+  for (size_t threadIndex = 0; threadIndex < numberOfThreads; threadIndex++)
+    {
+    threads.emplace_back(generateModels);
+    }
+
+  // Progress is reported from this thread only, as the filter watcher is not thread-safe
+  std::unique_lock<std::mutex> lock(completedMutex);
+  while (numberOfCompletedModels < numberOfModels)
+    {
+    completedCondition.wait(lock);
+    double progress = static_cast<double>(numberOfCompletedModels) / numberOfModels;
+    lock.unlock();
+    progressReporter->UpdateProgress(progress);
+    lock.lock();
+    }
+  lock.unlock();
+
+  for (std::thread& thread : threads)
+    {
+    thread.join();
+    }
+  progressReporter->InvokeEvent(vtkCommand::EndEvent);
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
 int main(int argc, char * argv[])
 {
   PARSE_ARGS;
@@ -91,6 +526,7 @@ int main(int argc, char * argv[])
     std::cout << "Split normals? " << SplitNormals << std::endl;
     std::cout << "Calculate point normals? " << PointNormals << std::endl;
     std::cout << "Pad? " << Pad << std::endl;
+    std::cout << "Single pass? " << SinglePass << std::endl;
     std::cout << "Filter type: " << FilterType << std::endl;
     std::cout << "Input color hierarchy scene file: "
               << (ModelHierarchyFile.size() > 0 ? ModelHierarchyFile.c_str() : "None")  << std::endl;
@@ -868,6 +1304,12 @@ int main(int argc, char * argv[])
   transformIJKtoLPS->Scale(-1.0, -1.0, 1.0); // RAS to LPS
   transformIJKtoLPS->Concatenate(ijkToRasMatrix);
 
+  // In single pass mode the region of each label is found in one pass over the image
+  // and the models are generated from these regions concurrently, instead of processing
+  // the whole image for each label. Joint smoothing processes all labels at once already.
+  bool singlePass = SinglePass && makeMultiple && !JointSmoothing;
+  std::vector<LabelModel> labelModels;
+
   //
   // Loop through all the labels
   //
@@ -998,6 +1440,16 @@ int main(int argc, char * argv[])
       */
       }
 
+    if (singlePass)
+      {
+      // models are generated after all the labels to generate are known
+      LabelModel labelModel;
+      labelModel.Label = i;
+      labelModel.Name = labelName;
+      labelModels.push_back(labelModel);
+      continue;
+      }
+
     // threshold
     if (JointSmoothing == 0)
       {
@@ -1636,115 +2088,89 @@ int main(int argc, char * argv[])
       writer = nullptr;
       if (modelScene.GetPointer() != nullptr)
         {
-        if (debug)
-          {
-          std::cout << "Adding model " << labelName << " to the output scene, with filename " << fileName.c_str()
-                    << endl;
-          }
-        // each model needs a mrml node, a storage node and a display node
-        vtkNew<vtkMRMLModelNode> mnode;
-        mnode->SetScene(modelScene.GetPointer());
-        mnode->SetName(labelName.c_str());
-
-        vtkNew<vtkMRMLModelStorageNode> snode;
-        snode->SetFileName(fileName.c_str());
-        if (modelScene->AddNode(snode.GetPointer()) == nullptr)
-          {
-          std::cerr << "ERROR: unable to add the storage node to the model scene" << endl;
-          }
-        vtkNew<vtkMRMLModelDisplayNode> dnode;
-        dnode->SetColor(0.5, 0.5, 0.5);
-        double *rgba;
-        if (colorNode != nullptr)
-          {
-          rgba = colorNode->GetLookupTable()->GetTableValue(i);
-          if (rgba != nullptr)
-            {
-            if (debug)
-              {
-              std::cout << "Got colour: " << rgba[0] << " " << rgba[1] << " " << rgba[2] << " " << rgba[3] << endl;
-              }
-            dnode->SetColor(rgba[0], rgba[1], rgba[2]);
-            }
-          else
-            {
-            std::cerr << "Couldn't get look up table value for " << i << ", display node colour is not set (grey)"
-                      << endl;
-            }
-          }
-
-        dnode->SetVisibility(1);
-        modelScene->AddNode(dnode.GetPointer());
-        if (debug)
-          {
-          std::cout << "Added display node: id = " << (dnode->GetID() == nullptr ? "(null)" : dnode->GetID()) << endl;
-          std::cout << "Setting model's storage node: id = "
-                    << (snode->GetID() == nullptr ? "(null)" : snode->GetID()) << endl;
-          }
-        mnode->SetAndObserveStorageNodeID(snode->GetID());
-        mnode->SetAndObserveDisplayNodeID(dnode->GetID());
-        modelScene->AddNode(mnode.GetPointer());
-
-        // put it in the hierarchy, either the flat one by default or
-        // try to find the matching color hierarchy node to make this an
-        // associated node
-        std::string colorName;
-        if (colorNode != nullptr)
-          {
-          colorName = std::string(colorNode->GetColorNameAsFileName(i));
-          }
-        else
-          {
-          // might be in a testing case where the hierarchy nodes are
-          // numbered (made from the generic colors)
-          std::stringstream ss;
-          ss << i;
-          colorName = ss.str();
-          if (debug)
-            {
-            std::cout << "No color node, guessing at color name being same as label number " << colorName.c_str() << std::endl;
-            }
-          }
-        vtkMRMLNode *mrmlNode = nullptr;
-        if (colorName.compare("") != 0)
-          {
-          mrmlNode = modelScene->GetFirstNodeByName(colorName.c_str());
-          }
-        // if there's no color hierarchy, or no color name or the mrml node
-        // named for the color isn't a model hierarchy node, use a flat hierarchy
-        if (topColorHierarchyNode == nullptr ||
-            colorName.compare("") == 0 ||
-            mrmlNode == nullptr ||
-            strcmp(mrmlNode->GetClassName(),"vtkMRMLModelHierarchyNode") != 0)
-          {
-          vtkNew<vtkMRMLModelHierarchyNode> mhnd;
-          mhnd->SetHideFromEditors(1);
-          modelScene->AddNode(mhnd.GetPointer());
-          mhnd->SetParentNodeID(rnd->GetID());
-          mhnd->SetModelNodeID(mnode->GetID());
-          }
-        else
-          {
-          // use the template color hierarchy
-          vtkMRMLModelHierarchyNode *colorHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(mrmlNode);
-          if (colorHierarchyNode)
-            {
-            colorHierarchyNode->SetAssociatedNodeID(mnode->GetID());
-            // and hide it so that it doesn't clutter up the tree
-            colorHierarchyNode->SetHideFromEditors(1);
-            if (debug)
-              {
-              std::cout << "Found a color hierarchy node with name " << colorHierarchyNode->GetName() << ", set it's associated node to this model id: " << mnode->GetID() << std::endl;
-              }
-            }
-          }
-        if (debug)
-          {
-          std::cout << "...done adding model to output scene" << endl;
-          }
+        AddModelToScene(modelScene.GetPointer(), labelName, fileName, i,
+                        colorNode, topColorHierarchyNode, rnd, debug);
         }
       } // end of skipping an empty label
     }   // end of loop over labels
+  if (singlePass && !labelModels.empty())
+    {
+    vtkImageData* labelImage = image;
+    if (Pad)
+      {
+      padder->Update();
+      labelImage = padder->GetOutput();
+      }
+    switch (labelImage->GetScalarType())
+      {
+      vtkTemplateMacro(ComputeLabelExtents(labelImage, static_cast<VTK_TT*>(labelImage->GetScalarPointer()), labelModels));
+      default:
+        std::cerr << "ERROR: unsupported scalar type " << labelImage->GetScalarType() << std::endl;
+        return EXIT_FAILURE;
+      }
+
+    LabelModelParameters parameters;
+    if (strcmp(FilterType.c_str(), "Sinc") == 0 && Smooth == 1)
+      {
+      std::cerr << "Warning: Smoothing iterations of 1 not allowed for Sinc filter, using 2" << endl;
+      Smooth = 2;
+      }
+    parameters.Smooth = Smooth;
+    parameters.FilterType = FilterType;
+    parameters.Decimate = Decimate;
+    parameters.SplitNormals = SplitNormals;
+    parameters.PointNormals = PointNormals;
+    parameters.SaveIntermediateModels = SaveIntermediateModels;
+    parameters.Debug = debug;
+    if (rootDir != "")
+      {
+      parameters.RootDir = rootDir + std::string("/");
+      }
+    else
+      {
+      std::cout << "WARNING: output directory is an empty string..." << endl;
+      }
+    parameters.FileHeader = modelFileHeader;
+    parameters.IJKToLPSMatrix->DeepCopy(transformIJKtoLPS->GetMatrix());
+
+    std::stringstream stream;
+    stream << "Generate Models (" << labelModels.size() << " to process)";
+    std::string            commentModels = stream.str();
+    vtkNew<vtkAlgorithm>   progressReporter;
+    vtkPluginFilterWatcher watchModels(progressReporter.GetPointer(),
+                                       commentModels.c_str(),
+                                       CLPProcessInformation,
+                                       (numFilterSteps - currentFilterOffset) / numFilterSteps,
+                                       currentFilterOffset / numFilterSteps);
+    if (debug)
+      {
+      watchModels.QuietOn();
+      }
+    GenerateLabelModels(labelImage, labelModels, parameters, progressReporter.GetPointer());
+
+    // Add the models to the scene in the same order as the models are generated one by one
+    for (::size_t l = 0; l < labelModels.size(); l++)
+      {
+      const LabelModel& labelModel = labelModels[l];
+      if (labelModel.Failed)
+        {
+        std::cerr << "ERROR while generating model for label " << labelModel.Label << std::endl;
+        return EXIT_FAILURE;
+        }
+      if (!labelModel.HasPolygons)
+        {
+        std::cout << "Cannot create a model from label " << labelModel.Label
+                  << "\nNo polygons can be created,\nthere may be no voxels with this label in the volume." << endl;
+        std::cout << "...continuing" << endl;
+        continue;
+        }
+      if (modelScene.GetPointer() != nullptr)
+        {
+        AddModelToScene(modelScene.GetPointer(), labelModel.Name, labelModel.FileName, labelModel.Label,
+                        colorNode, topColorHierarchyNode, rnd, debug);
+        }
+      }
+    }
   if (debug)
     {
     std::cout << "End of looping over labels" << endl;
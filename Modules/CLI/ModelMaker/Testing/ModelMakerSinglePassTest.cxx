@@ -0,0 +1,182 @@
+/*=auto=========================================================================
+
+Portions (c) Copyright 2006 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+See COPYRIGHT.txt
+or http://www.slicer.org/copyright/copyright.txt for details.
+
+=========================================================================auto=*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLModelHierarchyNode.h"
+#include "vtkMRMLModelNode.h"
+#include "vtkMRMLModelStorageNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkNew.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataReader.h>
+#include <vtkSmartPointer.h>
+#include <vtkTimerLog.h>
+
+// VTKsys includes
+#include <vtksys/SystemTools.hxx>
+
+// STD includes
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#ifdef WIN32
+#define MODULE_IMPORT __declspec(dllimport)
+#else
+#define MODULE_IMPORT
+#endif
+
+extern "C" MODULE_IMPORT int ModuleEntryPoint(int, char * []);
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int RunModelMaker(const std::string& inputVolume, const std::string& outputDirectory, bool singlePass, double& runtime)
+{
+  vtksys::SystemTools::RemoveADirectory(outputDirectory);
+  vtksys::SystemTools::MakeDirectory(outputDirectory);
+
+  std::vector<std::string> arguments;
+  arguments.push_back("ModelMaker");
+  arguments.push_back("--generateAll");
+  arguments.push_back("--modelSceneFile");
+  arguments.push_back(outputDirectory + "/models.mrml#vtkMRMLModelHierarchyNode1");
+  if (singlePass)
+    {
+    arguments.push_back("--singlePass");
+    }
+  arguments.push_back(inputVolume);
+  std::vector<char*> argv;
+  for (std::string& argument : arguments)
+    {
+    argv.push_back(&argument[0]);
+    }
+
+  vtkNew<vtkTimerLog> timer;
+  timer->StartTimer();
+  int result = ModuleEntryPoint(static_cast<int>(argv.size()), argv.data());
+  timer->StopTimer();
+  runtime = timer->GetElapsedTime();
+  return result;
+}
+
+//----------------------------------------------------------------------------
+vtkSmartPointer<vtkPolyData> ReadModel(vtkMRMLModelNode* modelNode)
+{
+  vtkMRMLModelStorageNode* storageNode = vtkMRMLModelStorageNode::SafeDownCast(modelNode->GetStorageNode());
+  if (!storageNode)
+    {
+    return nullptr;
+    }
+  vtkNew<vtkPolyDataReader> reader;
+  reader->SetFileName(storageNode->GetFullNameFromFileName().c_str());
+  reader->Update();
+  return reader->GetOutput();
+}
+
+//----------------------------------------------------------------------------
+int CompareModels(vtkPolyData* expectedModel, vtkPolyData* model)
+{
+  CHECK_NOT_NULL(expectedModel);
+  CHECK_NOT_NULL(model);
+  CHECK_BOOL(model->GetNumberOfPoints() > 0, true);
+  CHECK_INT(model->GetNumberOfPoints(), expectedModel->GetNumberOfPoints());
+  CHECK_INT(model->GetNumberOfCells(), expectedModel->GetNumberOfCells());
+  double maximumDistance = 0.0;
+  for (vtkIdType pointIndex = 0; pointIndex < model->GetNumberOfPoints(); ++pointIndex)
+    {
+    double* expectedPoint = expectedModel->GetPoint(pointIndex);
+    double* point = model->GetPoint(pointIndex);
+    for (int axis = 0; axis < 3; ++axis)
+      {
+      maximumDistance = std::max(maximumDistance, std::abs(point[axis] - expectedPoint[axis]));
+      }
+    }
+  CHECK_DOUBLE_TOLERANCE(maximumDistance, 0.0, 1e-4);
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int CompareScenes(const std::string& expectedSceneFile, const std::string& sceneFile)
+{
+  vtkNew<vtkMRMLScene> expectedScene;
+  expectedScene->SetURL(expectedSceneFile.c_str());
+  CHECK_INT(expectedScene->Import(), 1);
+  vtkNew<vtkMRMLScene> scene;
+  scene->SetURL(sceneFile.c_str());
+  CHECK_INT(scene->Import(), 1);
+
+  // Hierarchy is the same
+  CHECK_INT(scene->GetNumberOfNodes(), expectedScene->GetNumberOfNodes());
+  CHECK_INT(scene->GetNumberOfNodesByClass("vtkMRMLModelHierarchyNode"),
+    expectedScene->GetNumberOfNodesByClass("vtkMRMLModelHierarchyNode"));
+  for (int nodeIndex = 0; nodeIndex < expectedScene->GetNumberOfNodes(); ++nodeIndex)
+    {
+    vtkMRMLNode* expectedNode = expectedScene->GetNthNode(nodeIndex);
+    vtkMRMLNode* node = scene->GetNthNode(nodeIndex);
+    CHECK_STD_STRING(node->GetClassName(), expectedNode->GetClassName());
+    CHECK_STRING(node->GetID(), expectedNode->GetID());
+    CHECK_STRING(node->GetName(), expectedNode->GetName());
+    vtkMRMLModelHierarchyNode* expectedHierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(expectedNode);
+    if (expectedHierarchyNode)
+      {
+      vtkMRMLModelHierarchyNode* hierarchyNode = vtkMRMLModelHierarchyNode::SafeDownCast(node);
+      CHECK_STRING(hierarchyNode->GetParentNodeID(), expectedHierarchyNode->GetParentNodeID());
+      CHECK_STRING(hierarchyNode->GetAssociatedNodeID(), expectedHierarchyNode->GetAssociatedNodeID());
+      }
+    }
+
+  // Models are the same
+  int numberOfModels = expectedScene->GetNumberOfNodesByClass("vtkMRMLModelNode");
+  CHECK_BOOL(numberOfModels > 0, true);
+  for (int modelIndex = 0; modelIndex < numberOfModels; ++modelIndex)
+    {
+    vtkMRMLModelNode* expectedModelNode = vtkMRMLModelNode::SafeDownCast(
+      expectedScene->GetNthNodeByClass(modelIndex, "vtkMRMLModelNode"));
+    vtkMRMLModelNode* modelNode = vtkMRMLModelNode::SafeDownCast(
+      scene->GetNthNodeByClass(modelIndex, "vtkMRMLModelNode"));
+    CHECK_NOT_NULL(modelNode);
+    CHECK_EXIT_SUCCESS(CompareModels(ReadModel(expectedModelNode), ReadModel(modelNode)));
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+// Generate models from all labels of the input volume one by one and in single pass mode,
+// then check that the same models and model hierarchy are generated.
+int ModelMakerSinglePassTest(int argc, char * argv[])
+{
+  if (argc < 3)
+    {
+    std::cerr << "Usage: " << argv[0] << " inputVolume outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string inputVolume = argv[1];
+  std::string outputDirectory = argv[2];
+
+  double runtime = 0.0;
+  CHECK_EXIT_SUCCESS(RunModelMaker(inputVolume, outputDirectory + "/EachLabel", false, runtime));
+  std::cout << "<DartMeasurement name=\"EachLabelTime\" type=\"numeric/double\">"
+            << runtime << "</DartMeasurement>" << std::endl;
+  double singlePassRuntime = 0.0;
+  CHECK_EXIT_SUCCESS(RunModelMaker(inputVolume, outputDirectory + "/SinglePass", true, singlePassRuntime));
+  std::cout << "<DartMeasurement name=\"SinglePassTime\" type=\"numeric/double\">"
+            << singlePassRuntime << "</DartMeasurement>" << std::endl;
+  std::cout << "Model generation time: each label " << runtime << "s, single pass " << singlePassRuntime << "s" << std::endl;
+
+  CHECK_EXIT_SUCCESS(CompareScenes(outputDirectory + "/EachLabel/models.mrml", outputDirectory + "/SinglePass/models.mrml"));
+  return EXIT_SUCCESS;
+}
@@ -520,6 +520,9 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
       markupsNode->RemoveAllControlPoints();
       }
 
+    // Measurements and interaction handles are updated once, when all points are read
+    bool wasUpdatingPoints = markupsNode->StartPointsUpdate();
+
     char line[MARKUPS_BUFFER_SIZE];
 
     // save the valid lines in a vector, parse them once know the max id
@@ -672,6 +675,7 @@ int vtkMRMLMarkupsFiducialStorageNode::ReadDataInternal(vtkMRMLNode *refNode)
         }
       }
     fstr.close();
+    markupsNode->EndPointsUpdate(wasUpdatingPoints);
     }
   else
     {
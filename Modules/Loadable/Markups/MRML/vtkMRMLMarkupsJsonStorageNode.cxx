@@ -64,6 +64,7 @@ public:
   bool UpdateMarkupsDisplayNodeFromJsonValue(vtkMRMLMarkupsDisplayNode* displayNode, rapidjson::Value& markupObject);
   bool ReadVector(rapidjson::Value& item, double* v, int numberOfComponents=3);
   bool ReadControlPoints(rapidjson::Value& item, int coordinateSystem, vtkMRMLMarkupsNode* markupsNode);
+  bool ReadControlPointsInternal(rapidjson::Value& item, int coordinateSystem, vtkMRMLMarkupsNode* markupsNode);
 
 
   // Writer
@@ -171,6 +172,16 @@ bool vtkMRMLMarkupsJsonStorageNode::vtkInternal::ReadControlPoints(rapidjson::Va
     return false;
     }
 
+  // Measurements and interaction handles are updated once, when all points are added
+  bool wasUpdatingPoints = markupsNode->StartPointsUpdate();
+  bool success = this->ReadControlPointsInternal(controlPointsArray, coordinateSystem, markupsNode);
+  markupsNode->EndPointsUpdate(wasUpdatingPoints);
+  return success;
+}
+
+//----------------------------------------------------------------------------
+bool vtkMRMLMarkupsJsonStorageNode::vtkInternal::ReadControlPointsInternal(rapidjson::Value& controlPointsArray, int coordinateSystem, vtkMRMLMarkupsNode* markupsNode)
+{
   for (rapidjson::SizeType controlPointIndex = 0; controlPointIndex < controlPointsArray.Size(); ++controlPointIndex)
     {
     rapidjson::Value& controlPointItem = controlPointsArray[controlPointIndex];
@@ -208,6 +208,7 @@ void vtkMRMLMarkupsNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*/)
   this->CurveInputPoly->GetPoints()->Reset();
   this->RemoveAllControlPoints();
   int numMarkups = node->GetNumberOfControlPoints();
+  bool wasUpdatingPoints = this->StartPointsUpdate();
   for (int n = 0; n < numMarkups; n++)
     {
     ControlPoint* controlPoint = node->GetNthControlPoint(n);
@@ -215,6 +216,7 @@ void vtkMRMLMarkupsNode::CopyContent(vtkMRMLNode* anode, bool deepCopy/*=true*/)
     (*controlPointCopy) = (*controlPoint);
     this->AddControlPoint(controlPointCopy, false);
     }
+  this->EndPointsUpdate(wasUpdatingPoints);
 }
 
 //---------------------------------------------------------------------------
@@ -338,11 +340,15 @@ void vtkMRMLMarkupsNode::RemoveAllControlPoints()
     }
 
   this->ControlPoints.clear();
+  this->ControlPointIndexByID.clear();
 
   this->CurveInputPoly->GetPoints()->Reset();
   this->CurveInputPoly->GetPoints()->Squeeze();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (!this->IsUpdatingPoints)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointRemovedEvent);
   if (definedPointsExisted)
@@ -503,7 +509,10 @@ int vtkMRMLMarkupsNode::AddControlPoint(ControlPoint *controlPoint, bool autoLab
   this->CurveInputPoly->GetPoints()->InsertNextPoint(controlPoint->Position);
   this->CurveInputPoly->GetPoints()->Modified();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (!this->IsUpdatingPoints)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   int controlPointIndex = this->GetNumberOfControlPoints() - 1;
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointAddedEvent,  static_cast<void*>(&controlPointIndex));
@@ -645,8 +654,21 @@ void vtkMRMLMarkupsNode::RemoveNthControlPoint(int pointIndex)
   delete this->ControlPoints[static_cast<unsigned int> (pointIndex)];
   this->ControlPoints.erase(this->ControlPoints.begin() + pointIndex);
 
-  this->UpdateCurvePolyFromControlPoints();
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (pointIndex == this->GetNumberOfControlPoints())
+    {
+    // last point is removed, no need to rebuild all curve points
+    vtkPoints* points = this->CurveInputPoly->GetPoints();
+    points->SetNumberOfPoints(pointIndex);
+    points->Modified();
+    }
+  else
+    {
+    this->UpdateCurvePolyFromControlPoints();
+    }
+  if (!this->IsUpdatingPoints)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   if (positionWasDefined)
     {
@@ -689,7 +711,10 @@ bool vtkMRMLMarkupsNode::InsertControlPoint(ControlPoint *controlPoint, int targ
   std::vector < ControlPoint* >::iterator result = this->ControlPoints.insert(pos, controlPoint);
 
   this->UpdateCurvePolyFromControlPoints();
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (!this->IsUpdatingPoints)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // let observers know that a markup was added
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointAddedEvent, static_cast<void*>(&targetIndex));
@@ -755,7 +780,10 @@ void vtkMRMLMarkupsNode::SwapControlPoints(int m1, int m2)
   *controlPoint2 = controlPoint1Backup;
 
   this->UpdateCurvePolyFromControlPoints();
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (!this->IsUpdatingPoints)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // and let listeners know that two control points have changed
   this->InvokeCustomModifiedEvent(vtkMRMLMarkupsNode::PointModifiedEvent, static_cast<void*>(&m1));
@@ -806,7 +834,10 @@ void vtkMRMLMarkupsNode::SetNthControlPointPosition(const int pointIndex,
   points->SetPoint(pointIndex, x, y, z);
   points->Modified();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (!this->IsUpdatingPoints)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // throw an event to let listeners know the position has changed
   int n = pointIndex;
@@ -880,7 +911,10 @@ void vtkMRMLMarkupsNode::SetNthControlPointPositionOrientationWorldFromArray(
   points->SetPoint(pointIndex, controlPoint->Position);
   points->Modified();
 
-  this->UpdateInteractionHandleToWorldMatrix();
+  if (!this->IsUpdatingPoints)
+    {
+    this->UpdateInteractionHandleToWorldMatrix();
+    }
 
   // throw an event to let listeners know the position has changed
   int n = pointIndex;
@@ -1132,18 +1166,45 @@ int vtkMRMLMarkupsNode::GetNthControlPointIndexByID(const char* controlPointID)
     {
     return -1;
     }
-  for (int controlPointIndex = 0; controlPointIndex < this->GetNumberOfControlPoints(); controlPointIndex++)
+  // Control points may have been inserted, removed, or their ID changed since the lookup table
+  // was built, therefore the table is only used if it points to a control point with this ID.
+  for (int attempt = 0; attempt < 2; attempt++)
     {
-    ControlPoint *compareControlPoint = this->ControlPoints[controlPointIndex];
-    if (compareControlPoint &&
-        strcmp(compareControlPoint->ID.c_str(), controlPointID) == 0)
+    std::map<std::string, int>::iterator indexIt = this->ControlPointIndexByID.find(controlPointID);
+    if (indexIt != this->ControlPointIndexByID.end())
+      {
+      int controlPointIndex = indexIt->second;
+      if (controlPointIndex >= 0 && controlPointIndex < this->GetNumberOfControlPoints()
+        && this->ControlPoints[controlPointIndex]
+        && this->ControlPoints[controlPointIndex]->ID == controlPointID)
+        {
+        return controlPointIndex;
+        }
+      }
+    if (attempt == 0)
       {
-      return controlPointIndex;
+      this->UpdateControlPointIndexByID();
       }
     }
   return -1;
 }
 
+//-------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::UpdateControlPointIndexByID()
+{
+  this->ControlPointIndexByID.clear();
+  int numberOfControlPoints = this->GetNumberOfControlPoints();
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
+    {
+    ControlPoint *controlPoint = this->ControlPoints[controlPointIndex];
+    if (controlPoint)
+      {
+      // if IDs are not unique then the first control point is found, as in a linear search
+      this->ControlPointIndexByID.insert(std::make_pair(controlPoint->ID, controlPointIndex));
+      }
+    }
+}
+
 //-------------------------------------------------------------------------
 vtkMRMLMarkupsNode::ControlPoint* vtkMRMLMarkupsNode::GetNthControlPointByID(const char* controlPointID)
 {
@@ -1818,6 +1879,18 @@ void vtkMRMLMarkupsNode::GetControlPointLabels(vtkStringArray* labels)
 
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
+{
+  this->SetControlPointPositionsInternal(points, true);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::SetControlPointPositions(vtkPoints* points)
+{
+  this->SetControlPointPositionsInternal(points, false);
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::SetControlPointPositionsInternal(vtkPoints* points, bool world)
 {
   if (!points)
     {
@@ -1826,21 +1899,35 @@ void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
     }
 
   int wasModified = this->StartModify();
-  this->IsUpdatingPoints = true;
+  bool wasUpdatingPoints = this->StartPointsUpdate();
 
   vtkIdType numberOfPoints = points->GetNumberOfPoints();
   for (vtkIdType pointIndex = 0; pointIndex < numberOfPoints; pointIndex++)
     {
-    double* posWorld = points->GetPoint(pointIndex);
+    double* pos = points->GetPoint(pointIndex);
     if (pointIndex < this->GetNumberOfControlPoints())
       {
       // point already exists, just update it
-      this->SetNthControlPointPositionWorldFromArray(pointIndex, posWorld);
+      if (world)
+        {
+        this->SetNthControlPointPositionWorldFromArray(pointIndex, pos);
+        }
+      else
+        {
+        this->SetNthControlPointPositionFromArray(pointIndex, pos);
+        }
       }
     else
       {
       // need to add a new point
-      vtkMRMLMarkupsNode::AddControlPointWorld(vtkVector3d(posWorld));
+      if (world)
+        {
+        vtkMRMLMarkupsNode::AddControlPointWorld(vtkVector3d(pos));
+        }
+      else
+        {
+        vtkMRMLMarkupsNode::AddControlPoint(vtkVector3d(pos));
+        }
       }
     }
   while (this->GetNumberOfControlPoints() > numberOfPoints)
@@ -1848,11 +1935,31 @@ void vtkMRMLMarkupsNode::SetControlPointPositionsWorld(vtkPoints* points)
     this->RemoveNthControlPoint(this->GetNumberOfControlPoints() - 1);
     }
 
-  this->IsUpdatingPoints = false;
-  this->UpdateMeasurements();
+  this->EndPointsUpdate(wasUpdatingPoints);
   this->EndModify(wasModified);
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLMarkupsNode::StartPointsUpdate()
+{
+  bool wasUpdatingPoints = this->IsUpdatingPoints;
+  this->IsUpdatingPoints = true;
+  return wasUpdatingPoints;
+}
+
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::EndPointsUpdate(bool wasUpdatingPoints)
+{
+  this->IsUpdatingPoints = wasUpdatingPoints;
+  if (wasUpdatingPoints)
+    {
+    // an outer update is still in progress
+    return;
+    }
+  this->UpdateInteractionHandleToWorldMatrix();
+  this->UpdateMeasurements();
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
 {
@@ -1870,6 +1977,21 @@ void vtkMRMLMarkupsNode::GetControlPointPositionsWorld(vtkPoints* points)
     }
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLMarkupsNode::GetControlPointPositions(vtkPoints* points)
+{
+  if (!points)
+    {
+    return;
+    }
+  int numberOfControlPoints = this->GetNumberOfControlPoints();
+  points->SetNumberOfPoints(numberOfControlPoints);
+  for (int controlPointIndex = 0; controlPointIndex < numberOfControlPoints; controlPointIndex++)
+    {
+    points->SetPoint(controlPointIndex, this->ControlPoints[controlPointIndex]->Position);
+    }
+}
+
 //---------------------------------------------------------------------------
 bool vtkMRMLMarkupsNode::SetControlPointLabelsWorld(vtkStringArray* labels, vtkPoints* points, std::string separator /*=""*/)
 {
@@ -31,6 +31,9 @@
 #include <vtkSmartPointer.h>
 #include <vtkVector.h>
 
+// STD includes
+#include <map>
+
 class vtkFrenetSerretFrame;
 class vtkMRMLUnitNode;
 
@@ -568,11 +571,29 @@ public:
   /// New control points are added if needed.
   /// Existing control points are updated with the new positions.
   /// Any extra existing control points are removed.
+  /// Measurements and interaction handles are updated only once, after all points are set,
+  /// therefore this is much faster than setting the points one by one.
   void SetControlPointPositionsWorld(vtkPoints* points);
 
+  /// Set all control point positions from a point list, in local coordinate system.
+  /// \sa SetControlPointPositionsWorld
+  void SetControlPointPositions(vtkPoints* points);
+
   /// Get a copy of all control point positions in world coordinate system
   void GetControlPointPositionsWorld(vtkPoints* points);
 
+  /// Get a copy of all control point positions in local coordinate system
+  void GetControlPointPositions(vtkPoints* points);
+
+  /// Pause update of measurements and interaction handles while many control points are added or modified.
+  /// Returns the previous state, which must be passed to EndPointsUpdate.
+  /// It is recommended to also call StartModify/EndModify, so that observers are notified only once.
+  bool StartPointsUpdate();
+
+  /// Resume update of measurements and interaction handles and, if this ends the outermost
+  /// update, update them once.
+  void EndPointsUpdate(bool wasUpdatingPoints);
+
   /// 4x4 matrix detailing the orientation and position in world coordinates of the interaction handles.
   virtual vtkMatrix4x4* GetInteractionHandleToWorldMatrix();
 
@@ -631,6 +652,12 @@ protected:
   /// Calculates the handle to world matrix based on the current control points
   virtual void UpdateInteractionHandleToWorldMatrix();
 
+  /// Set all control point positions, in world or local coordinate system
+  void SetControlPointPositionsInternal(vtkPoints* points, bool world);
+
+  /// Rebuild the control point ID to index lookup table
+  void UpdateControlPointIndexByID();
+
   // Used for limiting number of markups that may be placed.
   int MaximumNumberOfControlPoints;
   int RequiredNumberOfControlPoints;
@@ -681,8 +708,14 @@ protected:
   // Transform that moves the xyz unit vectors and origin of the interaction handles to local coordinates
   vtkSmartPointer<vtkMatrix4x4> InteractionHandleToWorldMatrix;
 
-  /// Flag set from SetControlPointPositionsWorld that pauses update of measurements until the update is complete.
+  /// Flag set from StartPointsUpdate that pauses update of measurements and
+  /// interaction handles until the update is complete.
   bool IsUpdatingPoints;
+
+  /// Cached control point index for each control point ID.
+  /// Entries may be outdated (points may be inserted, removed, or their ID changed),
+  /// therefore found entries are verified and the table is rebuilt if needed.
+  std::map<std::string, int> ControlPointIndexByID;
 };
 
 #endif
@@ -0,0 +1,156 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+#include "vtkMRMLMarkupsFiducialNode.h"
+#include "vtkMRMLMarkupsLineNode.h"
+#include "vtkMRMLScene.h"
+
+// VTK includes
+#include <vtkMatrix4x4.h>
+#include <vtkNew.h>
+#include <vtkPoints.h>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+int TestControlPointIndexByID()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode;
+  scene->AddNode(markupsNode);
+
+  for (int i = 0; i < 100; i++)
+    {
+    markupsNode->AddControlPoint(vtkVector3d(i, 0, 0));
+    }
+  std::string firstID = markupsNode->GetNthControlPointID(0);
+  std::string tenthID = markupsNode->GetNthControlPointID(10);
+  std::string lastID = markupsNode->GetNthControlPointID(99);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(firstID.c_str()), 0);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(tenthID.c_str()), 10);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(lastID.c_str()), 99);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID("nonexistent"), -1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(nullptr), -1);
+
+  // Indices are updated when points are inserted, removed, or swapped
+  markupsNode->InsertControlPoint(5, vtkVector3d(0, 1, 0), "inserted");
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(tenthID.c_str()), 11);
+  std::string insertedID = markupsNode->GetNthControlPointID(5);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(insertedID.c_str()), 5);
+
+  markupsNode->RemoveNthControlPoint(0);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(firstID.c_str()), -1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(tenthID.c_str()), 10);
+
+  markupsNode->SwapControlPoints(10, 20);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(tenthID.c_str()), 20);
+
+  // Changed IDs are found
+  markupsNode->ResetNthControlPointID(20);
+  std::string resetID = markupsNode->GetNthControlPointID(20);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(tenthID.c_str()), -1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(resetID.c_str()), 20);
+  CHECK_POINTER(markupsNode->GetNthControlPointByID(resetID.c_str()), markupsNode->GetNthControlPoint(20));
+
+  markupsNode->RemoveAllControlPoints();
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(lastID.c_str()), -1);
+  CHECK_INT(markupsNode->GetNthControlPointIndexByID(resetID.c_str()), -1);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSetControlPointPositions()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsFiducialNode> markupsNode;
+  scene->AddNode(markupsNode);
+  markupsNode->AddControlPoint(vtkVector3d(100, 100, 100), "existing");
+
+  const int numberOfPoints = 1000;
+  vtkNew<vtkPoints> points;
+  for (int i = 0; i < numberOfPoints; i++)
+    {
+    points->InsertNextPoint(i, 2 * i, 0);
+    }
+  markupsNode->SetControlPointPositions(points);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), numberOfPoints);
+  CHECK_STD_STRING(markupsNode->GetNthControlPointLabel(0), "existing");
+  double position[3] = { 0.0, 0.0, 0.0 };
+  markupsNode->GetNthControlPointPosition(numberOfPoints - 1, position);
+  CHECK_DOUBLE(position[1], 2.0 * (numberOfPoints - 1));
+
+  // Interaction handles are updated after all points are set:
+  // the origin is at the center of the points
+  vtkMatrix4x4* handleToWorldMatrix = markupsNode->GetInteractionHandleToWorldMatrix();
+  CHECK_DOUBLE_TOLERANCE(handleToWorldMatrix->GetElement(0, 3), (numberOfPoints - 1) / 2.0, 1e-6);
+  CHECK_DOUBLE_TOLERANCE(handleToWorldMatrix->GetElement(1, 3), (numberOfPoints - 1), 1e-6);
+
+  // Extra points are removed
+  vtkNew<vtkPoints> fewerPoints;
+  fewerPoints->InsertNextPoint(1, 2, 3);
+  fewerPoints->InsertNextPoint(4, 5, 6);
+  markupsNode->SetControlPointPositions(fewerPoints);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 2);
+  vtkNew<vtkPoints> retrievedPoints;
+  markupsNode->GetControlPointPositions(retrievedPoints);
+  CHECK_INT(retrievedPoints->GetNumberOfPoints(), 2);
+  CHECK_DOUBLE(retrievedPoints->GetPoint(1)[2], 6.0);
+
+  markupsNode->SetControlPointPositions(nullptr);
+  CHECK_INT(markupsNode->GetNumberOfControlPoints(), 0);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestPointsUpdate()
+{
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLMarkupsLineNode> lineNode;
+  scene->AddNode(lineNode);
+  lineNode->AddControlPoint(vtkVector3d(0, 0, 0));
+  lineNode->AddControlPoint(vtkVector3d(10, 0, 0));
+  CHECK_DOUBLE(lineNode->GetNthMeasurement(0)->GetValue(), 10.0);
+
+  // Measurements are updated only when the outermost update ends
+  bool wasUpdatingPoints = lineNode->StartPointsUpdate();
+  CHECK_BOOL(wasUpdatingPoints, false);
+  bool wasUpdatingPointsNested = lineNode->StartPointsUpdate();
+  CHECK_BOOL(wasUpdatingPointsNested, true);
+  lineNode->SetNthControlPointPosition(1, 20, 0, 0);
+  lineNode->EndPointsUpdate(wasUpdatingPointsNested);
+  CHECK_DOUBLE(lineNode->GetNthMeasurement(0)->GetValue(), 10.0);
+  lineNode->EndPointsUpdate(wasUpdatingPoints);
+  CHECK_DOUBLE(lineNode->GetNthMeasurement(0)->GetValue(), 20.0);
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLMarkupsNodeTest5(int , char * [] )
+{
+  CHECK_EXIT_SUCCESS(TestControlPointIndexByID());
+  CHECK_EXIT_SUCCESS(TestSetControlPointPositions());
+  CHECK_EXIT_SUCCESS(TestPointsUpdate());
+  return EXIT_SUCCESS;
+}
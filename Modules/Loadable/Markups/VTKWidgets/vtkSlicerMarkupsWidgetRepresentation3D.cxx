@@ -46,6 +46,9 @@
 #include <vtkMRMLInteractionEventData.h>
 #include <vtkMRMLViewNode.h>
 
+// STD includes
+#include <algorithm>
+
 vtkSlicerMarkupsWidgetRepresentation3D::ControlPointsPipeline3D::ControlPointsPipeline3D()
 {
   this->Glypher = vtkSmartPointer<vtkGlyph3D>::New();
@@ -143,6 +146,7 @@ vtkSlicerMarkupsWidgetRepresentation3D::vtkSlicerMarkupsWidgetRepresentation3D()
   this->HideTextActorIfAllPointsOccluded = false;
 
   this->ControlPointSize = 10; // will be set from the markup's GlyphScale
+  this->NumberOfControlPointsInPipelines = -1;
 
   this->AccuratePicker = vtkSmartPointer<vtkCellPicker>::New();
   this->AccuratePicker->SetTolerance(.005);
@@ -152,21 +156,96 @@ vtkSlicerMarkupsWidgetRepresentation3D::vtkSlicerMarkupsWidgetRepresentation3D()
 vtkSlicerMarkupsWidgetRepresentation3D::~vtkSlicerMarkupsWidgetRepresentation3D() = default;
 
 //----------------------------------------------------------------------
-void vtkSlicerMarkupsWidgetRepresentation3D::UpdateNthPointAndLabelFromMRML(int vtkNotUsed(n))
+bool vtkSlicerMarkupsWidgetRepresentation3D::UpdateNthPointAndLabelFromMRML(int n)
 {
-  /*
-  TODO: implement this for better performance
-  if (markupsNode->GetNumberOfControlPoints() - 1 >= this->PointsVisibilityOnSlice->GetNumberOfValues())
+  vtkMRMLMarkupsNode* markupsNode = this->GetMarkupsNode();
+  if (!this->MarkupsDisplayNode || !markupsNode
+    || n < 0 || n >= markupsNode->GetNumberOfControlPoints()
+    || markupsNode->GetNumberOfControlPoints() != this->NumberOfControlPointsInPipelines)
     {
-    this->PointsVisibilityOnSlice->InsertValue(markupsNode->GetNumberOfControlPoints() - 1, 1);
+    return false;
     }
-  else
+
+  // Find the pipeline that the point must be displayed in
+  int expectedControlPointType = -1;
+  if (markupsNode->GetNthControlPointVisibility(n))
     {
-    this->PointsVisibilityOnSlice->InsertNextValue(1);
+    std::vector<int> activeControlPointIndices;
+    this->MarkupsDisplayNode->GetActiveControlPoints(activeControlPointIndices);
+    if (std::find(activeControlPointIndices.begin(), activeControlPointIndices.end(), n) != activeControlPointIndices.end())
+      {
+      expectedControlPointType = Active;
+      }
+    else
+      {
+      expectedControlPointType = markupsNode->GetNthControlPointSelected(n) ? Selected : Unselected;
+      }
     }
-  this->UpdateInterpolatedPoints(markupsNode->GetNumberOfControlPoints() - 1);
-  */
+
+  // Find the pipeline that the point is currently displayed in.
+  // Control point indices are stored in increasing order in each pipeline.
+  int foundControlPointType = -1;
+  vtkIdType foundPipelinePointIndex = -1;
+  for (int controlPointType = 0; controlPointType < NumberOfControlPointTypes; ++controlPointType)
+    {
+    if (controlPointType == Project || controlPointType == ProjectBack)
+      {
+      // no projection display in 3D
+      continue;
+      }
+    vtkIdTypeArray* controlPointIndices = this->GetControlPointsPipeline(controlPointType)->ControlPointIndices;
+    vtkIdType numberOfValues = controlPointIndices->GetNumberOfValues();
+    if (numberOfValues == 0)
+      {
+      continue;
+      }
+    vtkIdType* indicesBegin = controlPointIndices->GetPointer(0);
+    vtkIdType* indicesEnd = indicesBegin + numberOfValues;
+    vtkIdType* foundIndex = std::lower_bound(indicesBegin, indicesEnd, static_cast<vtkIdType>(n));
+    if (foundIndex != indicesEnd && *foundIndex == n)
+      {
+      foundControlPointType = controlPointType;
+      foundPipelinePointIndex = foundIndex - indicesBegin;
+      break;
+      }
+    }
+
+  if (foundControlPointType != expectedControlPointType)
+    {
+    // point has to be moved to another pipeline
+    return false;
+    }
+  if (foundControlPointType < 0)
+    {
+    // point is not displayed
+    return true;
+    }
+
+  ControlPointsPipeline3D* controlPoints = this->GetControlPointsPipeline(foundControlPointType);
+  controlPoints->Glypher->SetScaleFactor(this->ControlPointSize);
+
+  double worldPos[3] = { 0.0, 0.0, 0.0 };
+  markupsNode->GetNthControlPointPositionWorld(n, worldPos);
+  double pointNormalWorld[3] = { 0.0, 0.0, 1.0 };
+  markupsNode->GetNthControlPointNormalWorld(n, pointNormalWorld);
+
+  controlPoints->ControlPoints->SetPoint(foundPipelinePointIndex, worldPos);
+  controlPoints->LabelControlPoints->SetPoint(foundPipelinePointIndex, worldPos);
+  controlPoints->ControlPointsPolyData->GetPointData()->GetNormals()->SetTuple(foundPipelinePointIndex, pointNormalWorld);
+  controlPoints->LabelControlPointsPolyData->GetPointData()->GetNormals()->SetTuple(foundPipelinePointIndex, pointNormalWorld);
+  controlPoints->Labels->SetValue(foundPipelinePointIndex, markupsNode->GetNthControlPointLabel(n));
+
+  controlPoints->ControlPoints->Modified();
+  controlPoints->ControlPointsPolyData->GetPointData()->GetNormals()->Modified();
+  controlPoints->ControlPointsPolyData->Modified();
+
+  controlPoints->LabelControlPoints->Modified();
+  controlPoints->LabelControlPointsPolyData->GetPointData()->GetNormals()->Modified();
+  controlPoints->Labels->Modified();
+  controlPoints->LabelControlPointsPolyData->Modified();
+  return true;
 }
+
 //----------------------------------------------------------------------
 void vtkSlicerMarkupsWidgetRepresentation3D::UpdateAllPointsAndLabelsFromMRML()
 {
@@ -181,6 +260,7 @@ void vtkSlicerMarkupsWidgetRepresentation3D::UpdateAllPointsAndLabelsFromMRML()
     }
 
   int numPoints = markupsNode->GetNumberOfControlPoints();
+  this->NumberOfControlPointsInPipelines = numPoints;
   std::vector<int> activeControlPointIndices;
   this->MarkupsDisplayNode->GetActiveControlPoints(activeControlPointIndices);
   for (int controlPointType = 0; controlPointType < NumberOfControlPointTypes; ++controlPointType)
@@ -648,22 +728,15 @@ void vtkSlicerMarkupsWidgetRepresentation3D::UpdateFromMRML(vtkMRMLNode* caller,
 
   this->TextActor->SetTextProperty(this->GetControlPointsPipeline(Unselected)->TextProperty);
 
-  /* TODO: implement this for better performance
-  if (event == )
+  // If only a single control point is modified then update only that point,
+  // to avoid regenerating glyph and label inputs of all points.
+  bool pointUpdated = false;
+  if (caller == markupsNode && event == vtkMRMLMarkupsNode::PointModifiedEvent && callData != nullptr)
     {
-    int *nPtr = nullptr;
-    int n = -1;
-    if (callData != nullptr)
-      {
-      nPtr = reinterpret_cast<int *>(callData);
-      if (nPtr)
-        {
-        n = *nPtr;
-        }
-      }
-    this->UpdateNthPointAndLabelFromMRML(n);
+    int n = *reinterpret_cast<int*>(callData);
+    pointUpdated = this->UpdateNthPointAndLabelFromMRML(n);
     }
-  else*/
+  if (!pointUpdated)
     {
     this->UpdateAllPointsAndLabelsFromMRML();
     }
@@ -117,10 +117,17 @@ protected:
 
   ControlPointsPipeline3D* GetControlPointsPipeline(int controlPointType);
 
-  virtual void UpdateNthPointAndLabelFromMRML(int n);
+  /// Update position, orientation, and label of a single control point in the point pipelines.
+  /// Returns false if the point cannot be updated in place (for example, the number of points
+  /// or the selected/active/visible state of the point changed) and all points have to be updated.
+  virtual bool UpdateNthPointAndLabelFromMRML(int n);
 
   virtual void UpdateAllPointsAndLabelsFromMRML();
 
+  /// Number of control points in the markups node at the last update of all points.
+  /// Single points can only be updated in place if the number of points is unchanged.
+  int NumberOfControlPointsInPipelines;
+
   vtkSmartPointer<vtkCellPicker> AccuratePicker;
 
   double TextActorPositionWorld[3];
@@ -101,6 +101,8 @@ The effect uses <a href="https://www.spl.harvard.edu/publications/item/view/2761
 
     if not self.growCutFilter:
       self.growCutFilter = vtkSlicerSegmentationsModuleLogic.vtkImageGrowCutSegment()
+      # Bucket queue requires much less memory than the Fibonacci heap and it is typically faster
+      self.growCutFilter.SetEngineToBucketQueue()
       self.growCutFilter.SetIntensityVolume(self.clippedMasterImageData)
       self.growCutFilter.SetMaskVolume(self.clippedMaskImageData)
       maskExtent = self.clippedMaskImageData.GetExtent() if self.clippedMaskImageData else None
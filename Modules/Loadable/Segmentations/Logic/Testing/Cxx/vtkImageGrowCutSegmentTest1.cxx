@@ -0,0 +1,219 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// Segmentations includes
+#include "vtkImageGrowCutSegment.h"
+
+// MRML includes
+#include "vtkMRMLCoreTestingMacros.h"
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+// STD includes
+#include <cmath>
+#include <iostream>
+#include <string>
+
+namespace
+{
+
+const int ImageSize = 100;
+
+//----------------------------------------------------------------------------
+void PrintMeasurement(const std::string& name, int engine, double value)
+{
+  std::cout << "<DartMeasurement name=\"" << name << "-" << vtkImageGrowCutSegment::GetEngineAsString(engine) << "\" "
+            << "type=\"numeric/double\">"
+            << value << "</DartMeasurement>" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+void AllocateImage(vtkImageData* image, int scalarType)
+{
+  image->SetDimensions(ImageSize, ImageSize, ImageSize);
+  image->AllocateScalars(scalarType, 1);
+}
+
+//----------------------------------------------------------------------------
+void FillSeedCube(vtkImageData* seedImage, int center[3], short label)
+{
+  for (int z = center[2] - 2; z <= center[2] + 2; z++)
+    {
+    for (int y = center[1] - 2; y <= center[1] + 2; y++)
+      {
+      for (int x = center[0] - 2; x <= center[0] + 2; x++)
+        {
+        *static_cast<short*>(seedImage->GetScalarPointer(x, y, z)) = label;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+/// Bright noisy sphere in darker noisy background,
+/// with seeds inside and outside the sphere.
+void CreateInputs(vtkImageData* intensityImage, vtkImageData* seedImage, vtkImageData* maskImage)
+{
+  AllocateImage(intensityImage, VTK_SHORT);
+  AllocateImage(seedImage, VTK_SHORT);
+  AllocateImage(maskImage, VTK_UNSIGNED_CHAR);
+  short* intensityPtr = static_cast<short*>(intensityImage->GetScalarPointer());
+  short* seedPtr = static_cast<short*>(seedImage->GetScalarPointer());
+  unsigned char* maskPtr = static_cast<unsigned char*>(maskImage->GetScalarPointer());
+  // noise is generated by a linear congruential generator to get the same image on all platforms
+  unsigned int randomState = 12345;
+  for (int z = 0; z < ImageSize; z++)
+    {
+    for (int y = 0; y < ImageSize; y++)
+      {
+      for (int x = 0; x < ImageSize; x++)
+        {
+        randomState = randomState * 1664525u + 1013904223u;
+        float noise = (randomState >> 8) / 16777216.0f;
+        double radius = sqrt((x - 50.0) * (x - 50.0) + (y - 50.0) * (y - 50.0) + (z - 50.0) * (z - 50.0));
+        *(intensityPtr++) = static_cast<short>((radius < 25.0 ? 200 : 50) + noise * 40);
+        *(seedPtr++) = 0;
+        *(maskPtr++) = (x < 10 || y > 85) ? 1 : 0;
+        }
+      }
+    }
+  int insideSeedCenter[3] = { 50, 50, 50 };
+  FillSeedCube(seedImage, insideSeedCenter, 1);
+  int outsideSeedCenter1[3] = { 15, 15, 15 };
+  FillSeedCube(seedImage, outsideSeedCenter1, 2);
+  int outsideSeedCenter2[3] = { 80, 20, 80 };
+  FillSeedCube(seedImage, outsideSeedCenter2, 2);
+}
+
+//----------------------------------------------------------------------------
+int GetNumberOfDifferentVoxels(vtkImageData* image1, vtkImageData* image2)
+{
+  short* voxels1 = static_cast<short*>(image1->GetScalarPointer());
+  short* voxels2 = static_cast<short*>(image2->GetScalarPointer());
+  int numberOfDifferentVoxels = 0;
+  for (int i = 0; i < ImageSize * ImageSize * ImageSize; i++)
+    {
+    if (voxels1[i] != voxels2[i])
+      {
+      numberOfDifferentVoxels++;
+      }
+    }
+  return numberOfDifferentVoxels;
+}
+
+//----------------------------------------------------------------------------
+int TestEngines(bool useMask, double distancePenalty)
+{
+  std::cout << "Mask: " << (useMask ? "yes" : "no") << ", distance penalty: " << distancePenalty << std::endl;
+  vtkNew<vtkImageData> intensityImage;
+  vtkNew<vtkImageData> seedImage;
+  vtkNew<vtkImageData> maskImage;
+  CreateInputs(intensityImage.GetPointer(), seedImage.GetPointer(), maskImage.GetPointer());
+
+  vtkNew<vtkImageGrowCutSegment> fibonacciHeapFilter;
+  fibonacciHeapFilter->SetEngineToFibonacciHeap();
+  vtkNew<vtkImageGrowCutSegment> bucketQueueFilter;
+  bucketQueueFilter->SetEngineToBucketQueue();
+  vtkImageGrowCutSegment* filters[2] = { fibonacciHeapFilter.GetPointer(), bucketQueueFilter.GetPointer() };
+
+  // Full computation
+  vtkNew<vtkTimerLog> timer;
+  for (vtkImageGrowCutSegment* filter : filters)
+    {
+    filter->SetIntensityVolume(intensityImage.GetPointer());
+    filter->SetSeedLabelVolume(seedImage.GetPointer());
+    if (useMask)
+      {
+      filter->SetMaskVolume(maskImage.GetPointer());
+      }
+    filter->SetDistancePenalty(distancePenalty);
+    timer->StartTimer();
+    filter->Update();
+    timer->StopTimer();
+    PrintMeasurement("FullComputationTime", filter->GetEngine(), timer->GetElapsedTime());
+    PrintMeasurement("PeakMemoryMB", filter->GetEngine(), filter->GetEngineMemorySize() / 1.0e6);
+    }
+  CHECK_INT(GetNumberOfDifferentVoxels(fibonacciHeapFilter->GetOutput(), bucketQueueFilter->GetOutput()), 0);
+  CHECK_BOOL(bucketQueueFilter->GetEngineMemorySize() < fibonacciHeapFilter->GetEngineMemorySize(), true);
+
+  if (useMask)
+    {
+    // Masked voxels are not labeled
+    CHECK_INT(*static_cast<short*>(bucketQueueFilter->GetOutput()->GetScalarPointer(5, 50, 50)), 0);
+    CHECK_INT(*static_cast<short*>(bucketQueueFilter->GetOutput()->GetScalarPointer(50, 90, 50)), 0);
+    }
+
+  // Quick update after adding seeds
+  int newSeedCenter[3] = { 30, 70, 40 };
+  FillSeedCube(seedImage.GetPointer(), newSeedCenter, 3);
+  seedImage->Modified();
+  for (vtkImageGrowCutSegment* filter : filters)
+    {
+    timer->StartTimer();
+    filter->Update();
+    timer->StopTimer();
+    PrintMeasurement("UpdateTime", filter->GetEngine(), timer->GetElapsedTime());
+    }
+  CHECK_INT(GetNumberOfDifferentVoxels(fibonacciHeapFilter->GetOutput(), bucketQueueFilter->GetOutput()), 0);
+  CHECK_INT(*static_cast<short*>(bucketQueueFilter->GetOutput()->GetScalarPointer(30, 70, 40)), 3);
+
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestEngineChange()
+{
+  vtkNew<vtkImageData> intensityImage;
+  vtkNew<vtkImageData> seedImage;
+  vtkNew<vtkImageData> maskImage;
+  CreateInputs(intensityImage.GetPointer(), seedImage.GetPointer(), maskImage.GetPointer());
+
+  vtkNew<vtkImageGrowCutSegment> filter;
+  CHECK_INT(filter->GetEngine(), vtkImageGrowCutSegment::EngineFibonacciHeap);
+  filter->SetIntensityVolume(intensityImage.GetPointer());
+  filter->SetSeedLabelVolume(seedImage.GetPointer());
+  filter->Update();
+  vtkNew<vtkImageData> fibonacciHeapResult;
+  fibonacciHeapResult->DeepCopy(filter->GetOutput());
+
+  // Result is recomputed from scratch by the new engine
+  filter->SetEngineToBucketQueue();
+  filter->Update();
+  CHECK_INT(filter->GetEngine(), vtkImageGrowCutSegment::EngineBucketQueue);
+  CHECK_INT(GetNumberOfDifferentVoxels(fibonacciHeapResult.GetPointer(), filter->GetOutput()), 0);
+
+  CHECK_STRING(vtkImageGrowCutSegment::GetEngineAsString(vtkImageGrowCutSegment::EngineBucketQueue), "BucketQueue");
+  CHECK_STRING(vtkImageGrowCutSegment::GetEngineAsString(vtkImageGrowCutSegment::Engine_Last), "");
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkImageGrowCutSegmentTest1(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestEngines(false, 0.0));
+  CHECK_EXIT_SUCCESS(TestEngines(false, 1.5));
+  CHECK_EXIT_SUCCESS(TestEngines(true, 0.0));
+  CHECK_EXIT_SUCCESS(TestEngines(true, 1.5));
+  CHECK_EXIT_SUCCESS(TestEngineChange());
+  return EXIT_SUCCESS;
+}
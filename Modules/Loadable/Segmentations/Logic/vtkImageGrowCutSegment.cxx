@@ -1,6 +1,9 @@
 #include "vtkImageGrowCutSegment.h"
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <thread>
 #include <vector>
 
 #include <vtkInformation.h>
@@ -11,6 +14,7 @@
 #include <vtkSmartPointer.h>
 #include <vtkStreamingDemandDrivenPipeline.h>
 #include <vtkTimerLog.h>
+#include <vtkType.h>
 
 #include "FibHeap.h"
 
@@ -26,6 +30,168 @@ const int MaskPixelTypeID = VTK_UNSIGNED_CHAR;
 const NodeKeyValueType DIST_INF = std::numeric_limits<NodeKeyValueType>::max();
 const NodeKeyValueType DIST_EPSILON = 1e-3;
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Monotone priority queue of voxels, used by the bucket queue engine.
+//
+// Distances are non-negative floats, therefore their bit patterns, interpreted as unsigned integers,
+// are ordered the same way as the distances. These integer keys are stored in a radix heap:
+// an entry is placed in the bucket that corresponds to the highest bit where its key differs from
+// the last extracted key. When bucket 0 (keys equal to the last extracted key) is empty, the next non-empty
+// bucket is redistributed into lower buckets, using its minimum key as the new last extracted key.
+// Pushed keys must not be smaller than the last extracted key, which holds for Dijkstra's algorithm,
+// as distances along paths never decrease.
+//
+// Keys of entries are not updated: when the distance of a voxel decreases then a new entry is pushed and
+// the outdated entry is skipped by the caller when it is extracted.
+class RadixQueue
+{
+public:
+  struct Entry
+    {
+    vtkTypeUInt32 Key;
+    NodeIndexType Index;
+    };
+
+  static vtkTypeUInt32 GetKey(NodeKeyValueType distance)
+    {
+    vtkTypeUInt32 key = 0;
+    memcpy(&key, &distance, sizeof(key));
+    return key;
+    }
+
+  static NodeKeyValueType GetDistance(vtkTypeUInt32 key)
+    {
+    NodeKeyValueType distance = 0;
+    memcpy(&distance, &key, sizeof(distance));
+    return distance;
+    }
+
+  /// Remove all entries and release memory.
+  /// All keys that will be pushed must be larger or equal to minimumDistance.
+  void Reset(NodeKeyValueType minimumDistance)
+    {
+    for (std::vector<Entry>& bucket : this->Buckets)
+      {
+      std::vector<Entry>().swap(bucket);
+      }
+    this->LastKey = GetKey(minimumDistance);
+    this->Size = 0;
+    }
+
+  bool IsEmpty() const { return this->Size == 0; }
+
+  void Push(NodeKeyValueType distance, NodeIndexType index)
+    {
+    vtkTypeUInt32 key = GetKey(distance);
+    this->Buckets[this->GetBucketIndex(key)].push_back({ key, index });
+    this->Size++;
+    }
+
+  /// Add entries with the smallest possible key (key of the last extracted entry)
+  void PushMinimum(const std::vector<NodeIndexType>& indices)
+    {
+    std::vector<Entry>& bucket = this->Buckets[0];
+    bucket.reserve(bucket.size() + indices.size());
+    for (NodeIndexType index : indices)
+      {
+      bucket.push_back({ this->LastKey, index });
+      }
+    this->Size += indices.size();
+    }
+
+  /// Remove and return an entry with the smallest key. The queue must not be empty.
+  Entry Pop()
+    {
+    if (this->Buckets[0].empty())
+      {
+      int bucketIndex = 1;
+      while (this->Buckets[bucketIndex].empty())
+        {
+        bucketIndex++;
+        }
+      std::vector<Entry>& bucket = this->Buckets[bucketIndex];
+      vtkTypeUInt32 minimumKey = bucket[0].Key;
+      for (const Entry& entry : bucket)
+        {
+        minimumKey = std::min(minimumKey, entry.Key);
+        }
+      this->LastKey = minimumKey;
+      for (const Entry& entry : bucket)
+        {
+        this->Buckets[this->GetBucketIndex(entry.Key)].push_back(entry);
+        }
+      bucket.clear();
+      }
+    Entry entry = this->Buckets[0].back();
+    this->Buckets[0].pop_back();
+    this->Size--;
+    return entry;
+    }
+
+  /// Number of bytes allocated for storing entries
+  size_t GetAllocatedMemorySize() const
+    {
+    size_t memorySize = 0;
+    for (const std::vector<Entry>& bucket : this->Buckets)
+      {
+      memorySize += bucket.capacity() * sizeof(Entry);
+      }
+    return memorySize;
+    }
+
+protected:
+  /// Number of significant bits in the difference from the last extracted key
+  int GetBucketIndex(vtkTypeUInt32 key) const
+    {
+    vtkTypeUInt32 difference = key ^ this->LastKey;
+    int bucketIndex = 0;
+    for (int shift = 16; shift > 0; shift /= 2)
+      {
+      if (difference >> shift)
+        {
+        difference >>= shift;
+        bucketIndex += shift;
+        }
+      }
+    return bucketIndex + static_cast<int>(difference);
+    }
+
+  std::vector<Entry> Buckets[33];
+  vtkTypeUInt32 LastKey{ 0 };
+  size_t Size{ 0 };
+};
+
+//----------------------------------------------------------------------------
+int GetNumberOfSliceRanges(NodeIndexType numberOfSlices, int numberOfThreads)
+{
+  NodeIndexType numberOfRanges = (numberOfThreads > 0 ? numberOfThreads : std::thread::hardware_concurrency());
+  return static_cast<int>(std::max<NodeIndexType>(1, std::min(numberOfRanges, numberOfSlices)));
+}
+
+//----------------------------------------------------------------------------
+// Call processSlices(zBegin, zEnd, rangeIndex) for numberOfRanges consecutive ranges of slices,
+// each range in a separate thread.
+template<typename SliceRangeFunction>
+void ForEachSliceRange(NodeIndexType numberOfSlices, int numberOfRanges, SliceRangeFunction processSlices)
+{
+  std::vector<std::thread> workerThreads;
+  for (int rangeIndex = 1; rangeIndex < numberOfRanges; rangeIndex++)
+    {
+    workerThreads.emplace_back(processSlices,
+      numberOfSlices * rangeIndex / numberOfRanges, numberOfSlices * (rangeIndex + 1) / numberOfRanges, rangeIndex);
+    }
+  processSlices(0, numberOfSlices / numberOfRanges, 0);
+  for (std::thread& workerThread : workerThreads)
+    {
+    workerThread.join();
+    }
+}
+
+} // end of anonymous namespace
+
 //----------------------------------------------------------------------------
 class vtkImageGrowCutSegment::vtkInternal
 {
@@ -41,12 +207,22 @@ public:
   template<typename IntensityPixelType, typename LabelPixelType>
   void DijkstraBasedClassificationAHP(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume);
 
+  template<typename LabelPixelType>
+  bool InitializationBucketQueue(vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty, int numberOfThreads);
+
+  template<typename IntensityPixelType, typename LabelPixelType>
+  void DijkstraBasedClassificationBucketQueue(vtkImageData *intensityVolume);
+
   template <class SourceVolType>
   bool ExecuteGrowCut(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume,
-    vtkImageData *resultLabelVolume, double distancePenalty);
+    vtkImageData *resultLabelVolume, double distancePenalty, int engine, int numberOfThreads);
 
   template< class SourceVolType, class SeedVolType>
-  bool ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume, double distancePenalty);
+  bool ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume, vtkImageData *maskLabelVolume,
+    double distancePenalty, int engine, int numberOfThreads);
+
+  // Compute neighbor index offsets and distance penalties for the current image dimensions
+  void ComputeNeighborhood(double spacing[3]);
 
   // Stores the shortest distance from known labels to each point
   // If a point is set to DIST_INF then that point will modified, as a shorter distance path will be found.
@@ -66,9 +242,26 @@ public:
   std::vector<double> m_NeighborDistancePenalties;
   std::vector<unsigned char> m_NumberOfNeighbors; // size of neighborhood (everywhere the same except at the image boundary)
 
+  std::vector<int> m_NeighborSteps; // voxel coordinate differences (x, y, z) for each neighbor
+
   FibHeap *m_Heap;
   FibHeapNode *m_HeapNodes; // a node is stored for each voxel
   bool m_bSegInitialized;
+
+  // Engine that computed the current distances and result
+  int m_Engine;
+
+  // Bucket queue engine stores distances only within this extent (in voxel coordinates,
+  // starting from 0). All voxels outside are masked, therefore their label never changes.
+  int m_CompactExtent[6];
+  NodeIndexType m_CompactDimX;
+  NodeIndexType m_CompactDimY;
+  NodeIndexType m_CompactDimZ;
+  std::vector<NodeKeyValueType> m_CompactDistances;
+  std::vector<NodeIndexType> m_CompactNeighborIndexOffsets;
+  RadixQueue m_Queue;
+
+  vtkIdType m_EngineMemorySize;
 };
 
 //-----------------------------------------------------------------------------
@@ -78,8 +271,17 @@ vtkImageGrowCutSegment::vtkInternal::vtkInternal()
   m_Heap = nullptr;
   m_HeapNodes = nullptr;
   m_bSegInitialized = false;
+  m_Engine = vtkImageGrowCutSegment::EngineFibonacciHeap;
   m_DistanceVolume = vtkSmartPointer<vtkImageData>::New();
   m_ResultLabelVolume = vtkSmartPointer<vtkImageData>::New();
+  m_CompactDimX = 0;
+  m_CompactDimY = 0;
+  m_CompactDimZ = 0;
+  for (int i = 0; i < 6; i++)
+    {
+    m_CompactExtent[i] = 0;
+    }
+  m_EngineMemorySize = 0;
 };
 
 //-----------------------------------------------------------------------------
@@ -104,6 +306,42 @@ void vtkImageGrowCutSegment::vtkInternal::Reset()
   m_bSegInitialized = false;
   m_DistanceVolume->Initialize();
   m_ResultLabelVolume->Initialize();
+  std::vector<NodeKeyValueType>().swap(m_CompactDistances);
+  m_Queue.Reset(0);
+  m_EngineMemorySize = 0;
+}
+
+//-----------------------------------------------------------------------------
+void vtkImageGrowCutSegment::vtkInternal::ComputeNeighborhood(double spacing[3])
+{
+  m_NeighborIndexOffsets.clear();
+  m_NeighborDistancePenalties.clear();
+  m_NeighborSteps.clear();
+  // Neighbors are traversed in the order of m_NeighborIndexOffsets,
+  // therefore one would expect that the offsets should
+  // be as continuous as possible (e.g., x coordinate
+  // should change most quickly), but that resulted in
+  // about 5-6% longer computation time. Therefore,
+  // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
+  for (long ix = -1; ix <= 1; ix++)
+  {
+    for (long iy = -1; iy <= 1; iy++)
+    {
+      for (long iz = -1; iz <= 1; iz++)
+      {
+        if (ix == 0 && iy == 0 && iz == 0)
+          {
+          continue;
+          }
+        m_NeighborIndexOffsets.push_back(ix + long(m_DimX)*(iy + long(m_DimY)*iz));
+        m_NeighborDistancePenalties.push_back(this->m_DistancePenalty * sqrt((spacing[0] * ix) * (spacing[0] * ix)
+          + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
+        m_NeighborSteps.push_back(ix);
+        m_NeighborSteps.push_back(iy);
+        m_NeighborSteps.push_back(iz);
+        }
+      }
+    }
 }
 
 //-----------------------------------------------------------------------------
@@ -161,31 +399,7 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
 
     // Compute index offset
     m_DistancePenalty = distancePenalty;
-    m_NeighborIndexOffsets.clear();
-    m_NeighborDistancePenalties.clear();
-    // Neighbors are traversed in the order of m_NeighborIndexOffsets,
-    // therefore one would expect that the offsets should
-    // be as continuous as possible (e.g., x coordinate
-    // should change most quickly), but that resulted in
-    // about 5-6% longer computation time. Therefore,
-    // we put indices in order x1y1z1, x1y1z2, x1y1z3, etc.
-    double* spacing = seedLabelVolume->GetSpacing();
-    for (long ix = -1; ix <= 1; ix++)
-    {
-      for (long iy = -1; iy <= 1; iy++)
-      {
-        for (long iz = -1; iz <= 1; iz++)
-        {
-          if (ix == 0 && iy == 0 && iz == 0)
-            {
-            continue;
-            }
-          m_NeighborIndexOffsets.push_back(ix + long(m_DimX)*(iy + long(m_DimY)*iz));
-          m_NeighborDistancePenalties.push_back(this->m_DistancePenalty * sqrt((spacing[0] * ix) * (spacing[0] * ix)
-            + (spacing[1] * iy) * (spacing[1] * iy) + (spacing[2] * iz) * (spacing[2] * iz)));
-          }
-        }
-      }
+    this->ComputeNeighborhood(seedLabelVolume->GetSpacing());
 
     // Determine neighborhood size for computation at each voxel.
     // The neighborhood size is everywhere the same (size of m_NeighborIndexOffsets)
@@ -305,6 +519,10 @@ bool vtkImageGrowCutSegment::vtkInternal::InitializationAHP(
   m_Heap->Insert(&m_HeapNodes[zeroValueElementIndex]);
   m_Heap->ExtractMin();
 
+  // heap nodes, distance volume, neighborhood sizes
+  m_EngineMemorySize = static_cast<vtkIdType>(dimXYZ + 1) * sizeof(FibHeapNode) + sizeof(FibHeap)
+    + static_cast<vtkIdType>(dimXYZ) * (sizeof(NodeKeyValueType) + sizeof(unsigned char));
+
   return true;
 }
 
@@ -402,10 +620,267 @@ void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationAHP(
   m_HeapNodes = nullptr;
 }
 
+//-----------------------------------------------------------------------------
+template<typename LabelPixelType>
+bool vtkImageGrowCutSegment::vtkInternal::InitializationBucketQueue(
+    vtkImageData *seedLabelVolume,
+    vtkImageData *maskLabelVolume,
+    double distancePenalty,
+    int numberOfThreads)
+{
+  LabelPixelType* seedLabelVolumePtr = static_cast<LabelPixelType*>(seedLabelVolume->GetScalarPointer());
+  MaskPixelType* maskLabelVolumePtr = nullptr;
+  if (maskLabelVolume != nullptr)
+    {
+    maskLabelVolumePtr = static_cast<MaskPixelType*>(maskLabelVolume->GetScalarPointer());
+    }
+  const int numberOfSliceRanges = GetNumberOfSliceRanges(m_DimZ, numberOfThreads);
+
+  if (!m_bSegInitialized)
+    {
+    m_ResultLabelVolume->SetOrigin(seedLabelVolume->GetOrigin());
+    m_ResultLabelVolume->SetSpacing(seedLabelVolume->GetSpacing());
+    m_ResultLabelVolume->SetExtent(seedLabelVolume->GetExtent());
+    m_ResultLabelVolume->AllocateScalars(seedLabelVolume->GetScalarType(), 1);
+    m_DistancePenalty = distancePenalty;
+    this->ComputeNeighborhood(seedLabelVolume->GetSpacing());
+
+    // Labels can only change in the non-masked region and in the voxels next to it
+    // (voxels at the boundary of the region may be relabeled if they become seeds).
+    m_CompactExtent[0] = 0;
+    m_CompactExtent[1] = m_DimX - 1;
+    m_CompactExtent[2] = 0;
+    m_CompactExtent[3] = m_DimY - 1;
+    m_CompactExtent[4] = 0;
+    m_CompactExtent[5] = m_DimZ - 1;
+    if (maskLabelVolumePtr)
+      {
+      std::vector<int> rangeExtents(6 * numberOfSliceRanges);
+      ForEachSliceRange(m_DimZ, numberOfSliceRanges, [&](NodeIndexType zBegin, NodeIndexType zEnd, int rangeIndex)
+        {
+        int* extent = &rangeExtents[6 * rangeIndex];
+        extent[0] = extent[2] = extent[4] = VTK_INT_MAX;
+        extent[1] = extent[3] = extent[5] = VTK_INT_MIN;
+        for (NodeIndexType z = zBegin; z < zEnd; z++)
+          {
+          for (NodeIndexType y = 0; y < m_DimY; y++)
+            {
+            MaskPixelType* maskRowPtr = maskLabelVolumePtr + m_DimX * (y + m_DimY * z);
+            for (NodeIndexType x = 0; x < m_DimX; x++)
+              {
+              if (maskRowPtr[x] == 0)
+                {
+                extent[0] = std::min(extent[0], int(x));
+                extent[1] = std::max(extent[1], int(x));
+                extent[2] = std::min(extent[2], int(y));
+                extent[3] = std::max(extent[3], int(y));
+                extent[4] = std::min(extent[4], int(z));
+                extent[5] = std::max(extent[5], int(z));
+                }
+              }
+            }
+          }
+        });
+      int extent[6] = { VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN, VTK_INT_MAX, VTK_INT_MIN };
+      for (int rangeIndex = 0; rangeIndex < numberOfSliceRanges; rangeIndex++)
+        {
+        for (int i = 0; i < 6; i += 2)
+          {
+          extent[i] = std::min(extent[i], rangeExtents[6 * rangeIndex + i]);
+          extent[i + 1] = std::max(extent[i + 1], rangeExtents[6 * rangeIndex + i + 1]);
+          }
+        }
+      if (extent[0] > extent[1])
+        {
+        // everything is masked, the result is empty
+        m_CompactExtent[0] = m_CompactExtent[2] = m_CompactExtent[4] = 0;
+        m_CompactExtent[1] = m_CompactExtent[3] = m_CompactExtent[5] = -1;
+        }
+      else
+        {
+        int dimensions[3] = { int(m_DimX), int(m_DimY), int(m_DimZ) };
+        for (int i = 0; i < 3; i++)
+          {
+          m_CompactExtent[2 * i] = std::max(extent[2 * i] - 1, 0);
+          m_CompactExtent[2 * i + 1] = std::min(extent[2 * i + 1] + 1, dimensions[i] - 1);
+          }
+        }
+      }
+    m_CompactDimX = NodeIndexType(m_CompactExtent[1] - m_CompactExtent[0] + 1);
+    m_CompactDimY = NodeIndexType(m_CompactExtent[3] - m_CompactExtent[2] + 1);
+    m_CompactDimZ = NodeIndexType(m_CompactExtent[5] - m_CompactExtent[4] + 1);
+    m_CompactDistances.resize(static_cast<size_t>(m_CompactDimX) * m_CompactDimY * m_CompactDimZ);
+    m_CompactDistances.shrink_to_fit();
+    m_CompactNeighborIndexOffsets.clear();
+    for (size_t i = 0; i < m_NeighborIndexOffsets.size(); i++)
+      {
+      m_CompactNeighborIndexOffsets.push_back(m_NeighborSteps[3 * i]
+        + long(m_CompactDimX) * (m_NeighborSteps[3 * i + 1] + long(m_CompactDimY) * m_NeighborSteps[3 * i + 2]));
+      }
+    }
+
+  // Seeds that labels are propagated from, collected separately for each range of slices
+  std::vector< std::vector<NodeIndexType> > rangeSeedIndices(numberOfSliceRanges);
+  LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  NodeKeyValueType* distancePtr = m_CompactDistances.empty() ? nullptr : &(m_CompactDistances[0]);
+  const bool initialized = m_bSegInitialized;
+  ForEachSliceRange(m_DimZ, numberOfSliceRanges, [&](NodeIndexType zBegin, NodeIndexType zEnd, int rangeIndex)
+    {
+    std::vector<NodeIndexType>& seedIndices = rangeSeedIndices[rangeIndex];
+    for (NodeIndexType z = zBegin; z < zEnd; z++)
+      {
+      bool zInside = (int(z) >= m_CompactExtent[4] && int(z) <= m_CompactExtent[5]);
+      for (NodeIndexType y = 0; y < m_DimY; y++)
+        {
+        bool yInside = zInside && (int(y) >= m_CompactExtent[2] && int(y) <= m_CompactExtent[3]);
+        for (NodeIndexType x = 0; x < m_DimX; x++)
+          {
+          NodeIndexType index = x + m_DimX * (y + m_DimY * z);
+          LabelPixelType seedValue = seedLabelVolumePtr[index];
+          if (!yInside || int(x) < m_CompactExtent[0] || int(x) > m_CompactExtent[1])
+            {
+            // Masked voxel that has no non-masked neighbors: it is only labeled if it is a seed
+            // that was added after the initial computation.
+            if (!initialized)
+              {
+              resultLabelVolumePtr[index] = 0;
+              }
+            else if (seedValue != 0)
+              {
+              resultLabelVolumePtr[index] = seedValue;
+              }
+            continue;
+            }
+          NodeIndexType compactIndex = (x - m_CompactExtent[0])
+            + m_CompactDimX * ((y - m_CompactExtent[2]) + m_CompactDimY * (z - m_CompactExtent[4]));
+          if (!initialized)
+            {
+            if (maskLabelVolumePtr && maskLabelVolumePtr[index] != 0)
+              {
+              // small distance will prevent overwriting of masked voxels,
+              // and masked voxels are not added to the queue to exclude them from region growing
+              resultLabelVolumePtr[index] = 0;
+              distancePtr[compactIndex] = DIST_EPSILON;
+              }
+            else if (seedValue == 0)
+              {
+              resultLabelVolumePtr[index] = 0;
+              distancePtr[compactIndex] = DIST_INF;
+              }
+            else
+              {
+              resultLabelVolumePtr[index] = seedValue;
+              distancePtr[compactIndex] = DIST_EPSILON;
+              seedIndices.push_back(compactIndex);
+              }
+            }
+          else if (seedValue != 0
+            && (resultLabelVolumePtr[index] != seedValue // changed seed
+              || distancePtr[compactIndex] > DIST_EPSILON)) // new seed
+            {
+            // Only grow from new/changed seeds, old seeds are ignored as their labels have been already propagated
+            resultLabelVolumePtr[index] = seedValue;
+            distancePtr[compactIndex] = DIST_EPSILON;
+            seedIndices.push_back(compactIndex);
+            }
+          }
+        }
+      }
+    });
+
+  m_Queue.Reset(DIST_EPSILON);
+  for (std::vector<NodeIndexType>& seedIndices : rangeSeedIndices)
+    {
+    m_Queue.PushMinimum(seedIndices);
+    std::vector<NodeIndexType>().swap(seedIndices);
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+template<typename IntensityPixelType, typename LabelPixelType>
+void vtkImageGrowCutSegment::vtkInternal::DijkstraBasedClassificationBucketQueue(vtkImageData *intensityVolume)
+{
+  LabelPixelType* resultLabelVolumePtr = static_cast<LabelPixelType*>(m_ResultLabelVolume->GetScalarPointer());
+  IntensityPixelType* imSrc = static_cast<IntensityPixelType*>(intensityVolume->GetScalarPointer());
+  NodeKeyValueType* distancePtr = m_CompactDistances.empty() ? nullptr : &(m_CompactDistances[0]);
+  const NodeIndexType compactDimXY = m_CompactDimX * m_CompactDimY;
+  const int numberOfNeighbors = static_cast<int>(m_NeighborIndexOffsets.size());
+
+  // Same propagation as in the Fibonacci heap engine, both for full computation and quick update,
+  // as voxels are only added to the queue when their distance decreases.
+  while (!m_Queue.IsEmpty())
+    {
+    RadixQueue::Entry entry = m_Queue.Pop();
+    NodeIndexType compactIndex = entry.Index;
+    NodeKeyValueType currentDistance = RadixQueue::GetDistance(entry.Key);
+    if (currentDistance > distancePtr[compactIndex])
+      {
+      // outdated entry, a shorter path has been already found
+      continue;
+      }
+
+    NodeIndexType compactZ = compactIndex / compactDimXY;
+    NodeIndexType compactY = (compactIndex - compactZ * compactDimXY) / m_CompactDimX;
+    NodeIndexType compactX = compactIndex - compactZ * compactDimXY - compactY * m_CompactDimX;
+    NodeIndexType x = compactX + m_CompactExtent[0];
+    NodeIndexType y = compactY + m_CompactExtent[2];
+    NodeIndexType z = compactZ + m_CompactExtent[4];
+    if (x == 0 || x == m_DimX - 1 || y == 0 || y == m_DimY - 1 || z == 0 || z == m_DimZ - 1)
+      {
+      // labels are not propagated from the image boundary
+      continue;
+      }
+    // Neighbors of voxels at the boundary of the compact extent may be outside,
+    // those are masked and so they are skipped.
+    bool boundary = (compactX == 0 || compactX == m_CompactDimX - 1
+      || compactY == 0 || compactY == m_CompactDimY - 1
+      || compactZ == 0 || compactZ == m_CompactDimZ - 1);
+
+    NodeIndexType index = x + m_DimX * (y + m_DimY * z);
+    LabelPixelType currentLabel = resultLabelVolumePtr[index];
+
+    // Update neighbors
+    NodeKeyValueType pixCenter = imSrc[index];
+    for (int i = 0; i < numberOfNeighbors; i++)
+      {
+      if (boundary)
+        {
+        const int* step = &(m_NeighborSteps[3 * i]);
+        if ((step[0] < 0 && compactX == 0) || (step[0] > 0 && compactX == m_CompactDimX - 1)
+          || (step[1] < 0 && compactY == 0) || (step[1] > 0 && compactY == m_CompactDimY - 1)
+          || (step[2] < 0 && compactZ == 0) || (step[2] > 0 && compactZ == m_CompactDimZ - 1))
+          {
+          continue;
+          }
+        }
+      NodeIndexType compactIndexNgbh = compactIndex + m_CompactNeighborIndexOffsets[i];
+      NodeIndexType indexNgbh = index + m_NeighborIndexOffsets[i];
+      NodeKeyValueType neighborCurrentDistance = distancePtr[compactIndexNgbh];
+      NodeKeyValueType neighborNewDistance = fabs(pixCenter - imSrc[indexNgbh]) + currentDistance + m_NeighborDistancePenalties[i];
+      if (neighborCurrentDistance > neighborNewDistance)
+        {
+        distancePtr[compactIndexNgbh] = neighborNewDistance;
+        resultLabelVolumePtr[indexNgbh] = currentLabel;
+        m_Queue.Push(neighborNewDistance, compactIndexNgbh);
+        }
+      }
+    }
+
+  m_bSegInitialized = true;
+
+  // distances and the queue (queue memory is not released until the end, so it is the peak size)
+  m_EngineMemorySize = static_cast<vtkIdType>(m_CompactDistances.capacity() * sizeof(NodeKeyValueType)
+    + m_Queue.GetAllocatedMemorySize());
+
+  // Release memory
+  m_Queue.Reset(0);
+}
+
 //-----------------------------------------------------------------------------
 template< class IntensityPixelType, class LabelPixelType>
 bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume,
-  vtkImageData *maskLabelVolume, double distancePenalty)
+  vtkImageData *maskLabelVolume, double distancePenalty, int engine, int numberOfThreads)
 {
   int* imSize = intensityVolume->GetDimensions();
 
@@ -432,6 +907,16 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensit
     return false;
     }
 
+  if (engine == vtkImageGrowCutSegment::EngineBucketQueue)
+    {
+    if (!InitializationBucketQueue<LabelPixelType>(seedLabelVolume, maskLabelVolume, distancePenalty, numberOfThreads))
+      {
+      return false;
+      }
+    DijkstraBasedClassificationBucketQueue<IntensityPixelType, LabelPixelType>(intensityVolume);
+    return true;
+    }
+
   if (!InitializationAHP<IntensityPixelType, LabelPixelType>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty))
     {
     return false;
@@ -444,7 +929,7 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut2(vtkImageData *intensit
 //----------------------------------------------------------------------------
 template <class SourceVolType>
 bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData *intensityVolume, vtkImageData *seedLabelVolume,
-  vtkImageData *maskLabelVolume, vtkImageData *resultLabelVolume, double distancePenalty)
+  vtkImageData *maskLabelVolume, vtkImageData *resultLabelVolume, double distancePenalty, int engine, int numberOfThreads)
 {
   int* extent = intensityVolume->GetExtent();
   double* spacing = intensityVolume->GetSpacing();
@@ -516,11 +1001,18 @@ bool vtkImageGrowCutSegment::vtkInternal::ExecuteGrowCut(vtkImageData *intensity
     {
     this->Reset();
     }
+  else if (engine != m_Engine)
+    {
+    // engines store distances differently
+    this->Reset();
+    }
+  m_Engine = engine;
 
   bool success = false;
   switch (seedLabelVolume->GetScalarType())
   {
-    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, distancePenalty)));
+    vtkTemplateMacro((success = ExecuteGrowCut2<SourceVolType, VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume,
+      distancePenalty, engine, numberOfThreads)));
   default:
     vtkGenericWarningMacro("vtkOrientedImageDataResample::MergeImage: Unknown ScalarType");
   }
@@ -543,6 +1035,8 @@ vtkImageGrowCutSegment::vtkImageGrowCutSegment()
   this->SetNumberOfInputPorts(3);
   this->SetNumberOfOutputPorts(1);
   this->DistancePenalty = 0.0;
+  this->Engine = EngineFibonacciHeap;
+  this->NumberOfThreads = 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -576,7 +1070,8 @@ void vtkImageGrowCutSegment::ExecuteDataWithInformation(
 
   switch (intensityVolume->GetScalarType())
     {
-    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume, this->DistancePenalty));
+    vtkTemplateMacro(this->Internal->ExecuteGrowCut<VTK_TT>(intensityVolume, seedLabelVolume, maskLabelVolume, resultLabelVolume,
+      this->DistancePenalty, this->Engine, this->NumberOfThreads));
     break;
     }
   logger->StopTimer();
@@ -604,9 +1099,47 @@ void vtkImageGrowCutSegment::Reset()
   this->Internal->Reset();
 }
 
+//-----------------------------------------------------------------------------
+void vtkImageGrowCutSegment::SetEngine(int engine)
+{
+  if (engine < 0 || engine >= Engine_Last)
+    {
+    vtkErrorMacro("SetEngine: invalid engine " << engine);
+    return;
+    }
+  if (this->Engine == engine)
+    {
+    return;
+    }
+  this->Engine = engine;
+  this->Modified();
+}
+
+//-----------------------------------------------------------------------------
+const char* vtkImageGrowCutSegment::GetEngineAsString(int engine)
+{
+  switch (engine)
+    {
+    case EngineFibonacciHeap: return "FibonacciHeap";
+    case EngineBucketQueue: return "BucketQueue";
+    default:
+      // invalid id
+      return "";
+    }
+}
+
+//-----------------------------------------------------------------------------
+vtkIdType vtkImageGrowCutSegment::GetEngineMemorySize()
+{
+  return this->Internal->m_EngineMemorySize;
+}
+
 //-----------------------------------------------------------------------------
 void vtkImageGrowCutSegment::PrintSelf(ostream &os, vtkIndent indent)
 {
-  // XXX Implement this function
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "DistancePenalty: " << this->DistancePenalty << "\n";
+  os << indent << "Engine: " << vtkImageGrowCutSegment::GetEngineAsString(this->Engine) << "\n";
+  os << indent << "NumberOfThreads: " << this->NumberOfThreads << "\n";
+  os << indent << "EngineMemorySize: " << this->Internal->m_EngineMemorySize << "\n";
 }
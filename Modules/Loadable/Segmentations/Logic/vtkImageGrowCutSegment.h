@@ -36,6 +36,37 @@ public:
   vtkGetMacro(DistancePenalty, double);
   vtkSetMacro(DistancePenalty, double);
 
+  /// Algorithms for computing the shortest paths from the seeds
+  enum
+    {
+    /// Fibonacci heap that stores a node for each voxel of the image
+    EngineFibonacciHeap = 0,
+    /// Radix bucket queue, with distances only stored in the region that is not masked.
+    /// It requires much less memory and it is typically faster than the Fibonacci heap.
+    /// Result is the same, except voxels that are at exactly the same distance from different labels.
+    EngineBucketQueue,
+    Engine_Last
+    };
+
+  /// Set the algorithm used for region growing. Default is EngineFibonacciHeap.
+  /// Changing the engine forces full recomputation of the result label volume.
+  void SetEngine(int engine);
+  vtkGetMacro(Engine, int);
+  void SetEngineToFibonacciHeap() { this->SetEngine(EngineFibonacciHeap); }
+  void SetEngineToBucketQueue() { this->SetEngine(EngineBucketQueue); }
+  static const char* GetEngineAsString(int engine);
+
+  /// Maximum number of threads used by the bucket queue engine for initialization.
+  /// Region growing is always performed in a single thread, to keep the result independent from thread scheduling.
+  /// Default is 0, which means the number of hardware threads.
+  vtkGetMacro(NumberOfThreads, int);
+  vtkSetMacro(NumberOfThreads, int);
+
+  /// Memory allocated for the internal data structures of the engine
+  /// (distances, heap nodes, queue) in the last update, in bytes.
+  /// Input and output volumes are not included.
+  vtkIdType GetEngineMemorySize();
+
 protected:
   vtkImageGrowCutSegment();
   ~vtkImageGrowCutSegment() override;
@@ -52,6 +83,8 @@ private:
   class vtkInternal;
   vtkInternal * Internal;
   double DistancePenalty;
+  int Engine;
+  int NumberOfThreads;
 };
 
 #endif
@@ -22,7 +22,9 @@
 #include "vtkSlicerSegmentationsModuleLogic.h"
 
 // SegmentationCore includes
+#include "vtkBinaryLabelmapToBrickedLabelmapConversionRule.h"
 #include "vtkBinaryLabelmapToClosedSurfaceConversionRule.h"
+#include "vtkBrickedLabelmapToBinaryLabelmapConversionRule.h"
 #include "vtkClosedSurfaceToBinaryLabelmapConversionRule.h"
 #include "vtkClosedSurfaceToFractionalLabelmapConversionRule.h"
 #include "vtkFractionalLabelmapToClosedSurfaceConversionRule.h"
@@ -152,6 +154,10 @@ void vtkSlicerSegmentationsModuleLogic::RegisterNodes()
     vtkSmartPointer<vtkClosedSurfaceToFractionalLabelmapConversionRule>::New() );
   vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
     vtkSmartPointer<vtkFractionalLabelmapToClosedSurfaceConversionRule>::New() );
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBinaryLabelmapToBrickedLabelmapConversionRule>::New() );
+  vtkSegmentationConverterFactory::GetInstance()->RegisterConverterRule(
+    vtkSmartPointer<vtkBrickedLabelmapToBinaryLabelmapConversionRule>::New() );
 }
 
 //---------------------------------------------------------------------------
@@ -26,6 +26,7 @@
 // MRML includes
 #include <vtkMRMLScene.h>
 #include <vtkMRMLVolumeNode.h>
+#include <vtkMRMLVolumeSequenceRecorder.h>
 #include <vtkMRMLHierarchyNode.h>
 
 // VTK includes
@@ -34,6 +35,7 @@
 #include <vtkCommand.h>
 #include <vtkCollection.h>
 #include <vtkCollectionIterator.h>
+#include <vtkImageData.h>
 #include <vtkObjectFactory.h>
 #include <vtkSmartPointer.h>
 #include <vtksys/RegularExpression.hxx>
@@ -41,6 +43,7 @@
 #include <vtkVariant.h>
 
 // STD includes
+#include <cmath>
 #include <sstream>
 #include <algorithm> // for std::find
 #include <regex>
@@ -140,6 +143,7 @@ void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
   of << indent << " playbackRateFps=\"" << this->PlaybackRateFps << "\"";
   of << indent << " playbackItemSkippingEnabled=\"" << (this->PlaybackItemSkippingEnabled ? "true" : "false") << "\"";
   of << indent << " playbackLooped=\"" << (this->PlaybackLooped ? "true" : "false") << "\"";
+  of << indent << " playbackPrefetchTimeSec=\"" << this->PlaybackPrefetchTimeSec << "\"";
   of << indent << " selectedItemNumber=\"" << this->SelectedItemNumber << "\"";
   of << indent << " recordingActive=\"" << (this->RecordingActive ? "true" : "false") << "\"";
   of << indent << " recordOnMasterModifiedOnly=\"" << (this->RecordMasterOnly ? "true" : "false") << "\"";
@@ -149,6 +153,10 @@ void vtkMRMLSequenceBrowserNode::WriteXML(ostream& of, int nIndent)
     {
     of << indent << " recordingSamplingMode=\"" << recordingSamplingModeString << "\"";
     }
+  if (!this->RecordingDirectory.empty())
+    {
+    of << indent << " recordingDirectory=\"" << this->XMLAttributeEncodeString(this->RecordingDirectory) << "\"";
+    }
 
   std::string indexDisplayModeString = this->GetIndexDisplayModeAsString();
   if (!indexDisplayModeString.empty())
@@ -231,6 +239,14 @@ void vtkMRMLSequenceBrowserNode::ReadXMLAttributes(const char** atts)
         this->SetPlaybackLooped(0);
         }
       }
+    else if (!strcmp(attName, "playbackPrefetchTimeSec"))
+      {
+      std::stringstream ss;
+      ss << attValue;
+      double playbackPrefetchTimeSec = 1.0;
+      ss >> playbackPrefetchTimeSec;
+      this->SetPlaybackPrefetchTimeSec(playbackPrefetchTimeSec);
+      }
     else if (!strcmp(attName, "selectedItemNumber"))
       {
       std::stringstream ss;
@@ -271,6 +287,10 @@ void vtkMRMLSequenceBrowserNode::ReadXMLAttributes(const char** atts)
         }
       SetRecordingSamplingMode(recordingSamplingMode);
       }
+    else if (!strcmp(attName, "recordingDirectory"))
+      {
+      this->SetRecordingDirectory(this->XMLAttributeDecodeString(attValue));
+      }
     else if (!strcmp(attName, "indexDisplayMode"))
       {
       int indexDisplayMode = this->GetIndexDisplayModeFromString(attValue);
@@ -359,8 +379,10 @@ void vtkMRMLSequenceBrowserNode::Copy(vtkMRMLNode *anode)
   this->SetPlaybackRateFps(node->GetPlaybackRateFps());
   this->SetPlaybackItemSkippingEnabled(node->GetPlaybackItemSkippingEnabled());
   this->SetPlaybackLooped(node->GetPlaybackLooped());
+  this->SetPlaybackPrefetchTimeSec(node->GetPlaybackPrefetchTimeSec());
   this->SetRecordMasterOnly(node->GetRecordMasterOnly());
   this->SetRecordingSamplingMode(node->GetRecordingSamplingMode());
+  this->SetRecordingDirectory(node->GetRecordingDirectory());
   this->SetIndexDisplayMode(node->GetIndexDisplayMode());
   this->SetIndexDisplayFormat(node->GetIndexDisplayFormat());
   this->SetRecordingActive(node->GetRecordingActive());
@@ -380,10 +402,12 @@ void vtkMRMLSequenceBrowserNode::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << " Playback rate (fps): " << this->PlaybackRateFps << '\n';
   os << indent << " Playback item skipping enabled: " << (this->PlaybackItemSkippingEnabled ? "true" : "false") << '\n';
   os << indent << " Playback looped: " << (this->PlaybackLooped ? "true" : "false") << '\n';
+  os << indent << " Playback prefetch time (s): " << this->PlaybackPrefetchTimeSec << '\n';
   os << indent << " Selected item number: " << this->SelectedItemNumber << '\n';
   os << indent << " Recording active: " << (this->RecordingActive ? "true" : "false") << '\n';
   os << indent << " Recording on master modified only: " << (this->RecordMasterOnly ? "true" : "false") << '\n';
   os << indent << " Recording sampling mode: " << this->GetRecordingSamplingModeAsString() << "\n";
+  os << indent << " Recording directory: " << this->RecordingDirectory << "\n";
   os << indent << " Index display mode: " << this->GetIndexDisplayModeAsString() << "\n";
   os << indent << " Index display format: " << this->GetIndexDisplayFormat() << "\n";
 
@@ -1028,9 +1052,57 @@ int vtkMRMLSequenceBrowserNode::SelectNextItem(int selectionIncrement/*=1*/)
     }
   this->SetSelectedItemNumber(selectedItemNumber);
   this->EndModify(browserNodeModify);
+  if (this->GetPlaybackActive())
+    {
+    this->PrefetchNextItems(selectionIncrement);
+    }
   return selectedItemNumber;
 }
 
+//---------------------------------------------------------------------------
+void vtkMRMLSequenceBrowserNode::PrefetchNextItems(int selectionIncrement/*=1*/)
+{
+  vtkMRMLSequenceNode* masterSequenceNode = this->GetMasterSequenceNode();
+  int numberOfItems = this->GetNumberOfItems();
+  if (!masterSequenceNode || numberOfItems == 0 || selectionIncrement == 0
+    || this->PlaybackPrefetchTimeSec <= 0 || this->PlaybackRateFps <= 0)
+    {
+    return;
+    }
+  // Items are selected at PlaybackRateFps, each time moving by selectionIncrement
+  int numberOfPrefetchedItems = static_cast<int>(ceil(this->PlaybackPrefetchTimeSec * this->PlaybackRateFps));
+  numberOfPrefetchedItems = std::min(numberOfPrefetchedItems, numberOfItems - 1);
+  std::vector<std::string> indexValues;
+  int itemNumber = std::max(this->GetSelectedItemNumber(), 0);
+  for (int i = 0; i < numberOfPrefetchedItems; ++i)
+    {
+    itemNumber += selectionIncrement;
+    if (itemNumber < 0 || itemNumber >= numberOfItems)
+      {
+      if (!this->GetPlaybackLooped())
+        {
+        break;
+        }
+      itemNumber = ((itemNumber % numberOfItems) + numberOfItems) % numberOfItems;
+      }
+    indexValues.push_back(masterSequenceNode->GetNthIndexValue(itemNumber));
+    }
+  if (indexValues.empty())
+    {
+    return;
+    }
+
+  std::vector< vtkMRMLSequenceNode* > synchronizedSequenceNodes;
+  this->GetSynchronizedSequenceNodes(synchronizedSequenceNodes, true);
+  for (vtkMRMLSequenceNode* sequenceNode : synchronizedSequenceNodes)
+    {
+    if (sequenceNode && this->GetPlayback(sequenceNode))
+      {
+      sequenceNode->PrefetchDataNodesAtValues(indexValues);
+      }
+    }
+}
+
 //---------------------------------------------------------------------------
 int vtkMRMLSequenceBrowserNode::GetNumberOfItems()
 {
@@ -1100,14 +1172,46 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
   std::vector< vtkMRMLSequenceNode* > sequenceNodes;
   this->GetSynchronizedSequenceNodes(sequenceNodes, true);
   bool snapshotAdded = false;
+  // Volumes that are recorded to file are added first. If a frame is dropped then the snapshot
+  // is not recorded in any of the sequences, so that all sequences have the same index values.
+  std::vector< vtkMRMLSequenceNode* > sequenceNodesRecordedToFile;
+  bool frameDropped = false;
   for (std::vector< vtkMRMLSequenceNode* >::iterator it = sequenceNodes.begin(); it != sequenceNodes.end(); it++)
     {
     vtkMRMLSequenceNode* currSequenceNode = (*it);
-    if (this->GetRecording(currSequenceNode))
+    if (!continuousRecording || !this->GetRecording(currSequenceNode) || !this->CanRecordVolumeFrameToFile(currSequenceNode))
+      {
+      continue;
+      }
+    if (!this->RecordVolumeFrameToFile(currSequenceNode, currTime.str()))
+      {
+      frameDropped = true;
+      break;
+      }
+    sequenceNodesRecordedToFile.push_back(currSequenceNode);
+    }
+  if (frameDropped)
+    {
+    for (vtkMRMLSequenceNode* recordedSequenceNode : sequenceNodesRecordedToFile)
+      {
+      recordedSequenceNode->RemoveDataNodeAtValue(currTime.str());
+      }
+    this->EndModify(wasModified);
+    return;
+    }
+  for (std::vector< vtkMRMLSequenceNode* >::iterator it = sequenceNodes.begin(); it != sequenceNodes.end(); it++)
+    {
+    vtkMRMLSequenceNode* currSequenceNode = (*it);
+    if (!this->GetRecording(currSequenceNode))
+      {
+      continue;
+      }
+    if (std::find(sequenceNodesRecordedToFile.begin(), sequenceNodesRecordedToFile.end(), currSequenceNode)
+      == sequenceNodesRecordedToFile.end())
       {
       currSequenceNode->SetDataNodeAtValue(this->GetProxyNode(currSequenceNode), currTime.str().c_str());
-      snapshotAdded = true;
       }
+    snapshotAdded = true;
     }
   if (snapshotAdded)
     {
@@ -1117,6 +1221,101 @@ void vtkMRMLSequenceBrowserNode::SaveProxyNodesState()
   this->EndModify(wasModified);
 }
 
+//---------------------------------------------------------------------------
+bool vtkMRMLSequenceBrowserNode::CanRecordVolumeFrameToFile(vtkMRMLSequenceNode* sequenceNode)
+{
+  vtkMRMLVolumeNode* proxyVolumeNode = vtkMRMLVolumeNode::SafeDownCast(this->GetProxyNode(sequenceNode));
+  if (this->RecordingDirectory.empty() || !proxyVolumeNode || !proxyVolumeNode->GetImageData())
+    {
+    return false;
+    }
+  // Data nodes of the sequence must not be read from another file
+  return !sequenceNode->GetFrameReader() || vtkMRMLVolumeSequenceRecorder::SafeDownCast(sequenceNode->GetFrameReader());
+}
+
+//---------------------------------------------------------------------------
+bool vtkMRMLSequenceBrowserNode::RecordVolumeFrameToFile(vtkMRMLSequenceNode* sequenceNode, const std::string& indexValue)
+{
+  vtkMRMLVolumeNode* proxyVolumeNode = vtkMRMLVolumeNode::SafeDownCast(this->GetProxyNode(sequenceNode));
+  vtkMRMLVolumeSequenceRecorder* recorder = vtkMRMLVolumeSequenceRecorder::SafeDownCast(sequenceNode->GetFrameReader());
+  if (!recorder)
+    {
+    vtkNew<vtkMRMLVolumeSequenceRecorder> newRecorder;
+    std::stringstream fileNamePrefix;
+    fileNamePrefix << this->RecordingDirectory << "/" << (sequenceNode->GetID() ? sequenceNode->GetID() : "Sequence")
+      << "_" << static_cast<long long>(vtkTimerLog::GetUniversalTime());
+    newRecorder->SetFileName(fileNamePrefix.str());
+    sequenceNode->SetFrameReader(newRecorder.GetPointer());
+    recorder = newRecorder.GetPointer();
+    }
+
+  int frameIndex = recorder->AddFrame(proxyVolumeNode->GetImageData());
+  if (frameIndex < 0)
+    {
+    // frame is dropped, the writer cannot keep up with recording
+    return false;
+    }
+
+  // Data node in the sequence only stores the volume properties, voxels are read from the recorder
+  vtkSmartPointer<vtkMRMLVolumeNode> frameVolumeNode = vtkSmartPointer<vtkMRMLVolumeNode>::Take(
+    vtkMRMLVolumeNode::SafeDownCast(proxyVolumeNode->CreateNodeInstance()));
+  frameVolumeNode->CopyContent(proxyVolumeNode, false);
+  frameVolumeNode->SetAndObserveImageData(nullptr);
+  sequenceNode->SetPagedDataNodeAtValue(frameVolumeNode, indexValue, frameIndex);
+  return true;
+}
+
+//---------------------------------------------------------------------------
+int vtkMRMLSequenceBrowserNode::GetNumberOfDroppedRecordingFrames()
+{
+  int numberOfDroppedFrames = 0;
+  std::vector< vtkMRMLSequenceNode* > sequenceNodes;
+  this->GetSynchronizedSequenceNodes(sequenceNodes, true);
+  for (vtkMRMLSequenceNode* sequenceNode : sequenceNodes)
+    {
+    vtkMRMLVolumeSequenceRecorder* recorder = vtkMRMLVolumeSequenceRecorder::SafeDownCast(sequenceNode->GetFrameReader());
+    if (recorder)
+      {
+      numberOfDroppedFrames += recorder->GetNumberOfDroppedFrames();
+      }
+    }
+  return numberOfDroppedFrames;
+}
+
+//---------------------------------------------------------------------------
+double vtkMRMLSequenceBrowserNode::GetAverageRecordingLatencySec()
+{
+  double latencySec = 0.0;
+  std::vector< vtkMRMLSequenceNode* > sequenceNodes;
+  this->GetSynchronizedSequenceNodes(sequenceNodes, true);
+  for (vtkMRMLSequenceNode* sequenceNode : sequenceNodes)
+    {
+    vtkMRMLVolumeSequenceRecorder* recorder = vtkMRMLVolumeSequenceRecorder::SafeDownCast(sequenceNode->GetFrameReader());
+    if (recorder)
+      {
+      latencySec = std::max(latencySec, recorder->GetAverageLatencySec());
+      }
+    }
+  return latencySec;
+}
+
+//---------------------------------------------------------------------------
+double vtkMRMLSequenceBrowserNode::GetMaximumRecordingLatencySec()
+{
+  double latencySec = 0.0;
+  std::vector< vtkMRMLSequenceNode* > sequenceNodes;
+  this->GetSynchronizedSequenceNodes(sequenceNodes, true);
+  for (vtkMRMLSequenceNode* sequenceNode : sequenceNodes)
+    {
+    vtkMRMLVolumeSequenceRecorder* recorder = vtkMRMLVolumeSequenceRecorder::SafeDownCast(sequenceNode->GetFrameReader());
+    if (recorder)
+      {
+      latencySec = std::max(latencySec, recorder->GetMaximumLatencySec());
+      }
+    }
+  return latencySec;
+}
+
 //---------------------------------------------------------------------------
 void vtkMRMLSequenceBrowserNode::OnNodeReferenceAdded(vtkMRMLNodeReference* nodeReference)
 {
@@ -35,6 +35,7 @@
 
 class vtkCollection;
 class vtkMRMLSequenceNode;
+class vtkMRMLVolumeNode;
 class vtkIntArray;
 
 class VTK_SLICER_SEQUENCES_MODULE_MRML_EXPORT vtkMRMLSequenceBrowserNode : public vtkMRMLNode
@@ -133,6 +134,14 @@ public:
   vtkSetMacro(PlaybackItemSkippingEnabled, bool);
   vtkBooleanMacro(PlaybackItemSkippingEnabled, bool);
 
+  /// Get/Set duration of playback (in seconds) for which the upcoming items are prefetched.
+  /// The number of prefetched items is computed from PlaybackRateFps.
+  /// Only sequences that read their data nodes on demand are prefetched. Set to 0 to disable prefetching.
+  /// Default is 1 second.
+  /// \sa vtkMRMLSequenceNode::PrefetchDataNodesAtValues
+  vtkGetMacro(PlaybackPrefetchTimeSec, double);
+  vtkSetMacro(PlaybackPrefetchTimeSec, double);
+
   /// Get/Set playback looping (restart from the first sequence node when reached the last one)
   vtkGetMacro(PlaybackLooped, bool);
   vtkSetMacro(PlaybackLooped, bool);
@@ -152,6 +161,26 @@ public:
   vtkSetMacro(RecordMasterOnly, bool);
   vtkBooleanMacro(RecordMasterOnly, bool);
 
+  /// Directory where recorded volume frames are written.
+  /// If set then during continuous recording the voxels of volume proxy nodes are not copied
+  /// into the sequence but queued and written to compressed files by a background thread.
+  /// Only a bounded number of frames is kept in memory, other frames are read from the files
+  /// when they are needed. If a frame cannot be queued then the whole snapshot is dropped
+  /// (in all the recorded sequences). Frame files are deleted when the sequence is saved.
+  /// If empty (default) then proxy nodes are recorded in memory.
+  /// \sa vtkMRMLVolumeSequenceRecorder
+  vtkGetMacro(RecordingDirectory, std::string);
+  vtkSetMacro(RecordingDirectory, std::string);
+
+  /// Number of volume frames that were not recorded because the background writer could not keep up,
+  /// summed over all sequences. Only frames recorded to RecordingDirectory may be dropped.
+  int GetNumberOfDroppedRecordingFrames();
+
+  /// Average and maximum time between recording a volume frame and completing its file (in seconds).
+  /// The largest value of all sequences recorded to RecordingDirectory is returned.
+  double GetAverageRecordingLatencySec();
+  double GetMaximumRecordingLatencySec();
+
   /// Set the recording sampling mode
   vtkSetMacro(RecordingSamplingMode, int);
   void SetRecordingSamplingModeFromString(const char *recordingSamplingModeString);
@@ -182,6 +211,11 @@ public:
   /// Selects the next sequence item for display, returns current selected item number
   int SelectNextItem(int selectionIncrement=1);
 
+  /// Start reading the data of the items that playback selects after the current item in the
+  /// background, in all synchronized sequences. The number of items is determined by
+  /// PlaybackRateFps and PlaybackPrefetchTimeSec. Called by SelectNextItem() during playback.
+  void PrefetchNextItems(int selectionIncrement=1);
+
   /// Selects first sequence item for display, returns current selected item number
   int SelectFirstItem();
 
@@ -319,11 +353,19 @@ protected:
   std::string GetSynchronizationPostfixFromSequence(vtkMRMLSequenceNode* sequenceNode);
   std::string GetSynchronizationPostfixFromSequenceID(const char* sequenceNodeID);
 
+  /// Return true if the proxy volume of the sequence is recorded by a background writer
+  bool CanRecordVolumeFrameToFile(vtkMRMLSequenceNode* sequenceNode);
+
+  /// Record the voxels of the proxy volume using the background writer of the sequence.
+  /// Returns false if the frame is dropped because the writer cannot keep up with recording.
+  bool RecordVolumeFrameToFile(vtkMRMLSequenceNode* sequenceNode, const std::string& indexValue);
+
 protected:
   bool PlaybackActive{false};
   double PlaybackRateFps{10.0};
   bool PlaybackItemSkippingEnabled{true};
   bool PlaybackLooped{true};
+  double PlaybackPrefetchTimeSec{1.0};
   int SelectedItemNumber{-1};
 
   bool RecordingActive{false};
@@ -331,6 +373,7 @@ protected:
   double LastSaveProxyNodesStateTimeSec;
   bool RecordMasterOnly{false};
   int RecordingSamplingMode{vtkMRMLSequenceBrowserNode::SamplingLimitedToPlaybackFrameRate};
+  std::string RecordingDirectory;
   int IndexDisplayMode{vtkMRMLSequenceBrowserNode::IndexDisplayAsIndexValue};
   std::string IndexDisplayFormat;
 
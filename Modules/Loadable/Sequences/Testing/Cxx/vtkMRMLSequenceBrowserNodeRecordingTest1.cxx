@@ -0,0 +1,201 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright 2015 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSequenceBrowserNode.h>
+#include <vtkMRMLSequenceNode.h>
+#include <vtkMRMLVolumeSequenceRecorder.h>
+#include <vtkMRMLVolumeSequenceStorageNode.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkSmartPointer.h>
+#include <vtksys/SystemTools.hxx>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+// STD includes
+#include <vector>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageData> CreateFrameVoxels(int frameValue)
+{
+  vtkSmartPointer<vtkImageData> frameVoxels = vtkSmartPointer<vtkImageData>::New();
+  frameVoxels->SetDimensions(8, 8, 4);
+  frameVoxels->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(frameVoxels->GetScalarPointer());
+  for (int i = 0; i < 8 * 8 * 4; ++i)
+    {
+    voxels[i] = static_cast<short>(frameValue);
+    }
+  return frameVoxels;
+}
+
+//-----------------------------------------------------------------------------
+int GetFrameValue(vtkMRMLNode* dataNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(dataNode);
+  if (!volumeNode || !volumeNode->GetImageData())
+    {
+    return -1;
+    }
+  return static_cast<int>(volumeNode->GetImageData()->GetScalarComponentAsDouble(7, 7, 3, 0));
+}
+
+//-----------------------------------------------------------------------------
+int TestRecorder(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLVolumeSequenceRecorder> recorder;
+  recorder->SetFileName(tempDir + "/vtkMRMLVolumeSequenceRecorderTest1");
+  const int numberOfFrames = 10;
+  for (int frameValue = 0; frameValue < numberOfFrames; ++frameValue)
+    {
+    CHECK_INT(recorder->AddFrame(CreateFrameVoxels(frameValue)), frameValue);
+    }
+  recorder->WaitForPendingFrames();
+  CHECK_INT(recorder->GetNumberOfPendingFrames(), 0);
+  CHECK_INT(recorder->GetNumberOfWrittenFrames(), numberOfFrames);
+  CHECK_INT(recorder->GetNumberOfFailedFrames(), 0);
+  CHECK_INT(recorder->GetNumberOfDroppedFrames(), 0);
+  CHECK_BOOL(recorder->GetMaximumLatencySec() >= recorder->GetAverageLatencySec(), true);
+
+  // Frames are read back from the files
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    vtkNew<vtkImageData> frameVoxels;
+    CHECK_BOOL(recorder->ReadFrame(frameIndex, frameVoxels.GetPointer()), true);
+    CHECK_INT(static_cast<int>(frameVoxels->GetScalarComponentAsDouble(7, 7, 3, 0)), frameIndex);
+    }
+
+  // Voxels are copied when the frame is added, the image can be modified afterward
+  vtkSmartPointer<vtkImageData> modifiedFrameVoxels = CreateFrameVoxels(100);
+  int modifiedFrameIndex = recorder->AddFrame(modifiedFrameVoxels);
+  CHECK_INT(modifiedFrameIndex, numberOfFrames);
+  static_cast<short*>(modifiedFrameVoxels->GetScalarPointer())[8 * 8 * 4 - 1] = 200;
+  recorder->WaitForPendingFrames();
+  vtkNew<vtkImageData> readModifiedFrameVoxels;
+  CHECK_BOOL(recorder->ReadFrame(modifiedFrameIndex, readModifiedFrameVoxels.GetPointer()), true);
+  CHECK_INT(static_cast<int>(readModifiedFrameVoxels->GetScalarComponentAsDouble(7, 7, 3, 0)), 100);
+
+  // Frames are dropped when the queue is full
+  recorder->SetMaximumNumberOfPendingFrames(1);
+  int numberOfAddedFrames = 0;
+  for (int frameValue = 0; frameValue < numberOfFrames; ++frameValue)
+    {
+    if (recorder->AddFrame(CreateFrameVoxels(frameValue)) >= 0)
+      {
+      numberOfAddedFrames++;
+      }
+    }
+  recorder->WaitForPendingFrames();
+  CHECK_INT(recorder->GetNumberOfWrittenFrames() + recorder->GetNumberOfDroppedFrames(), numberOfFrames + 1 + numberOfFrames);
+  CHECK_INT(recorder->GetNumberOfWrittenFrames(), numberOfFrames + 1 + numberOfAddedFrames);
+
+  recorder->RemoveFrameFiles();
+  CHECK_BOOL(vtksys::SystemTools::FileExists(recorder->GetFrameFileName(0).c_str(), true), false);
+  return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+int TestBrowserNodeRecording(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  vtkNew<vtkMRMLScalarVolumeNode> proxyNode;
+  scene->AddNode(proxyNode.GetPointer());
+  proxyNode->SetAndObserveImageData(CreateFrameVoxels(0));
+
+  vtkNew<vtkMRMLSequenceBrowserNode> browserNode;
+  scene->AddNode(browserNode.GetPointer());
+  browserNode->SetAndObserveMasterSequenceNodeID(sequenceNode->GetID());
+  browserNode->AddProxyNode(proxyNode.GetPointer(), sequenceNode.GetPointer(), false);
+  browserNode->SetRecording(sequenceNode.GetPointer(), true);
+  browserNode->SetRecordingSamplingMode(vtkMRMLSequenceBrowserNode::SamplingAll);
+  browserNode->SetRecordingDirectory(tempDir);
+  browserNode->SetRecordingActive(true);
+
+  const int numberOfFrames = 5;
+  for (int frameValue = 1; frameValue <= numberOfFrames; ++frameValue)
+    {
+    // Voxels of the proxy node are updated in place, recorded frames are copies
+    proxyNode->GetImageData()->DeepCopy(CreateFrameVoxels(frameValue));
+    proxyNode->Modified();
+    browserNode->SaveProxyNodesState();
+    }
+  browserNode->SetRecordingActive(false);
+
+  vtkMRMLVolumeSequenceRecorder* recorder = vtkMRMLVolumeSequenceRecorder::SafeDownCast(sequenceNode->GetFrameReader());
+  CHECK_NOT_NULL(recorder);
+  CHECK_INT(browserNode->GetNumberOfDroppedRecordingFrames(), 0);
+  // Frames that are recorded within the index value tolerance replace each other
+  CHECK_BOOL(sequenceNode->GetNumberOfDataNodes() >= 1 && sequenceNode->GetNumberOfDataNodes() <= numberOfFrames, true);
+  for (int itemNumber = 0; itemNumber < sequenceNode->GetNumberOfDataNodes(); ++itemNumber)
+    {
+    CHECK_BOOL(sequenceNode->IsNthDataNodePaged(itemNumber), true);
+    CHECK_BOOL(GetFrameValue(sequenceNode->GetNthDataNode(itemNumber)) > 0, true);
+    }
+  recorder->WaitForPendingFrames();
+  CHECK_BOOL(browserNode->GetMaximumRecordingLatencySec() >= browserNode->GetAverageRecordingLatencySec(), true);
+  CHECK_INT(GetFrameValue(sequenceNode->GetNthDataNode(sequenceNode->GetNumberOfDataNodes() - 1)), numberOfFrames);
+
+  // Frame files are merged into the sequence file when the sequence is saved, then they are deleted
+  std::vector<int> frameValues;
+  for (int itemNumber = 0; itemNumber < sequenceNode->GetNumberOfDataNodes(); ++itemNumber)
+    {
+    frameValues.push_back(GetFrameValue(sequenceNode->GetNthDataNode(itemNumber)));
+    }
+  std::string firstFrameFileName = recorder->GetFrameFileName(0);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(firstFrameFileName.c_str(), true), true);
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName((tempDir + "/vtkMRMLSequenceBrowserNodeRecordingTest1.seq.nrrd").c_str());
+  storageNode->SetUseCompression(0);
+  CHECK_INT(storageNode->WriteData(sequenceNode.GetPointer()), 1);
+  CHECK_BOOL(vtksys::SystemTools::FileExists(firstFrameFileName.c_str(), true), false);
+  CHECK_NOT_NULL(sequenceNode->GetFrameReader());
+  CHECK_NULL(vtkMRMLVolumeSequenceRecorder::SafeDownCast(sequenceNode->GetFrameReader()));
+  for (int itemNumber = 0; itemNumber < sequenceNode->GetNumberOfDataNodes(); ++itemNumber)
+    {
+    CHECK_BOOL(sequenceNode->IsNthDataNodePaged(itemNumber), true);
+    CHECK_INT(GetFrameValue(sequenceNode->GetNthDataNode(itemNumber)), frameValues[itemNumber]);
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkMRMLSequenceBrowserNodeRecordingTest1(int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+  CHECK_EXIT_SUCCESS(TestRecorder(tempDir));
+  CHECK_EXIT_SUCCESS(TestBrowserNodeRecording(tempDir));
+  return EXIT_SUCCESS;
+}
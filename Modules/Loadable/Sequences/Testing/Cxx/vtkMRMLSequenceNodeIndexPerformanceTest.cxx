@@ -0,0 +1,144 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright 2015 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include <vtkMRMLSequenceNode.h>
+#include <vtkMRMLTextNode.h>
+
+// VTK includes
+#include <vtkCollection.h>
+#include <vtkNew.h>
+#include <vtkTimerLog.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+// STD includes
+#include <iostream>
+#include <sstream>
+
+namespace
+{
+
+//----------------------------------------------------------------------------
+void PrintMeasurement(const std::string& name, int numberOfItems, double value)
+{
+  std::cout << "<DartMeasurement name=\"" << name << "-" << numberOfItems << "\" "
+            << "type=\"numeric/double\">"
+            << value << "</DartMeasurement>" << std::endl;
+}
+
+//----------------------------------------------------------------------------
+std::string IndexValue(int itemNumber)
+{
+  std::ostringstream indexStr;
+  indexStr << itemNumber * 0.1;
+  return indexStr.str();
+}
+
+//----------------------------------------------------------------------------
+int CheckItemOrder(vtkMRMLSequenceNode* seqNode, int numberOfItems)
+{
+  CHECK_INT(seqNode->GetNumberOfDataNodes(), numberOfItems);
+  for (int itemNumber = 0; itemNumber < numberOfItems; itemNumber += numberOfItems / 10)
+    {
+    CHECK_STD_STRING(seqNode->GetNthIndexValue(itemNumber), IndexValue(itemNumber));
+    }
+  return EXIT_SUCCESS;
+}
+
+//----------------------------------------------------------------------------
+int TestSequenceIndexPerformance(int numberOfItems)
+{
+  vtkNew<vtkMRMLTextNode> textNode;
+  vtkNew<vtkTimerLog> timer;
+
+  // Append items one by one, as done by the sequence recorder
+  vtkNew<vtkMRMLSequenceNode> appendedSeqNode;
+  appendedSeqNode->SetIndexType(vtkMRMLSequenceNode::NumericIndex);
+  timer->StartTimer();
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    appendedSeqNode->SetDataNodeAtValue(textNode.GetPointer(), IndexValue(itemNumber));
+    }
+  timer->StopTimer();
+  PrintMeasurement("AppendItems", numberOfItems, timer->GetElapsedTime());
+  CHECK_EXIT_SUCCESS(CheckItemOrder(appendedSeqNode.GetPointer(), numberOfItems));
+
+  // Insert items in alternating order, each item is inserted in the middle of the sequence
+  vtkNew<vtkMRMLSequenceNode> insertedSeqNode;
+  insertedSeqNode->SetIndexType(vtkMRMLSequenceNode::NumericIndex);
+  timer->StartTimer();
+  for (int itemNumber = 0; itemNumber < numberOfItems; itemNumber += 2)
+    {
+    insertedSeqNode->SetDataNodeAtValue(textNode.GetPointer(), IndexValue(itemNumber));
+    }
+  for (int itemNumber = 1; itemNumber < numberOfItems; itemNumber += 2)
+    {
+    insertedSeqNode->SetDataNodeAtValue(textNode.GetPointer(), IndexValue(itemNumber));
+    }
+  timer->StopTimer();
+  PrintMeasurement("InsertItems", numberOfItems, timer->GetElapsedTime());
+  CHECK_EXIT_SUCCESS(CheckItemOrder(insertedSeqNode.GetPointer(), numberOfItems));
+
+  // Add all items at once
+  vtkNew<vtkCollection> nodes;
+  std::vector<std::string> indexValues;
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    nodes->AddItem(textNode.GetPointer());
+    indexValues.push_back(IndexValue(itemNumber));
+    }
+  vtkNew<vtkMRMLSequenceNode> bulkSeqNode;
+  bulkSeqNode->SetIndexType(vtkMRMLSequenceNode::NumericIndex);
+  timer->StartTimer();
+  CHECK_BOOL(bulkSeqNode->SetDataNodesAtValues(nodes.GetPointer(), indexValues), true);
+  timer->StopTimer();
+  PrintMeasurement("SetDataNodesAtValues", numberOfItems, timer->GetElapsedTime());
+  CHECK_EXIT_SUCCESS(CheckItemOrder(bulkSeqNode.GetPointer(), numberOfItems));
+
+  // Seek to each item, with exact and closest match
+  timer->StartTimer();
+  for (int itemNumber = 0; itemNumber < numberOfItems; ++itemNumber)
+    {
+    CHECK_INT(bulkSeqNode->GetItemNumberFromIndexValue(indexValues[itemNumber]), itemNumber);
+    }
+  timer->StopTimer();
+  PrintMeasurement("SeekExactMatch", numberOfItems, timer->GetElapsedTime());
+
+  timer->StartTimer();
+  for (int itemNumber = 0; itemNumber < numberOfItems - 1; ++itemNumber)
+    {
+    std::ostringstream betweenIndexStr;
+    betweenIndexStr << itemNumber * 0.1 + 0.05;
+    CHECK_INT(bulkSeqNode->GetItemNumberFromIndexValue(betweenIndexStr.str(), false), itemNumber);
+    }
+  timer->StopTimer();
+  PrintMeasurement("SeekClosestMatch", numberOfItems, timer->GetElapsedTime());
+
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//----------------------------------------------------------------------------
+int vtkMRMLSequenceNodeIndexPerformanceTest(int vtkNotUsed(argc), char* vtkNotUsed(argv)[])
+{
+  CHECK_EXIT_SUCCESS(TestSequenceIndexPerformance(1000));
+  CHECK_EXIT_SUCCESS(TestSequenceIndexPerformance(10000));
+  CHECK_EXIT_SUCCESS(TestSequenceIndexPerformance(100000));
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright 2015 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLSequenceNode.h>
+#include <vtkMRMLVolumeSequenceFrameReader.h>
+
+// VTK includes
+#include <vtkImageData.h>
+#include <vtkNew.h>
+#include <vtkObjectFactory.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+// STD includes
+#include <sstream>
+
+namespace
+{
+
+//-----------------------------------------------------------------------------
+// Frame reader that generates frames filled with the frame index instead of reading a file
+class vtkTestFrameReader : public vtkMRMLVolumeSequenceFrameReader
+{
+public:
+  static vtkTestFrameReader *New();
+  vtkTypeMacro(vtkTestFrameReader, vtkMRMLVolumeSequenceFrameReader);
+
+protected:
+  vtkTestFrameReader() = default;
+  ~vtkTestFrameReader() override = default;
+
+  bool DecodeFrame(const std::string& vtkNotUsed(fileName), int frameIndex, vtkImageData* frameVoxels) override
+    {
+    frameVoxels->SetDimensions(4, 4, 4);
+    frameVoxels->AllocateScalars(VTK_SHORT, 1);
+    short* voxels = static_cast<short*>(frameVoxels->GetScalarPointer());
+    for (int i = 0; i < 4 * 4 * 4; ++i)
+      {
+      voxels[i] = static_cast<short>(frameIndex);
+      }
+    return true;
+    }
+};
+vtkStandardNewMacro(vtkTestFrameReader);
+
+//-----------------------------------------------------------------------------
+std::string IndexValue(int frameIndex)
+{
+  std::ostringstream indexStr;
+  indexStr << frameIndex;
+  return indexStr.str();
+}
+
+//-----------------------------------------------------------------------------
+int GetFrameValue(vtkMRMLNode* dataNode)
+{
+  vtkMRMLScalarVolumeNode* volumeNode = vtkMRMLScalarVolumeNode::SafeDownCast(dataNode);
+  if (!volumeNode || !volumeNode->GetImageData())
+    {
+    return -1;
+    }
+  return static_cast<int>(volumeNode->GetImageData()->GetScalarComponentAsDouble(0, 0, 0, 0));
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkMRMLSequenceNodePagedDataTest1( int, char * [] )
+{
+  vtkNew<vtkMRMLSequenceNode> seqNode;
+  seqNode->SetIndexType(vtkMRMLSequenceNode::NumericIndex);
+  seqNode->SetPagedDataNodeCacheSize(4);
+  vtkNew<vtkTestFrameReader> frameReader;
+  frameReader->SetFileName("frames.seq.nrrd");
+  seqNode->SetFrameReader(frameReader.GetPointer());
+
+  const int numberOfFrames = 20;
+  for (int frameIndex = 0; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    vtkNew<vtkMRMLScalarVolumeNode> frameVolume;
+    seqNode->SetPagedDataNodeAtValue(frameVolume.GetPointer(), IndexValue(frameIndex), frameIndex);
+    }
+  CHECK_INT(seqNode->GetNumberOfDataNodes(), numberOfFrames);
+  CHECK_INT(seqNode->GetNumberOfLoadedPagedDataNodes(), 0);
+  CHECK_INT(frameReader->GetNumberOfDecodedFrames(), 0);
+  CHECK_BOOL(seqNode->IsNthDataNodePaged(0), true);
+  CHECK_BOOL(seqNode->IsNthDataNodeLoaded(0), false);
+
+  // Frames are read when they are requested, only the most recently used ones are kept
+  for (int frameIndex = 0; frameIndex < 10; ++frameIndex)
+    {
+    CHECK_INT(GetFrameValue(seqNode->GetNthDataNode(frameIndex)), frameIndex);
+    }
+  CHECK_INT(frameReader->GetNumberOfDecodedFrames(), 10);
+  CHECK_INT(seqNode->GetNumberOfLoadedPagedDataNodes(), 4);
+  CHECK_BOOL(seqNode->IsNthDataNodeLoaded(5), false);
+  CHECK_BOOL(seqNode->IsNthDataNodeLoaded(9), true);
+  CHECK_INT(GetFrameValue(seqNode->GetDataNodeAtValue("8")), 8);
+  CHECK_INT(frameReader->GetNumberOfDecodedFrames(), 10);
+
+  // Prefetched frames are decoded only once
+  std::vector<std::string> prefetchedIndexValues;
+  prefetchedIndexValues.push_back(IndexValue(12));
+  prefetchedIndexValues.push_back(IndexValue(13));
+  seqNode->PrefetchDataNodesAtValues(prefetchedIndexValues);
+  CHECK_INT(GetFrameValue(seqNode->GetNthDataNode(12)), 12);
+  CHECK_INT(GetFrameValue(seqNode->GetNthDataNode(13)), 13);
+  CHECK_INT(frameReader->GetNumberOfDecodedFrames(), 12);
+  CHECK_INT(frameReader->GetNumberOfPrefetchedFrames(), 0);
+  CHECK_INT(seqNode->GetNumberOfLoadedPagedDataNodes(), 4);
+
+  // Updated data nodes keep their voxels
+  vtkNew<vtkMRMLScalarVolumeNode> updatedVolume;
+  vtkNew<vtkImageData> updatedVoxels;
+  updatedVoxels->SetDimensions(2, 2, 2);
+  updatedVoxels->AllocateScalars(VTK_SHORT, 1);
+  updatedVoxels->SetScalarComponentFromDouble(0, 0, 0, 0, 100);
+  updatedVolume->SetAndObserveImageData(updatedVoxels.GetPointer());
+  CHECK_BOOL(seqNode->UpdateDataNodeAtValue(updatedVolume.GetPointer(), IndexValue(2)), true);
+  CHECK_BOOL(seqNode->IsNthDataNodePaged(2), false);
+  for (int frameIndex = 14; frameIndex < numberOfFrames; ++frameIndex)
+    {
+    CHECK_INT(GetFrameValue(seqNode->GetNthDataNode(frameIndex)), frameIndex);
+    }
+  CHECK_INT(GetFrameValue(seqNode->GetNthDataNode(2)), 100);
+
+  // Copies read the voxels from the same reader
+  vtkNew<vtkMRMLSequenceNode> seqNodeCopy;
+  seqNodeCopy->Copy(seqNode.GetPointer());
+  CHECK_POINTER(seqNodeCopy->GetFrameReader(), frameReader.GetPointer());
+  CHECK_BOOL(seqNodeCopy->IsNthDataNodePaged(0), true);
+  CHECK_INT(GetFrameValue(seqNodeCopy->GetNthDataNode(0)), 0);
+
+  seqNode->RemoveAllDataNodes();
+  CHECK_INT(seqNode->GetNumberOfLoadedPagedDataNodes(), 0);
+  CHECK_NULL(seqNode->GetFrameReader());
+
+  return EXIT_SUCCESS;
+}
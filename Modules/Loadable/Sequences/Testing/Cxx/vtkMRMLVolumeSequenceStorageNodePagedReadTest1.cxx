@@ -0,0 +1,262 @@
+/*==============================================================================
+
+  Program: 3D Slicer
+
+  Portions (c) Copyright 2015 Brigham and Women's Hospital (BWH) All Rights Reserved.
+
+  See COPYRIGHT.txt
+  or http://www.slicer.org/copyright/copyright.txt for details.
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+
+==============================================================================*/
+
+// MRML includes
+#include <vtkMRMLScalarVolumeNode.h>
+#include <vtkMRMLScene.h>
+#include <vtkMRMLSequenceNode.h>
+#include <vtkMRMLVolumeSequenceFrameReader.h>
+#include <vtkMRMLVolumeSequenceStorageNode.h>
+
+// vtkTeem includes
+#include <vtkTeemNRRDWriter.h>
+
+// VTK includes
+#include <vtkImageAppendComponents.h>
+#include <vtkImageData.h>
+#include <vtkNew.h>
+
+#include "vtkMRMLCoreTestingMacros.h"
+
+// STD includes
+#include <sstream>
+#include <vector>
+
+namespace
+{
+
+const int NUMBER_OF_FRAMES = 3;
+
+//-----------------------------------------------------------------------------
+short VoxelValue(int frameIndex, int voxelIndex)
+{
+  return static_cast<short>(frameIndex * 1000 + voxelIndex);
+}
+
+//-----------------------------------------------------------------------------
+bool CheckFrameVoxels(vtkImageData* frameVoxels, int frameIndex)
+{
+  if (!frameVoxels || frameVoxels->GetNumberOfScalarComponents() != 1
+    || frameVoxels->GetNumberOfPoints() != 4 * 5 * 6)
+    {
+    return false;
+    }
+  short* voxels = static_cast<short*>(frameVoxels->GetScalarPointer());
+  for (int i = 0; i < 4 * 5 * 6; ++i)
+    {
+    if (voxels[i] != VoxelValue(frameIndex, i))
+      {
+      std::cerr << "Frame " << frameIndex << " voxel " << i << ": expected " << VoxelValue(frameIndex, i)
+        << ", actual " << voxels[i] << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+//-----------------------------------------------------------------------------
+void CreateFrameVoxels(int frameIndex, vtkImageData* frameVoxels)
+{
+  frameVoxels->SetDimensions(4, 5, 6);
+  frameVoxels->AllocateScalars(VTK_SHORT, 1);
+  short* voxels = static_cast<short*>(frameVoxels->GetScalarPointer());
+  for (int i = 0; i < 4 * 5 * 6; ++i)
+    {
+    voxels[i] = VoxelValue(frameIndex, i);
+    }
+}
+
+//-----------------------------------------------------------------------------
+int WriteSequence(vtkMRMLScene* scene, const std::string& fileName, bool useCompression)
+{
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+    vtkNew<vtkImageData> frameVoxels;
+    CreateFrameVoxels(frameIndex, frameVoxels.GetPointer());
+    vtkNew<vtkMRMLScalarVolumeNode> frameVolume;
+    frameVolume->SetAndObserveImageData(frameVoxels.GetPointer());
+    std::ostringstream indexStr;
+    indexStr << frameIndex;
+    sequenceNode->SetDataNodeAtValue(frameVolume.GetPointer(), indexStr.str());
+    }
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  storageNode->SetUseCompression(useCompression ? 1 : 0);
+  CHECK_INT(storageNode->WriteData(sequenceNode.GetPointer()), 1);
+  return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+int TestRawFramesReadOnDemand(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::string fileName = tempDir + "/vtkMRMLVolumeSequenceStorageNodePagedReadTest1_raw.seq.nrrd";
+  CHECK_EXIT_SUCCESS(WriteSequence(scene.GetPointer(), fileName, false));
+
+  // Frames of uncompressed files are read individually, in any order
+  vtkNew<vtkMRMLVolumeSequenceFrameReader> frameReader;
+  frameReader->SetFileName(fileName);
+  CHECK_BOOL(frameReader->CanReadFramesIndividually(), true);
+  CHECK_INT(frameReader->GetNumberOfFrames(), NUMBER_OF_FRAMES);
+  for (int frameIndex = NUMBER_OF_FRAMES - 1; frameIndex >= 0; --frameIndex)
+    {
+    vtkNew<vtkImageData> frameVoxels;
+    CHECK_BOOL(frameReader->ReadFrame(frameIndex, frameVoxels.GetPointer()), true);
+    CHECK_BOOL(CheckFrameVoxels(frameVoxels.GetPointer(), frameIndex), true);
+    }
+
+  // Prefetched frames are decoded in background threads
+  std::vector<int> prefetchedFrameIndices;
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+    prefetchedFrameIndices.push_back(frameIndex);
+    }
+  frameReader->Prefetch(prefetchedFrameIndices);
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+    vtkNew<vtkImageData> frameVoxels;
+    CHECK_BOOL(frameReader->ReadFrame(frameIndex, frameVoxels.GetPointer()), true);
+    CHECK_BOOL(CheckFrameVoxels(frameVoxels.GetPointer(), frameIndex), true);
+    }
+  TESTING_OUTPUT_ASSERT_ERRORS_BEGIN();
+  vtkNew<vtkImageData> invalidFrameVoxels;
+  CHECK_BOOL(frameReader->ReadFrame(NUMBER_OF_FRAMES, invalidFrameVoxels.GetPointer()), false);
+  TESTING_OUTPUT_ASSERT_ERRORS_END();
+
+  // Storage node only reads the header and creates paged data nodes
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_INT(storageNode->ReadData(sequenceNode.GetPointer()), 1);
+  CHECK_NOT_NULL(sequenceNode->GetFrameReader());
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), NUMBER_OF_FRAMES);
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+    CHECK_BOOL(sequenceNode->IsNthDataNodePaged(frameIndex), true);
+    vtkMRMLScalarVolumeNode* frameVolume = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(frameIndex));
+    CHECK_NOT_NULL(frameVolume);
+    CHECK_BOOL(CheckFrameVoxels(frameVolume->GetImageData(), frameIndex), true);
+    }
+  return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+int TestCompressedFramesReadAtOnce(const std::string& tempDir)
+{
+  vtkNew<vtkMRMLScene> scene;
+  std::string fileName = tempDir + "/vtkMRMLVolumeSequenceStorageNodePagedReadTest1_compressed.seq.nrrd";
+  CHECK_EXIT_SUCCESS(WriteSequence(scene.GetPointer(), fileName, true));
+
+  // Compressed files can still be read frame by frame, but each frame requires decoding the file
+  vtkNew<vtkMRMLVolumeSequenceFrameReader> frameReader;
+  frameReader->SetFileName(fileName);
+  CHECK_BOOL(frameReader->CanReadFramesIndividually(), false);
+  CHECK_INT(frameReader->GetNumberOfFrames(), NUMBER_OF_FRAMES);
+  vtkNew<vtkImageData> frameVoxels;
+  CHECK_BOOL(frameReader->ReadFrame(1, frameVoxels.GetPointer()), true);
+  CHECK_BOOL(CheckFrameVoxels(frameVoxels.GetPointer(), 1), true);
+
+  // Storage node decodes all the frames when the sequence is read
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_INT(storageNode->ReadData(sequenceNode.GetPointer()), 1);
+  CHECK_NULL(sequenceNode->GetFrameReader());
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), NUMBER_OF_FRAMES);
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+    CHECK_BOOL(sequenceNode->IsNthDataNodePaged(frameIndex), false);
+    vtkMRMLScalarVolumeNode* frameVolume = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(frameIndex));
+    CHECK_NOT_NULL(frameVolume);
+    CHECK_BOOL(CheckFrameVoxels(frameVolume->GetImageData(), frameIndex), true);
+    }
+  return EXIT_SUCCESS;
+}
+
+//-----------------------------------------------------------------------------
+int TestInterleavedFramesReadAtOnce(const std::string& tempDir)
+{
+  // Files written with frames as interleaved components, as earlier versions did
+  std::string fileName = tempDir + "/vtkMRMLVolumeSequenceStorageNodePagedReadTest1_interleaved.seq.nrrd";
+  vtkNew<vtkImageAppendComponents> appender;
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+    vtkNew<vtkImageData> frameVoxels;
+    CreateFrameVoxels(frameIndex, frameVoxels.GetPointer());
+    appender->AddInputData(frameVoxels.GetPointer());
+    }
+  appender->Update();
+  vtkNew<vtkTeemNRRDWriter> writer;
+  writer->SetVectorAxisKind(nrrdKindList);
+  writer->SetUseCompression(0);
+  writer->SetFileName(fileName.c_str());
+  writer->SetInputConnection(appender->GetOutputPort());
+  writer->Write();
+  CHECK_INT(writer->GetWriteError(), 0);
+
+  // Each frame would require reading the whole file
+  vtkNew<vtkMRMLVolumeSequenceFrameReader> frameReader;
+  frameReader->SetFileName(fileName);
+  CHECK_BOOL(frameReader->CanReadFramesIndividually(), false);
+  CHECK_INT(frameReader->GetNumberOfFrames(), NUMBER_OF_FRAMES);
+  vtkNew<vtkImageData> frameVoxels;
+  CHECK_BOOL(frameReader->ReadFrame(2, frameVoxels.GetPointer()), true);
+  CHECK_BOOL(CheckFrameVoxels(frameVoxels.GetPointer(), 2), true);
+
+  // Storage node decodes all the frames when the sequence is read
+  vtkNew<vtkMRMLScene> scene;
+  vtkNew<vtkMRMLSequenceNode> sequenceNode;
+  scene->AddNode(sequenceNode.GetPointer());
+  vtkNew<vtkMRMLVolumeSequenceStorageNode> storageNode;
+  scene->AddNode(storageNode.GetPointer());
+  storageNode->SetFileName(fileName.c_str());
+  CHECK_INT(storageNode->ReadData(sequenceNode.GetPointer()), 1);
+  CHECK_NULL(sequenceNode->GetFrameReader());
+  CHECK_INT(sequenceNode->GetNumberOfDataNodes(), NUMBER_OF_FRAMES);
+  for (int frameIndex = 0; frameIndex < NUMBER_OF_FRAMES; ++frameIndex)
+    {
+    CHECK_BOOL(sequenceNode->IsNthDataNodePaged(frameIndex), false);
+    vtkMRMLScalarVolumeNode* frameVolume = vtkMRMLScalarVolumeNode::SafeDownCast(sequenceNode->GetNthDataNode(frameIndex));
+    CHECK_NOT_NULL(frameVolume);
+    CHECK_BOOL(CheckFrameVoxels(frameVolume->GetImageData(), frameIndex), true);
+    }
+  return EXIT_SUCCESS;
+}
+
+} // end of anonymous namespace
+
+//-----------------------------------------------------------------------------
+int vtkMRMLVolumeSequenceStorageNodePagedReadTest1(int argc, char * argv[])
+{
+  if (argc < 2)
+    {
+    std::cerr << "Usage: " << argv[0] << " /path/to/temp" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::string tempDir = argv[1];
+  CHECK_EXIT_SUCCESS(TestRawFramesReadOnDemand(tempDir));
+  CHECK_EXIT_SUCCESS(TestCompressedFramesReadAtOnce(tempDir));
+  CHECK_EXIT_SUCCESS(TestInterleavedFramesReadAtOnce(tempDir));
+  return EXIT_SUCCESS;
+}
@@ -188,8 +188,21 @@ void qMRMLTransformInfoWidget::updateWidgetFromMRML()
 
   if (d->TransformNode.GetPointer())
     {
-    d->TransformToParentInfoTextBrowser->setText(d->TransformNode->GetTransformToParentInfo());
-    d->TransformFromParentInfoTextBrowser->setText(d->TransformNode->GetTransformFromParentInfo());
+    QString transformToParentInfo = d->TransformNode->GetTransformToParentInfo();
+    QString transformFromParentInfo = d->TransformNode->GetTransformFromParentInfo();
+    // Show accuracy of the resampled transforms that are used for display instead of the exact transform
+    double resampledTransformToWorldError = d->TransformNode->GetResampledTransformToWorldError();
+    if (resampledTransformToWorldError >= 0)
+      {
+      transformToParentInfo += QString("\nResampled transform to world maximum error: %1 mm").arg(resampledTransformToWorldError, 0, 'g', 3);
+      }
+    double resampledTransformFromWorldError = d->TransformNode->GetResampledTransformFromWorldError();
+    if (resampledTransformFromWorldError >= 0)
+      {
+      transformFromParentInfo += QString("\nResampled transform from world maximum error: %1 mm").arg(resampledTransformFromWorldError, 0, 'g', 3);
+      }
+    d->TransformToParentInfoTextBrowser->setText(transformToParentInfo);
+    d->TransformFromParentInfoTextBrowser->setText(transformFromParentInfo);
     }
   else
     {
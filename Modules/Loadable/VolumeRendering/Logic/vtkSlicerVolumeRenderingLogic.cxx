@@ -28,6 +28,7 @@
 // MRML includes
 #include <vtkCacheManager.h>
 #include <vtkMRMLColorNode.h>
+#include <vtkMRMLImageStatistics.h>
 #include <vtkMRMLLabelMapVolumeDisplayNode.h>
 #include <vtkMRMLScene.h>
 #include <vtkMRMLViewNode.h>
@@ -388,14 +389,15 @@ void vtkSlicerVolumeRenderingLogic::UpdateTranferFunctionRangeFromImage(vtkMRMLV
   //update scalar range
   vtkColorTransferFunction *functionColor = prop->GetRGBTransferFunction();
 
-  vtkDataArray* scalars = input->GetPointData()->GetScalars();
-  if (!scalars)
+  // Statistics are shared with the display nodes of the volume, so the range is computed only once
+  vtkMRMLImageStatistics* statistics = vtkMRMLImageStatistics::GetImageStatistics(input);
+  if (!statistics)
     {
     return;
     }
 
   double rangeNew[2];
-  scalars->GetRange(rangeNew);
+  statistics->GetScalarRange(rangeNew);
   functionColor->AdjustRange(rangeNew);
   vtkDebugMacro("Color range: "<< functionColor->GetRange()[0] << " " << functionColor->GetRange()[1]);
 
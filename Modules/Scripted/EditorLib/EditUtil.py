@@ -304,6 +304,17 @@ class EditUtil(object):
     volumeNode.GetImageData().Modified()
     volumeNode.Modified()
 
+  @staticmethod
+  def markVolumeNodeExtentAsModified(volumeNode, extent):
+    """Same as markVolumeNodeAsModified but only the voxels within the
+    ijk extent (imin, imax, jmin, jmax, kmin, kmax) have been changed.
+    Slice views then only reslice the region of the modified voxels.
+    """
+    if volumeNode.GetImageDataConnection():
+      volumeNode.GetImageDataConnection().GetProducer().Update()
+    volumeNode.ImageDataExtentModified(extent)
+    volumeNode.Modified()
+
   @staticmethod
   def structureVolume(masterNode, structureName, mergeVolumePostfix="-label"):
     """Return the per-structure volume associated with the master node for the given
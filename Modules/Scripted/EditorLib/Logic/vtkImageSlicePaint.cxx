@@ -49,6 +49,7 @@ vtkImageSlicePaint::vtkImageSlicePaint()
   this->ThresholdPaintRange[0] = 0;
   this->ThresholdPaintRange[1] = VTK_DOUBLE_MAX;
   this->PaintOver = 1;
+  this->NotifyWorkingImageModified = 1;
 }
 
 //----------------------------------------------------------------------------
@@ -380,7 +381,10 @@ void vtkImageSlicePaintPaint(vtkImageSlicePaint *self, T *vtkNotUsed(ptr))
       }
     }
 
-  self->GetWorkingImage()->Modified();
+  if (self->GetNotifyWorkingImageModified())
+    {
+    self->GetWorkingImage()->Modified();
+    }
   if (self->GetExtractImage())
     {
     self->GetExtractImage()->Modified();
@@ -436,5 +440,6 @@ void vtkImageSlicePaint::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "ThresholdPaint: " << this->GetThresholdPaint() << "\n";
   os << indent << "ThresholdPaintRange: " << this->GetThresholdPaintRange()[0] << ", " <<  this->GetThresholdPaintRange()[1] << "\n";
   os << indent << "PaintOver: " << this->GetPaintOver() << "\n";
+  os << indent << "NotifyWorkingImageModified: " << this->GetNotifyWorkingImageModified() << "\n";
 }
 
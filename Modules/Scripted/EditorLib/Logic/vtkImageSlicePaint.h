@@ -137,6 +137,16 @@ public:
   vtkSetVector2Macro(ThresholdPaintRange, double);
   vtkGetVector2Macro(ThresholdPaintRange, double);
 
+  ///
+  /// NotifyWorkingImageModified on (default) means that Paint() calls
+  /// Modified() on the WorkingImage. Turn it off when the caller reports the
+  /// painted extent itself (see vtkMRMLVolumeNode::ImageDataExtentModified()),
+  /// otherwise the extent is recorded after an unknown modification and
+  /// slice views reslice the whole image.
+  vtkSetMacro(NotifyWorkingImageModified, int);
+  vtkGetMacro(NotifyWorkingImageModified, int);
+  vtkBooleanMacro(NotifyWorkingImageModified, int);
+
   ///
   /// Apply the paint operation
   void Paint();
@@ -166,6 +176,7 @@ protected:
   int ThresholdPaint;
   double ThresholdPaintRange[2];
   int PaintOver;
+  int NotifyWorkingImageModified;
 
 private:
   vtkImageSlicePaint(const vtkImageSlicePaint&) = delete;
@@ -313,6 +313,7 @@ class PaintEffectTool(LabelEffectTool):
     # interaction state variables
     self.position = [0, 0, 0]
     self.paintCoordinates = []
+    self.paintedExtent = None
     self.feedbackActors = []
     self.lastRadius = 0
 
@@ -510,6 +511,7 @@ class PaintEffectTool(LabelEffectTool):
       if self.undoRedo:
         self.undoRedo.saveState()
 
+    self.paintedExtent = None
     for xy in self.paintCoordinates:
       if self.pixelMode:
         self.paintPixel(xy[0], xy[1])
@@ -525,7 +527,22 @@ class PaintEffectTool(LabelEffectTool):
     sliceLogic = self.sliceWidget.sliceLogic()
     labelLogic = sliceLogic.GetLabelLayer()
     labelNode = labelLogic.GetVolumeNode()
-    EditUtil.markVolumeNodeAsModified(labelNode)
+    if self.paintedExtent:
+      # slice views only reslice the painted region
+      EditUtil.markVolumeNodeExtentAsModified(labelNode, self.paintedExtent)
+    else:
+      EditUtil.markVolumeNodeAsModified(labelNode)
+
+  def addPaintedExtent(self, ijkPoints):
+    """
+    grow the ijk extent of the voxels modified by paintApply
+    """
+    for point in ijkPoints:
+      if self.paintedExtent is None:
+        self.paintedExtent = [point[0], point[0], point[1], point[1], point[2], point[2]]
+      for i in range(3):
+        self.paintedExtent[2*i] = min(self.paintedExtent[2*i], point[i])
+        self.paintedExtent[2*i+1] = max(self.paintedExtent[2*i+1], point[i])
 
   def paintPixel(self, x, y):
     """
@@ -557,7 +574,8 @@ class PaintEffectTool(LabelEffectTool):
     parameterNode = EditUtil.getParameterNode()
     paintLabel = int(parameterNode.GetParameter("label"))
     labelImage.SetScalarComponentFromFloat(ijk[0],ijk[1],ijk[2],0, paintLabel)
-    EditUtil.markVolumeNodeAsModified(labelNode)
+    self.addPaintedExtent([ijk])
+    EditUtil.markVolumeNodeExtentAsModified(labelNode, [ijk[0],ijk[0],ijk[1],ijk[1],ijk[2],ijk[2]])
 
   def paintBrush(self, x, y):
     """
@@ -691,6 +709,9 @@ class PaintEffectTool(LabelEffectTool):
     self.painter.SetPaintOver(paintOver)
     self.painter.SetThresholdPaint(paintThreshold)
     self.painter.SetThresholdPaintRange(paintThresholdMin, paintThresholdMax)
+    # paintApply reports the painted extent to the label volume node,
+    # a plain Modified() here would force slice views to reslice everything
+    self.painter.NotifyWorkingImageModifiedOff()
 
     if bSphere:  # fill volume of a sphere rather than a circle on the currently displayed image slice
         # Algorithm:
@@ -769,6 +790,7 @@ class PaintEffectTool(LabelEffectTool):
 
 
             self.painter.Paint()
+            self.addPaintedExtent([tltemp, trtemp, bltemp, brtemp])
 
 
     # paint the slice: same for circular and spherical brush modes
@@ -779,6 +801,8 @@ class PaintEffectTool(LabelEffectTool):
     self.painter.SetBrushCenter( brushCenter[0], brushCenter[1], brushCenter[2] )
     self.painter.SetBrushRadius( brushRadius )
     self.painter.Paint()
+    self.addPaintedExtent([tl, tr, bl, br])
+    self.painter.NotifyWorkingImageModifiedOn()
 
 
 #